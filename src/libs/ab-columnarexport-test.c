@@ -0,0 +1,379 @@
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <gwenhywfar/gwenhywfar.h>
+#include <aqbanking/banking.h>
+
+#include <string.h>
+
+
+
+/* Reads back the file written by the columnar exporter (see plugins/imexporters/columnar/README) and checks
+ * the file header, the batches and the validity bits of a date, a value and a string column. */
+
+
+#define TEST_BATCHSIZE 2
+#define TEST_ROWS      3
+#define TEST_COLUMNS   3
+
+
+typedef struct {
+  const uint8_t *ptr;
+  uint32_t len;
+  uint32_t pos;
+} TEST_READER;
+
+
+/* second row has neither date, value nor purpose */
+static const int expectedValid[TEST_ROWS]= {1, 0, 1};
+static const uint32_t expectedDays[TEST_ROWS]= {20745, 0, 1};
+static const int64_t expectedValues[TEST_ROWS]= {1190, 0, -5};
+static const char *expectedPurposes[TEST_ROWS]= {"Rent", NULL, "ab"};
+
+static const char *columnNames[TEST_COLUMNS]= {"date", "value", "purpose"};
+static const int columnTypes[TEST_COLUMNS]= {3, 4, 5};
+static const int columnScales[TEST_COLUMNS]= {0, 2, 0};
+
+
+
+static uint32_t pad8(uint32_t len)
+{
+  return (len+7) & ~((uint32_t) 7);
+}
+
+
+
+static const uint8_t *readBytes(TEST_READER *r, uint32_t len)
+{
+  const uint8_t *p;
+
+  if (r->pos+len>r->len) {
+    fprintf(stderr, "Unexpected end of data at offset %lu\n", (unsigned long) r->pos);
+    return NULL;
+  }
+  p=r->ptr+r->pos;
+  r->pos+=len;
+  return p;
+}
+
+
+
+static uint32_t getUint32(const uint8_t *p)
+{
+  return ((uint32_t) p[0]) | (((uint32_t) p[1])<<8) | (((uint32_t) p[2])<<16) | (((uint32_t) p[3])<<24);
+}
+
+
+
+static uint64_t getUint64(const uint8_t *p)
+{
+  return ((uint64_t) getUint32(p)) | (((uint64_t) getUint32(p+4))<<32);
+}
+
+
+
+static int readUint32(TEST_READER *r, uint32_t *pValue)
+{
+  const uint8_t *p;
+
+  p=readBytes(r, 4);
+  if (p==NULL)
+    return -1;
+  *pValue=getUint32(p);
+  return 0;
+}
+
+
+
+static int readUint64(TEST_READER *r, uint64_t *pValue)
+{
+  const uint8_t *p;
+
+  p=readBytes(r, 8);
+  if (p==NULL)
+    return -1;
+  *pValue=getUint64(p);
+  return 0;
+}
+
+
+
+static int checkHeader(TEST_READER *r)
+{
+  const uint8_t *p;
+  uint32_t u;
+  int i;
+
+  p=readBytes(r, 8);
+  if (p==NULL || memcmp(p, "AQBCOLS1", 8)!=0) {
+    fprintf(stderr, "Bad magic\n");
+    return -1;
+  }
+  if (readUint32(r, &u)<0 || u!=1) {
+    fprintf(stderr, "Bad version\n");
+    return -1;
+  }
+  if (readUint32(r, &u)<0 || u!=TEST_COLUMNS) {
+    fprintf(stderr, "Bad number of columns\n");
+    return -1;
+  }
+
+  for (i=0; i<TEST_COLUMNS; i++) {
+    uint32_t len;
+
+    p=readBytes(r, 4);
+    if (p==NULL)
+      return -1;
+    len=p[2] | (p[3]<<8);
+    if (p[0]!=columnTypes[i] || p[1]!=columnScales[i] || len!=strlen(columnNames[i])) {
+      fprintf(stderr, "Bad description of column %d\n", i);
+      return -1;
+    }
+    p=readBytes(r, len);
+    if (p==NULL || memcmp(p, columnNames[i], len)!=0) {
+      fprintf(stderr, "Bad name of column %d\n", i);
+      return -1;
+    }
+  }
+
+  /* header is padded with zeroes */
+  while (r->pos%8) {
+    p=readBytes(r, 1);
+    if (p==NULL || *p!=0) {
+      fprintf(stderr, "Bad header padding\n");
+      return -1;
+    }
+  }
+  return 0;
+}
+
+
+
+static int checkColumnValues(TEST_READER *r, int col, uint32_t firstRow, uint32_t rows)
+{
+  const uint8_t *values;
+  const uint8_t *data;
+  uint32_t i;
+
+  switch (col) {
+  case 0:
+    values=readBytes(r, pad8(rows*4));
+    if (values==NULL)
+      return -1;
+    for (i=0; i<rows; i++) {
+      if (expectedValid[firstRow+i] && getUint32(values+i*4)!=expectedDays[firstRow+i]) {
+        fprintf(stderr, "Row %lu: Bad date\n", (unsigned long)(firstRow+i));
+        return -1;
+      }
+    }
+    break;
+
+  case 1:
+    values=readBytes(r, rows*8);
+    if (values==NULL)
+      return -1;
+    for (i=0; i<rows; i++) {
+      if (expectedValid[firstRow+i] && (int64_t) getUint64(values+i*8)!=expectedValues[firstRow+i]) {
+        fprintf(stderr, "Row %lu: Bad value\n", (unsigned long)(firstRow+i));
+        return -1;
+      }
+    }
+    break;
+
+  case 2:
+    values=readBytes(r, pad8((rows+1)*4));
+    if (values==NULL)
+      return -1;
+    data=readBytes(r, pad8(getUint32(values+rows*4)));
+    if (data==NULL)
+      return -1;
+    for (i=0; i<rows; i++) {
+      const char *s;
+      uint32_t offset;
+      uint32_t len;
+
+      s=expectedPurposes[firstRow+i];
+      offset=getUint32(values+i*4);
+      len=getUint32(values+(i+1)*4)-offset;
+      if (len!=(s?strlen(s):0) || (s && memcmp(data+offset, s, len)!=0)) {
+        fprintf(stderr, "Row %lu: Bad purpose\n", (unsigned long)(firstRow+i));
+        return -1;
+      }
+    }
+    break;
+  }
+
+  return 0;
+}
+
+
+
+static int checkBatch(TEST_READER *r, uint32_t firstRow, uint32_t rows)
+{
+  uint64_t chunkSizes[TEST_COLUMNS];
+  uint32_t u;
+  int i;
+
+  if (readUint32(r, &u)<0 || u!=rows) {
+    fprintf(stderr, "Batch at row %lu: Bad number of rows\n", (unsigned long) firstRow);
+    return -1;
+  }
+  if (readUint32(r, &u)<0 || u!=TEST_COLUMNS) {
+    fprintf(stderr, "Batch at row %lu: Bad number of columns\n", (unsigned long) firstRow);
+    return -1;
+  }
+  for (i=0; i<TEST_COLUMNS; i++) {
+    if (readUint64(r, &(chunkSizes[i]))<0)
+      return -1;
+  }
+
+  for (i=0; i<TEST_COLUMNS; i++) {
+    const uint8_t *validity;
+    uint32_t start;
+    uint32_t j;
+
+    start=r->pos;
+    validity=readBytes(r, pad8((rows+7)/8));
+    if (validity==NULL)
+      return -1;
+    for (j=0; j<rows; j++) {
+      if (((validity[j/8]>>(j%8)) & 1)!=expectedValid[firstRow+j]) {
+        fprintf(stderr, "Row %lu, column %s: Bad validity bit\n", (unsigned long)(firstRow+j), columnNames[i]);
+        return -1;
+      }
+    }
+
+    if (checkColumnValues(r, i, firstRow, rows)<0)
+      return -1;
+
+    if (r->pos-start!=chunkSizes[i]) {
+      fprintf(stderr, "Batch at row %lu, column %s: Chunk size %lu doesn't match data (%lu)\n",
+              (unsigned long) firstRow, columnNames[i],
+              (unsigned long) chunkSizes[i], (unsigned long)(r->pos-start));
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+
+
+static AB_TRANSACTION *createTransaction(const char *date, const char *value, const char *purpose)
+{
+  AB_TRANSACTION *t;
+
+  t=AB_Transaction_new();
+  if (date) {
+    GWEN_DATE *dt;
+
+    dt=GWEN_Date_fromString(date);
+    AB_Transaction_SetDate(t, dt);
+    GWEN_Date_free(dt);
+  }
+  if (value) {
+    AB_VALUE *v;
+
+    v=AB_Value_fromString(value);
+    AB_Value_SetCurrency(v, "EUR");
+    AB_Transaction_SetValue(t, v);
+    AB_Value_free(v);
+  }
+  if (purpose)
+    AB_Transaction_SetPurpose(t, purpose);
+  return t;
+}
+
+
+
+static int testExport(AB_BANKING *ab)
+{
+  AB_IMEXPORTER_CONTEXT *ctx;
+  AB_IMEXPORTER_ACCOUNTINFO *ai;
+  GWEN_DB_NODE *dbParams;
+  GWEN_BUFFER *bufExport;
+  int rv;
+
+  ctx=AB_ImExporterContext_new();
+  ai=AB_ImExporterAccountInfo_new();
+  AB_ImExporterContext_AddAccountInfo(ctx, ai);
+  AB_ImExporterAccountInfo_AddTransaction(ai, createTransaction("20261019", "11,9", "Rent"));
+  AB_ImExporterAccountInfo_AddTransaction(ai, createTransaction(NULL, NULL, NULL));
+  AB_ImExporterAccountInfo_AddTransaction(ai, createTransaction("19700102", "-0,05", "ab"));
+
+  dbParams=GWEN_DB_Group_new("params");
+  GWEN_DB_SetIntValue(dbParams, GWEN_DB_FLAGS_OVERWRITE_VARS, "batchSize", TEST_BATCHSIZE);
+  GWEN_DB_SetIntValue(dbParams, GWEN_DB_FLAGS_OVERWRITE_VARS, "scale", 2);
+  GWEN_DB_SetCharValue(dbParams, 0, "columns", columnNames[0]);
+  GWEN_DB_SetCharValue(dbParams, 0, "columns", columnNames[1]);
+  GWEN_DB_SetCharValue(dbParams, 0, "columns", columnNames[2]);
+
+  bufExport=GWEN_Buffer_new(0, 1024, 0, 1);
+  rv=AB_Banking_ExportToBuffer(ab, "columnar", ctx, bufExport, dbParams);
+  if (rv<0) {
+    fprintf(stderr, "Error exporting (%d)\n", rv);
+  }
+  else {
+    TEST_READER r;
+    uint32_t u;
+    uint64_t totalRows;
+
+    r.ptr=(const uint8_t *) GWEN_Buffer_GetStart(bufExport);
+    r.len=GWEN_Buffer_GetUsedBytes(bufExport);
+    r.pos=0;
+
+    if (checkHeader(&r)<0 ||
+        checkBatch(&r, 0, TEST_BATCHSIZE)<0 ||
+        checkBatch(&r, TEST_BATCHSIZE, TEST_ROWS-TEST_BATCHSIZE)<0)
+      rv=-1;
+    /* end marker */
+    else if (readUint32(&r, &u)<0 || u!=0 ||
+             readUint32(&r, &u)<0 || u!=TEST_COLUMNS ||
+             readUint64(&r, &totalRows)<0 || totalRows!=TEST_ROWS ||
+             r.pos!=r.len) {
+      fprintf(stderr, "Bad end of file\n");
+      rv=-1;
+    }
+  }
+
+  GWEN_Buffer_free(bufExport);
+  GWEN_DB_Group_free(dbParams);
+  AB_ImExporterContext_free(ctx);
+  return rv;
+}
+
+
+
+int main(int argc, char *argv[])
+{
+#ifdef AQBANKING_WITH_PLUGIN_IMEXPORTER_COLUMNAR
+  AB_BANKING *ab;
+  int result=0;
+  int rv;
+
+  GWEN_Init();
+
+  ab=AB_Banking_new("ab-columnarexport-test", "./ab-columnarexport-test.conf", 0);
+  rv=AB_Banking_Init(ab);
+  if (rv) {
+    fprintf(stderr, "Could not init AqBanking (%d)\n", rv);
+    AB_Banking_free(ab);
+    GWEN_Fini();
+    return 2;
+  }
+
+  if (testExport(ab)<0) {
+    fprintf(stderr, "testExport columnar: FAILED\n");
+    result=-1;
+  }
+
+  AB_Banking_Fini(ab);
+  AB_Banking_free(ab);
+  GWEN_Fini();
+  return result;
+#else
+  /* columnar exporter not built */
+  return 77;
+#endif
+}
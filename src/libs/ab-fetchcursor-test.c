@@ -0,0 +1,283 @@
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <gwenhywfar/gwenhywfar.h>
+#include <aqbanking/banking.h>
+
+#include "aqbanking/backendsupport/fetchcursor_l.h"
+
+#include <string.h>
+
+
+
+#define TEST_ACCOUNT_ID 1
+
+
+
+static AB_TRANSACTION *createTransaction(const char *date, const char *value, const char *purpose,
+                                         const char *bankReference)
+{
+  AB_TRANSACTION *t;
+  GWEN_DATE *dt;
+  AB_VALUE *v;
+
+  t=AB_Transaction_new();
+  AB_Transaction_SetType(t, AB_Transaction_TypeStatement);
+  dt=GWEN_Date_fromString(date);
+  AB_Transaction_SetDate(t, dt);
+  GWEN_Date_free(dt);
+  v=AB_Value_fromString(value);
+  AB_Transaction_SetValue(t, v);
+  AB_Value_free(v);
+  AB_Transaction_SetPurpose(t, purpose);
+  if (bankReference)
+    AB_Transaction_SetBankReference(t, bankReference);
+  return t;
+}
+
+
+
+static AB_IMEXPORTER_CONTEXT *createContext(AB_IMEXPORTER_ACCOUNTINFO **pAccountInfo)
+{
+  AB_IMEXPORTER_CONTEXT *ctx;
+  AB_IMEXPORTER_ACCOUNTINFO *ai;
+
+  ctx=AB_ImExporterContext_new();
+  ai=AB_ImExporterAccountInfo_new();
+  AB_ImExporterAccountInfo_SetAccountId(ai, TEST_ACCOUNT_ID);
+  AB_ImExporterContext_AddAccountInfo(ctx, ai);
+  *pAccountInfo=ai;
+  return ctx;
+}
+
+
+
+static int checkPurposes(AB_IMEXPORTER_ACCOUNTINFO *ai, const char **purposes)
+{
+  const AB_TRANSACTION *t;
+  int i=0;
+
+  t=AB_ImExporterAccountInfo_GetFirstTransaction(ai, 0, 0);
+  while (t) {
+    const char *s;
+
+    s=AB_Transaction_GetPurpose(t);
+    if (purposes[i]==NULL || s==NULL || strcmp(s, purposes[i])!=0) {
+      fprintf(stderr, "Unexpected transaction %d (%s)\n", i, s?s:"<none>");
+      return -1;
+    }
+    i++;
+    t=AB_Transaction_List_Next(t);
+  }
+  if (purposes[i]!=NULL) {
+    fprintf(stderr, "Missing transaction %d (%s)\n", i, purposes[i]);
+    return -1;
+  }
+  return 0;
+}
+
+
+
+static int countValues(GWEN_DB_NODE *dbCursor, const char *varName)
+{
+  int i;
+
+  for (i=0; GWEN_DB_GetCharValue(dbCursor, varName, i, NULL); i++);
+  return i;
+}
+
+
+
+static int checkCursor(GWEN_DB_NODE *dbCursor, const char *lastBookedDate, int references, int hashes)
+{
+  const char *s;
+  int i;
+
+  s=GWEN_DB_GetCharValue(dbCursor, "lastBookedDate", 0, "");
+  if (strcmp(s, lastBookedDate)!=0) {
+    fprintf(stderr, "Unexpected lastBookedDate (%s, expected %s)\n", s, lastBookedDate);
+    return -1;
+  }
+  i=countValues(dbCursor, "boundaryReference");
+  if (i!=references) {
+    fprintf(stderr, "Unexpected number of boundary references (%d, expected %d)\n", i, references);
+    return -1;
+  }
+  i=countValues(dbCursor, "boundaryHash");
+  if (i!=hashes) {
+    fprintf(stderr, "Unexpected number of boundary hashes (%d, expected %d)\n", i, hashes);
+    return -1;
+  }
+  return 0;
+}
+
+
+
+/* run a first request, returns the cursor for the next one */
+static GWEN_DB_NODE *createCursor(void)
+{
+  AB_IMEXPORTER_CONTEXT *ctx;
+  AB_IMEXPORTER_ACCOUNTINFO *ai;
+  GWEN_DB_NODE *dbCursor;
+
+  ctx=createContext(&ai);
+  AB_ImExporterAccountInfo_AddTransaction(ai, createTransaction("20261016", "10", "old", NULL));
+  AB_ImExporterAccountInfo_AddTransaction(ai, createTransaction("20261019", "5", "coffee", NULL));
+  AB_ImExporterAccountInfo_AddTransaction(ai, createTransaction("20261019", "5", "coffee", NULL));
+  AB_ImExporterAccountInfo_AddTransaction(ai, createTransaction("20261019", "-500", "rent", "REF1"));
+
+  dbCursor=GWEN_DB_Group_new("fetchCursor");
+  if (AB_FetchCursor_FilterAndAdvance(ctx, dbCursor, TEST_ACCOUNT_ID)!=1 ||
+      checkCursor(dbCursor, "20261019", 1, 2)<0) {
+    fprintf(stderr, "Cursor not advanced by first request\n");
+    GWEN_DB_Group_free(dbCursor);
+    dbCursor=NULL;
+  }
+  AB_ImExporterContext_free(ctx);
+  return dbCursor;
+}
+
+
+
+/* transactions before the cursor and those already received on the cursor date are dropped */
+static int testFilter(void)
+{
+  AB_IMEXPORTER_CONTEXT *ctx;
+  AB_IMEXPORTER_ACCOUNTINFO *ai;
+  GWEN_DB_NODE *dbCursor;
+  const char *expected[]= {"coffee", "salary", NULL};
+  int rv;
+
+  dbCursor=createCursor();
+  if (dbCursor==NULL)
+    return -1;
+
+  ctx=createContext(&ai);
+  AB_ImExporterAccountInfo_AddTransaction(ai, createTransaction("20261016", "10", "old", NULL));
+  /* each stored hash only matches once, the third coffee is new */
+  AB_ImExporterAccountInfo_AddTransaction(ai, createTransaction("20261019", "5", "coffee", NULL));
+  AB_ImExporterAccountInfo_AddTransaction(ai, createTransaction("20261019", "5", "coffee", NULL));
+  AB_ImExporterAccountInfo_AddTransaction(ai, createTransaction("20261019", "5", "coffee", NULL));
+  /* the bank reference matches even though the purpose has changed */
+  AB_ImExporterAccountInfo_AddTransaction(ai, createTransaction("20261019", "-500", "rent october", "REF1"));
+  AB_ImExporterAccountInfo_AddTransaction(ai, createTransaction("20261020", "2000", "salary", "REF2"));
+
+  rv=AB_FetchCursor_FilterAndAdvance(ctx, dbCursor, TEST_ACCOUNT_ID);
+  if (rv!=1) {
+    fprintf(stderr, "Cursor not advanced (%d)\n", rv);
+    rv=-1;
+  }
+  else if (checkPurposes(ai, expected)<0 || checkCursor(dbCursor, "20261020", 1, 0)<0)
+    rv=-1;
+  else
+    rv=0;
+
+  AB_ImExporterContext_free(ctx);
+  GWEN_DB_Group_free(dbCursor);
+  return rv;
+}
+
+
+
+/* the cursor is not advanced if a request for the account failed */
+static int testFailedRequest(void)
+{
+  AB_IMEXPORTER_CONTEXT *ctx;
+  AB_IMEXPORTER_ACCOUNTINFO *ai;
+  GWEN_DB_NODE *dbCursor;
+  const char *expected[]= {"salary", NULL};
+  int rv;
+
+  dbCursor=createCursor();
+  if (dbCursor==NULL)
+    return -1;
+  GWEN_DB_SetIntValue(dbCursor, GWEN_DB_FLAGS_OVERWRITE_VARS, "failed", 1);
+
+  ctx=createContext(&ai);
+  AB_ImExporterAccountInfo_AddTransaction(ai, createTransaction("20261019", "-500", "rent", "REF1"));
+  AB_ImExporterAccountInfo_AddTransaction(ai, createTransaction("20261020", "2000", "salary", "REF2"));
+
+  rv=AB_FetchCursor_FilterAndAdvance(ctx, dbCursor, TEST_ACCOUNT_ID);
+  if (rv!=0) {
+    fprintf(stderr, "Cursor advanced after failed request (%d)\n", rv);
+    rv=-1;
+  }
+  else if (checkPurposes(ai, expected)<0 || checkCursor(dbCursor, "20261019", 1, 2)<0)
+    rv=-1;
+
+  AB_ImExporterContext_free(ctx);
+  GWEN_DB_Group_free(dbCursor);
+  return rv;
+}
+
+
+
+/* a cursor stored meanwhile is never moved back, boundaries on the same date are merged */
+static int testMergeStored(void)
+{
+  GWEN_DB_NODE *dbNew;
+  GWEN_DB_NODE *dbStored;
+  int rv=0;
+
+  dbNew=GWEN_DB_Group_new("fetchCursor");
+  GWEN_DB_SetCharValue(dbNew, 0, "lastBookedDate", "20261019");
+  GWEN_DB_SetCharValue(dbNew, 0, "boundaryHash", "A");
+  GWEN_DB_SetCharValue(dbNew, 0, "boundaryReference", "REF1");
+
+  dbStored=GWEN_DB_Group_new("fetchCursor");
+  GWEN_DB_SetCharValue(dbStored, 0, "lastBookedDate", "20261020");
+  GWEN_DB_SetCharValue(dbStored, 0, "boundaryHash", "B");
+  if (AB_FetchCursor_MergeStored(dbNew, dbStored)!=0) {
+    fprintf(stderr, "Stored cursor moved back\n");
+    rv=-1;
+  }
+
+  GWEN_DB_ClearGroup(dbStored, NULL);
+  GWEN_DB_SetCharValue(dbStored, 0, "lastBookedDate", "20261019");
+  GWEN_DB_SetCharValue(dbStored, 0, "boundaryHash", "A");
+  GWEN_DB_SetCharValue(dbStored, 0, "boundaryHash", "A");
+  GWEN_DB_SetCharValue(dbStored, 0, "boundaryReference", "REF2");
+  if (AB_FetchCursor_MergeStored(dbNew, dbStored)!=1 || checkCursor(dbNew, "20261019", 2, 2)<0) {
+    fprintf(stderr, "Boundaries not merged\n");
+    rv=-1;
+  }
+
+  GWEN_DB_ClearGroup(dbStored, NULL);
+  GWEN_DB_SetCharValue(dbStored, 0, "lastBookedDate", "20261016");
+  GWEN_DB_SetCharValue(dbStored, 0, "boundaryHash", "C");
+  if (AB_FetchCursor_MergeStored(dbNew, dbStored)!=1 || checkCursor(dbNew, "20261019", 2, 2)<0) {
+    fprintf(stderr, "Older stored cursor not replaced\n");
+    rv=-1;
+  }
+
+  GWEN_DB_Group_free(dbStored);
+  GWEN_DB_Group_free(dbNew);
+  return rv;
+}
+
+
+
+int main(int argc, char *argv[])
+{
+  int result=0;
+
+  GWEN_Init();
+
+  if (testFilter()<0) {
+    fprintf(stderr, "testFilter: FAILED\n");
+    result=-1;
+  }
+  if (testFailedRequest()<0) {
+    fprintf(stderr, "testFailedRequest: FAILED\n");
+    result=-1;
+  }
+  if (testMergeStored()<0) {
+    fprintf(stderr, "testMergeStored: FAILED\n");
+    result=-1;
+  }
+
+  GWEN_Fini();
+  return result;
+}
+
@@ -0,0 +1,584 @@
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <gwenhywfar/gwenhywfar.h>
+#include <gwenhywfar/syncio_memory.h>
+#include <gwenhywfar/xml.h>
+#include <gwenhywfar/text.h>
+#include <aqbanking/banking.h>
+
+#include <string.h>
+
+
+
+/* The SEPA exporter writes its documents directly without building an XML tree. The reference
+ * functions below create the same documents the way the exporter used to do it (as a tree of
+ * GWEN_XMLNODEs written by GWEN_XmlCtxStore) to make sure the output stays byte-identical. */
+
+
+#define REF_MAX_PMTINF 8
+
+
+typedef struct {
+  const GWEN_DATE *date;
+  int tcount;
+  AB_VALUE *value;
+  AB_TRANSACTION *transactions[16];
+} REF_PMTINF;
+
+
+
+static void refSetCharValueEscaped(GWEN_XMLNODE *n, const char *varName, const char *value)
+{
+  if (value && *value) {
+    GWEN_BUFFER *dbuf;
+
+    dbuf=GWEN_Buffer_new(0, 256, 0, 1);
+    GWEN_Text_EscapeXmlToBuffer(value, dbuf);
+    GWEN_XMLNode_SetCharValue(n, varName, GWEN_Buffer_GetStart(dbuf));
+    GWEN_Buffer_free(dbuf);
+  }
+}
+
+
+
+static void refSetValueString(GWEN_XMLNODE *n, const char *varName, const AB_VALUE *v)
+{
+  GWEN_BUFFER *tbuf;
+
+  tbuf=GWEN_Buffer_new(0, 64, 0, 1);
+  AB_Value_toHumanReadableString(v, tbuf, 2, 0);
+  GWEN_XMLNode_SetCharValue(n, varName, GWEN_Buffer_GetStart(tbuf));
+  GWEN_Buffer_free(tbuf);
+}
+
+
+
+static void refSetDate(GWEN_XMLNODE *n, const char *varName, const GWEN_DATE *dt)
+{
+  GWEN_BUFFER *tbuf;
+
+  tbuf=GWEN_Buffer_new(0, 64, 0, 1);
+  GWEN_Date_toStringWithTemplate(dt, "YYYY-MM-DD", tbuf);
+  GWEN_XMLNode_SetCharValue(n, varName, GWEN_Buffer_GetStart(tbuf));
+  GWEN_Buffer_free(tbuf);
+}
+
+
+
+static void refAddAmount(GWEN_XMLNODE *n, const AB_VALUE *v)
+{
+  GWEN_XMLNODE *nn;
+  GWEN_BUFFER *tbuf;
+  const char *s;
+
+  nn=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "InstdAmt");
+  GWEN_XMLNode_AddChild(n, nn);
+  tbuf=GWEN_Buffer_new(0, 64, 0, 1);
+  AB_Value_toHumanReadableString(v, tbuf, 2, 0);
+  s=AB_Value_GetCurrency(v);
+  GWEN_XMLNode_SetProperty(nn, "Ccy", s?s:"EUR");
+  GWEN_XMLNode_AddChild(nn, GWEN_XMLNode_new(GWEN_XMLNodeTypeData, GWEN_Buffer_GetStart(tbuf)));
+  GWEN_Buffer_free(tbuf);
+}
+
+
+
+static void refAddAgent(GWEN_XMLNODE *n, const char *tagName, const char *bic)
+{
+  GWEN_XMLNODE *nn;
+
+  nn=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, tagName);
+  GWEN_XMLNode_AddChild(n, nn);
+  if (bic && *bic)
+    GWEN_XMLNode_SetCharValueByPath(nn, GWEN_XML_PATH_FLAGS_OVERWRITE_VALUES, "FinInstnId/BIC", bic);
+  else
+    GWEN_XMLNode_SetCharValueByPath(nn, GWEN_XML_PATH_FLAGS_OVERWRITE_VALUES, "FinInstnId/Othr/Id", "NOTPROVIDED");
+}
+
+
+
+static void refAddParty(GWEN_XMLNODE *n, const char *tagName, const char *name)
+{
+  GWEN_XMLNODE *nn;
+
+  nn=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, tagName);
+  GWEN_XMLNode_AddChild(n, nn);
+  refSetCharValueEscaped(nn, "Nm", name);
+}
+
+
+
+static void refAddAccount(GWEN_XMLNODE *n, const char *tagName, const char *iban, int escaped)
+{
+  GWEN_XMLNODE *nn;
+
+  nn=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, tagName);
+  GWEN_XMLNode_AddChild(n, nn);
+  if (escaped) {
+    GWEN_XMLNODE *nnn;
+
+    nnn=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "Id");
+    GWEN_XMLNode_AddChild(nn, nnn);
+    refSetCharValueEscaped(nnn, "IBAN", iban);
+  }
+  else
+    GWEN_XMLNode_SetCharValueByPath(nn, GWEN_XML_PATH_FLAGS_OVERWRITE_VALUES, "Id/IBAN", iban);
+}
+
+
+
+static void refAddRemittance(GWEN_XMLNODE *n, const char *purpose, int crop)
+{
+  GWEN_XMLNODE *nn;
+  GWEN_BUFFER *tbuf;
+
+  nn=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "RmtInf");
+  GWEN_XMLNode_AddChild(n, nn);
+  tbuf=GWEN_Buffer_new(0, 140, 0, 1);
+  GWEN_Buffer_AppendString(tbuf, purpose);
+  if (crop && GWEN_Buffer_GetUsedBytes(tbuf)>140)
+    GWEN_Buffer_Crop(tbuf, 0, 140);
+  refSetCharValueEscaped(nn, "Ustrd", GWEN_Buffer_GetStart(tbuf));
+  GWEN_Buffer_free(tbuf);
+}
+
+
+
+static void refAddTransaction001(GWEN_XMLNODE *n, const AB_TRANSACTION *t)
+{
+  GWEN_XMLNODE *nn;
+  GWEN_XMLNODE *nnn;
+  const char *s;
+
+  nn=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "CdtTrfTxInf");
+  GWEN_XMLNode_AddChild(n, nn);
+
+  nnn=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "PmtId");
+  GWEN_XMLNode_AddChild(nn, nnn);
+  s=AB_Transaction_GetEndToEndReference(t);
+  refSetCharValueEscaped(nnn, "EndToEndId", (s && *s)?s:"NOTPROVIDED");
+
+  nnn=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "Amt");
+  GWEN_XMLNode_AddChild(nn, nnn);
+  refAddAmount(nnn, AB_Transaction_GetValue(t));
+
+  s=AB_Transaction_GetRemoteBic(t);
+  if (s && *s)
+    GWEN_XMLNode_SetCharValueByPath(nn, GWEN_XML_PATH_FLAGS_OVERWRITE_VALUES, "CdtrAgt/FinInstnId/BIC", s);
+
+  refAddParty(nn, "Cdtr", AB_Transaction_GetRemoteName(t));
+  refAddAccount(nn, "CdtrAcct", AB_Transaction_GetRemoteIban(t), 1);
+  refAddRemittance(nn, AB_Transaction_GetPurpose(t), 0);
+}
+
+
+
+static void refAddTransaction008(GWEN_XMLNODE *n, const AB_TRANSACTION *t, int is_8_1_1)
+{
+  GWEN_XMLNODE *nn;
+  GWEN_XMLNODE *nnn;
+  GWEN_XMLNODE *nnnn;
+  const char *origCredSchemId;
+  const char *origMandateId;
+  const char *origCreditorName;
+  const char *s;
+
+  nn=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "DrctDbtTxInf");
+  GWEN_XMLNode_AddChild(n, nn);
+
+  s=AB_Transaction_GetEndToEndReference(t);
+  if (!(s && *s))
+    s=AB_Transaction_GetCustomerReference(t);
+  if (!(s && *s))
+    s="NOTPROVIDED";
+  GWEN_XMLNode_SetCharValueByPath(nn, GWEN_XML_PATH_FLAGS_OVERWRITE_VALUES, "PmtId/EndToEndId", s);
+
+  refAddAmount(nn, AB_Transaction_GetValue(t));
+
+  nnn=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "DrctDbtTx");
+  GWEN_XMLNode_AddChild(nn, nnn);
+  nnnn=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "MndtRltdInf");
+  GWEN_XMLNode_AddChild(nnn, nnnn);
+  refSetCharValueEscaped(nnnn, "MndtId", AB_Transaction_GetMandateId(t));
+  refSetDate(nnnn, "DtOfSgntr", AB_Transaction_GetMandateDate(t));
+
+  origCredSchemId=AB_Transaction_GetOriginalCreditorSchemeId(t);
+  origMandateId=AB_Transaction_GetOriginalMandateId(t);
+  origCreditorName=AB_Transaction_GetOriginalCreditorName(t);
+  if ((origCredSchemId && *origCredSchemId) ||
+      (origMandateId && *origMandateId) ||
+      (origCreditorName && *origCreditorName)) {
+    GWEN_XMLNODE *n5;
+
+    refSetCharValueEscaped(nnnn, "AmdmntInd", "true");
+    n5=GWEN_XMLNode_GetNodeByXPath(nnnn, "AmdmntInfDtls/OrgnlCdtrSchmeId", 0);
+    refSetCharValueEscaped(n5, "OrgnlMndtId", origMandateId);
+    refSetCharValueEscaped(n5, "Nm", origCreditorName);
+    if (origCredSchemId && *origCredSchemId) {
+      GWEN_XMLNode_SetCharValueByPath(n5, GWEN_XML_PATH_FLAGS_OVERWRITE_VALUES,
+                                      is_8_1_1?"Id/PrvtId/OthrId/Id":"Id/PrvtId/Othr/Id", origCredSchemId);
+      GWEN_XMLNode_SetCharValueByPath(n5, GWEN_XML_PATH_FLAGS_OVERWRITE_VALUES,
+                                      is_8_1_1?"Id/PrvtId/OthrId/IdTp":"Id/PrvtId/Othr/SchmeNm/Prtry", "SEPA");
+    }
+  }
+  else
+    refSetCharValueEscaped(nnnn, "AmdmntInd", "false");
+
+  if (is_8_1_1) {
+    GWEN_XMLNode_SetCharValueByPath(nnn, GWEN_XML_PATH_FLAGS_OVERWRITE_VALUES,
+                                    "CdtrSchmeId/Id/PrvtId/OthrId/Id", AB_Transaction_GetCreditorSchemeId(t));
+    GWEN_XMLNode_SetCharValueByPath(nnn, GWEN_XML_PATH_FLAGS_OVERWRITE_VALUES,
+                                    "CdtrSchmeId/Id/PrvtId/OthrId/IdTp", "SEPA");
+  }
+
+  refAddAgent(nn, "DbtrAgt", AB_Transaction_GetRemoteBic(t));
+  refAddParty(nn, "Dbtr", AB_Transaction_GetRemoteName(t));
+  refAddAccount(nn, "DbtrAcct", AB_Transaction_GetRemoteIban(t), 1);
+
+  s=AB_Transaction_GetMandateDebitorName(t);
+  if (s && *s)
+    GWEN_XMLNode_SetCharValueByPath(nn, GWEN_XML_PATH_FLAGS_OVERWRITE_VALUES, "UltmtDbtr/Nm", s);
+
+  refAddRemittance(nn, AB_Transaction_GetPurpose(t), 1);
+}
+
+
+
+static void refAddPmtInf(GWEN_XMLNODE *painNode, const REF_PMTINF *pmtinf, const AB_IMEXPORTER_ACCOUNTINFO *ai,
+                         const int *doctype)
+{
+  GWEN_XMLNODE *n;
+  GWEN_XMLNODE *nn;
+  const AB_TRANSACTION *t;
+  int is_8_1_1=(doctype[1]==1 && doctype[2]==1);
+  int withCounts;
+  int i;
+
+  t=pmtinf->transactions[0];
+  withCounts=(doctype[0]==1)?(doctype[1]>1 || doctype[2]>2):!is_8_1_1;
+
+  n=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "PmtInf");
+  GWEN_XMLNode_AddChild(painNode, n);
+  GWEN_XMLNode_SetCharValue(n, "PmtInfId", "id");
+  GWEN_XMLNode_SetCharValue(n, "PmtMtd", (doctype[0]==1)?"TRF":"DD");
+  if (withCounts) {
+    GWEN_XMLNode_SetCharValue(n, "BtchBookg", "false");
+    GWEN_XMLNode_SetIntValue(n, "NbOfTxs", pmtinf->tcount);
+    refSetValueString(n, "CtrlSum", pmtinf->value);
+  }
+
+  nn=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "PmtTpInf");
+  GWEN_XMLNode_AddChild(n, nn);
+  GWEN_XMLNode_SetCharValueByPath(nn, GWEN_XML_PATH_FLAGS_OVERWRITE_VALUES, "SvcLvl/Cd", "SEPA");
+  if (doctype[0]==8) {
+    if (!is_8_1_1)
+      GWEN_XMLNode_SetCharValueByPath(nn, GWEN_XML_PATH_FLAGS_OVERWRITE_VALUES, "LclInstrm/Cd", "CORE");
+    GWEN_XMLNode_SetCharValue(nn, "SeqTp", "FRST");
+  }
+
+  refSetDate(n, (doctype[0]==1)?"ReqdExctnDt":"ReqdColltnDt", pmtinf->date);
+  refAddParty(n, (doctype[0]==1)?"Dbtr":"Cdtr", AB_ImExporterAccountInfo_GetOwner(ai));
+  refAddAccount(n, (doctype[0]==1)?"DbtrAcct":"CdtrAcct", AB_ImExporterAccountInfo_GetIban(ai), 0);
+  refAddAgent(n, (doctype[0]==1)?"DbtrAgt":"CdtrAgt", AB_ImExporterAccountInfo_GetBic(ai));
+  GWEN_XMLNode_SetCharValue(n, "ChrgBr", "SLEV");
+
+  if (doctype[0]==8 && !is_8_1_1) {
+    GWEN_XMLNode_SetCharValueByPath(n, GWEN_XML_PATH_FLAGS_OVERWRITE_VALUES,
+                                    "CdtrSchmeId/Id/PrvtId/Othr/Id", AB_Transaction_GetCreditorSchemeId(t));
+    GWEN_XMLNode_SetCharValueByPath(n, GWEN_XML_PATH_FLAGS_OVERWRITE_VALUES,
+                                    "CdtrSchmeId/Id/PrvtId/Othr/SchmeNm/Prtry", "SEPA");
+  }
+
+  for (i=0; i<pmtinf->tcount; i++) {
+    if (doctype[0]==1)
+      refAddTransaction001(n, pmtinf->transactions[i]);
+    else
+      refAddTransaction008(n, pmtinf->transactions[i], is_8_1_1);
+  }
+}
+
+
+
+static int refExport(AB_IMEXPORTER_CONTEXT *ctx, const char *type, const char *xmlns, GWEN_BUFFER *buf)
+{
+  AB_IMEXPORTER_ACCOUNTINFO *ai;
+  AB_TRANSACTION *t;
+  REF_PMTINF pmtinfs[REF_MAX_PMTINF];
+  int pmtinfCount=0;
+  int tcount=0;
+  int doctype[3];
+  GWEN_XMLNODE *root;
+  GWEN_XMLNODE *n;
+  GWEN_XMLNODE *painNode;
+  GWEN_XML_CONTEXT *xmlctx;
+  GWEN_SYNCIO *sio;
+  int i;
+  int rv;
+
+  if (sscanf(type, "%d.%d.%d", &doctype[0], &doctype[1], &doctype[2])!=3)
+    return GWEN_ERROR_INVALID;
+
+  /* group transactions by date (all other PmtInf criteria are the same in this test) */
+  memset(pmtinfs, 0, sizeof(pmtinfs));
+  ai=AB_ImExporterContext_GetFirstAccountInfo(ctx);
+  t=AB_ImExporterAccountInfo_GetFirstTransaction(ai, 0, 0);
+  while (t) {
+    for (i=0; i<pmtinfCount; i++) {
+      if (GWEN_Date_Compare(pmtinfs[i].date, AB_Transaction_GetDate(t))==0)
+        break;
+    }
+    if (i==pmtinfCount) {
+      pmtinfs[i].date=AB_Transaction_GetDate(t);
+      pmtinfs[i].value=AB_Value_new();
+      pmtinfCount++;
+    }
+    pmtinfs[i].transactions[pmtinfs[i].tcount++]=t;
+    AB_Value_AddValue(pmtinfs[i].value, AB_Transaction_GetValue(t));
+    tcount++;
+    t=AB_Transaction_List_Next(t);
+  }
+
+  root=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "root");
+  n=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "?xml");
+  GWEN_XMLNode_AddHeader(root, n);
+  GWEN_XMLNode_SetProperty(n, "version", "1.0");
+  GWEN_XMLNode_SetProperty(n, "encoding", "UTF-8");
+
+  n=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "Document");
+  GWEN_XMLNode_SetProperty(n, "xmlns", xmlns);
+  GWEN_XMLNode_AddChild(root, n);
+
+  if (doctype[0]==1)
+    painNode=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, (doctype[1]>1 || doctype[2]>2)?"CstmrCdtTrfInitn":strstr(xmlns, "pain"));
+  else
+    painNode=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, !(doctype[1]==1 && doctype[2]==1)?"CstmrDrctDbtInitn":strstr(xmlns, "pain"));
+  GWEN_XMLNode_AddChild(n, painNode);
+
+  n=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "GrpHdr");
+  GWEN_XMLNode_AddChild(painNode, n);
+  GWEN_XMLNode_SetCharValue(n, "MsgId", "id");
+  GWEN_XMLNode_SetCharValue(n, "CreDtTm", "time");
+  GWEN_XMLNode_SetIntValue(n, "NbOfTxs", tcount);
+  if (doctype[1]==1 && ((doctype[0]==1 && doctype[2]==2) || (doctype[0]==8 && doctype[2]==1)))
+    GWEN_XMLNode_SetCharValue(n, "Grpg", "GRPD");
+  refAddParty(n, "InitgPty", AB_ImExporterAccountInfo_GetOwner(ai));
+
+  for (i=0; i<pmtinfCount; i++) {
+    refAddPmtInf(painNode, &pmtinfs[i], ai, doctype);
+    AB_Value_free(pmtinfs[i].value);
+  }
+
+  sio=GWEN_SyncIo_Memory_new(buf, 0);
+  xmlctx=GWEN_XmlCtxStore_new(root, GWEN_XML_FLAGS_INDENT | GWEN_XML_FLAGS_SIMPLE | GWEN_XML_FLAGS_HANDLE_HEADERS);
+  rv=GWEN_XMLNode_WriteToStream(root, xmlctx, sio);
+  GWEN_XmlCtx_free(xmlctx);
+  GWEN_SyncIo_free(sio);
+  GWEN_XMLNode_free(root);
+
+  return rv;
+}
+
+
+
+/* replace the content of the given element by "X" (ids and timestamps differ between runs) */
+static void maskElement(GWEN_BUFFER *buf, const char *tagName)
+{
+  GWEN_BUFFER *tbuf;
+  char openTag[64];
+  char closeTag[64];
+  const char *p;
+
+  snprintf(openTag, sizeof(openTag), "<%s>", tagName);
+  snprintf(closeTag, sizeof(closeTag), "</%s>", tagName);
+
+  tbuf=GWEN_Buffer_new(0, GWEN_Buffer_GetUsedBytes(buf)+1, 0, 1);
+  p=GWEN_Buffer_GetStart(buf);
+  for (;;) {
+    const char *pOpen;
+    const char *pClose;
+
+    pOpen=strstr(p, openTag);
+    pClose=pOpen?strstr(pOpen, closeTag):NULL;
+    if (pClose==NULL)
+      break;
+    pOpen+=strlen(openTag);
+    GWEN_Buffer_AppendBytes(tbuf, p, pOpen-p);
+    GWEN_Buffer_AppendByte(tbuf, 'X');
+    p=pClose;
+  }
+  GWEN_Buffer_AppendString(tbuf, p);
+
+  GWEN_Buffer_Reset(buf);
+  GWEN_Buffer_AppendString(buf, GWEN_Buffer_GetStart(tbuf));
+  GWEN_Buffer_free(tbuf);
+}
+
+
+
+static AB_TRANSACTION *createTransaction(const char *date, const char *value,
+                                         const char *remoteName, const char *remoteIban, const char *remoteBic,
+                                         const char *purpose)
+{
+  AB_TRANSACTION *t;
+  GWEN_DATE *dt;
+  AB_VALUE *v;
+
+  t=AB_Transaction_new();
+  dt=GWEN_Date_fromString(date);
+  AB_Transaction_SetDate(t, dt);
+  GWEN_Date_free(dt);
+  v=AB_Value_fromString(value);
+  AB_Value_SetCurrency(v, "EUR");
+  AB_Transaction_SetValue(t, v);
+  AB_Value_free(v);
+  AB_Transaction_SetRemoteName(t, remoteName);
+  AB_Transaction_SetRemoteIban(t, remoteIban);
+  AB_Transaction_SetRemoteBic(t, remoteBic);
+  AB_Transaction_SetPurpose(t, purpose);
+
+  /* direct debit data (ignored for transfers) */
+  dt=GWEN_Date_fromString("20250102");
+  AB_Transaction_SetMandateDate(t, dt);
+  GWEN_Date_free(dt);
+  AB_Transaction_SetCreditorSchemeId(t, "DE98ZZZ09999999999");
+  AB_Transaction_SetSequence(t, AB_Transaction_SequenceFirst);
+  return t;
+}
+
+
+
+/* transactions on two dates (i.e. two PmtInf blocks), with characters which need escaping */
+static AB_IMEXPORTER_CONTEXT *createContext(int withBic)
+{
+  AB_IMEXPORTER_CONTEXT *ctx;
+  AB_IMEXPORTER_ACCOUNTINFO *ai;
+  AB_TRANSACTION *t;
+
+  ctx=AB_ImExporterContext_new();
+  ai=AB_ImExporterAccountInfo_new();
+  AB_ImExporterAccountInfo_SetOwner(ai, "Smith & Sons");
+  AB_ImExporterAccountInfo_SetIban(ai, "DE89370400440532013000");
+  if (withBic)
+    AB_ImExporterAccountInfo_SetBic(ai, "COBADEFFXXX");
+  AB_ImExporterContext_AddAccountInfo(ctx, ai);
+
+  t=createTransaction("20261020", "12,50", "First <Co>", "DE02120300000000202051", "BYLADEM1001", "Invoice 1 & 2");
+  AB_Transaction_SetEndToEndReference(t, "E2E-1");
+  AB_Transaction_SetMandateId(t, "MANDATE-1");
+  AB_ImExporterAccountInfo_AddTransaction(ai, t);
+
+  t=createTransaction("20261021", "100", "Second", "DE02500105170137075030", "INGDDEFFXXX",
+                      "A purpose which is longer than the 140 characters allowed for the unstructured remittance "
+                      "information of a direct debit, so it gets cropped");
+  AB_Transaction_SetMandateId(t, "MANDATE-2");
+  AB_Transaction_SetCustomerReference(t, "CUSTREF-2");
+  AB_Transaction_SetOriginalMandateId(t, "OLD-MANDATE-2");
+  AB_Transaction_SetOriginalCreditorName(t, "Old & Creditor");
+  AB_Transaction_SetOriginalCreditorSchemeId(t, "DE98ZZZ01111111111");
+  AB_Transaction_SetMandateDebitorName(t, "Ultimate Debtor");
+  AB_ImExporterAccountInfo_AddTransaction(ai, t);
+
+  t=createTransaction("20261020", "3,05", "Third", "DE02100500000054540402", withBic?"BELADEBEXXX":NULL, "Rent");
+  AB_Transaction_SetMandateId(t, "MANDATE-3");
+  AB_ImExporterAccountInfo_AddTransaction(ai, t);
+
+  return ctx;
+}
+
+
+
+static int testExport(AB_BANKING *ab, const char *type, const char *xmlns, int withBic)
+{
+  AB_IMEXPORTER_CONTEXT *ctx;
+  GWEN_DB_NODE *dbParams;
+  GWEN_BUFFER *bufExport;
+  GWEN_BUFFER *bufReference;
+  int rv;
+
+  ctx=createContext(withBic);
+
+  dbParams=GWEN_DB_Group_new("params");
+  GWEN_DB_SetCharValue(dbParams, GWEN_DB_FLAGS_OVERWRITE_VARS, "type", type);
+  GWEN_DB_SetCharValue(dbParams, GWEN_DB_FLAGS_OVERWRITE_VARS, "xmlns", xmlns);
+  /* use reserved message ids so the test doesn't need the unique id storage */
+  GWEN_DB_SetIntValue(dbParams, GWEN_DB_FLAGS_OVERWRITE_VARS, "reservedSepaMsgIdFirst", 1);
+  GWEN_DB_SetIntValue(dbParams, GWEN_DB_FLAGS_OVERWRITE_VARS, "reservedSepaMsgIdCount", 100);
+
+  bufExport=GWEN_Buffer_new(0, 4096, 0, 1);
+  bufReference=GWEN_Buffer_new(0, 4096, 0, 1);
+
+  rv=AB_Banking_ExportToBuffer(ab, "sepa", ctx, bufExport, dbParams);
+  if (rv<0) {
+    fprintf(stderr, "%s: Error exporting (%d)\n", type, rv);
+  }
+  else {
+    rv=refExport(ctx, type, xmlns, bufReference);
+    if (rv<0) {
+      fprintf(stderr, "%s: Error creating reference document (%d)\n", type, rv);
+    }
+    else {
+      maskElement(bufExport, "MsgId");
+      maskElement(bufExport, "CreDtTm");
+      maskElement(bufExport, "PmtInfId");
+      maskElement(bufReference, "MsgId");
+      maskElement(bufReference, "CreDtTm");
+      maskElement(bufReference, "PmtInfId");
+      if (strcmp(GWEN_Buffer_GetStart(bufExport), GWEN_Buffer_GetStart(bufReference))!=0) {
+        fprintf(stderr, "%s: Exported document differs from reference.\nExported:\n%s\nReference:\n%s\n",
+                type, GWEN_Buffer_GetStart(bufExport), GWEN_Buffer_GetStart(bufReference));
+        rv=-1;
+      }
+    }
+  }
+
+  GWEN_Buffer_free(bufReference);
+  GWEN_Buffer_free(bufExport);
+  GWEN_DB_Group_free(dbParams);
+  AB_ImExporterContext_free(ctx);
+  return rv;
+}
+
+
+
+int main(int argc, char *argv[])
+{
+#ifdef AQBANKING_WITH_PLUGIN_IMEXPORTER_SEPA
+  AB_BANKING *ab;
+  int result=0;
+  int rv;
+
+  GWEN_Init();
+
+  ab=AB_Banking_new("ab-sepaexport-test", "./ab-sepaexport-test.conf", 0);
+  rv=AB_Banking_Init(ab);
+  if (rv) {
+    fprintf(stderr, "Could not init AqBanking (%d)\n", rv);
+    AB_Banking_free(ab);
+    GWEN_Fini();
+    return 2;
+  }
+
+  if (testExport(ab, "001.001.02", "urn:swift:xsd:$pain.001.001.02", 1)<0 ||
+      testExport(ab, "001.001.03", "urn:iso:std:iso:20022:tech:xsd:pain.001.001.03", 1)<0 ||
+      testExport(ab, "001.003.03", "urn:iso:std:iso:20022:tech:xsd:pain.001.003.03", 0)<0) {
+    fprintf(stderr, "testExport pain.001: FAILED\n");
+    result=-1;
+  }
+  if (testExport(ab, "008.001.01", "urn:swift:xsd:$pain.008.001.01", 1)<0 ||
+      testExport(ab, "008.002.02", "urn:iso:std:iso:20022:tech:xsd:pain.008.002.02", 1)<0 ||
+      testExport(ab, "008.003.02", "urn:iso:std:iso:20022:tech:xsd:pain.008.003.02", 0)<0) {
+    fprintf(stderr, "testExport pain.008: FAILED\n");
+    result=-1;
+  }
+
+  AB_Banking_Fini(ab);
+  AB_Banking_free(ab);
+  GWEN_Fini();
+  return result;
+#else
+  /* SEPA exporter not built */
+  return 77;
+#endif
+}
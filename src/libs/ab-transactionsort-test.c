@@ -0,0 +1,172 @@
+#include <gwenhywfar/gwenhywfar.h>
+#include <aqbanking/banking.h>
+#include <aqbanking/types/transactionsort.h>
+
+#include <string.h>
+
+
+
+static AB_TRANSACTION *createTransaction(const char *date, const char *value, const char *purpose)
+{
+  AB_TRANSACTION *t;
+  GWEN_DATE *dt;
+  AB_VALUE *v;
+
+  t=AB_Transaction_new();
+  dt=GWEN_Date_fromString(date);
+  AB_Transaction_SetDate(t, dt);
+  AB_Transaction_SetValutaDate(t, dt);
+  GWEN_Date_free(dt);
+  v=AB_Value_fromString(value);
+  AB_Transaction_SetValue(t, v);
+  AB_Value_free(v);
+  AB_Transaction_SetPurpose(t, purpose);
+  return t;
+}
+
+
+
+static int checkPurposes(const AB_TRANSACTION_LIST *tl, const char **purposes)
+{
+  const AB_TRANSACTION *t;
+  int i=0;
+
+  t=AB_Transaction_List_First(tl);
+  while (t) {
+    const char *s;
+
+    s=AB_Transaction_GetPurpose(t);
+    if (purposes[i]==NULL || s==NULL || strcmp(s, purposes[i])!=0) {
+      fprintf(stderr, "Unexpected transaction %d (%s)\n", i, s?s:"<none>");
+      return -1;
+    }
+    i++;
+    t=AB_Transaction_List_Next(t);
+  }
+  if (purposes[i]!=NULL) {
+    fprintf(stderr, "Missing transaction %d (%s)\n", i, purposes[i]);
+    return -1;
+  }
+  return 0;
+}
+
+
+
+/* identical bookings within one list are kept, only duplicates of another list are dropped */
+static int testIntraListDuplicates(void)
+{
+  AB_TRANSACTION_LIST *tl;
+  const char *expected[]= {"coffee", "coffee", "rent", NULL};
+  int rv;
+
+  tl=AB_Transaction_List_new();
+  AB_Transaction_List_Add(createTransaction("20261002", "-300", "rent"), tl);
+  AB_Transaction_List_Add(createTransaction("20261001", "-2,50", "coffee"), tl);
+  AB_Transaction_List_Add(createTransaction("20261001", "-2,50", "coffee"), tl);
+
+  rv=AB_Transaction_List_MergeSorted(tl, NULL, 0, NULL, AB_TRANSACTION_MERGE_FLAGS_SORT);
+  if (rv!=0) {
+    fprintf(stderr, "Intra-list duplicate dropped (%d)\n", rv);
+    AB_Transaction_List_free(tl);
+    return -1;
+  }
+  rv=checkPurposes(tl, expected);
+  AB_Transaction_List_free(tl);
+  return rv;
+}
+
+
+
+/* a transaction of the source list which is also in the destination list is dropped once */
+static int testCrossListDuplicates(void)
+{
+  AB_TRANSACTION_LIST *tlDest;
+  AB_TRANSACTION_LIST *tlSrc;
+  const char *expected[]= {"coffee", "coffee", "rent", "salary", NULL};
+  int rv;
+
+  /* destination: two identical bookings */
+  tlDest=AB_Transaction_List_new();
+  AB_Transaction_List_Add(createTransaction("20261001", "-2,50", "coffee"), tlDest);
+  AB_Transaction_List_Add(createTransaction("20261001", "-2,50", "coffee"), tlDest);
+  AB_Transaction_List_Add(createTransaction("20261002", "-300", "rent"), tlDest);
+
+  /* source: overlapping statement which contains one of the two bookings and the rent again */
+  tlSrc=AB_Transaction_List_new();
+  AB_Transaction_List_Add(createTransaction("20261001", "-2,50", "coffee"), tlSrc);
+  AB_Transaction_List_Add(createTransaction("20261002", "-300", "rent"), tlSrc);
+  AB_Transaction_List_Add(createTransaction("20261003", "2000", "salary"), tlSrc);
+
+  rv=AB_Transaction_List_MergeSorted(tlDest, &tlSrc, 1, NULL, AB_TRANSACTION_MERGE_FLAGS_SORT);
+  if (rv!=2) {
+    fprintf(stderr, "Expected 2 dropped duplicates, got %d\n", rv);
+    AB_Transaction_List_free(tlSrc);
+    AB_Transaction_List_free(tlDest);
+    return -1;
+  }
+  if (AB_Transaction_List_GetCount(tlSrc)!=0) {
+    fprintf(stderr, "Source list not empty\n");
+    AB_Transaction_List_free(tlSrc);
+    AB_Transaction_List_free(tlDest);
+    return -1;
+  }
+  rv=checkPurposes(tlDest, expected);
+  AB_Transaction_List_free(tlSrc);
+  AB_Transaction_List_free(tlDest);
+  return rv;
+}
+
+
+
+/* two identical bookings in the source only match one booking of the destination */
+static int testRepeatedCrossListDuplicates(void)
+{
+  AB_TRANSACTION_LIST *tlDest;
+  AB_TRANSACTION_LIST *tlSrc;
+  const char *expected[]= {"coffee", "coffee", NULL};
+  int rv;
+
+  tlDest=AB_Transaction_List_new();
+  AB_Transaction_List_Add(createTransaction("20261001", "-2,50", "coffee"), tlDest);
+
+  tlSrc=AB_Transaction_List_new();
+  AB_Transaction_List_Add(createTransaction("20261001", "-2,50", "coffee"), tlSrc);
+  AB_Transaction_List_Add(createTransaction("20261001", "-2,50", "coffee"), tlSrc);
+
+  rv=AB_Transaction_List_MergeSorted(tlDest, &tlSrc, 1, NULL, AB_TRANSACTION_MERGE_FLAGS_SORT);
+  if (rv!=1) {
+    fprintf(stderr, "Expected 1 dropped duplicate, got %d\n", rv);
+    AB_Transaction_List_free(tlSrc);
+    AB_Transaction_List_free(tlDest);
+    return -1;
+  }
+  rv=checkPurposes(tlDest, expected);
+  AB_Transaction_List_free(tlSrc);
+  AB_Transaction_List_free(tlDest);
+  return rv;
+}
+
+
+
+int main(int argc, char *argv[])
+{
+  int result=0;
+
+  GWEN_Init();
+
+  if (testIntraListDuplicates()<0) {
+    fprintf(stderr, "testIntraListDuplicates: FAILED\n");
+    result=-1;
+  }
+  if (testCrossListDuplicates()<0) {
+    fprintf(stderr, "testCrossListDuplicates: FAILED\n");
+    result=-1;
+  }
+  if (testRepeatedCrossListDuplicates()<0) {
+    fprintf(stderr, "testRepeatedCrossListDuplicates: FAILED\n");
+    result=-1;
+  }
+
+  GWEN_Fini();
+  return result;
+}
@@ -1,8 +1,40 @@
 #include <gwenhywfar/buffer.h>
 #include <aqbanking/banking.h>
 
+#include <stdint.h>
+
 char *input = "1,361.54";
 
+
+
+static int testScaledInt64(const char *s, int scale, int expectedRv, int64_t expectedValue)
+{
+  AB_VALUE *value;
+  int64_t result = 0;
+  int rv;
+
+  value = AB_Value_fromString(s);
+  if (value == NULL) {
+    fprintf(stderr, "Could not parse \"%s\"\n", s);
+    return -1;
+  }
+
+  rv = AB_Value_GetScaledInt64(value, scale, &result);
+  AB_Value_free(value);
+  if (rv != expectedRv) {
+    fprintf(stderr, "AB_Value_GetScaledInt64(\"%s\", %d): returned %d (expected %d)\n", s, scale, rv, expectedRv);
+    return -1;
+  }
+  if (rv == 0 && result != expectedValue) {
+    fprintf(stderr, "AB_Value_GetScaledInt64(\"%s\", %d): got %lld (expected %lld)\n",
+            s, scale, (long long) result, (long long) expectedValue);
+    return -1;
+  }
+  return 0;
+}
+
+
+
 int main(int argc, char *argv[])
 {
   AB_VALUE *value;
@@ -31,5 +63,18 @@ int main(int argc, char *argv[])
   GWEN_Buffer_free(buf2);
   AB_Value_free(value);
 
+  if (testScaledInt64("11,9", 2, 0, 1190) < 0 ||
+      testScaledInt64("1361.54", 2, 0, 136154) < 0 ||
+      testScaledInt64("-12,34", 2, 0, -1234) < 0 ||
+      testScaledInt64("0", 2, 0, 0) < 0 ||
+      testScaledInt64("0,005", 3, 0, 5) < 0 ||
+      testScaledInt64("0,005", 2, GWEN_ERROR_BAD_DATA, 0) < 0 ||
+      testScaledInt64("92233720368547758,07", 2, 0, INT64_MAX) < 0 ||
+      testScaledInt64("92233720368547758,08", 2, GWEN_ERROR_BAD_DATA, 0) < 0 ||
+      testScaledInt64("1", 19, GWEN_ERROR_INVALID, 0) < 0) {
+    fprintf(stderr, "testScaledInt64: FAILED\n");
+    result = -1;
+  }
+
   return result;
 }
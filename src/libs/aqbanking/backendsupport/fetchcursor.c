@@ -0,0 +1,348 @@
+/***************************************************************************
+ begin       : Mon Oct 19 2026
+ copyright   : (C) 2026 by Martin Preuss
+ email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "fetchcursor_l.h"
+
+#include <aqbanking/error.h>
+
+#include <gwenhywfar/debug.h>
+#include <gwenhywfar/stringlist.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * forward declarations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+static int _getCursorJulian(GWEN_DB_NODE *dbCursor);
+static GWEN_STRINGLIST *_readBoundaryKeys(GWEN_DB_NODE *dbCursor, const char *varName);
+static void _addBoundaryKeys(GWEN_DB_NODE *dbCursor, const char *varName, const GWEN_STRINGLIST *sl);
+static void _mergeBoundaryKeys(GWEN_DB_NODE *dbNew, GWEN_DB_NODE *dbStored, const char *varName);
+static int _countBoundaryKey(GWEN_DB_NODE *dbCursor, const char *varName, const char *key, int maxIdx);
+static const char *_getTransactionReference(const AB_TRANSACTION *t);
+static char *_generateBoundaryHash(const AB_TRANSACTION *t);
+
+
+/* ------------------------------------------------------------------------------------------------
+ * implementations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+
+
+void AB_FetchCursor_ApplyToRequest(GWEN_DB_NODE *dbCursor, AB_TRANSACTION *t)
+{
+  const char *s;
+
+  s=GWEN_DB_GetCharValue(dbCursor, "lastBookedDate", 0, NULL);
+  if (s && *s) {
+    GWEN_DATE *dtCursor;
+
+    dtCursor=GWEN_Date_fromString(s);
+    if (dtCursor) {
+      const GWEN_DATE *dtFirst;
+
+      /* the cursor date itself is requested again since more transactions might have been booked on it */
+      dtFirst=AB_Transaction_GetFirstDate(t);
+      if (dtFirst==NULL || GWEN_Date_GetJulian(dtFirst)<GWEN_Date_GetJulian(dtCursor)) {
+        DBG_INFO(AQBANKING_LOGDOMAIN, "Incremental request: Starting at %s", s);
+        AB_Transaction_SetFirstDate(t, dtCursor);
+      }
+      GWEN_Date_free(dtCursor);
+    }
+    else {
+      DBG_WARN(AQBANKING_LOGDOMAIN, "Invalid date in fetch cursor [%s], ignoring", s);
+    }
+  }
+}
+
+
+
+int AB_FetchCursor_FilterAndAdvance(AB_IMEXPORTER_CONTEXT *ctx, GWEN_DB_NODE *dbCursor, uint32_t aid)
+{
+  AB_IMEXPORTER_ACCOUNTINFO *ai;
+  int julianCursor;
+  int julianNew;
+  GWEN_STRINGLIST *oldReferences;
+  GWEN_STRINGLIST *oldHashes;
+  GWEN_STRINGLIST *newReferences;
+  GWEN_STRINGLIST *newHashes;
+  int dropped=0;
+  int rv=0;
+
+  julianCursor=_getCursorJulian(dbCursor);
+  julianNew=julianCursor;
+
+  /* identical transactions may be booked more than once a day, so every stored key only matches once */
+  oldReferences=_readBoundaryKeys(dbCursor, "boundaryReference");
+  oldHashes=_readBoundaryKeys(dbCursor, "boundaryHash");
+  newReferences=GWEN_StringList_new();
+  newHashes=GWEN_StringList_new();
+
+  ai=AB_ImExporterContext_GetFirstAccountInfo(ctx);
+  while (ai) {
+    if (AB_ImExporterAccountInfo_GetAccountId(ai)==aid) {
+      AB_TRANSACTION *t;
+
+      t=AB_ImExporterAccountInfo_GetFirstTransaction(ai, AB_Transaction_TypeStatement, 0);
+      while (t) {
+        AB_TRANSACTION *tNext;
+        const GWEN_DATE *dt;
+
+        tNext=AB_Transaction_List_FindNextByType(t, AB_Transaction_TypeStatement, 0);
+        dt=AB_Transaction_GetDate(t);
+        if (dt) {
+          int julian;
+          const char *reference=NULL;
+          char *hash=NULL;
+
+          julian=GWEN_Date_GetJulian(dt);
+          if (julian==julianCursor || julian>=julianNew) {
+            /* the bank reference survives changes to the other fields (e.g. intraday vs. final statement) */
+            reference=_getTransactionReference(t);
+            if (reference==NULL)
+              hash=_generateBoundaryHash(t);
+          }
+
+          if (julian<julianCursor ||
+              (julian==julianCursor && reference && GWEN_StringList_RemoveString(oldReferences, reference)) ||
+              (julian==julianCursor && hash && GWEN_StringList_RemoveString(oldHashes, hash))) {
+            /* already received by an earlier incremental request */
+            AB_ImExporterAccountInfo_RemoveTransaction(ai, t);
+            AB_Transaction_free(t);
+            dropped++;
+          }
+          else if ((reference || hash) && julian>=julianNew) {
+            if (julian>julianNew) {
+              julianNew=julian;
+              GWEN_StringList_Clear(newReferences);
+              GWEN_StringList_Clear(newHashes);
+            }
+            if (reference)
+              GWEN_StringList_AppendString(newReferences, reference, 0, 0);
+            else
+              GWEN_StringList_AppendString(newHashes, hash, 0, 0);
+          }
+          free(hash);
+        }
+        t=tNext;
+      }
+    }
+    ai=AB_ImExporterAccountInfo_List_Next(ai);
+  }
+  GWEN_StringList_free(oldHashes);
+  GWEN_StringList_free(oldReferences);
+
+  if (dropped)
+    DBG_NOTICE(AQBANKING_LOGDOMAIN, "Dropped %d transaction(s) of account %lu already received earlier",
+               dropped, (unsigned long int) aid);
+
+  if (GWEN_StringList_Count(newReferences) || GWEN_StringList_Count(newHashes)) {
+    if (GWEN_DB_GetIntValue(dbCursor, "failed", 0, 0)) {
+      /* the transactions missing from the failed request would be skipped by the next request otherwise */
+      DBG_NOTICE(AQBANKING_LOGDOMAIN, "Incremental request for account %lu failed, not advancing fetch cursor",
+                 (unsigned long int) aid);
+    }
+    else {
+      if (julianNew>julianCursor) {
+        GWEN_DATE *dtNew;
+
+        dtNew=GWEN_Date_fromJulian(julianNew);
+        GWEN_DB_SetCharValue(dbCursor, GWEN_DB_FLAGS_OVERWRITE_VARS, "lastBookedDate", GWEN_Date_GetString(dtNew));
+        GWEN_Date_free(dtNew);
+        GWEN_DB_DeleteVar(dbCursor, "boundaryReference");
+        GWEN_DB_DeleteVar(dbCursor, "boundaryHash");
+      }
+      _addBoundaryKeys(dbCursor, "boundaryReference", newReferences);
+      _addBoundaryKeys(dbCursor, "boundaryHash", newHashes);
+      rv=1;
+    }
+  }
+
+  GWEN_StringList_free(newHashes);
+  GWEN_StringList_free(newReferences);
+  return rv;
+}
+
+
+
+int AB_FetchCursor_MergeStored(GWEN_DB_NODE *dbNew, GWEN_DB_NODE *dbStored)
+{
+  const char *sStored;
+  const char *sNew;
+  int cmp;
+
+  sStored=GWEN_DB_GetCharValue(dbStored, "lastBookedDate", 0, "");
+  sNew=GWEN_DB_GetCharValue(dbNew, "lastBookedDate", 0, "");
+  cmp=strcmp(sStored, sNew); /* YYYYMMDD */
+  if (cmp>0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Stored fetch cursor is already further advanced (%s > %s)", sStored, sNew);
+    return 0;
+  }
+  else if (cmp==0) {
+    _mergeBoundaryKeys(dbNew, dbStored, "boundaryReference");
+    _mergeBoundaryKeys(dbNew, dbStored, "boundaryHash");
+  }
+
+  return 1;
+}
+
+
+
+int _getCursorJulian(GWEN_DB_NODE *dbCursor)
+{
+  const char *s;
+  int julian=0;
+
+  s=GWEN_DB_GetCharValue(dbCursor, "lastBookedDate", 0, NULL);
+  if (s && *s) {
+    GWEN_DATE *dtCursor;
+
+    dtCursor=GWEN_Date_fromString(s);
+    if (dtCursor) {
+      julian=GWEN_Date_GetJulian(dtCursor);
+      GWEN_Date_free(dtCursor);
+    }
+  }
+
+  return julian;
+}
+
+
+
+GWEN_STRINGLIST *_readBoundaryKeys(GWEN_DB_NODE *dbCursor, const char *varName)
+{
+  GWEN_STRINGLIST *sl;
+  int i;
+
+  sl=GWEN_StringList_new();
+  for (i=0; ; i++) {
+    const char *s;
+
+    s=GWEN_DB_GetCharValue(dbCursor, varName, i, NULL);
+    if (s==NULL)
+      break;
+    GWEN_StringList_AppendString(sl, s, 0, 0);
+  }
+
+  return sl;
+}
+
+
+
+void _addBoundaryKeys(GWEN_DB_NODE *dbCursor, const char *varName, const GWEN_STRINGLIST *sl)
+{
+  GWEN_STRINGLISTENTRY *se;
+
+  se=GWEN_StringList_FirstEntry(sl);
+  while (se) {
+    GWEN_DB_SetCharValue(dbCursor, 0, varName, GWEN_StringListEntry_Data(se));
+    se=GWEN_StringListEntry_Next(se);
+  }
+}
+
+
+
+void _mergeBoundaryKeys(GWEN_DB_NODE *dbNew, GWEN_DB_NODE *dbStored, const char *varName)
+{
+  int i;
+
+  for (i=0; ; i++) {
+    const char *s;
+
+    s=GWEN_DB_GetCharValue(dbStored, varName, i, NULL);
+    if (s==NULL)
+      break;
+    /* keep identical bookings: add every stored key as often as it is stored */
+    if (_countBoundaryKey(dbNew, varName, s, -1)<_countBoundaryKey(dbStored, varName, s, i))
+      GWEN_DB_SetCharValue(dbNew, 0, varName, s);
+  }
+}
+
+
+
+int _countBoundaryKey(GWEN_DB_NODE *dbCursor, const char *varName, const char *key, int maxIdx)
+{
+  int count=0;
+  int i;
+
+  for (i=0; maxIdx<0 || i<=maxIdx; i++) {
+    const char *s;
+
+    s=GWEN_DB_GetCharValue(dbCursor, varName, i, NULL);
+    if (s==NULL)
+      break;
+    if (strcmp(s, key)==0)
+      count++;
+  }
+
+  return count;
+}
+
+
+
+const char *_getTransactionReference(const AB_TRANSACTION *t)
+{
+  const char *s;
+
+  s=AB_Transaction_GetBankReference(t);
+  if (s && *s && strcasecmp(s, "NONREF")!=0)
+    return s;
+
+  /* e.g. camt.053 entry reference */
+  s=AB_Transaction_GetFiId(t);
+  if (s && *s)
+    return s;
+
+  return NULL;
+}
+
+
+
+char *_generateBoundaryHash(const AB_TRANSACTION *t)
+{
+  AB_TRANSACTION *tCopy;
+  const char *s;
+  char *result=NULL;
+  int rv;
+
+  /* only hash what the bank sent, not the ids assigned locally */
+  tCopy=AB_Transaction_dup(t);
+  AB_Transaction_SetUniqueAccountId(tCopy, 0);
+  AB_Transaction_SetUniqueId(tCopy, 0);
+  AB_Transaction_SetRefUniqueId(tCopy, 0);
+  AB_Transaction_SetIdForApplication(tCopy, 0);
+  AB_Transaction_SetStringIdForApplication(tCopy, NULL);
+  AB_Transaction_SetSessionId(tCopy, 0);
+  AB_Transaction_SetGroupId(tCopy, 0);
+
+  rv=AB_Transaction_GenerateHash(tCopy);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+  }
+  else {
+    s=AB_Transaction_GetHash(tCopy);
+    if (s && *s)
+      result=strdup(s);
+  }
+  AB_Transaction_free(tCopy);
+
+  return result;
+}
+
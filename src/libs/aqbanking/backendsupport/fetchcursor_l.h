@@ -0,0 +1,53 @@
+/***************************************************************************
+ begin       : Mon Oct 19 2026
+ copyright   : (C) 2026 by Martin Preuss
+ email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+
+#ifndef AQBANKING_FETCHCURSOR_L_H
+#define AQBANKING_FETCHCURSOR_L_H
+
+
+#include <aqbanking/types/imexporter_context.h>
+#include <aqbanking/types/transaction.h>
+
+#include <gwenhywfar/db.h>
+
+
+/**
+ * Fetch cursors of incremental transaction requests (see provider_fetchcursor.c).
+ *
+ * A fetch cursor is a GWEN_DB group containing
+ * - lastBookedDate: date of the latest booked transaction received so far (YYYYMMDD)
+ * - boundaryReference: bank references of the booked transactions received for that date
+ * - boundaryHash: hashes of the booked transactions received for that date which have no bank reference
+ * - failed: set while one of the current requests for the account failed (never stored)
+ */
+
+
+/**
+ * Let the given request start at the date of the cursor unless it already starts later.
+ */
+void AB_FetchCursor_ApplyToRequest(GWEN_DB_NODE *dbCursor, AB_TRANSACTION *t);
+
+/**
+ * Drop the booked transactions of the given account which have already been received according to the cursor
+ * and advance the cursor to the transactions left. The cursor is not advanced if it is marked as failed.
+ * @return 1 if the cursor has been advanced, 0 otherwise
+ */
+int AB_FetchCursor_FilterAndAdvance(AB_IMEXPORTER_CONTEXT *ctx, GWEN_DB_NODE *dbCursor, uint32_t aid);
+
+/**
+ * Merge a cursor stored meanwhile by another process into a new cursor. The cursor is never moved back.
+ * @return 1 if dbNew is to be stored, 0 if the stored cursor is already further advanced
+ */
+int AB_FetchCursor_MergeStored(GWEN_DB_NODE *dbNew, GWEN_DB_NODE *dbStored);
+
+
+#endif /* AQBANKING_FETCHCURSOR_L_H */
+
@@ -0,0 +1,702 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+
+#include "fixedrecord_p.h"
+
+#include <gwenhywfar/debug.h>
+#include <gwenhywfar/misc.h>
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+
+
+#define AB_FIXEDRECORD_MAXGROUPDEPTH 8
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * forward declarations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+
+static int _addFieldsFromXml(AB_FIXEDRECORD_LAYOUT *rl, GWEN_XMLNODE *nDefs, GWEN_XMLNODE *nParent, int depth);
+static int _addFieldFromXml(AB_FIXEDRECORD_LAYOUT *rl, GWEN_XMLNODE *nElem);
+static int _getFieldView(const AB_FIXEDRECORD_LAYOUT *rl, int idx,
+                         const char *recPtr, int recLen,
+                         const char **pPtr);
+static int _storeField(const AB_FIXEDRECORD_LAYOUT *rl, int idx,
+                       const char *recPtr, int recLen,
+                       const char *currency,
+                       AB_TRANSACTION *t);
+static AB_VALUE *_valueFromCents(const char *s, const char *currency);
+static int _isBlank(unsigned char c);
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * implementations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+
+
+AB_FIXEDRECORD_LAYOUT *AB_FixedRecordLayout_new(const char *recordId)
+{
+  AB_FIXEDRECORD_LAYOUT *rl;
+
+  GWEN_NEW_OBJECT(AB_FIXEDRECORD_LAYOUT, rl);
+  if (recordId)
+    rl->recordId=strdup(recordId);
+  strncpy(rl->dateTemplate, "YYMMDD", sizeof(rl->dateTemplate)-1);
+
+  return rl;
+}
+
+
+
+void AB_FixedRecordLayout_free(AB_FIXEDRECORD_LAYOUT *rl)
+{
+  if (rl) {
+    int i;
+
+    for (i=0; i<rl->fieldCount; i++)
+      free(rl->fields[i].name);
+    free(rl->fields);
+    free(rl->recordId);
+    GWEN_FREE_OBJECT(rl);
+  }
+}
+
+
+
+AB_FIXEDRECORD_LAYOUT *AB_FixedRecordLayout_fromFieldDefs(const char *recordId,
+                                                          const AB_FIXEDRECORD_FIELDDEF *defs)
+{
+  AB_FIXEDRECORD_LAYOUT *rl;
+
+  assert(defs);
+
+  rl=AB_FixedRecordLayout_new(recordId);
+  while (defs->name) {
+    int rv;
+
+    rv=AB_FixedRecordLayout_AddField(rl, defs->name, defs->offset, defs->length, defs->flags, defs->target);
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      AB_FixedRecordLayout_free(rl);
+      return NULL;
+    }
+    defs++;
+  }
+
+  return rl;
+}
+
+
+
+AB_FIXEDRECORD_LAYOUT *AB_FixedRecordLayout_fromXml(GWEN_XMLNODE *nDefs, const char *recordId)
+{
+  GWEN_XMLNODE *n;
+  AB_FIXEDRECORD_LAYOUT *rl;
+  int rv;
+
+  assert(nDefs);
+  assert(recordId);
+
+  n=GWEN_XMLNode_FindFirstTag(nDefs, "SEGs", NULL, NULL);
+  if (n)
+    n=GWEN_XMLNode_FindFirstTag(n, "SEGdef", "id", recordId);
+  if (n==NULL) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Record \"%s\" not defined", recordId);
+    return NULL;
+  }
+
+  rl=AB_FixedRecordLayout_new(recordId);
+  rv=_addFieldsFromXml(rl, nDefs, n, 0);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    AB_FixedRecordLayout_free(rl);
+    return NULL;
+  }
+
+  return rl;
+}
+
+
+
+int AB_FixedRecordLayout_AddField(AB_FIXEDRECORD_LAYOUT *rl,
+                                  const char *name,
+                                  int offset, int length,
+                                  uint32_t flags,
+                                  AB_FIXEDRECORD_TARGET target)
+{
+  AB_FIXEDRECORD_FIELD *f;
+
+  assert(rl);
+  assert(name);
+
+  if (length<1 || length>AB_FIXEDRECORD_MAXFIELDLEN) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Invalid length %d for field \"%s\"", length, name);
+    return GWEN_ERROR_INVALID;
+  }
+
+  if (rl->fieldCount>=rl->fieldsAllocated) {
+    int newCount;
+    AB_FIXEDRECORD_FIELD *newFields;
+
+    newCount=rl->fieldsAllocated?(rl->fieldsAllocated*2):AB_FIXEDRECORD_LAYOUT_INITIAL_FIELDS;
+    newFields=(AB_FIXEDRECORD_FIELD *) realloc(rl->fields, newCount*sizeof(AB_FIXEDRECORD_FIELD));
+    if (newFields==NULL) {
+      DBG_ERROR(AQBANKING_LOGDOMAIN, "Out of memory");
+      return GWEN_ERROR_MEMORY_FULL;
+    }
+    rl->fields=newFields;
+    rl->fieldsAllocated=newCount;
+  }
+
+  if (offset<0) {
+    if (rl->fieldCount) {
+      const AB_FIXEDRECORD_FIELD *fPrev;
+
+      fPrev=&(rl->fields[rl->fieldCount-1]);
+      offset=fPrev->offset+fPrev->length;
+    }
+    else
+      offset=0;
+  }
+
+  f=&(rl->fields[rl->fieldCount]);
+  f->name=strdup(name);
+  f->offset=offset;
+  f->length=length;
+  f->flags=flags;
+  f->target=target;
+
+  if (offset+length>rl->recordLength)
+    rl->recordLength=offset+length;
+
+  return rl->fieldCount++;
+}
+
+
+
+const char *AB_FixedRecordLayout_GetRecordId(const AB_FIXEDRECORD_LAYOUT *rl)
+{
+  assert(rl);
+  return rl->recordId;
+}
+
+
+
+int AB_FixedRecordLayout_GetRecordLength(const AB_FIXEDRECORD_LAYOUT *rl)
+{
+  assert(rl);
+  return rl->recordLength;
+}
+
+
+
+uint32_t AB_FixedRecordLayout_GetFlags(const AB_FIXEDRECORD_LAYOUT *rl)
+{
+  assert(rl);
+  return rl->flags;
+}
+
+
+
+void AB_FixedRecordLayout_SetFlags(AB_FIXEDRECORD_LAYOUT *rl, uint32_t fl)
+{
+  assert(rl);
+  rl->flags=fl;
+}
+
+
+
+void AB_FixedRecordLayout_SetDateTemplate(AB_FIXEDRECORD_LAYOUT *rl, const char *s)
+{
+  assert(rl);
+  memset(rl->dateTemplate, 0, sizeof(rl->dateTemplate));
+  if (s && *s)
+    strncpy(rl->dateTemplate, s, sizeof(rl->dateTemplate)-1);
+  else
+    strncpy(rl->dateTemplate, "YYMMDD", sizeof(rl->dateTemplate)-1);
+}
+
+
+
+int AB_FixedRecordLayout_GetFieldIndex(const AB_FIXEDRECORD_LAYOUT *rl, const char *name)
+{
+  int i;
+
+  assert(rl);
+  assert(name);
+
+  for (i=0; i<rl->fieldCount; i++) {
+    if (strcasecmp(rl->fields[i].name, name)==0)
+      return i;
+  }
+
+  return -1;
+}
+
+
+
+int AB_FixedRecordLayout_GetString(const AB_FIXEDRECORD_LAYOUT *rl, int idx,
+                                   const char *recPtr, int recLen,
+                                   char *buffer, int bufSize)
+{
+  const char *p;
+  int len;
+  int i;
+  int pos=0;
+  int condense;
+
+  assert(rl);
+  assert(buffer);
+  assert(bufSize>0);
+
+  len=_getFieldView(rl, idx, recPtr, recLen, &p);
+  if (len<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", len);
+    return len;
+  }
+
+  condense=(rl->fields[idx].flags & AB_FIXEDRECORD_FIELD_FLAGS_CONDENSE)?1:0;
+  if (!condense && !(rl->flags & AB_FIXEDRECORD_LAYOUT_FLAGS_ISO8859_1)) {
+    if (len>=bufSize)
+      return GWEN_ERROR_BUFFER_OVERFLOW;
+    memmove(buffer, p, len);
+    buffer[len]=0;
+    return len;
+  }
+
+  for (i=0; i<len; i++) {
+    unsigned char c;
+
+    c=(unsigned char) p[i];
+    if (condense && _isBlank(c)) {
+      /* leading and trailing blanks are already gone, so only runs inside the field are left */
+      if (pos && buffer[pos-1]==' ')
+        continue;
+      c=' ';
+    }
+
+    if (c<0x80 || !(rl->flags & AB_FIXEDRECORD_LAYOUT_FLAGS_ISO8859_1)) {
+      if (pos+1>=bufSize)
+        return GWEN_ERROR_BUFFER_OVERFLOW;
+      buffer[pos++]=(char) c;
+    }
+    else {
+      if (pos+2>=bufSize)
+        return GWEN_ERROR_BUFFER_OVERFLOW;
+      buffer[pos++]=(char)(0xc0 | (c>>6));
+      buffer[pos++]=(char)(0x80 | (c & 0x3f));
+    }
+  }
+  buffer[pos]=0;
+
+  return pos;
+}
+
+
+
+int AB_FixedRecordLayout_GetInt(const AB_FIXEDRECORD_LAYOUT *rl, int idx,
+                                const char *recPtr, int recLen,
+                                int *pResult)
+{
+  const char *p;
+  int len;
+  int i;
+  int res=0;
+
+  len=_getFieldView(rl, idx, recPtr, recLen, &p);
+  if (len<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", len);
+    return len;
+  }
+  if (len==0)
+    return GWEN_ERROR_NO_DATA;
+
+  for (i=0; i<len; i++) {
+    if (p[i]<'0' || p[i]>'9') {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "Non-digit in numeric field \"%s\"", rl->fields[idx].name);
+      return GWEN_ERROR_BAD_DATA;
+    }
+    res=(res*10)+(p[i]-'0');
+  }
+
+  *pResult=res;
+  return 0;
+}
+
+
+
+GWEN_DATE *AB_FixedRecordLayout_GetDate(const AB_FIXEDRECORD_LAYOUT *rl, int idx,
+                                        const char *recPtr, int recLen)
+{
+  const AB_FIXEDRECORD_FIELD *f;
+  const char *tmpl;
+  const char *p;
+  int len;
+  int i;
+  int y=0, m=0, d=0;
+  int yDigits=0;
+
+  assert(rl);
+  if (idx<0 || idx>=rl->fieldCount)
+    return NULL;
+
+  /* use the raw field data here, positions in the template refer to it */
+  f=&(rl->fields[idx]);
+  if (f->offset>=recLen)
+    return NULL;
+  p=recPtr+f->offset;
+  len=f->length;
+  if (f->offset+len>recLen)
+    len=recLen-f->offset;
+
+  tmpl=rl->dateTemplate;
+  for (i=0; tmpl[i]; i++) {
+    char c;
+
+    c=tmpl[i];
+    if (c=='Y' || c=='M' || c=='D') {
+      int v;
+
+      if (i>=len || p[i]<'0' || p[i]>'9')
+        return NULL;
+      v=p[i]-'0';
+      if (c=='Y') {
+        y=(y*10)+v;
+        yDigits++;
+      }
+      else if (c=='M')
+        m=(m*10)+v;
+      else
+        d=(d*10)+v;
+    }
+  }
+
+  if (yDigits==0 || m==0 || d==0)
+    return NULL;
+  if (yDigits<=2)
+    y+=(y>80)?1900:2000;
+
+  return GWEN_Date_fromGregorian(y, m, d);
+}
+
+
+
+int AB_FixedRecordLayout_DecodeTransaction(const AB_FIXEDRECORD_LAYOUT *rl,
+                                           const char *recPtr, int recLen,
+                                           const char *currency,
+                                           AB_TRANSACTION *t)
+{
+  int i;
+
+  assert(rl);
+  assert(t);
+
+  for (i=0; i<rl->fieldCount; i++) {
+    if (rl->fields[i].target!=AB_FixedRecordTarget_None) {
+      int rv;
+
+      rv=_storeField(rl, i, recPtr, recLen, currency, t);
+      if (rv<0) {
+        DBG_INFO(AQBANKING_LOGDOMAIN, "Error in field \"%s\" of record \"%s\" (%d)",
+                 rl->fields[i].name, rl->recordId?rl->recordId:"", rv);
+        return rv;
+      }
+    }
+  }
+
+  return 0;
+}
+
+
+
+AB_FIXEDRECORD_TARGET AB_FixedRecordTarget_fromString(const char *s)
+{
+  if (s && *s) {
+    if (strcasecmp(s, "localBankCode")==0)
+      return AB_FixedRecordTarget_LocalBankCode;
+    else if (strcasecmp(s, "localAccountNumber")==0)
+      return AB_FixedRecordTarget_LocalAccountNumber;
+    else if (strcasecmp(s, "remoteBankCode")==0)
+      return AB_FixedRecordTarget_RemoteBankCode;
+    else if (strcasecmp(s, "remoteAccountNumber")==0)
+      return AB_FixedRecordTarget_RemoteAccountNumber;
+    else if (strcasecmp(s, "remoteName")==0)
+      return AB_FixedRecordTarget_RemoteName;
+    else if (strcasecmp(s, "customerReference")==0)
+      return AB_FixedRecordTarget_CustomerReference;
+    else if (strcasecmp(s, "bankReference")==0)
+      return AB_FixedRecordTarget_BankReference;
+    else if (strcasecmp(s, "transactionKey")==0)
+      return AB_FixedRecordTarget_TransactionKey;
+    else if (strcasecmp(s, "value")==0)
+      return AB_FixedRecordTarget_Value;
+    else if (strcasecmp(s, "date")==0)
+      return AB_FixedRecordTarget_Date;
+    else if (strcasecmp(s, "valutaDate")==0)
+      return AB_FixedRecordTarget_ValutaDate;
+    else if (strcasecmp(s, "purpose")==0)
+      return AB_FixedRecordTarget_Purpose;
+  }
+
+  return AB_FixedRecordTarget_None;
+}
+
+
+
+int _addFieldsFromXml(AB_FIXEDRECORD_LAYOUT *rl, GWEN_XMLNODE *nDefs, GWEN_XMLNODE *nParent, int depth)
+{
+  GWEN_XMLNODE *n;
+
+  if (depth>AB_FIXEDRECORD_MAXGROUPDEPTH) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Groups nested too deeply");
+    return GWEN_ERROR_INVALID;
+  }
+
+  n=GWEN_XMLNode_GetFirstTag(nParent);
+  while (n) {
+    const char *sTagName;
+    int rv=0;
+
+    sTagName=GWEN_XMLNode_GetData(n);
+    if (sTagName && strcasecmp(sTagName, "ELEM")==0)
+      rv=_addFieldFromXml(rl, n);
+    else if (sTagName && strcasecmp(sTagName, "GROUP")==0) {
+      const char *sType;
+      GWEN_XMLNODE *nGroup=NULL;
+
+      sType=GWEN_XMLNode_GetProperty(n, "type", NULL);
+      if (sType) {
+        nGroup=GWEN_XMLNode_FindFirstTag(nDefs, "GROUPs", NULL, NULL);
+        if (nGroup)
+          nGroup=GWEN_XMLNode_FindFirstTag(nGroup, "GROUPdef", "id", sType);
+      }
+      if (nGroup==NULL) {
+        DBG_ERROR(AQBANKING_LOGDOMAIN, "Group \"%s\" not defined", sType?sType:"<no type>");
+        return GWEN_ERROR_INVALID;
+      }
+      rv=_addFieldsFromXml(rl, nDefs, nGroup, depth+1);
+    }
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      return rv;
+    }
+
+    n=GWEN_XMLNode_GetNextTag(n);
+  }
+
+  return 0;
+}
+
+
+
+int _addFieldFromXml(AB_FIXEDRECORD_LAYOUT *rl, GWEN_XMLNODE *nElem)
+{
+  const char *sName;
+  int size;
+  uint32_t flags=0;
+  int rv;
+
+  sName=GWEN_XMLNode_GetProperty(nElem, "name", NULL);
+  size=atoi(GWEN_XMLNode_GetProperty(nElem, "size", "0"));
+  if (sName==NULL || size<1) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Element without name or size");
+    return GWEN_ERROR_INVALID;
+  }
+
+  if (atoi(GWEN_XMLNode_GetProperty(nElem, "lfiller", "0"))=='0')
+    flags|=AB_FIXEDRECORD_FIELD_FLAGS_STRIPZEROES;
+  if (atoi(GWEN_XMLNode_GetProperty(nElem, "condense", "0")))
+    flags|=AB_FIXEDRECORD_FIELD_FLAGS_CONDENSE;
+
+  rv=AB_FixedRecordLayout_AddField(rl, sName, -1, size, flags,
+                                   AB_FixedRecordTarget_fromString(GWEN_XMLNode_GetProperty(nElem, "target", NULL)));
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  return 0;
+}
+
+
+
+/* returns the length of the cleaned up field data and stores a pointer to it */
+int _getFieldView(const AB_FIXEDRECORD_LAYOUT *rl, int idx,
+                  const char *recPtr, int recLen,
+                  const char **pPtr)
+{
+  const AB_FIXEDRECORD_FIELD *f;
+  const char *p;
+  int len;
+
+  assert(rl);
+  if (idx<0 || idx>=rl->fieldCount) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Invalid field index %d", idx);
+    return GWEN_ERROR_INVALID;
+  }
+
+  f=&(rl->fields[idx]);
+  if (recPtr==NULL || f->offset>=recLen) {
+    *pPtr="";
+    return 0;
+  }
+
+  p=recPtr+f->offset;
+  len=f->length;
+  if (f->offset+len>recLen)
+    len=recLen-f->offset;
+
+  if (f->flags & AB_FIXEDRECORD_FIELD_FLAGS_CONDENSE) {
+    while (len && _isBlank((unsigned char) *p)) {
+      p++;
+      len--;
+    }
+    while (len && _isBlank((unsigned char) p[len-1]))
+      len--;
+  }
+
+  if (f->flags & AB_FIXEDRECORD_FIELD_FLAGS_STRIPZEROES) {
+    while (len>1 && *p=='0') {
+      p++;
+      len--;
+    }
+  }
+
+  *pPtr=p;
+  return len;
+}
+
+
+
+int _storeField(const AB_FIXEDRECORD_LAYOUT *rl, int idx,
+                const char *recPtr, int recLen,
+                const char *currency,
+                AB_TRANSACTION *t)
+{
+  char buffer[AB_FIXEDRECORD_MAXSTRINGSIZE];
+  AB_FIXEDRECORD_TARGET target;
+  int len;
+
+  target=rl->fields[idx].target;
+
+  if (target==AB_FixedRecordTarget_Date || target==AB_FixedRecordTarget_ValutaDate) {
+    GWEN_DATE *da;
+
+    da=AB_FixedRecordLayout_GetDate(rl, idx, recPtr, recLen);
+    if (da) {
+      if (target==AB_FixedRecordTarget_Date)
+        AB_Transaction_SetDate(t, da);
+      else
+        AB_Transaction_SetValutaDate(t, da);
+      GWEN_Date_free(da);
+    }
+    else {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "Empty or invalid date in field \"%s\", ignoring", rl->fields[idx].name);
+    }
+    return 0;
+  }
+
+  len=AB_FixedRecordLayout_GetString(rl, idx, recPtr, recLen, buffer, sizeof(buffer));
+  if (len<0)
+    return len;
+  if (len==0)
+    return 0;
+
+  switch (target) {
+  case AB_FixedRecordTarget_LocalBankCode:
+    AB_Transaction_SetLocalBankCode(t, buffer);
+    break;
+  case AB_FixedRecordTarget_LocalAccountNumber:
+    AB_Transaction_SetLocalAccountNumber(t, buffer);
+    break;
+  case AB_FixedRecordTarget_RemoteBankCode:
+    AB_Transaction_SetRemoteBankCode(t, buffer);
+    break;
+  case AB_FixedRecordTarget_RemoteAccountNumber:
+    AB_Transaction_SetRemoteAccountNumber(t, buffer);
+    break;
+  case AB_FixedRecordTarget_RemoteName:
+    AB_Transaction_SetRemoteName(t, buffer);
+    break;
+  case AB_FixedRecordTarget_CustomerReference:
+    AB_Transaction_SetCustomerReference(t, buffer);
+    break;
+  case AB_FixedRecordTarget_BankReference:
+    AB_Transaction_SetBankReference(t, buffer);
+    break;
+  case AB_FixedRecordTarget_TransactionKey:
+    AB_Transaction_SetTransactionKey(t, buffer);
+    break;
+  case AB_FixedRecordTarget_Purpose:
+    AB_Transaction_AddPurposeLine(t, buffer);
+    break;
+  case AB_FixedRecordTarget_Value: {
+    AB_VALUE *v;
+
+    v=_valueFromCents(buffer, currency);
+    if (v==NULL)
+      return GWEN_ERROR_BAD_DATA;
+    AB_Transaction_SetValue(t, v);
+    AB_Value_free(v);
+    break;
+  }
+  default:
+    break;
+  }
+
+  return 0;
+}
+
+
+
+AB_VALUE *_valueFromCents(const char *s, const char *currency)
+{
+  char numbuf[AB_FIXEDRECORD_MAXFIELDLEN+32];
+  const char *p;
+
+  for (p=s; *p; p++) {
+    if (*p<'0' || *p>'9') {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "Non-digit in amount [%s]", s);
+      return NULL;
+    }
+  }
+
+  if (currency && *currency)
+    snprintf(numbuf, sizeof(numbuf), "%s/100:%s", s, currency);
+  else
+    snprintf(numbuf, sizeof(numbuf), "%s/100", s);
+  return AB_Value_fromString(numbuf);
+}
+
+
+
+/* like GWEN_Text_CondenseBuffer() every control character counts as blank */
+int _isBlank(unsigned char c)
+{
+  return (c<33)?1:0;
+}
+
+
@@ -0,0 +1,211 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+/** @file fixedrecord.h
+ * @short Decoder for fixed-width record formats used by importer plugins.
+ */
+
+
+#ifndef AQBANKING_FIXEDRECORD_H
+#define AQBANKING_FIXEDRECORD_H
+
+
+#include <aqbanking/error.h> /* for AQBANKING_API */
+#include <aqbanking/types/transaction.h>
+
+#include <gwenhywfar/xml.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * A record layout describes the fields of one type of fixed-width record (offset, length, how to clean up
+ * the field data and which member of an @ref AB_TRANSACTION receives the field).
+ *
+ * Layouts are compiled once (either from a table of @ref AB_FIXEDRECORD_FIELDDEF or from an XML description
+ * in the format of the message engine's SEGdef/GROUPdef elements) and can then be used to decode any number
+ * of records. Decoding works directly on the record data and only uses stack buffers, the only memory
+ * allocated is that of the transaction members set.
+ */
+typedef struct AB_FIXEDRECORD_LAYOUT AB_FIXEDRECORD_LAYOUT;
+
+
+/** Maximum length of a single field. */
+#define AB_FIXEDRECORD_MAXFIELDLEN 256
+
+/**
+ * Size of a buffer which can receive any field via @ref AB_FixedRecordLayout_GetString
+ * (a field may double in size when transformed from ISO-8859-1 to UTF-8).
+ */
+#define AB_FIXEDRECORD_MAXSTRINGSIZE ((AB_FIXEDRECORD_MAXFIELDLEN*2)+1)
+
+
+/** remove leading and trailing blanks and replace every run of blanks inside the field by a single space */
+#define AB_FIXEDRECORD_FIELD_FLAGS_CONDENSE      0x00000001
+/** remove leading zeroes (but leave at least one digit) */
+#define AB_FIXEDRECORD_FIELD_FLAGS_STRIPZEROES   0x00000002
+
+
+/** the field data is encoded in ISO-8859-1 and needs to be transformed to UTF-8 */
+#define AB_FIXEDRECORD_LAYOUT_FLAGS_ISO8859_1    0x00000001
+
+
+/**
+ * Member of the transaction which receives the content of a field when decoding a record via
+ * @ref AB_FixedRecordLayout_DecodeTransaction.
+ */
+typedef enum {
+  AB_FixedRecordTarget_None=0,           /**< field is not stored in the transaction */
+  AB_FixedRecordTarget_LocalBankCode,
+  AB_FixedRecordTarget_LocalAccountNumber,
+  AB_FixedRecordTarget_RemoteBankCode,
+  AB_FixedRecordTarget_RemoteAccountNumber,
+  AB_FixedRecordTarget_RemoteName,
+  AB_FixedRecordTarget_CustomerReference,
+  AB_FixedRecordTarget_BankReference,
+  AB_FixedRecordTarget_TransactionKey,
+  AB_FixedRecordTarget_Value,            /**< amount in cents (only digits) */
+  AB_FixedRecordTarget_Date,             /**< booking date according to the date template of the layout */
+  AB_FixedRecordTarget_ValutaDate,       /**< valuta date according to the date template of the layout */
+  AB_FixedRecordTarget_Purpose           /**< added as purpose line if not empty */
+} AB_FIXEDRECORD_TARGET;
+
+
+/**
+ * Entry of a static field table used with @ref AB_FixedRecordLayout_fromFieldDefs.
+ * The table is terminated by an entry with name==NULL.
+ */
+typedef struct AB_FIXEDRECORD_FIELDDEF AB_FIXEDRECORD_FIELDDEF;
+struct AB_FIXEDRECORD_FIELDDEF {
+  const char *name;
+  int offset;                    /**< -1: field directly follows the previous one */
+  int length;
+  uint32_t flags;                /**< see AB_FIXEDRECORD_FIELD_FLAGS_* */
+  AB_FIXEDRECORD_TARGET target;
+};
+
+
+
+AQBANKING_API AB_FIXEDRECORD_LAYOUT *AB_FixedRecordLayout_new(const char *recordId);
+AQBANKING_API void AB_FixedRecordLayout_free(AB_FIXEDRECORD_LAYOUT *rl);
+
+/**
+ * Compile a layout from a static field table.
+ */
+AQBANKING_API AB_FIXEDRECORD_LAYOUT *AB_FixedRecordLayout_fromFieldDefs(const char *recordId,
+                                                                        const AB_FIXEDRECORD_FIELDDEF *defs);
+
+/**
+ * Compile a layout from the SEGdef with the given id below the given XML node.
+ *
+ * Only the attributes relevant to fixed-width records are used: ELEM elements provide "name", "size",
+ * "lfiller" (48 strips leading zeroes), "condense" and "target" (name of the transaction member,
+ * see @ref AB_FixedRecordTarget_fromString), GROUP elements with a "type" attribute include the GROUPdef
+ * with that id.
+ */
+AQBANKING_API AB_FIXEDRECORD_LAYOUT *AB_FixedRecordLayout_fromXml(GWEN_XMLNODE *nDefs, const char *recordId);
+
+
+/**
+ * Append a field to the layout.
+ * @return index of the new field or error code
+ * @param rl layout
+ * @param name field name
+ * @param offset offset of the field within the record (-1: directly behind the previous field)
+ * @param length length of the field in bytes
+ * @param flags see AB_FIXEDRECORD_FIELD_FLAGS_*
+ * @param target transaction member to receive the field content
+ */
+AQBANKING_API int AB_FixedRecordLayout_AddField(AB_FIXEDRECORD_LAYOUT *rl,
+                                                const char *name,
+                                                int offset, int length,
+                                                uint32_t flags,
+                                                AB_FIXEDRECORD_TARGET target);
+
+AQBANKING_API const char *AB_FixedRecordLayout_GetRecordId(const AB_FIXEDRECORD_LAYOUT *rl);
+
+/** Minimum number of bytes a record needs to contain all fields of this layout. */
+AQBANKING_API int AB_FixedRecordLayout_GetRecordLength(const AB_FIXEDRECORD_LAYOUT *rl);
+
+AQBANKING_API uint32_t AB_FixedRecordLayout_GetFlags(const AB_FIXEDRECORD_LAYOUT *rl);
+AQBANKING_API void AB_FixedRecordLayout_SetFlags(AB_FIXEDRECORD_LAYOUT *rl, uint32_t fl);
+
+/**
+ * Set the template for date fields. Only the characters 'Y', 'M' and 'D' are used, all other characters
+ * are skipped. Two-digit years are mapped to 1981-2080. Default is "YYMMDD".
+ */
+AQBANKING_API void AB_FixedRecordLayout_SetDateTemplate(AB_FIXEDRECORD_LAYOUT *rl, const char *s);
+
+/**
+ * Lookup the index of a field by name (case-insensitive). Should be done once after compiling the layout.
+ * @return index or -1 if not found
+ */
+AQBANKING_API int AB_FixedRecordLayout_GetFieldIndex(const AB_FIXEDRECORD_LAYOUT *rl, const char *name);
+
+
+/**
+ * Copy the cleaned up content of the given field into the given buffer.
+ * The content is transformed to UTF-8 if the layout has the flag @ref AB_FIXEDRECORD_LAYOUT_FLAGS_ISO8859_1.
+ * @return length of the string stored in the buffer (without trailing zero) or error code
+ * @param rl layout
+ * @param idx index of the field
+ * @param recPtr pointer to the record data
+ * @param recLen length of the record data (fields beyond the end of the record are empty)
+ * @param buffer buffer to receive the zero-terminated string
+ * @param bufSize size of the buffer
+ */
+AQBANKING_API int AB_FixedRecordLayout_GetString(const AB_FIXEDRECORD_LAYOUT *rl, int idx,
+                                                 const char *recPtr, int recLen,
+                                                 char *buffer, int bufSize);
+
+/**
+ * Read a field containing only digits (after cleaning up).
+ * @return 0 if ok, GWEN_ERROR_NO_DATA if the field is empty, GWEN_ERROR_BAD_DATA if there are non-digits
+ */
+AQBANKING_API int AB_FixedRecordLayout_GetInt(const AB_FIXEDRECORD_LAYOUT *rl, int idx,
+                                              const char *recPtr, int recLen,
+                                              int *pResult);
+
+/**
+ * Read a date field according to the date template of the layout.
+ * @return date (to be freed by the caller) or NULL if the field is empty or invalid
+ */
+AQBANKING_API GWEN_DATE *AB_FixedRecordLayout_GetDate(const AB_FIXEDRECORD_LAYOUT *rl, int idx,
+                                                      const char *recPtr, int recLen);
+
+/**
+ * Store all fields with a target into the given transaction.
+ * Fields which are empty after cleaning up are not stored.
+ * @return 0 if ok, error code otherwise
+ * @param rl layout
+ * @param recPtr pointer to the record data
+ * @param recLen length of the record data
+ * @param currency currency to set for AB_FixedRecordTarget_Value (may be NULL)
+ * @param t transaction to receive the data
+ */
+AQBANKING_API int AB_FixedRecordLayout_DecodeTransaction(const AB_FIXEDRECORD_LAYOUT *rl,
+                                                         const char *recPtr, int recLen,
+                                                         const char *currency,
+                                                         AB_TRANSACTION *t);
+
+
+AQBANKING_API AB_FIXEDRECORD_TARGET AB_FixedRecordTarget_fromString(const char *s);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* AQBANKING_FIXEDRECORD_H */
+
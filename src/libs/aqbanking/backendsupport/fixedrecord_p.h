@@ -0,0 +1,47 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+
+#ifndef AQBANKING_FIXEDRECORD_P_H
+#define AQBANKING_FIXEDRECORD_P_H
+
+
+#include "fixedrecord.h"
+
+
+#define AB_FIXEDRECORD_LAYOUT_INITIAL_FIELDS 16
+#define AB_FIXEDRECORD_MAXDATETEMPLATE       16
+
+
+typedef struct AB_FIXEDRECORD_FIELD AB_FIXEDRECORD_FIELD;
+struct AB_FIXEDRECORD_FIELD {
+  char *name;
+  int offset;
+  int length;
+  uint32_t flags;
+  AB_FIXEDRECORD_TARGET target;
+};
+
+
+struct AB_FIXEDRECORD_LAYOUT {
+  char *recordId;
+  uint32_t flags;
+  char dateTemplate[AB_FIXEDRECORD_MAXDATETEMPLATE];
+
+  int recordLength;
+
+  AB_FIXEDRECORD_FIELD *fields;
+  int fieldCount;
+  int fieldsAllocated;
+};
+
+
+#endif
+
@@ -13,6 +13,7 @@
 #endif
 
 #include "imexporter_p.h"
+#include "aqbanking/banking_be.h"
 
 #include <gwenhywfar/debug.h>
 #include <gwenhywfar/misc.h>
@@ -22,6 +23,7 @@
 
 #include <assert.h>
 #include <ctype.h>
+#include <string.h>
 
 
 GWEN_INHERIT_FUNCTIONS(AB_IMEXPORTER)
@@ -232,6 +234,76 @@ void AB_ImExporter_SetLibLoader(AB_IMEXPORTER *ie, GWEN_LIBLOADER *ll)
 
 
 
+uint32_t AB_ImExporter_GetNextSepaMessageId(AB_IMEXPORTER *ie, GWEN_DB_NODE *params)
+{
+  int count;
+
+  assert(ie);
+
+  count=params?GWEN_DB_GetIntValue(params, AB_IMEXPORTER_PARAMS_SEPAMSGID_COUNT, 0, 0):0;
+  if (count>0) {
+    int uid;
+
+    /* take next id from the block reserved by the caller */
+    uid=GWEN_DB_GetIntValue(params, AB_IMEXPORTER_PARAMS_SEPAMSGID_FIRST, 0, 0);
+    if (uid>0) {
+      GWEN_DB_SetIntValue(params, GWEN_DB_FLAGS_OVERWRITE_VARS, AB_IMEXPORTER_PARAMS_SEPAMSGID_FIRST, uid+1);
+      GWEN_DB_SetIntValue(params, GWEN_DB_FLAGS_OVERWRITE_VARS, AB_IMEXPORTER_PARAMS_SEPAMSGID_COUNT, count-1);
+      return (uint32_t) uid;
+    }
+  }
+
+  return AB_Banking_GetNamedUniqueId(ie->banking, "sepamsg", 1);
+}
+
+
+
+void AB_ImExporter_SetTransactionFn(AB_IMEXPORTER *ie, AB_IMEXPORTER_TRANSACTION_FN fn, void *user_data)
+{
+  assert(ie);
+  ie->transactionFn=fn;
+  ie->transactionFnUserData=user_data;
+}
+
+
+
+int AB_ImExporter_HasTransactionFn(const AB_IMEXPORTER *ie)
+{
+  assert(ie);
+  return (ie->transactionFn!=NULL)?1:0;
+}
+
+
+
+int AB_ImExporter_DeliverTransaction(AB_IMEXPORTER *ie, AB_IMEXPORTER_ACCOUNTINFO *ai, AB_TRANSACTION *t)
+{
+  assert(ie);
+  assert(t);
+
+  if (ie->transactionFn) {
+    int rv;
+
+    rv=ie->transactionFn(ai, t, ie->transactionFnUserData);
+    AB_Transaction_free(t);
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      return rv;
+    }
+    return 0;
+  }
+
+  if (ai==NULL) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Transaction without account info");
+    AB_Transaction_free(t);
+    return GWEN_ERROR_INVALID;
+  }
+
+  AB_ImExporterAccountInfo_AddTransaction(ai, t);
+  return 0;
+}
+
+
+
 
 
 
@@ -395,15 +467,71 @@ GWEN_TIME *AB_ImExporter_DateFromString(const char *p, const char *tmpl,
 }
 
 
+/* masks used to check 8 bytes at once for bytes which are not plain printable ASCII (i.e. <32, 127 or >127) */
+#define AB_IMEXPORTER_ONES  0x0101010101010101ULL
+#define AB_IMEXPORTER_HIGHS 0x8080808080808080ULL
+
+
+/* return pointer to the first byte in [p, pEnd) which is not in the range 32-126 (or pEnd) */
+static const char *_skipPlainAscii(const char *p, const char *pEnd)
+{
+  while (pEnd-p>=8) {
+    uint64_t w;
+    uint64_t special;
+
+    memcpy(&w, p, 8);
+    special=(w & AB_IMEXPORTER_HIGHS) |                                   /* >127 */
+            ((w-AB_IMEXPORTER_ONES*32) & ~w & AB_IMEXPORTER_HIGHS) |      /* <32 */
+            (((w ^ (AB_IMEXPORTER_ONES*127))-AB_IMEXPORTER_ONES) &
+             ~(w ^ (AB_IMEXPORTER_ONES*127)) & AB_IMEXPORTER_HIGHS);      /* ==127 */
+    if (special)
+      break;
+    p+=8;
+  }
+
+  while (p<pEnd) {
+    unsigned int c;
+
+    c=(unsigned char)(*p);
+    if (c<32 || c>126)
+      break;
+    p++;
+  }
+
+  return p;
+}
+
+
+
 void AB_ImExporter_Iso8859_1ToUtf8(const char *p,
                                    int size,
                                    GWEN_BUFFER *buf)
 {
-  while (*p) {
+  const char *pEnd;
+
+  if (size<0)
+    pEnd=p+strlen(p);
+  else {
+    pEnd=(const char *) memchr(p, 0, size);
+    if (pEnd==NULL)
+      pEnd=p+size;
+  }
+
+  /* worst case: every byte becomes two */
+  GWEN_Buffer_AllocRoom(buf, 2*(pEnd-p)+1);
+
+  while (p<pEnd) {
+    const char *pRunEnd;
     unsigned int c;
 
-    if (!size)
-      break;
+    /* copy runs of plain ASCII at once */
+    pRunEnd=_skipPlainAscii(p, pEnd);
+    if (pRunEnd>p) {
+      GWEN_Buffer_AppendBytes(buf, p, pRunEnd-p);
+      p=pRunEnd;
+      if (p>=pEnd)
+        break;
+    }
 
     c=(unsigned char)(*(p++));
     if (c<32 || c==127)
@@ -413,16 +541,25 @@ void AB_ImExporter_Iso8859_1ToUtf8(const char *p,
       c &= ~0x40;
     }
     GWEN_Buffer_AppendByte(buf, c);
-    if (size!=-1)
-      size--;
   } /* while */
 }
 
 
 
+int AB_ImExporter_Iso8859_1IsPlainAscii(const char *p, int size)
+{
+  const char *pEnd;
+
+  pEnd=p+((size<0)?strlen(p):size);
+  return (_skipPlainAscii(p, pEnd)==pEnd)?1:0;
+}
+
+
+
 int AB_ImExporter__Transform_Var(GWEN_DB_NODE *db, int level)
 {
   GWEN_DB_NODE *dbC;
+  GWEN_BUFFER *vbuf=NULL;
 
   dbC=GWEN_DB_GetFirstValue(db);
   while (dbC) {
@@ -433,17 +570,18 @@ int AB_ImExporter__Transform_Var(GWEN_DB_NODE *db, int level)
       s=GWEN_DB_GetCharValueFromNode(dbC);
       assert(s);
       l=strlen(s);
-      if (l) {
-        GWEN_BUFFER *vbuf;
-
-        vbuf=GWEN_Buffer_new(0, 1+(l*15/10), 0, 1);
+      /* most values are plain ASCII and can be kept as they are */
+      if (l && !AB_ImExporter_Iso8859_1IsPlainAscii(s, l)) {
+        if (vbuf==NULL)
+          vbuf=GWEN_Buffer_new(0, 1+(l*15/10), 0, 1);
         AB_ImExporter_Iso8859_1ToUtf8(s, l, vbuf);
         GWEN_DB_SetCharValueInNode(dbC, GWEN_Buffer_GetStart(vbuf));
-        GWEN_Buffer_free(vbuf);
+        GWEN_Buffer_Reset(vbuf);
       }
     }
     dbC=GWEN_DB_GetNextValue(dbC);
   }
+  GWEN_Buffer_free(vbuf);
 
   return 0;
 }
@@ -50,6 +50,13 @@
 /** This module supports the function @ref AB_ImExporter_GetEditProfileDialog */
 #define AB_IMEXPORTER_FLAGS_GETPROFILEEDITOR_SUPPORTED 0x00000001
 
+/**
+ * This module hands every transaction to the callback given to @ref AB_Banking_ImportWithTransactionFn
+ * as soon as it has been read and doesn't keep it (i.e. memory usage doesn't grow with the number of
+ * transactions in the input).
+ */
+#define AB_IMEXPORTER_FLAGS_STREAMING_IMPORT           0x00000002
+
 
 /*@}*/
 
@@ -72,6 +79,28 @@ GWEN_INHERIT_FUNCTION_DEFS(AB_IMEXPORTER)
 #include <aqbanking/banking.h>
 
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Callback receiving transactions during @ref AB_Banking_ImportWithTransactionFn.
+ *
+ * The transaction is freed by the caller after this function returns, so the callback must copy it
+ * (e.g. via @ref AB_Transaction_dup) if it wants to keep it.
+ *
+ * @return 0 to continue, a negative error code to abort the import
+ * @param ai account info the transaction belongs to (might be NULL if the input doesn't specify an account)
+ * @param t transaction
+ * @param user_data pointer given to @ref AB_Banking_ImportWithTransactionFn
+ */
+typedef int (*AB_IMEXPORTER_TRANSACTION_FN)(AB_IMEXPORTER_ACCOUNTINFO *ai, AB_TRANSACTION *t, void *user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -182,11 +211,27 @@ void AB_ImExporter_Utf8ToDta(const char *p, int size, GWEN_BUFFER *buf);
  */
 void AB_ImExporter_DtaToUtf8(const char *p, int size, GWEN_BUFFER *buf);
 
+/**
+ * Transforms an ISO-8859-1 string to an UTF-8 string. Control characters are replaced by a space (chr 32).
+ * Runs of plain ASCII characters are copied as a whole.
+ * @param p string to transform (stops at the first NUL byte)
+ * @param size number of bytes to transform (-1 for all)
+ * @param buf buffer to receive the result
+ */
 void AB_ImExporter_Iso8859_1ToUtf8(const char *p, int size, GWEN_BUFFER *buf);
 
+/**
+ * Checks whether the given string only consists of printable ASCII characters (32-126) in which case
+ * @ref AB_ImExporter_Iso8859_1ToUtf8 would return an unchanged copy.
+ * @return 1 if plain ASCII, 0 otherwise
+ * @param p string to check
+ * @param size number of bytes to check (-1 for strlen(p))
+ */
+int AB_ImExporter_Iso8859_1IsPlainAscii(const char *p, int size);
+
 /**
  * This function call @ref AB_ImExporter_Iso8859_1ToUtf8 on all char
- * values in the given db.
+ * values in the given db. Values consisting of plain ASCII only are left untouched.
  */
 int AB_ImExporter_DbFromIso8859_1ToUtf8(GWEN_DB_NODE *db);
 
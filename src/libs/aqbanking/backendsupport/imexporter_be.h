@@ -113,6 +113,57 @@ void AB_ImExporter_SetGetEditProfileDialogFn(AB_IMEXPORTER *ie, AB_IMEXPORTER_GE
 
 
 
+/** @name Helper Functions for SEPA Exporters
+ *
+ */
+/*@{*/
+
+/** first id of a block of "sepamsg" ids reserved by the caller of an exporter (see @ref AB_Banking_ReserveNamedUniqueIds) */
+#define AB_IMEXPORTER_PARAMS_SEPAMSGID_FIRST "reservedSepaMsgIdFirst"
+/** number of ids left in the reserved block */
+#define AB_IMEXPORTER_PARAMS_SEPAMSGID_COUNT "reservedSepaMsgIdCount"
+
+/**
+ * Return the id to be used for the next SEPA message id or payment info id.
+ * If the params contain a block of ids reserved beforehand the next id is taken from that block (and removed
+ * from it), otherwise a new id is created via @ref AB_Banking_GetNamedUniqueId which needs to lock and write
+ * the configuration.
+ */
+uint32_t AB_ImExporter_GetNextSepaMessageId(AB_IMEXPORTER *ie, GWEN_DB_NODE *params);
+
+/*@}*/
+
+
+
+/** @name Helper Functions for Streaming Importers
+ *
+ * Importers which set @ref AB_IMEXPORTER_FLAGS_STREAMING_IMPORT pass every completed transaction to
+ * @ref AB_ImExporter_DeliverTransaction instead of adding it to an account info themselves.
+ */
+/*@{*/
+
+/**
+ * Returns !=0 if the caller of the import wants transactions handed to a callback
+ * (see @ref AB_Banking_ImportWithTransactionFn).
+ */
+int AB_ImExporter_HasTransactionFn(const AB_IMEXPORTER *ie);
+
+/**
+ * Hand a completed transaction to the transaction callback and free it afterwards. If there is no callback
+ * the transaction is added to the given account info.
+ * Takes over the transaction in any case.
+ * @return 0 if ok, error code otherwise (e.g. if the callback wants to abort the import)
+ * @param ie im/exporter
+ * @param ai account info the transaction belongs to
+ * @param t transaction
+ */
+int AB_ImExporter_DeliverTransaction(AB_IMEXPORTER *ie, AB_IMEXPORTER_ACCOUNTINFO *ai, AB_TRANSACTION *t);
+
+/*@}*/
+
+
+
+
 /** @name Handling of ImExporter Plugins
  *
  */
@@ -27,6 +27,8 @@ GWEN_LIST_FUNCTION_DEFS(AB_IMEXPORTER, AB_ImExporter)
 
 void AB_ImExporter_SetLibLoader(AB_IMEXPORTER *ie, GWEN_LIBLOADER *ll);
 
+void AB_ImExporter_SetTransactionFn(AB_IMEXPORTER *ie, AB_IMEXPORTER_TRANSACTION_FN fn, void *user_data);
+
 
 #endif /* AQBANKING_IMEXPORTER_L_H */
 
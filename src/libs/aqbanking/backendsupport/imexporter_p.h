@@ -35,6 +35,10 @@ struct AB_IMEXPORTER {
   AB_IMEXPORTER_EXPORT_FN exportFn;
   AB_IMEXPORTER_CHECKFILE_FN checkFileFn;
   AB_IMEXPORTER_GET_EDITPROFILE_DIALOG_FN getEditProfileDialogFn;
+
+  /* only set while running AB_Banking_ImportWithTransactionFn() */
+  AB_IMEXPORTER_TRANSACTION_FN transactionFn;
+  void *transactionFnUserData;
 };
 
 
@@ -14,14 +14,19 @@
 
 #include "aqbanking/backendsupport/provider_p.h"
 #include "aqbanking/backendsupport/provider_be.h"
+#include "aqbanking/backendsupport/fetchcursor_l.h"
 #include "aqbanking/banking_l.h"
 
 #include <gwenhywfar/debug.h>
 #include <gwenhywfar/misc.h>
 #include <gwenhywfar/text.h>
+#include <gwenhywfar/stringlist.h>
 
 #include <assert.h>
 #include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 
 GWEN_INHERIT_FUNCTIONS(AB_PROVIDER)
@@ -405,11 +410,27 @@ GWEN_DIALOG *AB_Provider_GetUserTypeDialog(AB_PROVIDER *pro)
 
 int AB_Provider_SendCommands(AB_PROVIDER *pro, AB_PROVIDERQUEUE *pq, AB_IMEXPORTER_CONTEXT *ctx)
 {
+  GWEN_DB_NODE *dbCursors;
+  AB_TRANSACTION_LIST2 *cmdList;
+  int incrementalCount;
+  int rv;
+
   assert(pro);
-  if (pro->sendCommandsFn)
-    return pro->sendCommandsFn(pro, pq, ctx);
-  else
+  if (pro->sendCommandsFn==NULL)
     return GWEN_ERROR_NOT_SUPPORTED;
+
+  /* let incremental transaction requests start at the fetch cursor of their account (see provider_fetchcursor.c) */
+  dbCursors=GWEN_DB_Group_new("fetchCursors");
+  cmdList=AB_Transaction_List2_new();
+  incrementalCount=_prepareIncrementalRequests(pro, pq, dbCursors, cmdList);
+
+  rv=pro->sendCommandsFn(pro, pq, ctx);
+  if (rv>=0 && incrementalCount>0)
+    _finishIncrementalRequests(pro, ctx, dbCursors, cmdList);
+
+  AB_Transaction_List2_free(cmdList);
+  GWEN_DB_Group_free(dbCursors);
+  return rv;
 }
 
 
@@ -508,6 +529,7 @@ void AB_Plugin_Provider_SetFactoryFn(GWEN_PLUGIN *pl, AB_PLUGIN_PROVIDER_FACTORY
 #include "provider_accspec.c"
 #include "provider_user.c"
 #include "provider_queues.c"
+#include "provider_fetchcursor.c"
 
 
 
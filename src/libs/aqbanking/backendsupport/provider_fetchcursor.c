@@ -0,0 +1,213 @@
+/***************************************************************************
+ begin       : Mon Oct 19 2026
+ copyright   : (C) 2026 by Martin Preuss
+ email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+
+/*
+ * This file is included by provider.c
+ *
+ * Incremental transaction requests (AB_TRANSACTION_REQUESTFLAGS_INCREMENTAL):
+ * For every account a fetch cursor is kept in the config group "fetchcursors" containing
+ * - lastBookedDate: date of the latest booked transaction received so far (YYYYMMDD)
+ * - boundaryReference: bank references of the booked transactions received for that date
+ * - boundaryHash: hashes of the booked transactions received for that date which have no bank reference
+ *
+ * Incremental requests start at lastBookedDate (inclusive, because the bank might book more transactions on that
+ * day), booked transactions received before that date or already received on that date are dropped from the
+ * result. The cursor is advanced afterwards unless one of the incremental requests of the account failed.
+ *
+ * Filtering and advancing the cursor itself is done in fetchcursor.c, this file only handles the requests and
+ * reading/storing the cursors.
+ */
+
+
+
+int _prepareIncrementalRequests(AB_PROVIDER *pro, AB_PROVIDERQUEUE *pq, GWEN_DB_NODE *dbCursors,
+                                AB_TRANSACTION_LIST2 *cmdList)
+{
+  AB_ACCOUNTQUEUE_LIST *aql;
+  AB_ACCOUNTQUEUE *aq;
+  int count=0;
+
+  aql=AB_ProviderQueue_GetAccountQueueList(pq);
+  if (aql==NULL)
+    return 0;
+
+  aq=AB_AccountQueue_List_First(aql);
+  while (aq) {
+    AB_TRANSACTION_LIST2 *tl;
+
+    tl=AB_AccountQueue_GetTransactionList(aq);
+    if (tl) {
+      AB_TRANSACTION_LIST2_ITERATOR *it;
+
+      it=AB_Transaction_List2_First(tl);
+      if (it) {
+        AB_TRANSACTION *t;
+
+        t=AB_Transaction_List2Iterator_Data(it);
+        while (t) {
+          if (AB_Transaction_GetCommand(t)==AB_Transaction_CommandGetTransactions &&
+              (AB_Transaction_GetRequestFlags(t) & AB_TRANSACTION_REQUESTFLAGS_INCREMENTAL)) {
+            GWEN_DB_NODE *dbCursor;
+
+            dbCursor=_getFetchCursor(pro, dbCursors, AB_AccountQueue_GetAccountId(aq));
+            AB_FetchCursor_ApplyToRequest(dbCursor, t);
+            AB_Transaction_List2_PushBack(cmdList, t);
+            count++;
+          }
+          t=AB_Transaction_List2Iterator_Next(it);
+        }
+        AB_Transaction_List2Iterator_free(it);
+      }
+    }
+    aq=AB_AccountQueue_List_Next(aq);
+  }
+
+  return count;
+}
+
+
+
+void _finishIncrementalRequests(AB_PROVIDER *pro, AB_IMEXPORTER_CONTEXT *ctx, GWEN_DB_NODE *dbCursors,
+                                AB_TRANSACTION_LIST2 *cmdList)
+{
+  AB_TRANSACTION_LIST2_ITERATOR *it;
+  GWEN_DB_NODE *dbCursor;
+
+  /* don't advance the cursor of accounts for which an incremental request failed */
+  it=AB_Transaction_List2_First(cmdList);
+  if (it) {
+    AB_TRANSACTION *t;
+
+    t=AB_Transaction_List2Iterator_Data(it);
+    while (t) {
+      AB_TRANSACTION_STATUS tStatus;
+
+      tStatus=AB_Transaction_GetStatus(t);
+      if (tStatus==AB_Transaction_StatusRejected ||
+          tStatus==AB_Transaction_StatusAborted ||
+          tStatus==AB_Transaction_StatusError) {
+        dbCursor=_getFetchCursor(pro, dbCursors, AB_Transaction_GetUniqueAccountId(t));
+        GWEN_DB_SetIntValue(dbCursor, GWEN_DB_FLAGS_OVERWRITE_VARS, "failed", 1);
+      }
+      t=AB_Transaction_List2Iterator_Next(it);
+    }
+    AB_Transaction_List2Iterator_free(it);
+  }
+
+  dbCursor=GWEN_DB_GetFirstGroup(dbCursors);
+  while (dbCursor) {
+    uint32_t aid;
+
+    aid=(uint32_t) strtoul(GWEN_DB_GroupName(dbCursor), NULL, 10);
+    if (AB_FetchCursor_FilterAndAdvance(ctx, dbCursor, aid)) {
+      int rv;
+
+      rv=_storeFetchCursor(pro, dbCursor, aid);
+      if (rv<0) {
+        DBG_ERROR(AQBANKING_LOGDOMAIN, "Could not store fetch cursor of account %lu (%d)",
+                  (unsigned long int) aid, rv);
+      }
+    }
+    dbCursor=GWEN_DB_GetNextGroup(dbCursor);
+  }
+}
+
+
+
+GWEN_DB_NODE *_getFetchCursor(AB_PROVIDER *pro, GWEN_DB_NODE *dbCursors, uint32_t aid)
+{
+  char idBuf[16];
+  GWEN_DB_NODE *dbCursor;
+
+  snprintf(idBuf, sizeof(idBuf)-1, "%lu", (unsigned long int) aid);
+  idBuf[sizeof(idBuf)-1]=0;
+
+  dbCursor=GWEN_DB_GetGroup(dbCursors, GWEN_PATH_FLAGS_NAMEMUSTEXIST, idBuf);
+  if (dbCursor==NULL) {
+    GWEN_DB_NODE *dbStored=NULL;
+    int rv;
+
+    dbCursor=GWEN_DB_GetGroup(dbCursors, GWEN_DB_FLAGS_DEFAULT, idBuf);
+    assert(dbCursor);
+    if (AB_Banking_Has_FetchCursor(AB_Provider_GetBanking(pro), aid)>=0) {
+      rv=AB_Banking_Read_FetchCursor(AB_Provider_GetBanking(pro), aid, 1, 1, &dbStored);
+      if (rv<0) {
+        DBG_WARN(AQBANKING_LOGDOMAIN, "Could not read fetch cursor of account %lu (%d), requesting full range",
+                 (unsigned long int) aid, rv);
+      }
+      else {
+        GWEN_DB_AddGroupChildren(dbCursor, dbStored);
+        GWEN_DB_Group_free(dbStored);
+      }
+    }
+    else {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "No fetch cursor for account %lu yet", (unsigned long int) aid);
+    }
+  }
+
+  return dbCursor;
+}
+
+
+
+int _storeFetchCursor(AB_PROVIDER *pro, GWEN_DB_NODE *dbCursor, uint32_t aid)
+{
+  AB_BANKING *ab;
+  GWEN_DB_NODE *dbStored=NULL;
+  GWEN_DB_NODE *dbNew;
+  int rv;
+
+  ab=AB_Provider_GetBanking(pro);
+
+  dbNew=GWEN_DB_Group_new("fetchCursor");
+  GWEN_DB_AddGroupChildren(dbNew, dbCursor);
+  GWEN_DB_DeleteVar(dbNew, "failed");
+
+  if (AB_Banking_Has_FetchCursor(ab, aid)<0) {
+    rv=AB_Banking_Write_FetchCursor(ab, aid, 1, 1, dbNew);
+    GWEN_DB_Group_free(dbNew);
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      return rv;
+    }
+    return 0;
+  }
+
+  /* another process might have advanced the cursor meanwhile, never move it back */
+  rv=AB_Banking_Read_FetchCursor(ab, aid, 1, 0, &dbStored);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    GWEN_DB_Group_free(dbNew);
+    return rv;
+  }
+
+  if (!AB_FetchCursor_MergeStored(dbNew, dbStored)) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Fetch cursor of account %lu is already further advanced", (unsigned long int) aid);
+    GWEN_DB_Group_free(dbStored);
+    GWEN_DB_Group_free(dbNew);
+    AB_Banking_Unlock_FetchCursor(ab, aid);
+    return 0;
+  }
+  GWEN_DB_Group_free(dbStored);
+
+  rv=AB_Banking_Write_FetchCursor(ab, aid, 0, 1, dbNew);
+  GWEN_DB_Group_free(dbNew);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    AB_Banking_Unlock_FetchCursor(ab, aid);
+    return rv;
+  }
+
+  return 0;
+}
+
+
+
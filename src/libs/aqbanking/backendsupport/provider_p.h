@@ -69,4 +69,14 @@ static void GWENHYWFAR_CB AB_Plugin_Provider_FreeData(void *bp, void *p);
 
 
 
+/* provider_fetchcursor.c */
+static int _prepareIncrementalRequests(AB_PROVIDER *pro, AB_PROVIDERQUEUE *pq, GWEN_DB_NODE *dbCursors,
+                                       AB_TRANSACTION_LIST2 *cmdList);
+static void _finishIncrementalRequests(AB_PROVIDER *pro, AB_IMEXPORTER_CONTEXT *ctx, GWEN_DB_NODE *dbCursors,
+                                       AB_TRANSACTION_LIST2 *cmdList);
+static GWEN_DB_NODE *_getFetchCursor(AB_PROVIDER *pro, GWEN_DB_NODE *dbCursors, uint32_t aid);
+static int _storeFetchCursor(AB_PROVIDER *pro, GWEN_DB_NODE *dbCursor, uint32_t aid);
+
+
+
 #endif /* AQBANKING_PROVIDER_P_H */
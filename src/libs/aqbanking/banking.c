@@ -44,6 +44,7 @@
 #include <sys/stat.h>
 #include <errno.h>
 #include <ctype.h>
+#include <stdio.h>
 
 
 #ifdef OS_WIN32
@@ -60,6 +61,7 @@ GWEN_INHERIT_FUNCTIONS(AB_BANKING)
 
 #include "banking_init.c"
 #include "banking_cfg.c"
+#include "banking_snapshot.c"
 #include "banking_update.c"
 
 #include "banking_accspec.c"
@@ -69,6 +71,7 @@ GWEN_INHERIT_FUNCTIONS(AB_BANKING)
 
 #include "banking_online.c"
 #include "banking_imex.c"
+#include "banking_profilecache.c"
 #include "banking_bankinfo.c"
 #include "banking_dialogs.c"
 #include "banking_compat.c"
@@ -162,6 +165,22 @@ void AB_Banking_free(AB_BANKING *ab)
 
     GWEN_INHERIT_FINI(AB_BANKING, ab);
 
+    if (ab->keptProviders) {
+      AB_PROVIDER *pro;
+
+      DBG_WARN(AQBANKING_LOGDOMAIN, "Providers still initialized, AB_Banking_Fini() not called?");
+      while ((pro=AB_Provider_List_First(ab->keptProviders))) {
+        AB_Provider_List_Del(pro);
+        AB_Provider_free(pro);
+      }
+      AB_Provider_List_free(ab->keptProviders);
+    }
+    _clearAccountSpecCache(ab);
+    AB_Banking__ReleaseSettingsSnapshot(ab);
+    AB_HashIndex_free(ab->accountSpecByBankCodeAndAccountNumber);
+    AB_HashIndex_free(ab->accountSpecByIban);
+    if (ab->accountSpecByUniqueId)
+      GWEN_IdMap_free(ab->accountSpecByUniqueId);
     GWEN_DB_Group_free(ab->dbRuntimeConfig);
     AB_Banking_ClearCryptTokenList(ab);
     GWEN_Crypt_Token_List2_free(ab->cryptTokenList);
@@ -178,11 +197,20 @@ void AB_Banking_free(AB_BANKING *ab)
 
 
 int AB_Banking_GetNamedUniqueId(AB_BANKING *ab, const char *idName, int startAtStdUniqueId)
+{
+  return AB_Banking_ReserveNamedUniqueIds(ab, idName, startAtStdUniqueId, 1);
+}
+
+
+
+int AB_Banking_ReserveNamedUniqueIds(AB_BANKING *ab, const char *idName, int startAtStdUniqueId, int count)
 {
   int rv;
   int uid=0;
   GWEN_DB_NODE *dbConfig=NULL;
 
+  assert(count>0);
+
   rv=GWEN_ConfigMgr_LockGroup(ab->configMgr,
                               AB_CFG_GROUP_MAIN,
                               "uniqueId");
@@ -212,19 +240,19 @@ int AB_Banking_GetNamedUniqueId(AB_BANKING *ab, const char *idName, int startAtS
       /* not set yet, start with a unique id from standard source */
       uid=GWEN_DB_GetIntValue(dbConfig, "uniqueId", 0, 0);
       uid++;
-      GWEN_DB_SetIntValue(dbConfig, GWEN_DB_FLAGS_OVERWRITE_VARS, "uniqueId", uid);
-      GWEN_DB_SetIntValue(dbConfig, GWEN_DB_FLAGS_OVERWRITE_VARS, GWEN_Buffer_GetStart(tbuf), uid);
+      GWEN_DB_SetIntValue(dbConfig, GWEN_DB_FLAGS_OVERWRITE_VARS, "uniqueId", uid+count-1);
+      GWEN_DB_SetIntValue(dbConfig, GWEN_DB_FLAGS_OVERWRITE_VARS, GWEN_Buffer_GetStart(tbuf), uid+count-1);
     }
     else {
       uid++;
-      GWEN_DB_SetIntValue(dbConfig, GWEN_DB_FLAGS_OVERWRITE_VARS, GWEN_Buffer_GetStart(tbuf), uid);
+      GWEN_DB_SetIntValue(dbConfig, GWEN_DB_FLAGS_OVERWRITE_VARS, GWEN_Buffer_GetStart(tbuf), uid+count-1);
     }
     GWEN_Buffer_free(tbuf);
   }
   else {
     uid=GWEN_DB_GetIntValue(dbConfig, "uniqueId", 0, 0);
     uid++;
-    GWEN_DB_SetIntValue(dbConfig, GWEN_DB_FLAGS_OVERWRITE_VARS, "uniqueId", uid);
+    GWEN_DB_SetIntValue(dbConfig, GWEN_DB_FLAGS_OVERWRITE_VARS, "uniqueId", uid+count-1);
   }
 
   rv=GWEN_ConfigMgr_SetGroup(ab->configMgr,
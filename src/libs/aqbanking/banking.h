@@ -332,6 +332,15 @@ int AB_Banking_UnlockSharedConfig(AB_BANKING *ab, const char *name);
  *       (see https://www.hbci-zka.de/register/prod_register.htm)</li>
  *   <li>fintsApplicationVersionString (char): string containing the version of the application
  *       (major and minor version only, e.g. "1.2")</li>
+ *   <li>keepProviders (int): if !=0 backends are not deinitialized by @ref AB_Banking_EndUseProvider() but kept
+ *       for the next use until the last call to @ref AB_Banking_Fini(). This saves reloading backend data
+ *       (like protocol definitions) in long running applications.</li>
+ *   <li>noProfileCache (int): if !=0 im-/exporter profiles are always looked up by reading all profile files
+ *       instead of using the profile registry cached in the user data folder (see
+ *       @ref AB_Banking_GetImExporterProfile).</li>
+ *   <li>noSettingsSnapshot (int): if !=0 users, accounts and account specs are always read from the single
+ *       config groups instead of using the settings snapshot file in the user data folder (which is rebuilt
+ *       automatically after the settings have been changed).</li>
  * </ul>
  */
 /*@{*/
@@ -67,6 +67,15 @@ int AB_Banking_Delete_AccountConfig(AB_BANKING *ab, uint32_t uid)
     return rv;
   }
 
+  /* the fetch cursor of the account is no longer of use */
+  if (AB_Banking_Has_FetchCursor(ab, uid)>=0) {
+    rv=AB_Banking_Delete_FetchCursor(ab, uid);
+    if (rv<0) {
+      DBG_WARN(AQBANKING_LOGDOMAIN, "Could not delete fetch cursor of account %lu (%d), ignoring",
+               (unsigned long int) uid, rv);
+    }
+  }
+
   return 0;
 }
 
@@ -87,4 +96,78 @@ int AB_Banking_Unlock_AccountConfig(AB_BANKING *ab, uint32_t uid)
 
 
 
+int AB_Banking_Read_FetchCursor(const AB_BANKING *ab, uint32_t uid, int doLock, int doUnlock, GWEN_DB_NODE **pDb)
+{
+  int rv;
+
+  rv=AB_Banking_ReadConfigGroup(ab, AB_CFG_GROUP_FETCHCURSORS, uid, doLock, doUnlock, pDb);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  return rv;
+}
+
+
+
+int AB_Banking_Has_FetchCursor(const AB_BANKING *ab, uint32_t uid)
+{
+  int rv;
+
+  rv=AB_Banking_HasConfigGroup(ab, AB_CFG_GROUP_FETCHCURSORS, uid);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  return rv;
+}
+
+
+
+int AB_Banking_Write_FetchCursor(AB_BANKING *ab, uint32_t uid, int doLock, int doUnlock, GWEN_DB_NODE *db)
+{
+  int rv;
+
+  rv=AB_Banking_WriteConfigGroup(ab, AB_CFG_GROUP_FETCHCURSORS, uid, doLock, doUnlock, db);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  return 0;
+}
+
+
+
+int AB_Banking_Delete_FetchCursor(AB_BANKING *ab, uint32_t uid)
+{
+  int rv;
+
+  rv=AB_Banking_DeleteConfigGroup(ab, AB_CFG_GROUP_FETCHCURSORS, uid);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  return 0;
+}
+
+
+
+int AB_Banking_Unlock_FetchCursor(AB_BANKING *ab, uint32_t uid)
+{
+  int rv;
+
+  rv=AB_Banking_UnlockConfigGroup(ab, AB_CFG_GROUP_FETCHCURSORS, uid);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  return 0;
+}
+
+
 
@@ -19,6 +19,14 @@
 
 static const char *_nonEmptyString(const char *s, const char *altstring);
 static void _logAccountSpec(const AB_ACCOUNT_SPEC *a, const char *logMessage);
+static int _readAccountSpecList(const AB_BANKING *ab, AB_ACCOUNT_SPEC_LIST **pAccountSpecList);
+static int _loadAccountSpecCacheIfNeeded(AB_BANKING *ab);
+static void _addAccountSpecToCacheIndexes(AB_BANKING *ab, AB_ACCOUNT_SPEC *as);
+static void _clearAccountSpecCache(AB_BANKING *ab);
+static int _copyCachedAccountSpec(const AB_ACCOUNT_SPEC *as, AB_ACCOUNT_SPEC **pAccountSpec);
+static int _copyCachedAccountSpecsForKey(const AB_HASHINDEX *hi, const char *key, AB_ACCOUNT_SPEC_LIST **pAccountSpecList);
+static int _readAccountSpecFromSnapshot(const AB_BANKING *ab, AB_SETTINGS_SNAPSHOT_INDEX idx, const char *key,
+                                        uint32_t uniqueId, AB_ACCOUNT_SPEC **pAccountSpec);
 
 
 /* ------------------------------------------------------------------------------------------------
@@ -82,6 +90,7 @@ int AB_Banking_WriteAccountSpec(AB_BANKING *ab, const AB_ACCOUNT_SPEC *accountSp
   db=GWEN_DB_Group_new("accountSpec");
   AB_AccountSpec_toDb(accountSpec, db);
 
+  _clearAccountSpecCache(ab);
   rv=AB_Banking_WriteConfigGroup(ab, AB_CFG_GROUP_ACCOUNTSPECS, uniqueId, 1, 1, db);
   if (rv<0) {
     DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
@@ -99,6 +108,7 @@ int AB_Banking_DeleteAccountSpec(AB_BANKING *ab, uint32_t uid)
 {
   int rv;
 
+  _clearAccountSpecCache(ab);
   rv=AB_Banking_DeleteConfigGroup(ab, AB_CFG_GROUP_ACCOUNTSPECS, uid);
   if (rv<0) {
     DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
@@ -114,6 +124,364 @@ int AB_Banking_DeleteAccountSpec(AB_BANKING *ab, uint32_t uid)
 
 
 int AB_Banking_GetAccountSpecList(const AB_BANKING *ab, AB_ACCOUNT_SPEC_LIST **pAccountSpecList)
+{
+  AB_ACCOUNT_SPEC_LIST *accountSpecList;
+  const AB_ACCOUNT_SPEC *as;
+  int rv;
+
+  rv=_loadAccountSpecCacheIfNeeded((AB_BANKING *) ab);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  if (AB_AccountSpec_List_GetCount(ab->accountSpecCache)<1) {
+    DBG_WARN(AQBANKING_LOGDOMAIN, "No valid account specs found");
+    return GWEN_ERROR_NOT_FOUND;
+  }
+
+  accountSpecList=AB_AccountSpec_List_new();
+  as=AB_AccountSpec_List_First(ab->accountSpecCache);
+  while (as) {
+    AB_AccountSpec_List_Add(AB_AccountSpec_dup(as), accountSpecList);
+    as=AB_AccountSpec_List_Next(as);
+  }
+
+  *pAccountSpecList=accountSpecList;
+  return 0;
+}
+
+
+
+void AB_Banking_ClearAccountSpecCache(AB_BANKING *ab)
+{
+  assert(ab);
+  _clearAccountSpecCache(ab);
+}
+
+
+
+int AB_Banking_GetAccountSpecByUniqueId(const AB_BANKING *ab, uint32_t uniqueAccountId, AB_ACCOUNT_SPEC **pAccountSpec)
+{
+  int rv;
+
+  rv=_readAccountSpecFromSnapshot(ab, AB_SettingsSnapshotIndex_Count, NULL, uniqueAccountId, pAccountSpec);
+  if (rv!=GWEN_ERROR_NOT_AVAILABLE)
+    return rv;
+
+  rv=_loadAccountSpecCacheIfNeeded((AB_BANKING *) ab);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  return _copyCachedAccountSpec((const AB_ACCOUNT_SPEC *) GWEN_IdMap_Find(ab->accountSpecByUniqueId, uniqueAccountId),
+                                pAccountSpec);
+}
+
+
+
+int AB_Banking_GetAccountSpecByIban(const AB_BANKING *ab, const char *iban, AB_ACCOUNT_SPEC **pAccountSpec)
+{
+  int rv;
+
+  if (!(iban && *iban)) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "No IBAN given");
+    return GWEN_ERROR_INVALID;
+  }
+
+  rv=_readAccountSpecFromSnapshot(ab, AB_SettingsSnapshotIndex_Iban, iban, 0, pAccountSpec);
+  if (rv!=GWEN_ERROR_NOT_AVAILABLE)
+    return rv;
+
+  rv=_loadAccountSpecCacheIfNeeded((AB_BANKING *) ab);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  return _copyCachedAccountSpec((const AB_ACCOUNT_SPEC *) AB_HashIndex_Find(ab->accountSpecByIban, iban), pAccountSpec);
+}
+
+
+
+int AB_Banking_GetAccountSpecByBankCodeAndAccountNumber(const AB_BANKING *ab,
+                                                        const char *bankCode,
+                                                        const char *accountNumber,
+                                                        AB_ACCOUNT_SPEC **pAccountSpec)
+{
+  char keyBuf[128];
+  int rv;
+  int keyRv;
+
+  if (!(accountNumber && *accountNumber)) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "No account number given");
+    return GWEN_ERROR_INVALID;
+  }
+
+  keyRv=AB_HashIndex_MakeKey(keyBuf, sizeof(keyBuf), bankCode, accountNumber, NULL);
+  if (keyRv==0) {
+    rv=_readAccountSpecFromSnapshot(ab, AB_SettingsSnapshotIndex_BankCodeAndAccountNumber, keyBuf, 0, pAccountSpec);
+    if (rv!=GWEN_ERROR_NOT_AVAILABLE)
+      return rv;
+  }
+
+  rv=_loadAccountSpecCacheIfNeeded((AB_BANKING *) ab);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  if (keyRv<0) {
+    const AB_ACCOUNT_SPEC *as;
+
+    /* unusually long key, fall back to linear search */
+    as=AB_AccountSpec_List_First(ab->accountSpecCache);
+    while (as) {
+      if (strcasecmp(_nonEmptyString(AB_AccountSpec_GetBankCode(as), ""), bankCode?bankCode:"")==0 &&
+          strcasecmp(_nonEmptyString(AB_AccountSpec_GetAccountNumber(as), ""), accountNumber)==0)
+        break;
+      as=AB_AccountSpec_List_Next(as);
+    }
+    return _copyCachedAccountSpec(as, pAccountSpec);
+  }
+
+  return _copyCachedAccountSpec((const AB_ACCOUNT_SPEC *) AB_HashIndex_Find(ab->accountSpecByBankCodeAndAccountNumber,
+                                                                            keyBuf),
+                                pAccountSpec);
+}
+
+
+
+int AB_Banking_GetAccountSpecListByIban(const AB_BANKING *ab, const char *iban, AB_ACCOUNT_SPEC_LIST **pAccountSpecList)
+{
+  int rv;
+
+  if (!(iban && *iban)) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "No IBAN given");
+    return GWEN_ERROR_INVALID;
+  }
+
+  rv=_loadAccountSpecCacheIfNeeded((AB_BANKING *) ab);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  return _copyCachedAccountSpecsForKey(ab->accountSpecByIban, iban, pAccountSpecList);
+}
+
+
+
+int AB_Banking_GetAccountSpecListByBankCodeAndAccountNumber(const AB_BANKING *ab,
+                                                            const char *bankCode,
+                                                            const char *accountNumber,
+                                                            AB_ACCOUNT_SPEC_LIST **pAccountSpecList)
+{
+  char keyBuf[128];
+  int rv;
+
+  if (!(accountNumber && *accountNumber)) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "No account number given");
+    return GWEN_ERROR_INVALID;
+  }
+
+  rv=_loadAccountSpecCacheIfNeeded((AB_BANKING *) ab);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  rv=AB_HashIndex_MakeKey(keyBuf, sizeof(keyBuf), bankCode, accountNumber, NULL);
+  if (rv<0) {
+    AB_ACCOUNT_SPEC_LIST *accountSpecList;
+    const AB_ACCOUNT_SPEC *as;
+
+    /* unusually long key, fall back to linear search */
+    accountSpecList=AB_AccountSpec_List_new();
+    as=AB_AccountSpec_List_First(ab->accountSpecCache);
+    while (as) {
+      if (strcasecmp(_nonEmptyString(AB_AccountSpec_GetBankCode(as), ""), bankCode?bankCode:"")==0 &&
+          strcasecmp(_nonEmptyString(AB_AccountSpec_GetAccountNumber(as), ""), accountNumber)==0)
+        AB_AccountSpec_List_Add(AB_AccountSpec_dup(as), accountSpecList);
+      as=AB_AccountSpec_List_Next(as);
+    }
+    if (AB_AccountSpec_List_GetCount(accountSpecList)<1) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "Account spec not found");
+      AB_AccountSpec_List_free(accountSpecList);
+      return GWEN_ERROR_NOT_FOUND;
+    }
+    *pAccountSpecList=accountSpecList;
+    return 0;
+  }
+
+  return _copyCachedAccountSpecsForKey(ab->accountSpecByBankCodeAndAccountNumber, keyBuf, pAccountSpecList);
+}
+
+
+
+int _copyCachedAccountSpec(const AB_ACCOUNT_SPEC *as, AB_ACCOUNT_SPEC **pAccountSpec)
+{
+  if (as==NULL) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Account spec not found");
+    return GWEN_ERROR_NOT_FOUND;
+  }
+
+  if (pAccountSpec)
+    *pAccountSpec=AB_AccountSpec_dup(as);
+  return 0;
+}
+
+
+
+int _copyCachedAccountSpecsForKey(const AB_HASHINDEX *hi, const char *key, AB_ACCOUNT_SPEC_LIST **pAccountSpecList)
+{
+  AB_ACCOUNT_SPEC_LIST *accountSpecList;
+  const AB_ACCOUNT_SPEC *as;
+
+  as=(const AB_ACCOUNT_SPEC *) AB_HashIndex_Find(hi, key);
+  if (as==NULL) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Account spec not found");
+    return GWEN_ERROR_NOT_FOUND;
+  }
+
+  /* entries sharing a key are returned in the order of the cached list */
+  accountSpecList=AB_AccountSpec_List_new();
+  while (as) {
+    AB_AccountSpec_List_Add(AB_AccountSpec_dup(as), accountSpecList);
+    as=(const AB_ACCOUNT_SPEC *) AB_HashIndex_FindNext(hi, key, as);
+  }
+
+  *pAccountSpecList=accountSpecList;
+  return 0;
+}
+
+
+
+int _readAccountSpecFromSnapshot(const AB_BANKING *ab, AB_SETTINGS_SNAPSHOT_INDEX idx, const char *key,
+                                 uint32_t uniqueId, AB_ACCOUNT_SPEC **pAccountSpec)
+{
+  const AB_SETTINGS_SNAPSHOT *ss;
+  GWEN_DB_NODE *db=NULL;
+  AB_ACCOUNT_SPEC *as;
+  int rv;
+
+  /* a loaded cache is at least as fast and reflects changes made by this session */
+  if (ab->accountSpecCache)
+    return GWEN_ERROR_NOT_AVAILABLE;
+
+  ss=AB_Banking__GetSettingsSnapshot((AB_BANKING *) ab);
+  if (ss==NULL)
+    return GWEN_ERROR_NOT_AVAILABLE;
+
+  /* idx==AB_SettingsSnapshotIndex_Count: lookup by unique id */
+  if (idx<AB_SettingsSnapshotIndex_Count) {
+    rv=AB_SettingsSnapshot_FindAccountSpec(ss, idx, key, &uniqueId);
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "Account spec not found");
+      return rv;
+    }
+  }
+
+  rv=AB_SettingsSnapshot_ReadGroup(ss, AB_SettingsSnapshotTable_AccountSpecs, uniqueId, &db);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Account spec not found");
+    return rv;
+  }
+
+  /* same conversion as in _readAccountSpecList() */
+  as=AB_AccountSpec_fromDb(db);
+  GWEN_DB_Group_free(db);
+  if (as==NULL) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Invalid account spec %lu", (unsigned long) uniqueId);
+    return GWEN_ERROR_BAD_DATA;
+  }
+  if (AB_AccountSpec_GetType(as)==AB_AccountType_Unknown)
+    AB_AccountSpec_SetType(as, AB_AccountType_Unspecified);
+
+  if (pAccountSpec)
+    *pAccountSpec=as;
+  else
+    AB_AccountSpec_free(as);
+  return 0;
+}
+
+
+
+int _loadAccountSpecCacheIfNeeded(AB_BANKING *ab)
+{
+  if (ab->accountSpecCache==NULL) {
+    AB_ACCOUNT_SPEC_LIST *accountSpecList=NULL;
+    AB_ACCOUNT_SPEC *as;
+    int rv;
+
+    rv=_readAccountSpecList(ab, &accountSpecList);
+    if (rv<0 && rv!=GWEN_ERROR_NOT_FOUND) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      return rv;
+    }
+
+    if (ab->accountSpecByUniqueId==NULL) {
+      ab->accountSpecByUniqueId=GWEN_IdMap_new(GWEN_IdMapAlgo_Hex4);
+      ab->accountSpecByIban=AB_HashIndex_new(AB_HASHINDEX_FLAGS_IGNORECASE);
+      ab->accountSpecByBankCodeAndAccountNumber=AB_HashIndex_new(AB_HASHINDEX_FLAGS_IGNORECASE);
+    }
+
+    ab->accountSpecCache=accountSpecList?accountSpecList:AB_AccountSpec_List_new();
+    as=AB_AccountSpec_List_First(ab->accountSpecCache);
+    while (as) {
+      _addAccountSpecToCacheIndexes(ab, as);
+      as=AB_AccountSpec_List_Next(as);
+    }
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Cached %d account specs", AB_AccountSpec_List_GetCount(ab->accountSpecCache));
+  }
+
+  return 0;
+}
+
+
+
+void _addAccountSpecToCacheIndexes(AB_BANKING *ab, AB_ACCOUNT_SPEC *as)
+{
+  uint32_t uid;
+  const char *s;
+
+  /* only the first entry for a given unique id is indexed to behave like a linear search through the list */
+  uid=AB_AccountSpec_GetUniqueId(as);
+  if (uid && GWEN_IdMap_Find(ab->accountSpecByUniqueId, uid)==NULL)
+    GWEN_IdMap_Insert(ab->accountSpecByUniqueId, uid, (void *) as);
+
+  /* all entries are indexed by IBAN and account number, AB_HashIndex_Find() returns the first one in list order */
+  s=AB_AccountSpec_GetIban(as);
+  if (s && *s)
+    AB_HashIndex_Add(ab->accountSpecByIban, s, (void *) as);
+
+  s=AB_AccountSpec_GetAccountNumber(as);
+  if (s && *s) {
+    char keyBuf[128];
+
+    if (AB_HashIndex_MakeKey(keyBuf, sizeof(keyBuf), AB_AccountSpec_GetBankCode(as), s, NULL)==0)
+      AB_HashIndex_Add(ab->accountSpecByBankCodeAndAccountNumber, keyBuf, (void *) as);
+  }
+}
+
+
+
+void _clearAccountSpecCache(AB_BANKING *ab)
+{
+  if (ab->accountSpecCache) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Dropping cached account specs");
+    GWEN_IdMap_Clear(ab->accountSpecByUniqueId);
+    AB_HashIndex_Clear(ab->accountSpecByIban);
+    AB_HashIndex_Clear(ab->accountSpecByBankCodeAndAccountNumber);
+    AB_AccountSpec_List_free(ab->accountSpecCache);
+    ab->accountSpecCache=NULL;
+  }
+}
+
+
+
+int _readAccountSpecList(const AB_BANKING *ab, AB_ACCOUNT_SPEC_LIST **pAccountSpecList)
 {
   GWEN_DB_NODE *dbAll=NULL;
   int rv;
@@ -168,21 +536,6 @@ int AB_Banking_GetAccountSpecList(const AB_BANKING *ab, AB_ACCOUNT_SPEC_LIST **p
 
 
 
-int AB_Banking_GetAccountSpecByUniqueId(const AB_BANKING *ab, uint32_t uniqueAccountId, AB_ACCOUNT_SPEC **pAccountSpec)
-{
-  int rv;
-
-  rv=AB_Banking_ReadAccountSpec(ab, uniqueAccountId, pAccountSpec);
-  if (rv<0) {
-    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
-    return rv;
-  }
-
-  return rv;
-}
-
-
-
 void _logAccountSpec(const AB_ACCOUNT_SPEC *a, const char *logMessage)
 {
   const char *sBankCode;
@@ -210,65 +210,327 @@ int AB_Banking__TransformIban(const char *iban, int len, char *newIban, int maxL
 
 int AB_Banking_CheckIban(const char *iban)
 {
-  char newIban[256];
-  char tmp[10];
-  int i;
-  unsigned int j;
-  const char *p;
-  char *s;
+  int rv;
 
   if (strlen(iban)<5) {
     DBG_INFO(AQBANKING_LOGDOMAIN, "Bad IBAN (too short) [%s]", iban);
     return -1;
   }
-  p=iban;
-  if (!(*p >= 'A' && *p++ <= 'Z' && *p >= 'A' && *p++ <= 'Z')) {
+  if (!(iban[0]>='A' && iban[0]<='Z' && iban[1]>='A' && iban[1]<='Z')) {
     DBG_INFO(AQBANKING_LOGDOMAIN, "Bad IBAN (country code not in upper case) [%s]", iban);
     return -1;
   }
-  p+=2;
 
-  /* convert IBAN+4 to buffer */
-  if (AB_Banking__TransformIban(p, strlen(p),
-                                newIban, sizeof(newIban)-1)) {
-    DBG_INFO(AQBANKING_LOGDOMAIN, "here");
+  rv=AB_Banking__IbanMod97(iban);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Bad IBAN (bad char) [%s]", iban);
     return -1;
   }
 
-  /* append country and checksum */
-  p=iban;
-  s=newIban+strlen(newIban);
-  if (AB_Banking__TransformIban(p, 4, s, sizeof(newIban)-strlen(newIban)-1)) {
-    DBG_INFO(AQBANKING_LOGDOMAIN, "here");
+  if (rv!=1) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Bad IBAN (bad checksum) [%s]", iban);
+    return 1;
+  }
+
+  DBG_DEBUG(AQBANKING_LOGDOMAIN, "IBAN is valid [%s]", iban);
+  return 0;
+}
+
+
+
+/* Calculate the IBAN checksum (country code and check digits moved to the end, letters replaced by 10-35)
+ * digit by digit without creating the numeric string first.
+ * Returns the remainder (1 for valid IBANs) or -1 on bad characters.
+ */
+int AB_Banking__IbanMod97(const char *iban)
+{
+  unsigned int remainder=0;
+  int digits=0;
+  int i;
+
+  for (i=0; i<2; i++) {
+    const char *p;
+    const char *pEnd;
+
+    /* first the BBAN, then country code and check digits */
+    p=(i==0)?iban+4:iban;
+    pEnd=(i==0)?NULL:iban+4;
+    while (*p && (pEnd==NULL || p<pEnd)) {
+      int c;
+
+      c=toupper(*p);
+      if (c>='A' && c<='Z') {
+        remainder=(remainder*100+(c-'A'+10))%97;
+        digits+=2;
+      }
+      else if (c>='0' && c<='9') {
+        remainder=(remainder*10+(c-'0'))%97;
+        digits++;
+      }
+      else if (c!=' ')
+        return -1;
+      p++;
+    }
+  }
+
+  if (digits>255) {
+    /* same limit as with the numeric string previously used */
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Bad IBAN (too long)");
     return -1;
   }
 
-  /* calculate checksum in 9er steps */
-  p=newIban;
-  tmp[0]=0;
-  j=0;
-  while (*p) {
-    for (i=strlen(tmp); i<9;  i++) {
-      if (!*p)
-        break;
-      tmp[i]=*(p++);
+  return (int) remainder;
+}
+
+
+
+/* IBAN length and BBAN structure per country as in the SWIFT IBAN registry
+ * (n: digits, a: upper case letters, c: letters and digits), sorted by country code
+ */
+static const struct {
+  const char *country;
+  int length;
+  const char *bbanStructure;
+} ab_ibanCountryRules[]= {
+  {"AD", 24, "4n4n12c"},
+  {"AE", 23, "3n16n"},
+  {"AL", 28, "8n16c"},
+  {"AT", 20, "5n11n"},
+  {"AZ", 28, "4a20c"},
+  {"BA", 20, "3n3n8n2n"},
+  {"BE", 16, "3n7n2n"},
+  {"BG", 22, "4a4n2n8c"},
+  {"BH", 22, "4a14c"},
+  {"BR", 29, "8n5n10n1a1c"},
+  {"BY", 28, "4c4n16c"},
+  {"CH", 21, "5n12c"},
+  {"CR", 22, "4n14n"},
+  {"CY", 28, "3n5n16c"},
+  {"CZ", 24, "4n6n10n"},
+  {"DE", 22, "8n10n"},
+  {"DK", 18, "4n9n1n"},
+  {"DO", 28, "4c20n"},
+  {"EE", 20, "2n2n11n1n"},
+  {"EG", 29, "4n4n17n"},
+  {"ES", 24, "4n4n1n1n10n"},
+  {"FI", 18, "3n11n"},
+  {"FO", 18, "4n9n1n"},
+  {"FR", 27, "5n5n11c2n"},
+  {"GB", 22, "4a6n8n"},
+  {"GE", 22, "2a16n"},
+  {"GI", 23, "4a15c"},
+  {"GL", 18, "4n9n1n"},
+  {"GR", 27, "3n4n16c"},
+  {"GT", 28, "4c20c"},
+  {"HR", 21, "7n10n"},
+  {"HU", 28, "3n4n1n15n1n"},
+  {"IE", 22, "4a6n8n"},
+  {"IL", 23, "3n3n13n"},
+  {"IQ", 23, "4a3n12n"},
+  {"IS", 26, "4n2n6n10n"},
+  {"IT", 27, "1a5n5n12c"},
+  {"JO", 30, "4a4n18c"},
+  {"KW", 30, "4a22c"},
+  {"KZ", 20, "3n13c"},
+  {"LB", 28, "4n20c"},
+  {"LC", 32, "4a24c"},
+  {"LI", 21, "5n12c"},
+  {"LT", 20, "5n11n"},
+  {"LU", 20, "3n13c"},
+  {"LV", 21, "4a13c"},
+  {"MC", 27, "5n5n11c2n"},
+  {"MD", 24, "2c18c"},
+  {"ME", 22, "3n13n2n"},
+  {"MK", 19, "3n10c2n"},
+  {"MR", 27, "5n5n11n2n"},
+  {"MT", 31, "4a5n18c"},
+  {"MU", 30, "4a2n2n12n3n3a"},
+  {"NL", 18, "4a10n"},
+  {"NO", 15, "4n6n1n"},
+  {"PK", 24, "4a16c"},
+  {"PL", 28, "8n16n"},
+  {"PS", 29, "4a21c"},
+  {"PT", 25, "4n4n11n2n"},
+  {"QA", 29, "4a21c"},
+  {"RO", 24, "4a16c"},
+  {"RS", 22, "3n13n2n"},
+  {"SA", 24, "2n18c"},
+  {"SC", 31, "4a2n2n16n3a"},
+  {"SE", 24, "3n16n1n"},
+  {"SI", 19, "5n8n2n"},
+  {"SK", 24, "4n6n10n"},
+  {"SM", 27, "1a5n5n12c"},
+  {"ST", 25, "4n4n11n2n"},
+  {"SV", 28, "4a20n"},
+  {"TL", 23, "3n14n2n"},
+  {"TN", 24, "2n3n13n2n"},
+  {"TR", 26, "5n1n16c"},
+  {"UA", 29, "6n19c"},
+  {"VA", 22, "3n15n"},
+  {"VG", 24, "4a16n"},
+  {"XK", 20, "4n10n2n"},
+  {NULL, 0, NULL}
+};
+
+
+
+/* check characters, length and BBAN structure of the IBAN (country code has already been checked) */
+int AB_Banking__CheckIbanStructure(const char *iban)
+{
+  char compactIban[35];
+  int len=0;
+  int i;
+  const char *p;
+
+  /* remove blanks */
+  for (p=iban; *p; p++) {
+    int c;
+
+    if (*p==' ')
+      continue;
+    c=toupper(*p);
+    if (!((c>='A' && c<='Z') || (c>='0' && c<='9')))
+      return AB_IbanCheckResult_BadFormat;
+    if (len>=(int)(sizeof(compactIban)-1))
+      return AB_IbanCheckResult_BadFormat; /* longer than 34 chars */
+    compactIban[len++]=c;
+  }
+  compactIban[len]=0;
+  if (len<5 || !(compactIban[2]>='0' && compactIban[2]<='9' && compactIban[3]>='0' && compactIban[3]<='9'))
+    return AB_IbanCheckResult_BadFormat;
+
+  for (i=0; ab_ibanCountryRules[i].country; i++) {
+    if (ab_ibanCountryRules[i].country[0]==compactIban[0] && ab_ibanCountryRules[i].country[1]==compactIban[1]) {
+      const char *s;
+      const char *pBban;
+
+      if (len!=ab_ibanCountryRules[i].length)
+        return AB_IbanCheckResult_BadLength;
+
+      pBban=compactIban+4;
+      s=ab_ibanCountryRules[i].bbanStructure;
+      while (*s) {
+        int count=0;
+        char charType;
+
+        while (*s>='0' && *s<='9')
+          count=count*10+(*(s++)-'0');
+        charType=*(s++);
+        while (count--) {
+          int c;
+
+          c=*(pBban++);
+          if ((charType=='n' && !(c>='0' && c<='9')) ||
+              (charType=='a' && !(c>='A' && c<='Z')))
+            return AB_IbanCheckResult_BadStructure;
+          /* 'c': any letter or digit, already checked above */
+        }
+      }
+      return AB_IbanCheckResult_Ok;
     }
-    tmp[i]=0;
-    if (1!=sscanf(tmp, "%u", &j)) {
-      DBG_INFO(AQBANKING_LOGDOMAIN, "Bad IBAN (bad char) [%s]", iban);
-      return -1;
+  }
+
+  /* unknown country: only checksum can be checked */
+  return AB_IbanCheckResult_Ok;
+}
+
+
+
+AB_IBANCHECK_RESULT AB_Banking_CheckIbanAndBic(const char *iban, const char *bic)
+{
+  int rv;
+
+  if (!(iban && *iban))
+    return AB_IbanCheckResult_Missing;
+
+  if (!(iban[0]>='A' && iban[0]<='Z' && iban[1]>='A' && iban[1]<='Z'))
+    return AB_IbanCheckResult_BadFormat;
+
+  rv=AB_Banking__CheckIbanStructure(iban);
+  if (rv!=AB_IbanCheckResult_Ok)
+    return (AB_IBANCHECK_RESULT) rv;
+
+  rv=AB_Banking__IbanMod97(iban);
+  if (rv<0)
+    return AB_IbanCheckResult_BadFormat;
+  if (rv!=1)
+    return AB_IbanCheckResult_BadChecksum;
+
+  if (bic && *bic && AB_Banking_CheckBic(bic)!=0)
+    return AB_IbanCheckResult_BadBic;
+
+  return AB_IbanCheckResult_Ok;
+}
+
+
+
+int AB_Banking_CheckBic(const char *bic)
+{
+  int i;
+
+  /* 4 chars bank code, 2 chars country code, 2 chars location code, optionally 3 chars branch code */
+  for (i=0; bic[i]; i++) {
+    int c;
+
+    c=toupper(bic[i]);
+    if (i<6) {
+      if (!(c>='A' && c<='Z'))
+        return 1;
     }
-    j=j%97; /* modulo 97 */
-    snprintf(tmp, sizeof(tmp), "%u", j);
-  } /* while */
+    else if (!((c>='A' && c<='Z') || (c>='0' && c<='9')))
+      return 1;
+  }
 
-  if (j!=1) {
-    DBG_INFO(AQBANKING_LOGDOMAIN, "Bad IBAN (bad checksum) [%s]", iban);
-    return 1;
+  return (i==8 || i==11)?0:1;
+}
+
+
+
+int AB_Banking_CheckIbans(const char *const *ibans, const char *const *bics, int count,
+                          AB_IBANCHECK_RESULT *results)
+{
+  int i;
+  int errors=0;
+
+  assert(ibans);
+  assert(results);
+
+  for (i=0; i<count; i++) {
+    results[i]=AB_Banking_CheckIbanAndBic(ibans[i], bics?bics[i]:NULL);
+    if (results[i]!=AB_IbanCheckResult_Ok)
+      errors++;
   }
 
-  DBG_DEBUG(AQBANKING_LOGDOMAIN, "IBAN is valid [%s]", iban);
-  return 0;
+  return errors;
+}
+
+
+
+int AB_Banking_CheckTransactionIbans(const AB_TRANSACTION_LIST *tl, AB_IBANCHECK_RESULT *results, int maxResults)
+{
+  const AB_TRANSACTION *t;
+  int i=0;
+  int errors=0;
+
+  assert(tl);
+  assert(results);
+
+  if ((int) AB_Transaction_List_GetCount(tl)>maxResults) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Result array too small (%d < %d)",
+              maxResults, (int) AB_Transaction_List_GetCount(tl));
+    return GWEN_ERROR_BUFFER_OVERFLOW;
+  }
+
+  t=AB_Transaction_List_First(tl);
+  while (t) {
+    results[i]=AB_Banking_CheckIbanAndBic(AB_Transaction_GetRemoteIban(t), AB_Transaction_GetRemoteBic(t));
+    if (results[i]!=AB_IbanCheckResult_Ok)
+      errors++;
+    i++;
+    t=AB_Transaction_List_Next(t);
+  }
+
+  return errors;
 }
 
 
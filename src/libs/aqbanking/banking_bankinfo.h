@@ -13,6 +13,7 @@
 #define AQBANKING_BANKING_INFO_H
 
 #include <aqbanking/types/bankinfo.h>
+#include <aqbanking/types/transaction.h>
 
 
 typedef enum {
@@ -23,6 +24,23 @@ typedef enum {
 } AB_BANKINFO_CHECKRESULT;
 
 
+typedef enum {
+  AB_IbanCheckResult_Ok=0,
+  /** IBAN (or BIC) missing */
+  AB_IbanCheckResult_Missing,
+  /** bad characters, lower case country code, too short or too long */
+  AB_IbanCheckResult_BadFormat,
+  /** length doesn't match the length for the country of the IBAN */
+  AB_IbanCheckResult_BadLength,
+  /** BBAN doesn't match the structure for the country of the IBAN (e.g. letters where only digits are allowed) */
+  AB_IbanCheckResult_BadStructure,
+  /** mod-97 checksum mismatch */
+  AB_IbanCheckResult_BadChecksum,
+  /** IBAN is valid but the BIC is malformed */
+  AB_IbanCheckResult_BadBic
+} AB_IBANCHECK_RESULT;
+
+
 
 #ifdef __cplusplus
 extern "C" {
@@ -105,6 +123,51 @@ AQBANKING_API AB_BANKINFO_CHECKRESULT AB_Banking_CheckAccount(AB_BANKING *ab,
 AQBANKING_API int AB_Banking_CheckIban(const char *iban);
 
 
+/**
+ * Checks an IBAN and an optional BIC.
+ *
+ * In addition to @ref AB_Banking_CheckIban this function checks the length and the structure of the
+ * IBAN against the rules for its country (if known, IBANs of unknown countries are only checked for the
+ * checksum) and the format of the BIC (8 or 11 characters). No memory is allocated.
+ * @return result of the check (see @ref AB_IBANCHECK_RESULT)
+ * @param iban IBAN (may contain blanks)
+ * @param bic BIC (NULL or empty if none)
+ */
+AQBANKING_API AB_IBANCHECK_RESULT AB_Banking_CheckIbanAndBic(const char *iban, const char *bic);
+
+
+/**
+ * Checks whether the given string is a well-formed BIC (only the format is checked,
+ * not whether the bank exists).
+ * @return 0 if valid, 1 if not
+ * @param bic BIC (e.g. "DEUTDEFF" or "DEUTDEFF500")
+ */
+AQBANKING_API int AB_Banking_CheckBic(const char *bic);
+
+
+/**
+ * Checks a number of IBANs and BICs via @ref AB_Banking_CheckIbanAndBic.
+ * @return number of entries which are not valid
+ * @param ibans array of IBANs
+ * @param bics array of corresponding BICs (NULL if no BICs are to be checked, entries may be NULL)
+ * @param count number of entries in the arrays
+ * @param results array receiving the result for every entry (must hold at least @b count entries)
+ */
+AQBANKING_API int AB_Banking_CheckIbans(const char *const *ibans, const char *const *bics, int count,
+                                        AB_IBANCHECK_RESULT *results);
+
+
+/**
+ * Checks remote IBAN and BIC of the given transactions via @ref AB_Banking_CheckIbanAndBic.
+ * @return number of transactions which are not valid (or error code if results is too small)
+ * @param tl list of transactions
+ * @param results array receiving the result for every transaction in list order
+ * @param maxResults number of entries in the results array
+ */
+AQBANKING_API int AB_Banking_CheckTransactionIbans(const AB_TRANSACTION_LIST *tl,
+                                                   AB_IBANCHECK_RESULT *results, int maxResults);
+
+
 /**
  * Create an IBAN from German bank code and account number.
  */
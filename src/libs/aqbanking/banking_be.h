@@ -86,6 +86,8 @@ AB_PROVIDER *AB_Banking_BeginUseProvider(AB_BANKING *ab, const char *modname);
 /**
  * Call this as soon as the provider isn't actually needed anymore.
  * This probably unloads the plugin, at least it is deinitialized.
+ * If the runtime config variable "keepProviders" is set the provider stays initialized until the last call
+ * to @ref AB_Banking_Fini() and the next call to @ref AB_Banking_BeginUseProvider returns the same object.
  *
  * @return 0 if ok, error code otherwise
  *
@@ -153,6 +155,17 @@ int AB_Banking_CheckCryptToken(AB_BANKING *ab,
  */
 int AB_Banking_GetNamedUniqueId(AB_BANKING *ab, const char *idName, int startAtStdUniqueId);
 
+/**
+ * Reserve a block of consecutive named unique ids with a single update of the configuration
+ * (see @ref AB_Banking_GetNamedUniqueId).
+ * @return first id of the block (the ids from there up to first+count-1 belong to the caller), error code otherwise
+ * @param ab pointer to AB_BANKING object
+ * @param idName name of the id to get (e.g. "account", "user", "job" etc)
+ * @param startAtStdUniqueId if the given id is zero and this var is !=0 start with the current standard uniqueId
+ * @param count number of ids to reserve (must be >0)
+ */
+int AB_Banking_ReserveNamedUniqueIds(AB_BANKING *ab, const char *idName, int startAtStdUniqueId, int count);
+
 
 int AB_Banking_GetCert(AB_BANKING *ab,
                        const char *url,
@@ -375,6 +375,7 @@ int AB_Banking_WriteNamedConfigGroup(AB_BANKING *ab,
       GWEN_ConfigMgr_UnlockGroup(ab->configMgr, groupName, subGroupName);
     return rv;
   }
+  AB_Banking__SettingsChanged(ab, groupName);
 
   /* unlock group */
   if (doUnlock) {
@@ -409,6 +410,17 @@ int AB_Banking_ReadConfigGroup(const AB_BANKING *ab,
   }
 
 
+  /* a plain read (lock, read, unlock) can be served from the settings snapshot */
+  if (doLock && doUnlock) {
+    const AB_SETTINGS_SNAPSHOT *ss;
+    int t;
+
+    t=AB_Banking__GetSettingsSnapshotTable(groupName);
+    ss=(t<0)?NULL:AB_Banking__GetSettingsSnapshot((AB_BANKING *) ab);
+    if (ss && AB_SettingsSnapshot_ReadGroup(ss, (AB_SETTINGS_SNAPSHOT_TABLE) t, uniqueId, pDb)==0)
+      return 0;
+  }
+
   /* make config manager id from given unique id */
   rv=GWEN_ConfigMgr_MkUniqueIdFromId(ab->configMgr, groupName, uniqueId, 0, idBuf, sizeof(idBuf)-1);
   if (rv<0) {
@@ -452,6 +464,9 @@ int AB_Banking_HasConfigGroup(const AB_BANKING *ab,
   }
   idBuf[sizeof(idBuf)-1]=0;
 
+  if (AB_Banking__HasConfigGroupInSnapshot(ab, groupName, uniqueId))
+    return 1;
+
   rv=GWEN_ConfigMgr_HasGroup(ab->configMgr, groupName, idBuf);
   if (rv<0) {
     DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
@@ -463,6 +478,29 @@ int AB_Banking_HasConfigGroup(const AB_BANKING *ab,
 
 
 
+int AB_Banking__HasConfigGroupInSnapshot(const AB_BANKING *ab, const char *groupName, uint32_t uniqueId)
+{
+  const AB_SETTINGS_SNAPSHOT *ss;
+  GWEN_DB_NODE *db=NULL;
+  int t;
+
+  t=AB_Banking__GetSettingsSnapshotTable(groupName);
+  if (t<0)
+    return 0;
+
+  ss=AB_Banking__GetSettingsSnapshot((AB_BANKING *) ab);
+  if (ss==NULL)
+    return 0;
+
+  if (AB_SettingsSnapshot_ReadGroup(ss, (AB_SETTINGS_SNAPSHOT_TABLE) t, uniqueId, &db)<0)
+    return 0;
+
+  GWEN_DB_Group_free(db);
+  return 1;
+}
+
+
+
 int AB_Banking_WriteConfigGroup(AB_BANKING *ab,
                                 const char *groupName,
                                 uint32_t uniqueId,
@@ -529,6 +567,7 @@ int AB_Banking_DeleteConfigGroup(AB_BANKING *ab, const char *groupName, uint32_t
     DBG_ERROR(AQBANKING_LOGDOMAIN, "Unable to delete config group (%d)", rv);
     return rv;
   }
+  AB_Banking__SettingsChanged(ab, groupName);
 
   return 0;
 }
@@ -574,6 +613,32 @@ int AB_Banking_ReadConfigGroups(const AB_BANKING *ab,
                                 const char *matchVar,
                                 const char *matchVal,
                                 GWEN_DB_NODE **pDb)
+{
+  int t;
+
+  /* the snapshot only contains groups with a unique id and knows about the backend name */
+  t=AB_Banking__GetSettingsSnapshotTable(groupName);
+  if (t>=0 &&
+      (uidField && strcasecmp(uidField, "uniqueId")==0) &&
+      (!(matchVar && *matchVar) || (strcasecmp(matchVar, "backendName")==0 && matchVal))) {
+    const AB_SETTINGS_SNAPSHOT *ss;
+
+    ss=AB_Banking__GetSettingsSnapshot((AB_BANKING *) ab);
+    if (ss)
+      return AB_SettingsSnapshot_ReadGroups(ss, (AB_SETTINGS_SNAPSHOT_TABLE) t, (matchVar && *matchVar)?matchVal:NULL, pDb);
+  }
+
+  return AB_Banking__ReadConfigGroupsFromFiles(ab, groupName, uidField, matchVar, matchVal, pDb);
+}
+
+
+
+int AB_Banking__ReadConfigGroupsFromFiles(const AB_BANKING *ab,
+                                          const char *groupName,
+                                          const char *uidField,
+                                          const char *matchVar,
+                                          const char *matchVal,
+                                          GWEN_DB_NODE **pDb)
 {
   GWEN_STRINGLIST *sl;
   int rv;
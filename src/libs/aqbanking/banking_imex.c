@@ -62,6 +62,10 @@
 # include "src/libs/plugins/imexporters/xml/xml.h"
 #endif
 
+#ifdef AQBANKING_WITH_PLUGIN_IMEXPORTER_COLUMNAR
+# include "src/libs/plugins/imexporters/columnar/columnar.h"
+#endif
+
 
 
 
@@ -128,6 +132,11 @@ AB_IMEXPORTER *AB_Banking__CreateImExporterPlugin(AB_BANKING *ab, const char *mo
       return AB_ImExporterXML_new(ab);
 #endif
 
+#ifdef AQBANKING_WITH_PLUGIN_IMEXPORTER_COLUMNAR
+    if (strcasecmp(modname, "columnar")==0)
+      return AB_ImExporterColumnar_new(ab);
+#endif
+
     DBG_ERROR(AQBANKING_LOGDOMAIN, "Plugin [%s] not compiled-in", modname);
   }
 
@@ -272,6 +281,86 @@ int AB_Banking_Import(AB_BANKING *ab,
 
 
 
+int AB_Banking_ImportWithTransactionFn(AB_BANKING *ab,
+                                       const char *importerName,
+                                       AB_IMEXPORTER_CONTEXT *ctx,
+                                       GWEN_SYNCIO *sio,
+                                       GWEN_DB_NODE *dbProfile,
+                                       AB_IMEXPORTER_TRANSACTION_FN fn,
+                                       void *user_data)
+{
+  AB_IMEXPORTER *ie;
+  int rv;
+
+  assert(fn);
+
+  ie=AB_Banking_GetImExporter(ab, importerName);
+  if (ie==NULL) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here");
+    return GWEN_ERROR_NO_DATA;
+  }
+
+  if (AB_ImExporter_GetFlags(ie) & AB_IMEXPORTER_FLAGS_STREAMING_IMPORT) {
+    /* importer hands over every transaction as soon as it is complete */
+    AB_ImExporter_SetTransactionFn(ie, fn, user_data);
+    rv=AB_ImExporter_Import(ie, ctx, sio, dbProfile);
+    AB_ImExporter_SetTransactionFn(ie, NULL, NULL);
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      return rv;
+    }
+  }
+  else {
+    /* importer collects transactions in the context, hand them over afterwards */
+    rv=AB_ImExporter_Import(ie, ctx, sio, dbProfile);
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      return rv;
+    }
+
+    rv=AB_Banking__DeliverContextTransactions(ctx, fn, user_data);
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      return rv;
+    }
+  }
+
+  return 0;
+}
+
+
+
+int AB_Banking__DeliverContextTransactions(AB_IMEXPORTER_CONTEXT *ctx, AB_IMEXPORTER_TRANSACTION_FN fn, void *user_data)
+{
+  AB_IMEXPORTER_ACCOUNTINFO_LIST *ail;
+  AB_IMEXPORTER_ACCOUNTINFO *ai;
+
+  ail=AB_ImExporterContext_GetAccountInfoList(ctx);
+  ai=ail?AB_ImExporterAccountInfo_List_First(ail):NULL;
+  while (ai) {
+    AB_TRANSACTION_LIST *tl;
+    AB_TRANSACTION *t;
+
+    tl=AB_ImExporterAccountInfo_GetTransactionListForUpdate(ai);
+    while (tl && (t=AB_Transaction_List_First(tl))) {
+      int rv;
+
+      AB_Transaction_List_Del(t);
+      rv=fn(ai, t, user_data);
+      AB_Transaction_free(t);
+      if (rv<0) {
+        DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+        return rv;
+      }
+    }
+    ai=AB_ImExporterAccountInfo_List_Next(ai);
+  }
+
+  return 0;
+}
+
+
+
 int AB_Banking_Export(AB_BANKING *ab,
                       const char *exporterName,
                       AB_IMEXPORTER_CONTEXT *ctx,
@@ -767,92 +856,41 @@ int AB_Banking__ReadImExporterProfiles(AB_BANKING *ab,
 GWEN_DB_NODE *AB_Banking_GetImExporterProfiles(AB_BANKING *ab,
                                                const char *name)
 {
-  GWEN_BUFFER *buf;
   GWEN_DB_NODE *db;
-  int rv;
   GWEN_STRINGLIST *sl;
   GWEN_STRINGLISTENTRY *sentry;
 
-  buf=GWEN_Buffer_new(0, 256, 0, 1);
-  db=GWEN_DB_Group_new("profiles");
+  sl=AB_Banking__GetImExporterProfileFolders(ab, name);
+  if (sl==NULL) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here");
+    return 0;
+  }
 
-  sl=AB_Banking_GetGlobalDataDirs();
-  assert(sl);
+  db=GWEN_DB_Group_new("profiles");
 
+  /* global folders first, the last one is the folder for the local user profiles */
   sentry=GWEN_StringList_FirstEntry(sl);
-  assert(sentry);
-
   while (sentry) {
-    const char *pkgdatadir;
+    GWEN_STRINGLISTENTRY *sentryNext;
+    int rv;
 
-    pkgdatadir = GWEN_StringListEntry_Data(sentry);
-    assert(pkgdatadir);
-
-    /* read global profiles */
-    GWEN_Buffer_AppendString(buf, pkgdatadir);
-    GWEN_Buffer_AppendString(buf,
-                             DIRSEP
-                             "aqbanking"
-                             DIRSEP
-                             AB_IMEXPORTER_FOLDER
-                             DIRSEP);
-    if (GWEN_Text_EscapeToBufferTolerant(name, buf)) {
-      DBG_ERROR(AQBANKING_LOGDOMAIN,
-                "Bad name for importer/exporter");
-      GWEN_StringList_free(sl);
-      GWEN_DB_Group_free(db);
-      GWEN_Buffer_free(buf);
-      return 0;
-    }
-    GWEN_Buffer_AppendString(buf, DIRSEP "profiles");
+    sentryNext=GWEN_StringListEntry_Next(sentry);
     rv=AB_Banking__ReadImExporterProfiles(ab,
-                                          GWEN_Buffer_GetStart(buf),
+                                          GWEN_StringListEntry_Data(sentry),
                                           db,
-                                          1);
+                                          sentryNext?1:0);
     if (rv && rv!=GWEN_ERROR_NOT_FOUND) {
       DBG_ERROR(AQBANKING_LOGDOMAIN,
-                "Error reading global profiles");
+                "Error reading %s profiles",
+                sentryNext?"global":"users");
       GWEN_StringList_free(sl);
       GWEN_DB_Group_free(db);
-      GWEN_Buffer_free(buf);
       return 0;
     }
-    GWEN_Buffer_Reset(buf);
-    sentry=GWEN_StringListEntry_Next(sentry);
+    sentry=sentryNext;
   }
   GWEN_StringList_free(sl);
 
-  /* read local user profiles */
-  if (AB_Banking_GetUserDataDir(ab, buf)) {
-    DBG_ERROR(AQBANKING_LOGDOMAIN,
-              "Could not get user data dir");
-    GWEN_DB_Group_free(db);
-    GWEN_Buffer_free(buf);
-    return 0;
-  }
-  GWEN_Buffer_AppendString(buf, DIRSEP AB_IMEXPORTER_FOLDER DIRSEP);
-  if (GWEN_Text_EscapeToBufferTolerant(name, buf)) {
-    DBG_ERROR(AQBANKING_LOGDOMAIN,
-              "Bad name for importer/exporter");
-    GWEN_DB_Group_free(db);
-    GWEN_Buffer_free(buf);
-    return 0;
-  }
-  GWEN_Buffer_AppendString(buf, DIRSEP "profiles");
-
-  rv=AB_Banking__ReadImExporterProfiles(ab,
-                                        GWEN_Buffer_GetStart(buf),
-                                        db,
-                                        0);
-  if (rv && rv!=GWEN_ERROR_NOT_FOUND) {
-    DBG_ERROR(AQBANKING_LOGDOMAIN,
-              "Error reading users profiles");
-    GWEN_DB_Group_free(db);
-    GWEN_Buffer_free(buf);
-    return 0;
-  }
-  GWEN_Buffer_free(buf);
-
   return db;
 }
 
@@ -1054,6 +1092,22 @@ GWEN_DB_NODE *AB_Banking_GetImExporterProfile(AB_BANKING *ab,
 {
   GWEN_DB_NODE *dbProfiles;
 
+  if (AB_Banking__UseProfileCache(ab)) {
+    GWEN_DB_NODE *dbProfile=NULL;
+    int rv;
+
+    rv=AB_Banking__GetCachedImExporterProfile(ab, imExporterName, AB_Banking__MatchProfileName, profileName, &dbProfile);
+    if (rv==0)
+      return dbProfile;
+    else if (rv==GWEN_ERROR_NOT_FOUND) {
+      DBG_ERROR(AQBANKING_LOGDOMAIN,
+                "Profile \"%s\" for exporter \"%s\" not found",
+                profileName, imExporterName);
+      return NULL;
+    }
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Profile registry not usable (%d), reading all profiles", rv);
+  }
+
   dbProfiles=AB_Banking_GetImExporterProfiles(ab, imExporterName);
   if (dbProfiles) {
     GWEN_DB_NODE *dbProfile;
@@ -1101,6 +1155,28 @@ GWEN_DB_NODE *AB_Banking_FindMatchingSwiftImExporterProfile(AB_BANKING *ab,
 {
   GWEN_DB_NODE *dbProfiles;
 
+  if (AB_Banking__UseProfileCache(ab)) {
+    AB_BANKING_SWIFT_MATCH swiftMatch;
+    GWEN_DB_NODE *dbProfile=NULL;
+    int rv;
+
+    swiftMatch.family=family;
+    swiftMatch.version1=version1;
+    swiftMatch.version2=version2;
+    swiftMatch.version3=version3;
+    rv=AB_Banking__GetCachedImExporterProfile(ab, imExporterName, AB_Banking__MatchSwiftProfile, &swiftMatch, &dbProfile);
+    if (rv==0)
+      return dbProfile;
+    else if (rv==GWEN_ERROR_NOT_FOUND) {
+      DBG_ERROR(AQBANKING_LOGDOMAIN,
+                "Profile \"%s.%03d.%03d.%02d\" for exporter \"%s\" not found",
+                family, version1, version2, version3,
+                imExporterName);
+      return NULL;
+    }
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Profile registry not usable (%d), reading all profiles", rv);
+  }
+
   dbProfiles=AB_Banking_GetImExporterProfiles(ab, imExporterName);
   if (dbProfiles) {
     GWEN_DB_NODE *dbProfile;
@@ -1151,9 +1227,13 @@ GWEN_DB_NODE *AB_Banking_FindMatchingSwiftImExporterProfile(AB_BANKING *ab,
 
 AB_SWIFT_DESCR_LIST *AB_Banking_GetSwiftDescriptorsForImExporter(AB_BANKING *ab, const char *imExporterName)
 {
-  GWEN_DB_NODE *dbProfiles;
+  GWEN_DB_NODE *dbProfiles=NULL;
 
-  dbProfiles=AB_Banking_GetImExporterProfiles(ab, imExporterName);
+  /* only the names are needed here which are also contained in the profile registry */
+  if (AB_Banking__UseProfileCache(ab))
+    dbProfiles=AB_Banking__GetProfileRegistry(ab, imExporterName);
+  if (dbProfiles==NULL)
+    dbProfiles=AB_Banking_GetImExporterProfiles(ab, imExporterName);
   if (dbProfiles) {
     GWEN_DB_NODE *dbProfile;
     AB_SWIFT_DESCR_LIST *descrList;
@@ -1164,10 +1244,9 @@ AB_SWIFT_DESCR_LIST *AB_Banking_GetSwiftDescriptorsForImExporter(AB_BANKING *ab,
       const char *name;
       AB_SWIFT_DESCR *descr;
 
+      /* the registry also contains groups for the folders which have no name */
       name=GWEN_DB_GetCharValue(dbProfile, "name", 0, 0);
-      assert(name);
-
-      descr=AB_SwiftDescr_FromString(name);
+      descr=name?AB_SwiftDescr_FromString(name):NULL;
       if (descr) {
         DBG_ERROR(AQBANKING_LOGDOMAIN, "Adding matching profile [%s]", name);
         AB_SwiftDescr_SetAlias1(descr, name);
@@ -1176,6 +1255,7 @@ AB_SWIFT_DESCR_LIST *AB_Banking_GetSwiftDescriptorsForImExporter(AB_BANKING *ab,
 
       dbProfile=GWEN_DB_GetNextGroup(dbProfile);
     }
+    GWEN_DB_Group_free(dbProfiles);
 
     if (AB_SwiftDescr_List_GetCount(descrList)==0) {
       AB_SwiftDescr_List_free(descrList);
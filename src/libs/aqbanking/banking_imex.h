@@ -90,6 +90,16 @@ AQBANKING_API
 GWEN_DB_NODE *AB_Banking_GetImExporterProfiles(AB_BANKING *ab,
                                                const char *imExporterName);
 
+/**
+ * Returns a single profile of the given im-/exporter (see @ref AB_Banking_GetImExporterProfiles).
+ *
+ * Unless the runtime variable "noProfileCache" is set only the file containing the requested profile
+ * is read. Names and locations of all profiles are taken from a registry in the user data folder
+ * which is rebuilt automatically whenever a profile folder or profile file has been modified.
+ * @param ab pointer to the AB_BANKING object
+ * @param imExporterName name of the importer whose profile is to be read
+ * @param profileName name of the profile (case-insensitive)
+ */
 AQBANKING_API
 GWEN_DB_NODE *AB_Banking_GetImExporterProfile(AB_BANKING *ab,
                                               const char *imExporterName,
@@ -196,6 +206,35 @@ int AB_Banking_Import(AB_BANKING *ab,
                       GWEN_DB_NODE *dbProfile);
 
 
+/**
+ * Reads the given stream like @ref AB_Banking_Import but hands every transaction to the given callback
+ * instead of storing it in the context. Account infos, balances and securities are still stored in the
+ * context.
+ *
+ * Importers which have the flag @ref AB_IMEXPORTER_FLAGS_STREAMING_IMPORT (e.g. "ofx") call the callback
+ * as soon as a transaction has been read and release it afterwards, so memory usage doesn't depend on the
+ * number of transactions in the input. For all other importers the transactions are handed over after the
+ * whole input has been read.
+ *
+ * @return 0 on success, error code otherwise (including errors returned by the callback which abort the import)
+ * @param ab pointer to the AqBanking object
+ * @param importerName name of the importer module (see @ref AB_Banking_Import)
+ * @param ctx import context to receive account infos etc
+ * @param sio stream to read from
+ * @param dbProfile import profile
+ * @param fn callback receiving the transactions (see @ref AB_IMEXPORTER_TRANSACTION_FN)
+ * @param user_data pointer passed to the callback
+ */
+AQBANKING_API
+int AB_Banking_ImportWithTransactionFn(AB_BANKING *ab,
+                                       const char *importerName,
+                                       AB_IMEXPORTER_CONTEXT *ctx,
+                                       GWEN_SYNCIO *sio,
+                                       GWEN_DB_NODE *dbProfile,
+                                       AB_IMEXPORTER_TRANSACTION_FN fn,
+                                       void *user_data);
+
+
 /**
  * Writes all data to the given stream.
  * This is a very basic function, there are convenience functions to make it easier to
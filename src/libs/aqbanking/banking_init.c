@@ -456,6 +456,12 @@ int AB_Banking_Fini(AB_BANKING *ab)
       return GWEN_ERROR_GENERIC;
     }
 
+    /* deinit providers kept alive for reuse */
+    AB_Banking__ReleaseKeptProviders(ab);
+
+    /* update settings snapshot if needed */
+    AB_Banking__FinishSettingsSnapshot(ab);
+
     /* lock group */
     rv=GWEN_ConfigMgr_LockGroup(ab->configMgr, AB_CFG_GROUP_MAIN, "config");
     if (rv<0) {
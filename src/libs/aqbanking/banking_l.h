@@ -33,6 +33,13 @@ int AB_Banking_Write_AccountConfig(AB_BANKING *ab, uint32_t uid, int doLock, int
 int AB_Banking_Delete_AccountConfig(AB_BANKING *ab, uint32_t uid);
 int AB_Banking_Unlock_AccountConfig(AB_BANKING *ab, uint32_t uid);
 
+/* per-account cursor of incremental transaction requests, see backendsupport/provider_fetchcursor.c */
+int AB_Banking_Read_FetchCursor(const AB_BANKING *ab, uint32_t uid, int doLock, int doUnlock, GWEN_DB_NODE **pDb);
+int AB_Banking_Has_FetchCursor(const AB_BANKING *ab, uint32_t uid);
+int AB_Banking_Write_FetchCursor(AB_BANKING *ab, uint32_t uid, int doLock, int doUnlock, GWEN_DB_NODE *db);
+int AB_Banking_Delete_FetchCursor(AB_BANKING *ab, uint32_t uid);
+int AB_Banking_Unlock_FetchCursor(AB_BANKING *ab, uint32_t uid);
+
 
 /* ========================================================================================================================
  *                                                banking_user.c
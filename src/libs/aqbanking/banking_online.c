@@ -63,6 +63,9 @@ static int _sendProviderQueues(AB_BANKING *ab,
                                AB_IMEXPORTER_CONTEXT *ctx,
                                uint32_t pid);
 
+static AB_PROVIDER *_findKeptProvider(const AB_BANKING *ab, const char *name);
+static int _finiProvider(AB_BANKING *ab, AB_PROVIDER *pro);
+
 
 
 /* ------------------------------------------------------------------------------------------------
@@ -188,6 +191,16 @@ AB_PROVIDER *AB_Banking__GetProvider(AB_BANKING *ab, const char *name)
 AB_PROVIDER *AB_Banking_BeginUseProvider(AB_BANKING *ab, const char *modname)
 {
   AB_PROVIDER *pro;
+  int keepProvider;
+
+  keepProvider=AB_Banking_RuntimeConfig_GetIntValue(ab, "keepProviders", 0);
+  if (keepProvider) {
+    pro=_findKeptProvider(ab, modname);
+    if (pro) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "Reusing initialized provider \"%s\"", modname);
+      return pro;
+    }
+  }
 
   pro=AB_Banking__GetProvider(ab, modname);
   if (pro) {
@@ -210,6 +223,12 @@ AB_PROVIDER *AB_Banking_BeginUseProvider(AB_BANKING *ab, const char *modname)
     }
     GWEN_DB_Group_free(db);
 
+    if (keepProvider) {
+      if (ab->keptProviders==NULL)
+        ab->keptProviders=AB_Provider_List_new();
+      AB_Provider_List_Add(pro, ab->keptProviders);
+    }
+
     return pro;
   }
   else {
@@ -221,12 +240,63 @@ AB_PROVIDER *AB_Banking_BeginUseProvider(AB_BANKING *ab, const char *modname)
 
 
 int AB_Banking_EndUseProvider(AB_BANKING *ab, AB_PROVIDER *pro)
+{
+  assert(pro);
+
+  if (_findKeptProvider(ab, AB_Provider_GetName(pro))==pro) {
+    /* released by AB_Banking_Fini() */
+    return 0;
+  }
+
+  return _finiProvider(ab, pro);
+}
+
+
+
+void AB_Banking__ReleaseKeptProviders(AB_BANKING *ab)
+{
+  if (ab->keptProviders) {
+    AB_PROVIDER *pro;
+
+    while ((pro=AB_Provider_List_First(ab->keptProviders))) {
+      int rv;
+
+      AB_Provider_List_Del(pro);
+      rv=_finiProvider(ab, pro);
+      if (rv<0) {
+        DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      }
+    }
+    AB_Provider_List_free(ab->keptProviders);
+    ab->keptProviders=NULL;
+  }
+}
+
+
+
+AB_PROVIDER *_findKeptProvider(const AB_BANKING *ab, const char *name)
+{
+  if (ab->keptProviders && name) {
+    AB_PROVIDER *pro;
+
+    pro=AB_Provider_List_First(ab->keptProviders);
+    while (pro) {
+      if (strcasecmp(AB_Provider_GetName(pro), name)==0)
+        return pro;
+      pro=AB_Provider_List_Next(pro);
+    }
+  }
+
+  return NULL;
+}
+
+
+
+int _finiProvider(AB_BANKING *ab, AB_PROVIDER *pro)
 {
   int rv;
   GWEN_DB_NODE *db=NULL;
 
-  assert(pro);
-
   rv=AB_Banking_ReadNamedConfigGroup(ab, AB_CFG_GROUP_BACKENDS, AB_Provider_GetName(pro), 1, 0, &db);
   if (rv<0) {
     DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
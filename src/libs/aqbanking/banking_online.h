@@ -28,6 +28,9 @@ extern "C" {
  * AqBanking holds a list of account specs for every account managed by AqBanking.
  * You can retrieve the complete list of account specs for all accounts known to AqBanking (@ref AB_Banking6_GetAccountSpecList)
  * or directly request an account spec by its unique id (@ref AB_Banking6_GetAccountSpecByUniqueId).
+ *
+ * Account specs are read from the settings once and then kept in memory. The in-memory copy is dropped whenever
+ * an account spec is written or deleted through this AB_BANKING object and reloaded on the next access.
  */
 /*@{*/
 
@@ -53,6 +56,71 @@ AQBANKING_API int AB_Banking_GetAccountSpecByUniqueId(const AB_BANKING *ab, uint
                                                       AB_ACCOUNT_SPEC **pAccountSpec);
 
 
+/**
+ * Returns an AB_ACCOUNT_SPEC object for the first account with the given IBAN.
+ * The caller is responsible for freeing the data returned (if any) via @ref AB_AccountSpec_free.
+ * @return 0 if ok, GWEN_ERROR_NOT_FOUND if there is no such account, error code otherwise
+ * @param ab pointer to the AB_BANKING object
+ * @param iban IBAN of the account to look for (no wildcards)
+ * @param pAccountSpec Pointer to a variable to receive the matching account spec.
+ */
+AQBANKING_API int AB_Banking_GetAccountSpecByIban(const AB_BANKING *ab, const char *iban,
+                                                  AB_ACCOUNT_SPEC **pAccountSpec);
+
+
+/**
+ * Returns an AB_ACCOUNT_SPEC object for the first account with the given bank code and account number.
+ * The caller is responsible for freeing the data returned (if any) via @ref AB_AccountSpec_free.
+ * @return 0 if ok, GWEN_ERROR_NOT_FOUND if there is no such account, error code otherwise
+ * @param ab pointer to the AB_BANKING object
+ * @param bankCode bank code of the account to look for (no wildcards)
+ * @param accountNumber account number to look for (no wildcards)
+ * @param pAccountSpec Pointer to a variable to receive the matching account spec.
+ */
+AQBANKING_API int AB_Banking_GetAccountSpecByBankCodeAndAccountNumber(const AB_BANKING *ab,
+                                                                      const char *bankCode,
+                                                                      const char *accountNumber,
+                                                                      AB_ACCOUNT_SPEC **pAccountSpec);
+
+
+/**
+ * Returns the list of AB_ACCOUNT_SPEC objects for all accounts with the given IBAN (in the order of
+ * @ref AB_Banking_GetAccountSpecList). The caller is responsible for freeing the list returned (if any)
+ * via @ref AB_AccountSpec_List_free.
+ * @return 0 if ok, GWEN_ERROR_NOT_FOUND if there is no such account, error code otherwise
+ * @param ab pointer to the AB_BANKING object
+ * @param iban IBAN of the accounts to look for (no wildcards)
+ * @param pAccountSpecList Pointer to a variable receiving the list of matching account specs.
+ */
+AQBANKING_API int AB_Banking_GetAccountSpecListByIban(const AB_BANKING *ab, const char *iban,
+                                                      AB_ACCOUNT_SPEC_LIST **pAccountSpecList);
+
+
+/**
+ * Returns the list of AB_ACCOUNT_SPEC objects for all accounts with the given bank code and account number
+ * (in the order of @ref AB_Banking_GetAccountSpecList). The caller is responsible for freeing the list returned
+ * (if any) via @ref AB_AccountSpec_List_free.
+ * @return 0 if ok, GWEN_ERROR_NOT_FOUND if there is no such account, error code otherwise
+ * @param ab pointer to the AB_BANKING object
+ * @param bankCode bank code of the accounts to look for (no wildcards)
+ * @param accountNumber account number to look for (no wildcards)
+ * @param pAccountSpecList Pointer to a variable receiving the list of matching account specs.
+ */
+AQBANKING_API int AB_Banking_GetAccountSpecListByBankCodeAndAccountNumber(const AB_BANKING *ab,
+                                                                          const char *bankCode,
+                                                                          const char *accountNumber,
+                                                                          AB_ACCOUNT_SPEC_LIST **pAccountSpecList);
+
+
+/**
+ * Drop the in-memory copy of the account specs so they are reloaded on the next access.
+ * Long running applications should call this before every operation because account specs might have been
+ * changed by other processes.
+ * @param ab pointer to the AB_BANKING object
+ */
+AQBANKING_API void AB_Banking_ClearAccountSpecCache(AB_BANKING *ab);
+
+
 /*@}*/
 
 
@@ -44,6 +44,7 @@
 #define AB_CFG_GROUP_SHARED       "shared"
 #define AB_CFG_GROUP_ACCOUNTSPECS "accountspecs"
 #define AB_CFG_GROUP_USERSPECS    "userspecs"
+#define AB_CFG_GROUP_FETCHCURSORS "fetchcursors"
 
 
 
@@ -52,8 +53,12 @@
 #include "backendsupport/imexporter_l.h"
 #include "backendsupport/bankinfoplugin_l.h"
 
+#include "aqbanking/types/hashindex.h"
+#include "settingssnapshot_l.h"
+
 #include <gwenhywfar/plugin.h>
 #include <gwenhywfar/syncio_memory.h>
+#include <gwenhywfar/idmap.h>
 
 
 
@@ -76,6 +81,19 @@ struct AB_BANKING {
   GWEN_CONFIGMGR *configMgr;
 
   GWEN_DB_NODE *dbRuntimeConfig;
+
+  /* in-memory copy of all account specs, see banking_accspec.c (NULL if not loaded) */
+  AB_ACCOUNT_SPEC_LIST *accountSpecCache;
+  GWEN_IDMAP *accountSpecByUniqueId;
+  AB_HASHINDEX *accountSpecByIban;
+  AB_HASHINDEX *accountSpecByBankCodeAndAccountNumber;
+
+  /* mapped settings snapshot, see banking_snapshot.c (NULL if not opened) */
+  AB_SETTINGS_SNAPSHOT *settingsSnapshot;
+  int settingsSnapshotDirty;
+
+  /* providers kept initialized between uses if runtime config var "keepProviders" is set, see banking_online.c */
+  AB_PROVIDER_LIST *keptProviders;
 };
 
 
@@ -87,6 +105,8 @@ GWEN_CONFIGMGR *AB_Banking_GetConfigMgr(AB_BANKING *ab);
 
 static int AB_Banking__GetConfigManager(AB_BANKING *ab, const char *dname);
 
+static void AB_Banking__ReleaseKeptProviders(AB_BANKING *ab);
+
 
 static AB_IMEXPORTER *AB_Banking_FindImExporter(AB_BANKING *ab, const char *name);
 
@@ -104,6 +124,8 @@ static int AB_Banking__ReadImExporterProfiles(AB_BANKING *ab,
 
 
 static int AB_Banking__TransformIban(const char *iban, int len, char *newIban, int maxLen);
+static int AB_Banking__IbanMod97(const char *iban);
+static int AB_Banking__CheckIbanStructure(const char *iban);
 
 
 
@@ -185,6 +207,69 @@ static int AB_Banking_DeleteConfigGroup(AB_BANKING *ab, const char *groupName, u
 
 static int AB_Banking_UnlockConfigGroup(AB_BANKING *ab, const char *groupName, uint32_t uniqueId);
 
+/**
+ * Read all config groups of the given group from the config manager (i.e. without using the settings snapshot),
+ * arguments and result like @ref AB_Banking_ReadConfigGroups.
+ */
+static int AB_Banking__ReadConfigGroupsFromFiles(const AB_BANKING *ab,
+                                                 const char *groupName,
+                                                 const char *uidField,
+                                                 const char *matchVar,
+                                                 const char *matchVal,
+                                                 GWEN_DB_NODE **pDb);
+
+/**
+ * @return 1 if the given config group is found in the settings snapshot, 0 otherwise (i.e. also if the snapshot
+ *   is not usable, the caller has to ask the config manager in that case)
+ */
+static int AB_Banking__HasConfigGroupInSnapshot(const AB_BANKING *ab, const char *groupName, uint32_t uniqueId);
+
+
+
+
+/* ========================================================================================================================
+ *                                                banking_snapshot.c
+ * ========================================================================================================================
+ */
+
+static int AB_Banking__UseSettingsSnapshot(const AB_BANKING *ab);
+
+/**
+ * @return table of the settings snapshot for the given config group, -1 if the group is not in the snapshot
+ */
+static int AB_Banking__GetSettingsSnapshotTable(const char *groupName);
+
+static void AB_Banking__GetSettingsSnapshotPath(const AB_BANKING *ab, const char *suffix, GWEN_BUFFER *buf);
+static uint32_t AB_Banking__ReadSettingsGeneration(const AB_BANKING *ab);
+static int AB_Banking__WriteSettingsGeneration(const AB_BANKING *ab, uint32_t generation);
+
+/**
+ * To be called after a config group has been written or deleted, invalidates the settings snapshot
+ * if the group is part of it.
+ */
+static void AB_Banking__SettingsChanged(AB_BANKING *ab, const char *groupName);
+
+static void AB_Banking__RemoveSettingsSnapshot(const AB_BANKING *ab);
+static void AB_Banking__ReleaseSettingsSnapshot(AB_BANKING *ab);
+static int AB_Banking__AddSettingsSnapshotTable(const AB_BANKING *ab,
+                                                AB_SETTINGS_SNAPSHOT_WRITER *sw,
+                                                AB_SETTINGS_SNAPSHOT_TABLE t,
+                                                const char *groupName);
+static int AB_Banking__WriteSettingsSnapshot(const AB_BANKING *ab);
+static int AB_Banking__OpenSettingsSnapshot(const AB_BANKING *ab, uint32_t generation, AB_SETTINGS_SNAPSHOT **pSnapshot);
+
+/**
+ * Return the current settings snapshot (rebuilt if needed).
+ * @return NULL if the snapshot is disabled, not usable or this session has changed the settings
+ *   (the caller has to read from the config manager in that case)
+ */
+static const AB_SETTINGS_SNAPSHOT *AB_Banking__GetSettingsSnapshot(AB_BANKING *ab);
+
+/**
+ * Called by @ref AB_Banking_Fini: rebuild the snapshot if this session has changed the settings.
+ */
+static void AB_Banking__FinishSettingsSnapshot(AB_BANKING *ab);
+
 
 
 
@@ -195,6 +280,70 @@ static AB_PROVIDER *AB_Banking__GetProvider(AB_BANKING *ab, const char *name);
 
 
 static AB_IMEXPORTER *AB_Banking_GetImExporter(AB_BANKING *ab, const char *name);
+static int AB_Banking__DeliverContextTransactions(AB_IMEXPORTER_CONTEXT *ctx,
+                                                 AB_IMEXPORTER_TRANSACTION_FN fn,
+                                                 void *user_data);
+
+
+
+
+/* ========================================================================================================================
+ *                                                banking_profilecache.c
+ * ========================================================================================================================
+ */
+
+/**
+ * Callback used to select a profile from the profile registry by its name.
+ * @return 1 if the profile matches, 0 otherwise
+ */
+typedef int (*AB_BANKING_PROFILE_MATCH_FN)(const char *profileName, const void *matchData);
+
+typedef struct AB_BANKING_SWIFT_MATCH AB_BANKING_SWIFT_MATCH;
+struct AB_BANKING_SWIFT_MATCH {
+  const char *family;
+  int version1;
+  int version2;
+  int version3;
+};
+
+
+static int AB_Banking__UseProfileCache(const AB_BANKING *ab);
+
+/**
+ * Return the profile folders of the given im-/exporter: the global folders first, the local folder of the
+ * user is always the last entry.
+ */
+static GWEN_STRINGLIST *AB_Banking__GetImExporterProfileFolders(AB_BANKING *ab, const char *imExporterName);
+
+static int AB_Banking__GetProfileCacheFile(AB_BANKING *ab, const char *imExporterName, GWEN_BUFFER *buf);
+
+/**
+ * @return 0 for a file, 1 for a folder, GWEN_ERROR_NOT_FOUND if the path doesn't exist
+ */
+static int AB_Banking__StatProfileFile(const char *path, char *mtimeBuf, int mtimeLen, long long *pSize);
+static int AB_Banking__ScanProfileFolder(const char *path, int isGlobal, GWEN_DB_NODE *dbRegistry);
+static GWEN_DB_NODE *AB_Banking__ScanProfileRegistry(const GWEN_STRINGLIST *slFolders);
+static int AB_Banking__ProfileRegistryIsValid(GWEN_DB_NODE *dbRegistry, const GWEN_STRINGLIST *slFolders);
+static int AB_Banking__WriteProfileRegistry(GWEN_DB_NODE *dbRegistry, const char *folder);
+
+/**
+ * Load the profile registry of the given im-/exporter from the cache file, rebuild it if it is missing or outdated.
+ */
+static GWEN_DB_NODE *AB_Banking__GetProfileRegistry(AB_BANKING *ab, const char *imExporterName);
+
+/**
+ * Read the first profile accepted by the given match function, only that profile file is parsed.
+ * @return 0 if ok, GWEN_ERROR_NOT_FOUND if no profile matches, other errors if the registry is not usable
+ *   (the caller should fall back to @ref AB_Banking_GetImExporterProfiles in that case)
+ */
+static int AB_Banking__GetCachedImExporterProfile(AB_BANKING *ab,
+                                                  const char *imExporterName,
+                                                  AB_BANKING_PROFILE_MATCH_FN fn,
+                                                  const void *matchData,
+                                                  GWEN_DB_NODE **pDb);
+
+static int AB_Banking__MatchProfileName(const char *profileName, const void *matchData);
+static int AB_Banking__MatchSwiftProfile(const char *profileName, const void *matchData);
 
 
 
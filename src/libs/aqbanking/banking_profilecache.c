@@ -0,0 +1,481 @@
+/***************************************************************************
+ begin       : Mon Oct 19 2026
+ copyright   : (C) 2026 by Martin Preuss
+ email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+/* This file is included by banking.c */
+
+
+/*
+ * The profile registry of an im-/exporter contains name, path, modification time and size of every
+ * profile file in the global and local profile folders. It is stored per user in
+ * "<userdatadir>/imexporters/<name>/profiles.cache", so that looking up a single profile only needs to
+ * stat the profile folders and files instead of parsing every profile file.
+ *
+ * The registry is rebuilt if the list of folders differs, if a folder has been modified (i.e. a file has
+ * been added, removed or renamed) or if a profile file has been changed.
+ */
+
+
+#define AB_PROFILE_REGISTRY_VERSION  1
+#define AB_PROFILE_REGISTRY_FILENAME "profiles.cache"
+
+
+
+int AB_Banking__UseProfileCache(const AB_BANKING *ab)
+{
+  return (AB_Banking_RuntimeConfig_GetIntValue(ab, "noProfileCache", 0)==0)?1:0;
+}
+
+
+
+GWEN_STRINGLIST *AB_Banking__GetImExporterProfileFolders(AB_BANKING *ab, const char *imExporterName)
+{
+  GWEN_STRINGLIST *sl;
+  GWEN_STRINGLIST *slFolders;
+  GWEN_STRINGLISTENTRY *sentry;
+  GWEN_BUFFER *buf;
+
+  buf=GWEN_Buffer_new(0, 256, 0, 1);
+  slFolders=GWEN_StringList_new();
+
+  /* global folders */
+  sl=AB_Banking_GetGlobalDataDirs();
+  assert(sl);
+  sentry=GWEN_StringList_FirstEntry(sl);
+  while (sentry) {
+    const char *pkgdatadir;
+
+    pkgdatadir=GWEN_StringListEntry_Data(sentry);
+    assert(pkgdatadir);
+
+    GWEN_Buffer_AppendString(buf, pkgdatadir);
+    GWEN_Buffer_AppendString(buf, DIRSEP "aqbanking" DIRSEP AB_IMEXPORTER_FOLDER DIRSEP);
+    if (GWEN_Text_EscapeToBufferTolerant(imExporterName, buf)) {
+      DBG_ERROR(AQBANKING_LOGDOMAIN, "Bad name for importer/exporter");
+      GWEN_StringList_free(sl);
+      GWEN_StringList_free(slFolders);
+      GWEN_Buffer_free(buf);
+      return NULL;
+    }
+    GWEN_Buffer_AppendString(buf, DIRSEP "profiles");
+    GWEN_StringList_AppendString(slFolders, GWEN_Buffer_GetStart(buf), 0, 0);
+    GWEN_Buffer_Reset(buf);
+    sentry=GWEN_StringListEntry_Next(sentry);
+  }
+  GWEN_StringList_free(sl);
+
+  /* local folder (always the last entry) */
+  if (AB_Banking_GetUserDataDir(ab, buf)) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Could not get user data dir");
+    GWEN_StringList_free(slFolders);
+    GWEN_Buffer_free(buf);
+    return NULL;
+  }
+  GWEN_Buffer_AppendString(buf, DIRSEP AB_IMEXPORTER_FOLDER DIRSEP);
+  if (GWEN_Text_EscapeToBufferTolerant(imExporterName, buf)) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Bad name for importer/exporter");
+    GWEN_StringList_free(slFolders);
+    GWEN_Buffer_free(buf);
+    return NULL;
+  }
+  GWEN_Buffer_AppendString(buf, DIRSEP "profiles");
+  GWEN_StringList_AppendString(slFolders, GWEN_Buffer_GetStart(buf), 0, 0);
+  GWEN_Buffer_free(buf);
+
+  return slFolders;
+}
+
+
+
+int AB_Banking__GetProfileCacheFile(AB_BANKING *ab, const char *imExporterName, GWEN_BUFFER *buf)
+{
+  int rv;
+
+  rv=AB_Banking_GetUserDataDir(ab, buf);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+  GWEN_Buffer_AppendString(buf, DIRSEP AB_IMEXPORTER_FOLDER DIRSEP);
+  rv=GWEN_Text_EscapeToBufferTolerant(imExporterName, buf);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+  return 0;
+}
+
+
+
+int AB_Banking__StatProfileFile(const char *path, char *mtimeBuf, int mtimeLen, long long *pSize)
+{
+  struct stat st;
+
+  if (stat(path, &st))
+    return GWEN_ERROR_NOT_FOUND;
+
+  snprintf(mtimeBuf, mtimeLen, "%lld", (long long) st.st_mtime);
+  if (pSize)
+    *pSize=(long long) st.st_size;
+  return S_ISDIR(st.st_mode)?1:0;
+}
+
+
+
+int AB_Banking__ScanProfileFolder(const char *path, int isGlobal, GWEN_DB_NODE *dbRegistry)
+{
+  GWEN_DIRECTORY *d;
+  GWEN_BUFFER *nbuf;
+  char nbuffer[64];
+  unsigned int pathLen;
+
+  d=GWEN_Directory_new();
+  if (GWEN_Directory_Open(d, path)) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Path \"%s\" is not available", path);
+    GWEN_Directory_free(d);
+    return GWEN_ERROR_NOT_FOUND;
+  }
+
+  nbuf=GWEN_Buffer_new(0, 256, 0, 1);
+  GWEN_Buffer_AppendString(nbuf, path);
+  pathLen=GWEN_Buffer_GetUsedBytes(nbuf);
+
+  /* same selection of files as in AB_Banking__ReadImExporterProfiles() */
+  while (!GWEN_Directory_Read(d, nbuffer, sizeof(nbuffer))) {
+    int nlen;
+
+    nlen=strlen(nbuffer);
+    if (nlen>4 && strcasecmp(nbuffer+nlen-5, ".conf")==0) {
+      char mtimeBuf[32];
+      long long fileSize=0;
+      int rv;
+
+      GWEN_Buffer_Crop(nbuf, 0, pathLen);
+      GWEN_Buffer_SetPos(nbuf, pathLen);
+      GWEN_Buffer_AppendString(nbuf, DIRSEP);
+      GWEN_Buffer_AppendString(nbuf, nbuffer);
+
+      rv=AB_Banking__StatProfileFile(GWEN_Buffer_GetStart(nbuf), mtimeBuf, sizeof(mtimeBuf), &fileSize);
+      if (rv==0) {
+        GWEN_DB_NODE *dbT;
+
+        dbT=GWEN_DB_Group_new("profile");
+        if (GWEN_DB_ReadFile(dbT, GWEN_Buffer_GetStart(nbuf), GWEN_DB_FLAGS_DEFAULT | GWEN_PATH_FLAGS_CREATE_GROUP)) {
+          DBG_ERROR(AQBANKING_LOGDOMAIN, "Could not read file \"%s\"", GWEN_Buffer_GetStart(nbuf));
+        }
+        else {
+          const char *s;
+
+          s=GWEN_DB_GetCharValue(dbT, "name", 0, 0);
+          if (!s) {
+            DBG_ERROR(AQBANKING_LOGDOMAIN, "Bad file \"%s\" (no name)", GWEN_Buffer_GetStart(nbuf));
+          }
+          else {
+            GWEN_DB_NODE *dbEntry;
+
+            /* a later profile of the same name replaces the earlier one (and moves to the end) */
+            dbEntry=GWEN_DB_FindFirstGroup(dbRegistry, "profile");
+            while (dbEntry) {
+              const char *t;
+
+              t=GWEN_DB_GetCharValue(dbEntry, "name", 0, NULL);
+              if (t && strcmp(t, s)==0) {
+                GWEN_DB_UnlinkGroup(dbEntry);
+                GWEN_DB_Group_free(dbEntry);
+                break;
+              }
+              dbEntry=GWEN_DB_FindNextGroup(dbEntry, "profile");
+            }
+
+            dbEntry=GWEN_DB_GetGroup(dbRegistry, GWEN_PATH_FLAGS_CREATE_GROUP, "profile");
+            GWEN_DB_SetCharValue(dbEntry, GWEN_DB_FLAGS_OVERWRITE_VARS, "name", s);
+            GWEN_DB_SetCharValue(dbEntry, GWEN_DB_FLAGS_OVERWRITE_VARS, "path", GWEN_Buffer_GetStart(nbuf));
+            GWEN_DB_SetCharValue(dbEntry, GWEN_DB_FLAGS_OVERWRITE_VARS, "fileName", nbuffer);
+            GWEN_DB_SetIntValue(dbEntry, GWEN_DB_FLAGS_OVERWRITE_VARS, "isGlobal", isGlobal);
+            GWEN_DB_SetCharValue(dbEntry, GWEN_DB_FLAGS_OVERWRITE_VARS, "mtime", mtimeBuf);
+            GWEN_DB_SetIntValue(dbEntry, GWEN_DB_FLAGS_OVERWRITE_VARS, "size", (int) fileSize);
+          }
+        }
+        GWEN_DB_Group_free(dbT);
+      }
+      else if (rv<0) {
+        DBG_ERROR(AQBANKING_LOGDOMAIN, "stat(%s): %s", GWEN_Buffer_GetStart(nbuf), strerror(errno));
+      }
+    }
+  }
+  GWEN_Directory_Close(d);
+  GWEN_Directory_free(d);
+  GWEN_Buffer_free(nbuf);
+
+  return 0;
+}
+
+
+
+GWEN_DB_NODE *AB_Banking__ScanProfileRegistry(const GWEN_STRINGLIST *slFolders)
+{
+  GWEN_DB_NODE *dbRegistry;
+  GWEN_STRINGLISTENTRY *sentry;
+
+  dbRegistry=GWEN_DB_Group_new("profileRegistry");
+  GWEN_DB_SetIntValue(dbRegistry, GWEN_DB_FLAGS_OVERWRITE_VARS, "version", AB_PROFILE_REGISTRY_VERSION);
+
+  sentry=GWEN_StringList_FirstEntry(slFolders);
+  while (sentry) {
+    const char *path;
+    GWEN_DB_NODE *dbFolder;
+    char mtimeBuf[32];
+    int rv;
+
+    path=GWEN_StringListEntry_Data(sentry);
+    dbFolder=GWEN_DB_GetGroup(dbRegistry, GWEN_PATH_FLAGS_CREATE_GROUP, "folder");
+    GWEN_DB_SetCharValue(dbFolder, GWEN_DB_FLAGS_OVERWRITE_VARS, "path", path);
+
+    rv=AB_Banking__StatProfileFile(path, mtimeBuf, sizeof(mtimeBuf), NULL);
+    if (rv<0)
+      strcpy(mtimeBuf, "0");
+    GWEN_DB_SetCharValue(dbFolder, GWEN_DB_FLAGS_OVERWRITE_VARS, "mtime", mtimeBuf);
+
+    rv=AB_Banking__ScanProfileFolder(path, GWEN_StringListEntry_Next(sentry)?1:0, dbRegistry);
+    if (rv<0 && rv!=GWEN_ERROR_NOT_FOUND) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      GWEN_DB_Group_free(dbRegistry);
+      return NULL;
+    }
+    sentry=GWEN_StringListEntry_Next(sentry);
+  }
+
+  return dbRegistry;
+}
+
+
+
+int AB_Banking__ProfileRegistryIsValid(GWEN_DB_NODE *dbRegistry, const GWEN_STRINGLIST *slFolders)
+{
+  GWEN_STRINGLISTENTRY *sentry;
+  GWEN_DB_NODE *dbT;
+
+  if (GWEN_DB_GetIntValue(dbRegistry, "version", 0, 0)!=AB_PROFILE_REGISTRY_VERSION)
+    return 0;
+
+  /* same folders in the same order, none of them modified */
+  sentry=GWEN_StringList_FirstEntry(slFolders);
+  dbT=GWEN_DB_FindFirstGroup(dbRegistry, "folder");
+  while (sentry && dbT) {
+    const char *s;
+    char mtimeBuf[32];
+
+    s=GWEN_DB_GetCharValue(dbT, "path", 0, NULL);
+    if (s==NULL || strcmp(s, GWEN_StringListEntry_Data(sentry))!=0)
+      return 0;
+
+    if (AB_Banking__StatProfileFile(s, mtimeBuf, sizeof(mtimeBuf), NULL)<0)
+      strcpy(mtimeBuf, "0");
+    s=GWEN_DB_GetCharValue(dbT, "mtime", 0, NULL);
+    if (s==NULL || strcmp(s, mtimeBuf)!=0)
+      return 0;
+
+    sentry=GWEN_StringListEntry_Next(sentry);
+    dbT=GWEN_DB_FindNextGroup(dbT, "folder");
+  }
+  if (sentry || dbT)
+    return 0;
+
+  /* profile files changed in place */
+  dbT=GWEN_DB_FindFirstGroup(dbRegistry, "profile");
+  while (dbT) {
+    const char *s;
+    char mtimeBuf[32];
+    long long fileSize=0;
+
+    s=GWEN_DB_GetCharValue(dbT, "path", 0, NULL);
+    if (s==NULL || AB_Banking__StatProfileFile(s, mtimeBuf, sizeof(mtimeBuf), &fileSize)!=0)
+      return 0;
+    s=GWEN_DB_GetCharValue(dbT, "mtime", 0, NULL);
+    if (s==NULL || strcmp(s, mtimeBuf)!=0 || GWEN_DB_GetIntValue(dbT, "size", 0, -1)!=(int) fileSize)
+      return 0;
+
+    dbT=GWEN_DB_FindNextGroup(dbT, "profile");
+  }
+
+  return 1;
+}
+
+
+
+int AB_Banking__WriteProfileRegistry(GWEN_DB_NODE *dbRegistry, const char *folder)
+{
+  GWEN_BUFFER *fbuf;
+  GWEN_BUFFER *tbuf;
+  int rv;
+
+  rv=GWEN_Directory_GetPath(folder, GWEN_PATH_FLAGS_CHECKROOT);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  fbuf=GWEN_Buffer_new(0, 256, 0, 1);
+  GWEN_Buffer_AppendString(fbuf, folder);
+  GWEN_Buffer_AppendString(fbuf, DIRSEP AB_PROFILE_REGISTRY_FILENAME);
+
+  /* write to a temporary file first, other processes might currently read the registry */
+  tbuf=GWEN_Buffer_new(0, 256, 0, 1);
+  GWEN_Buffer_AppendBuffer(tbuf, fbuf);
+  GWEN_Buffer_AppendArgs(tbuf, ".%d.tmp", (int) getpid());
+
+  rv=GWEN_DB_WriteFile(dbRegistry, GWEN_Buffer_GetStart(tbuf), GWEN_DB_FLAGS_DEFAULT);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Could not write profile registry \"%s\" (%d)", GWEN_Buffer_GetStart(tbuf), rv);
+    unlink(GWEN_Buffer_GetStart(tbuf));
+    GWEN_Buffer_free(tbuf);
+    GWEN_Buffer_free(fbuf);
+    return rv;
+  }
+
+#ifdef OS_WIN32
+  /* rename() doesn't replace existing files on windows */
+  unlink(GWEN_Buffer_GetStart(fbuf));
+#endif
+  if (rename(GWEN_Buffer_GetStart(tbuf), GWEN_Buffer_GetStart(fbuf))) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "rename(%s): %s", GWEN_Buffer_GetStart(tbuf), strerror(errno));
+    unlink(GWEN_Buffer_GetStart(tbuf));
+    GWEN_Buffer_free(tbuf);
+    GWEN_Buffer_free(fbuf);
+    return GWEN_ERROR_IO;
+  }
+
+  GWEN_Buffer_free(tbuf);
+  GWEN_Buffer_free(fbuf);
+  return 0;
+}
+
+
+
+GWEN_DB_NODE *AB_Banking__GetProfileRegistry(AB_BANKING *ab, const char *imExporterName)
+{
+  GWEN_STRINGLIST *slFolders;
+  GWEN_BUFFER *buf;
+  GWEN_DB_NODE *dbRegistry;
+  uint32_t pos;
+  int rv;
+
+  slFolders=AB_Banking__GetImExporterProfileFolders(ab, imExporterName);
+  if (slFolders==NULL) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here");
+    return NULL;
+  }
+
+  buf=GWEN_Buffer_new(0, 256, 0, 1);
+  rv=AB_Banking__GetProfileCacheFile(ab, imExporterName, buf);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    GWEN_Buffer_free(buf);
+    GWEN_StringList_free(slFolders);
+    return NULL;
+  }
+  pos=GWEN_Buffer_GetPos(buf);
+  GWEN_Buffer_AppendString(buf, DIRSEP AB_PROFILE_REGISTRY_FILENAME);
+
+  dbRegistry=GWEN_DB_Group_new("profileRegistry");
+  rv=GWEN_DB_ReadFile(dbRegistry, GWEN_Buffer_GetStart(buf), GWEN_DB_FLAGS_DEFAULT | GWEN_PATH_FLAGS_CREATE_GROUP);
+  if (rv<0 || !AB_Banking__ProfileRegistryIsValid(dbRegistry, slFolders)) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Profile registry for \"%s\" missing or outdated, rebuilding", imExporterName);
+    GWEN_DB_Group_free(dbRegistry);
+    dbRegistry=AB_Banking__ScanProfileRegistry(slFolders);
+    if (dbRegistry) {
+      GWEN_Buffer_Crop(buf, 0, pos);
+      /* errors are not fatal here, the registry is just rebuilt next time */
+      AB_Banking__WriteProfileRegistry(dbRegistry, GWEN_Buffer_GetStart(buf));
+    }
+  }
+  GWEN_Buffer_free(buf);
+  GWEN_StringList_free(slFolders);
+
+  return dbRegistry;
+}
+
+
+
+int AB_Banking__GetCachedImExporterProfile(AB_BANKING *ab,
+                                           const char *imExporterName,
+                                           AB_BANKING_PROFILE_MATCH_FN fn,
+                                           const void *matchData,
+                                           GWEN_DB_NODE **pDb)
+{
+  GWEN_DB_NODE *dbRegistry;
+  GWEN_DB_NODE *dbEntry;
+  GWEN_DB_NODE *dbProfile;
+  const char *name;
+  const char *path;
+  int rv;
+
+  dbRegistry=AB_Banking__GetProfileRegistry(ab, imExporterName);
+  if (dbRegistry==NULL) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "No profile registry for \"%s\"", imExporterName);
+    return GWEN_ERROR_GENERIC;
+  }
+
+  dbEntry=GWEN_DB_FindFirstGroup(dbRegistry, "profile");
+  while (dbEntry) {
+    name=GWEN_DB_GetCharValue(dbEntry, "name", 0, NULL);
+    if (name && fn(name, matchData))
+      break;
+    dbEntry=GWEN_DB_FindNextGroup(dbEntry, "profile");
+  }
+  if (dbEntry==NULL) {
+    GWEN_DB_Group_free(dbRegistry);
+    return GWEN_ERROR_NOT_FOUND;
+  }
+
+  name=GWEN_DB_GetCharValue(dbEntry, "name", 0, NULL);
+  path=GWEN_DB_GetCharValue(dbEntry, "path", 0, NULL);
+  assert(path);
+
+  /* same layout as the groups returned by AB_Banking_GetImExporterProfiles() */
+  dbProfile=GWEN_DB_Group_new(name);
+  rv=GWEN_DB_ReadFile(dbProfile, path, GWEN_DB_FLAGS_DEFAULT | GWEN_PATH_FLAGS_CREATE_GROUP);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Could not read profile file \"%s\" (%d)", path, rv);
+    GWEN_DB_Group_free(dbProfile);
+    GWEN_DB_Group_free(dbRegistry);
+    return rv;
+  }
+  GWEN_DB_SetIntValue(dbProfile, GWEN_DB_FLAGS_OVERWRITE_VARS, "isGlobal", GWEN_DB_GetIntValue(dbEntry, "isGlobal", 0, 0));
+  GWEN_DB_SetCharValue(dbProfile, GWEN_DB_FLAGS_OVERWRITE_VARS, "fileName", GWEN_DB_GetCharValue(dbEntry, "fileName", 0, ""));
+  GWEN_DB_Group_free(dbRegistry);
+
+  *pDb=dbProfile;
+  return 0;
+}
+
+
+
+int AB_Banking__MatchProfileName(const char *profileName, const void *matchData)
+{
+  return (strcasecmp(profileName, (const char *) matchData)==0)?1:0;
+}
+
+
+
+int AB_Banking__MatchSwiftProfile(const char *profileName, const void *matchData)
+{
+  const AB_BANKING_SWIFT_MATCH *m;
+  AB_SWIFT_DESCR *swiftDescr;
+  int rv=0;
+
+  m=(const AB_BANKING_SWIFT_MATCH *) matchData;
+  swiftDescr=AB_SwiftDescr_FromString(profileName);
+  if (swiftDescr) {
+    rv=AB_SwiftDescr_Matches(swiftDescr, m->family, m->version1, m->version2, m->version3)?1:0;
+    AB_SwiftDescr_free(swiftDescr);
+  }
+  return rv;
+}
+
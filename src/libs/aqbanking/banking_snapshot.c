@@ -0,0 +1,359 @@
+/***************************************************************************
+ begin       : Mon Oct 19 2026
+ copyright   : (C) 2026 by Martin Preuss
+ email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+/* This file is included by banking.c */
+
+
+/*
+ * Settings snapshot
+ *
+ * All config groups of users, accounts and account specs are additionally stored in a single file
+ * "settings6.snapshot" next to the settings folder (see settingssnapshot_l.h). Read-only accesses to these
+ * groups are served from that file without locking and reading every single group file.
+ *
+ * Every change to one of those groups writes a new value to the file "settings6.generation". A snapshot
+ * remembers the generation it has been created from, so a snapshot which doesn't match the current generation
+ * is rebuilt by the next reader. A session which changed the settings itself doesn't use the snapshot anymore
+ * and rebuilds it when AqBanking is deinitialized.
+ */
+
+
+#define AB_BANKING_SNAPSHOT_SUFFIX   ".snapshot"
+#define AB_BANKING_GENERATION_SUFFIX ".generation"
+
+
+
+int AB_Banking__UseSettingsSnapshot(const AB_BANKING *ab)
+{
+  return (ab->dataDir && AB_Banking_RuntimeConfig_GetIntValue(ab, "noSettingsSnapshot", 0)==0)?1:0;
+}
+
+
+
+int AB_Banking__GetSettingsSnapshotTable(const char *groupName)
+{
+  if (groupName) {
+    if (strcasecmp(groupName, AB_CFG_GROUP_USERS)==0)
+      return AB_SettingsSnapshotTable_Users;
+    else if (strcasecmp(groupName, AB_CFG_GROUP_ACCOUNTS)==0)
+      return AB_SettingsSnapshotTable_Accounts;
+    else if (strcasecmp(groupName, AB_CFG_GROUP_ACCOUNTSPECS)==0)
+      return AB_SettingsSnapshotTable_AccountSpecs;
+  }
+  return -1;
+}
+
+
+
+void AB_Banking__GetSettingsSnapshotPath(const AB_BANKING *ab, const char *suffix, GWEN_BUFFER *buf)
+{
+  assert(ab->dataDir);
+  GWEN_Buffer_AppendString(buf, ab->dataDir);
+  GWEN_Buffer_AppendString(buf, DIRSEP);
+  GWEN_Buffer_AppendString(buf, AB_BANKING_SETTINGS_DIR);
+  if (suffix)
+    GWEN_Buffer_AppendString(buf, suffix);
+}
+
+
+
+uint32_t AB_Banking__ReadSettingsGeneration(const AB_BANKING *ab)
+{
+  GWEN_BUFFER *buf;
+  FILE *f;
+  unsigned long generation=0;
+
+  buf=GWEN_Buffer_new(0, 256, 0, 1);
+  AB_Banking__GetSettingsSnapshotPath(ab, AB_BANKING_GENERATION_SUFFIX, buf);
+  f=fopen(GWEN_Buffer_GetStart(buf), "r");
+  if (f) {
+    if (fscanf(f, "%lu", &generation)!=1)
+      generation=0;
+    fclose(f);
+  }
+  GWEN_Buffer_free(buf);
+
+  return (uint32_t) generation;
+}
+
+
+
+int AB_Banking__WriteSettingsGeneration(const AB_BANKING *ab, uint32_t generation)
+{
+  GWEN_BUFFER *buf;
+  GWEN_BUFFER *tmpBuf;
+  FILE *f;
+  int rv=0;
+
+  buf=GWEN_Buffer_new(0, 256, 0, 1);
+  AB_Banking__GetSettingsSnapshotPath(ab, AB_BANKING_GENERATION_SUFFIX, buf);
+  tmpBuf=GWEN_Buffer_new(0, 256, 0, 1);
+  GWEN_Buffer_AppendArgs(tmpBuf, "%s.%d.tmp", GWEN_Buffer_GetStart(buf), (int) getpid());
+
+  f=fopen(GWEN_Buffer_GetStart(tmpBuf), "w");
+  if (f==NULL) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "fopen(%s): %s", GWEN_Buffer_GetStart(tmpBuf), strerror(errno));
+    GWEN_Buffer_free(tmpBuf);
+    GWEN_Buffer_free(buf);
+    return GWEN_ERROR_IO;
+  }
+  if (fprintf(f, "%lu\n", (unsigned long) generation)<0)
+    rv=GWEN_ERROR_IO;
+  if (fclose(f))
+    rv=GWEN_ERROR_IO;
+
+  if (rv==0) {
+#ifdef OS_WIN32
+    unlink(GWEN_Buffer_GetStart(buf));
+#endif
+    if (rename(GWEN_Buffer_GetStart(tmpBuf), GWEN_Buffer_GetStart(buf))) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "rename(%s): %s", GWEN_Buffer_GetStart(tmpBuf), strerror(errno));
+      rv=GWEN_ERROR_IO;
+    }
+  }
+  if (rv<0)
+    unlink(GWEN_Buffer_GetStart(tmpBuf));
+
+  GWEN_Buffer_free(tmpBuf);
+  GWEN_Buffer_free(buf);
+  return rv;
+}
+
+
+
+void AB_Banking__SettingsChanged(AB_BANKING *ab, const char *groupName)
+{
+  if (ab->dataDir && AB_Banking__GetSettingsSnapshotTable(groupName)>=0) {
+    uint32_t generation;
+    int rv;
+
+    /* mix in the process id so that concurrent writers never end up with the same generation */
+    generation=AB_Banking__ReadSettingsGeneration(ab)+1+(((uint32_t) getpid())<<16);
+    rv=AB_Banking__WriteSettingsGeneration(ab, generation);
+    if (rv<0) {
+      DBG_WARN(AQBANKING_LOGDOMAIN, "Could not update settings generation (%d), removing settings snapshot", rv);
+      AB_Banking__RemoveSettingsSnapshot(ab);
+    }
+
+    AB_Banking__ReleaseSettingsSnapshot(ab);
+    ab->settingsSnapshotDirty=1;
+  }
+}
+
+
+
+void AB_Banking__RemoveSettingsSnapshot(const AB_BANKING *ab)
+{
+  GWEN_BUFFER *buf;
+
+  buf=GWEN_Buffer_new(0, 256, 0, 1);
+  AB_Banking__GetSettingsSnapshotPath(ab, AB_BANKING_SNAPSHOT_SUFFIX, buf);
+  unlink(GWEN_Buffer_GetStart(buf));
+  GWEN_Buffer_free(buf);
+}
+
+
+
+void AB_Banking__ReleaseSettingsSnapshot(AB_BANKING *ab)
+{
+  if (ab->settingsSnapshot) {
+    AB_SettingsSnapshot_free(ab->settingsSnapshot);
+    ab->settingsSnapshot=NULL;
+  }
+}
+
+
+
+int AB_Banking__AddSettingsSnapshotTable(const AB_BANKING *ab,
+                                         AB_SETTINGS_SNAPSHOT_WRITER *sw,
+                                         AB_SETTINGS_SNAPSHOT_TABLE t,
+                                         const char *groupName)
+{
+  GWEN_DB_NODE *dbAll=NULL;
+  GWEN_DB_NODE *db;
+  int rv;
+
+  rv=AB_Banking__ReadConfigGroupsFromFiles(ab, groupName, "uniqueId", NULL, NULL, &dbAll);
+  if (rv==GWEN_ERROR_NOT_FOUND)
+    return 0;
+  else if (rv<0) {
+    /* also GWEN_ERROR_PARTIAL: an incomplete snapshot must not be used */
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    GWEN_DB_Group_free(dbAll);
+    return rv;
+  }
+
+  db=GWEN_DB_GetFirstGroup(dbAll);
+  while (db) {
+    uint32_t uid;
+
+    uid=(uint32_t) GWEN_DB_GetIntValue(db, "uniqueId", 0, 0);
+    rv=AB_SettingsSnapshotWriter_AddGroup(sw, t, uid, GWEN_DB_GroupName(db), GWEN_DB_GetCharValue(db, "backendName", 0, NULL),
+                                          db);
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      GWEN_DB_Group_free(dbAll);
+      return rv;
+    }
+
+    if (t==AB_SettingsSnapshotTable_AccountSpecs) {
+      AB_ACCOUNT_SPEC *as;
+      const char *s;
+
+      as=AB_AccountSpec_fromDb(db);
+      AB_SettingsSnapshotWriter_AddAccountSpecKey(sw, AB_SettingsSnapshotIndex_Iban, AB_AccountSpec_GetIban(as), uid);
+      s=AB_AccountSpec_GetAccountNumber(as);
+      if (s && *s) {
+        char keyBuf[128];
+
+        /* same key as used by the account spec cache, see banking_accspec.c */
+        if (AB_HashIndex_MakeKey(keyBuf, sizeof(keyBuf), AB_AccountSpec_GetBankCode(as), s, NULL)==0)
+          AB_SettingsSnapshotWriter_AddAccountSpecKey(sw, AB_SettingsSnapshotIndex_BankCodeAndAccountNumber, keyBuf, uid);
+      }
+      AB_AccountSpec_free(as);
+    }
+
+    db=GWEN_DB_GetNextGroup(db);
+  }
+  GWEN_DB_Group_free(dbAll);
+
+  return 0;
+}
+
+
+
+int AB_Banking__WriteSettingsSnapshot(const AB_BANKING *ab)
+{
+  AB_SETTINGS_SNAPSHOT_WRITER *sw;
+  GWEN_BUFFER *buf;
+  uint32_t generation;
+  int rv;
+
+  /* read generation first: changes made while reading the groups will invalidate the new snapshot */
+  generation=AB_Banking__ReadSettingsGeneration(ab);
+
+  buf=GWEN_Buffer_new(0, 256, 0, 1);
+  AB_Banking__GetSettingsSnapshotPath(ab, NULL, buf);
+  sw=AB_SettingsSnapshotWriter_new(GWEN_Buffer_GetStart(buf), generation);
+
+  rv=AB_Banking__AddSettingsSnapshotTable(ab, sw, AB_SettingsSnapshotTable_Users, AB_CFG_GROUP_USERS);
+  if (rv==0)
+    rv=AB_Banking__AddSettingsSnapshotTable(ab, sw, AB_SettingsSnapshotTable_Accounts, AB_CFG_GROUP_ACCOUNTS);
+  if (rv==0)
+    rv=AB_Banking__AddSettingsSnapshotTable(ab, sw, AB_SettingsSnapshotTable_AccountSpecs, AB_CFG_GROUP_ACCOUNTSPECS);
+  if (rv==0) {
+    GWEN_Buffer_AppendString(buf, AB_BANKING_SNAPSHOT_SUFFIX);
+    rv=AB_SettingsSnapshotWriter_WriteFile(sw, GWEN_Buffer_GetStart(buf));
+  }
+  AB_SettingsSnapshotWriter_free(sw);
+  GWEN_Buffer_free(buf);
+
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Could not write settings snapshot (%d)", rv);
+    return rv;
+  }
+
+  DBG_INFO(AQBANKING_LOGDOMAIN, "Settings snapshot written (generation %lu)", (unsigned long) generation);
+  return 0;
+}
+
+
+
+int AB_Banking__OpenSettingsSnapshot(const AB_BANKING *ab, uint32_t generation, AB_SETTINGS_SNAPSHOT **pSnapshot)
+{
+  AB_SETTINGS_SNAPSHOT *ss=NULL;
+  GWEN_BUFFER *buf;
+  const char *s;
+  int rv;
+
+  buf=GWEN_Buffer_new(0, 256, 0, 1);
+  AB_Banking__GetSettingsSnapshotPath(ab, AB_BANKING_SNAPSHOT_SUFFIX, buf);
+  rv=AB_SettingsSnapshot_Open(GWEN_Buffer_GetStart(buf), &ss);
+  GWEN_Buffer_free(buf);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  /* the snapshot must have been made from the current state of our own settings folder */
+  buf=GWEN_Buffer_new(0, 256, 0, 1);
+  AB_Banking__GetSettingsSnapshotPath(ab, NULL, buf);
+  s=AB_SettingsSnapshot_GetStamp(ss);
+  if (AB_SettingsSnapshot_GetGeneration(ss)!=generation || s==NULL || strcmp(s, GWEN_Buffer_GetStart(buf))!=0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Settings snapshot is outdated");
+    GWEN_Buffer_free(buf);
+    AB_SettingsSnapshot_free(ss);
+    return GWEN_ERROR_NOT_FOUND;
+  }
+  GWEN_Buffer_free(buf);
+
+  *pSnapshot=ss;
+  return 0;
+}
+
+
+
+const AB_SETTINGS_SNAPSHOT *AB_Banking__GetSettingsSnapshot(AB_BANKING *ab)
+{
+  AB_SETTINGS_SNAPSHOT *ss=NULL;
+  uint32_t generation;
+  int rv;
+
+  if (ab->settingsSnapshotDirty || !AB_Banking__UseSettingsSnapshot(ab))
+    return NULL;
+
+  generation=AB_Banking__ReadSettingsGeneration(ab);
+  if (ab->settingsSnapshot) {
+    if (AB_SettingsSnapshot_GetGeneration(ab->settingsSnapshot)==generation &&
+        AB_SettingsSnapshot_IsCurrent(ab->settingsSnapshot))
+      return ab->settingsSnapshot;
+    AB_Banking__ReleaseSettingsSnapshot(ab);
+  }
+
+  rv=AB_Banking__OpenSettingsSnapshot(ab, generation, &ss);
+  if (rv<0) {
+    /* missing or outdated, rebuild */
+    rv=AB_Banking__WriteSettingsSnapshot(ab);
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      return NULL;
+    }
+    rv=AB_Banking__OpenSettingsSnapshot(ab, generation, &ss);
+    if (rv<0) {
+      /* settings changed again while rebuilding */
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      return NULL;
+    }
+  }
+
+  ab->settingsSnapshot=ss;
+  return ss;
+}
+
+
+
+void AB_Banking__FinishSettingsSnapshot(AB_BANKING *ab)
+{
+  AB_Banking__ReleaseSettingsSnapshot(ab);
+  if (ab->settingsSnapshotDirty) {
+    if (AB_Banking__UseSettingsSnapshot(ab)) {
+      int rv;
+
+      rv=AB_Banking__WriteSettingsSnapshot(ab);
+      if (rv<0) {
+        DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      }
+    }
+    ab->settingsSnapshotDirty=0;
+  }
+}
+
+
+
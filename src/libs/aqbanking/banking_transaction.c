@@ -419,75 +419,124 @@ int AB_Banking_CheckTransactionAgainstLimits_Sequence(const AB_TRANSACTION *t, c
 
 
 
-static int _checkStringForSepaCharset(const char *s, int restricted)
+/* Character classes for SEPA names: bit 0 set for chars allowed in the restricted charset, bit 1 for chars
+ * allowed in the extended charset (which additionally allows "'", "&" and "*").
+ * All bytes >=0x80 are handled separately (umlauts in UTF-8).
+ */
+#define AB_SEPA_CHARCLASS_RESTRICTED 0x01
+#define AB_SEPA_CHARCLASS_EXTENDED   0x02
+
+static const unsigned char ab_sepaCharClass[256]= {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0x00 */
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0x10 */
+  3, 0, 0, 0, 3, 3, 2, 2, 3, 3, 2, 3, 3, 3, 3, 3, /* 0x20 */
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 0, 0, 0, 0, 3, /* 0x30 */
+  0, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, /* 0x40 */
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 0, 0, 0, 0, 0, /* 0x50 */
+  0, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, /* 0x60 */
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 0, 0, 0, 0, 0, /* 0x70 */
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0x80 */
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0x90 */
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0xa0 */
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0xb0 */
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0xc0 */
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0xd0 */
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0xe0 */
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 /* 0xf0 */
+};
+
+
+
+/* return pointer to the first char not in the given class (the terminating 0 is never in any class) */
+static const char *_skipSepaChars(const char *s, unsigned char mask)
 {
-  char ascii_chars[]="'&*$%:?,-(+.)/ "; /* last is a blank! */
-  const char *ascii;
+  const unsigned char *p;
 
-#define RESTRICTED_CHARS_OFFSET 3
+  p=(const unsigned char *) s;
 
-  assert(s);
+  /* check 8 chars per loop, the conditions are evaluated in order so we never read beyond the end of the string */
+  while ((ab_sepaCharClass[p[0]] & mask) &&
+         (ab_sepaCharClass[p[1]] & mask) &&
+         (ab_sepaCharClass[p[2]] & mask) &&
+         (ab_sepaCharClass[p[3]] & mask) &&
+         (ab_sepaCharClass[p[4]] & mask) &&
+         (ab_sepaCharClass[p[5]] & mask) &&
+         (ab_sepaCharClass[p[6]] & mask) &&
+         (ab_sepaCharClass[p[7]] & mask))
+    p+=8;
 
-  ascii=ascii_chars;
-  if (restricted)
-    ascii+=RESTRICTED_CHARS_OFFSET;
+  while (ab_sepaCharClass[*p] & mask)
+    p++;
 
-  while (*s) {
-    unsigned char c=*s++;
-
-    if (!((c>='A' && c<='Z') ||
-          (c>='a' && c<='z') ||
-          (c>='0' && c<='9') ||
-          strchr(ascii, c)!=NULL)) {
-      char errchr[7];
-      int i = 0;
-
-      if (c == 0xC3 && !restricted) {
-        c = *s++;
-        switch (c) {
-        case 0x84:  /* AE */
-        case 0xA4:  /* ae */
-        case 0x96:  /* OE */
-        case 0xB6:  /* oe */
-        case 0x9C:  /* UE */
-        case 0xBC:  /* ue */
-        case 0x9F:  /* ss */
-          if ((*s & 0xC0) != 0x80)
-            break;
-        /* these are no umlauts, after all, so fall through */
-
-        default:
-          errchr[i++]=0xC3;
-          if ((c & 0xC0) == 0x80)
-            errchr[i++]=c;
-          else
-            /* UTF-8 sequence ended prematurely */
-            s--;
+  return (const char *) p;
+}
+
+
+
+static int _checkStringForSepaCharset(const char *s, int restricted)
+{
+  unsigned char mask;
+
+  assert(s);
+
+  mask=restricted?AB_SEPA_CHARCLASS_RESTRICTED:AB_SEPA_CHARCLASS_EXTENDED;
+
+  for (;;) {
+    unsigned char c;
+    char errchr[7];
+    int i = 0;
+
+    /* fast path for runs of valid chars */
+    s=_skipSepaChars(s, mask);
+    if (*s==0)
+      break;
+
+    c=*s++;
+    if (c == 0xC3 && !restricted) {
+      c = *s++;
+      switch (c) {
+      case 0x84:  /* AE */
+      case 0xA4:  /* ae */
+      case 0x96:  /* OE */
+      case 0xB6:  /* oe */
+      case 0x9C:  /* UE */
+      case 0xBC:  /* ue */
+      case 0x9F:  /* ss */
+        if ((*s & 0xC0) != 0x80)
           break;
-        }
+      /* these are no umlauts, after all, so fall through */
+
+      default:
+        errchr[i++]=0xC3;
+        if ((c & 0xC0) == 0x80)
+          errchr[i++]=c;
+        else
+          /* UTF-8 sequence ended prematurely */
+          s--;
+        break;
       }
-      else
-        errchr[i++] = c;
-
-      if (i) {
-        while ((*s & 0xC0) == 0x80)
-          if (i<6)
-            errchr[i++]=*s++;
-          else {
-            i++;
-            s++;
-          }
+    }
+    else
+      errchr[i++] = c;
 
-        if (i<7 && (i>1 || !(c & 0x80))) {
-          errchr[i] = '\0';
-          DBG_ERROR(AQBANKING_LOGDOMAIN, "Invalid character in string: '%s'",
-                    errchr);
-        }
+    if (i) {
+      while ((*s & 0xC0) == 0x80)
+        if (i<6)
+          errchr[i++]=*s++;
         else {
-          DBG_ERROR(AQBANKING_LOGDOMAIN, "String not properly UTF-8 encoded");
+          i++;
+          s++;
         }
-        return GWEN_ERROR_BAD_DATA;
+
+      if (i<7 && (i>1 || !(c & 0x80))) {
+        errchr[i] = '\0';
+        DBG_ERROR(AQBANKING_LOGDOMAIN, "Invalid character in string: '%s'",
+                  errchr);
+      }
+      else {
+        DBG_ERROR(AQBANKING_LOGDOMAIN, "String not properly UTF-8 encoded");
       }
+      return GWEN_ERROR_BAD_DATA;
     }
   }
 
@@ -629,6 +678,113 @@ int AB_Banking_CheckTransactionForSepaConformity(const AB_TRANSACTION *t, int re
 
 
 
+/* Replace german umlauts (UTF-8) by their transliteration ("ae", "oe", "ue", "ss").
+ * Returns 1 if the string has been changed (result in buf), 0 otherwise (buf is untouched).
+ */
+static int _transliterateUmlauts(const char *s, GWEN_BUFFER *buf)
+{
+  const char *p;
+
+  if (!(s && strchr(s, 0xC3)))
+    return 0;
+
+  while ((p=strchr(s, 0xC3))) {
+    const char *replacement;
+
+    if (p>s)
+      GWEN_Buffer_AppendBytes(buf, s, p-s);
+    switch ((unsigned char) p[1]) {
+    case 0x84:
+      replacement="Ae";
+      break;
+    case 0xA4:
+      replacement="ae";
+      break;
+    case 0x96:
+      replacement="Oe";
+      break;
+    case 0xB6:
+      replacement="oe";
+      break;
+    case 0x9C:
+      replacement="Ue";
+      break;
+    case 0xBC:
+      replacement="ue";
+      break;
+    case 0x9F:
+      replacement="ss";
+      break;
+    default:
+      replacement=NULL;
+      break;
+    }
+    if (replacement) {
+      GWEN_Buffer_AppendString(buf, replacement);
+      s=p+2;
+    }
+    else {
+      /* not an umlaut, keep as is (the check will complain later if needed) */
+      GWEN_Buffer_AppendByte(buf, *p);
+      s=p+1;
+    }
+  }
+  GWEN_Buffer_AppendString(buf, s);
+
+  return 1;
+}
+
+
+
+static void _transliterateTransaction(AB_TRANSACTION *t, GWEN_BUFFER *tbuf)
+{
+  if (_transliterateUmlauts(AB_Transaction_GetLocalName(t), tbuf))
+    AB_Transaction_SetLocalName(t, GWEN_Buffer_GetStart(tbuf));
+  GWEN_Buffer_Reset(tbuf);
+
+  if (_transliterateUmlauts(AB_Transaction_GetRemoteName(t), tbuf))
+    AB_Transaction_SetRemoteName(t, GWEN_Buffer_GetStart(tbuf));
+  GWEN_Buffer_Reset(tbuf);
+
+  if (_transliterateUmlauts(AB_Transaction_GetPurpose(t), tbuf))
+    AB_Transaction_SetPurpose(t, GWEN_Buffer_GetStart(tbuf));
+  GWEN_Buffer_Reset(tbuf);
+}
+
+
+
+int AB_Banking_CheckTransactionListForSepaConformity(AB_TRANSACTION_LIST *tl, int restricted, uint32_t flags)
+{
+  AB_TRANSACTION *t;
+  GWEN_BUFFER *tbuf=NULL;
+  int errors=0;
+
+  assert(tl);
+
+  if (flags & AB_BANKING_SEPACHECK_FLAGS_TRANSLITERATE)
+    tbuf=GWEN_Buffer_new(0, 256, 0, 1);
+
+  t=AB_Transaction_List_First(tl);
+  while (t) {
+    int rv;
+
+    if (tbuf)
+      _transliterateTransaction(t, tbuf);
+
+    rv=AB_Banking_CheckTransactionForSepaConformity(t, restricted);
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "Transaction %u does not conform to SEPA (%d)", AB_Transaction_GetUniqueId(t), rv);
+      errors++;
+    }
+    t=AB_Transaction_List_Next(t);
+  }
+  GWEN_Buffer_free(tbuf);
+
+  return errors;
+}
+
+
+
 void AB_Banking_FillTransactionFromAccountSpec(AB_TRANSACTION *t, const AB_ACCOUNT_SPEC *as)
 {
   const char *s;
@@ -92,6 +92,21 @@ AQBANKING_API int AB_Banking_CheckTransactionAgainstLimits_Sequence(const AB_TRA
 AQBANKING_API int AB_Banking_CheckTransactionForSepaConformity(const AB_TRANSACTION *t, int restricted);
 
 
+/** Replace german umlauts in names and purpose by "ae", "oe", "ue" and "ss" before checking */
+#define AB_BANKING_SEPACHECK_FLAGS_TRANSLITERATE 0x00000001
+
+/**
+ * Check all transactions of a list for SEPA conformity (see @ref AB_Banking_CheckTransactionForSepaConformity).
+ * With @ref AB_BANKING_SEPACHECK_FLAGS_TRANSLITERATE umlauts in local name, remote name and purpose are
+ * transliterated in place first, so transactions become conformant to the restricted charset where possible.
+ * @return number of transactions which do not conform
+ * @param tl list of transactions to check
+ * @param restricted check against the restricted charset if !=0
+ * @param flags see AB_BANKING_SEPACHECK_FLAGS_TRANSLITERATE
+ */
+AQBANKING_API int AB_Banking_CheckTransactionListForSepaConformity(AB_TRANSACTION_LIST *tl, int restricted, uint32_t flags);
+
+
 /**
  * Fill local account info from account spec.
  */
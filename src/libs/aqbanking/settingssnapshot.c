@@ -0,0 +1,786 @@
+/***************************************************************************
+ begin       : Mon Oct 19 2026
+ copyright   : (C) 2026 by Martin Preuss
+ email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+
+#include "settingssnapshot_p.h"
+
+#include <aqbanking/error.h>
+
+#include <gwenhywfar/debug.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#ifdef HAVE_SYS_MMAN_H
+# include <sys/mman.h>
+#endif
+
+#ifndef O_BINARY
+# define O_BINARY 0
+#endif
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * forward declarations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+static int _readFileData(AB_SETTINGS_SNAPSHOT *ss, int fd);
+static void _releaseFileData(AB_SETTINGS_SNAPSHOT *ss);
+static int _checkHeader(const AB_SETTINGS_SNAPSHOT *ss);
+static const char *_getString(const AB_SETTINGS_SNAPSHOT *ss, uint32_t offset);
+static const AB_SETTINGS_SNAPSHOT_ENTRY *_getEntries(const AB_SETTINGS_SNAPSHOT *ss, AB_SETTINGS_SNAPSHOT_TABLE t);
+static const AB_SETTINGS_SNAPSHOT_ENTRY *_findEntry(const AB_SETTINGS_SNAPSHOT *ss, AB_SETTINGS_SNAPSHOT_TABLE t,
+                                                    uint32_t uniqueId);
+static int _readEntry(const AB_SETTINGS_SNAPSHOT *ss, const AB_SETTINGS_SNAPSHOT_ENTRY *e, GWEN_DB_NODE **pDb);
+
+static int _compareWriterEntries(const void *a, const void *b);
+static int _compareWriterKeys(const void *a, const void *b);
+static uint32_t _addString(GWEN_BUFFER *buf, uint32_t stringAreaOffset, const char *s);
+static int _writeData(FILE *f, const void *p, size_t len);
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * implementations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+int AB_SettingsSnapshot_Open(const char *fileName, AB_SETTINGS_SNAPSHOT **pSnapshot)
+{
+  AB_SETTINGS_SNAPSHOT *ss;
+  struct stat st;
+  int fd;
+  int rv;
+
+  assert(fileName);
+
+  fd=open(fileName, O_RDONLY | O_BINARY);
+  if (fd==-1) {
+    if (errno==ENOENT) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "No settings snapshot \"%s\"", fileName);
+      return GWEN_ERROR_NOT_FOUND;
+    }
+    DBG_INFO(AQBANKING_LOGDOMAIN, "open(%s): %s", fileName, strerror(errno));
+    return GWEN_ERROR_IO;
+  }
+
+  if (fstat(fd, &st)) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "fstat(%s): %s", fileName, strerror(errno));
+    close(fd);
+    return GWEN_ERROR_IO;
+  }
+  if (st.st_size<(off_t) sizeof(AB_SETTINGS_SNAPSHOT_HEADER) || st.st_size>0x7fffffff) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Bad size of settings snapshot \"%s\"", fileName);
+    close(fd);
+    return GWEN_ERROR_BAD_DATA;
+  }
+
+  GWEN_NEW_OBJECT(AB_SETTINGS_SNAPSHOT, ss);
+  ss->fileName=strdup(fileName);
+  ss->size=(uint32_t) st.st_size;
+  ss->fileDevice=(long long) st.st_dev;
+  ss->fileInode=(long long) st.st_ino;
+  ss->fileMtime=(long long) st.st_mtime;
+  ss->fileSize=(long long) st.st_size;
+
+  rv=_readFileData(ss, fd);
+  close(fd);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    AB_SettingsSnapshot_free(ss);
+    return rv;
+  }
+
+  ss->header=(const AB_SETTINGS_SNAPSHOT_HEADER *) ss->data;
+  rv=_checkHeader(ss);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Invalid settings snapshot \"%s\" (%d)", fileName, rv);
+    AB_SettingsSnapshot_free(ss);
+    return rv;
+  }
+
+  *pSnapshot=ss;
+  return 0;
+}
+
+
+
+void AB_SettingsSnapshot_free(AB_SETTINGS_SNAPSHOT *ss)
+{
+  if (ss) {
+    _releaseFileData(ss);
+    free(ss->fileName);
+    GWEN_FREE_OBJECT(ss);
+  }
+}
+
+
+
+int AB_SettingsSnapshot_IsCurrent(const AB_SETTINGS_SNAPSHOT *ss)
+{
+  struct stat st;
+
+  assert(ss);
+  if (stat(ss->fileName, &st))
+    return 0;
+
+  return ((long long) st.st_dev==ss->fileDevice &&
+          (long long) st.st_ino==ss->fileInode &&
+          (long long) st.st_mtime==ss->fileMtime &&
+          (long long) st.st_size==ss->fileSize)?1:0;
+}
+
+
+
+const char *AB_SettingsSnapshot_GetStamp(const AB_SETTINGS_SNAPSHOT *ss)
+{
+  assert(ss);
+  return _getString(ss, ss->header->stampOffset);
+}
+
+
+
+uint32_t AB_SettingsSnapshot_GetGeneration(const AB_SETTINGS_SNAPSHOT *ss)
+{
+  assert(ss);
+  return ss->header->generation;
+}
+
+
+
+int AB_SettingsSnapshot_GetGroupCount(const AB_SETTINGS_SNAPSHOT *ss, AB_SETTINGS_SNAPSHOT_TABLE t)
+{
+  assert(ss);
+  assert(t<AB_SettingsSnapshotTable_Count);
+  return (int) ss->header->tableCount[t];
+}
+
+
+
+int AB_SettingsSnapshot_ReadGroup(const AB_SETTINGS_SNAPSHOT *ss,
+                                  AB_SETTINGS_SNAPSHOT_TABLE t,
+                                  uint32_t uniqueId,
+                                  GWEN_DB_NODE **pDb)
+{
+  const AB_SETTINGS_SNAPSHOT_ENTRY *e;
+
+  assert(ss);
+  assert(t<AB_SettingsSnapshotTable_Count);
+
+  e=_findEntry(ss, t, uniqueId);
+  if (e==NULL) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Group %lu not in settings snapshot", (unsigned long) uniqueId);
+    return GWEN_ERROR_NOT_FOUND;
+  }
+
+  return _readEntry(ss, e, pDb);
+}
+
+
+
+int AB_SettingsSnapshot_ReadGroups(const AB_SETTINGS_SNAPSHOT *ss,
+                                   AB_SETTINGS_SNAPSHOT_TABLE t,
+                                   const char *backendName,
+                                   GWEN_DB_NODE **pDb)
+{
+  const AB_SETTINGS_SNAPSHOT_ENTRY *entries;
+  GWEN_DB_NODE *dbAll;
+  uint32_t i;
+
+  assert(ss);
+  assert(t<AB_SettingsSnapshotTable_Count);
+
+  entries=_getEntries(ss, t);
+  dbAll=GWEN_DB_Group_new("all");
+  for (i=0; i<ss->header->tableCount[t]; i++) {
+    const AB_SETTINGS_SNAPSHOT_ENTRY *e;
+    int doAdd=1;
+
+    e=&entries[i];
+    if (backendName) {
+      const char *s;
+
+      /* same matching as in AB_Banking_ReadConfigGroups() */
+      s=_getString(ss, e->backendNameOffset);
+      if (s && *s)
+        doAdd=(strcasecmp(s, backendName)==0)?1:0;
+      else
+        doAdd=(*backendName)?0:1;
+    }
+
+    if (doAdd) {
+      GWEN_DB_NODE *db=NULL;
+      int rv;
+
+      rv=_readEntry(ss, e, &db);
+      if (rv<0) {
+        DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+        GWEN_DB_Group_free(dbAll);
+        return rv;
+      }
+      GWEN_DB_AddGroup(dbAll, db);
+    }
+  }
+
+  if (GWEN_DB_Groups_Count(dbAll)==0) {
+    GWEN_DB_Group_free(dbAll);
+    return GWEN_ERROR_NOT_FOUND;
+  }
+
+  *pDb=dbAll;
+  return 0;
+}
+
+
+
+int AB_SettingsSnapshot_FindAccountSpec(const AB_SETTINGS_SNAPSHOT *ss,
+                                        AB_SETTINGS_SNAPSHOT_INDEX idx,
+                                        const char *key,
+                                        uint32_t *pUniqueId)
+{
+  const AB_SETTINGS_SNAPSHOT_KEY *keys;
+  uint32_t lo, hi;
+
+  assert(ss);
+  assert(idx<AB_SettingsSnapshotIndex_Count);
+
+  if (!(key && *key))
+    return GWEN_ERROR_NOT_FOUND;
+
+  keys=(const AB_SETTINGS_SNAPSHOT_KEY *)(ss->data+ss->header->indexOffset[idx]);
+
+  /* find the first entry not less than the key, so the first of multiple equal keys is found */
+  lo=0;
+  hi=ss->header->indexCount[idx];
+  while (lo<hi) {
+    uint32_t mid;
+    const char *s;
+
+    mid=lo+(hi-lo)/2;
+    s=_getString(ss, keys[mid].keyOffset);
+    if (strcasecmp(s?s:"", key)<0)
+      lo=mid+1;
+    else
+      hi=mid;
+  }
+
+  if (lo<ss->header->indexCount[idx]) {
+    const char *s;
+
+    s=_getString(ss, keys[lo].keyOffset);
+    if (s && strcasecmp(s, key)==0) {
+      *pUniqueId=keys[lo].uniqueId;
+      return 0;
+    }
+  }
+
+  return GWEN_ERROR_NOT_FOUND;
+}
+
+
+
+int _readFileData(AB_SETTINGS_SNAPSHOT *ss, int fd)
+{
+#ifdef HAVE_SYS_MMAN_H
+  void *p;
+
+  p=mmap(NULL, ss->size, PROT_READ, MAP_SHARED, fd, 0);
+  if (p==MAP_FAILED) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "mmap(%s): %s", ss->fileName, strerror(errno));
+    return GWEN_ERROR_IO;
+  }
+  ss->data=(const uint8_t *) p;
+  ss->mapped=1;
+  return 0;
+#else
+  uint8_t *p;
+  uint32_t done=0;
+
+  p=(uint8_t *) malloc(ss->size);
+  assert(p);
+  while (done<ss->size) {
+    ssize_t len;
+
+    len=read(fd, p+done, ss->size-done);
+    if (len<=0) {
+      if (len<0 && errno==EINTR)
+        continue;
+      DBG_INFO(AQBANKING_LOGDOMAIN, "read(%s): %s", ss->fileName, (len<0)?strerror(errno):"unexpected end of file");
+      free(p);
+      return GWEN_ERROR_IO;
+    }
+    done+=(uint32_t) len;
+  }
+  ss->data=p;
+  ss->mapped=0;
+  return 0;
+#endif
+}
+
+
+
+void _releaseFileData(AB_SETTINGS_SNAPSHOT *ss)
+{
+  if (ss->data) {
+#ifdef HAVE_SYS_MMAN_H
+    if (ss->mapped)
+      munmap((void *) ss->data, ss->size);
+    else
+      free((void *) ss->data);
+#else
+    free((void *) ss->data);
+#endif
+    ss->data=NULL;
+    ss->header=NULL;
+  }
+}
+
+
+
+int _checkHeader(const AB_SETTINGS_SNAPSHOT *ss)
+{
+  const AB_SETTINGS_SNAPSHOT_HEADER *h;
+  int i;
+
+  h=ss->header;
+  if (memcmp(h->magic, AB_SETTINGS_SNAPSHOT_MAGIC, sizeof(h->magic))!=0 ||
+      h->byteOrder!=AB_SETTINGS_SNAPSHOT_BYTEORDER) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Not a settings snapshot (or from a system with different byte order)");
+    return GWEN_ERROR_BAD_DATA;
+  }
+  if (h->version!=AB_SETTINGS_SNAPSHOT_VERSION) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Unsupported settings snapshot version %lu", (unsigned long) h->version);
+    return GWEN_ERROR_BAD_DATA;
+  }
+
+  /* the whole file must be there and end with a NUL byte, so every string inside is terminated */
+  if (h->fileSize!=ss->size || ss->data[ss->size-1]!=0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Truncated settings snapshot");
+    return GWEN_ERROR_BAD_DATA;
+  }
+
+  for (i=0; i<AB_SettingsSnapshotTable_Count; i++) {
+    if (h->tableOffset[i]%4 ||
+        h->tableCount[i]>ss->size/sizeof(AB_SETTINGS_SNAPSHOT_ENTRY) ||
+        h->tableOffset[i]>ss->size-h->tableCount[i]*sizeof(AB_SETTINGS_SNAPSHOT_ENTRY)) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "Bad table %d in settings snapshot", i);
+      return GWEN_ERROR_BAD_DATA;
+    }
+  }
+
+  for (i=0; i<AB_SettingsSnapshotIndex_Count; i++) {
+    if (h->indexOffset[i]%4 ||
+        h->indexCount[i]>ss->size/sizeof(AB_SETTINGS_SNAPSHOT_KEY) ||
+        h->indexOffset[i]>ss->size-h->indexCount[i]*sizeof(AB_SETTINGS_SNAPSHOT_KEY)) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "Bad index %d in settings snapshot", i);
+      return GWEN_ERROR_BAD_DATA;
+    }
+  }
+
+  return 0;
+}
+
+
+
+const char *_getString(const AB_SETTINGS_SNAPSHOT *ss, uint32_t offset)
+{
+  if (offset==0 || offset>=ss->size)
+    return NULL;
+  return (const char *)(ss->data+offset);
+}
+
+
+
+const AB_SETTINGS_SNAPSHOT_ENTRY *_getEntries(const AB_SETTINGS_SNAPSHOT *ss, AB_SETTINGS_SNAPSHOT_TABLE t)
+{
+  return (const AB_SETTINGS_SNAPSHOT_ENTRY *)(ss->data+ss->header->tableOffset[t]);
+}
+
+
+
+const AB_SETTINGS_SNAPSHOT_ENTRY *_findEntry(const AB_SETTINGS_SNAPSHOT *ss, AB_SETTINGS_SNAPSHOT_TABLE t,
+                                             uint32_t uniqueId)
+{
+  const AB_SETTINGS_SNAPSHOT_ENTRY *entries;
+  uint32_t lo, hi;
+
+  entries=_getEntries(ss, t);
+  lo=0;
+  hi=ss->header->tableCount[t];
+  while (lo<hi) {
+    uint32_t mid;
+
+    mid=lo+(hi-lo)/2;
+    if (entries[mid].uniqueId<uniqueId)
+      lo=mid+1;
+    else
+      hi=mid;
+  }
+
+  if (lo<ss->header->tableCount[t] && entries[lo].uniqueId==uniqueId)
+    return &entries[lo];
+  return NULL;
+}
+
+
+
+int _readEntry(const AB_SETTINGS_SNAPSHOT *ss, const AB_SETTINGS_SNAPSHOT_ENTRY *e, GWEN_DB_NODE **pDb)
+{
+  GWEN_DB_NODE *db;
+  const char *name;
+  int rv;
+
+  if (e->dataOffset==0 || e->dataOffset>=ss->size || e->dataLength>ss->size-e->dataOffset) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Bad data for group %lu in settings snapshot", (unsigned long) e->uniqueId);
+    return GWEN_ERROR_BAD_DATA;
+  }
+
+  name=_getString(ss, e->nameOffset);
+  db=GWEN_DB_Group_new((name && *name)?name:"config");
+  if (e->dataLength) {
+    rv=GWEN_DB_ReadFromString(db, (const char *)(ss->data+e->dataOffset), e->dataLength,
+                              GWEN_DB_FLAGS_DEFAULT | GWEN_PATH_FLAGS_CREATE_GROUP);
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "Bad data for group %lu in settings snapshot (%d)", (unsigned long) e->uniqueId, rv);
+      GWEN_DB_Group_free(db);
+      return rv;
+    }
+  }
+
+  *pDb=db;
+  return 0;
+}
+
+
+
+AB_SETTINGS_SNAPSHOT_WRITER *AB_SettingsSnapshotWriter_new(const char *stamp, uint32_t generation)
+{
+  AB_SETTINGS_SNAPSHOT_WRITER *sw;
+
+  GWEN_NEW_OBJECT(AB_SETTINGS_SNAPSHOT_WRITER, sw);
+  sw->stamp=strdup(stamp?stamp:"");
+  sw->generation=generation;
+  return sw;
+}
+
+
+
+void AB_SettingsSnapshotWriter_free(AB_SETTINGS_SNAPSHOT_WRITER *sw)
+{
+  if (sw) {
+    int i;
+
+    for (i=0; i<AB_SettingsSnapshotTable_Count; i++) {
+      uint32_t j;
+
+      for (j=0; j<sw->entryCount[i]; j++) {
+        free(sw->entries[i][j].name);
+        free(sw->entries[i][j].backendName);
+        GWEN_Buffer_free(sw->entries[i][j].dataBuffer);
+      }
+      free(sw->entries[i]);
+    }
+
+    for (i=0; i<AB_SettingsSnapshotIndex_Count; i++) {
+      uint32_t j;
+
+      for (j=0; j<sw->keyCount[i]; j++)
+        free(sw->keys[i][j].key);
+      free(sw->keys[i]);
+    }
+
+    free(sw->stamp);
+    GWEN_FREE_OBJECT(sw);
+  }
+}
+
+
+
+int AB_SettingsSnapshotWriter_AddGroup(AB_SETTINGS_SNAPSHOT_WRITER *sw,
+                                       AB_SETTINGS_SNAPSHOT_TABLE t,
+                                       uint32_t uniqueId,
+                                       const char *name,
+                                       const char *backendName,
+                                       GWEN_DB_NODE *db)
+{
+  AB_SETTINGS_SNAPSHOT_WRITER_ENTRY *e;
+  GWEN_BUFFER *buf;
+  int rv;
+
+  assert(sw);
+  assert(t<AB_SettingsSnapshotTable_Count);
+  assert(db);
+
+  if (uniqueId==0)
+    return 0;
+
+  buf=GWEN_Buffer_new(0, 1024, 0, 1);
+  rv=GWEN_DB_WriteToBuffer(db, buf, GWEN_DB_FLAGS_DEFAULT);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    GWEN_Buffer_free(buf);
+    return rv;
+  }
+
+  if (sw->entryCount[t]>=sw->entrySpace[t]) {
+    sw->entrySpace[t]=sw->entrySpace[t]?(sw->entrySpace[t]*2):64;
+    sw->entries[t]=(AB_SETTINGS_SNAPSHOT_WRITER_ENTRY *) realloc(sw->entries[t],
+                                                                 sw->entrySpace[t]*sizeof(AB_SETTINGS_SNAPSHOT_WRITER_ENTRY));
+    assert(sw->entries[t]);
+  }
+
+  e=&(sw->entries[t][sw->entryCount[t]++]);
+  e->uniqueId=uniqueId;
+  e->name=strdup(name?name:"");
+  e->backendName=(backendName && *backendName)?strdup(backendName):NULL;
+  e->dataBuffer=buf;
+  return 0;
+}
+
+
+
+void AB_SettingsSnapshotWriter_AddAccountSpecKey(AB_SETTINGS_SNAPSHOT_WRITER *sw,
+                                                 AB_SETTINGS_SNAPSHOT_INDEX idx,
+                                                 const char *key,
+                                                 uint32_t uniqueId)
+{
+  AB_SETTINGS_SNAPSHOT_WRITER_KEY *k;
+
+  assert(sw);
+  assert(idx<AB_SettingsSnapshotIndex_Count);
+
+  if (!(key && *key) || uniqueId==0)
+    return;
+
+  if (sw->keyCount[idx]>=sw->keySpace[idx]) {
+    sw->keySpace[idx]=sw->keySpace[idx]?(sw->keySpace[idx]*2):64;
+    sw->keys[idx]=(AB_SETTINGS_SNAPSHOT_WRITER_KEY *) realloc(sw->keys[idx],
+                                                              sw->keySpace[idx]*sizeof(AB_SETTINGS_SNAPSHOT_WRITER_KEY));
+    assert(sw->keys[idx]);
+  }
+
+  k=&(sw->keys[idx][sw->keyCount[idx]++]);
+  k->key=strdup(key);
+  k->uniqueId=uniqueId;
+}
+
+
+
+int AB_SettingsSnapshotWriter_WriteFile(AB_SETTINGS_SNAPSHOT_WRITER *sw, const char *fileName)
+{
+  AB_SETTINGS_SNAPSHOT_HEADER header;
+  GWEN_BUFFER *stringBuf;
+  GWEN_BUFFER *tmpNameBuf;
+  uint32_t offset;
+  uint32_t stringAreaOffset;
+  FILE *f;
+  int rv=0;
+  int i;
+
+  assert(sw);
+  assert(fileName);
+
+  /* sort tables by unique id and indexes by key (keeping the order of the tables for equal keys) */
+  for (i=0; i<AB_SettingsSnapshotTable_Count; i++) {
+    if (sw->entryCount[i])
+      qsort(sw->entries[i], sw->entryCount[i], sizeof(AB_SETTINGS_SNAPSHOT_WRITER_ENTRY), _compareWriterEntries);
+  }
+  for (i=0; i<AB_SettingsSnapshotIndex_Count; i++) {
+    if (sw->keyCount[i])
+      qsort(sw->keys[i], sw->keyCount[i], sizeof(AB_SETTINGS_SNAPSHOT_WRITER_KEY), _compareWriterKeys);
+  }
+
+  /* layout */
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, AB_SETTINGS_SNAPSHOT_MAGIC, sizeof(header.magic));
+  header.byteOrder=AB_SETTINGS_SNAPSHOT_BYTEORDER;
+  header.version=AB_SETTINGS_SNAPSHOT_VERSION;
+  header.generation=sw->generation;
+
+  offset=sizeof(AB_SETTINGS_SNAPSHOT_HEADER);
+  for (i=0; i<AB_SettingsSnapshotTable_Count; i++) {
+    header.tableOffset[i]=offset;
+    header.tableCount[i]=sw->entryCount[i];
+    offset+=sw->entryCount[i]*sizeof(AB_SETTINGS_SNAPSHOT_ENTRY);
+  }
+  for (i=0; i<AB_SettingsSnapshotIndex_Count; i++) {
+    header.indexOffset[i]=offset;
+    header.indexCount[i]=sw->keyCount[i];
+    offset+=sw->keyCount[i]*sizeof(AB_SETTINGS_SNAPSHOT_KEY);
+  }
+  stringAreaOffset=offset;
+
+  /* the string area starts with a NUL byte so that no string starts at offset 0 of the area */
+  stringBuf=GWEN_Buffer_new(0, 4096, 0, 1);
+  GWEN_Buffer_AppendByte(stringBuf, 0);
+  header.stampOffset=_addString(stringBuf, stringAreaOffset, sw->stamp);
+
+  tmpNameBuf=GWEN_Buffer_new(0, 256, 0, 1);
+  GWEN_Buffer_AppendArgs(tmpNameBuf, "%s.%d.tmp", fileName, (int) getpid());
+  f=fopen(GWEN_Buffer_GetStart(tmpNameBuf), "wb");
+  if (f==NULL) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "fopen(%s): %s", GWEN_Buffer_GetStart(tmpNameBuf), strerror(errno));
+    GWEN_Buffer_free(tmpNameBuf);
+    GWEN_Buffer_free(stringBuf);
+    return GWEN_ERROR_IO;
+  }
+
+  /* write tables, the strings are collected on the way */
+  fseek(f, sizeof(AB_SETTINGS_SNAPSHOT_HEADER), SEEK_SET);
+  for (i=0; i<AB_SettingsSnapshotTable_Count && rv==0; i++) {
+    uint32_t j;
+
+    for (j=0; j<sw->entryCount[i] && rv==0; j++) {
+      const AB_SETTINGS_SNAPSHOT_WRITER_ENTRY *we;
+      AB_SETTINGS_SNAPSHOT_ENTRY e;
+
+      we=&(sw->entries[i][j]);
+      e.uniqueId=we->uniqueId;
+      e.nameOffset=_addString(stringBuf, stringAreaOffset, we->name);
+      e.backendNameOffset=_addString(stringBuf, stringAreaOffset, we->backendName);
+      e.dataLength=GWEN_Buffer_GetUsedBytes(we->dataBuffer);
+      e.dataOffset=_addString(stringBuf, stringAreaOffset, GWEN_Buffer_GetStart(we->dataBuffer));
+      rv=_writeData(f, &e, sizeof(e));
+    }
+  }
+
+  for (i=0; i<AB_SettingsSnapshotIndex_Count && rv==0; i++) {
+    uint32_t j;
+
+    for (j=0; j<sw->keyCount[i] && rv==0; j++) {
+      AB_SETTINGS_SNAPSHOT_KEY k;
+
+      k.keyOffset=_addString(stringBuf, stringAreaOffset, sw->keys[i][j].key);
+      k.uniqueId=sw->keys[i][j].uniqueId;
+      rv=_writeData(f, &k, sizeof(k));
+    }
+  }
+
+  if (rv==0) {
+    /* terminating NUL byte (checked when reading) */
+    GWEN_Buffer_AppendByte(stringBuf, 0);
+    if ((uint64_t) stringAreaOffset+GWEN_Buffer_GetUsedBytes(stringBuf)>0x7fffffff) {
+      DBG_ERROR(AQBANKING_LOGDOMAIN, "Settings snapshot too large");
+      rv=GWEN_ERROR_BUFFER_OVERFLOW;
+    }
+  }
+
+  if (rv==0)
+    rv=_writeData(f, GWEN_Buffer_GetStart(stringBuf), GWEN_Buffer_GetUsedBytes(stringBuf));
+
+  if (rv==0) {
+    header.fileSize=stringAreaOffset+GWEN_Buffer_GetUsedBytes(stringBuf);
+    fseek(f, 0, SEEK_SET);
+    rv=_writeData(f, &header, sizeof(header));
+  }
+  GWEN_Buffer_free(stringBuf);
+
+  if (fclose(f)) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "fclose(%s): %s", GWEN_Buffer_GetStart(tmpNameBuf), strerror(errno));
+    if (rv==0)
+      rv=GWEN_ERROR_IO;
+  }
+
+  if (rv==0) {
+#ifdef OS_WIN32
+    /* rename() doesn't replace existing files on windows */
+    unlink(fileName);
+#endif
+    if (rename(GWEN_Buffer_GetStart(tmpNameBuf), fileName)) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "rename(%s): %s", GWEN_Buffer_GetStart(tmpNameBuf), strerror(errno));
+      rv=GWEN_ERROR_IO;
+    }
+  }
+
+  if (rv<0)
+    unlink(GWEN_Buffer_GetStart(tmpNameBuf));
+  GWEN_Buffer_free(tmpNameBuf);
+
+  return rv;
+}
+
+
+
+int _compareWriterEntries(const void *a, const void *b)
+{
+  const AB_SETTINGS_SNAPSHOT_WRITER_ENTRY *ea=(const AB_SETTINGS_SNAPSHOT_WRITER_ENTRY *) a;
+  const AB_SETTINGS_SNAPSHOT_WRITER_ENTRY *eb=(const AB_SETTINGS_SNAPSHOT_WRITER_ENTRY *) b;
+
+  if (ea->uniqueId<eb->uniqueId)
+    return -1;
+  if (ea->uniqueId>eb->uniqueId)
+    return 1;
+  return 0;
+}
+
+
+
+int _compareWriterKeys(const void *a, const void *b)
+{
+  const AB_SETTINGS_SNAPSHOT_WRITER_KEY *ka=(const AB_SETTINGS_SNAPSHOT_WRITER_KEY *) a;
+  const AB_SETTINGS_SNAPSHOT_WRITER_KEY *kb=(const AB_SETTINGS_SNAPSHOT_WRITER_KEY *) b;
+  int rv;
+
+  rv=strcasecmp(ka->key, kb->key);
+  if (rv)
+    return rv;
+  if (ka->uniqueId<kb->uniqueId)
+    return -1;
+  if (ka->uniqueId>kb->uniqueId)
+    return 1;
+  return 0;
+}
+
+
+
+uint32_t _addString(GWEN_BUFFER *buf, uint32_t stringAreaOffset, const char *s)
+{
+  uint32_t pos;
+
+  if (s==NULL)
+    return 0;
+
+  pos=GWEN_Buffer_GetUsedBytes(buf);
+  GWEN_Buffer_AppendString(buf, s);
+  GWEN_Buffer_AppendByte(buf, 0);
+
+  /* keep the next string 4 byte aligned (not needed for strings but cheap) */
+  while (GWEN_Buffer_GetUsedBytes(buf)%4)
+    GWEN_Buffer_AppendByte(buf, 0);
+
+  return stringAreaOffset+pos;
+}
+
+
+
+int _writeData(FILE *f, const void *p, size_t len)
+{
+  if (len && fwrite(p, len, 1, f)!=1) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "fwrite(): %s", strerror(errno));
+    return GWEN_ERROR_IO;
+  }
+  return 0;
+}
+
@@ -0,0 +1,150 @@
+/***************************************************************************
+ begin       : Mon Oct 19 2026
+ copyright   : (C) 2026 by Martin Preuss
+ email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+
+#ifndef AQBANKING_SETTINGSSNAPSHOT_L_H
+#define AQBANKING_SETTINGSSNAPSHOT_L_H
+
+
+#include <gwenhywfar/db.h>
+
+
+/**
+ * Read-only snapshot of the config groups of all users, accounts and account specs in a single file.
+ *
+ * The file is mapped into memory (or read at once on systems without mmap) and can be queried without
+ * locking any config group: every table is sorted by unique id, account specs additionally have sorted
+ * indexes by IBAN and by bank code/account number. Only the groups actually requested are parsed.
+ *
+ * A snapshot is never modified: a new one is written to a temporary file which then replaces the old one,
+ * so readers which still have the old file open are not affected.
+ *
+ * The stamp is an arbitrary string stored by the creator of the snapshot, it is used to check whether the
+ * snapshot still matches the settings it was created from.
+ */
+typedef struct AB_SETTINGS_SNAPSHOT AB_SETTINGS_SNAPSHOT;
+typedef struct AB_SETTINGS_SNAPSHOT_WRITER AB_SETTINGS_SNAPSHOT_WRITER;
+
+
+typedef enum {
+  AB_SettingsSnapshotTable_Users=0,
+  AB_SettingsSnapshotTable_Accounts,
+  AB_SettingsSnapshotTable_AccountSpecs,
+  AB_SettingsSnapshotTable_Count
+} AB_SETTINGS_SNAPSHOT_TABLE;
+
+
+typedef enum {
+  AB_SettingsSnapshotIndex_Iban=0,                   /**< key: IBAN */
+  AB_SettingsSnapshotIndex_BankCodeAndAccountNumber, /**< key: see @ref AB_HashIndex_MakeKey */
+  AB_SettingsSnapshotIndex_Count
+} AB_SETTINGS_SNAPSHOT_INDEX;
+
+
+
+/** @name Reading
+ *
+ */
+/*@{*/
+
+/**
+ * Open and validate a snapshot file.
+ * @return 0 if ok, GWEN_ERROR_NOT_FOUND if there is no such file, GWEN_ERROR_BAD_DATA if the file is not
+ *   a valid snapshot
+ */
+int AB_SettingsSnapshot_Open(const char *fileName, AB_SETTINGS_SNAPSHOT **pSnapshot);
+
+void AB_SettingsSnapshot_free(AB_SETTINGS_SNAPSHOT *ss);
+
+/**
+ * Check whether the file from which the snapshot has been read is still in place (i.e. has neither been
+ * replaced nor removed).
+ */
+int AB_SettingsSnapshot_IsCurrent(const AB_SETTINGS_SNAPSHOT *ss);
+
+const char *AB_SettingsSnapshot_GetStamp(const AB_SETTINGS_SNAPSHOT *ss);
+
+/**
+ * Generation of the settings the snapshot has been created from (as given to @ref AB_SettingsSnapshotWriter_new).
+ */
+uint32_t AB_SettingsSnapshot_GetGeneration(const AB_SETTINGS_SNAPSHOT *ss);
+
+int AB_SettingsSnapshot_GetGroupCount(const AB_SETTINGS_SNAPSHOT *ss, AB_SETTINGS_SNAPSHOT_TABLE t);
+
+/**
+ * Read a single config group.
+ * @return 0 if ok, GWEN_ERROR_NOT_FOUND if there is no group with the given unique id
+ */
+int AB_SettingsSnapshot_ReadGroup(const AB_SETTINGS_SNAPSHOT *ss,
+                                  AB_SETTINGS_SNAPSHOT_TABLE t,
+                                  uint32_t uniqueId,
+                                  GWEN_DB_NODE **pDb);
+
+/**
+ * Read all config groups of a table as subgroups of a new group (like @ref AB_Banking_ReadConfigGroups()),
+ * the subgroups are named after the config manager groups.
+ * @param backendName only return groups for this backend (ignored if NULL)
+ * @return 0 if ok, GWEN_ERROR_NOT_FOUND if there are no matching groups
+ */
+int AB_SettingsSnapshot_ReadGroups(const AB_SETTINGS_SNAPSHOT *ss,
+                                   AB_SETTINGS_SNAPSHOT_TABLE t,
+                                   const char *backendName,
+                                   GWEN_DB_NODE **pDb);
+
+/**
+ * Lookup the unique id of the first account spec with the given key (case-insensitive).
+ * @return 0 if ok, GWEN_ERROR_NOT_FOUND otherwise
+ */
+int AB_SettingsSnapshot_FindAccountSpec(const AB_SETTINGS_SNAPSHOT *ss,
+                                        AB_SETTINGS_SNAPSHOT_INDEX idx,
+                                        const char *key,
+                                        uint32_t *pUniqueId);
+
+/*@}*/
+
+
+
+/** @name Writing
+ *
+ */
+/*@{*/
+
+AB_SETTINGS_SNAPSHOT_WRITER *AB_SettingsSnapshotWriter_new(const char *stamp, uint32_t generation);
+void AB_SettingsSnapshotWriter_free(AB_SETTINGS_SNAPSHOT_WRITER *sw);
+
+/**
+ * Add a config group. Groups with a unique id of 0 are ignored.
+ * @param name name of the config manager group
+ * @param backendName value used to filter with @ref AB_SettingsSnapshot_ReadGroups (may be NULL)
+ */
+int AB_SettingsSnapshotWriter_AddGroup(AB_SETTINGS_SNAPSHOT_WRITER *sw,
+                                       AB_SETTINGS_SNAPSHOT_TABLE t,
+                                       uint32_t uniqueId,
+                                       const char *name,
+                                       const char *backendName,
+                                       GWEN_DB_NODE *db);
+
+/**
+ * Add a key for an account spec to an index. Empty keys are ignored.
+ */
+void AB_SettingsSnapshotWriter_AddAccountSpecKey(AB_SETTINGS_SNAPSHOT_WRITER *sw,
+                                                 AB_SETTINGS_SNAPSHOT_INDEX idx,
+                                                 const char *key,
+                                                 uint32_t uniqueId);
+
+/**
+ * Write the snapshot to a temporary file and replace the given file with it.
+ */
+int AB_SettingsSnapshotWriter_WriteFile(AB_SETTINGS_SNAPSHOT_WRITER *sw, const char *fileName);
+
+/*@}*/
+
+
+#endif
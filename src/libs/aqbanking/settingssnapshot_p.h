@@ -0,0 +1,118 @@
+/***************************************************************************
+ begin       : Mon Oct 19 2026
+ copyright   : (C) 2026 by Martin Preuss
+ email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+
+#ifndef AQBANKING_SETTINGSSNAPSHOT_P_H
+#define AQBANKING_SETTINGSSNAPSHOT_P_H
+
+
+#include "settingssnapshot_l.h"
+
+#include <gwenhywfar/buffer.h>
+
+
+#define AB_SETTINGS_SNAPSHOT_MAGIC     "ABSNAP\r\n"
+#define AB_SETTINGS_SNAPSHOT_VERSION   1
+#define AB_SETTINGS_SNAPSHOT_BYTEORDER 0x01020304
+
+
+/*
+ * File layout (all numbers in host byte order, all offsets relative to the beginning of the file):
+ *
+ *   header
+ *   entries of all tables (each table sorted by unique id)
+ *   keys of all indexes (each index sorted by key, then by unique id)
+ *   string area (NUL-terminated names, keys and GWEN_DB texts of the groups, the file ends with a NUL byte)
+ *
+ * A string offset of 0 means "no string".
+ */
+typedef struct AB_SETTINGS_SNAPSHOT_HEADER AB_SETTINGS_SNAPSHOT_HEADER;
+struct AB_SETTINGS_SNAPSHOT_HEADER {
+  char magic[8];
+  uint32_t byteOrder;
+  uint32_t version;
+  uint32_t generation;
+  uint32_t fileSize;
+  uint32_t stampOffset;
+  uint32_t tableOffset[AB_SettingsSnapshotTable_Count];
+  uint32_t tableCount[AB_SettingsSnapshotTable_Count];
+  uint32_t indexOffset[AB_SettingsSnapshotIndex_Count];
+  uint32_t indexCount[AB_SettingsSnapshotIndex_Count];
+};
+
+
+typedef struct AB_SETTINGS_SNAPSHOT_ENTRY AB_SETTINGS_SNAPSHOT_ENTRY;
+struct AB_SETTINGS_SNAPSHOT_ENTRY {
+  uint32_t uniqueId;
+  uint32_t nameOffset;
+  uint32_t backendNameOffset;
+  uint32_t dataOffset;
+  uint32_t dataLength;
+};
+
+
+typedef struct AB_SETTINGS_SNAPSHOT_KEY AB_SETTINGS_SNAPSHOT_KEY;
+struct AB_SETTINGS_SNAPSHOT_KEY {
+  uint32_t keyOffset;
+  uint32_t uniqueId;
+};
+
+
+
+struct AB_SETTINGS_SNAPSHOT {
+  char *fileName;
+
+  const uint8_t *data;
+  uint32_t size;
+  int mapped;             /* 1 if data is mapped, 0 if allocated */
+
+  const AB_SETTINGS_SNAPSHOT_HEADER *header;
+
+  /* identity of the file when opened, see AB_SettingsSnapshot_IsCurrent() */
+  long long fileDevice;
+  long long fileInode;
+  long long fileMtime;
+  long long fileSize;
+};
+
+
+
+typedef struct AB_SETTINGS_SNAPSHOT_WRITER_ENTRY AB_SETTINGS_SNAPSHOT_WRITER_ENTRY;
+struct AB_SETTINGS_SNAPSHOT_WRITER_ENTRY {
+  uint32_t uniqueId;
+  char *name;
+  char *backendName;
+  GWEN_BUFFER *dataBuffer;
+};
+
+
+typedef struct AB_SETTINGS_SNAPSHOT_WRITER_KEY AB_SETTINGS_SNAPSHOT_WRITER_KEY;
+struct AB_SETTINGS_SNAPSHOT_WRITER_KEY {
+  char *key;
+  uint32_t uniqueId;
+};
+
+
+struct AB_SETTINGS_SNAPSHOT_WRITER {
+  char *stamp;
+  uint32_t generation;
+
+  AB_SETTINGS_SNAPSHOT_WRITER_ENTRY *entries[AB_SettingsSnapshotTable_Count];
+  uint32_t entryCount[AB_SettingsSnapshotTable_Count];
+  uint32_t entrySpace[AB_SettingsSnapshotTable_Count];
+
+  AB_SETTINGS_SNAPSHOT_WRITER_KEY *keys[AB_SettingsSnapshotIndex_Count];
+  uint32_t keyCount[AB_SettingsSnapshotIndex_Count];
+  uint32_t keySpace[AB_SettingsSnapshotIndex_Count];
+};
+
+
+
+#endif
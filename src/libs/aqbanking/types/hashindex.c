@@ -0,0 +1,296 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "hashindex_p.h"
+
+#include <aqbanking/error.h>
+
+#include <gwenhywfar/misc.h>
+#include <gwenhywfar/debug.h>
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * forward declarations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+static uint32_t _hashKey(const AB_HASHINDEX *hi, const char *key);
+static int _keysEqual(const AB_HASHINDEX *hi, const char *k1, const char *k2);
+static AB_HASHINDEX_ENTRY *_findEntry(const AB_HASHINDEX *hi, uint32_t hash, const char *key, AB_HASHINDEX_ENTRY *e);
+static void _growIfNeeded(AB_HASHINDEX *hi);
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * implementations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+
+AB_HASHINDEX *AB_HashIndex_new(uint32_t flags)
+{
+  AB_HASHINDEX *hi;
+
+  GWEN_NEW_OBJECT(AB_HASHINDEX, hi);
+  hi->flags=flags;
+  hi->bucketCount=AB_HASHINDEX_INITIAL_BUCKETS;
+  hi->buckets=(AB_HASHINDEX_ENTRY **) calloc(hi->bucketCount, sizeof(AB_HASHINDEX_ENTRY *));
+  assert(hi->buckets);
+
+  return hi;
+}
+
+
+
+void AB_HashIndex_free(AB_HASHINDEX *hi)
+{
+  if (hi) {
+    AB_HashIndex_Clear(hi);
+    free(hi->buckets);
+    GWEN_FREE_OBJECT(hi);
+  }
+}
+
+
+
+void AB_HashIndex_Clear(AB_HASHINDEX *hi)
+{
+  uint32_t i;
+
+  assert(hi);
+  for (i=0; i<hi->bucketCount; i++) {
+    AB_HASHINDEX_ENTRY *e;
+
+    e=hi->buckets[i];
+    while (e) {
+      AB_HASHINDEX_ENTRY *eNext;
+
+      eNext=e->next;
+      free(e->key);
+      free(e);
+      e=eNext;
+    }
+    hi->buckets[i]=NULL;
+  }
+  hi->entryCount=0;
+}
+
+
+
+uint32_t AB_HashIndex_GetCount(const AB_HASHINDEX *hi)
+{
+  assert(hi);
+  return hi->entryCount;
+}
+
+
+
+void AB_HashIndex_Add(AB_HASHINDEX *hi, const char *key, void *ptr)
+{
+  AB_HASHINDEX_ENTRY *e;
+  AB_HASHINDEX_ENTRY **pLast;
+
+  assert(hi);
+  if (!(key && *key))
+    return;
+
+  _growIfNeeded(hi);
+
+  e=(AB_HASHINDEX_ENTRY *) malloc(sizeof(AB_HASHINDEX_ENTRY));
+  assert(e);
+  e->next=NULL;
+  e->hash=_hashKey(hi, key);
+  e->key=strdup(key);
+  e->ptr=ptr;
+
+  /* append to chain to preserve insertion order */
+  pLast=&(hi->buckets[e->hash % hi->bucketCount]);
+  while (*pLast)
+    pLast=&((*pLast)->next);
+  *pLast=e;
+  hi->entryCount++;
+}
+
+
+
+int AB_HashIndex_Remove(AB_HASHINDEX *hi, const char *key, const void *ptr)
+{
+  uint32_t hash;
+  AB_HASHINDEX_ENTRY **pEntry;
+
+  assert(hi);
+  if (!(key && *key))
+    return GWEN_ERROR_NOT_FOUND;
+
+  hash=_hashKey(hi, key);
+  pEntry=&(hi->buckets[hash % hi->bucketCount]);
+  while (*pEntry) {
+    AB_HASHINDEX_ENTRY *e;
+
+    e=*pEntry;
+    if (e->ptr==ptr && e->hash==hash && _keysEqual(hi, e->key, key)) {
+      *pEntry=e->next;
+      free(e->key);
+      free(e);
+      hi->entryCount--;
+      return 0;
+    }
+    pEntry=&(e->next);
+  }
+
+  return GWEN_ERROR_NOT_FOUND;
+}
+
+
+
+void *AB_HashIndex_Find(const AB_HASHINDEX *hi, const char *key)
+{
+  AB_HASHINDEX_ENTRY *e;
+  uint32_t hash;
+
+  assert(hi);
+  if (!(key && *key))
+    return NULL;
+
+  hash=_hashKey(hi, key);
+  e=_findEntry(hi, hash, key, hi->buckets[hash % hi->bucketCount]);
+  return e?(e->ptr):NULL;
+}
+
+
+
+void *AB_HashIndex_FindNext(const AB_HASHINDEX *hi, const char *key, const void *ptr)
+{
+  AB_HASHINDEX_ENTRY *e;
+  uint32_t hash;
+
+  assert(hi);
+  if (!(key && *key))
+    return NULL;
+
+  hash=_hashKey(hi, key);
+  e=_findEntry(hi, hash, key, hi->buckets[hash % hi->bucketCount]);
+  while (e && e->ptr!=ptr)
+    e=_findEntry(hi, hash, key, e->next);
+  if (e)
+    e=_findEntry(hi, hash, key, e->next);
+  return e?(e->ptr):NULL;
+}
+
+
+
+int AB_HashIndex_MakeKey(char *buffer, uint32_t size, const char *s1, const char *s2, const char *s3)
+{
+  int rv;
+
+  assert(buffer);
+  rv=snprintf(buffer, size, "%s\x1f%s\x1f%s", s1?s1:"", s2?s2:"", s3?s3:"");
+  if (rv<0 || (uint32_t) rv>=size) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Key too long for buffer");
+    return GWEN_ERROR_BUFFER_OVERFLOW;
+  }
+  return 0;
+}
+
+
+
+AB_HASHINDEX_ENTRY *_findEntry(const AB_HASHINDEX *hi, uint32_t hash, const char *key, AB_HASHINDEX_ENTRY *e)
+{
+  while (e) {
+    if (e->hash==hash && _keysEqual(hi, e->key, key))
+      return e;
+    e=e->next;
+  }
+  return NULL;
+}
+
+
+
+void _growIfNeeded(AB_HASHINDEX *hi)
+{
+  if (hi->entryCount>=(hi->bucketCount*2)) {
+    AB_HASHINDEX_ENTRY **newBuckets;
+    uint32_t newCount;
+    uint32_t i;
+
+    newCount=hi->bucketCount*4;
+    newBuckets=(AB_HASHINDEX_ENTRY **) calloc(newCount, sizeof(AB_HASHINDEX_ENTRY *));
+    assert(newBuckets);
+
+    for (i=0; i<hi->bucketCount; i++) {
+      AB_HASHINDEX_ENTRY *e;
+
+      e=hi->buckets[i];
+      while (e) {
+        AB_HASHINDEX_ENTRY *eNext;
+        AB_HASHINDEX_ENTRY **pLast;
+
+        eNext=e->next;
+        e->next=NULL;
+        pLast=&(newBuckets[e->hash % newCount]);
+        while (*pLast)
+          pLast=&((*pLast)->next);
+        *pLast=e;
+        e=eNext;
+      }
+    }
+
+    free(hi->buckets);
+    hi->buckets=newBuckets;
+    hi->bucketCount=newCount;
+  }
+}
+
+
+
+uint32_t _hashKey(const AB_HASHINDEX *hi, const char *key)
+{
+  const unsigned char *p;
+  uint32_t hash=2166136261u; /* FNV-1a */
+
+  p=(const unsigned char *) key;
+  if (hi->flags & AB_HASHINDEX_FLAGS_IGNORECASE) {
+    while (*p) {
+      hash^=(uint32_t) tolower(*(p++));
+      hash*=16777619u;
+    }
+  }
+  else {
+    while (*p) {
+      hash^=(uint32_t) *(p++);
+      hash*=16777619u;
+    }
+  }
+
+  return hash;
+}
+
+
+
+int _keysEqual(const AB_HASHINDEX *hi, const char *k1, const char *k2)
+{
+  if (hi->flags & AB_HASHINDEX_FLAGS_IGNORECASE)
+    return (strcasecmp(k1, k2)==0);
+  return (strcmp(k1, k2)==0);
+}
+
+
@@ -0,0 +1,82 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+
+#ifndef AB_HASHINDEX_H
+#define AB_HASHINDEX_H
+
+
+#include <aqbanking/error.h>
+
+#include <gwenhywfar/types.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Simple string-keyed hash index used to speed up lookups in lists of objects.
+ *
+ * The index does not own the objects it points to, it only stores copies of the keys.
+ * Multiple objects may be stored under the same key, they are returned in the order in which they
+ * have been added (so the first object found is the same one a linear search through the
+ * underlying list would have returned).
+ */
+typedef struct AB_HASHINDEX AB_HASHINDEX;
+
+
+/** compare keys case-insensitively (like strcasecmp) */
+#define AB_HASHINDEX_FLAGS_IGNORECASE 0x00000001
+
+
+AQBANKING_API AB_HASHINDEX *AB_HashIndex_new(uint32_t flags);
+AQBANKING_API void AB_HashIndex_free(AB_HASHINDEX *hi);
+
+/** Remove all entries (keeps the allocated bucket table). */
+AQBANKING_API void AB_HashIndex_Clear(AB_HASHINDEX *hi);
+
+AQBANKING_API uint32_t AB_HashIndex_GetCount(const AB_HASHINDEX *hi);
+
+/**
+ * Add an object pointer under the given key. Empty or NULL keys are ignored.
+ */
+AQBANKING_API void AB_HashIndex_Add(AB_HASHINDEX *hi, const char *key, void *ptr);
+
+/**
+ * Remove the entry for the given key pointing to the given object.
+ * @return 0 if removed, GWEN_ERROR_NOT_FOUND otherwise
+ */
+AQBANKING_API int AB_HashIndex_Remove(AB_HASHINDEX *hi, const char *key, const void *ptr);
+
+/**
+ * Returns the first object added under the given key (or NULL if none).
+ */
+AQBANKING_API void *AB_HashIndex_Find(const AB_HASHINDEX *hi, const char *key);
+
+/**
+ * Returns the object following @b ptr under the given key (or NULL if there is none).
+ */
+AQBANKING_API void *AB_HashIndex_FindNext(const AB_HASHINDEX *hi, const char *key, const void *ptr);
+
+/**
+ * Join up to three key parts into a composite key (NULL parts are treated as empty strings).
+ * @return 0 if ok, GWEN_ERROR_BUFFER_OVERFLOW if the buffer is too small
+ */
+AQBANKING_API int AB_HashIndex_MakeKey(char *buffer, uint32_t size, const char *s1, const char *s2, const char *s3);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif
@@ -0,0 +1,38 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+
+#ifndef AB_HASHINDEX_P_H
+#define AB_HASHINDEX_P_H
+
+#include "hashindex.h"
+
+
+#define AB_HASHINDEX_INITIAL_BUCKETS 64
+
+
+typedef struct AB_HASHINDEX_ENTRY AB_HASHINDEX_ENTRY;
+struct AB_HASHINDEX_ENTRY {
+  AB_HASHINDEX_ENTRY *next;
+  uint32_t hash;
+  char *key;
+  void *ptr;
+};
+
+
+struct AB_HASHINDEX {
+  uint32_t flags;
+  uint32_t bucketCount;
+  uint32_t entryCount;
+  AB_HASHINDEX_ENTRY **buckets;
+};
+
+
+#endif
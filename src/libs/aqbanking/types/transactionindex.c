@@ -0,0 +1,506 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "transactionindex_p.h"
+
+#include <aqbanking/error.h>
+
+#include <gwenhywfar/misc.h>
+#include <gwenhywfar/debug.h>
+
+#include <assert.h>
+#include <stdlib.h>
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * forward declarations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+static void _clearView(AB_TRANSACTION_INDEX_VIEW *view);
+static void _checkList(AB_TRANSACTION_INDEX *ti, const AB_TRANSACTION_LIST *tl);
+static void _rebuild(AB_TRANSACTION_INDEX *ti, const AB_TRANSACTION_LIST *tl);
+static int _collectByDate(const AB_TRANSACTION_INDEX_VIEW *view,
+                          const GWEN_DATE *fromDate, const GWEN_DATE *toDate, int useValutaDate,
+                          int ty, int cmd,
+                          AB_TRANSACTION_LIST2 **pList);
+static int _collectByValue(const AB_TRANSACTION_INDEX_VIEW *view,
+                           const AB_VALUE *minValue, const AB_VALUE *maxValue,
+                           int ty, int cmd,
+                           AB_TRANSACTION_LIST2 **pList);
+static int _collectByType(const AB_TRANSACTION_INDEX_VIEW *view, int ty, int cmd, AB_TRANSACTION_LIST2 **pList);
+static void _buildDateView(AB_TRANSACTION_INDEX_VIEW *view, const AB_TRANSACTION_LIST *tl, int useValutaDate);
+static void _buildValueView(AB_TRANSACTION_INDEX_VIEW *view, const AB_TRANSACTION_LIST *tl);
+static void _buildTypeView(AB_TRANSACTION_INDEX_VIEW *view, const AB_TRANSACTION_LIST *tl);
+static uint32_t _lowerBoundByKey(const AB_TRANSACTION_INDEX_VIEW *view, int key);
+static uint32_t _lowerBoundByValue(const AB_TRANSACTION_INDEX_VIEW *view, const AB_VALUE *v, int upper);
+static int _sortByKeyAndPos(const void *a, const void *b);
+static int _sortByValueAndPos(const void *a, const void *b);
+static void _addIfTypeMatches(AB_TRANSACTION_LIST2 **pList, AB_TRANSACTION *t, int ty, int cmd);
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * implementations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+
+AB_TRANSACTION_INDEX *AB_TransactionIndex_new(void)
+{
+  AB_TRANSACTION_INDEX *ti;
+
+  GWEN_NEW_OBJECT(AB_TRANSACTION_INDEX, ti);
+  ti->listCount=-1;
+
+  return ti;
+}
+
+
+
+void AB_TransactionIndex_free(AB_TRANSACTION_INDEX *ti)
+{
+  if (ti) {
+    AB_TransactionIndex_Clear(ti);
+    GWEN_FREE_OBJECT(ti);
+  }
+}
+
+
+
+void AB_TransactionIndex_Clear(AB_TRANSACTION_INDEX *ti)
+{
+  assert(ti);
+  _clearView(&(ti->byDate));
+  _clearView(&(ti->byValutaDate));
+  _clearView(&(ti->byValue));
+  _clearView(&(ti->byType));
+  ti->list=NULL;
+  ti->listCount=-1;
+  ti->listFirst=NULL;
+  ti->listLast=NULL;
+}
+
+
+
+AB_TRANSACTION_LIST2 *AB_TransactionIndex_FindByDate(AB_TRANSACTION_INDEX *ti,
+                                                     const AB_TRANSACTION_LIST *tl,
+                                                     const GWEN_DATE *fromDate,
+                                                     const GWEN_DATE *toDate,
+                                                     int useValutaDate,
+                                                     int ty, int cmd)
+{
+  AB_TRANSACTION_INDEX_VIEW *view;
+  AB_TRANSACTION_LIST2 *resultList=NULL;
+  int rv;
+
+  assert(ti);
+  if (tl==NULL)
+    return NULL;
+
+  _checkList(ti, tl);
+  view=useValutaDate?&(ti->byValutaDate):&(ti->byDate);
+  if (view->entries==NULL)
+    _buildDateView(view, tl, useValutaDate);
+
+  rv=_collectByDate(view, fromDate, toDate, useValutaDate, ty, cmd, &resultList);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    AB_Transaction_List2_free(resultList);
+    resultList=NULL;
+    _rebuild(ti, tl);
+    _buildDateView(view, tl, useValutaDate);
+    _collectByDate(view, fromDate, toDate, useValutaDate, ty, cmd, &resultList);
+  }
+
+  return resultList;
+}
+
+
+
+AB_TRANSACTION_LIST2 *AB_TransactionIndex_FindByValue(AB_TRANSACTION_INDEX *ti,
+                                                      const AB_TRANSACTION_LIST *tl,
+                                                      const AB_VALUE *minValue,
+                                                      const AB_VALUE *maxValue,
+                                                      int ty, int cmd)
+{
+  AB_TRANSACTION_LIST2 *resultList=NULL;
+  int rv;
+
+  assert(ti);
+  if (tl==NULL)
+    return NULL;
+
+  _checkList(ti, tl);
+  if (ti->byValue.entries==NULL)
+    _buildValueView(&(ti->byValue), tl);
+
+  rv=_collectByValue(&(ti->byValue), minValue, maxValue, ty, cmd, &resultList);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    AB_Transaction_List2_free(resultList);
+    resultList=NULL;
+    _rebuild(ti, tl);
+    _buildValueView(&(ti->byValue), tl);
+    _collectByValue(&(ti->byValue), minValue, maxValue, ty, cmd, &resultList);
+  }
+
+  return resultList;
+}
+
+
+
+AB_TRANSACTION_LIST2 *AB_TransactionIndex_FindByType(AB_TRANSACTION_INDEX *ti,
+                                                     const AB_TRANSACTION_LIST *tl,
+                                                     int ty, int cmd)
+{
+  AB_TRANSACTION_LIST2 *resultList=NULL;
+
+  assert(ti);
+  if (tl==NULL)
+    return NULL;
+
+  if (ty>AB_Transaction_TypeNone) {
+    int rv;
+
+    _checkList(ti, tl);
+    if (ti->byType.entries==NULL)
+      _buildTypeView(&(ti->byType), tl);
+
+    rv=_collectByType(&(ti->byType), ty, cmd, &resultList);
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      AB_Transaction_List2_free(resultList);
+      resultList=NULL;
+      _rebuild(ti, tl);
+      _buildTypeView(&(ti->byType), tl);
+      _collectByType(&(ti->byType), ty, cmd, &resultList);
+    }
+  }
+  else {
+    AB_TRANSACTION *t;
+
+    /* no type given, the list itself is the best view */
+    t=AB_Transaction_List_First(tl);
+    while (t) {
+      _addIfTypeMatches(&resultList, t, ty, cmd);
+      t=AB_Transaction_List_Next(t);
+    }
+  }
+
+  return resultList;
+}
+
+
+
+/* every entry visited is checked against its transaction, returns GWEN_ERROR_INVALID if the view is stale */
+int _collectByDate(const AB_TRANSACTION_INDEX_VIEW *view,
+                   const GWEN_DATE *fromDate, const GWEN_DATE *toDate, int useValutaDate,
+                   int ty, int cmd,
+                   AB_TRANSACTION_LIST2 **pList)
+{
+  uint32_t idx;
+  int lastJulian;
+
+  idx=fromDate?_lowerBoundByKey(view, GWEN_Date_GetJulian(fromDate)):0;
+  lastJulian=toDate?GWEN_Date_GetJulian(toDate):0;
+  while (idx<view->entryCount) {
+    const AB_TRANSACTION_INDEX_ENTRY *e;
+    const GWEN_DATE *dt;
+
+    e=&(view->entries[idx++]);
+    if (toDate && e->key>lastJulian)
+      break;
+    dt=useValutaDate?AB_Transaction_GetValutaDate(e->transaction):AB_Transaction_GetDate(e->transaction);
+    if (dt==NULL || GWEN_Date_GetJulian(dt)!=e->key) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "Date of transaction changed since the index was built");
+      return GWEN_ERROR_INVALID;
+    }
+    _addIfTypeMatches(pList, e->transaction, ty, cmd);
+  }
+
+  return 0;
+}
+
+
+
+int _collectByValue(const AB_TRANSACTION_INDEX_VIEW *view,
+                    const AB_VALUE *minValue, const AB_VALUE *maxValue,
+                    int ty, int cmd,
+                    AB_TRANSACTION_LIST2 **pList)
+{
+  uint32_t idx;
+  uint32_t idxEnd;
+
+  idx=minValue?_lowerBoundByValue(view, minValue, 0):0;
+  idxEnd=maxValue?_lowerBoundByValue(view, maxValue, 1):view->entryCount;
+  while (idx<idxEnd) {
+    const AB_TRANSACTION_INDEX_ENTRY *e;
+    const AB_VALUE *v;
+
+    e=&(view->entries[idx++]);
+    v=AB_Transaction_GetValue(e->transaction);
+    if (v==NULL || !AB_Value_Equal(v, e->value)) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "Value of transaction changed since the index was built");
+      return GWEN_ERROR_INVALID;
+    }
+    _addIfTypeMatches(pList, e->transaction, ty, cmd);
+  }
+
+  return 0;
+}
+
+
+
+int _collectByType(const AB_TRANSACTION_INDEX_VIEW *view, int ty, int cmd, AB_TRANSACTION_LIST2 **pList)
+{
+  uint32_t idx;
+
+  idx=_lowerBoundByKey(view, ty);
+  while (idx<view->entryCount && view->entries[idx].key==ty) {
+    const AB_TRANSACTION_INDEX_ENTRY *e;
+
+    e=&(view->entries[idx++]);
+    if (AB_Transaction_GetType(e->transaction)!=e->key) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "Type of transaction changed since the index was built");
+      return GWEN_ERROR_INVALID;
+    }
+    _addIfTypeMatches(pList, e->transaction, ty, cmd);
+  }
+
+  return 0;
+}
+
+
+
+void _addIfTypeMatches(AB_TRANSACTION_LIST2 **pList, AB_TRANSACTION *t, int ty, int cmd)
+{
+  if (AB_Transaction_MatchTypeAndCommand(t, ty, cmd)) {
+    if (*pList==NULL)
+      *pList=AB_Transaction_List2_new();
+    AB_Transaction_List2_PushBack(*pList, t);
+  }
+}
+
+
+
+/* the list can't notify the index, so detect changes of its size and of its ends */
+void _checkList(AB_TRANSACTION_INDEX *ti, const AB_TRANSACTION_LIST *tl)
+{
+  if (ti->list!=tl ||
+      ti->listCount!=(int) AB_Transaction_List_GetCount(tl) ||
+      ti->listFirst!=AB_Transaction_List_First(tl) ||
+      ti->listLast!=AB_Transaction_List_Last(tl)) {
+    DBG_DEBUG(AQBANKING_LOGDOMAIN, "Transaction list changed, rebuilding index");
+    _rebuild(ti, tl);
+  }
+}
+
+
+
+void _rebuild(AB_TRANSACTION_INDEX *ti, const AB_TRANSACTION_LIST *tl)
+{
+  AB_TransactionIndex_Clear(ti);
+  ti->list=tl;
+  ti->listCount=AB_Transaction_List_GetCount(tl);
+  ti->listFirst=AB_Transaction_List_First(tl);
+  ti->listLast=AB_Transaction_List_Last(tl);
+}
+
+
+
+void _clearView(AB_TRANSACTION_INDEX_VIEW *view)
+{
+  uint32_t i;
+
+  for (i=0; i<view->entryCount; i++)
+    AB_Value_free(view->entries[i].value);
+  free(view->entries);
+  view->entries=NULL;
+  view->entryCount=0;
+}
+
+
+
+void _buildDateView(AB_TRANSACTION_INDEX_VIEW *view, const AB_TRANSACTION_LIST *tl, int useValutaDate)
+{
+  AB_TRANSACTION *t;
+  uint32_t pos=0;
+
+  /* allocate at least one entry so that "entries!=NULL" marks the view as built */
+  view->entries=(AB_TRANSACTION_INDEX_ENTRY *) malloc(sizeof(AB_TRANSACTION_INDEX_ENTRY)*
+                                                      (AB_Transaction_List_GetCount(tl)+1));
+  assert(view->entries);
+  view->entryCount=0;
+
+  t=AB_Transaction_List_First(tl);
+  while (t) {
+    const GWEN_DATE *dt;
+
+    dt=useValutaDate?AB_Transaction_GetValutaDate(t):AB_Transaction_GetDate(t);
+    if (dt) {
+      AB_TRANSACTION_INDEX_ENTRY *e;
+
+      e=&(view->entries[view->entryCount++]);
+      e->key=GWEN_Date_GetJulian(dt);
+      e->pos=pos;
+      e->transaction=t;
+      e->value=NULL;
+    }
+    pos++;
+    t=AB_Transaction_List_Next(t);
+  }
+
+  qsort(view->entries, view->entryCount, sizeof(AB_TRANSACTION_INDEX_ENTRY), _sortByKeyAndPos);
+}
+
+
+
+void _buildValueView(AB_TRANSACTION_INDEX_VIEW *view, const AB_TRANSACTION_LIST *tl)
+{
+  AB_TRANSACTION *t;
+  uint32_t pos=0;
+
+  view->entries=(AB_TRANSACTION_INDEX_ENTRY *) malloc(sizeof(AB_TRANSACTION_INDEX_ENTRY)*
+                                                      (AB_Transaction_List_GetCount(tl)+1));
+  assert(view->entries);
+  view->entryCount=0;
+
+  t=AB_Transaction_List_First(tl);
+  while (t) {
+    const AB_VALUE *v;
+
+    v=AB_Transaction_GetValue(t);
+    if (v) {
+      AB_TRANSACTION_INDEX_ENTRY *e;
+
+      e=&(view->entries[view->entryCount++]);
+      e->key=0;
+      e->pos=pos;
+      e->transaction=t;
+      e->value=AB_Value_dup(v);
+    }
+    pos++;
+    t=AB_Transaction_List_Next(t);
+  }
+
+  qsort(view->entries, view->entryCount, sizeof(AB_TRANSACTION_INDEX_ENTRY), _sortByValueAndPos);
+}
+
+
+
+void _buildTypeView(AB_TRANSACTION_INDEX_VIEW *view, const AB_TRANSACTION_LIST *tl)
+{
+  AB_TRANSACTION *t;
+  uint32_t pos=0;
+
+  view->entries=(AB_TRANSACTION_INDEX_ENTRY *) malloc(sizeof(AB_TRANSACTION_INDEX_ENTRY)*
+                                                      (AB_Transaction_List_GetCount(tl)+1));
+  assert(view->entries);
+  view->entryCount=0;
+
+  t=AB_Transaction_List_First(tl);
+  while (t) {
+    AB_TRANSACTION_INDEX_ENTRY *e;
+
+    e=&(view->entries[view->entryCount++]);
+    e->key=AB_Transaction_GetType(t);
+    e->pos=pos++;
+    e->transaction=t;
+    e->value=NULL;
+    t=AB_Transaction_List_Next(t);
+  }
+
+  qsort(view->entries, view->entryCount, sizeof(AB_TRANSACTION_INDEX_ENTRY), _sortByKeyAndPos);
+}
+
+
+
+uint32_t _lowerBoundByKey(const AB_TRANSACTION_INDEX_VIEW *view, int key)
+{
+  uint32_t lo=0;
+  uint32_t hi;
+
+  hi=view->entryCount;
+  while (lo<hi) {
+    uint32_t mid;
+
+    mid=lo+(hi-lo)/2;
+    if (view->entries[mid].key<key)
+      lo=mid+1;
+    else
+      hi=mid;
+  }
+  return lo;
+}
+
+
+
+/* upper=0: first entry with value>=v, upper=1: first entry with value>v */
+uint32_t _lowerBoundByValue(const AB_TRANSACTION_INDEX_VIEW *view, const AB_VALUE *v, int upper)
+{
+  uint32_t lo=0;
+  uint32_t hi;
+
+  hi=view->entryCount;
+  while (lo<hi) {
+    uint32_t mid;
+    int rv;
+
+    mid=lo+(hi-lo)/2;
+    rv=AB_Value_Compare(view->entries[mid].value, v);
+    if (rv<0 || (upper && rv==0))
+      lo=mid+1;
+    else
+      hi=mid;
+  }
+  return lo;
+}
+
+
+
+int _sortByKeyAndPos(const void *a, const void *b)
+{
+  const AB_TRANSACTION_INDEX_ENTRY *e1;
+  const AB_TRANSACTION_INDEX_ENTRY *e2;
+
+  e1=(const AB_TRANSACTION_INDEX_ENTRY *) a;
+  e2=(const AB_TRANSACTION_INDEX_ENTRY *) b;
+  if (e1->key!=e2->key)
+    return (e1->key<e2->key)?-1:1;
+  if (e1->pos!=e2->pos)
+    return (e1->pos<e2->pos)?-1:1;
+  return 0;
+}
+
+
+
+int _sortByValueAndPos(const void *a, const void *b)
+{
+  const AB_TRANSACTION_INDEX_ENTRY *e1;
+  const AB_TRANSACTION_INDEX_ENTRY *e2;
+  int rv;
+
+  e1=(const AB_TRANSACTION_INDEX_ENTRY *) a;
+  e2=(const AB_TRANSACTION_INDEX_ENTRY *) b;
+  rv=AB_Value_Compare(e1->value, e2->value);
+  if (rv!=0)
+    return rv;
+  if (e1->pos!=e2->pos)
+    return (e1->pos<e2->pos)?-1:1;
+  return 0;
+}
+
+
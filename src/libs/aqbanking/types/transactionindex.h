@@ -0,0 +1,110 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+
+#ifndef AB_TRANSACTIONINDEX_H
+#define AB_TRANSACTIONINDEX_H
+
+
+#include <aqbanking/error.h>
+#include <aqbanking/types/transaction.h>
+#include <aqbanking/types/value.h>
+
+#include <gwenhywfar/gwendate.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Sorted views on a list of transactions used for range queries.
+ *
+ * Every view (booking date, valuta date, value, type) is only built when first needed. All views are
+ * rebuilt automatically when another list is passed or when the number, the first or the last transaction of the
+ * list changed. Every entry found by a query is checked against its transaction and all views are rebuilt if the date,
+ * value or type of that transaction changed.
+ *
+ * The list can not notify the index, so callers must call @ref AB_TransactionIndex_Clear after every other modification
+ * (e.g. removing one transaction and adding another one, or changing a transaction to move it into a queried range).
+ * This is mandatory before freeing transactions which were in the list when the index was last used.
+ *
+ * The index does not own the transactions. All query functions return a list of pointers to the
+ * transactions of the indexed list (or NULL if there are no matches) which must be freed by the caller via
+ * @ref AB_Transaction_List2_free (this does not free the transactions themselves).
+ */
+typedef struct AB_TRANSACTION_INDEX AB_TRANSACTION_INDEX;
+
+
+AQBANKING_API AB_TRANSACTION_INDEX *AB_TransactionIndex_new(void);
+AQBANKING_API void AB_TransactionIndex_free(AB_TRANSACTION_INDEX *ti);
+
+/** Drop all views, they will be rebuilt upon next query. */
+AQBANKING_API void AB_TransactionIndex_Clear(AB_TRANSACTION_INDEX *ti);
+
+
+/**
+ * Return transactions whose (valuta) date lies within the given range.
+ * Transactions without the respective date are never returned. Results are sorted by date, transactions
+ * with the same date are returned in list order.
+ *
+ * @param ti index
+ * @param tl list of transactions the index refers to
+ * @param fromDate first date of the range (NULL for open start)
+ * @param toDate last date of the range (NULL for open end)
+ * @param useValutaDate use valuta date instead of booking date if !=0
+ * @param ty transaction type, if 0 then this is not checked
+ * @param cmd command, if -1 then any non-zero command matches, if 0 then this is not checked
+ */
+AQBANKING_API AB_TRANSACTION_LIST2 *AB_TransactionIndex_FindByDate(AB_TRANSACTION_INDEX *ti,
+                                                                   const AB_TRANSACTION_LIST *tl,
+                                                                   const GWEN_DATE *fromDate,
+                                                                   const GWEN_DATE *toDate,
+                                                                   int useValutaDate,
+                                                                   int ty, int cmd);
+
+/**
+ * Return transactions whose value lies within the given range (currencies are not compared).
+ * Transactions without value are never returned. Results are sorted by value, transactions
+ * with the same value are returned in list order.
+ *
+ * @param ti index
+ * @param tl list of transactions the index refers to
+ * @param minValue lower bound (NULL for no lower bound)
+ * @param maxValue upper bound (NULL for no upper bound)
+ * @param ty transaction type, if 0 then this is not checked
+ * @param cmd command, if -1 then any non-zero command matches, if 0 then this is not checked
+ */
+AQBANKING_API AB_TRANSACTION_LIST2 *AB_TransactionIndex_FindByValue(AB_TRANSACTION_INDEX *ti,
+                                                                    const AB_TRANSACTION_LIST *tl,
+                                                                    const AB_VALUE *minValue,
+                                                                    const AB_VALUE *maxValue,
+                                                                    int ty, int cmd);
+
+/**
+ * Return transactions matching the given type and command in list order.
+ *
+ * @param ti index
+ * @param tl list of transactions the index refers to
+ * @param ty transaction type, if 0 then this is not checked
+ * @param cmd command, if -1 then any non-zero command matches, if 0 then this is not checked
+ */
+AQBANKING_API AB_TRANSACTION_LIST2 *AB_TransactionIndex_FindByType(AB_TRANSACTION_INDEX *ti,
+                                                                   const AB_TRANSACTION_LIST *tl,
+                                                                   int ty, int cmd);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif
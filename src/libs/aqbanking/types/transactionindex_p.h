@@ -0,0 +1,47 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+
+#ifndef AB_TRANSACTIONINDEX_P_H
+#define AB_TRANSACTIONINDEX_P_H
+
+#include "transactionindex.h"
+
+
+typedef struct AB_TRANSACTION_INDEX_ENTRY AB_TRANSACTION_INDEX_ENTRY;
+struct AB_TRANSACTION_INDEX_ENTRY {
+  int key;          /* julian date or transaction type */
+  uint32_t pos;     /* position in the transaction list (keeps sort stable) */
+  AB_TRANSACTION *transaction;
+  AB_VALUE *value;  /* copy of the value when the entry was made (value view only) */
+};
+
+
+typedef struct AB_TRANSACTION_INDEX_VIEW AB_TRANSACTION_INDEX_VIEW;
+struct AB_TRANSACTION_INDEX_VIEW {
+  AB_TRANSACTION_INDEX_ENTRY *entries; /* NULL if not built */
+  uint32_t entryCount;
+};
+
+
+struct AB_TRANSACTION_INDEX {
+  const AB_TRANSACTION_LIST *list; /* list the views were built for */
+  int listCount; /* number of transactions in the list when the views were built (-1: none built) */
+  const AB_TRANSACTION *listFirst; /* first and last transaction of the list when the views were built */
+  const AB_TRANSACTION *listLast;
+
+  AB_TRANSACTION_INDEX_VIEW byDate;
+  AB_TRANSACTION_INDEX_VIEW byValutaDate;
+  AB_TRANSACTION_INDEX_VIEW byValue;
+  AB_TRANSACTION_INDEX_VIEW byType;
+};
+
+
+#endif
@@ -0,0 +1,435 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "transactionsort_p.h"
+
+#include <aqbanking/error.h>
+
+#include <gwenhywfar/misc.h>
+#include <gwenhywfar/debug.h>
+#include <gwenhywfar/buffer.h>
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * forward declarations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+static int _setupChain(AB_TRANSACTION_SORT_CHAIN *chain, const int *keys);
+static void _extractEntries(AB_TRANSACTION_LIST *tl, const AB_TRANSACTION_SORT_CHAIN *chain, uint32_t runIndex,
+                            AB_TRANSACTION_SORT_RUN *run);
+static void _freeRun(AB_TRANSACTION_SORT_RUN *run);
+static int _compareKeys(const AB_TRANSACTION_SORT_ENTRY *e1, const AB_TRANSACTION_SORT_ENTRY *e2);
+static int _sortByKeysAndPos(const void *a, const void *b);
+static int _compareRunHeads(const AB_TRANSACTION_SORT_RUN *runs, uint32_t r1, uint32_t r2);
+static void _heapSiftDown(const AB_TRANSACTION_SORT_RUN *runs, uint32_t *heap, uint32_t heapSize, uint32_t idx);
+static int _hasSameContents(AB_TRANSACTION_SORT_ENTRY *e1, AB_TRANSACTION_SORT_ENTRY *e2);
+static const char *_getHashString(AB_TRANSACTION_SORT_ENTRY *e);
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * implementations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+
+int AB_Transaction_List_SortByKeys(AB_TRANSACTION_LIST *tl, const int *keys)
+{
+  AB_TRANSACTION_SORT_CHAIN chain;
+  AB_TRANSACTION_SORT_RUN run;
+  uint32_t i;
+  int rv;
+
+  assert(tl);
+
+  rv=_setupChain(&chain, keys);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  _extractEntries(tl, &chain, 0, &run);
+  if (run.entryCount>1) {
+    qsort(run.entries, run.entryCount, sizeof(AB_TRANSACTION_SORT_ENTRY), _sortByKeysAndPos);
+
+    /* relink in sorted order */
+    for (i=0; i<run.entryCount; i++)
+      AB_Transaction_List_Del(run.entries[i].transaction);
+    for (i=0; i<run.entryCount; i++)
+      AB_Transaction_List_Add(run.entries[i].transaction, tl);
+  }
+  _freeRun(&run);
+
+  return 0;
+}
+
+
+
+int AB_Transaction_List_MergeSorted(AB_TRANSACTION_LIST *tlDest,
+                                    AB_TRANSACTION_LIST **srcLists,
+                                    int srcCount,
+                                    const int *keys,
+                                    uint32_t flags)
+{
+  AB_TRANSACTION_SORT_CHAIN chain;
+  AB_TRANSACTION_SORT_RUN *runs;
+  AB_TRANSACTION_SORT_ENTRY **resultEntries;
+  AB_TRANSACTION **droppedTransactions;
+  uint32_t *heap;
+  uint32_t runCount;
+  uint32_t heapSize=0;
+  uint32_t totalCount=0;
+  uint32_t resultCount=0;
+  uint32_t droppedCount=0;
+  uint32_t sameKeysStart=0;
+  uint32_t i;
+  int rv;
+
+  assert(tlDest);
+  assert(srcCount<1 || srcLists);
+
+  rv=_setupChain(&chain, keys);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  /* run 0 is the destination list */
+  runCount=(srcCount>0)?srcCount+1:1;
+  runs=(AB_TRANSACTION_SORT_RUN *) calloc(runCount, sizeof(AB_TRANSACTION_SORT_RUN));
+  heap=(uint32_t *) malloc(runCount*sizeof(uint32_t));
+  assert(runs);
+  assert(heap);
+  for (i=0; i<runCount; i++) {
+    AB_TRANSACTION_LIST *tl;
+
+    tl=(i==0)?tlDest:srcLists[i-1];
+    if (tl)
+      _extractEntries(tl, &chain, i, &runs[i]);
+    if ((flags & AB_TRANSACTION_MERGE_FLAGS_SORT) && runs[i].entryCount>1)
+      qsort(runs[i].entries, runs[i].entryCount, sizeof(AB_TRANSACTION_SORT_ENTRY), _sortByKeysAndPos);
+    totalCount+=runs[i].entryCount;
+    if (runs[i].entryCount)
+      heap[heapSize++]=i;
+  }
+
+  resultEntries=(AB_TRANSACTION_SORT_ENTRY **) malloc((totalCount?totalCount:1)*sizeof(AB_TRANSACTION_SORT_ENTRY *));
+  droppedTransactions=(AB_TRANSACTION **) malloc((totalCount?totalCount:1)*sizeof(AB_TRANSACTION *));
+  assert(resultEntries);
+  assert(droppedTransactions);
+
+  /* k-way merge: the heap contains all runs which still have entries, ordered by their next entry */
+  if (heapSize>1) {
+    i=heapSize/2;
+    while (i>0)
+      _heapSiftDown(runs, heap, heapSize, --i);
+  }
+
+  while (heapSize) {
+    AB_TRANSACTION_SORT_RUN *run;
+    AB_TRANSACTION_SORT_ENTRY *e;
+    int isDuplicate=0;
+
+    run=&runs[heap[0]];
+    e=&(run->entries[run->nextEntry++]);
+    if (run->nextEntry>=run->entryCount)
+      heap[0]=heap[--heapSize];
+    if (heapSize>1)
+      _heapSiftDown(runs, heap, heapSize, 0);
+
+    /* duplicates can only be found among the preceding entries with the same keys. Those arrive ordered by list,
+     * so an entry only duplicates an entry of an earlier list which has not yet been matched by another entry of
+     * the same list (identical bookings within one list are legitimate and kept) */
+    if (resultCount && _compareKeys(resultEntries[resultCount-1], e)==0) {
+      if (!(flags & AB_TRANSACTION_MERGE_FLAGS_KEEPDUPLICATES)) {
+        uint32_t j;
+
+        for (j=sameKeysStart; j<resultCount; j++) {
+          AB_TRANSACTION_SORT_ENTRY *eResult;
+
+          eResult=resultEntries[j];
+          if (eResult->runIndex!=e->runIndex && eResult->matchedRun!=(int) e->runIndex && _hasSameContents(eResult, e)) {
+            eResult->matchedRun=(int) e->runIndex;
+            isDuplicate=1;
+            break;
+          }
+        }
+      }
+    }
+    else
+      sameKeysStart=resultCount;
+
+    if (isDuplicate)
+      droppedTransactions[droppedCount++]=e->transaction;
+    else
+      resultEntries[resultCount++]=e;
+  }
+
+  /* relink */
+  for (i=0; i<runCount; i++) {
+    uint32_t j;
+
+    for (j=0; j<runs[i].entryCount; j++)
+      AB_Transaction_List_Del(runs[i].entries[j].transaction);
+  }
+  for (i=0; i<resultCount; i++)
+    AB_Transaction_List_Add(resultEntries[i]->transaction, tlDest);
+  for (i=0; i<droppedCount; i++)
+    AB_Transaction_free(droppedTransactions[i]);
+
+  if (droppedCount) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Dropped %lu duplicate transactions", (unsigned long) droppedCount);
+  }
+
+  free(droppedTransactions);
+  free(resultEntries);
+  for (i=0; i<runCount; i++)
+    _freeRun(&runs[i]);
+  free(heap);
+  free(runs);
+
+  return (int) droppedCount;
+}
+
+
+
+int _setupChain(AB_TRANSACTION_SORT_CHAIN *chain, const int *keys)
+{
+  static const int defaultKeys[]= {
+    AB_TransactionSortKey_Date,
+    AB_TransactionSortKey_ValutaDate,
+    AB_TransactionSortKey_BankReference,
+    AB_TransactionSortKey_None
+  };
+  int i;
+
+  memset(chain, 0, sizeof(AB_TRANSACTION_SORT_CHAIN));
+  if (keys==NULL)
+    keys=defaultKeys;
+
+  for (i=0; keys[i]!=AB_TransactionSortKey_None; i++) {
+    int k;
+
+    if (i>=AB_TRANSACTION_SORT_MAXKEYS) {
+      DBG_ERROR(AQBANKING_LOGDOMAIN, "Too many sort keys (max %d)", AB_TRANSACTION_SORT_MAXKEYS);
+      return GWEN_ERROR_INVALID;
+    }
+    k=keys[i] & ~AB_TRANSACTION_SORTKEY_DESCENDING;
+    if (k<AB_TransactionSortKey_Date || k>AB_TransactionSortKey_UniqueId) {
+      DBG_ERROR(AQBANKING_LOGDOMAIN, "Invalid sort key %d", keys[i]);
+      return GWEN_ERROR_INVALID;
+    }
+    chain->keys[i]=k;
+    chain->descending[i]=(keys[i] & AB_TRANSACTION_SORTKEY_DESCENDING)?1:0;
+  }
+  chain->keyCount=i;
+
+  return 0;
+}
+
+
+
+void _extractEntries(AB_TRANSACTION_LIST *tl, const AB_TRANSACTION_SORT_CHAIN *chain, uint32_t runIndex,
+                     AB_TRANSACTION_SORT_RUN *run)
+{
+  AB_TRANSACTION *t;
+  uint32_t pos=0;
+
+  memset(run, 0, sizeof(AB_TRANSACTION_SORT_RUN));
+  run->entryCount=AB_Transaction_List_GetCount(tl);
+  if (run->entryCount==0)
+    return;
+
+  run->entries=(AB_TRANSACTION_SORT_ENTRY *) calloc(run->entryCount, sizeof(AB_TRANSACTION_SORT_ENTRY));
+  assert(run->entries);
+
+  t=AB_Transaction_List_First(tl);
+  while (t && pos<run->entryCount) {
+    AB_TRANSACTION_SORT_ENTRY *e;
+    int i;
+
+    e=&(run->entries[pos]);
+    e->chain=chain;
+    e->runIndex=runIndex;
+    e->matchedRun=-1;
+    e->pos=pos;
+    e->transaction=t;
+    for (i=0; i<chain->keyCount; i++) {
+      const GWEN_DATE *dt;
+
+      switch (chain->keys[i]) {
+      case AB_TransactionSortKey_Date:
+        dt=AB_Transaction_GetDate(t);
+        e->values[i].i=dt?GWEN_Date_GetJulian(dt):0;
+        break;
+      case AB_TransactionSortKey_ValutaDate:
+        dt=AB_Transaction_GetValutaDate(t);
+        e->values[i].i=dt?GWEN_Date_GetJulian(dt):0;
+        break;
+      case AB_TransactionSortKey_Value:
+        e->values[i].v=AB_Transaction_GetValue(t);
+        break;
+      case AB_TransactionSortKey_BankReference:
+        e->values[i].s=AB_Transaction_GetBankReference(t);
+        break;
+      case AB_TransactionSortKey_CustomerReference:
+        e->values[i].s=AB_Transaction_GetCustomerReference(t);
+        break;
+      case AB_TransactionSortKey_FiId:
+        e->values[i].s=AB_Transaction_GetFiId(t);
+        break;
+      case AB_TransactionSortKey_UniqueId:
+        e->values[i].u=AB_Transaction_GetUniqueId(t);
+        break;
+      default:
+        break;
+      }
+    }
+    pos++;
+    t=AB_Transaction_List_Next(t);
+  }
+  run->entryCount=pos;
+}
+
+
+
+void _freeRun(AB_TRANSACTION_SORT_RUN *run)
+{
+  uint32_t i;
+
+  for (i=0; i<run->entryCount; i++)
+    free(run->entries[i].hashString);
+  free(run->entries);
+  run->entries=NULL;
+  run->entryCount=0;
+}
+
+
+
+int _compareKeys(const AB_TRANSACTION_SORT_ENTRY *e1, const AB_TRANSACTION_SORT_ENTRY *e2)
+{
+  const AB_TRANSACTION_SORT_CHAIN *chain;
+  int i;
+
+  chain=e1->chain;
+  for (i=0; i<chain->keyCount; i++) {
+    const AB_TRANSACTION_SORT_KEYVALUE *v1=&(e1->values[i]);
+    const AB_TRANSACTION_SORT_KEYVALUE *v2=&(e2->values[i]);
+    int rv=0;
+
+    switch (chain->keys[i]) {
+    case AB_TransactionSortKey_Date:
+    case AB_TransactionSortKey_ValutaDate:
+      rv=(v1->i<v2->i)?-1:((v1->i>v2->i)?1:0);
+      break;
+    case AB_TransactionSortKey_UniqueId:
+      rv=(v1->u<v2->u)?-1:((v1->u>v2->u)?1:0);
+      break;
+    case AB_TransactionSortKey_Value:
+      if (v1->v && v2->v)
+        rv=AB_Value_Compare(v1->v, v2->v);
+      else
+        rv=(v1->v)?1:((v2->v)?-1:0);
+      break;
+    default:
+      rv=strcmp(v1->s?v1->s:"", v2->s?v2->s:"");
+      break;
+    }
+
+    if (rv)
+      return chain->descending[i]?-rv:rv;
+  }
+
+  return 0;
+}
+
+
+
+int _sortByKeysAndPos(const void *a, const void *b)
+{
+  const AB_TRANSACTION_SORT_ENTRY *e1=(const AB_TRANSACTION_SORT_ENTRY *) a;
+  const AB_TRANSACTION_SORT_ENTRY *e2=(const AB_TRANSACTION_SORT_ENTRY *) b;
+  int rv;
+
+  rv=_compareKeys(e1, e2);
+  if (rv)
+    return rv;
+  return (e1->pos<e2->pos)?-1:((e1->pos>e2->pos)?1:0);
+}
+
+
+
+int _compareRunHeads(const AB_TRANSACTION_SORT_RUN *runs, uint32_t r1, uint32_t r2)
+{
+  int rv;
+
+  rv=_compareKeys(&(runs[r1].entries[runs[r1].nextEntry]), &(runs[r2].entries[runs[r2].nextEntry]));
+  if (rv)
+    return rv;
+  /* same keys: earlier lists first */
+  return (r1<r2)?-1:((r1>r2)?1:0);
+}
+
+
+
+void _heapSiftDown(const AB_TRANSACTION_SORT_RUN *runs, uint32_t *heap, uint32_t heapSize, uint32_t idx)
+{
+  for (;;) {
+    uint32_t smallest=idx;
+    uint32_t left=2*idx+1;
+    uint32_t right=2*idx+2;
+    uint32_t tmp;
+
+    if (left<heapSize && _compareRunHeads(runs, heap[left], heap[smallest])<0)
+      smallest=left;
+    if (right<heapSize && _compareRunHeads(runs, heap[right], heap[smallest])<0)
+      smallest=right;
+    if (smallest==idx)
+      break;
+    tmp=heap[idx];
+    heap[idx]=heap[smallest];
+    heap[smallest]=tmp;
+    idx=smallest;
+  }
+}
+
+
+
+int _hasSameContents(AB_TRANSACTION_SORT_ENTRY *e1, AB_TRANSACTION_SORT_ENTRY *e2)
+{
+  return (strcmp(_getHashString(e1), _getHashString(e2))==0)?1:0;
+}
+
+
+
+const char *_getHashString(AB_TRANSACTION_SORT_ENTRY *e)
+{
+  if (e->hashString==NULL) {
+    GWEN_BUFFER *buf;
+
+    buf=GWEN_Buffer_new(0, 256, 0, 1);
+    AB_Transaction_toHashString(e->transaction, buf);
+    e->hashString=strdup(GWEN_Buffer_GetStart(buf));
+    GWEN_Buffer_free(buf);
+  }
+  return e->hashString;
+}
+
+
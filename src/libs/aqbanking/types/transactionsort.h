@@ -0,0 +1,106 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+
+#ifndef AB_TRANSACTIONSORT_H
+#define AB_TRANSACTIONSORT_H
+
+
+#include <aqbanking/error.h>
+#include <aqbanking/types/transaction.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Keys for sorting lists of transactions.
+ *
+ * A key chain is an array of keys terminated by @ref AB_TransactionSortKey_None. Transactions are compared by the
+ * first key, if equal by the second key and so on. Transactions which are equal in all keys keep their order.
+ * A key can be or'ed with @ref AB_TRANSACTION_SORTKEY_DESCENDING to sort in descending order.
+ *
+ * Missing dates, values and strings are sorted before all others, strings are compared case-sensitive.
+ */
+typedef enum {
+  AB_TransactionSortKey_None=0,
+  AB_TransactionSortKey_Date,
+  AB_TransactionSortKey_ValutaDate,
+  AB_TransactionSortKey_Value,
+  AB_TransactionSortKey_BankReference,
+  AB_TransactionSortKey_CustomerReference,
+  AB_TransactionSortKey_FiId,
+  AB_TransactionSortKey_UniqueId
+} AB_TRANSACTION_SORTKEY;
+
+
+#define AB_TRANSACTION_SORTKEY_DESCENDING 0x100
+
+/** Maximum number of keys in a key chain */
+#define AB_TRANSACTION_SORT_MAXKEYS 8
+
+
+/** Sort the input lists of @ref AB_Transaction_List_MergeSorted before merging them. */
+#define AB_TRANSACTION_MERGE_FLAGS_SORT           0x00000001
+/** Don't drop duplicate transactions in @ref AB_Transaction_List_MergeSorted. */
+#define AB_TRANSACTION_MERGE_FLAGS_KEEPDUPLICATES 0x00000002
+
+
+
+/**
+ * Sort a list of transactions.
+ *
+ * The keys of all transactions are extracted into an array which is then sorted, afterwards the transactions
+ * are relinked in the new order (no transaction is copied).
+ *
+ * @return 0 if ok, GWEN_ERROR_INVALID if the key chain is invalid
+ * @param tl list to sort
+ * @param keys key chain (NULL for booking date, valuta date, bank reference)
+ */
+AQBANKING_API int AB_Transaction_List_SortByKeys(AB_TRANSACTION_LIST *tl, const int *keys);
+
+
+/**
+ * Merge sorted lists of transactions into a sorted list.
+ *
+ * All transactions of the given source lists are moved into the destination list which is sorted by the given key
+ * chain afterwards. The destination list and all source lists must already be sorted by the same key chain unless
+ * @ref AB_TRANSACTION_MERGE_FLAGS_SORT is given. Transactions which are equal in all keys keep the order of the
+ * lists: those from the destination list first, then those of the source lists in the given order.
+ *
+ * Unless @ref AB_TRANSACTION_MERGE_FLAGS_KEEPDUPLICATES is given, transactions which are equal in all keys and
+ * have the same contents (see @ref AB_Transaction_toHashString) as a transaction of another list already in the
+ * result are dropped and freed. Every transaction in the result absorbs at most one duplicate per list, so identical
+ * transactions within one list (e.g. two equal bookings on the same day) are never dropped.
+ *
+ * The source lists are empty afterwards, they are not freed.
+ *
+ * @return number of dropped duplicates, GWEN_ERROR_INVALID if the key chain is invalid
+ * @param tlDest destination list
+ * @param srcLists array of source lists (entries may be NULL)
+ * @param srcCount number of entries in srcLists (may be 0 to only sort the destination list)
+ * @param keys key chain (NULL for booking date, valuta date, bank reference)
+ * @param flags see AB_TRANSACTION_MERGE_FLAGS_SORT and AB_TRANSACTION_MERGE_FLAGS_KEEPDUPLICATES
+ */
+AQBANKING_API int AB_Transaction_List_MergeSorted(AB_TRANSACTION_LIST *tlDest,
+                                                  AB_TRANSACTION_LIST **srcLists,
+                                                  int srcCount,
+                                                  const int *keys,
+                                                  uint32_t flags);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif
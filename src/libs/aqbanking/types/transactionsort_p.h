@@ -0,0 +1,56 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+
+#ifndef AB_TRANSACTIONSORT_P_H
+#define AB_TRANSACTIONSORT_P_H
+
+#include "transactionsort.h"
+
+
+typedef struct AB_TRANSACTION_SORT_CHAIN AB_TRANSACTION_SORT_CHAIN;
+struct AB_TRANSACTION_SORT_CHAIN {
+  int keys[AB_TRANSACTION_SORT_MAXKEYS];  /* without AB_TRANSACTION_SORTKEY_DESCENDING */
+  int descending[AB_TRANSACTION_SORT_MAXKEYS];
+  int keyCount;
+};
+
+
+typedef union AB_TRANSACTION_SORT_KEYVALUE AB_TRANSACTION_SORT_KEYVALUE;
+union AB_TRANSACTION_SORT_KEYVALUE {
+  int i;               /* julian date (0 if missing) */
+  uint32_t u;          /* unique id */
+  const char *s;       /* string owned by the transaction (NULL if missing) */
+  const AB_VALUE *v;   /* value owned by the transaction (NULL if missing) */
+};
+
+
+typedef struct AB_TRANSACTION_SORT_ENTRY AB_TRANSACTION_SORT_ENTRY;
+struct AB_TRANSACTION_SORT_ENTRY {
+  AB_TRANSACTION_SORT_KEYVALUE values[AB_TRANSACTION_SORT_MAXKEYS];
+  const AB_TRANSACTION_SORT_CHAIN *chain;
+  uint32_t pos;          /* position in the list (keeps sort stable) */
+  uint32_t runIndex;     /* index of the list this entry comes from */
+  int matchedRun;        /* index of the last list of which a duplicate was dropped for this entry (-1 if none) */
+  AB_TRANSACTION *transaction;
+  char *hashString;      /* only created when needed to check for duplicates */
+};
+
+
+/* sorted entries of one list while merging */
+typedef struct AB_TRANSACTION_SORT_RUN AB_TRANSACTION_SORT_RUN;
+struct AB_TRANSACTION_SORT_RUN {
+  AB_TRANSACTION_SORT_ENTRY *entries;
+  uint32_t entryCount;
+  uint32_t nextEntry;
+};
+
+
+#endif
@@ -568,6 +568,49 @@ long int AB_Value_Denom(const AB_VALUE *v)
 
 
 
+int AB_Value_GetScaledInt64(const AB_VALUE *v, int scale, int64_t *pResult)
+{
+  mpz_t n;
+  mpz_t r;
+  uint64_t u=0;
+  int rv=0;
+
+  assert(v);
+  assert(pResult);
+
+  if (scale<0 || scale>18) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Invalid scale %d", scale);
+    return GWEN_ERROR_INVALID;
+  }
+
+  mpz_init(n);
+  mpz_init(r);
+
+  /* n=num*10^scale, then divide by denom (must leave no remainder) */
+  mpz_ui_pow_ui(n, 10, (unsigned long) scale);
+  mpz_mul(n, n, mpq_numref(v->value));
+  mpz_tdiv_qr(n, r, n, mpq_denref(v->value));
+  if (mpz_sgn(r)!=0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Value can not be represented exactly with scale %d", scale);
+    rv=GWEN_ERROR_BAD_DATA;
+  }
+  else if (mpz_sizeinbase(n, 2)>63) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Scaled value does not fit into 64 bits");
+    rv=GWEN_ERROR_BAD_DATA;
+  }
+  else {
+    /* exports the absolute value */
+    mpz_export(&u, NULL, -1, sizeof(u), 0, 0, n);
+    *pResult=(mpz_sgn(n)<0)?-((int64_t) u):((int64_t) u);
+  }
+
+  mpz_clear(r);
+  mpz_clear(n);
+  return rv;
+}
+
+
+
 void AB_Value_toHbciString(const AB_VALUE *v, GWEN_BUFFER *buf)
 {
   GWEN_BUFFER *tbuf;
@@ -129,6 +129,16 @@ AQBANKING_API long int AB_Value_Num(const AB_VALUE *v);
 /** Returns the denominator of the given rational number. */
 AQBANKING_API long int AB_Value_Denom(const AB_VALUE *v);
 
+/**
+ * Returns the value multiplied by 10^scale as a 64 bit integer (e.g. "11,9" with a scale of 2 is returned as 1190).
+ * @return 0 if ok, GWEN_ERROR_BAD_DATA if the value can not be represented exactly with the given scale or does
+ * not fit into 64 bits
+ * @param v value
+ * @param scale number of decimal digits (0-18)
+ * @param pResult pointer to a variable to receive the scaled value
+ */
+AQBANKING_API int AB_Value_GetScaledInt64(const AB_VALUE *v, int scale, int64_t *pResult);
+
 
 /** Write value to HBCI string (e.g. "11,90" is written as "11,9") */
 AQBANKING_API void AB_Value_toHbciString(const AB_VALUE *v, GWEN_BUFFER *buf);
@@ -18,6 +18,8 @@
 
 #include <aqbanking/backendsupport/provider_be.h>
 
+#include <gwenhywfar/directory.h>
+
 
 
 /* ------------------------------------------------------------------------------------------------
@@ -186,9 +188,11 @@ AQFINTS_PARSER *AF_Provider_CreateParser(AB_PROVIDER *pro)
   if (paths) {
     AQFINTS_PARSER *parser;
     GWEN_STRINGLISTENTRY *se;
+    GWEN_BUFFER *buf;
     int rv;
 
     parser=AQFINTS_Parser_new();
+    AQFINTS_Parser_SetZeroCopy(parser, 1);
 
     se=GWEN_StringList_FirstEntry(paths);
     while (se) {
@@ -202,6 +206,20 @@ AQFINTS_PARSER *AF_Provider_CreateParser(AB_PROVIDER *pro)
     }
     GWEN_StringList_free(paths);
 
+    /* cache normalized definitions in the provider's data folder */
+    buf=GWEN_Buffer_new(0, 256, 0, 1);
+    rv=AB_Provider_GetUserDataDir(pro, buf);
+    if (rv==0)
+      rv=GWEN_Directory_GetPath(GWEN_Buffer_GetStart(buf), 0);
+    if (rv==0) {
+      GWEN_Buffer_AppendString(buf, GWEN_DIR_SEPARATOR_S "definitions.cache");
+      AQFINTS_Parser_SetCacheFile(parser, GWEN_Buffer_GetStart(buf));
+    }
+    else {
+      DBG_INFO(AQFINTS_LOGDOMAIN, "No data folder for definition cache (%d), ignoring", rv);
+    }
+    GWEN_Buffer_free(buf);
+
     rv=AQFINTS_Parser_ReadFiles(parser);
     if (rv<0) {
       DBG_INFO(AQFINTS_LOGDOMAIN, "here (%d)", rv);
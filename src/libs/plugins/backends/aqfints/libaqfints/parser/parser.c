@@ -26,7 +26,45 @@
 #include <gwenhywfar/debug.h>
 #include <gwenhywfar/stringlist.h>
 #include <gwenhywfar/directory.h>
+#include <gwenhywfar/buffer.h>
 
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* increase when the format of the definition cache changes */
+#define AQFINTS_PARSER_CACHE_VERSION 1
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * forward declarations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+static int _readDefinitionFiles(AQFINTS_PARSER *parser, const GWEN_STRINGLIST *slFiles);
+static int _readCacheFile(AQFINTS_PARSER *parser, const char *fingerprint);
+static void _writeCacheFile(AQFINTS_PARSER *parser, const char *fingerprint);
+static int _getFingerprint(const GWEN_STRINGLIST *slFiles, GWEN_BUFFER *buf);
+
+static void _createIndexes(AQFINTS_PARSER *parser);
+static void _freeIndexes(AQFINTS_PARSER *parser);
+static int _segmentMatchesVersions(const AQFINTS_SEGMENT *segment, int segmentVersion, int protocolVersion);
+static int _jobDefMatchesVersions(const AQFINTS_JOBDEF *jobDef, int jobVersion, int protocolVersion);
+static AQFINTS_SEGMENT *_findSegmentInIndex(const AQFINTS_INDEX *idx, const char *name,
+                                            int segmentVersion, int protocolVersion);
+static AQFINTS_JOBDEF *_findJobDefInIndex(const AQFINTS_INDEX *idx, const char *name,
+                                          int jobVersion, int protocolVersion);
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * implementations
+ * ------------------------------------------------------------------------------------------------
+ */
 
 
 
@@ -48,6 +86,8 @@ AQFINTS_PARSER *AQFINTS_Parser_new()
 void AQFINTS_Parser_free(AQFINTS_PARSER *parser)
 {
   if (parser) {
+    _freeIndexes(parser);
+    free(parser->cacheFile);
     GWEN_StringList_free(parser->pathList);
     AQFINTS_Segment_List_free(parser->segmentList);
     AQFINTS_JobDef_List_free(parser->jobDefList);
@@ -67,15 +107,38 @@ void AQFINTS_Parser_AddPath(AQFINTS_PARSER *parser, const char *path)
 
 
 
+void AQFINTS_Parser_SetZeroCopy(AQFINTS_PARSER *parser, int b)
+{
+  assert(parser);
+  parser->zeroCopy=b;
+}
+
+
+
+int AQFINTS_Parser_GetZeroCopy(const AQFINTS_PARSER *parser)
+{
+  assert(parser);
+  return parser->zeroCopy;
+}
+
+
+
+void AQFINTS_Parser_SetCacheFile(AQFINTS_PARSER *parser, const char *filename)
+{
+  assert(parser);
+  free(parser->cacheFile);
+  parser->cacheFile=(filename && *filename)?strdup(filename):NULL;
+}
+
+
+
 int AQFINTS_Parser_ReadFiles(AQFINTS_PARSER *parser)
 {
   GWEN_STRINGLIST *slFiles;
   GWEN_STRINGLISTENTRY *slEntry;
-  AQFINTS_ELEMENT *groupTree;
-  int filesLoaded=0;
+  int rv;
 
   slFiles=GWEN_StringList_new();
-  groupTree=AQFINTS_Element_new();
 
   /* sample file names */
   slEntry=GWEN_StringList_FirstEntry(parser->pathList);
@@ -84,8 +147,6 @@ int AQFINTS_Parser_ReadFiles(AQFINTS_PARSER *parser)
 
     s=GWEN_StringListEntry_Data(slEntry);
     if (s && *s) {
-      int rv;
-
       rv=GWEN_Directory_GetMatchingFilesRecursively(s, slFiles, "*.fints");
       if (rv<0) {
         DBG_ERROR(AQFINTS_PARSER_LOGDOMAIN, "Error reading file names from \"%s\", ignoring", s);
@@ -98,10 +159,48 @@ int AQFINTS_Parser_ReadFiles(AQFINTS_PARSER *parser)
   if (GWEN_StringList_Count(slFiles)<1) {
     DBG_ERROR(AQFINTS_PARSER_LOGDOMAIN, "No files found to load");
     GWEN_StringList_free(slFiles);
-    AQFINTS_Element_free(groupTree);
     return GWEN_ERROR_GENERIC;
   }
 
+  if (parser->cacheFile) {
+    GWEN_BUFFER *fpBuffer;
+
+    fpBuffer=GWEN_Buffer_new(0, 64, 0, 1);
+    if (_getFingerprint(slFiles, fpBuffer)<0) {
+      /* can't tell whether the cache is current, don't use it */
+      rv=_readDefinitionFiles(parser, slFiles);
+    }
+    else if (_readCacheFile(parser, GWEN_Buffer_GetStart(fpBuffer))<0) {
+      rv=_readDefinitionFiles(parser, slFiles);
+      if (rv==0)
+        _writeCacheFile(parser, GWEN_Buffer_GetStart(fpBuffer));
+    }
+    else
+      rv=0;
+    GWEN_Buffer_free(fpBuffer);
+  }
+  else
+    rv=_readDefinitionFiles(parser, slFiles);
+  GWEN_StringList_free(slFiles);
+  if (rv<0) {
+    DBG_INFO(AQFINTS_PARSER_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  _createIndexes(parser);
+  return 0;
+}
+
+
+
+int _readDefinitionFiles(AQFINTS_PARSER *parser, const GWEN_STRINGLIST *slFiles)
+{
+  GWEN_STRINGLISTENTRY *slEntry;
+  AQFINTS_ELEMENT *groupTree;
+  int filesLoaded=0;
+
+  groupTree=AQFINTS_Element_new();
+
   /* load files */
   slEntry=GWEN_StringList_FirstEntry(slFiles);
   while (slEntry) {
@@ -123,7 +222,6 @@ int AQFINTS_Parser_ReadFiles(AQFINTS_PARSER *parser)
   }
   if (filesLoaded<1) {
     DBG_ERROR(AQFINTS_PARSER_LOGDOMAIN, "No files loaded");
-    GWEN_StringList_free(slFiles);
     AQFINTS_Element_free(groupTree);
     return GWEN_ERROR_GENERIC;
   }
@@ -133,19 +231,211 @@ int AQFINTS_Parser_ReadFiles(AQFINTS_PARSER *parser)
   AQFINTS_Parser_SegmentList_Normalize(parser->segmentList);
 
   /* cleanup */
-  GWEN_StringList_free(slFiles);
   AQFINTS_Element_free(groupTree);
   return 0;
 }
 
 
 
+int _readCacheFile(AQFINTS_PARSER *parser, const char *fingerprint)
+{
+  int rv;
+
+  if (GWEN_Directory_GetPath(parser->cacheFile, GWEN_PATH_FLAGS_NAMEMUSTEXIST | GWEN_PATH_FLAGS_VARIABLE))
+    return GWEN_ERROR_NOT_FOUND;
+
+  rv=AQFINTS_Parser_Xml_ReadDefinitionCacheFile(parser->jobDefList, parser->segmentList, fingerprint,
+                                                parser->cacheFile);
+  if (rv<0) {
+    DBG_INFO(AQFINTS_PARSER_LOGDOMAIN, "Not using definition cache \"%s\" (%d)", parser->cacheFile, rv);
+    return rv;
+  }
+
+  if (AQFINTS_Segment_List_GetCount(parser->segmentList)<1) {
+    DBG_INFO(AQFINTS_PARSER_LOGDOMAIN, "Empty definition cache \"%s\", ignoring", parser->cacheFile);
+    AQFINTS_Segment_List_Clear(parser->segmentList);
+    AQFINTS_JobDef_List_Clear(parser->jobDefList);
+    return GWEN_ERROR_NO_DATA;
+  }
+
+  DBG_INFO(AQFINTS_PARSER_LOGDOMAIN, "Definitions read from cache \"%s\"", parser->cacheFile);
+  return 0;
+}
+
+
+
+void _writeCacheFile(AQFINTS_PARSER *parser, const char *fingerprint)
+{
+  int rv;
+
+  rv=AQFINTS_Parser_Xml_WriteDefinitionCacheFile(parser->jobDefList, parser->segmentList, fingerprint,
+                                                 parser->cacheFile);
+  if (rv<0) {
+    DBG_WARN(AQFINTS_PARSER_LOGDOMAIN, "Could not write definition cache \"%s\" (%d), ignoring", parser->cacheFile, rv);
+  }
+}
+
+
+
+int _getFingerprint(const GWEN_STRINGLIST *slFiles, GWEN_BUFFER *buf)
+{
+  GWEN_STRINGLISTENTRY *slEntry;
+  uint32_t hash=2166136261U;
+  uint32_t fileCount=0;
+  char numbuf[64];
+
+  /* FNV-1a over names, sizes and modification times of all definition files (in load order) */
+  slEntry=GWEN_StringList_FirstEntry(slFiles);
+  while (slEntry) {
+    const char *s;
+
+    s=GWEN_StringListEntry_Data(slEntry);
+    if (s && *s) {
+      struct stat st;
+      const char *p;
+
+      if (stat(s, &st)!=0) {
+        DBG_INFO(AQFINTS_PARSER_LOGDOMAIN, "Could not stat \"%s\"", s);
+        return GWEN_ERROR_IO;
+      }
+      snprintf(numbuf, sizeof(numbuf)-1, ":%lu:%lu;", (unsigned long) st.st_size, (unsigned long) st.st_mtime);
+      numbuf[sizeof(numbuf)-1]=0;
+      for (p=s; *p; p++) {
+        hash^=(uint8_t)(*p);
+        hash*=16777619U;
+      }
+      for (p=numbuf; *p; p++) {
+        hash^=(uint8_t)(*p);
+        hash*=16777619U;
+      }
+      fileCount++;
+    }
+    slEntry=GWEN_StringListEntry_Next(slEntry);
+  }
+
+  snprintf(numbuf, sizeof(numbuf)-1, "%d-%lu-%08lx",
+           AQFINTS_PARSER_CACHE_VERSION, (unsigned long) fileCount, (unsigned long) hash);
+  numbuf[sizeof(numbuf)-1]=0;
+  GWEN_Buffer_AppendString(buf, numbuf);
+  return 0;
+}
+
+
+
+void _createIndexes(AQFINTS_PARSER *parser)
+{
+  AQFINTS_SEGMENT *segment;
+  AQFINTS_JOBDEF *jobDef;
+  uint32_t cnt;
+
+  _freeIndexes(parser);
+
+  cnt=AQFINTS_Segment_List_GetCount(parser->segmentList);
+  parser->segmentsByCode=AQFINTS_Index_new(cnt);
+  parser->segmentsById=AQFINTS_Index_new(cnt);
+  segment=AQFINTS_Segment_List_First(parser->segmentList);
+  while (segment) {
+    AQFINTS_Index_Add(parser->segmentsByCode, AQFINTS_Segment_GetCode(segment), segment);
+    AQFINTS_Index_Add(parser->segmentsById, AQFINTS_Segment_GetId(segment), segment);
+    segment=AQFINTS_Segment_List_Next(segment);
+  }
+
+  cnt=AQFINTS_JobDef_List_GetCount(parser->jobDefList);
+  parser->jobDefsByCode=AQFINTS_Index_new(cnt);
+  parser->jobDefsById=AQFINTS_Index_new(cnt);
+  parser->jobDefsByParams=AQFINTS_Index_new(cnt);
+  jobDef=AQFINTS_JobDef_List_First(parser->jobDefList);
+  while (jobDef) {
+    AQFINTS_Index_Add(parser->jobDefsByCode, AQFINTS_JobDef_GetCode(jobDef), jobDef);
+    AQFINTS_Index_Add(parser->jobDefsById, AQFINTS_JobDef_GetId(jobDef), jobDef);
+    AQFINTS_Index_Add(parser->jobDefsByParams, AQFINTS_JobDef_GetParamsSegmentCode(jobDef), jobDef);
+    jobDef=AQFINTS_JobDef_List_Next(jobDef);
+  }
+}
+
+
+
+void _freeIndexes(AQFINTS_PARSER *parser)
+{
+  AQFINTS_Index_free(parser->jobDefsByParams);
+  parser->jobDefsByParams=NULL;
+  AQFINTS_Index_free(parser->jobDefsById);
+  parser->jobDefsById=NULL;
+  AQFINTS_Index_free(parser->jobDefsByCode);
+  parser->jobDefsByCode=NULL;
+  AQFINTS_Index_free(parser->segmentsById);
+  parser->segmentsById=NULL;
+  AQFINTS_Index_free(parser->segmentsByCode);
+  parser->segmentsByCode=NULL;
+}
+
+
+
+int _segmentMatchesVersions(const AQFINTS_SEGMENT *segment, int segmentVersion, int protocolVersion)
+{
+  return ((segmentVersion==0 || segmentVersion==AQFINTS_Segment_GetSegmentVersion(segment)) &&
+          (protocolVersion==0 || protocolVersion==AQFINTS_Segment_GetProtocolVersion(segment)));
+}
+
+
+
+int _jobDefMatchesVersions(const AQFINTS_JOBDEF *jobDef, int jobVersion, int protocolVersion)
+{
+  return ((jobVersion==0 || jobVersion==AQFINTS_JobDef_GetJobVersion(jobDef)) &&
+          (protocolVersion==0 || protocolVersion==AQFINTS_JobDef_GetProtocolVersion(jobDef)));
+}
+
+
+
+AQFINTS_SEGMENT *_findSegmentInIndex(const AQFINTS_INDEX *idx, const char *name,
+                                     int segmentVersion, int protocolVersion)
+{
+  const AQFINTS_INDEX_ENTRY *entry;
+
+  entry=AQFINTS_Index_FindFirst(idx, name);
+  while (entry) {
+    AQFINTS_SEGMENT *segment;
+
+    segment=(AQFINTS_SEGMENT *) AQFINTS_IndexEntry_GetPointer(entry);
+    if (_segmentMatchesVersions(segment, segmentVersion, protocolVersion))
+      return segment;
+    entry=AQFINTS_IndexEntry_FindNext(entry);
+  }
+
+  return NULL;
+}
+
+
+
+AQFINTS_JOBDEF *_findJobDefInIndex(const AQFINTS_INDEX *idx, const char *name,
+                                   int jobVersion, int protocolVersion)
+{
+  const AQFINTS_INDEX_ENTRY *entry;
+
+  entry=AQFINTS_Index_FindFirst(idx, name);
+  while (entry) {
+    AQFINTS_JOBDEF *jobDef;
+
+    jobDef=(AQFINTS_JOBDEF *) AQFINTS_IndexEntry_GetPointer(entry);
+    if (_jobDefMatchesVersions(jobDef, jobVersion, protocolVersion))
+      return jobDef;
+    entry=AQFINTS_IndexEntry_FindNext(entry);
+  }
+
+  return NULL;
+}
+
+
+
 
 AQFINTS_SEGMENT *AQFINTS_Parser_FindSegmentByCode(const AQFINTS_PARSER *parser, const char *id, int segmentVersion,
                                                   int protocolVersion)
 {
   AQFINTS_SEGMENT *segment;
 
+  if (parser->segmentsByCode && id && *id)
+    return _findSegmentInIndex(parser->segmentsByCode, id, segmentVersion, protocolVersion);
+
   segment=AQFINTS_Segment_List_First(parser->segmentList);
   while (segment) {
     if ((segmentVersion==0 || segmentVersion==AQFINTS_Segment_GetSegmentVersion(segment)) &&
@@ -173,6 +463,9 @@ AQFINTS_SEGMENT *AQFINTS_Parser_FindSegmentById(const AQFINTS_PARSER *parser, co
 {
   AQFINTS_SEGMENT *segment;
 
+  if (parser->segmentsById && id && *id)
+    return _findSegmentInIndex(parser->segmentsById, id, segmentVersion, protocolVersion);
+
   segment=AQFINTS_Segment_List_First(parser->segmentList);
   while (segment) {
     if ((segmentVersion==0 || segmentVersion==AQFINTS_Segment_GetSegmentVersion(segment)) &&
@@ -203,6 +496,22 @@ AQFINTS_SEGMENT *AQFINTS_Parser_FindSegmentHighestVersionForProto(const AQFINTS_
   AQFINTS_SEGMENT *bestMatchSoFar=NULL;
 
   assert((id && *id));
+  if (parser->segmentsByCode) {
+    const AQFINTS_INDEX_ENTRY *entry;
+
+    entry=AQFINTS_Index_FindFirst(parser->segmentsByCode, id);
+    while (entry) {
+      segment=(AQFINTS_SEGMENT *) AQFINTS_IndexEntry_GetPointer(entry);
+      if (protocolVersion==0 || (protocolVersion>=AQFINTS_Segment_GetProtocolVersion(segment))) {
+        if (bestMatchSoFar==NULL ||
+            AQFINTS_Segment_GetSegmentVersion(segment)>AQFINTS_Segment_GetSegmentVersion(bestMatchSoFar))
+          bestMatchSoFar=segment;
+      }
+      entry=AQFINTS_IndexEntry_FindNext(entry);
+    }
+    return bestMatchSoFar;
+  }
+
   segment=AQFINTS_Segment_List_First(parser->segmentList);
   while (segment) {
     int possibleMatch=0;
@@ -260,6 +569,9 @@ AQFINTS_JOBDEF *AQFINTS_Parser_FindJobDefByCode(const AQFINTS_PARSER *parser, co
 {
   AQFINTS_JOBDEF *jobDef;
 
+  if (parser->jobDefsByCode && id && *id)
+    return _findJobDefInIndex(parser->jobDefsByCode, id, jobVersion, protocolVersion);
+
   jobDef=AQFINTS_JobDef_List_First(parser->jobDefList);
   while (jobDef) {
     if ((jobVersion==0 || jobVersion==AQFINTS_JobDef_GetJobVersion(jobDef)) &&
@@ -287,6 +599,9 @@ AQFINTS_JOBDEF *AQFINTS_Parser_FindJobDefById(const AQFINTS_PARSER *parser, cons
 {
   AQFINTS_JOBDEF *jobDef;
 
+  if (parser->jobDefsById && id && *id)
+    return _findJobDefInIndex(parser->jobDefsById, id, jobVersion, protocolVersion);
+
   jobDef=AQFINTS_JobDef_List_First(parser->jobDefList);
   while (jobDef) {
     if ((jobVersion==0 || jobVersion==AQFINTS_JobDef_GetJobVersion(jobDef)) &&
@@ -314,6 +629,9 @@ AQFINTS_JOBDEF *AQFINTS_Parser_FindJobDefByParams(const AQFINTS_PARSER *parser,
 {
   AQFINTS_JOBDEF *jobDef;
 
+  if (parser->jobDefsByParams && params && *params)
+    return _findJobDefInIndex(parser->jobDefsByParams, params, jobVersion, protocolVersion);
+
   jobDef=AQFINTS_JobDef_List_First(parser->jobDefList);
   while (jobDef) {
     if ((jobVersion==0 || jobVersion==AQFINTS_JobDef_GetJobVersion(jobDef)) &&
@@ -390,7 +708,8 @@ int AQFINTS_Parser_ReadIntoSegmentList(AQFINTS_PARSER *parser,
 {
   int rv;
 
-  rv=AQFINTS_Parser_Hbci_ReadBuffer(targetSegmentList, ptrBuf, lenBuf);
+  rv=AQFINTS_Parser_Hbci_ReadBufferWithFlags(targetSegmentList, ptrBuf, lenBuf,
+                                             parser->zeroCopy?AQFINTS_PARSER_HBCI_FLAGS_ZEROCOPY:0);
   if (rv<0) {
     DBG_INFO(AQFINTS_PARSER_LOGDOMAIN, "here (%d)", rv);
     return rv;
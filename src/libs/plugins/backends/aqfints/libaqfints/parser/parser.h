@@ -47,6 +47,19 @@ void AQFINTS_Parser_free(AQFINTS_PARSER *parser);
  */
 /*@{*/
 
+/**
+ * Enable or disable zero-copy mode for reading HBCI messages (disabled by default).
+ *
+ * In zero-copy mode the elements of segments read reference slices of a single copy of the raw segment
+ * instead of holding a copy of their data. Strings are unescaped and copied only when accessed.
+ * This avoids an allocation per DE when reading large messages (e.g. statement responses).
+ *
+ * Elements of segments read in this mode must be materialized (see @ref AQFINTS_Element_Materialize) before
+ * they are duplicated or removed from their segment.
+ */
+void AQFINTS_Parser_SetZeroCopy(AQFINTS_PARSER *parser, int b);
+int AQFINTS_Parser_GetZeroCopy(const AQFINTS_PARSER *parser);
+
 /**
  * Read a HBCI message from a buffer into a GWEN_DB_NODE.
  *
@@ -125,12 +138,27 @@ int AQFINTS_Parser_WriteSegment(AQFINTS_PARSER *parser, AQFINTS_SEGMENT *segment
 void AQFINTS_Parser_AddPath(AQFINTS_PARSER *parser, const char *path);
 
 
+/**
+ * Set the file used to cache the definitions read by @ref AQFINTS_Parser_ReadFiles().
+ *
+ * The cache contains the segment and job definitions with groups already resolved and normalized, so they don't
+ * have to be created again from the *.fints files. The cache is only used if the list of definition files found
+ * (including sizes and modification times) is unchanged since the cache has been written, otherwise it is
+ * recreated.
+ *
+ * @param parser parser object
+ * @param filename path and name of the cache file (NULL to disable caching)
+ */
+void AQFINTS_Parser_SetCacheFile(AQFINTS_PARSER *parser, const char *filename);
+
+
 /**
  * Read files from the folders specified via @ref AQFINTS_Parser_AddPath().
  *
  * Adding paths after calling this function here has no effect.
  * Only returns an error if no file could be loaded (either because of errors or because there was no file to load).
  * This function is used to load segment and job definitions for the parser.
+ * Afterwards indexes are created which are used by the AQFINTS_Parser_Find* functions.
  *
  * @return 0 if okay, errorcode otherwise
  * @param parser parser object
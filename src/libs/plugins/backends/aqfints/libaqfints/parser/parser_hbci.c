@@ -32,11 +32,14 @@
  * ------------------------------------------------------------------------------------------------
  */
 
-static int readSeg(AQFINTS_SEGMENT *targetSegment, const uint8_t *ptrBuf, uint32_t lenBuf);
-static int readDeg(AQFINTS_ELEMENT *targetElement, const uint8_t *ptrBuf, uint32_t lenBuf);
-static int readDe(AQFINTS_ELEMENT *targetElement, const uint8_t *ptrBuf, uint32_t lenBuf);
+/* ptrSegStart: begin of the current segment in zero-copy mode, NULL otherwise */
+static int readSeg(AQFINTS_SEGMENT *targetSegment, const uint8_t *ptrSegStart, const uint8_t *ptrBuf, uint32_t lenBuf);
+static int readDeg(AQFINTS_ELEMENT *targetElement, const uint8_t *ptrSegStart, const uint8_t *ptrBuf, uint32_t lenBuf);
+static int readDe(AQFINTS_ELEMENT *targetElement, const uint8_t *ptrSegStart, const uint8_t *ptrBuf, uint32_t lenBuf);
 static int readString(AQFINTS_ELEMENT *targetElement, const uint8_t *ptrBuf, uint32_t lenBuf);
-static int readBin(AQFINTS_ELEMENT *targetElement, const uint8_t *ptrBuf, uint32_t lenBuf);
+static int readStringRaw(AQFINTS_ELEMENT *targetElement, const uint8_t *ptrSegStart, const uint8_t *ptrBuf,
+                         uint32_t lenBuf);
+static int readBin(AQFINTS_ELEMENT *targetElement, const uint8_t *ptrSegStart, const uint8_t *ptrBuf, uint32_t lenBuf);
 static void parseSegHeader(AQFINTS_SEGMENT *segment);
 
 static void writeDegSequence(AQFINTS_ELEMENT *element, GWEN_BUFFER *destBuf, int elementCount,
@@ -62,6 +65,16 @@ static void writeString(const char *s, GWEN_BUFFER *destBuf);
 int AQFINTS_Parser_Hbci_ReadBuffer(AQFINTS_SEGMENT_LIST *targetSegmentList,
                                    const uint8_t *ptrBuf,
                                    uint32_t lenBuf)
+{
+  return AQFINTS_Parser_Hbci_ReadBufferWithFlags(targetSegmentList, ptrBuf, lenBuf, 0);
+}
+
+
+
+int AQFINTS_Parser_Hbci_ReadBufferWithFlags(AQFINTS_SEGMENT_LIST *targetSegmentList,
+                                            const uint8_t *ptrBuf,
+                                            uint32_t lenBuf,
+                                            uint32_t flags)
 {
   uint32_t origLenBuf;
 
@@ -73,31 +86,42 @@ int AQFINTS_Parser_Hbci_ReadBuffer(AQFINTS_SEGMENT_LIST *targetSegmentList,
 
     targetSegment=AQFINTS_Segment_new();
 
-    rv=readSeg(targetSegment, ptrBuf, lenBuf);
+    rv=readSeg(targetSegment, (flags & AQFINTS_PARSER_HBCI_FLAGS_ZEROCOPY)?ptrBuf:NULL, ptrBuf, lenBuf);
     if (rv<0) {
       DBG_INFO(AQFINTS_PARSER_LOGDOMAIN, "here (%d)", rv);
       AQFINTS_Segment_free(targetSegment);
       return rv;
     }
-    parseSegHeader(targetSegment);
-
-    AQFINTS_Parser_Segment_RemoveTrailingEmptyElements(targetSegment);
-
-    AQFINTS_Segment_List_Add(targetSegment, targetSegmentList);
 
-    /* store copy of segment data */
+    /* store copy of segment data (needed before accessing any DE in zero-copy mode) */
     if (lenBuf>rv) {
       if (ptrBuf[rv]!='\'') {
         DBG_ERROR(AQFINTS_PARSER_LOGDOMAIN, "Segment not terminated by quotation mark");
+        AQFINTS_Segment_free(targetSegment);
         return GWEN_ERROR_BAD_DATA;
       }
-      AQFINTS_Segment_SetDataAsCopy(targetSegment, ptrBuf, rv+1);
+      if (flags & AQFINTS_PARSER_HBCI_FLAGS_ZEROCOPY) {
+        AQFINTS_ELEMENT *rootElement;
+
+        rootElement=AQFINTS_Segment_GetElements(targetSegment);
+        AQFINTS_Element_SetDataCopy(rootElement, ptrBuf, rv+1);
+        AQFINTS_Element_AddRuntimeFlags(rootElement, AQFINTS_ELEMENT_RTFLAGS_RAWSOURCE);
+      }
+      else
+        AQFINTS_Segment_SetDataAsCopy(targetSegment, ptrBuf, rv+1);
     }
     else {
       DBG_ERROR(AQFINTS_PARSER_LOGDOMAIN, "Segment too small (no room for terminating quotation mark)");
+      AQFINTS_Segment_free(targetSegment);
       return GWEN_ERROR_BAD_DATA;
     }
 
+    parseSegHeader(targetSegment);
+
+    AQFINTS_Parser_Segment_RemoveTrailingEmptyElements(targetSegment);
+
+    AQFINTS_Segment_List_Add(targetSegment, targetSegmentList);
+
     /* advance pointer and size */
     lenBuf-=rv;
     ptrBuf+=rv;
@@ -221,7 +245,7 @@ void parseSegHeader(AQFINTS_SEGMENT *segment)
 
 
 
-int readSeg(AQFINTS_SEGMENT *targetSegment, const uint8_t *ptrBuf, uint32_t lenBuf)
+int readSeg(AQFINTS_SEGMENT *targetSegment, const uint8_t *ptrSegStart, const uint8_t *ptrBuf, uint32_t lenBuf)
 {
   AQFINTS_ELEMENT *targetElement;
   uint32_t origLenBuf;
@@ -244,7 +268,7 @@ int readSeg(AQFINTS_SEGMENT *targetSegment, const uint8_t *ptrBuf, uint32_t lenB
     AQFINTS_Element_SetElementType(targetDegElement, AQFINTS_ElementType_Deg);
 
 
-    rv=readDeg(targetDegElement, ptrBuf, lenBuf);
+    rv=readDeg(targetDegElement, ptrSegStart, ptrBuf, lenBuf);
     if (rv<0) {
       DBG_INFO(AQFINTS_PARSER_LOGDOMAIN, "here (%d)", rv);
       AQFINTS_Element_free(targetDegElement);
@@ -272,7 +296,7 @@ int readSeg(AQFINTS_SEGMENT *targetSegment, const uint8_t *ptrBuf, uint32_t lenB
 
 
 
-int readDeg(AQFINTS_ELEMENT *targetElement, const uint8_t *ptrBuf, uint32_t lenBuf)
+int readDeg(AQFINTS_ELEMENT *targetElement, const uint8_t *ptrSegStart, const uint8_t *ptrBuf, uint32_t lenBuf)
 {
   uint32_t origLenBuf;
 
@@ -286,7 +310,7 @@ int readDeg(AQFINTS_ELEMENT *targetElement, const uint8_t *ptrBuf, uint32_t lenB
     AQFINTS_Element_SetElementType(targetDeElement, AQFINTS_ElementType_De);
 
 
-    rv=readDe(targetDeElement, ptrBuf, lenBuf);
+    rv=readDe(targetDeElement, ptrSegStart, ptrBuf, lenBuf);
     if (rv<0) {
       DBG_INFO(AQFINTS_PARSER_LOGDOMAIN, "here (%d)", rv);
       AQFINTS_Element_free(targetDeElement);
@@ -315,13 +339,13 @@ int readDeg(AQFINTS_ELEMENT *targetElement, const uint8_t *ptrBuf, uint32_t lenB
 
 
 
-int readDe(AQFINTS_ELEMENT *targetElement, const uint8_t *ptrBuf, uint32_t lenBuf)
+int readDe(AQFINTS_ELEMENT *targetElement, const uint8_t *ptrSegStart, const uint8_t *ptrBuf, uint32_t lenBuf)
 {
   if (lenBuf) {
     if (*ptrBuf=='@') {
       int rv;
 
-      rv=readBin(targetElement, ptrBuf, lenBuf);
+      rv=readBin(targetElement, ptrSegStart, ptrBuf, lenBuf);
       if (rv<0) {
         DBG_INFO(AQFINTS_PARSER_LOGDOMAIN, "here (%d)", rv);
         return rv;
@@ -331,7 +355,10 @@ int readDe(AQFINTS_ELEMENT *targetElement, const uint8_t *ptrBuf, uint32_t lenBu
     else {
       int rv;
 
-      rv=readString(targetElement, ptrBuf, lenBuf);
+      if (ptrSegStart)
+        rv=readStringRaw(targetElement, ptrSegStart, ptrBuf, lenBuf);
+      else
+        rv=readString(targetElement, ptrBuf, lenBuf);
       if (rv<0) {
         DBG_INFO(AQFINTS_PARSER_LOGDOMAIN, "here (%d)", rv);
         return rv;
@@ -390,7 +417,48 @@ int readString(AQFINTS_ELEMENT *targetElement, const uint8_t *ptrBuf, uint32_t l
 
 
 
-int readBin(AQFINTS_ELEMENT *targetElement, const uint8_t *ptrBuf, uint32_t lenBuf)
+int readStringRaw(AQFINTS_ELEMENT *targetElement, const uint8_t *ptrSegStart, const uint8_t *ptrBuf,
+                  uint32_t lenBuf)
+{
+  uint32_t origLenBuf;
+  const uint8_t *ptrStart;
+
+  origLenBuf=lenBuf;
+  ptrStart=ptrBuf;
+
+  /* only find the end of the string, unescaping is done when the data is accessed */
+  while (*ptrBuf && lenBuf) {
+    switch (*ptrBuf) {
+    case '\'':
+    case '+':
+    case ':':
+      /* end of segment, DEG or DE reached */
+      AQFINTS_Element_SetRawData(targetElement, (uint32_t)(ptrStart-ptrSegStart), (uint32_t)(ptrBuf-ptrStart));
+      return (int)(origLenBuf-lenBuf);
+    case '?':
+      /* escape character */
+      ptrBuf++;
+      lenBuf--;
+      if (!(lenBuf && *ptrBuf)) {
+        DBG_ERROR(AQFINTS_PARSER_LOGDOMAIN, "Premature end of data (question mark was last character)");
+        return GWEN_ERROR_BAD_DATA;
+      }
+      break;
+    default:
+      break;
+    } /* switch */
+
+    ptrBuf++;
+    lenBuf--;
+  } /* while */
+
+  DBG_ERROR(AQFINTS_PARSER_LOGDOMAIN, "No delimiter at end of data");
+  return GWEN_ERROR_BAD_DATA;
+}
+
+
+
+int readBin(AQFINTS_ELEMENT *targetElement, const uint8_t *ptrSegStart, const uint8_t *ptrBuf, uint32_t lenBuf)
 {
   uint32_t origLenBuf;
 
@@ -419,8 +487,12 @@ int readBin(AQFINTS_ELEMENT *targetElement, const uint8_t *ptrBuf, uint32_t lenB
         return GWEN_ERROR_BAD_DATA;
       }
 
-      if (lenBinary)
-        AQFINTS_Element_SetDataCopy(targetElement, ptrBuf, lenBinary);
+      if (lenBinary) {
+        if (ptrSegStart)
+          AQFINTS_Element_SetRawData(targetElement, (uint32_t)(ptrBuf-ptrSegStart), lenBinary);
+        else
+          AQFINTS_Element_SetDataCopy(targetElement, ptrBuf, lenBinary);
+      }
       AQFINTS_Element_AddFlags(targetElement, AQFINTS_ELEMENT_FLAGS_ISBIN);
       ptrBuf+=lenBinary;
       lenBuf-=lenBinary;
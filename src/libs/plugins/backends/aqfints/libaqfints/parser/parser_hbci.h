@@ -17,9 +17,22 @@
 
 
 
+/**
+ * Don't copy the data of every DE. Instead a single copy of the raw segment is stored with the root element of
+ * the segment and the DEs reference slices of it (see @ref AQFINTS_Element_SetRawData). Strings are only
+ * unescaped and copied when accessed, binary data is returned directly from the raw segment.
+ */
+#define AQFINTS_PARSER_HBCI_FLAGS_ZEROCOPY 0x00000001
+
+
 int AQFINTS_Parser_Hbci_ReadBuffer(AQFINTS_SEGMENT_LIST *targetSegmentList,
                                    const uint8_t *ptrBuf,
                                    uint32_t lenBuf);
+
+int AQFINTS_Parser_Hbci_ReadBufferWithFlags(AQFINTS_SEGMENT_LIST *targetSegmentList,
+                                            const uint8_t *ptrBuf,
+                                            uint32_t lenBuf,
+                                            uint32_t flags);
 void AQFINTS_Parser_Hbci_WriteBuffer(AQFINTS_SEGMENT_LIST *segmentList);
 
 void AQFINTS_Parser_Hbci_SampleSegmentBuffers(AQFINTS_SEGMENT_LIST *segmentList, GWEN_BUFFER *destBuf);
@@ -0,0 +1,184 @@
+/***************************************************************************
+ begin       : Mon Oct 19 2026
+ copyright   : (C) 2026 by Martin Preuss
+ email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+
+#include "parser_index_p.h"
+
+#include <gwenhywfar/misc.h>
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * forward declarations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+
+static uint32_t _hashName(const char *name);
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * implementations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+
+
+AQFINTS_INDEX *AQFINTS_Index_new(uint32_t expectedEntries)
+{
+  AQFINTS_INDEX *idx;
+  uint32_t bucketCount=16;
+
+  /* keep the load factor at or below 0.5 */
+  while (bucketCount<2*expectedEntries && bucketCount<(1U<<20))
+    bucketCount<<=1;
+
+  GWEN_NEW_OBJECT(AQFINTS_INDEX, idx);
+  idx->bucketCount=bucketCount;
+  idx->firstEntries=(AQFINTS_INDEX_ENTRY **) calloc(bucketCount, sizeof(AQFINTS_INDEX_ENTRY *));
+  idx->lastEntries=(AQFINTS_INDEX_ENTRY **) calloc(bucketCount, sizeof(AQFINTS_INDEX_ENTRY *));
+  assert(idx->firstEntries);
+  assert(idx->lastEntries);
+
+  return idx;
+}
+
+
+
+void AQFINTS_Index_free(AQFINTS_INDEX *idx)
+{
+  if (idx) {
+    uint32_t i;
+
+    for (i=0; i<idx->bucketCount; i++) {
+      AQFINTS_INDEX_ENTRY *entry;
+
+      entry=idx->firstEntries[i];
+      while (entry) {
+        AQFINTS_INDEX_ENTRY *nextEntry;
+
+        nextEntry=entry->next;
+        free(entry->name);
+        GWEN_FREE_OBJECT(entry);
+        entry=nextEntry;
+      }
+    }
+    free(idx->lastEntries);
+    free(idx->firstEntries);
+    GWEN_FREE_OBJECT(idx);
+  }
+}
+
+
+
+void AQFINTS_Index_Add(AQFINTS_INDEX *idx, const char *name, void *ptr)
+{
+  assert(idx);
+  if (name && *name) {
+    AQFINTS_INDEX_ENTRY *entry;
+    uint32_t bucket;
+
+    GWEN_NEW_OBJECT(AQFINTS_INDEX_ENTRY, entry);
+    entry->hash=_hashName(name);
+    entry->name=strdup(name);
+    entry->ptr=ptr;
+
+    /* append to keep the order in which entries were added */
+    bucket=entry->hash & (idx->bucketCount-1);
+    if (idx->lastEntries[bucket])
+      idx->lastEntries[bucket]->next=entry;
+    else
+      idx->firstEntries[bucket]=entry;
+    idx->lastEntries[bucket]=entry;
+    idx->entryCount++;
+  }
+}
+
+
+
+uint32_t AQFINTS_Index_GetCount(const AQFINTS_INDEX *idx)
+{
+  assert(idx);
+  return idx->entryCount;
+}
+
+
+
+const AQFINTS_INDEX_ENTRY *AQFINTS_Index_FindFirst(const AQFINTS_INDEX *idx, const char *name)
+{
+  assert(idx);
+  if (name && *name) {
+    const AQFINTS_INDEX_ENTRY *entry;
+    uint32_t hash;
+
+    hash=_hashName(name);
+    entry=idx->firstEntries[hash & (idx->bucketCount-1)];
+    while (entry) {
+      if (entry->hash==hash && strcasecmp(entry->name, name)==0)
+        return entry;
+      entry=entry->next;
+    }
+  }
+
+  return NULL;
+}
+
+
+
+const AQFINTS_INDEX_ENTRY *AQFINTS_IndexEntry_FindNext(const AQFINTS_INDEX_ENTRY *entry)
+{
+  const AQFINTS_INDEX_ENTRY *nextEntry;
+
+  assert(entry);
+  nextEntry=entry->next;
+  while (nextEntry) {
+    if (nextEntry->hash==entry->hash && strcasecmp(nextEntry->name, entry->name)==0)
+      return nextEntry;
+    nextEntry=nextEntry->next;
+  }
+
+  return NULL;
+}
+
+
+
+void *AQFINTS_IndexEntry_GetPointer(const AQFINTS_INDEX_ENTRY *entry)
+{
+  assert(entry);
+  return entry->ptr;
+}
+
+
+
+uint32_t _hashName(const char *name)
+{
+  uint32_t hash=2166136261U;
+
+  /* FNV-1a over the upper case name */
+  while (*name) {
+    hash^=(uint32_t) toupper((unsigned char) *name);
+    hash*=16777619U;
+    name++;
+  }
+
+  return hash;
+}
+
@@ -0,0 +1,58 @@
+/***************************************************************************
+ begin       : Mon Oct 19 2026
+ copyright   : (C) 2026 by Martin Preuss
+ email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+#ifndef AQFINTS_PARSER_INDEX_H
+#define AQFINTS_PARSER_INDEX_H
+
+
+#include <inttypes.h>
+
+
+/**
+ * Simple hash index mapping case-insensitive names to pointers.
+ *
+ * Multiple pointers may be stored under the same name, they are returned in the order in which they were added.
+ * This is used to speed up lookups of definitions (segments, jobs, groups) by code or id. The index doesn't own
+ * the pointers stored.
+ */
+typedef struct AQFINTS_INDEX AQFINTS_INDEX;
+typedef struct AQFINTS_INDEX_ENTRY AQFINTS_INDEX_ENTRY;
+
+
+/**
+ * Constructor.
+ *
+ * @param expectedEntries number of entries expected (used to determine the number of buckets)
+ */
+AQFINTS_INDEX *AQFINTS_Index_new(uint32_t expectedEntries);
+void AQFINTS_Index_free(AQFINTS_INDEX *idx);
+
+/**
+ * Add a pointer under the given name. Empty names are ignored.
+ */
+void AQFINTS_Index_Add(AQFINTS_INDEX *idx, const char *name, void *ptr);
+
+uint32_t AQFINTS_Index_GetCount(const AQFINTS_INDEX *idx);
+
+/**
+ * Return the first entry stored under the given name (NULL if none).
+ */
+const AQFINTS_INDEX_ENTRY *AQFINTS_Index_FindFirst(const AQFINTS_INDEX *idx, const char *name);
+
+/**
+ * Return the next entry stored under the same name as the given one (NULL if none).
+ */
+const AQFINTS_INDEX_ENTRY *AQFINTS_IndexEntry_FindNext(const AQFINTS_INDEX_ENTRY *entry);
+
+void *AQFINTS_IndexEntry_GetPointer(const AQFINTS_INDEX_ENTRY *entry);
+
+
+#endif
+
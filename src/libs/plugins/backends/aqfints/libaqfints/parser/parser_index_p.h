@@ -0,0 +1,35 @@
+/***************************************************************************
+ begin       : Mon Oct 19 2026
+ copyright   : (C) 2026 by Martin Preuss
+ email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+#ifndef AQFINTS_PARSER_INDEX_P_H
+#define AQFINTS_PARSER_INDEX_P_H
+
+
+#include "parser_index.h"
+
+
+struct AQFINTS_INDEX_ENTRY {
+  AQFINTS_INDEX_ENTRY *next;   /* next entry in the same bucket */
+  uint32_t hash;
+  char *name;
+  void *ptr;
+};
+
+
+struct AQFINTS_INDEX {
+  uint32_t bucketCount;        /* always a power of 2 */
+  uint32_t entryCount;
+  AQFINTS_INDEX_ENTRY **firstEntries;
+  AQFINTS_INDEX_ENTRY **lastEntries;
+};
+
+
+#endif
+
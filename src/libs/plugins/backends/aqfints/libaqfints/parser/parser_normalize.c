@@ -14,6 +14,7 @@
 
 
 #include "parser_normalize.h"
+#include "parser_index.h"
 #include "parser.h"
 
 #include <gwenhywfar/debug.h>
@@ -25,12 +26,15 @@
  */
 
 
-static AQFINTS_ELEMENT *findGroupInTree(AQFINTS_ELEMENT *groupTree, const char *id, int version);
+static AQFINTS_INDEX *createGroupIndex(AQFINTS_ELEMENT *groupTree);
+static AQFINTS_ELEMENT *findGroupInTree(AQFINTS_ELEMENT *groupTree, const AQFINTS_INDEX *groupIndex,
+                                        const char *id, int version);
 
 static void normalizeSequence(AQFINTS_ELEMENT *elementTree);
 static void normalizeSegment(AQFINTS_SEGMENT *segment);
-static void resolveGroups(AQFINTS_ELEMENT *elementTree, AQFINTS_ELEMENT *groupTree);
-static void segmentResolveGroups(AQFINTS_SEGMENT *segment, AQFINTS_ELEMENT *groupTree);
+static void resolveGroups(AQFINTS_ELEMENT *elementTree, AQFINTS_ELEMENT *groupTree, const AQFINTS_INDEX *groupIndex);
+static void segmentResolveGroups(AQFINTS_SEGMENT *segment, AQFINTS_ELEMENT *groupTree,
+                                 const AQFINTS_INDEX *groupIndex);
 
 static void removeTrailingEmptyDegChildren(AQFINTS_ELEMENT *elementTree);
 static void removeTrailingEmptyDeChildren(AQFINTS_ELEMENT *elementTree);
@@ -48,12 +52,16 @@ static void removeTrailingEmptyDeChildren(AQFINTS_ELEMENT *elementTree);
 void AQFINTS_Parser_SegmentList_ResolveGroups(AQFINTS_SEGMENT_LIST *segmentList, AQFINTS_ELEMENT *groupTree)
 {
   AQFINTS_SEGMENT *segment;
+  AQFINTS_INDEX *groupIndex;
 
+  /* create index once instead of walking the group tree for every group reference */
+  groupIndex=createGroupIndex(groupTree);
   segment=AQFINTS_Segment_List_First(segmentList);
   while (segment) {
-    segmentResolveGroups(segment, groupTree);
+    segmentResolveGroups(segment, groupTree, groupIndex);
     segment=AQFINTS_Segment_List_Next(segment);
   }
+  AQFINTS_Index_free(groupIndex);
 }
 
 
@@ -92,9 +100,47 @@ void AQFINTS_Parser_Segment_RemoveTrailingEmptyElements(AQFINTS_SEGMENT *segment
 
 
 
-AQFINTS_ELEMENT *findGroupInTree(AQFINTS_ELEMENT *groupTree, const char *id, int version)
+AQFINTS_INDEX *createGroupIndex(AQFINTS_ELEMENT *groupTree)
 {
+  AQFINTS_INDEX *groupIndex;
   AQFINTS_ELEMENT *group;
+  uint32_t groupCount=0;
+
+  group=AQFINTS_Element_Tree2_GetFirstChild(groupTree);
+  while (group) {
+    groupCount++;
+    group=AQFINTS_Element_Tree2_GetNext(group);
+  }
+
+  groupIndex=AQFINTS_Index_new(groupCount);
+  group=AQFINTS_Element_Tree2_GetFirstChild(groupTree);
+  while (group) {
+    AQFINTS_Index_Add(groupIndex, AQFINTS_Element_GetId(group), group);
+    group=AQFINTS_Element_Tree2_GetNext(group);
+  }
+
+  return groupIndex;
+}
+
+
+
+AQFINTS_ELEMENT *findGroupInTree(AQFINTS_ELEMENT *groupTree, const AQFINTS_INDEX *groupIndex,
+                                 const char *id, int version)
+{
+  AQFINTS_ELEMENT *group;
+
+  if (id && *id) {
+    const AQFINTS_INDEX_ENTRY *entry;
+
+    entry=AQFINTS_Index_FindFirst(groupIndex, id);
+    while (entry) {
+      group=(AQFINTS_ELEMENT *) AQFINTS_IndexEntry_GetPointer(entry);
+      if (version==0 || version==AQFINTS_Element_GetVersion(group))
+        return group;
+      entry=AQFINTS_IndexEntry_FindNext(entry);
+    }
+    return NULL;
+  }
 
   group=AQFINTS_Element_Tree2_GetFirstChild(groupTree);
   while (group) {
@@ -162,14 +208,14 @@ void normalizeSequence(AQFINTS_ELEMENT *elementTree)
 
 
 
-void segmentResolveGroups(AQFINTS_SEGMENT *segment, AQFINTS_ELEMENT *groupTree)
+void segmentResolveGroups(AQFINTS_SEGMENT *segment, AQFINTS_ELEMENT *groupTree, const AQFINTS_INDEX *groupIndex)
 {
-  resolveGroups(AQFINTS_Segment_GetElements(segment), groupTree);
+  resolveGroups(AQFINTS_Segment_GetElements(segment), groupTree, groupIndex);
 }
 
 
 
-void resolveGroups(AQFINTS_ELEMENT *elementTree, AQFINTS_ELEMENT *groupTree)
+void resolveGroups(AQFINTS_ELEMENT *elementTree, AQFINTS_ELEMENT *groupTree, const AQFINTS_INDEX *groupIndex)
 {
   AQFINTS_ELEMENT *element;
 
@@ -188,7 +234,7 @@ void resolveGroups(AQFINTS_ELEMENT *elementTree, AQFINTS_ELEMENT *groupTree)
 
         iGroupVersion=AQFINTS_Element_GetVersion(element);
         DBG_INFO(AQFINTS_PARSER_LOGDOMAIN, "Looking for group \"%s:%d\"", sGroupType, iGroupVersion);
-        groupDefElement=findGroupInTree(groupTree, sGroupType, iGroupVersion);
+        groupDefElement=findGroupInTree(groupTree, groupIndex, sGroupType, iGroupVersion);
         if (groupDefElement==NULL) {
           DBG_INFO(AQFINTS_PARSER_LOGDOMAIN, "Group \"%s:%d\" not found", sGroupType, iGroupVersion);
           assert(0);
@@ -212,7 +258,7 @@ void resolveGroups(AQFINTS_ELEMENT *elementTree, AQFINTS_ELEMENT *groupTree)
     }
 
     /* recursion */
-    resolveGroups(element, groupTree);
+    resolveGroups(element, groupTree, groupIndex);
 
     element=AQFINTS_Element_Tree2_GetNext(element);
   }
@@ -247,8 +293,8 @@ void removeTrailingEmptyDeChildren(AQFINTS_ELEMENT *elementTree)
 
   while ((element=AQFINTS_Element_Tree2_GetLastChild(elementTree))) {
     if (AQFINTS_Element_GetElementType(element)==AQFINTS_ElementType_De) {
-      if (AQFINTS_Element_GetDataLength(element)==0 ||
-          AQFINTS_Element_GetDataPointer(element)==NULL) {
+      /* don't use GetDataPointer() here, it would materialize data of zero-copy elements */
+      if (!AQFINTS_Element_HasData(element)) {
         AQFINTS_Element_Tree2_Unlink(element);
         AQFINTS_Element_free(element);
       }
@@ -14,6 +14,7 @@
 
 
 #include "parser/parser.h"
+#include "parser/parser_index.h"
 
 #include <gwenhywfar/stringlist.h>
 
@@ -23,6 +24,15 @@ struct AQFINTS_PARSER {
   AQFINTS_JOBDEF_LIST *jobDefList;
   AQFINTS_SEGMENT_LIST *segmentList;
   GWEN_STRINGLIST *pathList;
+  char *cacheFile;
+  int zeroCopy;
+
+  /* indexes into the lists above, created by AQFINTS_Parser_ReadFiles() */
+  AQFINTS_INDEX *segmentsByCode;
+  AQFINTS_INDEX *segmentsById;
+  AQFINTS_INDEX *jobDefsByCode;
+  AQFINTS_INDEX *jobDefsById;
+  AQFINTS_INDEX *jobDefsByParams;
 };
 
 
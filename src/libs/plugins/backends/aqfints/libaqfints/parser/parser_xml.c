@@ -17,6 +17,12 @@
 
 #include <gwenhywfar/debug.h>
 #include <gwenhywfar/text.h>
+#include <gwenhywfar/buffer.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
 
 
 
@@ -45,6 +51,7 @@ static void readSegmentChildren(AQFINTS_SEGMENT *segment, GWEN_XMLNODE *xmlSourc
 static void readJobDefs(AQFINTS_JOBDEF_LIST *jobDefList, GWEN_XMLNODE *xmlSource);
 
 static void writeSegmentDefinitions(const AQFINTS_SEGMENT_LIST *segmentList, GWEN_XMLNODE *xmlDest);
+static void writeJobDefinitions(const AQFINTS_JOBDEF_LIST *jobDefList, GWEN_XMLNODE *xmlDest);
 static void writeSegmentWithElements(const AQFINTS_SEGMENT *segment, GWEN_XMLNODE *xmlDest);
 static void writeElementTree(const AQFINTS_ELEMENT *el, GWEN_XMLNODE *xmlDest);
 
@@ -52,6 +59,7 @@ static void writeSegment(const AQFINTS_SEGMENT *segment, GWEN_XMLNODE *xmlDest);
 static void writeElement(const AQFINTS_ELEMENT *el, GWEN_XMLNODE *xmlDest);
 
 static void readJobDef(AQFINTS_JOBDEF *jobDef, GWEN_XMLNODE *xmlSource);
+static void writeJobDef(const AQFINTS_JOBDEF *jobDef, GWEN_XMLNODE *xmlDest);
 
 
 
@@ -168,6 +176,111 @@ int AQFINTS_Parser_Xml_WriteSegmentDefinitionFile(const AQFINTS_SEGMENT_LIST *se
 
 
 
+int AQFINTS_Parser_Xml_WriteDefinitionCacheFile(const AQFINTS_JOBDEF_LIST *jobDefList,
+                                                const AQFINTS_SEGMENT_LIST *segmentList,
+                                                const char *fingerprint,
+                                                const char *filename)
+{
+  GWEN_XMLNODE *xmlFile;
+  GWEN_XMLNODE *xmlHeader;
+  GWEN_XMLNODE *xmlFinTS;
+  GWEN_XMLNODE *xmlNode;
+  GWEN_BUFFER *tbuf;
+  int rv;
+
+  xmlFile=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "ROOT");
+  xmlHeader=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "?xml");
+  GWEN_XMLNode_AddHeader(xmlFile, xmlHeader);
+  xmlFinTS=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "FinTS");
+  if (fingerprint && *fingerprint)
+    GWEN_XMLNode_SetProperty(xmlFinTS, "fingerprint", fingerprint);
+  GWEN_XMLNode_AddChild(xmlFile, xmlFinTS);
+
+  xmlNode=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "SEGs");
+  writeSegmentDefinitions(segmentList, xmlNode);
+  GWEN_XMLNode_AddChild(xmlFinTS, xmlNode);
+
+  xmlNode=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "JOBs");
+  writeJobDefinitions(jobDefList, xmlNode);
+  GWEN_XMLNode_AddChild(xmlFinTS, xmlNode);
+
+  /* write to a temporary file first, other processes might currently read the cache */
+  tbuf=GWEN_Buffer_new(0, 256, 0, 1);
+  GWEN_Buffer_AppendString(tbuf, filename);
+  GWEN_Buffer_AppendArgs(tbuf, ".%d.tmp", (int) getpid());
+
+  /* no indentation: this file is not meant to be read by humans */
+  rv=GWEN_XMLNode_WriteFile(xmlFile, GWEN_Buffer_GetStart(tbuf),
+                            GWEN_XML_FLAGS_HANDLE_COMMENTS |
+                            GWEN_XML_FLAGS_HANDLE_HEADERS |
+                            GWEN_XML_FLAGS_SIMPLE);
+  GWEN_XMLNode_free(xmlFile);
+  if (rv<0) {
+    DBG_INFO(AQFINTS_PARSER_LOGDOMAIN, "Could not write cache file \"%s\" (%d)", GWEN_Buffer_GetStart(tbuf), rv);
+    unlink(GWEN_Buffer_GetStart(tbuf));
+    GWEN_Buffer_free(tbuf);
+    return rv;
+  }
+
+#ifdef OS_WIN32
+  /* rename() doesn't replace existing files on windows */
+  unlink(filename);
+#endif
+  if (rename(GWEN_Buffer_GetStart(tbuf), filename)) {
+    DBG_INFO(AQFINTS_PARSER_LOGDOMAIN, "rename(%s): %s", GWEN_Buffer_GetStart(tbuf), strerror(errno));
+    unlink(GWEN_Buffer_GetStart(tbuf));
+    GWEN_Buffer_free(tbuf);
+    return GWEN_ERROR_IO;
+  }
+
+  GWEN_Buffer_free(tbuf);
+  return 0;
+}
+
+
+
+int AQFINTS_Parser_Xml_ReadDefinitionCacheFile(AQFINTS_JOBDEF_LIST *jobDefList,
+                                               AQFINTS_SEGMENT_LIST *segmentList,
+                                               const char *fingerprint,
+                                               const char *filename)
+{
+  GWEN_XMLNODE *xmlNodeFile;
+  GWEN_XMLNODE *xmlNodeFints;
+  const char *s;
+  int rv;
+
+  xmlNodeFile=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "fintsFile");
+  rv=GWEN_XML_ReadFile(xmlNodeFile, filename,
+                       GWEN_XML_FLAGS_HANDLE_COMMENTS |
+                       GWEN_XML_FLAGS_HANDLE_HEADERS |
+                       GWEN_XML_FLAGS_SIMPLE);
+  if (rv<0) {
+    DBG_INFO(AQFINTS_PARSER_LOGDOMAIN, "Error reading cache file \"%s\" (%d)", filename, rv);
+    GWEN_XMLNode_free(xmlNodeFile);
+    return rv;
+  }
+
+  xmlNodeFints=GWEN_XMLNode_FindFirstTag(xmlNodeFile, "FinTS", NULL, NULL);
+  if (xmlNodeFints==NULL) {
+    DBG_INFO(AQFINTS_PARSER_LOGDOMAIN, "No FinTS group in cache file \"%s\"", filename);
+    GWEN_XMLNode_free(xmlNodeFile);
+    return GWEN_ERROR_BAD_DATA;
+  }
+
+  s=GWEN_XMLNode_GetProperty(xmlNodeFints, "fingerprint", NULL);
+  if (!(s && fingerprint && strcmp(s, fingerprint)==0)) {
+    DBG_INFO(AQFINTS_PARSER_LOGDOMAIN, "Cache file \"%s\" is outdated", filename);
+    GWEN_XMLNode_free(xmlNodeFile);
+    return GWEN_ERROR_NOT_FOUND;
+  }
+
+  readGroupsAndSegsAndJobs(jobDefList, segmentList, NULL, xmlNodeFints);
+  GWEN_XMLNode_free(xmlNodeFile);
+  return 0;
+}
+
+
+
 void writeSegmentDefinitions(const AQFINTS_SEGMENT_LIST *segmentList, GWEN_XMLNODE *xmlDest)
 {
   const AQFINTS_SEGMENT *segment;
@@ -186,6 +299,24 @@ void writeSegmentDefinitions(const AQFINTS_SEGMENT_LIST *segmentList, GWEN_XMLNO
 
 
 
+void writeJobDefinitions(const AQFINTS_JOBDEF_LIST *jobDefList, GWEN_XMLNODE *xmlDest)
+{
+  const AQFINTS_JOBDEF *jobDef;
+
+  jobDef=AQFINTS_JobDef_List_First(jobDefList);
+  while (jobDef) {
+    GWEN_XMLNODE *xmlNode;
+
+    xmlNode=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "JOBdef");
+    writeJobDef(jobDef, xmlNode);
+    GWEN_XMLNode_AddChild(xmlDest, xmlNode);
+
+    jobDef=AQFINTS_JobDef_List_Next(jobDef);
+  }
+}
+
+
+
 
 
 void readGroupsAndSegsAndJobs(AQFINTS_JOBDEF_LIST *jobDefList,
@@ -202,7 +333,8 @@ void readGroupsAndSegsAndJobs(AQFINTS_JOBDEF_LIST *jobDefList,
     s=GWEN_XMLNode_GetData(xmlNode);
     if (s && *s) {
       if (strcasecmp(s, "GROUPs")==0) {
-        readGroups(groupTree, xmlNode);
+        if (groupTree)
+          readGroups(groupTree, xmlNode);
       }
       else if (strcasecmp(s, "SEGs")==0) {
         readSegments(segmentList, xmlNode);
@@ -644,13 +776,15 @@ void writeSegment(const AQFINTS_SEGMENT *segment, GWEN_XMLNODE *xmlDest)
   if (s && *s)
     GWEN_XMLNode_SetProperty(xmlDest, "code", s);
 
+  /* always write versions, readSegment() uses -1 for missing versions */
   i=AQFINTS_Segment_GetSegmentVersion(segment);
-  if (i!=0)
-    GWEN_XMLNode_SetIntProperty(xmlDest, "segmentVersion", i);
+  GWEN_XMLNode_SetIntProperty(xmlDest, "segmentVersion", i);
 
   i=AQFINTS_Segment_GetProtocolVersion(segment);
-  if (i!=0)
-    GWEN_XMLNode_SetIntProperty(xmlDest, "protocolVersion", i);
+  GWEN_XMLNode_SetIntProperty(xmlDest, "protocolVersion", i);
+
+  if (AQFINTS_Segment_GetFlags(segment) & AQFINTS_SEGMENT_FLAGS_ISBPD)
+    GWEN_XMLNode_SetIntProperty(xmlDest, "isBpdJob", 1);
 }
 
 
@@ -722,13 +856,12 @@ void writeJobDef(const AQFINTS_JOBDEF *jobDef, GWEN_XMLNODE *xmlDest)
   if (s && *s)
     GWEN_XMLNode_SetProperty(xmlDest, "response", s);
 
+  /* always write versions, readJobDef() uses -1 for missing versions */
   i=AQFINTS_JobDef_GetJobVersion(jobDef);
-  if (i!=0)
-    GWEN_XMLNode_SetIntProperty(xmlDest, "jobVersion", i);
+  GWEN_XMLNode_SetIntProperty(xmlDest, "jobVersion", i);
 
   i=AQFINTS_JobDef_GetProtocolVersion(jobDef);
-  if (i!=0)
-    GWEN_XMLNode_SetIntProperty(xmlDest, "protocolVersion", i);
+  GWEN_XMLNode_SetIntProperty(xmlDest, "protocolVersion", i);
 
   flags=AQFINTS_JobDef_GetFlags(jobDef);
   if (flags & AQFINTS_JOBDEF_FLAGS_CRYPT)
@@ -32,5 +32,31 @@ int AQFINTS_Parser_Xml_ReadBuffer(AQFINTS_JOBDEF_LIST *jobDefList,
 int AQFINTS_Parser_Xml_WriteSegmentDefinitionFile(const AQFINTS_SEGMENT_LIST *segmentList, const char *filename);
 
 
+/**
+ * Write already normalized segment and job definitions to a cache file.
+ * The file is written to a temporary file first which then replaces the cache file, so readers never see a partially
+ * written cache.
+ *
+ * @param fingerprint string describing the source files the definitions were read from
+ */
+int AQFINTS_Parser_Xml_WriteDefinitionCacheFile(const AQFINTS_JOBDEF_LIST *jobDefList,
+                                                const AQFINTS_SEGMENT_LIST *segmentList,
+                                                const char *fingerprint,
+                                                const char *filename);
+
+/**
+ * Read segment and job definitions from a file written by @ref AQFINTS_Parser_Xml_WriteDefinitionCacheFile.
+ *
+ * The definitions read are already normalized, groups must not be resolved again.
+ *
+ * @return 0 if okay, GWEN_ERROR_NOT_FOUND if the fingerprint stored in the file doesn't match the given one,
+ *   other error code otherwise (in which case nothing has been added to the given lists)
+ */
+int AQFINTS_Parser_Xml_ReadDefinitionCacheFile(AQFINTS_JOBDEF_LIST *jobDefList,
+                                               AQFINTS_SEGMENT_LIST *segmentList,
+                                               const char *fingerprint,
+                                               const char *filename);
+
+
 #endif
 
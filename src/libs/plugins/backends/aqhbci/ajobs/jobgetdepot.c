@@ -175,6 +175,7 @@ int _readDepotInfo(AH_JOB *j, AB_IMEXPORTER_CONTEXT *ctx, const uint8_t *ptr, ui
   AB_IMEXPORTER_CONTEXT *tempContext;
   AB_SECURITY_LIST *tmpSecurityList;
   int rv;
+  uint64_t t0;
 
   assert(j);
   pro=AH_Job_GetProvider(j);
@@ -183,6 +184,7 @@ int _readDepotInfo(AH_JOB *j, AB_IMEXPORTER_CONTEXT *ctx, const uint8_t *ptr, ui
   /* import data into a temporary context */
   tempContext=AB_ImExporterContext_new();
 
+  t0=AH_Job_StatsStart(j);
   rv=AB_Banking_ImportFromBufferLoadProfile(AB_Provider_GetBanking(pro),
                                             "swift",
                                             tempContext,
@@ -190,6 +192,7 @@ int _readDepotInfo(AH_JOB *j, AB_IMEXPORTER_CONTEXT *ctx, const uint8_t *ptr, ui
                                             NULL,
                                             ptr,
                                             len);
+  AH_Job_StatsStop(j, AH_StatsPhase_Import, t0, len);
   if (rv<0) {
     DBG_INFO(AQHBCI_LOGDOMAIN, "here (%d)", rv);
     AB_ImExporterContext_free(tempContext);
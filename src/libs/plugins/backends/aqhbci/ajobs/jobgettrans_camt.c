@@ -125,6 +125,7 @@ int _readTransactions(AH_JOB *j,
   AB_IMEXPORTER_CONTEXT *tempContext;
   AB_IMEXPORTER_ACCOUNTINFO *tempAccountInfo;
   int rv;
+  uint64_t t0;
 
   assert(j);
   pro=AH_Job_GetProvider(j);
@@ -133,6 +134,7 @@ int _readTransactions(AH_JOB *j,
   /* import data into a temporary context */
   tempContext=AB_ImExporterContext_new();
 
+  t0=AH_Job_StatsStart(j);
   rv=AB_Banking_ImportFromBufferLoadProfile(AB_Provider_GetBanking(pro),
                                             "xml",
                                             tempContext,
@@ -140,6 +142,7 @@ int _readTransactions(AH_JOB *j,
                                             NULL,
                                             ptr,
                                             len);
+  AH_Job_StatsStop(j, AH_StatsPhase_Import, t0, len);
   if (rv<0) {
     DBG_INFO(AQHBCI_LOGDOMAIN, "here (%d)", rv);
     AB_ImExporterContext_free(tempContext);
@@ -153,7 +156,7 @@ int _readTransactions(AH_JOB *j,
     AB_BALANCE_LIST *bl;
 
     /* move transactions, set transaction type */
-    tl=AB_ImExporterAccountInfo_GetTransactionList(tempAccountInfo);
+    tl=AB_ImExporterAccountInfo_GetTransactionListForUpdate(tempAccountInfo);
     if (tl) {
       AB_TRANSACTION *t;
 
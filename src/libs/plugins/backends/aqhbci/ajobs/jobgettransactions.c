@@ -121,6 +121,7 @@ int AH_Job_GetTransactions__ReadTransactions(AH_JOB *j,
   AB_IMEXPORTER_CONTEXT *tempContext;
   AB_IMEXPORTER_ACCOUNTINFO *tempAccountInfo;
   int rv;
+  uint64_t t0;
 
   assert(j);
   pro=AH_Job_GetProvider(j);
@@ -134,6 +135,7 @@ int AH_Job_GetTransactions__ReadTransactions(AH_JOB *j,
   GWEN_Text_DumpString((const char *) ptr, len, 2);
 #endif
 
+  t0=AH_Job_StatsStart(j);
   rv=AB_Banking_ImportFromBufferLoadProfile(AB_Provider_GetBanking(pro),
                                             "swift",
                                             tempContext,
@@ -141,6 +143,7 @@ int AH_Job_GetTransactions__ReadTransactions(AH_JOB *j,
                                             NULL,
                                             ptr,
                                             len);
+  AH_Job_StatsStop(j, AH_StatsPhase_Import, t0, len);
   if (rv<0) {
     DBG_INFO(AQHBCI_LOGDOMAIN, "here (%d)", rv);
     AB_ImExporterContext_free(tempContext);
@@ -154,7 +157,7 @@ int AH_Job_GetTransactions__ReadTransactions(AH_JOB *j,
     AB_BALANCE_LIST *bl;
 
     /* move transactions, set transaction type */
-    tl=AB_ImExporterAccountInfo_GetTransactionList(tempAccountInfo);
+    tl=AB_ImExporterAccountInfo_GetTransactionListForUpdate(tempAccountInfo);
     if (tl) {
       AB_TRANSACTION *t;
 
@@ -220,6 +220,7 @@ AB_TRANSACTION *_readSto(AH_JOB *j, const char *docType, const uint8_t *ptr, uin
   AB_IMEXPORTER_CONTEXT *tempContext;
   AB_IMEXPORTER_ACCOUNTINFO *tempAccountInfo;
   int rv;
+  uint64_t t0;
 
   assert(j);
   pro=AH_Job_GetProvider(j);
@@ -228,6 +229,7 @@ AB_TRANSACTION *_readSto(AH_JOB *j, const char *docType, const uint8_t *ptr, uin
   /* import data into a temporary context */
   tempContext=AB_ImExporterContext_new();
 
+  t0=AH_Job_StatsStart(j);
   rv=AB_Banking_ImportFromBufferLoadProfile(AB_Provider_GetBanking(pro),
                                             "xml",
                                             tempContext,
@@ -235,6 +237,7 @@ AB_TRANSACTION *_readSto(AH_JOB *j, const char *docType, const uint8_t *ptr, uin
                                             NULL,
                                             ptr,
                                             len);
+  AH_Job_StatsStop(j, AH_StatsPhase_Import, t0, len);
   if (rv<0) {
     DBG_INFO(AQHBCI_LOGDOMAIN, "here (%d)", rv);
     AB_ImExporterContext_free(tempContext);
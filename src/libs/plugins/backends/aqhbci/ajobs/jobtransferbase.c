@@ -21,6 +21,7 @@
 #include "aqhbci/joblayer/job_crypt.h"
 #include "provider_l.h"
 #include "hhd_l.h"
+#include "sepaexportcache_l.h"
 
 #include <aqbanking/types/transaction.h>
 
@@ -31,7 +32,6 @@
 #include <gwenhywfar/gui.h>
 
 #include <assert.h>
-#include <ctype.h>
 
 
 
@@ -45,7 +45,6 @@ GWEN_INHERIT(AH_JOB, AH_JOB_TRANSFERBASE);
  */
 
 
-static void _replaceCtrlCharsInPurpose(AB_TRANSACTION *t);
 static void _setProfileName(AH_JOB *j, const char *s);
 static void _setDescriptor(AH_JOB *j, const char *s);
 
@@ -103,6 +102,14 @@ void GWENHYWFAR_CB AH_Job_TransferBase_FreeData(void *bp, void *p)
 
 
 
+/* --------------------------------------------------------------- FUNCTION */
+int AH_Job_TransferBase_IsTransferBase(const AH_JOB *j)
+{
+  return GWEN_INHERIT_ISOFTYPE(AH_JOB, AH_JOB_TRANSFERBASE, j);
+}
+
+
+
 /* --------------------------------------------------------------- FUNCTION */
 const char *AH_Job_TransferBase_GetFiid(const AH_JOB *j)
 {
@@ -123,10 +130,11 @@ int AH_Job_TransferBase_SepaExportTransactions(AH_JOB *j)
   AH_JOB_TRANSFERBASE *aj;
   GWEN_DB_NODE *dbArgs;
   AB_BANKING *ab;
-  const AB_TRANSACTION *t;
-  int rv;
   AB_ACCOUNT *a;
-  GWEN_DB_NODE *dbProfile;
+  AH_SEPA_EXPORT_CACHE *ec;
+  AH_SEPA_EXPORT_CACHE *localCache=NULL;
+  GWEN_BUFFER *dbuf;
+  int rv;
 
   DBG_INFO(AQHBCI_LOGDOMAIN, "Exporting transaction");
 
@@ -159,82 +167,35 @@ int AH_Job_TransferBase_SepaExportTransactions(AH_JOB *j)
                         I18N("Using SEPA descriptor %s and profile %s"),
                         aj->descriptor, aj->profileName);
 
-  dbProfile=AB_Banking_GetImExporterProfile(ab, "xml", aj->profileName);
-  if (dbProfile==NULL) {
-    DBG_ERROR(AQHBCI_LOGDOMAIN, "Profile \"%s\" not found.", aj->profileName);
-    return GWEN_ERROR_INTERNAL;
+  /* use the cache of the outbox currently executed, fall back to a private one */
+  ec=AH_Provider_GetSepaExportCache(AH_Job_GetProvider(j));
+  if (ec==NULL) {
+    localCache=AH_SepaExportCache_new(ab, 1);
+    ec=localCache;
   }
 
-  if (aj->localInstrumentationCode)
-    GWEN_DB_SetCharValue(dbProfile, GWEN_DB_FLAGS_OVERWRITE_VARS, "LocalInstrumentSEPACode", aj->localInstrumentationCode);
-
-  /* set data in job */
-  t=AH_Job_GetFirstTransfer(j);
-  if (t) {
-    AB_IMEXPORTER_CONTEXT *ioc;
-    AB_TRANSACTION *cpy;
-    GWEN_BUFFER *dbuf;
-
-    /* add copies of transfers */
-    ioc=AB_ImExporterContext_new();
-    while (t) {
-      cpy=AB_Transaction_dup(t);
-      _replaceCtrlCharsInPurpose(cpy);
-      AB_Transaction_SetUniqueAccountId(cpy, AB_Account_GetUniqueId(a));
-      AB_ImExporterContext_AddTransaction(ioc, cpy);
-      t=AB_Transaction_List_Next(t);
-    }
-
-    dbuf=GWEN_Buffer_new(0, 256, 0, 1);
-    rv=AB_Banking_ExportToBuffer(ab, "xml", ioc, dbuf, dbProfile);
-    AB_ImExporterContext_free(ioc);
-    if (rv<0) {
-      DBG_INFO(AQHBCI_LOGDOMAIN, "here (%d)", rv);
-      GWEN_Buffer_free(dbuf);
-      GWEN_DB_Group_free(dbProfile);
-      return rv;
-    }
-
-    /* store descriptor */
-    GWEN_DB_SetCharValue(dbArgs, GWEN_DB_FLAGS_OVERWRITE_VARS, "descriptor", aj->descriptor);
-    /* store transfer */
-    GWEN_DB_SetBinValue(dbArgs, GWEN_DB_FLAGS_OVERWRITE_VARS, "transfer", GWEN_Buffer_GetStart(dbuf),
-                        GWEN_Buffer_GetUsedBytes(dbuf));
+  dbuf=GWEN_Buffer_new(0, 256, 0, 1);
+  rv=AH_SepaExportCache_ExportTransfers(ec,
+                                        aj->profileName,
+                                        aj->localInstrumentationCode,
+                                        AH_Job_GetTransferList(j),
+                                        AB_Account_GetUniqueId(a),
+                                        dbuf);
+  AH_SepaExportCache_free(localCache);
+  if (rv<0) {
+    DBG_INFO(AQHBCI_LOGDOMAIN, "here (%d)", rv);
     GWEN_Buffer_free(dbuf);
-    GWEN_DB_Group_free(dbProfile);
-  }
-  else {
-    DBG_ERROR(AQHBCI_LOGDOMAIN, "No transaction in job");
-    GWEN_DB_Group_free(dbProfile);
-    return GWEN_ERROR_INTERNAL;
+    return rv;
   }
 
-  return 0;
-}
+  /* store descriptor */
+  GWEN_DB_SetCharValue(dbArgs, GWEN_DB_FLAGS_OVERWRITE_VARS, "descriptor", aj->descriptor);
+  /* store transfer */
+  GWEN_DB_SetBinValue(dbArgs, GWEN_DB_FLAGS_OVERWRITE_VARS, "transfer", GWEN_Buffer_GetStart(dbuf),
+                      GWEN_Buffer_GetUsedBytes(dbuf));
+  GWEN_Buffer_free(dbuf);
 
-
-
-/* --------------------------------------------------------------- FUNCTION */
-void _replaceCtrlCharsInPurpose(AB_TRANSACTION *trans)
-{
-  const char *s;
-
-  s=AB_Transaction_GetPurpose(trans);
-  if (s && *s) {
-    GWEN_BUFFER *buf;
-    char *t;
-
-    buf=GWEN_Buffer_new(0, 256, 0, 1);
-    GWEN_Buffer_AppendString(buf, s);
-    t=GWEN_Buffer_GetStart(buf);
-    while (*t) {
-      if (iscntrl(*t))
-        *t=' ';
-      t++;
-    }
-    AB_Transaction_SetPurpose(trans, GWEN_Buffer_GetStart(buf));
-    GWEN_Buffer_free(buf);
-  }
+  return 0;
 }
 
 
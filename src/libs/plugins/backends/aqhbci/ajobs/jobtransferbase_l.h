@@ -24,6 +24,12 @@ AH_JOB *AH_Job_TransferBase_new(const char *jobName,
 
 const char *AH_Job_TransferBase_GetFiid(const AH_JOB *j);
 
+/**
+ * Check whether the given job is derived from AH_JOB_TRANSFERBASE (i.e. exports its transfers via
+ * @ref AH_Job_TransferBase_SepaExportTransactions which needs one SEPA message id).
+ */
+int AH_Job_TransferBase_IsTransferBase(const AH_JOB *j);
+
 /**
  * Select SEPA PAIN profile to be used.
  *
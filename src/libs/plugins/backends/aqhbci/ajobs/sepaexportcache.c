@@ -0,0 +1,316 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ *          Please see toplevel file COPYING for license details           *
+ ***************************************************************************/
+
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+
+#include "sepaexportcache_p.h"
+#include "aqhbci_l.h"
+
+#include <aqbanking/banking_be.h>
+#include <aqbanking/backendsupport/imexporter_be.h>
+
+#include <gwenhywfar/debug.h>
+#include <gwenhywfar/misc.h>
+
+#include <assert.h>
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * forward declarations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+
+static GWEN_DB_NODE *_findProfileEntry(const AH_SEPA_EXPORT_CACHE *ec,
+                                       const char *profileName,
+                                       const char *localInstrumentationCode);
+static char *_replaceCtrlCharsInPurpose(AB_TRANSACTION *t);
+static void _moveTransfersToContext(AB_TRANSACTION_LIST *transferList,
+                                    uint32_t uniqueAccountId,
+                                    AB_IMEXPORTER_CONTEXT *ioc,
+                                    AH_SEPA_EXPORT_CACHE_SAVED *savedList);
+static void _moveTransfersBack(AB_IMEXPORTER_CONTEXT *ioc,
+                               AB_TRANSACTION_LIST *transferList,
+                               AH_SEPA_EXPORT_CACHE_SAVED *savedList);
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * implementations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+
+
+AH_SEPA_EXPORT_CACHE *AH_SepaExportCache_new(AB_BANKING *ab, int idBlockSize)
+{
+  AH_SEPA_EXPORT_CACHE *ec;
+
+  assert(ab);
+  GWEN_NEW_OBJECT(AH_SEPA_EXPORT_CACHE, ec);
+  ec->banking=ab;
+  ec->dbProfiles=GWEN_DB_Group_new("profiles");
+  ec->idBlockSize=(idBlockSize>0)?idBlockSize:1;
+  return ec;
+}
+
+
+
+void AH_SepaExportCache_free(AH_SEPA_EXPORT_CACHE *ec)
+{
+  if (ec) {
+    if (ec->messageIdsLeft>0) {
+      DBG_INFO(AQHBCI_LOGDOMAIN, "%d reserved SEPA message ids not used", ec->messageIdsLeft);
+    }
+    GWEN_DB_Group_free(ec->dbProfiles);
+    GWEN_FREE_OBJECT(ec);
+  }
+}
+
+
+
+GWEN_DB_NODE *AH_SepaExportCache_GetProfile(AH_SEPA_EXPORT_CACHE *ec,
+                                            const char *profileName,
+                                            const char *localInstrumentationCode)
+{
+  GWEN_DB_NODE *dbEntry;
+  GWEN_DB_NODE *dbProfile;
+
+  assert(ec);
+  assert(profileName);
+
+  dbEntry=_findProfileEntry(ec, profileName, localInstrumentationCode);
+  if (dbEntry)
+    return GWEN_DB_GetGroup(dbEntry, GWEN_PATH_FLAGS_NAMEMUSTEXIST, "profile");
+
+  dbProfile=AB_Banking_GetImExporterProfile(ec->banking, "xml", profileName);
+  if (dbProfile==NULL) {
+    DBG_ERROR(AQHBCI_LOGDOMAIN, "Profile \"%s\" not found.", profileName);
+    return NULL;
+  }
+  if (localInstrumentationCode)
+    GWEN_DB_SetCharValue(dbProfile, GWEN_DB_FLAGS_OVERWRITE_VARS, "LocalInstrumentSEPACode", localInstrumentationCode);
+  GWEN_DB_GroupRename(dbProfile, "profile");
+
+  dbEntry=GWEN_DB_GetGroup(ec->dbProfiles, GWEN_PATH_FLAGS_CREATE_GROUP, "entry");
+  GWEN_DB_SetCharValue(dbEntry, GWEN_DB_FLAGS_OVERWRITE_VARS, "profileName", profileName);
+  if (localInstrumentationCode)
+    GWEN_DB_SetCharValue(dbEntry, GWEN_DB_FLAGS_OVERWRITE_VARS, "localInstrumentationCode", localInstrumentationCode);
+  GWEN_DB_AddGroup(dbEntry, dbProfile);
+
+  return dbProfile;
+}
+
+
+
+int AH_SepaExportCache_GetNextMessageId(AH_SEPA_EXPORT_CACHE *ec)
+{
+  assert(ec);
+
+  if (ec->messageIdsLeft<1) {
+    int rv;
+
+    rv=AB_Banking_ReserveNamedUniqueIds(ec->banking, "sepamsg", 1, ec->idBlockSize);
+    if (rv<=0) {
+      DBG_ERROR(AQHBCI_LOGDOMAIN, "Could not reserve SEPA message ids (%d)", rv);
+      return (rv<0)?rv:GWEN_ERROR_GENERIC;
+    }
+    ec->nextMessageId=(uint32_t) rv;
+    ec->messageIdsLeft=ec->idBlockSize;
+  }
+
+  ec->messageIdsLeft--;
+  return (int)(ec->nextMessageId++);
+}
+
+
+
+int AH_SepaExportCache_ExportTransfers(AH_SEPA_EXPORT_CACHE *ec,
+                                       const char *profileName,
+                                       const char *localInstrumentationCode,
+                                       AB_TRANSACTION_LIST *transferList,
+                                       uint32_t uniqueAccountId,
+                                       GWEN_BUFFER *destBuffer)
+{
+  GWEN_DB_NODE *dbProfile;
+  AB_IMEXPORTER_CONTEXT *ioc;
+  AH_SEPA_EXPORT_CACHE_SAVED *savedList;
+  int count;
+  int msgId;
+  int rv;
+
+  assert(ec);
+
+  count=transferList?AB_Transaction_List_GetCount(transferList):0;
+  if (count<1) {
+    DBG_ERROR(AQHBCI_LOGDOMAIN, "No transaction in job");
+    return GWEN_ERROR_INTERNAL;
+  }
+
+  dbProfile=AH_SepaExportCache_GetProfile(ec, profileName, localInstrumentationCode);
+  if (dbProfile==NULL)
+    return GWEN_ERROR_INTERNAL;
+
+  msgId=AH_SepaExportCache_GetNextMessageId(ec);
+  if (msgId<0) {
+    DBG_INFO(AQHBCI_LOGDOMAIN, "here (%d)", msgId);
+    return msgId;
+  }
+  GWEN_DB_SetIntValue(dbProfile, GWEN_DB_FLAGS_OVERWRITE_VARS, AB_IMEXPORTER_PARAMS_SEPAMSGID_FIRST, msgId);
+  GWEN_DB_SetIntValue(dbProfile, GWEN_DB_FLAGS_OVERWRITE_VARS, AB_IMEXPORTER_PARAMS_SEPAMSGID_COUNT, 1);
+
+  savedList=(AH_SEPA_EXPORT_CACHE_SAVED *) calloc(count, sizeof(AH_SEPA_EXPORT_CACHE_SAVED));
+
+  ioc=AB_ImExporterContext_new();
+  _moveTransfersToContext(transferList, uniqueAccountId, ioc, savedList);
+  rv=AB_Banking_ExportToBuffer(ec->banking, "xml", ioc, destBuffer, dbProfile);
+  _moveTransfersBack(ioc, transferList, savedList);
+  AB_ImExporterContext_free(ioc);
+  free(savedList);
+
+  GWEN_DB_DeleteVar(dbProfile, AB_IMEXPORTER_PARAMS_SEPAMSGID_FIRST);
+  GWEN_DB_DeleteVar(dbProfile, AB_IMEXPORTER_PARAMS_SEPAMSGID_COUNT);
+
+  if (rv<0) {
+    DBG_INFO(AQHBCI_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  return 0;
+}
+
+
+
+GWEN_DB_NODE *_findProfileEntry(const AH_SEPA_EXPORT_CACHE *ec,
+                                const char *profileName,
+                                const char *localInstrumentationCode)
+{
+  GWEN_DB_NODE *dbEntry;
+
+  dbEntry=GWEN_DB_FindFirstGroup(ec->dbProfiles, "entry");
+  while (dbEntry) {
+    const char *sName;
+    const char *sCode;
+
+    sName=GWEN_DB_GetCharValue(dbEntry, "profileName", 0, NULL);
+    sCode=GWEN_DB_GetCharValue(dbEntry, "localInstrumentationCode", 0, NULL);
+    if (sName && strcasecmp(sName, profileName)==0) {
+      if ((sCode==NULL && localInstrumentationCode==NULL) ||
+          (sCode && localInstrumentationCode && strcasecmp(sCode, localInstrumentationCode)==0))
+        return dbEntry;
+    }
+    dbEntry=GWEN_DB_FindNextGroup(dbEntry, "entry");
+  }
+
+  return NULL;
+}
+
+
+
+void _moveTransfersToContext(AB_TRANSACTION_LIST *transferList,
+                             uint32_t uniqueAccountId,
+                             AB_IMEXPORTER_CONTEXT *ioc,
+                             AH_SEPA_EXPORT_CACHE_SAVED *savedList)
+{
+  AB_IMEXPORTER_ACCOUNTINFO *ai;
+  AB_TRANSACTION *t;
+  int i=0;
+
+  t=AB_Transaction_List_First(transferList);
+  ai=AB_ImExporterAccountInfo_new();
+  AB_ImExporterAccountInfo_FillFromTransaction(ai, t);
+  AB_ImExporterContext_AddAccountInfo(ioc, ai);
+
+  while (t) {
+    AB_TRANSACTION *tNext;
+
+    tNext=AB_Transaction_List_Next(t);
+    savedList[i].uniqueAccountId=AB_Transaction_GetUniqueAccountId(t);
+    savedList[i].purpose=_replaceCtrlCharsInPurpose(t);
+    AB_Transaction_SetUniqueAccountId(t, uniqueAccountId);
+    AB_Transaction_List_Del(t);
+    AB_ImExporterAccountInfo_AddTransaction(ai, t);
+    i++;
+    t=tNext;
+  }
+}
+
+
+
+void _moveTransfersBack(AB_IMEXPORTER_CONTEXT *ioc,
+                        AB_TRANSACTION_LIST *transferList,
+                        AH_SEPA_EXPORT_CACHE_SAVED *savedList)
+{
+  AB_IMEXPORTER_ACCOUNTINFO *ai;
+  AB_TRANSACTION_LIST *tl;
+  AB_TRANSACTION *t;
+  int i=0;
+
+  ai=AB_ImExporterContext_GetFirstAccountInfo(ioc);
+  tl=ai?AB_ImExporterAccountInfo_GetTransactionListForUpdate(ai):NULL;
+  if (tl==NULL)
+    return;
+
+  while ((t=AB_Transaction_List_First(tl))) {
+    AB_Transaction_List_Del(t);
+    AB_Transaction_SetUniqueAccountId(t, savedList[i].uniqueAccountId);
+    if (savedList[i].purpose) {
+      AB_Transaction_SetPurpose(t, savedList[i].purpose);
+      free(savedList[i].purpose);
+      savedList[i].purpose=NULL;
+    }
+    AB_Transaction_List_Add(t, transferList);
+    i++;
+  }
+}
+
+
+
+/* returns a copy of the original purpose if it has been changed, NULL otherwise */
+char *_replaceCtrlCharsInPurpose(AB_TRANSACTION *trans)
+{
+  const char *s;
+
+  s=AB_Transaction_GetPurpose(trans);
+  if (s && *s) {
+    const char *p;
+
+    for (p=s; *p; p++) {
+      if (iscntrl(*p))
+        break;
+    }
+    if (*p) {
+      char *original;
+      char *copy;
+      char *t;
+
+      original=strdup(s);
+      copy=strdup(s);
+      for (t=copy; *t; t++) {
+        if (iscntrl(*t))
+          *t=' ';
+      }
+      AB_Transaction_SetPurpose(trans, copy);
+      free(copy);
+      return original;
+    }
+  }
+
+  return NULL;
+}
+
+
@@ -0,0 +1,68 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ *          Please see toplevel file COPYING for license details           *
+ ***************************************************************************/
+
+
+#ifndef AH_SEPAEXPORTCACHE_L_H
+#define AH_SEPAEXPORTCACHE_L_H
+
+
+#include <aqbanking/banking.h>
+#include <aqbanking/types/transaction.h>
+
+#include <gwenhywfar/db.h>
+#include <gwenhywfar/buffer.h>
+
+
+/**
+ * Prepared SEPA export used while executing an outbox.
+ *
+ * Exporter profiles are only loaded once per profile name and local instrument code, SEPA message ids
+ * are reserved in blocks (one configuration update per block instead of one per exported document).
+ */
+typedef struct AH_SEPA_EXPORT_CACHE AH_SEPA_EXPORT_CACHE;
+
+
+/**
+ * @param ab banking object
+ * @param idBlockSize number of SEPA message ids to reserve at once (e.g. the number of jobs in the outbox)
+ */
+AH_SEPA_EXPORT_CACHE *AH_SepaExportCache_new(AB_BANKING *ab, int idBlockSize);
+void AH_SepaExportCache_free(AH_SEPA_EXPORT_CACHE *ec);
+
+
+/**
+ * Return the exporter profile for the given name with "LocalInstrumentSEPACode" set (if given).
+ * The profile remains owned by the cache.
+ */
+GWEN_DB_NODE *AH_SepaExportCache_GetProfile(AH_SEPA_EXPORT_CACHE *ec,
+                                            const char *profileName,
+                                            const char *localInstrumentationCode);
+
+/**
+ * Return the next SEPA message id from the reserved block (reserves a new block if needed).
+ * @return id (>0) or error code
+ */
+int AH_SepaExportCache_GetNextMessageId(AH_SEPA_EXPORT_CACHE *ec);
+
+/**
+ * Export the given transfers to a SEPA document using the "xml" exporter.
+ *
+ * The transfers are temporarily moved into an im-/exporter context instead of copying them,
+ * after the export they are back in the given list in their original order and unchanged.
+ * Control characters in purposes are replaced by blanks for the export.
+ */
+int AH_SepaExportCache_ExportTransfers(AH_SEPA_EXPORT_CACHE *ec,
+                                       const char *profileName,
+                                       const char *localInstrumentationCode,
+                                       AB_TRANSACTION_LIST *transferList,
+                                       uint32_t uniqueAccountId,
+                                       GWEN_BUFFER *destBuffer);
+
+
+#endif
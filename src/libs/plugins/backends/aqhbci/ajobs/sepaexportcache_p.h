@@ -0,0 +1,38 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ *          Please see toplevel file COPYING for license details           *
+ ***************************************************************************/
+
+
+#ifndef AH_SEPAEXPORTCACHE_P_H
+#define AH_SEPAEXPORTCACHE_P_H
+
+
+#include "sepaexportcache_l.h"
+
+
+struct AH_SEPA_EXPORT_CACHE {
+  AB_BANKING *banking;
+
+  /* one group per loaded profile with vars "profileName", "localInstrumentationCode" and the profile as subgroup */
+  GWEN_DB_NODE *dbProfiles;
+
+  int idBlockSize;
+  uint32_t nextMessageId;
+  int messageIdsLeft;
+};
+
+
+/* state of a transfer while it is temporarily moved into the export context */
+typedef struct AH_SEPA_EXPORT_CACHE_SAVED AH_SEPA_EXPORT_CACHE_SAVED;
+struct AH_SEPA_EXPORT_CACHE_SAVED {
+  uint32_t uniqueAccountId;
+  char *purpose; /* only set if the purpose has been changed for the export */
+};
+
+
+#endif
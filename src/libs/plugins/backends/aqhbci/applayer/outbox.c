@@ -16,9 +16,12 @@
 #include "outbox_p.h"
 
 #include "aqhbci/ajobs/accountjob_l.h"
+#include "aqhbci/ajobs/jobtransferbase_l.h"
 
 #include "aqhbci/applayer/cbox_prepare.h"
 #include "aqhbci/applayer/cbox_queue.h"
+#include "aqhbci/ajobs/sepaexportcache_l.h"
+#include "aqhbci/banking/provider_l.h"
 
 #include "aqbanking/i18n_l.h"
 
@@ -26,6 +29,7 @@
 #include <gwenhywfar/gui.h>
 
 #include <assert.h>
+#include <stdio.h>
 
 
 /*#define EXTREME_DEBUGGING */
@@ -38,8 +42,12 @@
  */
 
 static unsigned int _countTodoJobs(AH_OUTBOX *ob);
+static unsigned int _countTodoSepaExportJobs(AH_OUTBOX *ob);
+static unsigned int _countJobs(AH_OUTBOX *ob, int sepaExportOnly);
+static int _jobMatches(const AH_JOB *j, int sepaExportOnly);
 static int _sendOutboxWithProbablyLockedUsers(AH_OUTBOX *ob);
-static AH_JOB *_findTransferJobInCheckJobList(const AH_JOB_LIST *jl, AB_USER *u, AB_ACCOUNT *a, const char *jobName);
+static int _makeTransferJobKey(const AB_USER *u, const AB_ACCOUNT *a, const char *jobName, char *buffer, uint32_t size);
+static void _addOpenTransferJob(AH_OUTBOX *ob, AH_JOB *j);
 static int _prepare(AH_OUTBOX *ob);
 static void _finishCBox(AH_OUTBOX *ob, AH_OUTBOX_CBOX *cbox);
 static int _sendAndRecvCustomerBoxes(AH_OUTBOX *ob);
@@ -67,6 +75,7 @@ AH_OUTBOX *AH_Outbox_new(AB_PROVIDER *pro)
   ob->provider=pro;
   ob->userBoxes=AH_OutboxCBox_List_new();
   ob->finishedJobs=AH_Job_List_new();
+  ob->openTransferJobs=AB_HashIndex_new(AB_HASHINDEX_FLAGS_IGNORECASE);
   ob->usage=1;
   return ob;
 }
@@ -78,6 +87,7 @@ void AH_Outbox_free(AH_OUTBOX *ob)
   if (ob) {
     assert(ob->usage);
     if (--(ob->usage)==0) {
+      AB_HashIndex_free(ob->openTransferJobs);
       AH_OutboxCBox_List_free(ob->userBoxes);
       AH_Job_List_free(ob->finishedJobs);
       GWEN_INHERIT_FINI(AH_OUTBOX, ob);
@@ -120,6 +130,7 @@ int AH_Outbox_Execute(AH_OUTBOX *ob,
   int rv;
   uint32_t pid=0;
   AB_USER_LIST2 *lockedUsers=NULL;
+  AH_SEPA_EXPORT_CACHE *sepaExportCache;
 
   assert(ob);
 
@@ -137,6 +148,13 @@ int AH_Outbox_Execute(AH_OUTBOX *ob,
 
   ob->context=ctx;
 
+  /* jobs are about to be encoded and sent, they must not receive any more transfers */
+  AB_HashIndex_Clear(ob->openTransferJobs);
+
+  /* share SEPA exporter profiles and message ids among all jobs of this run */
+  sepaExportCache=AH_SepaExportCache_new(AB_Provider_GetBanking(ob->provider), _countTodoSepaExportJobs(ob));
+  AH_Provider_SetSepaExportCache(ob->provider, sepaExportCache);
+
   if (doLock) {
     lockedUsers=AB_User_List2_new();
     rv=_lockUsers(ob, lockedUsers);
@@ -166,6 +184,9 @@ int AH_Outbox_Execute(AH_OUTBOX *ob,
     }
   }
 
+  AH_Provider_SetSepaExportCache(ob->provider, NULL);
+  AH_SepaExportCache_free(sepaExportCache);
+
   if (!nounmount)
     AB_Banking_ClearCryptTokenList(AB_Provider_GetBanking(ob->provider));
 
@@ -181,7 +202,7 @@ int AH_Outbox_Execute(AH_OUTBOX *ob,
 
 AH_JOB *AH_Outbox_FindTransferJob(AH_OUTBOX *ob, AB_USER *u, AB_ACCOUNT *a, const char *jobName)
 {
-  AH_OUTBOX_CBOX *cbox;
+  char keyBuf[256];
   AH_JOB *j;
 
   assert(ob);
@@ -190,39 +211,24 @@ AH_JOB *AH_Outbox_FindTransferJob(AH_OUTBOX *ob, AB_USER *u, AB_ACCOUNT *a, cons
   assert(jobName);
 
   DBG_INFO(AQHBCI_LOGDOMAIN, "Searching for %s job", jobName);
-  cbox=AH_OutboxCBox_List_First(ob->userBoxes);
-  while (cbox) {
-    if (AH_OutboxCBox_GetUser(cbox)==u) {
-      AH_JOBQUEUE *jq;
-
-      /* check jobs in lists */
-      j=_findTransferJobInCheckJobList(AH_OutboxCBox_GetTodoJobs(cbox), u, a, jobName);
-      if (j)
-        return j;
-
-      /* check jobs in queues */
-      jq=AH_JobQueue_List_First(AH_OutboxCBox_GetTodoQueues(cbox));
-      while (jq) {
-        const AH_JOB_LIST *jl;
+  if (_makeTransferJobKey(u, a, jobName, keyBuf, sizeof(keyBuf))<0) {
+    DBG_INFO(AQHBCI_LOGDOMAIN, "Job name too long, not looking for a multi job");
+    return NULL;
+  }
 
-        jl=AH_JobQueue_GetJobList(jq);
-        if (jl) {
-          j=_findTransferJobInCheckJobList(jl, u, a, jobName);
-          if (j)
-            return j;
-        }
-        jq=AH_JobQueue_List_Next(jq);
-      } /* while */
-    }
-    else {
-      DBG_WARN(AQHBCI_LOGDOMAIN, "Customer doesn't match");
-    }
+  j=(AH_JOB *) AB_HashIndex_Find(ob->openTransferJobs, keyBuf);
+  while (j) {
+    if (AH_Job_GetTransferCount(j)<AH_Job_GetMaxTransfers(j))
+      return j;
 
-    cbox=AH_OutboxCBox_List_Next(cbox);
-  } /* while */
+    /* job is full, it will never be returned again */
+    DBG_INFO(AQHBCI_LOGDOMAIN, "Job's already full");
+    AB_HashIndex_Remove(ob->openTransferJobs, keyBuf, j);
+    j=(AH_JOB *) AB_HashIndex_Find(ob->openTransferJobs, keyBuf);
+  }
 
   DBG_INFO(AQHBCI_LOGDOMAIN, "No matching multi job found");
-  return 0;
+  return NULL;
 }
 
 
@@ -388,6 +394,9 @@ void AH_Outbox_AddJob(AH_OUTBOX *ob, AH_JOB *j)
   /* attach to job so that it will never be destroyed from me */
   AH_Job_Attach(j);
   AH_OutboxCBox_AddTodoJob(cbox, j);
+
+  if (AH_Job_GetTransferCount(j)<AH_Job_GetMaxTransfers(j) && AH_AccountJob_IsAccountJob(j))
+    _addOpenTransferJob(ob, j);
 }
 
 
@@ -516,6 +525,21 @@ int _sendAndRecvCustomerBoxes(AH_OUTBOX *ob)
 
 
 unsigned int _countTodoJobs(AH_OUTBOX *ob)
+{
+  return _countJobs(ob, 0);
+}
+
+
+
+/* only jobs exporting SEPA documents need a message id */
+unsigned int _countTodoSepaExportJobs(AH_OUTBOX *ob)
+{
+  return _countJobs(ob, 1);
+}
+
+
+
+unsigned int _countJobs(AH_OUTBOX *ob, int sepaExportOnly)
 {
   unsigned int cnt;
   AH_OUTBOX_CBOX *cbox;
@@ -527,10 +551,17 @@ unsigned int _countTodoJobs(AH_OUTBOX *ob)
     AH_JOBQUEUE_LIST *todoQueues;
     AH_JOB_LIST *todoJobs;
     AH_JOBQUEUE *jq;
+    AH_JOB *j;
 
     todoQueues=AH_OutboxCBox_GetTodoQueues(cbox);
     todoJobs=AH_OutboxCBox_GetTodoJobs(cbox);
-    cnt+=AH_Job_List_GetCount(todoJobs);
+    j=AH_Job_List_First(todoJobs);
+    while (j) {
+      if (_jobMatches(j, sepaExportOnly))
+        cnt++;
+      j=AH_Job_List_Next(j);
+    } /* while */
+
     jq=AH_JobQueue_List_First(todoQueues);
     while (jq) {
       if (!(AH_JobQueue_GetFlags(jq) & AH_JOBQUEUE_FLAGS_OUTBOX)) {
@@ -538,15 +569,13 @@ unsigned int _countTodoJobs(AH_OUTBOX *ob)
 
         jl=AH_JobQueue_GetJobList(jq);
         if (jl) {
-          AH_JOB *j;
-
           j=AH_Job_List_First(jl);
-	  while (j) {
-	    if (!(AH_Job_GetFlags(j) & AH_JOB_FLAGS_OUTBOX))
-	      cnt++;
+          while (j) {
+            if (!(AH_Job_GetFlags(j) & AH_JOB_FLAGS_OUTBOX) && _jobMatches(j, sepaExportOnly))
+              cnt++;
 
-	    j=AH_Job_List_Next(j);
-	  } /* while */
+            j=AH_Job_List_Next(j);
+          } /* while */
         }
       }
       jq=AH_JobQueue_List_Next(jq);
@@ -559,31 +588,33 @@ unsigned int _countTodoJobs(AH_OUTBOX *ob)
 
 
 
-AH_JOB *_findTransferJobInCheckJobList(const AH_JOB_LIST *jl, AB_USER *u, AB_ACCOUNT *a, const char *jobName)
+int _jobMatches(const AH_JOB *j, int sepaExportOnly)
 {
-  AH_JOB *j;
+  return (!sepaExportOnly || AH_Job_TransferBase_IsTransferBase(j));
+}
 
-  assert(jl);
-  j=AH_Job_List_First(jl);
-  while (j) {
-    DBG_INFO(AQHBCI_LOGDOMAIN, "Checking job \"%s\"", AH_Job_GetName(j));
-    if (strcasecmp(AH_Job_GetName(j), jobName)==0 &&
-        AH_AccountJob_GetAccount(j)==a) {
-      if (AH_Job_GetTransferCount(j)<AH_Job_GetMaxTransfers(j))
-        break;
-      else {
-        DBG_INFO(AQHBCI_LOGDOMAIN, "Job's already full");
-      }
-    }
-    else {
-      DBG_INFO(AQHBCI_LOGDOMAIN, "Job doesn't match");
-    }
 
-    j=AH_Job_List_Next(j);
-  } /* while */
 
-  return j;
+int _makeTransferJobKey(const AB_USER *u, const AB_ACCOUNT *a, const char *jobName, char *buffer, uint32_t size)
+{
+  char userIdBuf[16];
+  char accountIdBuf[16];
+
+  snprintf(userIdBuf, sizeof(userIdBuf), "%lu", (unsigned long int) AB_User_GetUniqueId(u));
+  snprintf(accountIdBuf, sizeof(accountIdBuf), "%lu", (unsigned long int) AB_Account_GetUniqueId(a));
+  return AB_HashIndex_MakeKey(buffer, size, userIdBuf, accountIdBuf, jobName);
 }
 
 
 
+void _addOpenTransferJob(AH_OUTBOX *ob, AH_JOB *j)
+{
+  AB_ACCOUNT *a;
+  char keyBuf[256];
+
+  a=AH_AccountJob_GetAccount(j);
+  if (a && _makeTransferJobKey(AH_Job_GetUser(j), a, AH_Job_GetName(j), keyBuf, sizeof(keyBuf))==0)
+    AB_HashIndex_Add(ob->openTransferJobs, keyBuf, j);
+}
+
+
@@ -16,6 +16,8 @@
 #include "aqhbci/joblayer/jobqueue_l.h"
 #include "aqhbci/applayer/cbox.h"
 
+#include <aqbanking/types/hashindex.h>
+
 #include <gwenhywfar/inherit.h>
 
 
@@ -26,6 +28,9 @@ struct AH_OUTBOX {
   AH_JOB_LIST *finishedJobs;
   AB_IMEXPORTER_CONTEXT *context;
 
+  /* multi-transfer jobs which can still take more transfers, key: user id, account id, job name */
+  AB_HASHINDEX *openTransferJobs;
+
   uint32_t usage;
 };
 
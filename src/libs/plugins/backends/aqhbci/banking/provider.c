@@ -189,6 +189,9 @@ int AH_Provider_Init(AB_PROVIDER *pro, GWEN_DB_NODE *dbData)
     DBG_INFO(AQHBCI_LOGDOMAIN, "here (%d)", rv);
   }
 
+  if (AB_Banking_RuntimeConfig_GetIntValue(AB_Provider_GetBanking(pro), "aqhbciStats", 0))
+    AH_Stats_SetEnabled(AH_HBCI_GetStats(hp->hbci), 1);
+
   if (lastVersion<currentVersion) {
     DBG_WARN(AQHBCI_LOGDOMAIN, "Updating configuration for AqHBCI (after init)");
     rv=AH_Provider_UpdatePostInit(pro, lastVersion, currentVersion);
@@ -258,6 +261,66 @@ const char *AH_Provider_GetProductVersion(const AB_PROVIDER *pro)
 
 
 
+void AH_Provider_SetStatsEnabled(AB_PROVIDER *pro, int b)
+{
+  AH_HBCI *h;
+
+  assert(pro);
+  h=AH_Provider_GetHbci(pro);
+  assert(h);
+  AH_Stats_SetEnabled(AH_HBCI_GetStats(h), b);
+}
+
+
+
+int AH_Provider_GetStatsEnabled(const AB_PROVIDER *pro)
+{
+  AH_HBCI *h;
+
+  assert(pro);
+  h=AH_Provider_GetHbci(pro);
+  assert(h);
+  return AH_Stats_GetEnabled(AH_HBCI_GetStats(h));
+}
+
+
+
+void AH_Provider_GetStats(const AB_PROVIDER *pro, GWEN_DB_NODE *db)
+{
+  AH_HBCI *h;
+
+  assert(pro);
+  h=AH_Provider_GetHbci(pro);
+  assert(h);
+  AH_Stats_toDb(AH_HBCI_GetStats(h), db);
+}
+
+
+
+void AH_Provider_DumpStats(const AB_PROVIDER *pro, GWEN_BUFFER *buf)
+{
+  AH_HBCI *h;
+
+  assert(pro);
+  h=AH_Provider_GetHbci(pro);
+  assert(h);
+  AH_Stats_Dump(AH_HBCI_GetStats(h), buf);
+}
+
+
+
+void AH_Provider_ResetStats(AB_PROVIDER *pro)
+{
+  AH_HBCI *h;
+
+  assert(pro);
+  h=AH_Provider_GetHbci(pro);
+  assert(h);
+  AH_Stats_Reset(AH_HBCI_GetStats(h));
+}
+
+
+
 
 
 
@@ -274,6 +337,32 @@ AH_HBCI *AH_Provider_GetHbci(const AB_PROVIDER *pro)
 
 
 
+AH_SEPA_EXPORT_CACHE *AH_Provider_GetSepaExportCache(const AB_PROVIDER *pro)
+{
+  AH_PROVIDER *hp;
+
+  assert(pro);
+  hp=GWEN_INHERIT_GETDATA(AB_PROVIDER, AH_PROVIDER, pro);
+  assert(hp);
+
+  return hp->sepaExportCache;
+}
+
+
+
+void AH_Provider_SetSepaExportCache(AB_PROVIDER *pro, AH_SEPA_EXPORT_CACHE *ec)
+{
+  AH_PROVIDER *hp;
+
+  assert(pro);
+  hp=GWEN_INHERIT_GETDATA(AB_PROVIDER, AH_PROVIDER, pro);
+  assert(hp);
+
+  hp->sepaExportCache=ec;
+}
+
+
+
 AB_ACCOUNT *AH_Provider_CreateAccountObject(AB_PROVIDER *pro)
 {
   return AH_Account_new(pro);
@@ -16,6 +16,8 @@
 #include <aqbanking/backendsupport/user.h>
 
 #include <gwenhywfar/ct.h>
+#include <gwenhywfar/db.h>
+#include <gwenhywfar/buffer.h>
 
 
 /** @defgroup G_AB_BE_AQHBCI HBCI Backend (AqHBCI)
@@ -60,6 +62,36 @@ const char *AH_Provider_GetProductVersion(const AB_PROVIDER *pro);
 
 
 
+/** @name Timing Statistics
+ *
+ * The backend can measure the time spent in every phase of the message pipeline
+ * (encoding, signing, encrypting, network, decrypting, verifying, decoding and job processing).
+ * Values are aggregated over all messages, per dialog, per user and per job type.
+ *
+ * Collecting is disabled by default, it can also be enabled by setting the runtime config
+ * variable "aqhbciStats" to a non-zero value before @ref AB_Banking_Init is called.
+ */
+/*@{*/
+void AH_Provider_SetStatsEnabled(AB_PROVIDER *pro, int b);
+int AH_Provider_GetStatsEnabled(const AB_PROVIDER *pro);
+
+/**
+ * Write the statistics collected so far into the given DB. Times are given in microseconds,
+ * 64 bit values are stored as decimal strings.
+ */
+void AH_Provider_GetStats(const AB_PROVIDER *pro, GWEN_DB_NODE *db);
+
+/**
+ * Append the statistics collected so far as human readable tables to the given buffer.
+ */
+void AH_Provider_DumpStats(const AB_PROVIDER *pro, GWEN_BUFFER *buf);
+
+void AH_Provider_ResetStats(AB_PROVIDER *pro);
+
+/*@}*/
+
+
+
 /**
  * Creates user keys for RDH type users.
  *
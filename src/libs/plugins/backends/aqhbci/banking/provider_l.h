@@ -14,10 +14,18 @@
 #include "aqhbci/tan/tanmethod.h"
 #include "aqhbci/joblayer/job_l.h"
 #include "hbci_l.h"
+#include "aqhbci/ajobs/sepaexportcache_l.h"
 
 
 AH_HBCI *AH_Provider_GetHbci(const AB_PROVIDER *pro);
 
+/**
+ * SEPA export cache of the outbox currently executed (if any). Jobs use this to share exporter profiles
+ * and reserved SEPA message ids. The cache is not owned by the provider.
+ */
+AH_SEPA_EXPORT_CACHE *AH_Provider_GetSepaExportCache(const AB_PROVIDER *pro);
+void AH_Provider_SetSepaExportCache(AB_PROVIDER *pro, AH_SEPA_EXPORT_CACHE *ec);
+
 
 int AH_Provider_SendDtazv(AB_PROVIDER *pro,
                           AB_USER *u,
@@ -24,6 +24,7 @@ typedef struct AH_PROVIDER AH_PROVIDER;
 struct AH_PROVIDER {
   AH_HBCI *hbci;
   GWEN_DB_NODE *dbTempConfig;
+  AH_SEPA_EXPORT_CACHE *sepaExportCache; /* only set while an outbox is executed, not owned */
 };
 static void GWENHYWFAR_CB AH_Provider_FreeData(void *bp, void *p);
 
@@ -42,6 +42,18 @@ static void showVersions()
 
 
 
+static void showStats(const AB_PROVIDER *pro)
+{
+  GWEN_BUFFER *sbuf;
+
+  sbuf=GWEN_Buffer_new(0, 1024, 0, 1);
+  AH_Provider_DumpStats(pro, sbuf);
+  fprintf(stdout, "\nTiming statistics:\n%s", GWEN_Buffer_GetStart(sbuf));
+  GWEN_Buffer_free(sbuf);
+}
+
+
+
 static void showUsage(const char *prgName)
 {
   GWEN_BUFFER *ubuf;
@@ -303,6 +315,9 @@ int AH_Control(AB_PROVIDER *pro, int argc, char **argv)
     rv=1;
   }
 
+  if (AH_Provider_GetStatsEnabled(pro))
+    showStats(pro);
+
   GWEN_DB_Group_free(db);
   return rv;
 }
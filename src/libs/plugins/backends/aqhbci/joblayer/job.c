@@ -1511,6 +1511,25 @@ AB_PROVIDER *AH_Job_GetProvider(const AH_JOB *j)
 
 
 
+uint64_t AH_Job_StatsStart(const AH_JOB *j)
+{
+  assert(j);
+  assert(j->usage);
+  return AH_Stats_Start(AH_HBCI_GetStats(AH_Provider_GetHbci(j->provider)));
+}
+
+
+
+void AH_Job_StatsStop(const AH_JOB *j, AH_STATS_PHASE ph, uint64_t startTime, uint32_t bytes)
+{
+  assert(j);
+  assert(j->usage);
+  if (startTime)
+    AH_Stats_Stop(AH_HBCI_GetStats(AH_Provider_GetHbci(j->provider)), ph, j->user, j->name, startTime, bytes);
+}
+
+
+
 void AH_Job_AddCommand(AH_JOB *j, AB_TRANSACTION *t)
 {
   assert(j);
@@ -35,7 +35,7 @@ static AB_ACCOUNT_LIST *_readAccounts(AH_JOB *j);
 static AB_ACCOUNT *_readAndSanitizeAccountData(AB_PROVIDER *pro, AH_BPD *bpd, GWEN_DB_NODE *dbAccountData);
 static void _removeEmpty(AH_JOB *j, AB_ACCOUNT_LIST *accList);
 static void _matchAccountsWithStoredAccountsAndAssignStoredId(AH_JOB *j, AB_ACCOUNT_LIST *accList);
-static uint32_t _findStored(AH_JOB *j, const AB_ACCOUNT *acc, AB_ACCOUNT_SPEC_LIST *asl);
+static uint32_t _findStored(AH_JOB *j, const AB_ACCOUNT *acc);
 static void _addOrModify(AH_JOB *j, AB_ACCOUNT *acc);
 static void _possiblyReplaceUpdJobsForAccountInLockedUser(AB_USER *user, AB_ACCOUNT *storedAcc,
                                                           GWEN_DB_NODE *dbTempUpd);
@@ -203,51 +203,39 @@ static void _removeEmpty(AH_JOB *j, AB_ACCOUNT_LIST *accList)
 
 void _matchAccountsWithStoredAccountsAndAssignStoredId(AH_JOB *j, AB_ACCOUNT_LIST *accList)
 {
+  AB_ACCOUNT *acc;
+
   /* find out which accounts are new */
   DBG_DEBUG(AQHBCI_LOGDOMAIN, "Checking for existing or to be added accounts");
-  if (AB_Account_List_GetCount(accList)) {
-    AB_BANKING *ab;
-    AB_ACCOUNT_SPEC_LIST *accountSpecList=NULL;
-    int rv;
-
-    ab=AH_Job_GetBankingApi(j);
-
-    accountSpecList=AB_AccountSpec_List_new();
-    rv=AB_Banking_GetAccountSpecList(ab, &accountSpecList);
-    if (rv<0) {
-      DBG_INFO(AQHBCI_LOGDOMAIN, "No account spec list");
+  acc=AB_Account_List_First(accList);
+  while (acc) {
+    uint32_t storedUid;
+
+    storedUid=_findStored(j, acc);
+    if (storedUid) {
+      DBG_INFO(AQHBCI_LOGDOMAIN, "Found a matching account (%x, %lu)", storedUid, (long unsigned int) storedUid);
+      AB_Account_SetUniqueId(acc, storedUid);
     }
-    else {
-      AB_ACCOUNT *acc;
 
-      acc=AB_Account_List_First(accList);
-      while (acc) {
-        uint32_t storedUid;
-
-        storedUid=_findStored(j, acc, accountSpecList);
-        if (storedUid) {
-          DBG_INFO(AQHBCI_LOGDOMAIN, "Found a matching account (%x, %lu)", storedUid, (long unsigned int) storedUid);
-          AB_Account_SetUniqueId(acc, storedUid);
-        }
-
-        acc=AB_Account_List_Next(acc);
-      }
-    }
-    AB_AccountSpec_List_free(accountSpecList);
+    acc=AB_Account_List_Next(acc);
   }
 }
 
 
 
-static uint32_t _findStored(AH_JOB *j, const AB_ACCOUNT *acc, AB_ACCOUNT_SPEC_LIST *asl)
+static uint32_t _findStored(AH_JOB *j, const AB_ACCOUNT *acc)
 {
+  AB_BANKING *ab;
   AB_PROVIDER *pro;
   const char *accountNum;
   const char *bankCode;
   const char *iban;
   int accountType;
+  AB_ACCOUNT_SPEC_LIST *candidateList=NULL;
   AB_ACCOUNT_SPEC *as=NULL;
+  uint32_t uniqueId=0;
 
+  ab=AH_Job_GetBankingApi(j);
   pro=AH_Job_GetProvider(j);
   assert(pro);
 
@@ -262,44 +250,48 @@ static uint32_t _findStored(AH_JOB *j, const AB_ACCOUNT *acc, AB_ACCOUNT_SPEC_LI
            iban?iban:"<none>",
            accountType);
 
-  if (iban && *iban && accountType>AB_AccountType_Unknown) {
+  /* only the account specs with the same IBAN or account number are candidates, get those via the indexed lookups */
+  if (iban && *iban && accountType>AB_AccountType_Unknown &&
+      AB_Banking_GetAccountSpecListByIban(ab, iban, &candidateList)==0) {
     DBG_DEBUG(AQHBCI_LOGDOMAIN, "Comparing IBAN and old account specs");
     /* IBAN given, try that first */
-    as=AB_AccountSpec_List_FindFirst(asl,
+    as=AB_AccountSpec_List_FindFirst(candidateList,
                                      AB_Provider_GetName(pro),
                                      NULL,                         /* country */
                                      NULL,                         /* bank code */
                                      NULL,                         /* account number */
                                      NULL,                         /* subAccountId */
-                                     AB_Account_GetIban(acc),     /* iban */
+                                     iban,                         /* iban */
                                      NULL, /* any currency */
                                      accountType);
+    if (as)
+      uniqueId=AB_AccountSpec_GetUniqueId(as);
+    AB_AccountSpec_List_free(candidateList);
+    candidateList=NULL;
   }
 
-  if (as==NULL) {
-    if (accountNum && *accountNum && bankCode && *bankCode && accountType>AB_AccountType_Unknown) {
+  if (uniqueId==0) {
+    if (accountNum && *accountNum && bankCode && *bankCode && accountType>AB_AccountType_Unknown &&
+        AB_Banking_GetAccountSpecListByBankCodeAndAccountNumber(ab, bankCode, accountNum, &candidateList)==0) {
       DBG_DEBUG(AQHBCI_LOGDOMAIN, "Comparing old account specs");
-      as=AB_AccountSpec_List_FindFirst(asl,
+      as=AB_AccountSpec_List_FindFirst(candidateList,
                                        AB_Provider_GetName(pro),
                                        AB_Account_GetCountry(acc),
-                                       AB_Account_GetBankCode(acc),
-                                       AB_Account_GetAccountNumber(acc),
+                                       bankCode,
+                                       accountNum,
                                        AB_Account_GetSubAccountId(acc),
                                        NULL,
                                        NULL, /* any currency */
                                        accountType);
+      if (as)
+        uniqueId=AB_AccountSpec_GetUniqueId(as);
+      AB_AccountSpec_List_free(candidateList);
     }
   }
 
-  if (as) {
-    uint32_t uniqueId;
-
-    uniqueId=AB_AccountSpec_GetUniqueId(as);
+  if (uniqueId)
     DBG_DEBUG(AQHBCI_LOGDOMAIN, "Found a matching account (%lu)", (long unsigned int) uniqueId);
-    return uniqueId;
-  }
-
-  return 0;
+  return uniqueId;
 }
 
 
@@ -380,6 +380,16 @@ void AH_Job_ReadAccountDataSeg(AB_ACCOUNT *acc, GWEN_DB_NODE *dbAccountData);
 AB_PROVIDER *AH_Job_GetProvider(const AH_JOB *j);
 
 
+/**
+ * Time a phase of the message pipeline for the statistics of the provider (see @ref AH_STATS).
+ * The time is accounted to the owner and the type of this job.
+ * @ref AH_Job_StatsStart returns 0 if statistics are disabled, in that case
+ * @ref AH_Job_StatsStop does nothing.
+ */
+uint64_t AH_Job_StatsStart(const AH_JOB *j);
+void AH_Job_StatsStop(const AH_JOB *j, AH_STATS_PHASE ph, uint64_t startTime, uint32_t bytes);
+
+
 /* Get job from list by id */
 AH_JOB *AH_Job_List_GetById(AH_JOB_LIST *jl, uint32_t id);
 
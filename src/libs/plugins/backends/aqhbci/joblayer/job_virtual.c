@@ -23,20 +23,25 @@
 
 int AH_Job_Process(AH_JOB *j, AB_IMEXPORTER_CONTEXT *ctx)
 {
+  uint64_t t0;
+  int rv;
 
   assert(j);
   assert(j->usage);
 
   DBG_INFO(AQHBCI_LOGDOMAIN, "Processing job \"%s\" (%llu)", AH_Job_GetName(j), (unsigned long long int) AH_Job_GetId(j));
 
+  t0=AH_Job_StatsStart(j);
   AH_Job_SampleResults(j);
 
   if (j->processFn)
-    return j->processFn(j, ctx);
+    rv=j->processFn(j, ctx);
   else {
     DBG_INFO(AQHBCI_LOGDOMAIN, "No processFn set");
-    return AH_Job_DefaultProcessHandler(j);
+    rv=AH_Job_DefaultProcessHandler(j);
   }
+  AH_Job_StatsStop(j, AH_StatsPhase_Process, t0, 0);
+  return rv;
 }
 
 
@@ -52,6 +52,7 @@ AH_MSG *AH_JobQueue_ToMessageWithTan(AH_JOBQUEUE *jq, AH_DIALOG *dlg, const char
 {
   AH_MSG *msg;
   int rv;
+  uint64_t t0;
 
   assert(jq);
   assert(dlg);
@@ -69,12 +70,14 @@ AH_MSG *AH_JobQueue_ToMessageWithTan(AH_JOBQUEUE *jq, AH_DIALOG *dlg, const char
     return NULL;
   }
 
+  t0=AH_Dialog_StatsStart(dlg);
   rv=_encodeJobs(jq, msg);
   if (rv<0) {
     DBG_INFO(AQHBCI_LOGDOMAIN, "here (%d)", rv);
     AH_Msg_free(msg);
     return NULL;
   }
+  AH_Dialog_StatsStop(dlg, AH_StatsPhase_Encode, t0, 0);
 
   rv=AH_Msg_EncodeMsg(msg);
   if (rv) {
@@ -58,6 +58,7 @@ AH_DIALOG *AH_Dialog_new(AB_USER *u, AB_PROVIDER *pro)
 
   dlg->provider=pro;
   dlg->dialogOwner=u;
+  dlg->stats=AH_HBCI_GetStats(h);
 
   /* create path */
   pbuf=GWEN_Buffer_new(0, 256, 0, 1);
@@ -256,11 +257,18 @@ uint32_t AH_Dialog_GetLastMsgNum(const AH_DIALOG *dlg)
 /* network stuff */
 int AH_Dialog_RecvMessage(AH_DIALOG *dlg, AH_MSG **pMsg)
 {
+  uint64_t t0;
+  int rv;
+
   assert(dlg);
+  t0=AH_Dialog_StatsStart(dlg);
   if (AH_User_GetCryptMode(dlg->dialogOwner)==AH_CryptMode_Pintan)
-    return AH_Dialog_RecvMessage_Https(dlg, pMsg);
+    rv=AH_Dialog_RecvMessage_Https(dlg, pMsg);
   else
-    return AH_Dialog_RecvMessage_Hbci(dlg, pMsg);
+    rv=AH_Dialog_RecvMessage_Hbci(dlg, pMsg);
+  if (rv==0 && *pMsg)
+    AH_Dialog_StatsStop(dlg, AH_StatsPhase_Receive, t0, GWEN_Buffer_GetUsedBytes(AH_Msg_GetBuffer(*pMsg)));
+  return rv;
 }
 
 
@@ -280,6 +288,7 @@ int AH_Dialog_SendMessage(AH_DIALOG *dlg, AH_MSG *msg)
 {
   int rv;
   GWEN_BUFFER *mbuf;
+  uint64_t t0;
 
   assert(dlg);
   assert(msg);
@@ -292,6 +301,7 @@ int AH_Dialog_SendMessage(AH_DIALOG *dlg, AH_MSG *msg)
   mbuf=AH_Msg_GetBuffer(msg);
   assert(mbuf);
 
+  t0=AH_Dialog_StatsStart(dlg);
   rv=AH_Dialog_SendPacket(dlg,
                           GWEN_Buffer_GetStart(mbuf),
                           GWEN_Buffer_GetUsedBytes(mbuf));
@@ -299,6 +309,8 @@ int AH_Dialog_SendMessage(AH_DIALOG *dlg, AH_MSG *msg)
     DBG_ERROR(AQHBCI_LOGDOMAIN, "Error sending message for dialog (%d)", rv);
     return rv;
   }
+  AH_Dialog_StatsStop(dlg, AH_StatsPhase_Send, t0, GWEN_Buffer_GetUsedBytes(mbuf));
+  dlg->statsMessages++;
   DBG_DEBUG(AQHBCI_LOGDOMAIN, "Message sent");
   return 0;
 }
@@ -328,6 +340,10 @@ int AH_Dialog_ExchangeMessages(AH_DIALOG *dlg, AH_MSG *msgToSend, AH_MSG **pMsgR
 
 int AH_Dialog_Connect(AH_DIALOG *dlg)
 {
+  dlg->statsStartTime=AH_Stats_Start(dlg->stats);
+  dlg->statsMessages=0;
+  memset(dlg->statsPhaseUsecs, 0, sizeof(dlg->statsPhaseUsecs));
+
   AH_Dialog_AddFlags(dlg, AH_DIALOG_FLAGS_INITIATOR);
   if (AH_User_GetCryptMode(dlg->dialogOwner)==AH_CryptMode_Pintan)
     return AH_Dialog_Connect_Https(dlg);
@@ -339,6 +355,12 @@ int AH_Dialog_Connect(AH_DIALOG *dlg)
 
 int AH_Dialog_Disconnect(AH_DIALOG *dlg)
 {
+  if (dlg->statsStartTime) {
+    AH_Stats_AddDialog(dlg->stats, dlg->dialogOwner, AH_Stats_Elapsed(dlg->statsStartTime),
+                       dlg->statsMessages, dlg->statsPhaseUsecs);
+    dlg->statsStartTime=0;
+  }
+
   if (AH_User_GetCryptMode(dlg->dialogOwner)==AH_CryptMode_Pintan)
     return AH_Dialog_Disconnect_Https(dlg);
   else
@@ -347,6 +369,39 @@ int AH_Dialog_Disconnect(AH_DIALOG *dlg)
 
 
 
+uint64_t AH_Dialog_StatsStart(const AH_DIALOG *dlg)
+{
+  assert(dlg);
+  return AH_Stats_Start(dlg->stats);
+}
+
+
+
+uint64_t AH_Dialog_StatsStop(AH_DIALOG *dlg, AH_STATS_PHASE ph, uint64_t startTime, uint32_t bytes)
+{
+  uint64_t usecs;
+
+  assert(dlg);
+  if (startTime==0)
+    return 0;
+  usecs=AH_Stats_Elapsed(startTime);
+  AH_Dialog_StatsAdd(dlg, ph, usecs, bytes);
+  return usecs;
+}
+
+
+
+void AH_Dialog_StatsAdd(AH_DIALOG *dlg, AH_STATS_PHASE ph, uint64_t usecs, uint32_t bytes)
+{
+  assert(dlg);
+  if (ph>=0 && ph<AH_StatsPhase_Count) {
+    AH_Stats_AddTime(dlg->stats, ph, dlg->dialogOwner, NULL, usecs, bytes);
+    dlg->statsPhaseUsecs[ph]+=usecs;
+  }
+}
+
+
+
 void AH_Dialog_SetItanMethod(AH_DIALOG *dlg, uint32_t i)
 {
   assert(dlg);
@@ -79,6 +79,15 @@ int AH_Dialog_SendMessage(AH_DIALOG *dlg, AH_MSG *msg);
 
 AH_HBCI *AH_Dialog_GetHbci(const AH_DIALOG *dlg);
 
+/**
+ * Time a phase of the message pipeline for the statistics of this dialog (see @ref AH_STATS).
+ * @ref AH_Dialog_StatsStart returns 0 if statistics are disabled, in that case
+ * @ref AH_Dialog_StatsStop does nothing.
+ */
+uint64_t AH_Dialog_StatsStart(const AH_DIALOG *dlg);
+uint64_t AH_Dialog_StatsStop(AH_DIALOG *dlg, AH_STATS_PHASE ph, uint64_t startTime, uint32_t bytes);
+void AH_Dialog_StatsAdd(AH_DIALOG *dlg, AH_STATS_PHASE ph, uint64_t usecs, uint32_t bytes);
+
 void AH_Dialog_SetItanMethod(AH_DIALOG *dlg, uint32_t i);
 uint32_t AH_Dialog_GetItanMethod(const AH_DIALOG *dlg);
 
@@ -43,6 +43,12 @@ struct AH_DIALOG {
   int tanJobVersion;
 
   AH_TAN_METHOD *tanMethodDescription;
+
+  /* timing statistics, only collected while stats are enabled */
+  AH_STATS *stats;
+  uint64_t statsStartTime;
+  uint32_t statsMessages;
+  uint64_t statsPhaseUsecs[AH_StatsPhase_Count];
 };
 
 
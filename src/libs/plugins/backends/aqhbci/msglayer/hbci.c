@@ -77,6 +77,8 @@ AH_HBCI *AH_HBCI_new(AB_PROVIDER *pro)
   hbci->transferTimeout=AH_HBCI_DEFAULT_TRANSFER_TIMEOUT;
   hbci->connectTimeout=AH_HBCI_DEFAULT_CONNECT_TIMEOUT;
 
+  hbci->stats=AH_Stats_new();
+
   return hbci;
 }
 
@@ -93,6 +95,8 @@ void AH_HBCI_free(AH_HBCI *hbci)
 
     GWEN_XMLNode_free(hbci->defs);
 
+    AH_Stats_free(hbci->stats);
+
     GWEN_FREE_OBJECT(hbci);
     GWEN_Logger_Close(AQHBCI_LOGDOMAIN);
   }
@@ -196,6 +200,14 @@ AB_BANKING *AH_HBCI_GetBankingApi(const AH_HBCI *hbci)
 
 
 
+AH_STATS *AH_HBCI_GetStats(const AH_HBCI *hbci)
+{
+  assert(hbci);
+  return hbci->stats;
+}
+
+
+
 GWEN_DB_NODE *AH_HBCI_GetProviderDb(const AH_HBCI *hbci)
 {
   assert(hbci);
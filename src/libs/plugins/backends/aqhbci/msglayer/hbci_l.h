@@ -25,6 +25,7 @@ typedef struct AH_HBCI AH_HBCI;
 
 #include "aqhbci/banking/user.h"
 #include "aqhbci/banking/account.h"
+#include "aqhbci/msglayer/hbcistats_l.h"
 
 
 #define AH_DEFAULT_KEYLEN 768
@@ -94,6 +95,11 @@ const char *AH_HBCI_GetProductVersion(const AH_HBCI *hbci);
 AB_BANKING *AH_HBCI_GetBankingApi(const AH_HBCI *hbci);
 AB_PROVIDER *AH_HBCI_GetProvider(const AH_HBCI *hbci);
 
+/**
+ * Timing statistics of the message pipeline (see @ref AH_STATS).
+ */
+AH_STATS *AH_HBCI_GetStats(const AH_HBCI *hbci);
+
 /*@}*/
 
 
@@ -45,6 +45,8 @@ struct AH_HBCI {
   uint32_t lastVersion;
 
   GWEN_DB_NODE *dbProviderConfig;
+
+  AH_STATS *stats;
 };
 
 
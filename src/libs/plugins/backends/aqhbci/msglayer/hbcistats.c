@@ -0,0 +1,494 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ *          Please see toplevel file COPYING for license details           *
+ ***************************************************************************/
+
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+
+#include "hbcistats_p.h"
+#include "aqhbci_l.h"
+
+#include <gwenhywfar/debug.h>
+#include <gwenhywfar/misc.h>
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef OS_WIN32
+# include <windows.h>
+#else
+# include <time.h>
+#endif
+
+
+
+GWEN_LIST_FUNCTIONS(AH_STATS_ENTRY, AH_StatsEntry)
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * forward declarations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+
+static uint64_t _now(void);
+
+static AH_STATS_ENTRY *_entryNew(const char *name);
+static void _entryFree(AH_STATS_ENTRY *e);
+static void _clearEntryList(AH_STATS_ENTRY_LIST *el);
+static AH_STATS_ENTRY *_getEntry(AH_STATS_ENTRY_LIST *el, const char *name);
+static AH_STATS_ENTRY *_getUserEntry(AH_STATS *st, const AB_USER *u);
+
+static void _addSample(AH_STATS_TIMER *tm, uint64_t usecs, uint32_t bytes);
+
+static void _setUint64(GWEN_DB_NODE *db, const char *name, uint64_t v);
+static void _timerToDb(const AH_STATS_TIMER *tm, GWEN_DB_NODE *db);
+static void _phasesToDb(const AH_STATS_TIMER *phases, GWEN_DB_NODE *db);
+static void _entryListToDb(const AH_STATS_ENTRY_LIST *el, const char *groupName, GWEN_DB_NODE *db);
+
+static void _dumpTableHeader(const char *title, GWEN_BUFFER *buf);
+static void _dumpTimer(const char *name, const AH_STATS_TIMER *tm, GWEN_BUFFER *buf);
+static void _dumpPhases(const AH_STATS_TIMER *phases, GWEN_BUFFER *buf);
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * static data
+ * ------------------------------------------------------------------------------------------------
+ */
+
+static const char *_phaseNames[AH_StatsPhase_Count]= {
+  "encode",
+  "sign",
+  "encrypt",
+  "send",
+  "receive",
+  "decrypt",
+  "verify",
+  "decode",
+  "process",
+  "import"
+};
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * implementations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+
+
+AH_STATS *AH_Stats_new(void)
+{
+  AH_STATS *st;
+
+  GWEN_NEW_OBJECT(AH_STATS, st);
+  st->userList=AH_StatsEntry_List_new();
+  st->jobList=AH_StatsEntry_List_new();
+  return st;
+}
+
+
+
+void AH_Stats_free(AH_STATS *st)
+{
+  if (st) {
+    _clearEntryList(st->userList);
+    AH_StatsEntry_List_free(st->userList);
+    _clearEntryList(st->jobList);
+    AH_StatsEntry_List_free(st->jobList);
+    GWEN_FREE_OBJECT(st);
+  }
+}
+
+
+
+void AH_Stats_SetEnabled(AH_STATS *st, int b)
+{
+  assert(st);
+  st->enabled=b?1:0;
+}
+
+
+
+int AH_Stats_GetEnabled(const AH_STATS *st)
+{
+  assert(st);
+  return st->enabled;
+}
+
+
+
+void AH_Stats_Reset(AH_STATS *st)
+{
+  assert(st);
+  memset(st->total, 0, sizeof(st->total));
+  memset(&(st->dialogDuration), 0, sizeof(st->dialogDuration));
+  memset(st->dialogPhases, 0, sizeof(st->dialogPhases));
+  st->dialogMessages=0;
+  _clearEntryList(st->userList);
+  _clearEntryList(st->jobList);
+}
+
+
+
+uint64_t AH_Stats_Start(const AH_STATS *st)
+{
+  if (st && st->enabled)
+    return _now();
+  return 0;
+}
+
+
+
+uint64_t AH_Stats_Elapsed(uint64_t startTime)
+{
+  if (startTime) {
+    uint64_t t;
+
+    t=_now();
+    return (t>startTime)?(t-startTime):0;
+  }
+  return 0;
+}
+
+
+
+uint64_t AH_Stats_Stop(AH_STATS *st, AH_STATS_PHASE ph, const AB_USER *u, const char *jobName,
+                       uint64_t startTime, uint32_t bytes)
+{
+  uint64_t usecs;
+
+  if (startTime==0)
+    return 0;
+  usecs=AH_Stats_Elapsed(startTime);
+  AH_Stats_AddTime(st, ph, u, jobName, usecs, bytes);
+  return usecs;
+}
+
+
+
+void AH_Stats_AddTime(AH_STATS *st, AH_STATS_PHASE ph, const AB_USER *u, const char *jobName,
+                      uint64_t usecs, uint32_t bytes)
+{
+  AH_STATS_ENTRY *e;
+
+  if (st==NULL || !(st->enabled) || ph<0 || ph>=AH_StatsPhase_Count)
+    return;
+
+  _addSample(&(st->total[ph]), usecs, bytes);
+
+  e=_getUserEntry(st, u);
+  if (e)
+    _addSample(&(e->phases[ph]), usecs, bytes);
+
+  if (jobName && *jobName) {
+    e=_getEntry(st->jobList, jobName);
+    _addSample(&(e->phases[ph]), usecs, bytes);
+  }
+}
+
+
+
+void AH_Stats_AddDialog(AH_STATS *st, const AB_USER *u, uint64_t usecs, uint32_t messages, const uint64_t *phaseUsecs)
+{
+  AH_STATS_ENTRY *e;
+  int i;
+
+  if (st==NULL || !(st->enabled))
+    return;
+
+  _addSample(&(st->dialogDuration), usecs, 0);
+  st->dialogMessages+=messages;
+  if (phaseUsecs) {
+    for (i=0; i<AH_StatsPhase_Count; i++)
+      _addSample(&(st->dialogPhases[i]), phaseUsecs[i], 0);
+  }
+
+  e=_getUserEntry(st, u);
+  if (e)
+    e->dialogs++;
+}
+
+
+
+void AH_Stats_toDb(const AH_STATS *st, GWEN_DB_NODE *db)
+{
+  GWEN_DB_NODE *dbT;
+
+  assert(st);
+  assert(db);
+
+  GWEN_DB_SetIntValue(db, GWEN_DB_FLAGS_OVERWRITE_VARS, "enabled", st->enabled);
+
+  dbT=GWEN_DB_GetGroup(db, GWEN_DB_FLAGS_OVERWRITE_GROUPS, "total");
+  _phasesToDb(st->total, dbT);
+
+  dbT=GWEN_DB_GetGroup(db, GWEN_DB_FLAGS_OVERWRITE_GROUPS, "dialogs");
+  GWEN_DB_SetIntValue(dbT, GWEN_DB_FLAGS_OVERWRITE_VARS, "count", (int) st->dialogDuration.count);
+  _setUint64(dbT, "messages", st->dialogMessages);
+  _timerToDb(&(st->dialogDuration), GWEN_DB_GetGroup(dbT, GWEN_DB_FLAGS_OVERWRITE_GROUPS, "duration"));
+  _phasesToDb(st->dialogPhases, GWEN_DB_GetGroup(dbT, GWEN_DB_FLAGS_OVERWRITE_GROUPS, "perDialog"));
+
+  GWEN_DB_DeleteGroup(db, "user");
+  _entryListToDb(st->userList, "user", db);
+  GWEN_DB_DeleteGroup(db, "job");
+  _entryListToDb(st->jobList, "job", db);
+}
+
+
+
+void AH_Stats_Dump(const AH_STATS *st, GWEN_BUFFER *buf)
+{
+  const AH_STATS_ENTRY *e;
+
+  assert(st);
+  assert(buf);
+
+  if (!(st->enabled))
+    GWEN_Buffer_AppendString(buf, "Statistics are disabled.\n");
+
+  _dumpTableHeader("All messages", buf);
+  _dumpPhases(st->total, buf);
+
+  GWEN_Buffer_AppendArgs(buf, "\nDialogs: %lu, messages sent: %llu\n",
+                         (unsigned long) st->dialogDuration.count, (unsigned long long) st->dialogMessages);
+  if (st->dialogDuration.count) {
+    _dumpTableHeader("Per dialog", buf);
+    _dumpTimer("duration", &(st->dialogDuration), buf);
+    _dumpPhases(st->dialogPhases, buf);
+  }
+
+  e=AH_StatsEntry_List_First(st->userList);
+  while (e) {
+    GWEN_Buffer_AppendString(buf, "\n");
+    GWEN_Buffer_AppendArgs(buf, "User %s (%lu dialogs)\n", e->name, (unsigned long) e->dialogs);
+    _dumpTableHeader(NULL, buf);
+    _dumpPhases(e->phases, buf);
+    e=AH_StatsEntry_List_Next(e);
+  }
+
+  e=AH_StatsEntry_List_First(st->jobList);
+  while (e) {
+    GWEN_Buffer_AppendString(buf, "\n");
+    GWEN_Buffer_AppendArgs(buf, "Job %s\n", e->name);
+    _dumpTableHeader(NULL, buf);
+    _dumpPhases(e->phases, buf);
+    e=AH_StatsEntry_List_Next(e);
+  }
+}
+
+
+
+const char *AH_StatsPhase_toString(AH_STATS_PHASE ph)
+{
+  if (ph>=0 && ph<AH_StatsPhase_Count)
+    return _phaseNames[ph];
+  return "unknown";
+}
+
+
+
+uint64_t _now(void)
+{
+#ifdef OS_WIN32
+  static LARGE_INTEGER freq= {0};
+  LARGE_INTEGER cnt;
+
+  if (freq.QuadPart==0)
+    QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&cnt);
+  return (uint64_t)((cnt.QuadPart*1000000.0)/freq.QuadPart);
+#else
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (((uint64_t) ts.tv_sec)*1000000)+(ts.tv_nsec/1000);
+#endif
+}
+
+
+
+AH_STATS_ENTRY *_entryNew(const char *name)
+{
+  AH_STATS_ENTRY *e;
+
+  GWEN_NEW_OBJECT(AH_STATS_ENTRY, e);
+  GWEN_LIST_INIT(AH_STATS_ENTRY, e);
+  e->name=strdup(name);
+  return e;
+}
+
+
+
+void _entryFree(AH_STATS_ENTRY *e)
+{
+  if (e) {
+    GWEN_LIST_FINI(AH_STATS_ENTRY, e);
+    free(e->name);
+    GWEN_FREE_OBJECT(e);
+  }
+}
+
+
+
+void _clearEntryList(AH_STATS_ENTRY_LIST *el)
+{
+  AH_STATS_ENTRY *e;
+
+  while ((e=AH_StatsEntry_List_First(el))) {
+    AH_StatsEntry_List_Del(e);
+    _entryFree(e);
+  }
+}
+
+
+
+AH_STATS_ENTRY *_getEntry(AH_STATS_ENTRY_LIST *el, const char *name)
+{
+  AH_STATS_ENTRY *e;
+
+  /* only a few users and job types, so a linear search is good enough */
+  e=AH_StatsEntry_List_First(el);
+  while (e) {
+    if (strcmp(e->name, name)==0)
+      return e;
+    e=AH_StatsEntry_List_Next(e);
+  }
+
+  e=_entryNew(name);
+  AH_StatsEntry_List_Add(e, el);
+  return e;
+}
+
+
+
+AH_STATS_ENTRY *_getUserEntry(AH_STATS *st, const AB_USER *u)
+{
+  char nameBuf[160];
+  const char *s;
+
+  if (u==NULL)
+    return NULL;
+
+  s=AB_User_GetBankCode(u);
+  snprintf(nameBuf, sizeof(nameBuf), "%s@%s",
+           AB_User_GetUserId(u)?AB_User_GetUserId(u):"(none)",
+           s?s:"(none)");
+  return _getEntry(st->userList, nameBuf);
+}
+
+
+
+void _addSample(AH_STATS_TIMER *tm, uint64_t usecs, uint32_t bytes)
+{
+  if (tm->count==0 || usecs<tm->minUsecs)
+    tm->minUsecs=usecs;
+  if (usecs>tm->maxUsecs)
+    tm->maxUsecs=usecs;
+  tm->totalUsecs+=usecs;
+  tm->bytes+=bytes;
+  tm->count++;
+}
+
+
+
+void _setUint64(GWEN_DB_NODE *db, const char *name, uint64_t v)
+{
+  char numbuf[32];
+
+  snprintf(numbuf, sizeof(numbuf), "%llu", (unsigned long long) v);
+  GWEN_DB_SetCharValue(db, GWEN_DB_FLAGS_OVERWRITE_VARS, name, numbuf);
+}
+
+
+
+void _timerToDb(const AH_STATS_TIMER *tm, GWEN_DB_NODE *db)
+{
+  GWEN_DB_SetIntValue(db, GWEN_DB_FLAGS_OVERWRITE_VARS, "count", (int) tm->count);
+  _setUint64(db, "totalUsecs", tm->totalUsecs);
+  _setUint64(db, "avgUsecs", tm->count?(tm->totalUsecs/tm->count):0);
+  _setUint64(db, "minUsecs", tm->minUsecs);
+  _setUint64(db, "maxUsecs", tm->maxUsecs);
+  _setUint64(db, "bytes", tm->bytes);
+}
+
+
+
+void _phasesToDb(const AH_STATS_TIMER *phases, GWEN_DB_NODE *db)
+{
+  int i;
+
+  for (i=0; i<AH_StatsPhase_Count; i++) {
+    if (phases[i].count)
+      _timerToDb(&(phases[i]), GWEN_DB_GetGroup(db, GWEN_DB_FLAGS_OVERWRITE_GROUPS, _phaseNames[i]));
+  }
+}
+
+
+
+void _entryListToDb(const AH_STATS_ENTRY_LIST *el, const char *groupName, GWEN_DB_NODE *db)
+{
+  const AH_STATS_ENTRY *e;
+
+  e=AH_StatsEntry_List_First(el);
+  while (e) {
+    GWEN_DB_NODE *dbE;
+
+    dbE=GWEN_DB_GetGroup(db, GWEN_PATH_FLAGS_CREATE_GROUP, groupName);
+    GWEN_DB_SetCharValue(dbE, GWEN_DB_FLAGS_OVERWRITE_VARS, "name", e->name);
+    if (e->dialogs)
+      GWEN_DB_SetIntValue(dbE, GWEN_DB_FLAGS_OVERWRITE_VARS, "dialogs", (int) e->dialogs);
+    _phasesToDb(e->phases, dbE);
+    e=AH_StatsEntry_List_Next(e);
+  }
+}
+
+
+
+void _dumpTableHeader(const char *title, GWEN_BUFFER *buf)
+{
+  if (title)
+    GWEN_Buffer_AppendArgs(buf, "%s\n", title);
+  GWEN_Buffer_AppendArgs(buf, "  %-10s %8s %12s %10s %10s %10s %12s\n",
+                         "Phase", "Count", "Total ms", "Avg ms", "Min ms", "Max ms", "Bytes");
+}
+
+
+
+void _dumpTimer(const char *name, const AH_STATS_TIMER *tm, GWEN_BUFFER *buf)
+{
+  GWEN_Buffer_AppendArgs(buf, "  %-10s %8lu %12.3f %10.3f %10.3f %10.3f %12llu\n",
+                         name,
+                         (unsigned long) tm->count,
+                         tm->totalUsecs/1000.0,
+                         tm->count?((tm->totalUsecs/1000.0)/tm->count):0.0,
+                         tm->minUsecs/1000.0,
+                         tm->maxUsecs/1000.0,
+                         (unsigned long long) tm->bytes);
+}
+
+
+
+void _dumpPhases(const AH_STATS_TIMER *phases, GWEN_BUFFER *buf)
+{
+  int i;
+
+  for (i=0; i<AH_StatsPhase_Count; i++) {
+    if (phases[i].count)
+      _dumpTimer(_phaseNames[i], &(phases[i]), buf);
+  }
+}
+
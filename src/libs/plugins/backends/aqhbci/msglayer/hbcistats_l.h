@@ -0,0 +1,103 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ *          Please see toplevel file COPYING for license details           *
+ ***************************************************************************/
+
+
+#ifndef AH_HBCISTATS_L_H
+#define AH_HBCISTATS_L_H
+
+
+#include <aqbanking/backendsupport/user.h>
+
+#include <gwenhywfar/db.h>
+#include <gwenhywfar/buffer.h>
+
+
+/**
+ * Timing statistics for the HBCI message pipeline.
+ *
+ * Every phase is aggregated over all messages (total), per user and per job type (only for the phases
+ * which belong to a single job: process and import). Additionally the sum of all phases of a dialog is
+ * sampled when the dialog is closed, so minimum, average and maximum per dialog are available.
+ *
+ * When disabled @ref AH_Stats_Start returns 0 without reading the clock and all other functions return
+ * immediately for a start time of 0, so instrumented code doesn't need to check whether collecting is enabled.
+ */
+typedef struct AH_STATS AH_STATS;
+
+
+typedef enum {
+  AH_StatsPhase_Encode=0,  /**< creating segments and message head/tail (without sign and encrypt) */
+  AH_StatsPhase_Sign,
+  AH_StatsPhase_Encrypt,
+  AH_StatsPhase_Send,
+  AH_StatsPhase_Receive,
+  AH_StatsPhase_Decrypt,
+  AH_StatsPhase_Verify,
+  AH_StatsPhase_Decode,    /**< parsing the message (without decrypt and verify) */
+  AH_StatsPhase_Process,   /**< AH_Job_Process (includes import) */
+  AH_StatsPhase_Import,    /**< im-/exporter calls of jobs */
+  AH_StatsPhase_Count
+} AH_STATS_PHASE;
+
+
+AH_STATS *AH_Stats_new(void);
+void AH_Stats_free(AH_STATS *st);
+
+void AH_Stats_SetEnabled(AH_STATS *st, int b);
+int AH_Stats_GetEnabled(const AH_STATS *st);
+
+void AH_Stats_Reset(AH_STATS *st);
+
+
+/**
+ * @return current time in microseconds or 0 if collecting is disabled
+ */
+uint64_t AH_Stats_Start(const AH_STATS *st);
+
+/**
+ * @return microseconds since the given start time (0 if startTime is 0)
+ */
+uint64_t AH_Stats_Elapsed(uint64_t startTime);
+
+/**
+ * Add the time since startTime to the given phase. Does nothing if startTime is 0.
+ * @return microseconds added
+ * @param u user (may be NULL)
+ * @param jobName job type (may be NULL, only used for phases belonging to a single job)
+ * @param bytes number of bytes handled
+ */
+uint64_t AH_Stats_Stop(AH_STATS *st, AH_STATS_PHASE ph, const AB_USER *u, const char *jobName,
+                       uint64_t startTime, uint32_t bytes);
+
+void AH_Stats_AddTime(AH_STATS *st, AH_STATS_PHASE ph, const AB_USER *u, const char *jobName,
+                      uint64_t usecs, uint32_t bytes);
+
+/**
+ * Sample a finished dialog.
+ * @param phaseUsecs array of AH_StatsPhase_Count entries with the time spent in every phase in this dialog
+ */
+void AH_Stats_AddDialog(AH_STATS *st, const AB_USER *u, uint64_t usecs, uint32_t messages, const uint64_t *phaseUsecs);
+
+
+/**
+ * Write the statistics to the given DB. Times are in microseconds, 64 bit values are stored as
+ * decimal strings.
+ */
+void AH_Stats_toDb(const AH_STATS *st, GWEN_DB_NODE *db);
+
+/**
+ * Write the statistics as human readable tables.
+ */
+void AH_Stats_Dump(const AH_STATS *st, GWEN_BUFFER *buf);
+
+
+const char *AH_StatsPhase_toString(AH_STATS_PHASE ph);
+
+
+#endif
@@ -0,0 +1,56 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ *          Please see toplevel file COPYING for license details           *
+ ***************************************************************************/
+
+
+#ifndef AH_HBCISTATS_P_H
+#define AH_HBCISTATS_P_H
+
+
+#include "hbcistats_l.h"
+
+#include <gwenhywfar/list.h>
+
+
+typedef struct AH_STATS_TIMER AH_STATS_TIMER;
+struct AH_STATS_TIMER {
+  uint32_t count;
+  uint64_t totalUsecs;
+  uint64_t minUsecs;
+  uint64_t maxUsecs;
+  uint64_t bytes;
+};
+
+
+/* aggregated values for a single user or job type */
+typedef struct AH_STATS_ENTRY AH_STATS_ENTRY;
+GWEN_LIST_FUNCTION_DEFS(AH_STATS_ENTRY, AH_StatsEntry)
+struct AH_STATS_ENTRY {
+  GWEN_LIST_ELEMENT(AH_STATS_ENTRY);
+  char *name;
+  uint32_t dialogs;
+  AH_STATS_TIMER phases[AH_StatsPhase_Count];
+};
+
+
+struct AH_STATS {
+  int enabled;
+
+  AH_STATS_TIMER total[AH_StatsPhase_Count];
+
+  /* samples are the sums per dialog */
+  AH_STATS_TIMER dialogDuration;
+  AH_STATS_TIMER dialogPhases[AH_StatsPhase_Count];
+  uint64_t dialogMessages;
+
+  AH_STATS_ENTRY_LIST *userList;
+  AH_STATS_ENTRY_LIST *jobList;
+};
+
+
+#endif
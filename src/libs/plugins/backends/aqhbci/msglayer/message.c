@@ -572,9 +572,14 @@ int AH_Msg_EncodeMsg(AH_MSG *hmsg)
 {
   GWEN_MSGENGINE *e;
   int rv;
+  uint64_t tStart;
+  uint64_t tPhase;
+  uint64_t cryptUsecs=0;
 
   assert(hmsg);
 
+  tStart=AH_Dialog_StatsStart(hmsg->dialog);
+
   e=AH_Dialog_GetMsgEngine(hmsg->dialog);
   assert(e);
   GWEN_MsgEngine_SetProtocolVersion(e, hmsg->hbciVersion);
@@ -605,6 +610,7 @@ int AH_Msg_EncodeMsg(AH_MSG *hmsg)
     GWEN_STRINGLISTENTRY *se;
 
     rawBuf=GWEN_Buffer_dup(hmsg->buffer);
+    tPhase=AH_Dialog_StatsStart(hmsg->dialog);
     se=GWEN_StringList_FirstEntry(hmsg->signerIdList);
     while (se) {
       DBG_NOTICE(AQHBCI_LOGDOMAIN, "Letting signer [%s] sign", GWEN_StringListEntry_Data(se));
@@ -617,6 +623,7 @@ int AH_Msg_EncodeMsg(AH_MSG *hmsg)
       se=GWEN_StringListEntry_Next(se);
     } /* while */
     GWEN_Buffer_free(rawBuf);
+    cryptUsecs+=AH_Dialog_StatsStop(hmsg->dialog, AH_StatsPhase_Sign, tPhase, 0);
   } /* if signing is needed */
   else {
     DBG_NOTICE(AQHBCI_LOGDOMAIN, "No signers");
@@ -629,11 +636,13 @@ int AH_Msg_EncodeMsg(AH_MSG *hmsg)
   /* encrypt message */
   if (hmsg->crypterId) {
     DBG_DEBUG(AQHBCI_LOGDOMAIN, "Encrypting message");
+    tPhase=AH_Dialog_StatsStart(hmsg->dialog);
     rv=AH_Msg__Encrypt(hmsg);
     if (rv) {
       DBG_INFO(AQHBCI_LOGDOMAIN, "here (%d)", rv);
       return rv;
     }
+    cryptUsecs+=AH_Dialog_StatsStop(hmsg->dialog, AH_StatsPhase_Encrypt, tPhase, GWEN_Buffer_GetUsedBytes(hmsg->buffer));
     DBG_DEBUG(AQHBCI_LOGDOMAIN, "Encrypting message: done");
   }
 
@@ -656,6 +665,15 @@ int AH_Msg_EncodeMsg(AH_MSG *hmsg)
   /* log final message */
   AH_Msg_LogMessage(hmsg, hmsg->buffer, 0, 1);
 
+  if (tStart) {
+    uint64_t usecs;
+
+    /* encoding time without signing and encryption */
+    usecs=AH_Stats_Elapsed(tStart);
+    AH_Dialog_StatsAdd(hmsg->dialog, AH_StatsPhase_Encode, (usecs>cryptUsecs)?(usecs-cryptUsecs):0,
+                       GWEN_Buffer_GetUsedBytes(hmsg->buffer));
+  }
+
   DBG_DEBUG(AQHBCI_LOGDOMAIN, "Message finished");
   return 0;
 }
@@ -999,11 +1017,18 @@ int AH_Msg_DecodeMsg(AH_MSG *hmsg,
   const char *mode;
   uint32_t expMsgNum;
   uint32_t guiid;
+  uint64_t tStart;
+  uint64_t tPhase;
+  uint64_t cryptUsecs=0;
+  uint32_t msgSize;
 
   assert(hmsg->dialog);
   e=AH_Dialog_GetMsgEngine(hmsg->dialog);
   assert(e);
 
+  tStart=AH_Dialog_StatsStart(hmsg->dialog);
+  msgSize=GWEN_Buffer_GetUsedBytes(hmsg->buffer);
+
   /* set mode */
   u=AH_Dialog_GetDialogOwner(hmsg->dialog);
   assert(u);
@@ -1137,11 +1162,13 @@ int AH_Msg_DecodeMsg(AH_MSG *hmsg,
       DBG_ERROR(AQHBCI_LOGDOMAIN, "Encryption error");
       return GWEN_ERROR_GENERIC;
     }
+    tPhase=AH_Dialog_StatsStart(hmsg->dialog);
     rv=AH_Msg__Decrypt(hmsg, gr);
     if (rv) {
       DBG_INFO(AQHBCI_LOGDOMAIN, "here");
       return AB_ERROR_SECURITY;
     }
+    cryptUsecs+=AH_Dialog_StatsStop(hmsg->dialog, AH_StatsPhase_Decrypt, tPhase, msgSize);
     /* unlink and delete crypthead */
     GWEN_DB_UnlinkGroup(n);
     GWEN_DB_Group_free(n);
@@ -1186,11 +1213,21 @@ int AH_Msg_DecodeMsg(AH_MSG *hmsg,
   }
 
   /* verify signatures */
+  tPhase=AH_Dialog_StatsStart(hmsg->dialog);
   rv=AH_Msg__Verify(hmsg, gr);
   if (rv) {
     DBG_INFO(AQHBCI_LOGDOMAIN, "here");
     return rv;
   }
+  cryptUsecs+=AH_Dialog_StatsStop(hmsg->dialog, AH_StatsPhase_Verify, tPhase, 0);
+
+  if (tStart) {
+    uint64_t usecs;
+
+    /* decoding time without decryption and verification */
+    usecs=AH_Stats_Elapsed(tStart);
+    AH_Dialog_StatsAdd(hmsg->dialog, AH_StatsPhase_Decode, (usecs>cryptUsecs)?(usecs-cryptUsecs):0, msgSize);
+  }
 
   return 0;
 }
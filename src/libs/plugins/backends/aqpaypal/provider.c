@@ -354,4 +354,5 @@ int APY_Provider_ParseResponse(AB_PROVIDER *pro, const char *s, GWEN_DB_NODE *db
 #include "provider_dialogs.c"
 #include "provider_getbalance.c"
 #include "provider_getstm.c"
+#include "provider_details.c"
 #include "provider_sendcmd.c"
@@ -0,0 +1,623 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ *          Please see toplevel file COPYING for license details           *
+ ***************************************************************************/
+
+
+/* included from provider.c */
+
+
+/*
+ * Transaction details (getTransactionDetails) need one request per transaction. Details of completed
+ * transactions are kept in a cache file per account, so repeated requests only need to fetch details for
+ * new transactions or transactions whose status changed.
+ *
+ * The remaining requests are sent one after the other. They share the http session object, but GWEN_HTTP_SESSION
+ * connects for every packet sent and disconnects after receiving the response, so every request still needs
+ * its own connection (including TLS handshake). Requests are not sent concurrently either, since GWEN_Gui and
+ * the gwen http/TLS layers are neither thread-safe nor non-blocking.
+ */
+
+
+/* PayPal doesn't return transactions older than 3 years, so there is no need to keep older details */
+#define APY_DETAILCACHE_MAXDAYS (3*366)
+
+
+
+static const char *apy_detailVarNames[]= {
+  "TRANSACTIONTYPE",
+  "SHIPTOSTREET",
+  "SHIPTOCITY",
+  "SHIPTOZIP",
+  "PAYMENTSTATUS",
+  "BUYERID",
+  NULL
+};
+
+static const char *apy_detailItemVarNames[]= {
+  "L_QTY",
+  "L_NAME",
+  "L_NUMBER",
+  "L_AMT",
+  "L_CURRENCYCODE",
+  NULL
+};
+
+
+
+int APY_Provider_UpdateTransList(AB_PROVIDER *pro, AB_USER *u, uint32_t accountId, AB_TRANSACTION_LIST2 *tl)
+{
+  AB_TRANSACTION_LIST2_ITERATOR *it;
+  GWEN_HTTP_SESSION *sess=NULL;
+  GWEN_DB_NODE *dbCache;
+  GWEN_BUFFER *hbuf;
+  int cacheModified=0;
+  int fromCache=0;
+  int fetched=0;
+  int rv;
+
+  /* request head is the same for all requests */
+  hbuf=GWEN_Buffer_new(0, 256, 0, 1);
+  rv=APY_Provider__BuildDetailsRequestHead(u, hbuf);
+  if (rv<0) {
+    DBG_INFO(AQPAYPAL_LOGDOMAIN, "here (%d)", rv);
+    GWEN_Buffer_free(hbuf);
+    return rv;
+  }
+
+  dbCache=APY_Provider__LoadDetailCache(pro, u, accountId);
+  if (APY_Provider__PruneDetailCache(dbCache))
+    cacheModified=1;
+
+  rv=0;
+  it=AB_Transaction_List2_First(tl);
+  if (it) {
+    AB_TRANSACTION *t;
+
+    t=AB_Transaction_List2Iterator_Data(it);
+    while (t) {
+      const char *fiId;
+      char entryName[64];
+      int cacheable;
+      GWEN_DB_NODE *dbEntry=NULL;
+
+      fiId=AB_Transaction_GetFiId(t);
+      cacheable=APY_Provider__GetCacheEntryName(fiId, entryName, sizeof(entryName));
+
+      /* only completed transactions are taken from the cache, the details of all others might have changed */
+      if (cacheable && AB_Transaction_GetStatus(t)==AB_Transaction_StatusAccepted)
+        dbEntry=GWEN_DB_GetGroup(dbCache, GWEN_PATH_FLAGS_NAMEMUSTEXIST, entryName);
+
+      if (dbEntry) {
+        APY_Provider__ApplyDetails(t, dbEntry);
+        fromCache++;
+      }
+      else {
+        GWEN_DB_NODE *dbResponse;
+
+        if (sess==NULL) {
+          sess=APY_Provider__CreateDetailsSession(pro, u);
+          if (sess==NULL) {
+            DBG_INFO(AQPAYPAL_LOGDOMAIN, "here");
+            rv=GWEN_ERROR_GENERIC;
+            break;
+          }
+        }
+
+        DBG_INFO(AQPAYPAL_LOGDOMAIN, "Getting details for transaction [%s]", fiId);
+        dbResponse=GWEN_DB_Group_new("response");
+        rv=APY_Provider__RequestDetails(pro, sess, GWEN_Buffer_GetStart(hbuf), fiId, dbResponse);
+        if (rv==GWEN_ERROR_USER_ABORTED) {
+          DBG_INFO(AQPAYPAL_LOGDOMAIN, "User aborted");
+          GWEN_DB_Group_free(dbResponse);
+          break;
+        }
+        else if (rv<0) {
+          /* not fatal, the transaction just lacks some details */
+          DBG_INFO(AQPAYPAL_LOGDOMAIN, "here (%d)", rv);
+          rv=0;
+        }
+        else {
+          const char *s;
+
+          APY_Provider__ApplyDetails(t, dbResponse);
+          fetched++;
+
+          s=GWEN_DB_GetCharValue(dbResponse, "PAYMENTSTATUS", 0, NULL);
+          if (cacheable && s && strcasecmp(s, "Completed")==0) {
+            dbEntry=GWEN_DB_GetGroup(dbCache, GWEN_DB_FLAGS_OVERWRITE_GROUPS, entryName);
+            APY_Provider__StoreDetails(dbResponse, AB_Transaction_GetDate(t), dbEntry);
+            cacheModified=1;
+          }
+        }
+        GWEN_DB_Group_free(dbResponse);
+      }
+
+      t=AB_Transaction_List2Iterator_Next(it);
+    }
+    AB_Transaction_List2Iterator_free(it);
+  }
+
+  if (sess) {
+    /* deinit (ignore result because it isn't important) */
+    GWEN_HttpSession_Fini(sess);
+    GWEN_HttpSession_free(sess);
+  }
+  GWEN_Buffer_free(hbuf);
+
+  DBG_INFO(AQPAYPAL_LOGDOMAIN, "Transaction details: %d fetched, %d from cache", fetched, fromCache);
+
+  if (cacheModified) {
+    int rv2;
+
+    rv2=APY_Provider__SaveDetailCache(pro, u, accountId, dbCache);
+    if (rv2<0) {
+      DBG_WARN(AQPAYPAL_LOGDOMAIN, "Could not write transaction detail cache (%d), ignoring", rv2);
+    }
+  }
+  GWEN_DB_Group_free(dbCache);
+
+  return rv;
+}
+
+
+
+int APY_Provider__BuildDetailsRequestHead(const AB_USER *u, GWEN_BUFFER *tbuf)
+{
+  const char *s;
+
+  GWEN_Buffer_AppendString(tbuf, "user=");
+  s=APY_User_GetApiUserId(u);
+  if (s && *s)
+    GWEN_Text_EscapeToBuffer(s, tbuf);
+  else {
+    DBG_ERROR(AQPAYPAL_LOGDOMAIN, "Missing user id");
+    return GWEN_ERROR_INVALID;
+  }
+
+  GWEN_Buffer_AppendString(tbuf, "&pwd=");
+  s=APY_User_GetApiPassword(u);
+  if (s && *s)
+    GWEN_Text_EscapeToBuffer(s, tbuf);
+  else {
+    DBG_ERROR(AQPAYPAL_LOGDOMAIN, "Missing API password");
+    return GWEN_ERROR_INVALID;
+  }
+
+  GWEN_Buffer_AppendString(tbuf, "&signature=");
+  s=APY_User_GetApiSignature(u);
+  if (s && *s)
+    GWEN_Text_EscapeToBuffer(s, tbuf);
+  else {
+    DBG_ERROR(AQPAYPAL_LOGDOMAIN, "Missing API signature");
+    return GWEN_ERROR_INVALID;
+  }
+
+  GWEN_Buffer_AppendString(tbuf, "&version=");
+  GWEN_Text_EscapeToBuffer(AQPAYPAL_API_VER, tbuf);
+  GWEN_Buffer_AppendString(tbuf, "&method=getTransactionDetails");
+
+  return 0;
+}
+
+
+
+GWEN_HTTP_SESSION *APY_Provider__CreateDetailsSession(AB_PROVIDER *pro, AB_USER *u)
+{
+  GWEN_HTTP_SESSION *sess;
+  int vmajor;
+  int vminor;
+  int rv;
+
+  sess=AB_HttpSession_new(pro, u, APY_User_GetServerUrl(u), "https", 443);
+  if (sess==NULL) {
+    DBG_ERROR(AQPAYPAL_LOGDOMAIN, "Could not create http session for user [%s]",
+              AB_User_GetUserId(u));
+    return NULL;
+  }
+
+  vmajor=APY_User_GetHttpVMajor(u);
+  vminor=APY_User_GetHttpVMinor(u);
+  if (vmajor==0 && vminor==0) {
+    vmajor=1;
+    vminor=0;
+  }
+  GWEN_HttpSession_SetHttpVMajor(sess, vmajor);
+  GWEN_HttpSession_SetHttpVMinor(sess, vminor);
+  GWEN_HttpSession_SetHttpContentType(sess, "application/x-www-form-urlencoded");
+
+  rv=GWEN_HttpSession_Init(sess);
+  if (rv<0) {
+    DBG_INFO(AQPAYPAL_LOGDOMAIN, "here (%d)", rv);
+    GWEN_HttpSession_free(sess);
+    return NULL;
+  }
+
+  return sess;
+}
+
+
+
+int APY_Provider__RequestDetails(AB_PROVIDER *pro, GWEN_HTTP_SESSION *sess, const char *requestHead,
+                                 const char *fiId, GWEN_DB_NODE *dbResponse)
+{
+  GWEN_BUFFER *tbuf;
+  const char *s;
+  int rv;
+
+  if (!(fiId && *fiId)) {
+    DBG_ERROR(AQPAYPAL_LOGDOMAIN, "Missing transaction id");
+    return GWEN_ERROR_INVALID;
+  }
+
+  tbuf=GWEN_Buffer_new(0, 256, 0, 1);
+  GWEN_Buffer_AppendString(tbuf, requestHead);
+  GWEN_Buffer_AppendString(tbuf, "&transactionId=");
+  GWEN_Text_EscapeToBuffer(fiId, tbuf);
+
+  if (getenv("AQPAYPAL_LOG_COMM"))
+    APY_Provider__LogComm("Sending (UpdateTrans)", tbuf);
+
+  /* send request */
+  rv=GWEN_HttpSession_SendPacket(sess, "POST",
+                                 (const uint8_t *) GWEN_Buffer_GetStart(tbuf),
+                                 GWEN_Buffer_GetUsedBytes(tbuf));
+  if (rv<0) {
+    DBG_INFO(AQPAYPAL_LOGDOMAIN, "here (%d)", rv);
+    GWEN_Buffer_free(tbuf);
+    return rv;
+  }
+
+  /* get response */
+  GWEN_Buffer_Reset(tbuf);
+  rv=GWEN_HttpSession_RecvPacket(sess, tbuf);
+  if (rv<0 || rv<200 || rv>299) {
+    DBG_INFO(AQPAYPAL_LOGDOMAIN, "here (%d)", rv);
+    GWEN_Buffer_free(tbuf);
+    return (rv<0)?rv:GWEN_ERROR_GENERIC;
+  }
+
+  if (getenv("AQPAYPAL_LOG_COMM"))
+    APY_Provider__LogComm("Received (UpdateTrans)", tbuf);
+
+  /* parse response */
+  rv=APY_Provider_ParseResponse(pro, GWEN_Buffer_GetStart(tbuf), dbResponse);
+  GWEN_Buffer_free(tbuf);
+  if (rv<0) {
+    DBG_INFO(AQPAYPAL_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  /* check result */
+  s=GWEN_DB_GetCharValue(dbResponse, "ACK", 0, NULL);
+  if (s && *s) {
+    if (strcasecmp(s, "Success")==0 ||
+        strcasecmp(s, "SuccessWithWarning")==0) {
+      DBG_INFO(AQPAYPAL_LOGDOMAIN, "Success");
+    }
+    else {
+      DBG_INFO(AQPAYPAL_LOGDOMAIN, "No positive response from server");
+      return GWEN_ERROR_BAD_DATA;
+    }
+  }
+  else {
+    DBG_INFO(AQPAYPAL_LOGDOMAIN, "No ACK response from server");
+    return GWEN_ERROR_BAD_DATA;
+  }
+
+  return 0;
+}
+
+
+
+void APY_Provider__ApplyDetails(AB_TRANSACTION *t, GWEN_DB_NODE *dbDetails)
+{
+  const char *s;
+  GWEN_DB_NODE *dbT;
+
+  s=GWEN_DB_GetCharValue(dbDetails, "TRANSACTIONTYPE", 0, NULL);
+  if (s && *s)
+    AB_Transaction_SetTransactionText(t, s);
+  /* address */
+  s=GWEN_DB_GetCharValue(dbDetails, "SHIPTOSTREET", 0, NULL);
+  if (s && *s)
+    AB_Transaction_SetRemoteAddrStreet(t, s);
+  s=GWEN_DB_GetCharValue(dbDetails, "SHIPTOCITY", 0, NULL);
+  if (s && *s)
+    AB_Transaction_SetRemoteAddrCity(t, s);
+  s=GWEN_DB_GetCharValue(dbDetails, "SHIPTOZIP", 0, NULL);
+  if (s && *s)
+    AB_Transaction_SetRemoteAddrZipcode(t, s);
+
+  s=GWEN_DB_GetCharValue(dbDetails, "PAYMENTSTATUS", 0, NULL);
+  if (s && *s) {
+    if (strcasecmp(s, "Completed")==0)
+      AB_Transaction_SetStatus(t, AB_Transaction_StatusAccepted);
+    else if (strcasecmp(s, "Denied")==0 ||
+             strcasecmp(s, "Failed")==0 ||
+             strcasecmp(s, "Expired")==0 ||
+             strcasecmp(s, "Voided")==0)
+      AB_Transaction_SetStatus(t, AB_Transaction_StatusRejected);
+    else if (strcasecmp(s, "Pending")==0 ||
+             strcasecmp(s, "Processed")==0)
+      AB_Transaction_SetStatus(t, AB_Transaction_StatusPending);
+    else if (strcasecmp(s, "Refunded")==0 ||
+             strcasecmp(s, "Reversed")==0)
+      AB_Transaction_SetStatus(t, AB_Transaction_StatusRevoked);
+    else {
+      DBG_INFO(AQPAYPAL_LOGDOMAIN, "Unknown payment status (%s)", s);
+    }
+  }
+
+  s=GWEN_DB_GetCharValue(dbDetails, "BUYERID", 0, NULL);
+  if (s && *s)
+    AB_Transaction_SetBankReference(t, s);
+
+  dbT=GWEN_DB_GetFirstGroup(dbDetails);
+  while (dbT) {
+    GWEN_BUFFER *pbuf;
+
+    pbuf=GWEN_Buffer_new(0, 256, 0, 1);
+    s=GWEN_DB_GetCharValue(dbT, "L_QTY", 0, NULL);
+    if (s && *s) {
+      GWEN_Buffer_AppendString(pbuf, s);
+      GWEN_Buffer_AppendString(pbuf, "x");
+    }
+    s=GWEN_DB_GetCharValue(dbT, "L_NAME", 0, NULL);
+    if (s && *s) {
+      GWEN_Buffer_AppendString(pbuf, s);
+      s=GWEN_DB_GetCharValue(dbT, "L_NUMBER", 0, NULL);
+      if (s && *s) {
+        GWEN_Buffer_AppendString(pbuf, "(");
+        GWEN_Buffer_AppendString(pbuf, s);
+        GWEN_Buffer_AppendString(pbuf, ")");
+      }
+    }
+    else {
+      s=GWEN_DB_GetCharValue(dbT, "L_NUMBER", 0, NULL);
+      if (s && *s)
+        GWEN_Buffer_AppendString(pbuf, s);
+    }
+
+    s=GWEN_DB_GetCharValue(dbT, "L_AMT", 0, NULL);
+    if (s && *s) {
+      GWEN_Buffer_AppendString(pbuf, "[");
+      GWEN_Buffer_AppendString(pbuf, s);
+      s=GWEN_DB_GetCharValue(dbT, "L_CURRENCYCODE", 0, NULL);
+      if (s && *s) {
+        GWEN_Buffer_AppendString(pbuf, " ");
+        GWEN_Buffer_AppendString(pbuf, s);
+      }
+      GWEN_Buffer_AppendString(pbuf, "]");
+
+    }
+
+    AB_Transaction_AddPurposeLine(t, GWEN_Buffer_GetStart(pbuf));
+    GWEN_Buffer_free(pbuf);
+
+    dbT=GWEN_DB_GetNextGroup(dbT);
+  }
+}
+
+
+
+void APY_Provider__StoreDetails(GWEN_DB_NODE *dbResponse, const GWEN_DATE *da, GWEN_DB_NODE *dbEntry)
+{
+  GWEN_DB_NODE *dbT;
+  int i;
+
+  /* only store what APY_Provider__ApplyDetails needs */
+  GWEN_DB_ClearGroup(dbEntry, NULL);
+  for (i=0; apy_detailVarNames[i]; i++) {
+    const char *s;
+
+    s=GWEN_DB_GetCharValue(dbResponse, apy_detailVarNames[i], 0, NULL);
+    if (s && *s)
+      GWEN_DB_SetCharValue(dbEntry, GWEN_DB_FLAGS_OVERWRITE_VARS, apy_detailVarNames[i], s);
+  }
+
+  dbT=GWEN_DB_GetFirstGroup(dbResponse);
+  while (dbT) {
+    GWEN_DB_NODE *dbItem;
+
+    dbItem=GWEN_DB_GetGroup(dbEntry, GWEN_PATH_FLAGS_CREATE_GROUP, "item");
+    for (i=0; apy_detailItemVarNames[i]; i++) {
+      const char *s;
+
+      s=GWEN_DB_GetCharValue(dbT, apy_detailItemVarNames[i], 0, NULL);
+      if (s && *s)
+        GWEN_DB_SetCharValue(dbItem, GWEN_DB_FLAGS_OVERWRITE_VARS, apy_detailItemVarNames[i], s);
+    }
+    dbT=GWEN_DB_GetNextGroup(dbT);
+  }
+
+  /* used to expire old entries */
+  GWEN_DB_SetIntValue(dbEntry, GWEN_DB_FLAGS_OVERWRITE_VARS, "julianDate",
+                      da?GWEN_Date_GetJulian(da):APY_Provider__CurrentJulianDate());
+}
+
+
+
+int APY_Provider__GetCacheEntryName(const char *fiId, char *buffer, int size)
+{
+  const char *s;
+
+  /* transaction ids are used in group names of the cache file, so only accept plain ids */
+  if (!(fiId && *fiId) || strlen(fiId)+3>(size_t) size)
+    return 0;
+  for (s=fiId; *s; s++) {
+    if (!isalnum((unsigned char) *s))
+      return 0;
+  }
+  snprintf(buffer, size, "tx%s", fiId);
+  return 1;
+}
+
+
+
+int APY_Provider__CurrentJulianDate(void)
+{
+  GWEN_DATE *dt;
+  int julian;
+
+  dt=GWEN_Date_CurrentDate();
+  julian=GWEN_Date_GetJulian(dt);
+  GWEN_Date_free(dt);
+  return julian;
+}
+
+
+
+int APY_Provider__PruneDetailCache(GWEN_DB_NODE *dbCache)
+{
+  GWEN_DB_NODE *dbEntry;
+  int minJulian;
+  int removed=0;
+
+  minJulian=APY_Provider__CurrentJulianDate()-APY_DETAILCACHE_MAXDAYS;
+  dbEntry=GWEN_DB_GetFirstGroup(dbCache);
+  while (dbEntry) {
+    GWEN_DB_NODE *dbNext;
+
+    dbNext=GWEN_DB_GetNextGroup(dbEntry);
+    if (GWEN_DB_GetIntValue(dbEntry, "julianDate", 0, 0)<minJulian) {
+      GWEN_DB_UnlinkGroup(dbEntry);
+      GWEN_DB_Group_free(dbEntry);
+      removed++;
+    }
+    dbEntry=dbNext;
+  }
+
+  return removed;
+}
+
+
+
+int APY_Provider__GetDetailCachePath(AB_PROVIDER *pro, const AB_USER *u, uint32_t accountId, GWEN_BUFFER *pbuf)
+{
+  const char *uid;
+  char numbuf[32];
+  int rv;
+
+  uid=AB_User_GetUserId(u);
+  if (!(uid && *uid)) {
+    DBG_ERROR(AQPAYPAL_LOGDOMAIN, "No user id");
+    return GWEN_ERROR_INVALID;
+  }
+
+  rv=AB_Provider_GetUserDataDir(pro, pbuf);
+  if (rv<0) {
+    DBG_INFO(AQPAYPAL_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  GWEN_Buffer_AppendString(pbuf, GWEN_DIR_SEPARATOR_S);
+  GWEN_Text_UnescapeToBufferTolerant(uid, pbuf);
+  snprintf(numbuf, sizeof(numbuf)-1, "-%lu.details", (unsigned long) accountId);
+  numbuf[sizeof(numbuf)-1]=0;
+  GWEN_Buffer_AppendString(pbuf, numbuf);
+
+  return 0;
+}
+
+
+
+GWEN_DB_NODE *APY_Provider__LoadDetailCache(AB_PROVIDER *pro, const AB_USER *u, uint32_t accountId)
+{
+  GWEN_DB_NODE *dbCache;
+  GWEN_BUFFER *pbuf;
+  int rv;
+
+  dbCache=GWEN_DB_Group_new("details");
+
+  pbuf=GWEN_Buffer_new(0, 256, 0, 1);
+  rv=APY_Provider__GetDetailCachePath(pro, u, accountId, pbuf);
+  if (rv==0 && GWEN_Directory_GetPath(GWEN_Buffer_GetStart(pbuf), GWEN_PATH_FLAGS_NAMEMUSTEXIST|GWEN_PATH_FLAGS_VARIABLE)==0) {
+    rv=GWEN_DB_ReadFile(dbCache, GWEN_Buffer_GetStart(pbuf), GWEN_DB_FLAGS_DEFAULT);
+    if (rv<0) {
+      DBG_WARN(AQPAYPAL_LOGDOMAIN, "Could not read transaction detail cache \"%s\" (%d), ignoring",
+               GWEN_Buffer_GetStart(pbuf), rv);
+      GWEN_DB_ClearGroup(dbCache, NULL);
+    }
+  }
+  GWEN_Buffer_free(pbuf);
+
+  return dbCache;
+}
+
+
+
+int APY_Provider__SaveDetailCache(AB_PROVIDER *pro, const AB_USER *u, uint32_t accountId, GWEN_DB_NODE *dbCache)
+{
+  GWEN_BUFFER *pbuf;
+  int rv;
+
+  pbuf=GWEN_Buffer_new(0, 256, 0, 1);
+  rv=AB_Provider_GetUserDataDir(pro, pbuf);
+  if (rv<0) {
+    DBG_INFO(AQPAYPAL_LOGDOMAIN, "here (%d)", rv);
+    GWEN_Buffer_free(pbuf);
+    return rv;
+  }
+
+  /* make sure the data dir exists */
+  rv=GWEN_Directory_GetPath(GWEN_Buffer_GetStart(pbuf), 0);
+  if (rv<0) {
+    DBG_INFO(AQPAYPAL_LOGDOMAIN, "here (%d)", rv);
+    GWEN_Buffer_free(pbuf);
+    return rv;
+  }
+
+  GWEN_Buffer_Reset(pbuf);
+  rv=APY_Provider__GetDetailCachePath(pro, u, accountId, pbuf);
+  if (rv<0) {
+    DBG_INFO(AQPAYPAL_LOGDOMAIN, "here (%d)", rv);
+    GWEN_Buffer_free(pbuf);
+    return rv;
+  }
+
+  rv=GWEN_DB_WriteFile(dbCache, GWEN_Buffer_GetStart(pbuf), GWEN_DB_FLAGS_DEFAULT);
+  GWEN_Buffer_free(pbuf);
+  if (rv<0) {
+    DBG_INFO(AQPAYPAL_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  return 0;
+}
+
+
+
+void APY_Provider__LogComm(const char *title, GWEN_BUFFER *tbuf)
+{
+  FILE *f;
+
+  f=fopen("paypal.log", "a+");
+  if (f) {
+    fprintf(f, "\n============================================\n");
+    fprintf(f, "%s:\n", title);
+    if (GWEN_Buffer_GetUsedBytes(tbuf)>0) {
+      if (1!=fwrite(GWEN_Buffer_GetStart(tbuf), GWEN_Buffer_GetUsedBytes(tbuf), 1, f)) {
+        DBG_INFO(AQPAYPAL_LOGDOMAIN, "here (%d: %s)", errno, strerror(errno));
+        fclose(f);
+      }
+      else {
+        if (fclose(f)) {
+          DBG_INFO(AQPAYPAL_LOGDOMAIN, "here (%d: %s)", errno, strerror(errno));
+        }
+      }
+    }
+    else {
+      fprintf(f, "Empty data.\n");
+      if (fclose(f)) {
+        DBG_INFO(AQPAYPAL_LOGDOMAIN, "here (%d: %s)", errno, strerror(errno));
+      }
+    }
+  }
+}
+
+
@@ -15,6 +15,9 @@
 #include <aqbanking/backendsupport/queue.h>
 #include <aqbanking/backendsupport/account_p.h>
 
+#include <gwenhywfar/httpsession.h>
+#include <gwenhywfar/gwendate.h>
+
 
 
 typedef struct APY_PROVIDER APY_PROVIDER;
@@ -53,9 +56,21 @@ static int APY_Provider_ExecGetTrans(AB_PROVIDER *pro,
                                      AB_USER *u,
                                      AB_TRANSACTION *j);
 
-static int APY_Provider_UpdateTrans(AB_PROVIDER *pro,
-                                    AB_USER *u,
-                                    AB_TRANSACTION *t);
+/* from provider_details.c */
+static int APY_Provider_UpdateTransList(AB_PROVIDER *pro, AB_USER *u, uint32_t accountId, AB_TRANSACTION_LIST2 *tl);
+static int APY_Provider__BuildDetailsRequestHead(const AB_USER *u, GWEN_BUFFER *tbuf);
+static GWEN_HTTP_SESSION *APY_Provider__CreateDetailsSession(AB_PROVIDER *pro, AB_USER *u);
+static int APY_Provider__RequestDetails(AB_PROVIDER *pro, GWEN_HTTP_SESSION *sess, const char *requestHead,
+                                        const char *fiId, GWEN_DB_NODE *dbResponse);
+static void APY_Provider__ApplyDetails(AB_TRANSACTION *t, GWEN_DB_NODE *dbDetails);
+static void APY_Provider__StoreDetails(GWEN_DB_NODE *dbResponse, const GWEN_DATE *da, GWEN_DB_NODE *dbEntry);
+static int APY_Provider__GetCacheEntryName(const char *fiId, char *buffer, int size);
+static int APY_Provider__CurrentJulianDate(void);
+static int APY_Provider__PruneDetailCache(GWEN_DB_NODE *dbCache);
+static int APY_Provider__GetDetailCachePath(AB_PROVIDER *pro, const AB_USER *u, uint32_t accountId, GWEN_BUFFER *pbuf);
+static GWEN_DB_NODE *APY_Provider__LoadDetailCache(AB_PROVIDER *pro, const AB_USER *u, uint32_t accountId);
+static int APY_Provider__SaveDetailCache(AB_PROVIDER *pro, const AB_USER *u, uint32_t accountId, GWEN_DB_NODE *dbCache);
+static void APY_Provider__LogComm(const char *title, GWEN_BUFFER *tbuf);
 
 int APY_Provider_UpdateAccountSpec(AB_PROVIDER *pro, AB_ACCOUNT_SPEC *as, int doLock);
 
@@ -0,0 +1,751 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ *          Please see toplevel file COPYING for license details           *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "columnar_p.h"
+
+#include "aqbanking/i18n_l.h"
+#include <aqbanking/banking.h>
+
+#include <gwenhywfar/debug.h>
+#include <gwenhywfar/misc.h>
+#include <gwenhywfar/gui.h>
+#include <gwenhywfar/inherit.h>
+
+#include <string.h>
+#include <strings.h>
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * forward declarations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+static AH_COLUMNAR_WRITER *_writerNew(GWEN_SYNCIO *sio, uint32_t batchSize, int scale);
+static void _writerFree(AH_COLUMNAR_WRITER *w);
+static int _writerSetupColumns(AH_COLUMNAR_WRITER *w, GWEN_DB_NODE *params);
+static void _writerAddColumn(AH_COLUMNAR_WRITER *w, const AH_COLUMNAR_COLDEF *def);
+static const AH_COLUMNAR_COLDEF *_findColDef(const char *name);
+
+static int _writeFileHeader(AH_COLUMNAR_WRITER *w);
+static int _writeFileEnd(AH_COLUMNAR_WRITER *w);
+static int _addTransaction(AH_COLUMNAR_WRITER *w, const AB_TRANSACTION *t);
+static int _flushBatch(AH_COLUMNAR_WRITER *w);
+static void _resetBatch(AH_COLUMNAR_WRITER *w);
+static uint64_t _getChunkSize(const AH_COLUMNAR_WRITER *w, const AH_COLUMNAR_COLUMN *col);
+static int _writeColumnChunk(AH_COLUMNAR_WRITER *w, const AH_COLUMNAR_COLUMN *col);
+
+static int _writeBuffer(GWEN_SYNCIO *sio, GWEN_BUFFER *buf);
+static int _writePadded(GWEN_SYNCIO *sio, const uint8_t *ptr, uint32_t len);
+static uint32_t _pad8(uint32_t len);
+static void _setUint32Le(uint8_t *p, uint32_t v);
+static void _setUint64Le(uint8_t *p, uint64_t v);
+static void _appendUint32Le(GWEN_BUFFER *buf, uint32_t v);
+static void _appendUint64Le(GWEN_BUFFER *buf, uint64_t v);
+
+static int _getType(const AB_TRANSACTION *t);
+static int _getSubType(const AB_TRANSACTION *t);
+static int _getStatus(const AB_TRANSACTION *t);
+static const char *_getCurrency(const AB_TRANSACTION *t);
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * static data
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#define AH_COLUMNAR_COL_INT32(n, fn)   {n, AH_ColumnarType_Int32,     fn,   NULL, NULL, NULL, NULL}
+#define AH_COLUMNAR_COL_UINT32(n, fn)  {n, AH_ColumnarType_UInt32,    NULL, fn,   NULL, NULL, NULL}
+#define AH_COLUMNAR_COL_DATE(n, fn)    {n, AH_ColumnarType_Date32,    NULL, NULL, fn,   NULL, NULL}
+#define AH_COLUMNAR_COL_VALUE(n, fn)   {n, AH_ColumnarType_Decimal64, NULL, NULL, NULL, fn,   NULL}
+#define AH_COLUMNAR_COL_STRING(n, fn)  {n, AH_ColumnarType_String,    NULL, NULL, NULL, NULL, fn}
+
+static const AH_COLUMNAR_COLDEF _colDefs[]= {
+  AH_COLUMNAR_COL_UINT32("uniqueAccountId",     AB_Transaction_GetUniqueAccountId),
+  AH_COLUMNAR_COL_UINT32("uniqueId",            AB_Transaction_GetUniqueId),
+  AH_COLUMNAR_COL_INT32("type",                 _getType),
+  AH_COLUMNAR_COL_INT32("subType",              _getSubType),
+  AH_COLUMNAR_COL_INT32("status",               _getStatus),
+  AH_COLUMNAR_COL_DATE("date",                  AB_Transaction_GetDate),
+  AH_COLUMNAR_COL_DATE("valutaDate",            AB_Transaction_GetValutaDate),
+  AH_COLUMNAR_COL_VALUE("value",                AB_Transaction_GetValue),
+  AH_COLUMNAR_COL_STRING("currency",            _getCurrency),
+  AH_COLUMNAR_COL_VALUE("fees",                 AB_Transaction_GetFees),
+  AH_COLUMNAR_COL_STRING("localIban",           AB_Transaction_GetLocalIban),
+  AH_COLUMNAR_COL_STRING("localBic",            AB_Transaction_GetLocalBic),
+  AH_COLUMNAR_COL_STRING("localBankCode",       AB_Transaction_GetLocalBankCode),
+  AH_COLUMNAR_COL_STRING("localAccountNumber",  AB_Transaction_GetLocalAccountNumber),
+  AH_COLUMNAR_COL_STRING("localName",           AB_Transaction_GetLocalName),
+  AH_COLUMNAR_COL_STRING("remoteIban",          AB_Transaction_GetRemoteIban),
+  AH_COLUMNAR_COL_STRING("remoteBic",           AB_Transaction_GetRemoteBic),
+  AH_COLUMNAR_COL_STRING("remoteBankCode",      AB_Transaction_GetRemoteBankCode),
+  AH_COLUMNAR_COL_STRING("remoteAccountNumber", AB_Transaction_GetRemoteAccountNumber),
+  AH_COLUMNAR_COL_STRING("remoteName",          AB_Transaction_GetRemoteName),
+  AH_COLUMNAR_COL_INT32("transactionCode",      AB_Transaction_GetTransactionCode),
+  AH_COLUMNAR_COL_STRING("transactionText",     AB_Transaction_GetTransactionText),
+  AH_COLUMNAR_COL_STRING("transactionKey",      AB_Transaction_GetTransactionKey),
+  AH_COLUMNAR_COL_STRING("primanota",           AB_Transaction_GetPrimanota),
+  AH_COLUMNAR_COL_STRING("purpose",             AB_Transaction_GetPurpose),
+  AH_COLUMNAR_COL_STRING("category",            AB_Transaction_GetCategory),
+  AH_COLUMNAR_COL_STRING("customerReference",   AB_Transaction_GetCustomerReference),
+  AH_COLUMNAR_COL_STRING("bankReference",       AB_Transaction_GetBankReference),
+  AH_COLUMNAR_COL_STRING("endToEndReference",   AB_Transaction_GetEndToEndReference),
+  AH_COLUMNAR_COL_STRING("fiId",                AB_Transaction_GetFiId),
+  AH_COLUMNAR_COL_STRING("mandateId",           AB_Transaction_GetMandateId),
+  AH_COLUMNAR_COL_STRING("creditorSchemeId",    AB_Transaction_GetCreditorSchemeId),
+  {NULL, 0, NULL, NULL, NULL, NULL, NULL}
+};
+
+static const uint8_t _zeroBytes[8]= {0, 0, 0, 0, 0, 0, 0, 0};
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * implementations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+GWEN_INHERIT(AB_IMEXPORTER, AH_IMEXPORTER_COLUMNAR);
+
+
+
+AB_IMEXPORTER *AB_ImExporterColumnar_new(AB_BANKING *ab)
+{
+  AB_IMEXPORTER *ie;
+  AH_IMEXPORTER_COLUMNAR *ieh;
+
+  ie=AB_ImExporter_new(ab, "columnar");
+  GWEN_NEW_OBJECT(AH_IMEXPORTER_COLUMNAR, ieh);
+  GWEN_INHERIT_SETDATA(AB_IMEXPORTER, AH_IMEXPORTER_COLUMNAR, ie, ieh,
+                       AH_ImExporterColumnar_FreeData);
+
+  AB_ImExporter_SetExportFn(ie, AH_ImExporterColumnar_Export);
+  AB_ImExporter_SetCheckFileFn(ie, AH_ImExporterColumnar_CheckFile);
+  return ie;
+}
+
+
+
+void GWENHYWFAR_CB AH_ImExporterColumnar_FreeData(void *bp, void *p)
+{
+  AH_IMEXPORTER_COLUMNAR *ieh;
+
+  ieh=(AH_IMEXPORTER_COLUMNAR *)p;
+  GWEN_FREE_OBJECT(ieh);
+}
+
+
+
+int AH_ImExporterColumnar_CheckFile(AB_IMEXPORTER *ie, const char *fname)
+{
+  /* export only */
+  return GWEN_ERROR_NOT_SUPPORTED;
+}
+
+
+
+int AH_ImExporterColumnar_Export(AB_IMEXPORTER *ie,
+                                 AB_IMEXPORTER_CONTEXT *ctx,
+                                 GWEN_SYNCIO *sio,
+                                 GWEN_DB_NODE *params)
+{
+  AH_IMEXPORTER_COLUMNAR *ieh;
+  AH_COLUMNAR_WRITER *w;
+  AB_IMEXPORTER_ACCOUNTINFO *ai;
+  int batchSize;
+  int scale;
+  int rv;
+
+  assert(ie);
+  ieh=GWEN_INHERIT_GETDATA(AB_IMEXPORTER, AH_IMEXPORTER_COLUMNAR, ie);
+  assert(ieh);
+
+  batchSize=GWEN_DB_GetIntValue(params, "batchSize", 0, AH_COLUMNAR_DEFAULT_BATCHSIZE);
+  if (batchSize<1 || batchSize>AH_COLUMNAR_MAX_BATCHSIZE) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Invalid batch size %d", batchSize);
+    GWEN_Gui_ProgressLog2(0, GWEN_LoggerLevel_Error, I18N("Invalid batch size %d"), batchSize);
+    return GWEN_ERROR_INVALID;
+  }
+
+  scale=GWEN_DB_GetIntValue(params, "scale", 0, AH_COLUMNAR_DEFAULT_SCALE);
+  if (scale<0 || scale>18) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Invalid scale %d", scale);
+    GWEN_Gui_ProgressLog2(0, GWEN_LoggerLevel_Error, I18N("Invalid scale %d"), scale);
+    return GWEN_ERROR_INVALID;
+  }
+
+  w=_writerNew(sio, (uint32_t) batchSize, scale);
+  rv=_writerSetupColumns(w, params);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    _writerFree(w);
+    return rv;
+  }
+
+  rv=_writeFileHeader(w);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    GWEN_Gui_ProgressLog(0, GWEN_LoggerLevel_Error, "Error exporting data");
+    _writerFree(w);
+    return rv;
+  }
+
+  ai=AB_ImExporterContext_GetFirstAccountInfo(ctx);
+  while (ai) {
+    const AB_TRANSACTION_LIST *tl;
+
+    tl=AB_ImExporterAccountInfo_GetTransactionList(ai);
+    if (tl) {
+      const AB_TRANSACTION *t;
+
+      t=AB_Transaction_List_First(tl);
+      while (t) {
+        rv=_addTransaction(w, t);
+        if (rv<0) {
+          DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+          GWEN_Gui_ProgressLog(0, GWEN_LoggerLevel_Error, "Error exporting data");
+          _writerFree(w);
+          return rv;
+        }
+        t=AB_Transaction_List_Next(t);
+      } /* while t */
+    } /* if tl */
+    ai=AB_ImExporterAccountInfo_List_Next(ai);
+  } /* while ai */
+
+  rv=_writeFileEnd(w);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    GWEN_Gui_ProgressLog(0, GWEN_LoggerLevel_Error, "Error exporting data");
+    _writerFree(w);
+    return rv;
+  }
+
+  DBG_INFO(AQBANKING_LOGDOMAIN, "Exported %lu transaction(s) in %d column(s)",
+           (unsigned long) w->totalRowCount, w->columnCount);
+  _writerFree(w);
+  return 0;
+}
+
+
+
+AH_COLUMNAR_WRITER *_writerNew(GWEN_SYNCIO *sio, uint32_t batchSize, int scale)
+{
+  AH_COLUMNAR_WRITER *w;
+
+  GWEN_NEW_OBJECT(AH_COLUMNAR_WRITER, w);
+  w->sio=sio;
+  w->batchSize=batchSize;
+  w->scale=scale;
+  return w;
+}
+
+
+
+void _writerFree(AH_COLUMNAR_WRITER *w)
+{
+  if (w) {
+    int i;
+
+    for (i=0; i<w->columnCount; i++) {
+      AH_COLUMNAR_COLUMN *col;
+
+      col=&(w->columns[i]);
+      free(col->validity);
+      free(col->values);
+      if (col->stringData)
+        GWEN_Buffer_free(col->stringData);
+    }
+    free(w->columns);
+    GWEN_FREE_OBJECT(w);
+  }
+}
+
+
+
+int _writerSetupColumns(AH_COLUMNAR_WRITER *w, GWEN_DB_NODE *params)
+{
+  int maxColumns;
+  int i;
+
+  /* count requested columns (all if none given) */
+  for (i=0; ; i++) {
+    if (GWEN_DB_GetCharValue(params, "columns", i, NULL)==NULL)
+      break;
+  }
+  maxColumns=i;
+  if (maxColumns==0) {
+    while (_colDefs[maxColumns].name)
+      maxColumns++;
+  }
+
+  w->columns=(AH_COLUMNAR_COLUMN *) malloc(maxColumns*sizeof(AH_COLUMNAR_COLUMN));
+  assert(w->columns);
+  memset(w->columns, 0, maxColumns*sizeof(AH_COLUMNAR_COLUMN));
+
+  if (GWEN_DB_GetCharValue(params, "columns", 0, NULL)) {
+    for (i=0; i<maxColumns; i++) {
+      const char *s;
+      const AH_COLUMNAR_COLDEF *def;
+
+      s=GWEN_DB_GetCharValue(params, "columns", i, NULL);
+      def=_findColDef(s);
+      if (def==NULL) {
+        DBG_ERROR(AQBANKING_LOGDOMAIN, "Unknown column \"%s\"", s);
+        GWEN_Gui_ProgressLog2(0, GWEN_LoggerLevel_Error, I18N("Unknown column \"%s\""), s);
+        return GWEN_ERROR_INVALID;
+      }
+      _writerAddColumn(w, def);
+    }
+  }
+  else {
+    for (i=0; i<maxColumns; i++)
+      _writerAddColumn(w, &(_colDefs[i]));
+  }
+
+  _resetBatch(w);
+  return 0;
+}
+
+
+
+void _writerAddColumn(AH_COLUMNAR_WRITER *w, const AH_COLUMNAR_COLDEF *def)
+{
+  AH_COLUMNAR_COLUMN *col;
+  uint32_t valueSize;
+
+  col=&(w->columns[w->columnCount++]);
+  col->def=def;
+  col->validity=(uint8_t *) malloc((w->batchSize+7)/8);
+  assert(col->validity);
+
+  switch (def->type) {
+  case AH_ColumnarType_Decimal64:
+    valueSize=w->batchSize*8;
+    break;
+  case AH_ColumnarType_String:
+    valueSize=(w->batchSize+1)*4;
+    col->stringData=GWEN_Buffer_new(0, 4096, 0, 1);
+    break;
+  default:
+    valueSize=w->batchSize*4;
+    break;
+  }
+  col->values=(uint8_t *) malloc(valueSize);
+  assert(col->values);
+}
+
+
+
+const AH_COLUMNAR_COLDEF *_findColDef(const char *name)
+{
+  const AH_COLUMNAR_COLDEF *def;
+
+  for (def=_colDefs; def->name; def++) {
+    if (strcasecmp(def->name, name)==0)
+      return def;
+  }
+  return NULL;
+}
+
+
+
+int _writeFileHeader(AH_COLUMNAR_WRITER *w)
+{
+  GWEN_BUFFER *buf;
+  int i;
+  int rv;
+
+  buf=GWEN_Buffer_new(0, 1024, 0, 1);
+  GWEN_Buffer_AppendBytes(buf, AH_COLUMNAR_MAGIC, AH_COLUMNAR_MAGIC_LEN);
+  _appendUint32Le(buf, AH_COLUMNAR_VERSION);
+  _appendUint32Le(buf, (uint32_t) w->columnCount);
+
+  for (i=0; i<w->columnCount; i++) {
+    const AH_COLUMNAR_COLDEF *def;
+    uint8_t descr[4];
+    uint32_t len;
+
+    def=w->columns[i].def;
+    len=strlen(def->name);
+    descr[0]=(uint8_t) def->type;
+    descr[1]=(uint8_t)((def->type==AH_ColumnarType_Decimal64)?w->scale:0);
+    descr[2]=(uint8_t)(len & 0xff);
+    descr[3]=(uint8_t)((len>>8) & 0xff);
+    GWEN_Buffer_AppendBytes(buf, (const char *) descr, sizeof(descr));
+    GWEN_Buffer_AppendBytes(buf, def->name, len);
+  }
+
+  /* pad header, so that all batches start at a multiple of 8 */
+  GWEN_Buffer_AppendBytes(buf, (const char *) _zeroBytes,
+                          _pad8(GWEN_Buffer_GetUsedBytes(buf))-GWEN_Buffer_GetUsedBytes(buf));
+
+  rv=_writeBuffer(w->sio, buf);
+  GWEN_Buffer_free(buf);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+  return 0;
+}
+
+
+
+int _writeFileEnd(AH_COLUMNAR_WRITER *w)
+{
+  GWEN_BUFFER *buf;
+  int rv;
+
+  rv=_flushBatch(w);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  /* end marker: empty batch followed by the total number of rows */
+  buf=GWEN_Buffer_new(0, 16, 0, 1);
+  _appendUint32Le(buf, 0);
+  _appendUint32Le(buf, (uint32_t) w->columnCount);
+  _appendUint64Le(buf, w->totalRowCount);
+  rv=_writeBuffer(w->sio, buf);
+  GWEN_Buffer_free(buf);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+  return 0;
+}
+
+
+
+int _addTransaction(AH_COLUMNAR_WRITER *w, const AB_TRANSACTION *t)
+{
+  uint32_t row;
+  int i;
+
+  row=w->rowCount;
+  for (i=0; i<w->columnCount; i++) {
+    AH_COLUMNAR_COLUMN *col;
+    const AH_COLUMNAR_COLDEF *def;
+    int isValid=1;
+
+    col=&(w->columns[i]);
+    def=col->def;
+    switch (def->type) {
+    case AH_ColumnarType_Int32:
+      _setUint32Le(col->values+row*4, (uint32_t) def->getInt(t));
+      break;
+
+    case AH_ColumnarType_UInt32:
+      _setUint32Le(col->values+row*4, def->getUInt(t));
+      break;
+
+    case AH_ColumnarType_Date32: {
+      const GWEN_DATE *dt;
+
+      dt=def->getDate(t);
+      if (dt)
+        _setUint32Le(col->values+row*4, (uint32_t)(GWEN_Date_GetJulian(dt)-AH_COLUMNAR_JULIAN_EPOCH));
+      else {
+        _setUint32Le(col->values+row*4, 0);
+        isValid=0;
+      }
+      break;
+    }
+
+    case AH_ColumnarType_Decimal64: {
+      const AB_VALUE *v;
+
+      v=def->getValue(t);
+      if (v) {
+        int64_t scaledValue;
+        int rv;
+
+        rv=AB_Value_GetScaledInt64(v, w->scale, &scaledValue);
+        if (rv<0) {
+          GWEN_BUFFER *tbuf;
+
+          tbuf=GWEN_Buffer_new(0, 64, 0, 1);
+          AB_Value_toString(v, tbuf);
+          DBG_ERROR(AQBANKING_LOGDOMAIN, "Value \"%s\" of column \"%s\" can not be stored with scale %d",
+                    GWEN_Buffer_GetStart(tbuf), def->name, w->scale);
+          GWEN_Gui_ProgressLog2(0, GWEN_LoggerLevel_Error,
+                                I18N("Value \"%s\" of column \"%s\" can not be stored with scale %d"),
+                                GWEN_Buffer_GetStart(tbuf), def->name, w->scale);
+          GWEN_Buffer_free(tbuf);
+          return rv;
+        }
+        _setUint64Le(col->values+row*8, (uint64_t) scaledValue);
+      }
+      else {
+        _setUint64Le(col->values+row*8, 0);
+        isValid=0;
+      }
+      break;
+    }
+
+    case AH_ColumnarType_String: {
+      const char *s;
+
+      s=def->getString(t);
+      if (s)
+        GWEN_Buffer_AppendString(col->stringData, s);
+      else
+        isValid=0;
+      /* end offset of this row */
+      _setUint32Le(col->values+(row+1)*4, GWEN_Buffer_GetUsedBytes(col->stringData));
+      break;
+    }
+    }
+
+    if (isValid)
+      col->validity[row/8]|=(uint8_t)(1<<(row%8));
+  }
+
+  w->rowCount++;
+  w->totalRowCount++;
+  if (w->rowCount>=w->batchSize)
+    return _flushBatch(w);
+  return 0;
+}
+
+
+
+int _flushBatch(AH_COLUMNAR_WRITER *w)
+{
+  GWEN_BUFFER *buf;
+  int i;
+  int rv;
+
+  if (w->rowCount==0)
+    return 0;
+
+  /* batch header: number of rows, number of columns, size of each column chunk */
+  buf=GWEN_Buffer_new(0, 8+(w->columnCount*8), 0, 1);
+  _appendUint32Le(buf, w->rowCount);
+  _appendUint32Le(buf, (uint32_t) w->columnCount);
+  for (i=0; i<w->columnCount; i++)
+    _appendUint64Le(buf, _getChunkSize(w, &(w->columns[i])));
+  rv=_writeBuffer(w->sio, buf);
+  GWEN_Buffer_free(buf);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  for (i=0; i<w->columnCount; i++) {
+    rv=_writeColumnChunk(w, &(w->columns[i]));
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      return rv;
+    }
+  }
+
+  _resetBatch(w);
+  return 0;
+}
+
+
+
+void _resetBatch(AH_COLUMNAR_WRITER *w)
+{
+  int i;
+
+  for (i=0; i<w->columnCount; i++) {
+    AH_COLUMNAR_COLUMN *col;
+
+    col=&(w->columns[i]);
+    memset(col->validity, 0, (w->batchSize+7)/8);
+    if (col->stringData) {
+      GWEN_Buffer_Reset(col->stringData);
+      _setUint32Le(col->values, 0);
+    }
+  }
+  w->rowCount=0;
+}
+
+
+
+uint64_t _getChunkSize(const AH_COLUMNAR_WRITER *w, const AH_COLUMNAR_COLUMN *col)
+{
+  uint64_t size;
+
+  size=_pad8((w->rowCount+7)/8);
+  switch (col->def->type) {
+  case AH_ColumnarType_Decimal64:
+    size+=w->rowCount*8;
+    break;
+  case AH_ColumnarType_String:
+    size+=_pad8((w->rowCount+1)*4);
+    size+=_pad8(GWEN_Buffer_GetUsedBytes(col->stringData));
+    break;
+  default:
+    size+=_pad8(w->rowCount*4);
+    break;
+  }
+  return size;
+}
+
+
+
+int _writeColumnChunk(AH_COLUMNAR_WRITER *w, const AH_COLUMNAR_COLUMN *col)
+{
+  int rv;
+
+  rv=_writePadded(w->sio, col->validity, (w->rowCount+7)/8);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  switch (col->def->type) {
+  case AH_ColumnarType_Decimal64:
+    rv=_writePadded(w->sio, col->values, w->rowCount*8);
+    break;
+  case AH_ColumnarType_String:
+    rv=_writePadded(w->sio, col->values, (w->rowCount+1)*4);
+    if (rv>=0)
+      rv=_writePadded(w->sio,
+                      (const uint8_t *) GWEN_Buffer_GetStart(col->stringData),
+                      GWEN_Buffer_GetUsedBytes(col->stringData));
+    break;
+  default:
+    rv=_writePadded(w->sio, col->values, w->rowCount*4);
+    break;
+  }
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+  return 0;
+}
+
+
+
+int _writeBuffer(GWEN_SYNCIO *sio, GWEN_BUFFER *buf)
+{
+  int rv;
+
+  rv=GWEN_SyncIo_WriteForced(sio, (const uint8_t *) GWEN_Buffer_GetStart(buf), GWEN_Buffer_GetUsedBytes(buf));
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+  return 0;
+}
+
+
+
+int _writePadded(GWEN_SYNCIO *sio, const uint8_t *ptr, uint32_t len)
+{
+  uint32_t padLen;
+  int rv;
+
+  if (len) {
+    rv=GWEN_SyncIo_WriteForced(sio, ptr, len);
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      return rv;
+    }
+  }
+
+  padLen=_pad8(len)-len;
+  if (padLen) {
+    rv=GWEN_SyncIo_WriteForced(sio, _zeroBytes, padLen);
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      return rv;
+    }
+  }
+  return 0;
+}
+
+
+
+uint32_t _pad8(uint32_t len)
+{
+  return (len+7) & ~((uint32_t) 7);
+}
+
+
+
+void _setUint32Le(uint8_t *p, uint32_t v)
+{
+  p[0]=(uint8_t)(v & 0xff);
+  p[1]=(uint8_t)((v>>8) & 0xff);
+  p[2]=(uint8_t)((v>>16) & 0xff);
+  p[3]=(uint8_t)((v>>24) & 0xff);
+}
+
+
+
+void _setUint64Le(uint8_t *p, uint64_t v)
+{
+  _setUint32Le(p, (uint32_t)(v & 0xffffffff));
+  _setUint32Le(p+4, (uint32_t)(v>>32));
+}
+
+
+
+void _appendUint32Le(GWEN_BUFFER *buf, uint32_t v)
+{
+  uint8_t b[4];
+
+  _setUint32Le(b, v);
+  GWEN_Buffer_AppendBytes(buf, (const char *) b, sizeof(b));
+}
+
+
+
+void _appendUint64Le(GWEN_BUFFER *buf, uint64_t v)
+{
+  uint8_t b[8];
+
+  _setUint64Le(b, v);
+  GWEN_Buffer_AppendBytes(buf, (const char *) b, sizeof(b));
+}
+
+
+
+int _getType(const AB_TRANSACTION *t)
+{
+  return AB_Transaction_GetType(t);
+}
+
+
+
+int _getSubType(const AB_TRANSACTION *t)
+{
+  return AB_Transaction_GetSubType(t);
+}
+
+
+
+int _getStatus(const AB_TRANSACTION *t)
+{
+  return AB_Transaction_GetStatus(t);
+}
+
+
+
+const char *_getCurrency(const AB_TRANSACTION *t)
+{
+  const AB_VALUE *v;
+
+  v=AB_Transaction_GetValue(t);
+  return v?AB_Value_GetCurrency(v):NULL;
+}
+
+
+
@@ -0,0 +1,21 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ *          Please see toplevel file COPYING for license details           *
+ ***************************************************************************/
+
+
+#ifndef AQBANKING_IMEX_COLUMNAR_H
+#define AQBANKING_IMEX_COLUMNAR_H
+
+
+#include <aqbanking/backendsupport/imexporter_be.h>
+
+
+AB_IMEXPORTER *AB_ImExporterColumnar_new(AB_BANKING *ab);
+
+
+#endif /* AQBANKING_IMEX_COLUMNAR_H */
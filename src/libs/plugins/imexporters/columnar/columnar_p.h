@@ -0,0 +1,96 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ *          Please see toplevel file COPYING for license details           *
+ ***************************************************************************/
+
+
+#ifndef AQBANKING_IMEX_COLUMNAR_P_H
+#define AQBANKING_IMEX_COLUMNAR_P_H
+
+
+#include "columnar.h"
+
+#include <aqbanking/backendsupport/imexporter_be.h>
+
+#include <gwenhywfar/buffer.h>
+#include <gwenhywfar/syncio.h>
+
+
+/* file format, see README */
+#define AH_COLUMNAR_MAGIC                "AQBCOLS1"
+#define AH_COLUMNAR_MAGIC_LEN            8
+#define AH_COLUMNAR_VERSION              1
+
+#define AH_COLUMNAR_DEFAULT_BATCHSIZE    65536
+#define AH_COLUMNAR_MAX_BATCHSIZE        (1024*1024)
+#define AH_COLUMNAR_DEFAULT_SCALE        2
+
+/* julian day of 1970/01/01, dates are stored as days since then */
+#define AH_COLUMNAR_JULIAN_EPOCH         2440588
+
+
+typedef enum {
+  AH_ColumnarType_Int32=1,
+  AH_ColumnarType_UInt32,
+  AH_ColumnarType_Date32,
+  AH_ColumnarType_Decimal64,
+  AH_ColumnarType_String
+} AH_COLUMNAR_TYPE;
+
+
+/* description of a column, only the getter matching the type is set */
+typedef struct AH_COLUMNAR_COLDEF AH_COLUMNAR_COLDEF;
+struct AH_COLUMNAR_COLDEF {
+  const char *name;
+  AH_COLUMNAR_TYPE type;
+  int (*getInt)(const AB_TRANSACTION *t);
+  uint32_t (*getUInt)(const AB_TRANSACTION *t);
+  const GWEN_DATE *(*getDate)(const AB_TRANSACTION *t);
+  const AB_VALUE *(*getValue)(const AB_TRANSACTION *t);
+  const char *(*getString)(const AB_TRANSACTION *t);
+};
+
+
+/* column buffers of the current batch (all data little endian) */
+typedef struct AH_COLUMNAR_COLUMN AH_COLUMNAR_COLUMN;
+struct AH_COLUMNAR_COLUMN {
+  const AH_COLUMNAR_COLDEF *def;
+  uint8_t *validity;         /* one bit per row (LSB first), set if the value is not NULL */
+  uint8_t *values;           /* 4 or 8 bytes per row, for strings batchSize+1 offsets into stringData */
+  GWEN_BUFFER *stringData;   /* only for strings */
+};
+
+
+typedef struct AH_COLUMNAR_WRITER AH_COLUMNAR_WRITER;
+struct AH_COLUMNAR_WRITER {
+  GWEN_SYNCIO *sio;
+  AH_COLUMNAR_COLUMN *columns;
+  int columnCount;
+  uint32_t batchSize;
+  uint32_t rowCount;          /* rows in current batch */
+  uint64_t totalRowCount;
+  int scale;
+};
+
+
+typedef struct AH_IMEXPORTER_COLUMNAR AH_IMEXPORTER_COLUMNAR;
+struct AH_IMEXPORTER_COLUMNAR {
+  int dummy;
+};
+
+
+static void GWENHYWFAR_CB AH_ImExporterColumnar_FreeData(void *bp, void *p);
+
+static int AH_ImExporterColumnar_Export(AB_IMEXPORTER *ie,
+                                        AB_IMEXPORTER_CONTEXT *ctx,
+                                        GWEN_SYNCIO *sio,
+                                        GWEN_DB_NODE *params);
+
+static int AH_ImExporterColumnar_CheckFile(AB_IMEXPORTER *ie, const char *fname);
+
+
+#endif /* AQBANKING_IMEX_COLUMNAR_P_H */
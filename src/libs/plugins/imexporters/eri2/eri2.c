@@ -22,8 +22,7 @@
 #include <gwenhywfar/syncio_buffered.h>
 
 #include <aqbanking/banking_be.h>
-#include <aqbanking/backendsupport/msgengine.h>
-#include <aqbanking/banking_be.h>
+#include <aqbanking/backendsupport/fixedrecord.h>
 #include <aqbanking/types/transaction.h>
 #include "aqbanking/i18n_l.h"
 
@@ -92,8 +91,34 @@ AB_IMEXPORTER *AB_ImExporterERI2_new(AB_BANKING *ab)
       }
       GWEN_Buffer_free(fbuf);
 
-      ieh->msgEngine = AB_MsgEngine_new();
-      GWEN_MsgEngine_SetDefinitions(ieh->msgEngine, xmlNode, 1);
+      ieh->layoutRec1=AB_ImExporterERI2__CompileLayout(xmlNode, "RecordType1");
+      ieh->layoutRec2=AB_ImExporterERI2__CompileLayout(xmlNode, "RecordType2");
+      ieh->layoutRec3=AB_ImExporterERI2__CompileLayout(xmlNode, "RecordType3");
+      GWEN_XMLNode_free(xmlNode);
+      if (ieh->layoutRec1==NULL || ieh->layoutRec2==NULL || ieh->layoutRec3==NULL) {
+        DBG_ERROR(AQBANKING_LOGDOMAIN, "Invalid record definitions in XML data file");
+        AB_ImExporter_free(ie);
+        return NULL;
+      }
+
+      /* lookup fields handled here once */
+      ieh->idxCode=AB_FixedRecordLayout_GetFieldIndex(ieh->layoutRec1, "code");
+      ieh->idxCurrency=AB_FixedRecordLayout_GetFieldIndex(ieh->layoutRec1, "currency");
+      ieh->idxLocalAccountNumber=AB_FixedRecordLayout_GetFieldIndex(ieh->layoutRec1, "localAccountNumber");
+      ieh->idxRemoteAccountNumber=AB_FixedRecordLayout_GetFieldIndex(ieh->layoutRec1, "remoteAccountNumber");
+      ieh->idxAmount=AB_FixedRecordLayout_GetFieldIndex(ieh->layoutRec1, "Amount");
+      ieh->idxSign=AB_FixedRecordLayout_GetFieldIndex(ieh->layoutRec1, "Sign");
+      ieh->idxNumberOfExtraRecords=AB_FixedRecordLayout_GetFieldIndex(ieh->layoutRec2, "NumberOfExtraRecords");
+      ieh->idxPurpose3=AB_FixedRecordLayout_GetFieldIndex(ieh->layoutRec3, "purpose3");
+      ieh->idxPurpose4=AB_FixedRecordLayout_GetFieldIndex(ieh->layoutRec3, "purpose4");
+      ieh->idxPurpose5=AB_FixedRecordLayout_GetFieldIndex(ieh->layoutRec3, "purpose5");
+      if (ieh->idxCode<0 || ieh->idxCurrency<0 || ieh->idxLocalAccountNumber<0 || ieh->idxRemoteAccountNumber<0 ||
+          ieh->idxAmount<0 || ieh->idxSign<0 || ieh->idxNumberOfExtraRecords<0 ||
+          ieh->idxPurpose3<0 || ieh->idxPurpose4<0 || ieh->idxPurpose5<0) {
+        DBG_ERROR(AQBANKING_LOGDOMAIN, "Missing fields in XML data file");
+        AB_ImExporter_free(ie);
+        return NULL;
+      }
 
       AB_ImExporter_SetImportFn(ie, AB_ImExporterERI2_Import);
       AB_ImExporter_SetExportFn(ie, AB_ImExporterERI2_Export);
@@ -110,11 +135,26 @@ AB_IMEXPORTER *AB_ImExporterERI2_new(AB_BANKING *ab)
 
 
 
+AB_FIXEDRECORD_LAYOUT *AB_ImExporterERI2__CompileLayout(GWEN_XMLNODE *xmlNode, const char *recordId)
+{
+  AB_FIXEDRECORD_LAYOUT *rl;
+
+  rl=AB_FixedRecordLayout_fromXml(xmlNode, recordId);
+  if (rl)
+    AB_FixedRecordLayout_SetFlags(rl, AB_FIXEDRECORD_LAYOUT_FLAGS_ISO8859_1);
+  return rl;
+}
+
+
+
 void GWENHYWFAR_CB AB_ImExporterERI2_FreeData(void *bp, void *p)
 {
   AB_IMEXPORTER_ERI2 *ieh;
 
   ieh=(AB_IMEXPORTER_ERI2 *)p;
+  AB_FixedRecordLayout_free(ieh->layoutRec3);
+  AB_FixedRecordLayout_free(ieh->layoutRec2);
+  AB_FixedRecordLayout_free(ieh->layoutRec1);
   GWEN_FREE_OBJECT(ieh);
 }
 
@@ -126,24 +166,30 @@ int AB_ImExporterERI2_Import(AB_IMEXPORTER *ie,
                              GWEN_DB_NODE *params)
 {
   AB_IMEXPORTER_ERI2 *ieh;
-  GWEN_DB_NODE *dbData;
-  int rv;
   GWEN_BUFFER *mbuf;
   GWEN_FAST_BUFFER *fb;
+  AB_TRANSACTION *t=NULL;
+  int extraRecords=0;
+  int extraRecordsSeen=0;
+  const char *dateFormat;
+  int rv=0;
 
   assert(ie);
   ieh = GWEN_INHERIT_GETDATA(AB_IMEXPORTER, AB_IMEXPORTER_ERI2, ie);
   assert(ieh);
 
-  mbuf = GWEN_Buffer_new(0, 1024, 0, 1);
-  dbData = GWEN_DB_Group_new("transactions");
+  dateFormat=GWEN_DB_GetCharValue(params, "dateFormat", 0, "YYMMDD");
+  AB_FixedRecordLayout_SetDateTemplate(ieh->layoutRec1, dateFormat);
 
+  mbuf = GWEN_Buffer_new(0, 256, 0, 1);
   fb=GWEN_FastBuffer_new(512, sio);
 
-  /* parse into db */
+  /* decode records directly into transactions */
   for (;;) {
-    int rv;
     int c;
+    const char *recPtr;
+    int recLen;
+    char code[4];
 
     GWEN_Buffer_Reset(mbuf);
     GWEN_FASTBUFFER_PEEKBYTE(fb, c);
@@ -155,53 +201,101 @@ int AB_ImExporterERI2_Import(AB_IMEXPORTER *ie,
     }
     else if (c<0) {
       DBG_ERROR(0, "Error reading message");
-      GWEN_FastBuffer_free(fb);
-      GWEN_Buffer_free(mbuf);
-      GWEN_DB_Group_free(dbData);
-      return c;
+      rv=c;
+      break;
     }
 
     rv=GWEN_FastBuffer_ReadLineToBuffer(fb, mbuf);
     if (rv<0) {
       DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
-      GWEN_FastBuffer_free(fb);
-      GWEN_Buffer_free(mbuf);
-      GWEN_DB_Group_free(dbData);
-      return rv;
+      break;
     }
+    rv=0;
 
-    GWEN_Buffer_Rewind(mbuf);
+    recPtr=GWEN_Buffer_GetStart(mbuf);
+    recLen=GWEN_Buffer_GetUsedBytes(mbuf);
+    if (recLen==0)
+      continue;
 
-    rv = GWEN_MsgEngine_ReadMessage(ieh->msgEngine, "SEG", mbuf, dbData, 0);
-    if (rv) {
-      GWEN_FastBuffer_free(fb);
-      GWEN_Buffer_free(mbuf);
-      GWEN_DB_Group_free(dbData);
-      return GWEN_ERROR_GENERIC;
+    /* all records share the same header, so use the first layout to determine the record type */
+    if (AB_FixedRecordLayout_GetString(ieh->layoutRec1, ieh->idxCode, recPtr, recLen, code, sizeof(code))!=1) {
+      DBG_ERROR(AQBANKING_LOGDOMAIN, "Record without type code");
+      rv=GWEN_ERROR_BAD_DATA;
+      break;
+    }
+
+    if (*code=='2') {
+      /* RecordType1: start of a new transaction */
+      if (t) {
+        rv=AB_ImExporterERI2__FinishTransaction(ctx, t, extraRecords, extraRecordsSeen, params);
+        t=NULL;
+        if (rv<0) {
+          DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+          break;
+        }
+      }
+      extraRecords=0;
+      extraRecordsSeen=0;
+
+      DBG_DEBUG(AQBANKING_LOGDOMAIN, "Found a possible transaction");
+      t=AB_Transaction_new();
+      rv=AB_ImExporterERI2__HandleRec1(ieh, recPtr, recLen, params, t);
+      if (rv==GWEN_ERROR_NO_DATA) {
+        DBG_ERROR(AQBANKING_LOGDOMAIN, "Empty record");
+        AB_Transaction_free(t);
+        t=NULL;
+        rv=0;
+      }
+      else if (rv<0) {
+        DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+        break;
+      }
+    }
+    else if (*code=='3') {
+      /* RecordType2: purpose lines 1-2 */
+      if (t) {
+        rv=AB_ImExporterERI2__HandleRec2(ieh, recPtr, recLen, t, &extraRecords);
+        if (rv<0) {
+          DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+          break;
+        }
+      }
+    }
+    else if (*code=='4') {
+      /* RecordType3: further purpose lines */
+      if (t && extraRecordsSeen<extraRecords) {
+        if (extraRecordsSeen==0)
+          rv=AB_ImExporterERI2__HandleRec3(ieh, recPtr, recLen, t);
+        else
+          rv=AB_ImExporterERI2__HandleRec4(ieh, recPtr, recLen, t);
+        if (rv<0) {
+          DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+          break;
+        }
+        extraRecordsSeen++;
+      }
+    }
+    else {
+      DBG_ERROR(AQBANKING_LOGDOMAIN, "Unknown record type \"%s\"", code);
+      rv=GWEN_ERROR_BAD_DATA;
+      break;
     }
   }
   GWEN_FastBuffer_free(fb);
   GWEN_Buffer_free(mbuf);
 
-  /* import from db */
-  GWEN_Gui_ProgressLog(0, GWEN_LoggerLevel_Notice,
-                       I18N("Data imported, transforming to UTF-8"));
-  rv=AB_ImExporter_DbFromIso8859_1ToUtf8(dbData);
-  if (rv) {
-    GWEN_Gui_ProgressLog(0, GWEN_LoggerLevel_Error,
-                         "Error converting data");
-    GWEN_DB_Group_free(dbData);
+  if (rv<0) {
+    AB_Transaction_free(t);
     return rv;
   }
-  GWEN_Gui_ProgressLog(0, GWEN_LoggerLevel_Notice,
-                       "Transforming data to transactions");
-  rv = AB_ImExporterERI2__ImportFromGroup(ctx, dbData, params);
-  if (rv) {
-    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
-    GWEN_DB_Group_free(dbData);
-    return rv;
+
+  if (t) {
+    rv=AB_ImExporterERI2__FinishTransaction(ctx, t, extraRecords, extraRecordsSeen, params);
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      return rv;
+    }
   }
-  GWEN_DB_Group_free(dbData);
 
   return 0;
 }
@@ -219,221 +313,243 @@ const char *AB_ImExporterERI2__StripPZero(const char *p)
 
 
 
-int AB_ImExporterERI2__HandleRec1(GWEN_DB_NODE *dbT,
+int AB_ImExporterERI2__HandleRec1(AB_IMEXPORTER_ERI2 *ieh,
+                                  const char *recPtr, int recLen,
                                   GWEN_DB_NODE *dbParams,
                                   AB_TRANSACTION *t)
 {
-  const char *p;
-  const char *dateFormat;
+  char buffer[AB_FIXEDRECORD_MAXSTRINGSIZE];
+  char currency[AB_FIXEDRECORD_MAXSTRINGSIZE];
+  int rv;
+
+  /* only records with an amount are transactions */
+  rv=AB_FixedRecordLayout_GetString(ieh->layoutRec1, ieh->idxAmount, recPtr, recLen, buffer, sizeof(buffer));
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+  else if (rv==0)
+    return GWEN_ERROR_NO_DATA;
+
+  rv=AB_FixedRecordLayout_GetString(ieh->layoutRec1, ieh->idxCurrency, recPtr, recLen, currency, sizeof(currency));
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+  else if (rv==0)
+    strcpy(currency, "EUR");
 
-  dateFormat = GWEN_DB_GetCharValue(dbParams, "dateFormat", 0, "YYMMDD");
+  /* value, dates, remote name and customer reference */
+  rv=AB_FixedRecordLayout_DecodeTransaction(ieh->layoutRec1, recPtr, recLen, currency, t);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
 
-  /* strip leading zeroes from localaccountnumber
-     can be removed when lfiller="48" does what I expect from i */
-  p = GWEN_DB_GetCharValue(dbT, "localAccountNumber", 0, 0);
-  p = AB_ImExporterERI2__StripPZero(p);
-  AB_Transaction_SetLocalAccountNumber(t, p);
+  /* strip leading zeroes from localaccountnumber */
+  rv=AB_FixedRecordLayout_GetString(ieh->layoutRec1, ieh->idxLocalAccountNumber, recPtr, recLen, buffer, sizeof(buffer));
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+  AB_Transaction_SetLocalAccountNumber(t, AB_ImExporterERI2__StripPZero(buffer));
 
   /* strip leading P and zeroes from remoteaccountnumber
      this CANNOT be done with lfiller="48" becaus of the P added
      to Postgiro accounts */
-  p = GWEN_DB_GetCharValue(dbT, "remoteAccountNumber", 0, 0);
-  p = AB_ImExporterERI2__StripPZero(p);
+  rv=AB_FixedRecordLayout_GetString(ieh->layoutRec1, ieh->idxRemoteAccountNumber, recPtr, recLen, buffer, sizeof(buffer));
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+  else {
+    const char *p;
 
+    p=AB_ImExporterERI2__StripPZero(buffer);
 #ifdef ERI2DEBUG
-  printf("Remote Account Number after StripPZero is %s\n", p);
+    printf("Remote Account Number after StripPZero is %s\n", p);
 #endif
+    AB_Transaction_SetRemoteAccountNumber(t, p);
+  }
 
-  AB_Transaction_SetRemoteAccountNumber(t, p);
-
-  /* translate value */
-  p = GWEN_DB_GetCharValue(dbT, "Amount", 0, 0);
-  if (p) {
-    AB_VALUE *v;
-    AB_VALUE *v2;
-
-    /* divide by 100 */
-    v=AB_Value_fromString(p);
-    v2=AB_Value_fromDouble(100.0);
-    AB_Value_DivValue(v, v2);
-    AB_Value_free(v2);
-
-    AB_Value_SetCurrency(v, GWEN_DB_GetCharValue(dbT, "currency", 0, "EUR"));
-    AB_Transaction_SetValue(t, v);
-    AB_Value_free(v);
+  /* possibly translate value */
+  rv=AB_FixedRecordLayout_GetString(ieh->layoutRec1, ieh->idxSign, recPtr, recLen, buffer, sizeof(buffer));
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
   }
+  else if (rv>0)
+    AB_ImExporterERI2__HandleSign(buffer, dbParams, t);
 
-  /* translate date */
-  p = GWEN_DB_GetCharValue(dbT, "date", 0, 0);
-  if (p) {
-    GWEN_DATE *da;
+  return 0;
+}
 
-    da = GWEN_Date_fromStringWithTemplate(p, dateFormat);
-    if (da)
-      AB_Transaction_SetDate(t, da);
-    GWEN_Date_free(da);
-  }
 
-  /* translate valutaDate */
-  p = GWEN_DB_GetCharValue(dbT, "valutaDate", 0, 0);
-  if (p) {
-    GWEN_DATE *da;
 
-    da = GWEN_Date_fromStringWithTemplate(p, dateFormat);
-    if (da)
-      AB_Transaction_SetValutaDate(t, da);
-    GWEN_Date_free(da);
-  }
+void AB_ImExporterERI2__HandleSign(const char *p, GWEN_DB_NODE *dbParams, AB_TRANSACTION *t)
+{
+  int determined=0;
+  int j;
 
-  /* possibly translate value */
-  p = GWEN_DB_GetCharValue(dbT, "Sign", 0, 0);
-  if (p) {
-    int determined=0;
-    int j;
+  /* get positive/negative mark */
+
+  /* try positive marks first */
+  for (j=0; ; j++) {
+    const char *patt;
 
-    /* get positive/negative mark */
+    patt = GWEN_DB_GetCharValue(dbParams, "positiveValues", j, 0);
+    if (!patt) {
+      if (j == 0)
+        patt = "C";
+      else
+        break;
+    }
+    if (-1 != GWEN_Text_ComparePattern(p, patt, 0)) {
+      /* value already is positive, keep it that way */
+      determined = 1;
+      break;
+    }
+  } /* for */
 
-    /* try positive marks first */
+  if (!determined) {
     for (j=0; ; j++) {
       const char *patt;
 
-      patt = GWEN_DB_GetCharValue(dbParams, "positiveValues", j, 0);
+      patt = GWEN_DB_GetCharValue(dbParams, "negativeValues", j, 0);
       if (!patt) {
         if (j == 0)
-          patt = "C";
+          patt = "D";
         else
           break;
       }
       if (-1 != GWEN_Text_ComparePattern(p, patt, 0)) {
-        /* value already is positive, keep it that way */
+        const AB_VALUE *pv;
+
+        /* value must be negated */
+        pv = AB_Transaction_GetValue(t);
+        if (pv) {
+          AB_VALUE *v;
+
+          v = AB_Value_dup(pv);
+          AB_Value_Negate(v);
+          AB_Transaction_SetValue(t, v);
+          AB_Value_free(v);
+        }
         determined = 1;
         break;
       }
     } /* for */
-
-    if (!determined) {
-      for (j=0; ; j++) {
-        const char *patt;
-
-        patt = GWEN_DB_GetCharValue(dbParams, "negativeValues", j, 0);
-        if (!patt) {
-          if (j == 0)
-            patt = "D";
-          else
-            break;
-        }
-        if (-1 != GWEN_Text_ComparePattern(p, patt, 0)) {
-          const AB_VALUE *pv;
-
-          /* value must be negated */
-          pv = AB_Transaction_GetValue(t);
-          if (pv) {
-            AB_VALUE *v;
-
-            v = AB_Value_dup(pv);
-            AB_Value_Negate(v);
-            AB_Transaction_SetValue(t, v);
-            AB_Value_free(v);
-          }
-          determined = 1;
-          break;
-        }
-      } /* for */
-    }
-  } /* if sign mark */
-
-  return 0;
+  }
 }
 
 
 
-void AB_ImExporterERI2__AddPurpose(AB_TRANSACTION *t, const char *s)
+int AB_ImExporterERI2__HandleRec2(AB_IMEXPORTER_ERI2 *ieh,
+                                  const char *recPtr, int recLen,
+                                  AB_TRANSACTION *t,
+                                  int *pExtraRecords)
 {
+  int rv;
+  int num3=0;
+
+  /* purpose lines 1-2 and bank reference */
+  rv=AB_FixedRecordLayout_DecodeTransaction(ieh->layoutRec2, recPtr, recLen, NULL, t);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
 
-  if (strlen(s) > 0)
-    AB_Transaction_AddPurposeLine(t, s);
+  rv=AB_FixedRecordLayout_GetInt(ieh->layoutRec2, ieh->idxNumberOfExtraRecords, recPtr, recLen, &num3);
+  if (rv<0 && rv!=GWEN_ERROR_NO_DATA) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+  *pExtraRecords=num3;
 
+  return 0;
 }
 
 
 
-int AB_ImExporterERI2__HandleRec2(GWEN_DB_NODE *dbT,
-                                  GWEN_DB_NODE *dbParams,
+int AB_ImExporterERI2__HandleRec3(AB_IMEXPORTER_ERI2 *ieh,
+                                  const char *recPtr, int recLen,
                                   AB_TRANSACTION *t)
 {
-  const char *p;
+  char buffer[AB_FIXEDRECORD_MAXSTRINGSIZE];
+  int idx[3];
+  int i;
+
+  idx[0]=ieh->idxPurpose3;
+  idx[1]=ieh->idxPurpose4;
+  idx[2]=ieh->idxPurpose5;
 
-  p = GWEN_DB_GetCharValue(dbT, "purpose1", 0, 0);
-  if (p)
-    AB_ImExporterERI2__AddPurpose(t, p);
+  for (i=0; i<3; i++) {
+    int rv;
 
-  p = GWEN_DB_GetCharValue(dbT, "purpose2", 0, 0);
-  if (p)
-    AB_ImExporterERI2__AddPurpose(t, p);
+    rv=AB_FixedRecordLayout_GetString(ieh->layoutRec3, idx[i], recPtr, recLen, buffer, sizeof(buffer));
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      return rv;
+    }
+    else if (rv>0)
+      AB_Transaction_AddPurposeLine(t, buffer);
+  }
 
   return 0;
 }
 
 
 
-int AB_ImExporterERI2__HandleRec3(GWEN_DB_NODE *dbT,
-                                  GWEN_DB_NODE *dbParams,
+int AB_ImExporterERI2__HandleRec4(AB_IMEXPORTER_ERI2 *ieh,
+                                  const char *recPtr, int recLen,
                                   AB_TRANSACTION *t)
 {
-  const char *p;
+  char buffer[3*AB_FIXEDRECORD_MAXSTRINGSIZE];
+  int idx[3];
+  int pos=0;
+  int i;
 
-  p = GWEN_DB_GetCharValue(dbT, "purpose3", 0, 0);
-  if (p)
-    AB_ImExporterERI2__AddPurpose(t, p);
+  /* further records of type 3 are combined into a single purpose line */
+  idx[0]=ieh->idxPurpose3;
+  idx[1]=ieh->idxPurpose4;
+  idx[2]=ieh->idxPurpose5;
 
-  p = GWEN_DB_GetCharValue(dbT, "purpose4", 0, 0);
-  if (p)
-    AB_ImExporterERI2__AddPurpose(t, p);
+  for (i=0; i<3; i++) {
+    int rv;
 
-  p = GWEN_DB_GetCharValue(dbT, "purpose5", 0, 0);
-  if (p)
-    AB_ImExporterERI2__AddPurpose(t, p);
+    rv=AB_FixedRecordLayout_GetString(ieh->layoutRec3, idx[i], recPtr, recLen,
+                                      buffer+pos, AB_FIXEDRECORD_MAXSTRINGSIZE);
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      return rv;
+    }
+    pos+=rv;
+    if (i<2 && pos<32*(i+1))
+      buffer[pos++]=' ';
+  }
+  buffer[pos]=0;
 
+  if (pos)
+    AB_Transaction_AddPurposeLine(t, buffer);
   return 0;
 }
 
 
 
-int AB_ImExporterERI2__HandleRec4(GWEN_DB_NODE *dbT,
-                                  GWEN_DB_NODE *dbParams,
-                                  AB_TRANSACTION *t)
+int AB_ImExporterERI2__FinishTransaction(AB_IMEXPORTER_CONTEXT *ctx,
+                                         AB_TRANSACTION *t,
+                                         int extraRecords, int extraRecordsSeen,
+                                         GWEN_DB_NODE *params)
 {
-
-  const char *p1, *p2, *p3;
-  GWEN_BUFFER *pbuf;
-  char strbuf[97];
-  unsigned int strlen = 0, *ps = &strlen;
-
-  pbuf = GWEN_Buffer_new(0, 96, 0, 1);
-
-  p1 = GWEN_DB_GetCharValue(dbT, "purpose3", 0, 0);
-  p2 = GWEN_DB_GetCharValue(dbT, "purpose4", 0, 0);
-  p3 = GWEN_DB_GetCharValue(dbT, "purpose5", 0, 0);
-
-  if (p1)
-    GWEN_Buffer_AppendString(pbuf, p1);
-  if (GWEN_Buffer_GetUsedBytes(pbuf) < 32)
-    GWEN_Buffer_AppendString(pbuf, " ");
-  if (p2)
-    GWEN_Buffer_AppendString(pbuf, p2);
-  if (GWEN_Buffer_GetUsedBytes(pbuf) < 64)
-    GWEN_Buffer_AppendString(pbuf, " ");
-  if (p3)
-    GWEN_Buffer_AppendString(pbuf, p3);
-
-  strlen = GWEN_Buffer_GetUsedBytes(pbuf);
-  if (strlen) {
-    GWEN_Buffer_Rewind(pbuf);
-    GWEN_Buffer_ReadBytes(pbuf, strbuf, ps);
-    strbuf[strlen] = 0;
-    AB_ImExporterERI2__AddPurpose(t, strbuf);
+  if (extraRecordsSeen!=extraRecords) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN,
+              "Missing records (have %d of %d)", extraRecordsSeen, extraRecords);
+    AB_Transaction_free(t);
+    return GWEN_ERROR_BAD_DATA;
   }
-  GWEN_Buffer_free(pbuf);
+
+  DBG_NOTICE(AQBANKING_LOGDOMAIN, "Adding transaction");
+  AB_ImExporterERI2__AddTransaction(ctx, t, params);
   return 0;
 }
 
@@ -480,96 +596,6 @@ void AB_ImExporterERI2__AddTransaction(AB_IMEXPORTER_CONTEXT *ctx,
 
 
 
-int AB_ImExporterERI2__ImportFromGroup(AB_IMEXPORTER_CONTEXT *ctx,
-                                       GWEN_DB_NODE *db,
-                                       GWEN_DB_NODE *dbParams)
-{
-  GWEN_DB_NODE *dbT;
-
-  dbT = GWEN_DB_FindFirstGroup(db, "RecordType1");
-  while (dbT) {
-    if (GWEN_DB_GetCharValue(dbT, "amount", 0, 0)) {
-      AB_TRANSACTION *t;
-      GWEN_DB_NODE *dbN;
-      int rv;
-
-      DBG_DEBUG(AQBANKING_LOGDOMAIN, "Found a possible transaction");
-      t = AB_Transaction_fromDb(dbT);
-      if (!t) {
-        DBG_ERROR(AQBANKING_LOGDOMAIN, "Error in config file");
-        GWEN_Gui_ProgressLog(0, GWEN_LoggerLevel_Error,
-                             "Error in config file");
-        return GWEN_ERROR_GENERIC;
-      }
-
-      rv = AB_ImExporterERI2__HandleRec1(dbT, dbParams, t);
-      if (rv) {
-        DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
-        AB_Transaction_free(t);
-        return rv;
-      }
-
-      /* check whether the next group is of record type 2 */
-      dbN = GWEN_DB_GetNextGroup(dbT);
-      if (dbN) {
-        if (strcasecmp(GWEN_DB_GroupName(dbN), "RecordType2") == 0) {
-          int num3;
-          int i;
-
-          rv = AB_ImExporterERI2__HandleRec2(dbN, dbParams, t);
-          if (rv) {
-            DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
-            AB_Transaction_free(t);
-            return rv;
-          }
-          num3 = GWEN_DB_GetIntValue(dbN, "NumberOfExtraRecords", 0, 0);
-          for (i = 0; i < num3; i++) {
-            dbN = GWEN_DB_GetNextGroup(dbN);
-            if (!dbN)
-              break;
-            else {
-              if (strcasecmp(GWEN_DB_GroupName(dbN), "RecordType1") == 0)
-                break;
-              if (strcasecmp(GWEN_DB_GroupName(dbN), "RecordType3") == 0) {
-                if (!i) {
-                  rv = AB_ImExporterERI2__HandleRec3(dbN, dbParams, t);
-                }
-                else {
-                  rv = AB_ImExporterERI2__HandleRec4(dbN, dbParams, t);
-                }
-                if (rv) {
-                  DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
-                  AB_Transaction_free(t);
-                  return rv;
-                }
-              }
-            }
-          } /* for */
-          if (i != num3) {
-            DBG_ERROR(AQBANKING_LOGDOMAIN,
-                      "Missing records (have %d of %d)", i, num3);
-            AB_Transaction_free(t);
-            return rv;
-          }
-        } /* if type 2 follows */
-      } /* if any group follows */
-
-      DBG_NOTICE(AQBANKING_LOGDOMAIN, "Adding transaction");
-      AB_ImExporterERI2__AddTransaction(ctx, t, dbParams);
-    }
-    else {
-      DBG_ERROR(AQBANKING_LOGDOMAIN, "Empty group");
-      GWEN_DB_Dump(dbT, 2);
-    }
-
-    dbT=GWEN_DB_FindNextGroup(dbT, "RecordType1");
-  } // while
-
-  return 0;
-}
-
-
-
 int AB_ImExporterERI2_CheckFile(AB_IMEXPORTER *ie, const char *fname)
 {
   GWEN_BUFFER *lbuffer;
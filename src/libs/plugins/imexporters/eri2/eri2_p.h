@@ -22,43 +22,62 @@
 #include <aqbanking/backendsupport/imexporter_be.h>
 #include <aqbanking/banking.h>
 
-#include <gwenhywfar/msgengine.h>
+#include <aqbanking/backendsupport/fixedrecord.h>
 
 
 typedef struct AB_IMEXPORTER_ERI2 AB_IMEXPORTER_ERI2;
 struct AB_IMEXPORTER_ERI2 {
-  GWEN_MSGENGINE *msgEngine;
+  AB_FIXEDRECORD_LAYOUT *layoutRec1;
+  AB_FIXEDRECORD_LAYOUT *layoutRec2;
+  AB_FIXEDRECORD_LAYOUT *layoutRec3;
+
+  /* indices of fields not directly stored into transactions */
+  int idxCode;
+  int idxCurrency;
+  int idxLocalAccountNumber;
+  int idxRemoteAccountNumber;
+  int idxAmount;
+  int idxSign;
+  int idxNumberOfExtraRecords;
+  int idxPurpose3;
+  int idxPurpose4;
+  int idxPurpose5;
 };
 
 
 static void GWENHYWFAR_CB AB_ImExporterERI2_FreeData(void *bp, void *p);
 
+static AB_FIXEDRECORD_LAYOUT *AB_ImExporterERI2__CompileLayout(GWEN_XMLNODE *xmlNode, const char *recordId);
+
 static int AB_ImExporterERI2_Import(AB_IMEXPORTER *ie,
                                     AB_IMEXPORTER_CONTEXT *ctx,
                                     GWEN_SYNCIO *sio,
                                     GWEN_DB_NODE *params);
 
-static int AB_ImExporterERI2__ImportFromGroup(AB_IMEXPORTER_CONTEXT *ctx,
-                                              GWEN_DB_NODE *db,
-                                              GWEN_DB_NODE *dbParams);
-
-static int AB_ImExporterERI2__HandleRec1(GWEN_DB_NODE *dbT,
+static int AB_ImExporterERI2__HandleRec1(AB_IMEXPORTER_ERI2 *ieh,
+                                         const char *recPtr, int recLen,
                                          GWEN_DB_NODE *dbParams,
                                          AB_TRANSACTION *t);
 
-static int AB_ImExporterERI2__HandleRec2(GWEN_DB_NODE *dbT,
-                                         GWEN_DB_NODE *dbParams,
-                                         AB_TRANSACTION *t);
+static void AB_ImExporterERI2__HandleSign(const char *p, GWEN_DB_NODE *dbParams, AB_TRANSACTION *t);
 
-static int AB_ImExporterERI2__HandleRec3(GWEN_DB_NODE *dbT,
-                                         GWEN_DB_NODE *dbParams,
+static int AB_ImExporterERI2__HandleRec2(AB_IMEXPORTER_ERI2 *ieh,
+                                         const char *recPtr, int recLen,
+                                         AB_TRANSACTION *t,
+                                         int *pExtraRecords);
+
+static int AB_ImExporterERI2__HandleRec3(AB_IMEXPORTER_ERI2 *ieh,
+                                         const char *recPtr, int recLen,
                                          AB_TRANSACTION *t);
 
-static int AB_ImExporterERI2__HandleRec4(GWEN_DB_NODE *dbT,
-                                         GWEN_DB_NODE *dbParams,
+static int AB_ImExporterERI2__HandleRec4(AB_IMEXPORTER_ERI2 *ieh,
+                                         const char *recPtr, int recLen,
                                          AB_TRANSACTION *t);
 
-static void AB_ImExporterERI2__AddPurpose(AB_TRANSACTION *t, const char *s);
+static int AB_ImExporterERI2__FinishTransaction(AB_IMEXPORTER_CONTEXT *ctx,
+                                                AB_TRANSACTION *t,
+                                                int extraRecords, int extraRecordsSeen,
+                                                GWEN_DB_NODE *params);
 
 static void AB_ImExporterERI2__AddTransaction(AB_IMEXPORTER_CONTEXT *ctx,
                                               AB_TRANSACTION *t,
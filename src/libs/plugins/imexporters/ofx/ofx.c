@@ -53,6 +53,7 @@ AB_IMEXPORTER *AB_ImExporterOFX_new(AB_BANKING *ab)
   GWEN_INHERIT_SETDATA(AB_IMEXPORTER, AH_IMEXPORTER_OFX, ie, ieh,
                        AH_ImExporterOFX_FreeData);
   AB_ImExporter_SetImportFn(ie, AH_ImExporterOFX_Import);
+  AB_ImExporter_AddFlags(ie, AB_IMEXPORTER_FLAGS_STREAMING_IMPORT);
   AB_ImExporter_SetCheckFileFn(ie, AH_ImExporterOFX_CheckFile);
   return ie;
 }
@@ -85,7 +86,7 @@ int AH_ImExporterOFX_Import(AB_IMEXPORTER *ie,
 
   /* this context does the real work, it sets some callbacks which
    * make GWEN's normal XML code read an OFX file */
-  xmlCtx=AIO_OfxXmlCtx_new(0, ctx);
+  xmlCtx=AIO_OfxXmlCtx_new(0, ie, ctx);
   assert(xmlCtx);
 
   /* possibly set charset */
@@ -93,7 +94,8 @@ int AH_ImExporterOFX_Import(AB_IMEXPORTER *ie,
   if (s && *s)
     AIO_OfxXmlCtx_SetCharset(xmlCtx, s);
 
-  /* read OFX file into context */
+  /* read OFX file into context (the XML reader consumes the input in chunks, if the caller set a
+   * transaction callback every STMTTRN/INVTRAN is handed over and released as soon as it is complete) */
   rv=GWEN_XMLContext_ReadFromIo(xmlCtx, sio);
   GWEN_XmlCtx_free(xmlCtx);
   if (rv<0) {
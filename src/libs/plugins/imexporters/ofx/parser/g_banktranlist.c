@@ -70,6 +70,8 @@ void AIO_OfxGroup_BANKTRANLIST_FreeData(void *bp, void *p)
   assert(xg);
   AB_Transaction_List2_freeAll(xg->transactionList);
 
+  free(xg->dtstart);
+  free(xg->dtend);
   free(xg->currentElement);
   GWEN_FREE_OBJECT(xg);
 }
@@ -194,8 +196,20 @@ int AIO_OfxGroup_BANKTRANLIST_EndSubGroup(AIO_OFX_GROUP *g, AIO_OFX_GROUP *sg)
 
     t=AIO_OfxGroup_STMTRN_TakeTransaction(sg);
     if (t) {
-      DBG_INFO(AQBANKING_LOGDOMAIN, "Adding transaction");
-      AB_Transaction_List2_PushBack(xg->transactionList, t);
+      if (AIO_OfxXmlCtx_IsStreaming(ctx)) {
+        int rv;
+
+        DBG_INFO(AQBANKING_LOGDOMAIN, "Delivering transaction");
+        rv=AIO_OfxXmlCtx_DeliverTransaction(ctx, t);
+        if (rv<0) {
+          DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+          return rv;
+        }
+      }
+      else {
+        DBG_INFO(AQBANKING_LOGDOMAIN, "Adding transaction");
+        AB_Transaction_List2_PushBack(xg->transactionList, t);
+      }
     }
   }
 
@@ -57,6 +57,9 @@ AIO_OFX_GROUP *AIO_OfxGroup_INVSTMTRS_new(const char *groupName,
   GWEN_INHERIT_SETDATA(AIO_OFX_GROUP, AIO_OFX_GROUP_INVSTMTRS, g, xg,
                        AIO_OfxGroup_INVSTMTRS_FreeData);
 
+  /* new statement, account not yet known */
+  AIO_OfxXmlCtx_SetCurrentAccountInfo(ctx, NULL);
+
   /* set virtual functions */
   AIO_OfxGroup_SetStartTagFn(g, AIO_OfxGroup_INVSTMTRS_StartTag);
   AIO_OfxGroup_SetAddDataFn(g, AIO_OfxGroup_INVSTMTRS_AddData);
@@ -223,6 +226,7 @@ int AIO_OfxGroup_INVSTMTRS_EndSubGroup(AIO_OFX_GROUP *g, AIO_OFX_GROUP *sg)
     DBG_INFO(AQBANKING_LOGDOMAIN, "Adding investment account");
     AB_ImExporterContext_AddAccountInfo(AIO_OfxXmlCtx_GetIoContext(ctx), ai);
     xg->accountInfo=ai;
+    AIO_OfxXmlCtx_SetCurrentAccountInfo(ctx, ai);
   }
 
   else if (strcasecmp(s, "INVTRANLIST") == 0) {
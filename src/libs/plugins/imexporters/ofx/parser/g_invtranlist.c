@@ -74,6 +74,8 @@ void AIO_OfxGroup_INVTRANLIST_FreeData(void *bp, void *p)
   assert(xg);
   AB_Transaction_List2_freeAll(xg->transactionList);
 
+  free(xg->dtstart);
+  free(xg->dtend);
   free(xg->currentElement);
   GWEN_FREE_OBJECT(xg);
 }
@@ -256,8 +258,21 @@ int AIO_OfxGroup_INVTRANLIST_EndSubGroup(AIO_OFX_GROUP *g, AIO_OFX_GROUP *sg)
 
   /*If one of the groups matches, then post a message about adding the new transaction to the list*/
   if (t) {
-    DBG_INFO(AQBANKING_LOGDOMAIN, "Adding transaction");
-    AB_Transaction_List2_PushBack(xg->transactionList, t);
+    if (AIO_OfxXmlCtx_IsStreaming(ctx)) {
+      int rv;
+
+      /* hand over the transaction right away instead of collecting the whole list */
+      DBG_INFO(AQBANKING_LOGDOMAIN, "Delivering transaction");
+      rv=AIO_OfxXmlCtx_DeliverTransaction(ctx, t);
+      if (rv<0) {
+        DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+        return rv;
+      }
+    }
+    else {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "Adding transaction");
+      AB_Transaction_List2_PushBack(xg->transactionList, t);
+    }
   }
   return 0;
 }
@@ -52,6 +52,9 @@ AIO_OFX_GROUP *AIO_OfxGroup_STMTRS_new(const char *groupName,
   GWEN_INHERIT_SETDATA(AIO_OFX_GROUP, AIO_OFX_GROUP_STMTRS, g, xg,
                        AIO_OfxGroup_STMTRS_FreeData);
 
+  /* new statement, account not yet known */
+  AIO_OfxXmlCtx_SetCurrentAccountInfo(ctx, NULL);
+
   /* set virtual functions */
   AIO_OfxGroup_SetStartTagFn(g, AIO_OfxGroup_STMTRS_StartTag);
   AIO_OfxGroup_SetAddDataFn(g, AIO_OfxGroup_STMTRS_AddData);
@@ -222,6 +225,7 @@ int AIO_OfxGroup_STMTRS_EndSubGroup(AIO_OFX_GROUP *g, AIO_OFX_GROUP *sg)
     DBG_INFO(AQBANKING_LOGDOMAIN, "Adding account");
     AB_ImExporterContext_AddAccountInfo(AIO_OfxXmlCtx_GetIoContext(ctx), ai);
     xg->accountInfo=ai;
+    AIO_OfxXmlCtx_SetCurrentAccountInfo(ctx, ai);
   }
   else if (strcasecmp(s, "BANKTRANLIST")==0) {
     AB_TRANSACTION_LIST2 *tl;
@@ -16,6 +16,8 @@
 #include "ofxxmlctx_p.h"
 #include "g_document_l.h"
 
+#include <aqbanking/backendsupport/imexporter_be.h>
+
 #include <gwenhywfar/misc.h>
 #include <gwenhywfar/debug.h>
 #include <gwenhywfar/text.h>
@@ -27,7 +29,7 @@ GWEN_INHERIT(GWEN_XML_CONTEXT, AIO_OFX_XMLCTX)
 
 
 
-GWEN_XML_CONTEXT *AIO_OfxXmlCtx_new(uint32_t flags, AB_IMEXPORTER_CONTEXT *ioContext)
+GWEN_XML_CONTEXT *AIO_OfxXmlCtx_new(uint32_t flags, AB_IMEXPORTER *ie, AB_IMEXPORTER_CONTEXT *ioContext)
 {
   GWEN_XML_CONTEXT *ctx;
   AIO_OFX_XMLCTX *xctx;
@@ -42,6 +44,7 @@ GWEN_XML_CONTEXT *AIO_OfxXmlCtx_new(uint32_t flags, AB_IMEXPORTER_CONTEXT *ioCon
   assert(xctx);
   GWEN_INHERIT_SETDATA(GWEN_XML_CONTEXT, AIO_OFX_XMLCTX, ctx, xctx,
                        AIO_OfxXmlCtx_FreeData);
+  xctx->imExporter=ie;
   xctx->ioContext=ioContext;
 
   /* set virtual functions */
@@ -189,6 +192,91 @@ AB_IMEXPORTER_CONTEXT *AIO_OfxXmlCtx_GetIoContext(const GWEN_XML_CONTEXT *ctx)
 
 
 
+AB_IMEXPORTER_ACCOUNTINFO *AIO_OfxXmlCtx_GetCurrentAccountInfo(const GWEN_XML_CONTEXT *ctx)
+{
+  AIO_OFX_XMLCTX *xctx;
+
+  assert(ctx);
+  xctx=GWEN_INHERIT_GETDATA(GWEN_XML_CONTEXT, AIO_OFX_XMLCTX, ctx);
+  assert(xctx);
+
+  return xctx->currentAccountInfo;
+}
+
+
+
+void AIO_OfxXmlCtx_SetCurrentAccountInfo(GWEN_XML_CONTEXT *ctx, AB_IMEXPORTER_ACCOUNTINFO *ai)
+{
+  AIO_OFX_XMLCTX *xctx;
+
+  assert(ctx);
+  xctx=GWEN_INHERIT_GETDATA(GWEN_XML_CONTEXT, AIO_OFX_XMLCTX, ctx);
+  assert(xctx);
+
+  xctx->currentAccountInfo=ai;
+}
+
+
+
+int AIO_OfxXmlCtx_IsStreaming(const GWEN_XML_CONTEXT *ctx)
+{
+  AIO_OFX_XMLCTX *xctx;
+
+  assert(ctx);
+  xctx=GWEN_INHERIT_GETDATA(GWEN_XML_CONTEXT, AIO_OFX_XMLCTX, ctx);
+  assert(xctx);
+
+  return (xctx->imExporter && AB_ImExporter_HasTransactionFn(xctx->imExporter))?1:0;
+}
+
+
+
+int AIO_OfxXmlCtx_DeliverTransaction(GWEN_XML_CONTEXT *ctx, AB_TRANSACTION *t)
+{
+  AIO_OFX_XMLCTX *xctx;
+  AB_IMEXPORTER_ACCOUNTINFO *ai;
+  const char *currency=NULL;
+  int rv;
+
+  assert(ctx);
+  xctx=GWEN_INHERIT_GETDATA(GWEN_XML_CONTEXT, AIO_OFX_XMLCTX, ctx);
+  assert(xctx);
+  assert(xctx->imExporter);
+
+  ai=xctx->currentAccountInfo;
+  if (ai)
+    currency=AB_ImExporterAccountInfo_GetCurrency(ai);
+
+  /* set currency if missing */
+  if (currency) {
+    const AB_VALUE *v;
+
+    v=AB_Transaction_GetValue(t);
+    if (v && AB_Value_GetCurrency(v)==NULL) {
+      AB_VALUE *v2;
+
+      v2=AB_Value_dup(v);
+      AB_Value_SetCurrency(v2, currency);
+      AB_Transaction_SetValue(t, v2);
+      AB_Value_free(v2);
+    }
+  }
+
+  /* hand over transaction, it is released afterwards */
+  rv=AB_ImExporter_DeliverTransaction(xctx->imExporter, ai, t);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    /* stop reading at the end of the current group */
+    xctx->abortCode=rv;
+    return rv;
+  }
+
+  return 0;
+}
+
+
+
+
 AIO_OFX_GROUP *AIO_OfxXmlCtx_GetCurrentGroup(const GWEN_XML_CONTEXT *ctx)
 {
   AIO_OFX_XMLCTX *xctx;
@@ -443,6 +531,11 @@ int AIO_OfxXmlCtx_EndTag(GWEN_XML_CONTEXT *ctx, int closing)
         }
         AIO_OfxGroup_free(g);
         GWEN_XmlCtx_DecDepth(ctx);
+
+        if (xctx->abortCode<0) {
+          DBG_INFO(AQBANKING_LOGDOMAIN, "Import aborted by transaction callback (%d)", xctx->abortCode);
+          return xctx->abortCode;
+        }
       }
 
       if (endingOfxDoc) {
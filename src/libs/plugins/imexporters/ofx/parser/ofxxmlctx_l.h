@@ -20,7 +20,7 @@
 
 
 
-GWEN_XML_CONTEXT *AIO_OfxXmlCtx_new(uint32_t flags, AB_IMEXPORTER_CONTEXT *ioContext);
+GWEN_XML_CONTEXT *AIO_OfxXmlCtx_new(uint32_t flags, AB_IMEXPORTER *ie, AB_IMEXPORTER_CONTEXT *ioContext);
 
 const char *AIO_OfxXmlCtx_GetCharset(const GWEN_XML_CONTEXT *ctx);
 void AIO_OfxXmlCtx_SetCharset(GWEN_XML_CONTEXT *ctx, const char *s);
@@ -34,6 +34,26 @@ void AIO_OfxXmlCtx_SetResultSeverity(GWEN_XML_CONTEXT *ctx, const char *s);
 
 AB_IMEXPORTER_CONTEXT *AIO_OfxXmlCtx_GetIoContext(const GWEN_XML_CONTEXT *ctx);
 
+/**
+ * Account info of the statement currently read (set by STMTRS/INVSTMTRS once the account is known).
+ */
+AB_IMEXPORTER_ACCOUNTINFO *AIO_OfxXmlCtx_GetCurrentAccountInfo(const GWEN_XML_CONTEXT *ctx);
+void AIO_OfxXmlCtx_SetCurrentAccountInfo(GWEN_XML_CONTEXT *ctx, AB_IMEXPORTER_ACCOUNTINFO *ai);
+
+/**
+ * Returns 1 if the caller of the import wants transactions handed over as soon as they are complete
+ * (see @ref AIO_OfxXmlCtx_DeliverTransaction), 0 if they are to be collected in the account infos.
+ */
+int AIO_OfxXmlCtx_IsStreaming(const GWEN_XML_CONTEXT *ctx);
+
+/**
+ * Hand a completed transaction to the transaction callback of the caller and release it.
+ * A missing currency is taken from the current account info. If the callback returns an error
+ * the import is aborted after the current group.
+ * Takes over the transaction.
+ */
+int AIO_OfxXmlCtx_DeliverTransaction(GWEN_XML_CONTEXT *ctx, AB_TRANSACTION *t);
+
 AIO_OFX_GROUP *AIO_OfxXmlCtx_GetCurrentGroup(const GWEN_XML_CONTEXT *ctx);
 
 void AIO_OfxXmlCtx_SetCurrentGroup(GWEN_XML_CONTEXT *ctx, AIO_OFX_GROUP *g);
@@ -24,8 +24,14 @@ struct AIO_OFX_XMLCTX {
   int resultCode;
   char *resultSeverity;
 
+  AB_IMEXPORTER *imExporter;
   AB_IMEXPORTER_CONTEXT *ioContext;
 
+  /* account info of the statement currently read (not owned) */
+  AB_IMEXPORTER_ACCOUNTINFO *currentAccountInfo;
+  /* error returned by the transaction callback */
+  int abortCode;
+
   AIO_OFX_GROUP *currentGroup;
   char *currentTagName;
 
@@ -27,14 +27,47 @@
 
 #include <ctype.h>
 
-#define YEAR_2000_CUTOFF 80
-
 
 
 GWEN_INHERIT(AB_IMEXPORTER, AH_IMEXPORTER_Q43);
 
 
 
+/* record layouts, the order of the fields must match the AH_Q43_IDX_* definitions in q43_p.h */
+
+static const AB_FIXEDRECORD_FIELDDEF q43_recFileHeader[]= {
+  {"date",            6,  6, 0, AB_FixedRecordTarget_None},
+  {NULL,              0,  0, 0, AB_FixedRecordTarget_None}
+};
+
+static const AB_FIXEDRECORD_FIELDDEF q43_recAccountHeader[]= {
+  {"bankCode",        2,  8, 0, AB_FixedRecordTarget_None},
+  {"accountNumber",  10, 10, 0, AB_FixedRecordTarget_None},
+  {"currency",       47,  3, 0, AB_FixedRecordTarget_None},
+  {NULL,              0,  0, 0, AB_FixedRecordTarget_None}
+};
+
+static const AB_FIXEDRECORD_FIELDDEF q43_recTransaction[]= {
+  {"date",           10,  6, 0, AB_FixedRecordTarget_Date},
+  {"valutaDate",     16,  6, 0, AB_FixedRecordTarget_ValutaDate},
+  {"sign",           27,  1, 0, AB_FixedRecordTarget_None},
+  {"amount",         28, 14, AB_FIXEDRECORD_FIELD_FLAGS_STRIPZEROES, AB_FixedRecordTarget_Value},
+  {NULL,              0,  0, 0, AB_FixedRecordTarget_None}
+};
+
+static const AB_FIXEDRECORD_FIELDDEF q43_recComment[]= {
+  {"comment1",        4, 38, AB_FIXEDRECORD_FIELD_FLAGS_CONDENSE, AB_FixedRecordTarget_Purpose},
+  {"comment2",       42, 38, AB_FIXEDRECORD_FIELD_FLAGS_CONDENSE, AB_FixedRecordTarget_Purpose},
+  {NULL,              0,  0, 0, AB_FixedRecordTarget_None}
+};
+
+static const AB_FIXEDRECORD_FIELDDEF q43_recFileEnd[]= {
+  {"numberOfRecords", 20, 6, 0, AB_FixedRecordTarget_None},
+  {NULL,              0,  0, 0, AB_FixedRecordTarget_None}
+};
+
+
+
 AB_IMEXPORTER *AB_ImExporterQ43_new(AB_BANKING *ab)
 {
   AB_IMEXPORTER *ie;
@@ -45,6 +78,18 @@ AB_IMEXPORTER *AB_ImExporterQ43_new(AB_BANKING *ab)
   GWEN_INHERIT_SETDATA(AB_IMEXPORTER, AH_IMEXPORTER_Q43, ie, ieh,
                        AH_ImExporterQ43_FreeData);
 
+  ieh->layoutFileHeader=AB_FixedRecordLayout_fromFieldDefs("00", q43_recFileHeader);
+  ieh->layoutAccountHeader=AB_FixedRecordLayout_fromFieldDefs("11", q43_recAccountHeader);
+  ieh->layoutTransaction=AB_FixedRecordLayout_fromFieldDefs("22", q43_recTransaction);
+  ieh->layoutComment=AB_FixedRecordLayout_fromFieldDefs("23", q43_recComment);
+  ieh->layoutFileEnd=AB_FixedRecordLayout_fromFieldDefs("88", q43_recFileEnd);
+  if (ieh->layoutFileHeader==NULL || ieh->layoutAccountHeader==NULL || ieh->layoutTransaction==NULL ||
+      ieh->layoutComment==NULL || ieh->layoutFileEnd==NULL) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Invalid record layouts");
+    AB_ImExporter_free(ie);
+    return NULL;
+  }
+
   AB_ImExporter_SetImportFn(ie, AH_ImExporterQ43_Import);
   AB_ImExporter_SetExportFn(ie, AH_ImExporterQ43_Export);
   AB_ImExporter_SetCheckFileFn(ie, AH_ImExporterQ43_CheckFile);
@@ -58,6 +103,11 @@ void GWENHYWFAR_CB AH_ImExporterQ43_FreeData(void *bp, void *p)
   AH_IMEXPORTER_Q43 *ieh;
 
   ieh=(AH_IMEXPORTER_Q43 *)p;
+  AB_FixedRecordLayout_free(ieh->layoutFileEnd);
+  AB_FixedRecordLayout_free(ieh->layoutComment);
+  AB_FixedRecordLayout_free(ieh->layoutTransaction);
+  AB_FixedRecordLayout_free(ieh->layoutAccountHeader);
+  AB_FixedRecordLayout_free(ieh->layoutFileHeader);
   GWEN_FREE_OBJECT(ieh);
 }
 
@@ -79,33 +129,13 @@ const char *AH_ImExporterQ43_GetCurrencyCode(int code)
 
 
 
-int AH_ImExporterQ43_ReadInt(const char *p, int len)
-{
-  int res=0;
-  int i;
-
-  for (i=0; i<len; i++) {
-    char c;
-
-    c=*(p++);
-    if (!isdigit(c))
-      return res;
-    res*=10;
-    res+=c-'0';
-  }
-
-  return res;
-}
-
-
-
 int AH_ImExporterQ43_ReadDocument(AB_IMEXPORTER *ie,
                                   AB_IMEXPORTER_CONTEXT *ctx,
                                   GWEN_FAST_BUFFER *fb,
                                   GWEN_DB_NODE *params)
 {
+  AH_IMEXPORTER_Q43 *ieh;
   AB_IMEXPORTER_ACCOUNTINFO *iea=NULL;
-  AB_IMEXPORTER_ACCOUNTINFO_LIST *ieaList;
   AB_TRANSACTION *t=NULL;
   GWEN_DATE *date=NULL;
   GWEN_BUFFER *lbuf;
@@ -114,8 +144,9 @@ int AH_ImExporterQ43_ReadDocument(AB_IMEXPORTER *ie,
   int hadSome=0;
   int records=0;
 
-  ieaList=AB_ImExporterContext_GetAccountInfoList(ctx);
-  assert(ieaList);
+  assert(ie);
+  ieh=GWEN_INHERIT_GETDATA(AB_IMEXPORTER, AH_IMEXPORTER_Q43, ie);
+  assert(ieh);
 
   lbuf=GWEN_Buffer_new(0, 256, 0, 1);
 
@@ -123,83 +154,55 @@ int AH_ImExporterQ43_ReadDocument(AB_IMEXPORTER *ie,
     rv=GWEN_FastBuffer_ReadLineToBuffer(fb, lbuf);
     if (rv==0) {
       int code;
-      char *p;
+      const char *p;
       int size;
 
       size=GWEN_Buffer_GetUsedBytes(lbuf);
-      if (size<2) {
+      p=GWEN_Buffer_GetStart(lbuf);
+      if (size<2 || !isdigit(p[0]) || !isdigit(p[1])) {
         DBG_ERROR(AQBANKING_LOGDOMAIN,
-                  "Line too short (%d bytes)",
-                  GWEN_Buffer_GetUsedBytes(lbuf));
-        AB_Transaction_free(t);
-        GWEN_Date_free(date);
-        GWEN_Buffer_free(lbuf);
-        return GWEN_ERROR_BAD_DATA;
+                  "Line too short or without record code (%d bytes)", size);
+        rv=GWEN_ERROR_BAD_DATA;
+        break;
       }
-      p=GWEN_Buffer_GetStart(lbuf);
       code=((p[0]-'0')*10)+(p[1]-'0');
       DBG_INFO(AQBANKING_LOGDOMAIN, "Got record %02d", code);
 
       switch (code) {
-      case 0: { /* file header */
-        int y, m, d;
-
-        if (size<12) {
-          DBG_ERROR(AQBANKING_LOGDOMAIN,
-                    "Record %02d too short (%d bytes)",
-                    code, GWEN_Buffer_GetUsedBytes(lbuf));
-          AB_Transaction_free(t);
-          GWEN_Date_free(date);
-          GWEN_Buffer_free(lbuf);
-          return GWEN_ERROR_BAD_DATA;
+      case 0: /* file header */
+        if (size<AB_FixedRecordLayout_GetRecordLength(ieh->layoutFileHeader)) {
+          DBG_ERROR(AQBANKING_LOGDOMAIN, "Record %02d too short (%d bytes)", code, size);
+          rv=GWEN_ERROR_BAD_DATA;
+          break;
         }
 
-        /* extract date */
-        y=((p[6] -'0')*10)+(p[7] -'0');
-        m=((p[8] -'0')*10)+(p[9] -'0');
-        d=((p[10]-'0')*10)+(p[11]-'0');
-        if (y>YEAR_2000_CUTOFF)
-          y+=1900;
-        else
-          y+=2000;
         GWEN_Date_free(date);
-        date=GWEN_Date_fromGregorian(y, m, d);
+        date=AB_FixedRecordLayout_GetDate(ieh->layoutFileHeader, AH_Q43_IDX_HEADER_DATE, p, size);
         if (date==NULL) {
           DBG_ERROR(AQBANKING_LOGDOMAIN, "Invalid date in record %02d", code);
-          AB_Transaction_free(t);
-          GWEN_Date_free(date);
-          GWEN_Buffer_free(lbuf);
-          return GWEN_ERROR_BAD_DATA;
+          rv=GWEN_ERROR_BAD_DATA;
         }
         break;
-      }
 
       case 11: { /* account header */
         char bankCode[9];
         char accountNumber[11];
-        int cy;
+        int cy=0;
 
-        if (size<80) {
-          DBG_ERROR(AQBANKING_LOGDOMAIN,
-                    "Record %02d too short (%d bytes)",
-                    code, GWEN_Buffer_GetUsedBytes(lbuf));
-          AB_Transaction_free(t);
-          GWEN_Date_free(date);
-          GWEN_Buffer_free(lbuf);
-          return GWEN_ERROR_BAD_DATA;
+        if (size<Q43_RECORD_SIZE) {
+          DBG_ERROR(AQBANKING_LOGDOMAIN, "Record %02d too short (%d bytes)", code, size);
+          rv=GWEN_ERROR_BAD_DATA;
+          break;
         }
 
-        /* get bankcode (combine bank code key and office branch code */
-        strncpy(bankCode, p+2, 8);
-        bankCode[8]=0;
-
-        /* get account number */
-        strncpy(accountNumber, p+10, 10);
-        accountNumber[10]=0;
+        /* get bankcode (combine bank code key and office branch code) and account number */
+        AB_FixedRecordLayout_GetString(ieh->layoutAccountHeader, AH_Q43_IDX_ACCOUNT_BANKCODE, p, size,
+                                       bankCode, sizeof(bankCode));
+        AB_FixedRecordLayout_GetString(ieh->layoutAccountHeader, AH_Q43_IDX_ACCOUNT_ACCOUNTNUMBER, p, size,
+                                       accountNumber, sizeof(accountNumber));
 
         /* get account info (or create it if necessary) */
-        iea=AB_ImExporterAccountInfo_List_GetByBankCodeAndAccountNumber(ieaList, bankCode, accountNumber,
-                                                                        AB_AccountType_Unknown);
+        iea=AB_ImExporterContext_FindAccountInfo(ctx, 0, NULL, bankCode, accountNumber, AB_AccountType_Unknown);
         if (iea==NULL) {
           iea=AB_ImExporterAccountInfo_new();
           AB_ImExporterAccountInfo_SetBankCode(iea, bankCode);
@@ -207,7 +210,7 @@ int AH_ImExporterQ43_ReadDocument(AB_IMEXPORTER *ie,
           AB_ImExporterContext_AddAccountInfo(ctx, iea);
         }
 
-        cy=((p[47]-'0')*100)+((p[48]-'0')*10)+(p[49]-'0');
+        AB_FixedRecordLayout_GetInt(ieh->layoutAccountHeader, AH_Q43_IDX_ACCOUNT_CURRENCY, p, size, &cy);
         currency=AH_ImExporterQ43_GetCurrencyCode(cy);
         if (!currency) {
           DBG_WARN(AQBANKING_LOGDOMAIN, "Unknown currency code %d, ignoring", cy);
@@ -218,90 +221,47 @@ int AH_ImExporterQ43_ReadDocument(AB_IMEXPORTER *ie,
         break;
       }
 
-      case 22: {
-        GWEN_DATE *da;
-        AB_VALUE *v;
-        int y, m, d;
-        char amount[32];
+      case 22: { /* transaction */
         const char *s;
+        char sign[2];
 
-        if (size<80) {
-          DBG_ERROR(AQBANKING_LOGDOMAIN,
-                    "Record %02d too short (%d bytes)",
-                    code, GWEN_Buffer_GetUsedBytes(lbuf));
-          AB_Transaction_free(t);
-          GWEN_Date_free(date);
-          GWEN_Buffer_free(lbuf);
-          return GWEN_ERROR_BAD_DATA;
+        if (size<Q43_RECORD_SIZE) {
+          DBG_ERROR(AQBANKING_LOGDOMAIN, "Record %02d too short (%d bytes)", code, size);
+          rv=GWEN_ERROR_BAD_DATA;
+          break;
         }
 
         if (iea==NULL) {
           DBG_ERROR(AQBANKING_LOGDOMAIN, "Bad order of records (22 before 11)");
-          AB_Transaction_free(t);
-          GWEN_Date_free(date);
-          GWEN_Buffer_free(lbuf);
-          return GWEN_ERROR_BAD_DATA;
+          rv=GWEN_ERROR_BAD_DATA;
+          break;
         }
 
         if (t)
           AB_ImExporterAccountInfo_AddTransaction(iea, t);
         t=AB_Transaction_new();
 
-        /* extract booking date */
-        y=((p[10]-'0')*10)+(p[11]-'0');
-        m=((p[12]-'0')*10)+(p[13]-'0');
-        d=((p[14]-'0')*10)+(p[15]-'0');
-        if (y>YEAR_2000_CUTOFF)
-          y+=1900;
-        else
-          y+=2000;
-        da=GWEN_Date_fromGregorian(y, m, d);
-        if (da==NULL) {
-          DBG_WARN(AQBANKING_LOGDOMAIN, "Invalid booking date in record %02d, ignoring", code);
-        }
-        else {
-          AB_Transaction_SetDate(t, da);
-          GWEN_Date_free(da);
+        /* booking date, valuta date and amount */
+        rv=AB_FixedRecordLayout_DecodeTransaction(ieh->layoutTransaction, p, size, currency, t);
+        if (rv<0) {
+          DBG_ERROR(AQBANKING_LOGDOMAIN, "Invalid transaction record (%d)", rv);
+          break;
         }
 
-        /* extract valuta date */
-        y=((p[16]-'0')*10)+(p[17]-'0');
-        m=((p[18]-'0')*10)+(p[18]-'0');
-        d=((p[19]-'0')*10)+(p[20]-'0');
-        if (y>YEAR_2000_CUTOFF)
-          y+=1900;
-        else
-          y+=2000;
-        da=GWEN_Date_fromGregorian(y, m, d);
-        if (da==NULL) {
-          DBG_WARN(AQBANKING_LOGDOMAIN, "Invalid valuta date in record %02d, ignoring", code);
-        }
-        else {
-          AB_Transaction_SetValutaDate(t, da);
-          GWEN_Date_free(da);
-        }
+        AB_FixedRecordLayout_GetString(ieh->layoutTransaction, AH_Q43_IDX_TRANSACTION_SIGN, p, size, sign, sizeof(sign));
+        if (*sign=='1') {
+          const AB_VALUE *pv;
 
-        /* get amount */
-        strncpy(amount, p+28, 14);
-        amount[14]=0;
-        strncat(amount, "/100:", sizeof(amount)-strlen(amount)-1);
-        if (currency)
-          strncat(amount, currency, sizeof(amount)-strlen(amount)-1);
-        amount[sizeof(amount)-1]=0;
-        v=AB_Value_fromString(amount);
-        if (v==NULL) {
-          DBG_ERROR(AQBANKING_LOGDOMAIN, "Invalid amount in transaction");
-          AB_Transaction_free(t);
-          GWEN_Date_free(date);
-          GWEN_Buffer_free(lbuf);
-          return GWEN_ERROR_BAD_DATA;
-        }
-        else {
-          if (p[27]=='1')
-            /* FIXME: Do we have to negate on "1" or "2"? */
+          /* FIXME: Do we have to negate on "1" or "2"? */
+          pv=AB_Transaction_GetValue(t);
+          if (pv) {
+            AB_VALUE *v;
+
+            v=AB_Value_dup(pv);
             AB_Value_Negate(v);
-          AB_Transaction_SetValue(t, v);
-          AB_Value_free(v);
+            AB_Transaction_SetValue(t, v);
+            AB_Value_free(v);
+          }
         }
 
         /* copy local account info */
@@ -312,45 +272,23 @@ int AH_ImExporterQ43_ReadDocument(AB_IMEXPORTER *ie,
         break;
       }
 
-      case 23: { /* transaction comments */
-        GWEN_BUFFER *tbuf;
-
-        if (size<80) {
-          DBG_ERROR(AQBANKING_LOGDOMAIN,
-                    "Record %02d too short (%d bytes)",
-                    code, GWEN_Buffer_GetUsedBytes(lbuf));
-          AB_Transaction_free(t);
-          GWEN_Date_free(date);
-          GWEN_Buffer_free(lbuf);
-          return GWEN_ERROR_BAD_DATA;
+      case 23: /* transaction comments */
+        if (size<Q43_RECORD_SIZE) {
+          DBG_ERROR(AQBANKING_LOGDOMAIN, "Record %02d too short (%d bytes)", code, size);
+          rv=GWEN_ERROR_BAD_DATA;
+          break;
         }
 
         if (t==NULL) {
           DBG_ERROR(AQBANKING_LOGDOMAIN, "Bad order of records (23 before 22)");
-          AB_Transaction_free(t);
-          GWEN_Date_free(date);
-          GWEN_Buffer_free(lbuf);
-          return GWEN_ERROR_BAD_DATA;
+          rv=GWEN_ERROR_BAD_DATA;
+          break;
         }
 
-        tbuf=GWEN_Buffer_new(0, 256, 0, 1);
-        /* comment 1 */
-        GWEN_Buffer_AppendBytes(tbuf, p+4, 38);
-        GWEN_Text_CondenseBuffer(tbuf);
-        if (GWEN_Buffer_GetUsedBytes(tbuf))
-          AB_Transaction_AddPurposeLine(t, GWEN_Buffer_GetStart(tbuf));
-        GWEN_Buffer_Reset(tbuf);
-
-        /* comment 2 */
-        GWEN_Buffer_AppendBytes(tbuf, p+42, 38);
-        GWEN_Text_CondenseBuffer(tbuf);
-        if (GWEN_Buffer_GetUsedBytes(tbuf))
-          AB_Transaction_AddPurposeLine(t, GWEN_Buffer_GetStart(tbuf));
-        GWEN_Buffer_free(tbuf);
+        rv=AB_FixedRecordLayout_DecodeTransaction(ieh->layoutComment, p, size, NULL, t);
         break;
-      }
 
-      case 33: { /* end of accunt record */
+      case 33: /* end of accunt record */
         /* store current transaction if any */
         if (t) {
           AB_ImExporterAccountInfo_AddTransaction(iea, t);
@@ -359,20 +297,16 @@ int AH_ImExporterQ43_ReadDocument(AB_IMEXPORTER *ie,
 
         // TODO: check the control fields here, read final account balance
         break;
-      }
 
       case 88: {
-        int numrecs;
+        int numrecs=0;
 
-        numrecs=AH_ImExporterQ43_ReadInt(p+20, 6);
+        AB_FixedRecordLayout_GetInt(ieh->layoutFileEnd, AH_Q43_IDX_END_NUMRECORDS, p, size, &numrecs);
         if (numrecs!=records) {
           DBG_ERROR(AQBANKING_LOGDOMAIN,
                     "Number of records doesn't match (%d != %d)",
                     numrecs, records);
-          AB_Transaction_free(t);
-          GWEN_Date_free(date);
-          GWEN_Buffer_free(lbuf);
-          return GWEN_ERROR_BAD_DATA;
+          rv=GWEN_ERROR_BAD_DATA;
         }
         break;
       }
@@ -381,6 +315,9 @@ int AH_ImExporterQ43_ReadDocument(AB_IMEXPORTER *ie,
         DBG_WARN(AQBANKING_LOGDOMAIN, "Ignoring line with code %02d", code);
       }
 
+      if (rv<0)
+        break;
+
       GWEN_Buffer_Reset(lbuf);
       if (code!=0)
         records++;
@@ -393,7 +330,9 @@ int AH_ImExporterQ43_ReadDocument(AB_IMEXPORTER *ie,
     rv=0;
 
   if (t) {
-    DBG_WARN(AQBANKING_LOGDOMAIN, "There is still a transaction open...");
+    if (rv==0) {
+      DBG_WARN(AQBANKING_LOGDOMAIN, "There is still a transaction open...");
+    }
     AB_Transaction_free(t);
   }
 
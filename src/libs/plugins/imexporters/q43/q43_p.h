@@ -15,18 +15,37 @@
 #include "q43.h"
 
 #include <aqbanking/backendsupport/imexporter_be.h>
+#include <aqbanking/backendsupport/fixedrecord.h>
+
+
+/* size of all records except the file header */
+#define Q43_RECORD_SIZE 80
+
+/* field indices in the record layouts (see tables in q43.c) */
+#define AH_Q43_IDX_HEADER_DATE            0
+
+#define AH_Q43_IDX_ACCOUNT_BANKCODE       0
+#define AH_Q43_IDX_ACCOUNT_ACCOUNTNUMBER  1
+#define AH_Q43_IDX_ACCOUNT_CURRENCY       2
+
+#define AH_Q43_IDX_TRANSACTION_SIGN       2
+
+#define AH_Q43_IDX_END_NUMRECORDS         0
 
 
 typedef struct AH_IMEXPORTER_Q43 AH_IMEXPORTER_Q43;
 struct AH_IMEXPORTER_Q43 {
-  int dummy;
+  AB_FIXEDRECORD_LAYOUT *layoutFileHeader;
+  AB_FIXEDRECORD_LAYOUT *layoutAccountHeader;
+  AB_FIXEDRECORD_LAYOUT *layoutTransaction;
+  AB_FIXEDRECORD_LAYOUT *layoutComment;
+  AB_FIXEDRECORD_LAYOUT *layoutFileEnd;
 };
 
 
 static void GWENHYWFAR_CB AH_ImExporterQ43_FreeData(void *bp, void *p);
 
 static const char *AH_ImExporterQ43_GetCurrencyCode(int code);
-static int AH_ImExporterQ43_ReadInt(const char *p, int len);
 
 static int AH_ImExporterQ43_ReadDocument(AB_IMEXPORTER *ie,
                                          AB_IMEXPORTER_CONTEXT *ctx,
@@ -106,21 +106,17 @@ int AH_ImExporterSEPA_Import(AB_IMEXPORTER *ie,
 
 
 
-static int AH_ImExporterSEPA_Export_Pain_Setup(AB_IMEXPORTER *ie,
-                                               AB_IMEXPORTER_CONTEXT *ctx,
-                                               GWEN_XMLNODE *painNode,
+static int AH_ImExporterSEPA_Export_Pain_Setup(AB_IMEXPORTER_CONTEXT *ctx,
                                                uint32_t doctype[],
-                                               AH_IMEXPORTER_SEPA_PMTINF_LIST **pList)
+                                               AH_IMEXPORTER_SEPA_PMTINF_LIST **pList,
+                                               int *pTransactionCount)
 {
-  GWEN_XMLNODE *n;
   AB_IMEXPORTER_ACCOUNTINFO *ai;
   AB_TRANSACTION *t;
   AH_IMEXPORTER_SEPA_PMTINF_LIST *pl;
   AH_IMEXPORTER_SEPA_PMTINF *pmtinf;
   int tcount=0;
-  AB_VALUE *v;
   GWEN_BUFFER *tbuf;
-  char *ctrlsum;
 
   ai=AB_ImExporterContext_GetFirstAccountInfo(ctx);
   if (ai==0) {
@@ -264,8 +260,7 @@ static int AH_ImExporterSEPA_Export_Pain_Setup(AB_IMEXPORTER *ie,
     t=AB_Transaction_List_Next(t);
   }
 
-  /* construct CtrlSum for PmtInf blocks and GrpHdr */
-  v=AB_Value_new();
+  /* construct CtrlSum for PmtInf blocks */
   tbuf=GWEN_Buffer_new(0, 64, 0, 1);
   pmtinf=AH_ImExporter_Sepa_PmtInf_List_First(pl);
   while (pmtinf) {
@@ -273,64 +268,11 @@ static int AH_ImExporterSEPA_Export_Pain_Setup(AB_IMEXPORTER *ie,
     pmtinf->ctrlsum=strdup(GWEN_Buffer_GetStart(tbuf));
     assert(pmtinf->ctrlsum);
     GWEN_Buffer_Reset(tbuf);
-    AB_Value_AddValue(v, pmtinf->value);
     pmtinf=AH_ImExporter_Sepa_PmtInf_List_Next(pmtinf);
   }
-
-  AB_Value_toHumanReadableString(v, tbuf, 2, 0);
-  ctrlsum=strdup(GWEN_Buffer_GetStart(tbuf));
-  assert(ctrlsum);
   GWEN_Buffer_free(tbuf);
-  AB_Value_free(v);
-
-  /* create GrpHdr */
-  n=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "GrpHdr");
-  if (n) {
-    GWEN_TIME *ti;
-    uint32_t uid;
-    char numbuf[32];
-    GWEN_XMLNODE *nn;
-
-    GWEN_XMLNode_AddChild(painNode, n);
-    ti=GWEN_CurrentTime();
-
-    tbuf=GWEN_Buffer_new(0, 64, 0, 1);
-
-    /* generate MsgId */
-    uid=AB_Banking_GetNamedUniqueId(AB_ImExporter_GetBanking(ie), "sepamsg", 1);
-    GWEN_Time_toUtcString(ti, "YYYYMMDD-hh:mm:ss-", tbuf);
-    snprintf(numbuf, sizeof(numbuf)-1, "%08x", uid);
-    GWEN_Buffer_AppendString(tbuf, numbuf);
-    GWEN_XMLNode_SetCharValue(n, "MsgId", GWEN_Buffer_GetStart(tbuf));
-    GWEN_Buffer_Reset(tbuf);
-
-    /* generate CreDtTm */
-    GWEN_Time_toUtcString(ti, "YYYY-MM-DDThh:mm:ssZ", tbuf);
-    GWEN_XMLNode_SetCharValue(n, "CreDtTm", GWEN_Buffer_GetStart(tbuf));
-    GWEN_Time_free(ti);
-    GWEN_Buffer_free(tbuf);
-
-    /* store NbOfTxs */
-    GWEN_XMLNode_SetIntValue(n, "NbOfTxs", tcount);
-#if 0
-    /* store CtrlSum */
-    GWEN_XMLNode_SetCharValue(n, "CtrlSum", ctrlsum);
-#endif
-
-    /* special treatment for pain.001.001.02 and pain.008.001.01 */
-    if (doctype[1]==1 && ((doctype[0]==1 && doctype[2]==2) ||
-                          (doctype[0]==8 && doctype[2]==1)))
-      GWEN_XMLNode_SetCharValue(n, "Grpg", "GRPD");
-
-    nn=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "InitgPty");
-    if (nn) {
-      GWEN_XMLNode_AddChild(n, nn);
-      pmtinf=AH_ImExporter_Sepa_PmtInf_List_First(pl);
-      AH_ImExporterSEPA_XmlSetCharValueEscaped(nn, "Nm", pmtinf->localName);
-    }
-  }
-  free(ctrlsum);
 
+  *pTransactionCount=tcount;
   *pList=pl;
   return 0;
 }
@@ -343,12 +285,15 @@ int AH_ImExporterSEPA_Export(AB_IMEXPORTER *ie,
                              GWEN_DB_NODE *params)
 {
   AH_IMEXPORTER_SEPA *ieh;
-  GWEN_XMLNODE *root;
-  GWEN_XMLNODE *documentNode;
-  GWEN_XMLNODE *topNode;
-  GWEN_XMLNODE *n;
   uint32_t doctype[]= {0, 0, 0};
+  AH_IMEXPORTER_SEPA_PMTINF_LIST *pl=NULL;
+  AH_IMEXPORTER_SEPA_CHECK_FN checkFn;
+  AH_IMEXPORTER_SEPA_WRITE_FN writeFn;
+  GWEN_BUFFER *buf;
+  const char *xmlns;
+  const char *topName;
   const char *s;
+  int tcount=0;
   int rv;
 
   assert(ie);
@@ -378,114 +323,309 @@ int AH_ImExporterSEPA_Export(AB_IMEXPORTER *ie,
       doctype[0]=0;
   }
 
-  root=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "root");
-  n=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "?xml");
-  if (n) {
-    GWEN_XMLNode_AddHeader(root, n);
-    GWEN_XMLNode_SetProperty(n, "version", "1.0");
-    GWEN_XMLNode_SetProperty(n, "encoding", "UTF-8");
-  }
-
-  documentNode=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "Document");
-  s=GWEN_DB_GetCharValue(params, "xmlns", 0, 0);
-  if (!s || !*s) {
+  xmlns=GWEN_DB_GetCharValue(params, "xmlns", 0, 0);
+  if (!xmlns || !*xmlns) {
     DBG_ERROR(AQBANKING_LOGDOMAIN,
               "xmlns not specified in profile \"%s\"",
               GWEN_DB_GetCharValue(params, "name", 0, 0));
-    GWEN_XMLNode_free(root);
     return GWEN_ERROR_INVALID;
   }
-  GWEN_XMLNode_SetProperty(documentNode, "xmlns", s);
-  GWEN_XMLNode_AddChild(root, documentNode);
 
   switch (doctype[0]) {
   case 1:
     if (doctype[1]>1 || doctype[2]>2)
-      s="CstmrCdtTrfInitn";
+      topName="CstmrCdtTrfInitn";
     else
-      s=strstr(s, "pain");
-    topNode=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, s);
-    GWEN_XMLNode_AddChild(documentNode, topNode);
-    rv=AH_ImExporterSEPA_Export_Pain_001(ie, ctx, topNode, doctype, params);
+      topName=strstr(xmlns, "pain");
+    checkFn=AH_ImExporterSEPA_Export_Pain_001_Check;
+    writeFn=AH_ImExporterSEPA_Export_Pain_001_Write;
     break;
   case 8:
     if (!(doctype[1]==1 && doctype[2]==1))
-      s="CstmrDrctDbtInitn";
+      topName="CstmrDrctDbtInitn";
     else
-      s=strstr(s, "pain");
-    topNode=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, s);
-    GWEN_XMLNode_AddChild(documentNode, topNode);
-    rv=AH_ImExporterSEPA_Export_Pain_008(ie, ctx, topNode, doctype, params);
+      topName=strstr(xmlns, "pain");
+    checkFn=AH_ImExporterSEPA_Export_Pain_008_Check;
+    writeFn=AH_ImExporterSEPA_Export_Pain_008_Write;
     break;
   default:
     DBG_ERROR(AQBANKING_LOGDOMAIN, "Unknown SEPA type \"%s\"",
               GWEN_DB_GetCharValue(params, "type", 0, 0));
-    GWEN_XMLNode_free(root);
     return GWEN_ERROR_INVALID;
   }
 
-  if (rv==0) {
-    GWEN_XML_CONTEXT *xmlctx;
+  if (topName==NULL) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Invalid xmlns \"%s\" for SEPA type \"%s\"",
+              xmlns, GWEN_DB_GetCharValue(params, "type", 0, 0));
+    return GWEN_ERROR_INVALID;
+  }
 
-    xmlctx=GWEN_XmlCtxStore_new(root,
-                                GWEN_XML_FLAGS_INDENT |
-                                GWEN_XML_FLAGS_SIMPLE |
-                                GWEN_XML_FLAGS_HANDLE_HEADERS);
+  rv=AH_ImExporterSEPA_Export_Pain_Setup(ctx, doctype, &pl, &tcount);
+  if (rv) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
 
-    rv=GWEN_XMLNode_WriteToStream(root, xmlctx, sio);
-    if (rv) {
-      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
-    }
-    GWEN_XmlCtx_free(xmlctx);
-    GWEN_XMLNode_free(root);
+  /* check everything before writing, so errors don't leave a partial document behind */
+  rv=checkFn(pl, doctype, params);
+  if (rv) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    AH_ImExporter_Sepa_PmtInf_List_free(pl);
+    return rv;
   }
 
-  /* TODO */
+  /* write the document directly, the buffer is flushed to the sink whenever it gets big enough */
+  buf=GWEN_Buffer_new(0, AH_IMEXPORTER_SEPA_FLUSH_SIZE+1024, 0, 1);
+  rv=AH_ImExporterSEPA_Export_WriteDocumentStart(ie, pl, doctype, params, xmlns, topName, tcount, buf);
+  if (rv==0)
+    rv=writeFn(ie, pl, doctype, params, buf, sio);
+  if (rv==0) {
+    AH_ImExporterSEPA_Export_WriteDocumentEnd(topName, buf);
+    rv=AH_ImExporterSEPA_Xml_Flush(buf, sio, 1);
+  }
+  if (rv) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+  }
+  GWEN_Buffer_free(buf);
+  AH_ImExporter_Sepa_PmtInf_List_free(pl);
+
   return rv;
 }
 
 
 
-int AH_ImExporterSEPA_CheckFile(AB_IMEXPORTER *ie, const char *fname)
+int AH_ImExporterSEPA_Export_WriteDocumentStart(AB_IMEXPORTER *ie,
+                                                AH_IMEXPORTER_SEPA_PMTINF_LIST *pl,
+                                                uint32_t doctype[],
+                                                GWEN_DB_NODE *params,
+                                                const char *xmlns,
+                                                const char *topName,
+                                                int tcount,
+                                                GWEN_BUFFER *buf)
 {
-  AH_IMEXPORTER_SEPA *ieh;
+  GWEN_TIME *ti;
+  GWEN_BUFFER *tbuf;
+  int rv;
 
-  assert(ie);
-  ieh=GWEN_INHERIT_GETDATA(AB_IMEXPORTER, AH_IMEXPORTER_SEPA, ie);
-  assert(ieh);
+  GWEN_Buffer_AppendString(buf, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+  GWEN_Buffer_AppendString(buf, "<Document xmlns=\"");
+  GWEN_Buffer_AppendString(buf, xmlns);
+  GWEN_Buffer_AppendString(buf, "\">\n");
+  AH_ImExporterSEPA_Xml_OpenTag(buf, 1, topName);
 
-#if 0
-  return AB_ERROR_INDIFFERENT;
-#else
-  /* TODO */
-  return GWEN_ERROR_NOT_IMPLEMENTED;
-#endif
+  /* create GrpHdr */
+  AH_ImExporterSEPA_Xml_OpenTag(buf, 2, "GrpHdr");
+  ti=GWEN_CurrentTime();
+
+  /* generate MsgId */
+  AH_ImExporterSEPA_Export_AddMessageId(ie, params, ti, 3, "MsgId", buf);
+
+  /* generate CreDtTm */
+  tbuf=GWEN_Buffer_new(0, 64, 0, 1);
+  GWEN_Time_toUtcString(ti, "YYYY-MM-DDThh:mm:ssZ", tbuf);
+  AH_ImExporterSEPA_Xml_AddElement(buf, 3, "CreDtTm", GWEN_Buffer_GetStart(tbuf));
+  GWEN_Buffer_free(tbuf);
+  GWEN_Time_free(ti);
+
+  /* store NbOfTxs */
+  AH_ImExporterSEPA_Xml_AddIntElement(buf, 3, "NbOfTxs", tcount);
+
+  /* special treatment for pain.001.001.02 and pain.008.001.01 */
+  if (doctype[1]==1 && ((doctype[0]==1 && doctype[2]==2) ||
+                        (doctype[0]==8 && doctype[2]==1)))
+    AH_ImExporterSEPA_Xml_AddElement(buf, 3, "Grpg", "GRPD");
+
+  AH_ImExporterSEPA_Xml_OpenTag(buf, 3, "InitgPty");
+  rv=AH_ImExporterSEPA_Xml_AddElementEscaped(buf, 4, "Nm", AH_ImExporter_Sepa_PmtInf_List_First(pl)->localName);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+  AH_ImExporterSEPA_Xml_CloseTag(buf, 3, "InitgPty");
+
+  AH_ImExporterSEPA_Xml_CloseTag(buf, 2, "GrpHdr");
+  return 0;
 }
 
 
 
-int AH_ImExporterSEPA_XmlSetCharValueEscaped(GWEN_XMLNODE *n, const char *varName, const char *value)
+void AH_ImExporterSEPA_Export_WriteDocumentEnd(const char *topName, GWEN_BUFFER *buf)
+{
+  AH_ImExporterSEPA_Xml_CloseTag(buf, 1, topName);
+  GWEN_Buffer_AppendString(buf, "</Document>\n");
+}
+
+
+
+/* used for MsgId and PmtInfId */
+void AH_ImExporterSEPA_Export_AddMessageId(AB_IMEXPORTER *ie,
+                                           GWEN_DB_NODE *params,
+                                           const GWEN_TIME *ti,
+                                           int depth,
+                                           const char *name,
+                                           GWEN_BUFFER *buf)
+{
+  GWEN_BUFFER *tbuf;
+  uint32_t uid;
+  char numbuf[32];
+
+  tbuf=GWEN_Buffer_new(0, 64, 0, 1);
+  uid=AB_ImExporter_GetNextSepaMessageId(ie, params);
+  GWEN_Time_toUtcString(ti, "YYYYMMDD-hh:mm:ss-", tbuf);
+  snprintf(numbuf, sizeof(numbuf)-1, "%08x", uid);
+  GWEN_Buffer_AppendString(tbuf, numbuf);
+  AH_ImExporterSEPA_Xml_AddElement(buf, depth, name, GWEN_Buffer_GetStart(tbuf));
+  GWEN_Buffer_free(tbuf);
+}
+
+
+
+void AH_ImExporterSEPA_Xml_OpenTag(GWEN_BUFFER *buf, int depth, const char *name)
+{
+  GWEN_Buffer_FillWithBytes(buf, ' ', depth*2);
+  GWEN_Buffer_AppendByte(buf, '<');
+  GWEN_Buffer_AppendString(buf, name);
+  GWEN_Buffer_AppendString(buf, ">\n");
+}
+
+
+
+void AH_ImExporterSEPA_Xml_CloseTag(GWEN_BUFFER *buf, int depth, const char *name)
+{
+  GWEN_Buffer_FillWithBytes(buf, ' ', depth*2);
+  GWEN_Buffer_AppendString(buf, "</");
+  GWEN_Buffer_AppendString(buf, name);
+  GWEN_Buffer_AppendString(buf, ">\n");
+}
+
+
+
+/* value is written as is */
+void AH_ImExporterSEPA_Xml_AddElement(GWEN_BUFFER *buf, int depth, const char *name, const char *value)
+{
+  GWEN_Buffer_FillWithBytes(buf, ' ', depth*2);
+  GWEN_Buffer_AppendByte(buf, '<');
+  GWEN_Buffer_AppendString(buf, name);
+  GWEN_Buffer_AppendByte(buf, '>');
+  GWEN_Buffer_AppendString(buf, value);
+  GWEN_Buffer_AppendString(buf, "</");
+  GWEN_Buffer_AppendString(buf, name);
+  GWEN_Buffer_AppendString(buf, ">\n");
+}
+
+
+
+/* value is XML-escaped, empty values are skipped */
+int AH_ImExporterSEPA_Xml_AddElementEscaped(GWEN_BUFFER *buf, int depth, const char *name, const char *value)
 {
   if (value && *value) {
-    GWEN_BUFFER *dbuf;
     int rv;
 
-    dbuf=GWEN_Buffer_new(0, 256, 0, 1);
-    rv=GWEN_Text_EscapeXmlToBuffer(value, dbuf);
+    GWEN_Buffer_FillWithBytes(buf, ' ', depth*2);
+    GWEN_Buffer_AppendByte(buf, '<');
+    GWEN_Buffer_AppendString(buf, name);
+    GWEN_Buffer_AppendByte(buf, '>');
+    rv=GWEN_Text_EscapeXmlToBuffer(value, buf);
     if (rv<0) {
       DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
-      GWEN_Buffer_free(dbuf);
       return rv;
     }
+    GWEN_Buffer_AppendString(buf, "</");
+    GWEN_Buffer_AppendString(buf, name);
+    GWEN_Buffer_AppendString(buf, ">\n");
+  }
+  return 0;
+}
+
+
+
+void AH_ImExporterSEPA_Xml_AddIntElement(GWEN_BUFFER *buf, int depth, const char *name, int value)
+{
+  char numbuf[32];
+
+  snprintf(numbuf, sizeof(numbuf)-1, "%d", value);
+  numbuf[sizeof(numbuf)-1]=0;
+  AH_ImExporterSEPA_Xml_AddElement(buf, depth, name, numbuf);
+}
+
+
+
+int AH_ImExporterSEPA_Xml_AddDateElement(GWEN_BUFFER *buf, int depth, const char *name, const GWEN_DATE *dt)
+{
+  GWEN_BUFFER *tbuf;
+  int rv;
+
+  tbuf=GWEN_Buffer_new(0, 32, 0, 1);
+  rv=GWEN_Date_toStringWithTemplate(dt, "YYYY-MM-DD", tbuf);
+  if (rv<0) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Error converting date to string");
+    GWEN_Buffer_free(tbuf);
+    return rv;
+  }
+  rv=AH_ImExporterSEPA_Xml_AddElementEscaped(buf, depth, name, GWEN_Buffer_GetStart(tbuf));
+  GWEN_Buffer_free(tbuf);
+  return rv;
+}
+
+
+
+void AH_ImExporterSEPA_Xml_AddAmount(GWEN_BUFFER *buf, int depth, const char *name, const AB_VALUE *v)
+{
+  const char *s;
+
+  s=AB_Value_GetCurrency(v);
+  if (!s)
+    s="EUR";
+  GWEN_Buffer_FillWithBytes(buf, ' ', depth*2);
+  GWEN_Buffer_AppendByte(buf, '<');
+  GWEN_Buffer_AppendString(buf, name);
+  GWEN_Buffer_AppendString(buf, " Ccy=\"");
+  GWEN_Buffer_AppendString(buf, s);
+  GWEN_Buffer_AppendString(buf, "\">");
+  AB_Value_toHumanReadableString(v, buf, 2, 0);
+  GWEN_Buffer_AppendString(buf, "</");
+  GWEN_Buffer_AppendString(buf, name);
+  GWEN_Buffer_AppendString(buf, ">\n");
+}
+
 
-    GWEN_XMLNode_SetCharValue(n, varName, GWEN_Buffer_GetStart(dbuf));
-    GWEN_Buffer_free(dbuf);
+
+/* write buffered data to the sink (if forced or if enough data has been collected) */
+int AH_ImExporterSEPA_Xml_Flush(GWEN_BUFFER *buf, GWEN_SYNCIO *sio, int force)
+{
+  uint32_t len;
+
+  len=GWEN_Buffer_GetUsedBytes(buf);
+  if (len && (force || len>=AH_IMEXPORTER_SEPA_FLUSH_SIZE)) {
+    int rv;
+
+    rv=GWEN_SyncIo_WriteForced(sio, (const uint8_t *) GWEN_Buffer_GetStart(buf), len);
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      return rv;
+    }
+    GWEN_Buffer_Reset(buf);
   }
   return 0;
 }
 
 
 
+int AH_ImExporterSEPA_CheckFile(AB_IMEXPORTER *ie, const char *fname)
+{
+  AH_IMEXPORTER_SEPA *ieh;
+
+  assert(ie);
+  ieh=GWEN_INHERIT_GETDATA(AB_IMEXPORTER, AH_IMEXPORTER_SEPA, ie);
+  assert(ieh);
+
+#if 0
+  return AB_ERROR_INDIFFERENT;
+#else
+  /* TODO */
+  return GWEN_ERROR_NOT_IMPLEMENTED;
+#endif
+}
 
 
 
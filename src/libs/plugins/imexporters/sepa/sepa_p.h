@@ -59,20 +59,78 @@ static int AH_ImExporterSEPA_Export(AB_IMEXPORTER *ie,
 static int AH_ImExporterSEPA_CheckFile(AB_IMEXPORTER *ie, const char *fname);
 
 
-static int AH_ImExporterSEPA_XmlSetCharValueEscaped(GWEN_XMLNODE *n, const char *varName, const char *value);
-
-
-static int AH_ImExporterSEPA_Export_Pain_001(AB_IMEXPORTER *ie,
-                                             AB_IMEXPORTER_CONTEXT *ctx,
-                                             GWEN_XMLNODE *painNode,
-                                             uint32_t doctype[],
-                                             GWEN_DB_NODE *params);
-
-static int AH_ImExporterSEPA_Export_Pain_008(AB_IMEXPORTER *ie,
-                                             AB_IMEXPORTER_CONTEXT *ctx,
-                                             GWEN_XMLNODE *painNode,
-                                             uint32_t doctype[],
-                                             GWEN_DB_NODE *params);
+/* the document is written to the sink whenever this many bytes have been collected */
+#define AH_IMEXPORTER_SEPA_FLUSH_SIZE 16384
+
+
+/* check all PmtInf blocks and their transactions without writing anything */
+typedef int (*AH_IMEXPORTER_SEPA_CHECK_FN)(AH_IMEXPORTER_SEPA_PMTINF_LIST *pl,
+                                           uint32_t doctype[],
+                                           GWEN_DB_NODE *params);
+
+/* write all PmtInf blocks including their transactions */
+typedef int (*AH_IMEXPORTER_SEPA_WRITE_FN)(AB_IMEXPORTER *ie,
+                                           AH_IMEXPORTER_SEPA_PMTINF_LIST *pl,
+                                           uint32_t doctype[],
+                                           GWEN_DB_NODE *params,
+                                           GWEN_BUFFER *buf,
+                                           GWEN_SYNCIO *sio);
+
+
+static int AH_ImExporterSEPA_Export_WriteDocumentStart(AB_IMEXPORTER *ie,
+                                                       AH_IMEXPORTER_SEPA_PMTINF_LIST *pl,
+                                                       uint32_t doctype[],
+                                                       GWEN_DB_NODE *params,
+                                                       const char *xmlns,
+                                                       const char *topName,
+                                                       int tcount,
+                                                       GWEN_BUFFER *buf);
+static void AH_ImExporterSEPA_Export_WriteDocumentEnd(const char *topName, GWEN_BUFFER *buf);
+static void AH_ImExporterSEPA_Export_AddMessageId(AB_IMEXPORTER *ie,
+                                                  GWEN_DB_NODE *params,
+                                                  const GWEN_TIME *ti,
+                                                  int depth,
+                                                  const char *name,
+                                                  GWEN_BUFFER *buf);
+
+static int AH_ImExporterSEPA_Export_Pain_001_Check(AH_IMEXPORTER_SEPA_PMTINF_LIST *pl,
+                                                   uint32_t doctype[],
+                                                   GWEN_DB_NODE *params);
+static int AH_ImExporterSEPA_Export_Pain_001_CheckTransaction(const AB_TRANSACTION *t, uint32_t doctype[]);
+static int AH_ImExporterSEPA_Export_Pain_001_Write(AB_IMEXPORTER *ie,
+                                                   AH_IMEXPORTER_SEPA_PMTINF_LIST *pl,
+                                                   uint32_t doctype[],
+                                                   GWEN_DB_NODE *params,
+                                                   GWEN_BUFFER *buf,
+                                                   GWEN_SYNCIO *sio);
+static int AH_ImExporterSEPA_Export_Pain_001_WriteTransaction(const AB_TRANSACTION *t,
+                                                              uint32_t doctype[],
+                                                              GWEN_BUFFER *buf);
+
+static int AH_ImExporterSEPA_Export_Pain_008_Check(AH_IMEXPORTER_SEPA_PMTINF_LIST *pl,
+                                                   uint32_t doctype[],
+                                                   GWEN_DB_NODE *params);
+static int AH_ImExporterSEPA_Export_Pain_008_CheckTransaction(const AB_TRANSACTION *t, uint32_t doctype[]);
+static int AH_ImExporterSEPA_Export_Pain_008_Write(AB_IMEXPORTER *ie,
+                                                   AH_IMEXPORTER_SEPA_PMTINF_LIST *pl,
+                                                   uint32_t doctype[],
+                                                   GWEN_DB_NODE *params,
+                                                   GWEN_BUFFER *buf,
+                                                   GWEN_SYNCIO *sio);
+static int AH_ImExporterSEPA_Export_Pain_008_WriteTransaction(const AB_TRANSACTION *t,
+                                                              const AH_IMEXPORTER_SEPA_PMTINF *pmtinf,
+                                                              uint32_t doctype[],
+                                                              GWEN_BUFFER *buf);
+
+/* helpers writing XML in the format of GWEN_XmlCtxStore with GWEN_XML_FLAGS_INDENT|GWEN_XML_FLAGS_SIMPLE */
+static void AH_ImExporterSEPA_Xml_OpenTag(GWEN_BUFFER *buf, int depth, const char *name);
+static void AH_ImExporterSEPA_Xml_CloseTag(GWEN_BUFFER *buf, int depth, const char *name);
+static void AH_ImExporterSEPA_Xml_AddElement(GWEN_BUFFER *buf, int depth, const char *name, const char *value);
+static int AH_ImExporterSEPA_Xml_AddElementEscaped(GWEN_BUFFER *buf, int depth, const char *name, const char *value);
+static void AH_ImExporterSEPA_Xml_AddIntElement(GWEN_BUFFER *buf, int depth, const char *name, int value);
+static int AH_ImExporterSEPA_Xml_AddDateElement(GWEN_BUFFER *buf, int depth, const char *name, const GWEN_DATE *dt);
+static void AH_ImExporterSEPA_Xml_AddAmount(GWEN_BUFFER *buf, int depth, const char *name, const AB_VALUE *v);
+static int AH_ImExporterSEPA_Xml_Flush(GWEN_BUFFER *buf, GWEN_SYNCIO *sio, int force);
 
 
 #endif /* AQHBCI_IMEX_SEPA_P_H */
@@ -1,5 +1,3 @@
-
-
 /* included by sepa.c */
 
 
@@ -7,261 +5,272 @@
 
 
 
-int AH_ImExporterSEPA_Export_Pain_001(AB_IMEXPORTER *ie,
-                                      AB_IMEXPORTER_CONTEXT *ctx,
-                                      GWEN_XMLNODE *painNode,
-                                      uint32_t doctype[],
-                                      GWEN_DB_NODE *params)
+int AH_ImExporterSEPA_Export_Pain_001_Check(AH_IMEXPORTER_SEPA_PMTINF_LIST *pl,
+                                            uint32_t doctype[],
+                                            GWEN_DB_NODE *params)
 {
-  GWEN_XMLNODE *n;
-  AH_IMEXPORTER_SEPA_PMTINF_LIST *pl;
   AH_IMEXPORTER_SEPA_PMTINF *pmtinf;
-  int post_1_1_2=(doctype[1]>1 || doctype[2]>2);
-  const char *s;
-  int rv;
-
-  rv=AH_ImExporterSEPA_Export_Pain_Setup(ie, ctx, painNode, doctype, &pl);
-  if (rv) {
-    DBG_ERROR(AQBANKING_LOGDOMAIN, "here %d", rv);
-    return rv;
-  }
 
-  /* generate PmtInf blocks */
   pmtinf=AH_ImExporter_Sepa_PmtInf_List_First(pl);
   while (pmtinf) {
-    const GWEN_DATE *tda;
-    GWEN_XMLNODE *nn;
-    AB_TRANSACTION *t;
     AB_TRANSACTION_LIST2_ITERATOR *it;
 
-    n=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "PmtInf");
-    GWEN_XMLNode_AddChild(painNode, n);
-
-    /* generate PmtInfId */
-    if (1) {
-      GWEN_TIME *ti;
-      GWEN_BUFFER *tbuf;
-      uint32_t uid;
-      char numbuf[32];
-
-      ti=GWEN_CurrentTime();
-      tbuf=GWEN_Buffer_new(0, 64, 0, 1);
-
-      uid=AB_Banking_GetNamedUniqueId(AB_ImExporter_GetBanking(ie), "sepamsg", 1);
-      GWEN_Time_toUtcString(ti, "YYYYMMDD-hh:mm:ss-", tbuf);
-      snprintf(numbuf, sizeof(numbuf)-1, "%08x", uid);
-      GWEN_Buffer_AppendString(tbuf, numbuf);
-      AH_ImExporterSEPA_XmlSetCharValueEscaped(n, "PmtInfId", GWEN_Buffer_GetStart(tbuf));
-      GWEN_Buffer_free(tbuf);
-      GWEN_Time_free(ti);
+    /* For PAIN before 001.003.02 the local BIC is always required */
+    if (!(pmtinf->localBic && *(pmtinf->localBic)) && doctype[1]<3) {
+      DBG_ERROR(AQBANKING_LOGDOMAIN, "No local BIC, but is required");
+      return GWEN_ERROR_BAD_DATA;
     }
 
-    AH_ImExporterSEPA_XmlSetCharValueEscaped(n, "PmtMtd", "TRF");
+    it=AB_Transaction_List2_First(pmtinf->transactions);
+    if (it) {
+      const AB_TRANSACTION *t;
 
-    if (post_1_1_2) {
-      /* store BtchBookg */
-      AH_ImExporterSEPA_XmlSetCharValueEscaped(n, "BtchBookg",
-                                               GWEN_DB_GetIntValue(params,
-                                                                   "singleBookingWanted", 0, 1)
-                                               ? "false"
-                                               : "true");
-      /* store NbOfTxs */
-      GWEN_XMLNode_SetIntValue(n, "NbOfTxs", pmtinf->tcount);
-      /* store CtrlSum */
-      AH_ImExporterSEPA_XmlSetCharValueEscaped(n, "CtrlSum", pmtinf->ctrlsum);
+      t=AB_Transaction_List2Iterator_Data(it);
+      while (t) {
+        int rv;
+
+        rv=AH_ImExporterSEPA_Export_Pain_001_CheckTransaction(t, doctype);
+        if (rv) {
+          DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+          AB_Transaction_List2Iterator_free(it);
+          return rv;
+        }
+        t=AB_Transaction_List2Iterator_Next(it);
+      }
+      AB_Transaction_List2Iterator_free(it);
     }
 
-    nn=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "PmtTpInf");
-    if (nn) {
-      GWEN_XMLNODE *nnn;
+    pmtinf=AH_ImExporter_Sepa_PmtInf_List_Next(pmtinf);
+  }
 
-      nnn=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "SvcLvl");
-      if (nnn) {
-        AH_ImExporterSEPA_XmlSetCharValueEscaped(nnn, "Cd", "SEPA");
-        GWEN_XMLNode_AddChild(nn, nnn);
-      }
+  return 0;
+}
 
-      GWEN_XMLNode_AddChild(n, nn);
-    }
 
-    /* create ReqdExctnDt" */
-    tda=pmtinf->date;
-    if (tda) {
-      GWEN_BUFFER *tbuf;
 
-      tbuf=GWEN_Buffer_new(0, 64, 0, 1);
-      GWEN_Date_toStringWithTemplate(tda, "YYYY-MM-DD", tbuf);
-      AH_ImExporterSEPA_XmlSetCharValueEscaped(n, "ReqdExctnDt", GWEN_Buffer_GetStart(tbuf));
-      GWEN_Buffer_free(tbuf);
-    }
-    else {
-      AH_ImExporterSEPA_XmlSetCharValueEscaped(n, "ReqdExctnDt", "1999-01-01");
-    }
+int AH_ImExporterSEPA_Export_Pain_001_CheckTransaction(const AB_TRANSACTION *t, uint32_t doctype[])
+{
+  const char *s;
 
-    /* create "Dbtr" */
-    nn=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "Dbtr");
-    if (nn) {
-      GWEN_XMLNode_AddChild(n, nn);
-      AH_ImExporterSEPA_XmlSetCharValueEscaped(nn, "Nm", pmtinf->localName);
-    }
+  if (AB_Transaction_GetValue(t)==NULL) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "No value in transaction");
+    return GWEN_ERROR_BAD_DATA;
+  }
 
-    /* create "DbtrAcct" */
-    GWEN_XMLNode_SetCharValueByPath(n, GWEN_XML_PATH_FLAGS_OVERWRITE_VALUES, "DbtrAcct/Id/IBAN", pmtinf->localIban);
+  s=AB_Transaction_GetRemoteBic(t);
+  if (!(s && *s) && doctype[1]<3) { /* BIC not required since 001.003.03 */
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "No remote BIC");
+    return GWEN_ERROR_BAD_DATA;
+  }
 
-    /* create "DbtrAgt" */
-    {
-      const char *bic = pmtinf->localBic;
-      if (bic && *bic)
-        GWEN_XMLNode_SetCharValueByPath(n, GWEN_XML_PATH_FLAGS_OVERWRITE_VALUES,
-                                        "DbtrAgt/FinInstnId/BIC", bic);
-      else {
-        if (doctype[1] >= 3) { /* BIC not required since 001.003.02, but must be written as "Othr/Id/NOTPROVIDED" */
-          GWEN_XMLNode_SetCharValueByPath(n, GWEN_XML_PATH_FLAGS_OVERWRITE_VALUES,
-                                          "DbtrAgt/FinInstnId/Othr/Id", "NOTPROVIDED");
-        }
-        else { /* For PAIN before 001.003.02, BIC is always required */
-          DBG_ERROR(AQBANKING_LOGDOMAIN, "No local BIC, but is required");
-          return GWEN_ERROR_BAD_DATA;
-        }
-      }
-    }
+  s=AB_Transaction_GetRemoteName(t);
+  if (!(s && *s)) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "No remote name");
+    return GWEN_ERROR_BAD_DATA;
+  }
 
-    AH_ImExporterSEPA_XmlSetCharValueEscaped(n, "ChrgBr", "SLEV");
+  s=AB_Transaction_GetRemoteIban(t);
+  if (!(s && *s)) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "No remote IBAN");
+    return GWEN_ERROR_BAD_DATA;
+  }
 
+  s=AB_Transaction_GetPurpose(t);
+  if (!(s && *s)) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Missing purpose in transaction");
+    return GWEN_ERROR_BAD_DATA;
+  }
 
-    it=AB_Transaction_List2_First(pmtinf->transactions);
-    assert(it);
-    t=AB_Transaction_List2Iterator_Data(it);
-    while (t) {
-      GWEN_XMLNODE *nn;
-
-      nn=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "CdtTrfTxInf");
-      if (nn) {
-        GWEN_XMLNODE *nnn;
-        const AB_VALUE *tv;
-
-        GWEN_XMLNode_AddChild(n, nn);
-
-        /* create "PmtId" */
-        nnn=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "PmtId");
-        if (nnn) {
-          GWEN_XMLNode_AddChild(nn, nnn);
-          s=AB_Transaction_GetEndToEndReference(t);
-          /*if (!(s && *s))
-            s=AB_Transaction_GetCustomerReference(t);*/
-          if (!(s && *s))
-            s="NOTPROVIDED";
-          AH_ImExporterSEPA_XmlSetCharValueEscaped(nnn, "EndToEndId", s);
-        }
+  return 0;
+}
 
-        tv=AB_Transaction_GetValue(t);
-        if (tv==NULL) {
-          DBG_ERROR(AQBANKING_LOGDOMAIN, "No value in transaction");
-          AB_Transaction_List2Iterator_free(it);
-          AH_ImExporter_Sepa_PmtInf_List_free(pl);
-          return GWEN_ERROR_BAD_DATA;
-        }
 
-        nnn=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "Amt");
-        if (nnn) {
-          GWEN_XMLNODE *nnnn;
 
-          GWEN_XMLNode_AddChild(nn, nnn);
+/* write PmtInf blocks, expects the data to be checked by AH_ImExporterSEPA_Export_Pain_001_Check() */
+int AH_ImExporterSEPA_Export_Pain_001_Write(AB_IMEXPORTER *ie,
+                                            AH_IMEXPORTER_SEPA_PMTINF_LIST *pl,
+                                            uint32_t doctype[],
+                                            GWEN_DB_NODE *params,
+                                            GWEN_BUFFER *buf,
+                                            GWEN_SYNCIO *sio)
+{
+  AH_IMEXPORTER_SEPA_PMTINF *pmtinf;
+  int post_1_1_2=(doctype[1]>1 || doctype[2]>2);
+  int rv;
 
-          nnnn=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "InstdAmt");
-          if (nnnn) {
-            GWEN_BUFFER *tbuf;
-            GWEN_XMLNODE *nnnnn;
+  pmtinf=AH_ImExporter_Sepa_PmtInf_List_First(pl);
+  while (pmtinf) {
+    AB_TRANSACTION_LIST2_ITERATOR *it;
+    GWEN_TIME *ti;
 
-            GWEN_XMLNode_AddChild(nnn, nnnn);
+    AH_ImExporterSEPA_Xml_OpenTag(buf, 2, "PmtInf");
 
-            tbuf=GWEN_Buffer_new(0, 64, 0, 1);
-            AB_Value_toHumanReadableString(tv, tbuf, 2, 0);
-            s=AB_Value_GetCurrency(tv);
-            if (!s)
-              s="EUR";
-            GWEN_XMLNode_SetProperty(nnnn, "Ccy", s);
+    /* generate PmtInfId */
+    ti=GWEN_CurrentTime();
+    AH_ImExporterSEPA_Export_AddMessageId(ie, params, ti, 3, "PmtInfId", buf);
+    GWEN_Time_free(ti);
 
-            nnnnn=GWEN_XMLNode_new(GWEN_XMLNodeTypeData, GWEN_Buffer_GetStart(tbuf));
-            GWEN_XMLNode_AddChild(nnnn, nnnnn);
-            GWEN_Buffer_free(tbuf);
-          }
-        }
+    AH_ImExporterSEPA_Xml_AddElement(buf, 3, "PmtMtd", "TRF");
 
-        /* create "CdtrAgt" */
-        s=AB_Transaction_GetRemoteBic(t);
-        if (s && *s)
-          GWEN_XMLNode_SetCharValueByPath(nn, GWEN_XML_PATH_FLAGS_OVERWRITE_VALUES,
-                                          "CdtrAgt/FinInstnId/BIC", s);
-        else if (doctype[1]<3) { /* BIC not required since 001.003.03 */
-          DBG_ERROR(AQBANKING_LOGDOMAIN, "No remote BIC");
-          AB_Transaction_List2Iterator_free(it);
-          AH_ImExporter_Sepa_PmtInf_List_free(pl);
-          return GWEN_ERROR_BAD_DATA;
-        }
+    if (post_1_1_2) {
+      /* store BtchBookg */
+      AH_ImExporterSEPA_Xml_AddElement(buf, 3, "BtchBookg",
+                                       GWEN_DB_GetIntValue(params, "singleBookingWanted", 0, 1)
+                                       ? "false"
+                                       : "true");
+      /* store NbOfTxs */
+      AH_ImExporterSEPA_Xml_AddIntElement(buf, 3, "NbOfTxs", pmtinf->tcount);
+      /* store CtrlSum */
+      AH_ImExporterSEPA_Xml_AddElement(buf, 3, "CtrlSum", pmtinf->ctrlsum);
+    }
 
-        /* create "Cdtr" */
-        nnn=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "Cdtr");
-        if (nnn) {
-          GWEN_XMLNode_AddChild(nn, nnn);
-          s=AB_Transaction_GetRemoteName(t);
-          if (!(s && *s)) {
-            DBG_ERROR(AQBANKING_LOGDOMAIN, "No remote name");
-            AB_Transaction_List2Iterator_free(it);
-            AH_ImExporter_Sepa_PmtInf_List_free(pl);
-            return GWEN_ERROR_BAD_DATA;
-          }
-          AH_ImExporterSEPA_XmlSetCharValueEscaped(nnn, "Nm", s);
-        }
+    AH_ImExporterSEPA_Xml_OpenTag(buf, 3, "PmtTpInf");
+    AH_ImExporterSEPA_Xml_OpenTag(buf, 4, "SvcLvl");
+    AH_ImExporterSEPA_Xml_AddElement(buf, 5, "Cd", "SEPA");
+    AH_ImExporterSEPA_Xml_CloseTag(buf, 4, "SvcLvl");
+    AH_ImExporterSEPA_Xml_CloseTag(buf, 3, "PmtTpInf");
+
+    /* create "ReqdExctnDt" */
+    if (pmtinf->date) {
+      rv=AH_ImExporterSEPA_Xml_AddDateElement(buf, 3, "ReqdExctnDt", pmtinf->date);
+      if (rv<0) {
+        DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+        return rv;
+      }
+    }
+    else
+      AH_ImExporterSEPA_Xml_AddElement(buf, 3, "ReqdExctnDt", "1999-01-01");
 
-        /* create "CdtrAcct" */
-        nnn=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "CdtrAcct");
-        if (nnn) {
-          GWEN_XMLNODE *nnnn;
-
-          GWEN_XMLNode_AddChild(nn, nnn);
-          s=AB_Transaction_GetRemoteIban(t);
-          if (!s) {
-            DBG_ERROR(AQBANKING_LOGDOMAIN, "No remote IBAN");
-            AB_Transaction_List2Iterator_free(it);
-            AH_ImExporter_Sepa_PmtInf_List_free(pl);
-            return GWEN_ERROR_BAD_DATA;
-          }
-
-          nnnn=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "Id");
-          if (nnnn) {
-            GWEN_XMLNode_AddChild(nnn, nnnn);
-            AH_ImExporterSEPA_XmlSetCharValueEscaped(nnnn, "IBAN", s);
-          }
-        }
+    /* create "Dbtr" */
+    AH_ImExporterSEPA_Xml_OpenTag(buf, 3, "Dbtr");
+    rv=AH_ImExporterSEPA_Xml_AddElementEscaped(buf, 4, "Nm", pmtinf->localName);
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      return rv;
+    }
+    AH_ImExporterSEPA_Xml_CloseTag(buf, 3, "Dbtr");
+
+    /* create "DbtrAcct" */
+    AH_ImExporterSEPA_Xml_OpenTag(buf, 3, "DbtrAcct");
+    AH_ImExporterSEPA_Xml_OpenTag(buf, 4, "Id");
+    AH_ImExporterSEPA_Xml_AddElement(buf, 5, "IBAN", pmtinf->localIban);
+    AH_ImExporterSEPA_Xml_CloseTag(buf, 4, "Id");
+    AH_ImExporterSEPA_Xml_CloseTag(buf, 3, "DbtrAcct");
 
-        /* create "RmtInf" */
-        nnn=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "RmtInf");
-        if (nnn) {
-          GWEN_XMLNode_AddChild(nn, nnn);
+    /* create "DbtrAgt" */
+    AH_ImExporterSEPA_Xml_OpenTag(buf, 3, "DbtrAgt");
+    AH_ImExporterSEPA_Xml_OpenTag(buf, 4, "FinInstnId");
+    if (pmtinf->localBic && *(pmtinf->localBic))
+      AH_ImExporterSEPA_Xml_AddElement(buf, 5, "BIC", pmtinf->localBic);
+    else {
+      /* BIC not required since 001.003.02, but must be written as "Othr/Id/NOTPROVIDED" */
+      AH_ImExporterSEPA_Xml_OpenTag(buf, 5, "Othr");
+      AH_ImExporterSEPA_Xml_AddElement(buf, 6, "Id", "NOTPROVIDED");
+      AH_ImExporterSEPA_Xml_CloseTag(buf, 5, "Othr");
+    }
+    AH_ImExporterSEPA_Xml_CloseTag(buf, 4, "FinInstnId");
+    AH_ImExporterSEPA_Xml_CloseTag(buf, 3, "DbtrAgt");
 
-          s=AB_Transaction_GetPurpose(t);
-          if (!(s && *s)) {
-            DBG_ERROR(AQBANKING_LOGDOMAIN, "Missing purpose in transaction");
-            AB_Transaction_List2Iterator_free(it);
-            AH_ImExporter_Sepa_PmtInf_List_free(pl);
-            return GWEN_ERROR_BAD_DATA;
-          }
+    AH_ImExporterSEPA_Xml_AddElement(buf, 3, "ChrgBr", "SLEV");
 
-          AH_ImExporterSEPA_XmlSetCharValueEscaped(nnn, "Ustrd", s);
+    /* write transactions */
+    it=AB_Transaction_List2_First(pmtinf->transactions);
+    if (it) {
+      const AB_TRANSACTION *t;
+
+      t=AB_Transaction_List2Iterator_Data(it);
+      while (t) {
+        rv=AH_ImExporterSEPA_Export_Pain_001_WriteTransaction(t, doctype, buf);
+        if (rv==0)
+          rv=AH_ImExporterSEPA_Xml_Flush(buf, sio, 0);
+        if (rv) {
+          DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+          AB_Transaction_List2Iterator_free(it);
+          return rv;
         }
+        t=AB_Transaction_List2Iterator_Next(it);
       }
+      AB_Transaction_List2Iterator_free(it);
+    }
+
+    AH_ImExporterSEPA_Xml_CloseTag(buf, 2, "PmtInf");
 
-      t=AB_Transaction_List2Iterator_Next(it);
-    } /* while t */
-    AB_Transaction_List2Iterator_free(it);
     pmtinf=AH_ImExporter_Sepa_PmtInf_List_Next(pmtinf);
   } /* while pmtinf  */
-  AH_ImExporter_Sepa_PmtInf_List_free(pl);
 
   return 0;
 }
 
 
 
+/* write the CdtTrfTxInf block for a single transaction */
+int AH_ImExporterSEPA_Export_Pain_001_WriteTransaction(const AB_TRANSACTION *t,
+                                                       uint32_t doctype[],
+                                                       GWEN_BUFFER *buf)
+{
+  const char *s;
+  int rv;
+
+  AH_ImExporterSEPA_Xml_OpenTag(buf, 3, "CdtTrfTxInf");
+
+  /* create "PmtId" */
+  s=AB_Transaction_GetEndToEndReference(t);
+  /*if (!(s && *s))
+    s=AB_Transaction_GetCustomerReference(t);*/
+  if (!(s && *s))
+    s="NOTPROVIDED";
+  AH_ImExporterSEPA_Xml_OpenTag(buf, 4, "PmtId");
+  rv=AH_ImExporterSEPA_Xml_AddElementEscaped(buf, 5, "EndToEndId", s);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+  AH_ImExporterSEPA_Xml_CloseTag(buf, 4, "PmtId");
+
+  /* create "Amt" */
+  AH_ImExporterSEPA_Xml_OpenTag(buf, 4, "Amt");
+  AH_ImExporterSEPA_Xml_AddAmount(buf, 5, "InstdAmt", AB_Transaction_GetValue(t));
+  AH_ImExporterSEPA_Xml_CloseTag(buf, 4, "Amt");
+
+  /* create "CdtrAgt" (BIC not required since 001.003.03) */
+  s=AB_Transaction_GetRemoteBic(t);
+  if (s && *s) {
+    AH_ImExporterSEPA_Xml_OpenTag(buf, 4, "CdtrAgt");
+    AH_ImExporterSEPA_Xml_OpenTag(buf, 5, "FinInstnId");
+    AH_ImExporterSEPA_Xml_AddElement(buf, 6, "BIC", s);
+    AH_ImExporterSEPA_Xml_CloseTag(buf, 5, "FinInstnId");
+    AH_ImExporterSEPA_Xml_CloseTag(buf, 4, "CdtrAgt");
+  }
+
+  /* create "Cdtr" */
+  AH_ImExporterSEPA_Xml_OpenTag(buf, 4, "Cdtr");
+  rv=AH_ImExporterSEPA_Xml_AddElementEscaped(buf, 5, "Nm", AB_Transaction_GetRemoteName(t));
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+  AH_ImExporterSEPA_Xml_CloseTag(buf, 4, "Cdtr");
+
+  /* create "CdtrAcct" */
+  AH_ImExporterSEPA_Xml_OpenTag(buf, 4, "CdtrAcct");
+  AH_ImExporterSEPA_Xml_OpenTag(buf, 5, "Id");
+  rv=AH_ImExporterSEPA_Xml_AddElementEscaped(buf, 6, "IBAN", AB_Transaction_GetRemoteIban(t));
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+  AH_ImExporterSEPA_Xml_CloseTag(buf, 5, "Id");
+  AH_ImExporterSEPA_Xml_CloseTag(buf, 4, "CdtrAcct");
+
+  /* create "RmtInf" */
+  AH_ImExporterSEPA_Xml_OpenTag(buf, 4, "RmtInf");
+  rv=AH_ImExporterSEPA_Xml_AddElementEscaped(buf, 5, "Ustrd", AB_Transaction_GetPurpose(t));
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+  AH_ImExporterSEPA_Xml_CloseTag(buf, 4, "RmtInf");
 
+  AH_ImExporterSEPA_Xml_CloseTag(buf, 3, "CdtTrfTxInf");
+  return 0;
+}
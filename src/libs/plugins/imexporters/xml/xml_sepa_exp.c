@@ -43,7 +43,8 @@ static AB_IMEXPORTER_XML_PAYMENTGROUP *_getMatchingPaymentGroupForTransaction(AB
                                                                               const AB_TRANSACTION *t);
 static void _sampleTotalTransactions(AB_IMEXPORTER_XML_PAYMENTGROUP_LIST *paymentGroupList, GWEN_DB_NODE *dbData);
 
-static const char *_createAndWriteMessageId(AB_IMEXPORTER *ie, const char *varName, GWEN_DB_NODE *dbData);
+static const char *_createAndWriteMessageId(AB_IMEXPORTER *ie, const char *varName, GWEN_DB_NODE *dbData,
+                                           GWEN_DB_NODE *dbParams);
 static void _createPaymentInfoIds(AB_IMEXPORTER_XML_PAYMENTGROUP_LIST *paymentGroupList, const char *messageId);
 
 static void _writePaymentGroups(const AB_IMEXPORTER_XML_PAYMENTGROUP_LIST *paymentGroupList,
@@ -179,7 +180,7 @@ GWEN_DB_NODE *_ctxToSepaDb(AB_IMEXPORTER *ie, const AB_IMEXPORTER_CONTEXT *ctx,
     }
   }
 
-  messageId=_createAndWriteMessageId(ie, "messageId", dbData);
+  messageId=_createAndWriteMessageId(ie, "messageId", dbData, dbParams);
   if (messageId==NULL) {
     DBG_ERROR(AQBANKING_LOGDOMAIN, "Could not generate message id, aborting.");
     GWEN_DB_Group_free(dbData);
@@ -237,7 +238,8 @@ AB_IMEXPORTER_XML_PAYMENTGROUP_LIST *_sortIntoPaymentGroups(const AB_IMEXPORTER_
 
 
 
-const char *_createAndWriteMessageId(AB_IMEXPORTER *ie, const char *varName, GWEN_DB_NODE *dbData)
+const char *_createAndWriteMessageId(AB_IMEXPORTER *ie, const char *varName, GWEN_DB_NODE *dbData,
+                                     GWEN_DB_NODE *dbParams)
 {
   GWEN_TIME *ti;
   GWEN_BUFFER *tbuf;
@@ -247,7 +249,7 @@ const char *_createAndWriteMessageId(AB_IMEXPORTER *ie, const char *varName, GWE
   ti=GWEN_CurrentTime();
   tbuf=GWEN_Buffer_new(0, 64, 0, 1);
 
-  uid=AB_Banking_GetNamedUniqueId(AB_ImExporter_GetBanking(ie), "sepamsg", 1);
+  uid=AB_ImExporter_GetNextSepaMessageId(ie, dbParams);
   GWEN_Time_toUtcString(ti, "YYYYMMDD-hh:mm:ss-", tbuf);
   snprintf(numbuf, sizeof(numbuf)-1, "%08x", uid);
   GWEN_Buffer_AppendString(tbuf, numbuf);
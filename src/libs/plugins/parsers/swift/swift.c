@@ -40,6 +40,20 @@ static const char *_findStartOfSubTag(const char *sptr);
 
 
 
+int AHB_SWIFT_IsPlainAscii(const char *s)
+{
+  while (*s) {
+    unsigned int c;
+
+    c=(unsigned char)(*(s++));
+    if (c<32 || c>126)
+      return 0;
+  }
+  return 1;
+}
+
+
+
 int AHB_SWIFT_Condense(char *buffer, int keepMultipleBlanks)
 {
   char *src;
@@ -104,12 +118,22 @@ AHB_SWIFT_TAG *AHB_SWIFT_Tag_new(const char *id,
 {
   AHB_SWIFT_TAG *tg;
 
+  int idLen;
+  int contentLen;
+
   assert(id);
   assert(content);
   GWEN_NEW_OBJECT(AHB_SWIFT_TAG, tg);
   GWEN_LIST_INIT(AHB_SWIFT_TAG, tg);
-  tg->id=strdup(id);
-  tg->content=strdup(content);
+
+  /* id and content share a single allocation */
+  idLen=strlen(id);
+  contentLen=strlen(content);
+  tg->id=(char *) malloc(idLen+1+contentLen+1);
+  assert(tg->id);
+  memmove(tg->id, id, idLen+1);
+  tg->content=tg->id+idLen+1;
+  memmove(tg->content, content, contentLen+1);
 
   return tg;
 }
@@ -120,8 +144,7 @@ void AHB_SWIFT_Tag_free(AHB_SWIFT_TAG *tg)
 {
   if (tg) {
     GWEN_LIST_FINI(AHB_SWIFT_TAG, tg);
-    free(tg->id);
-    free(tg->content);
+    free(tg->id); /* also frees content */
     GWEN_FREE_OBJECT(tg);
   }
 }
@@ -242,14 +265,11 @@ const char *_findStartOfSubTag(const char *sptr)
 
 
 
-int AHB_SWIFT_GetNextSubTag(const char **sptr, AHB_SWIFT_SUBTAG **tptr)
+int AHB_SWIFT_GetNextSubTagView(const char **sptr, AHB_SWIFT_SUBTAG_VIEW *view)
 {
   const char *s;
   int id=0;
-  /*int nextId=0;*/
-  const char *content=NULL;
   const char *startOfSubTag;
-  AHB_SWIFT_SUBTAG *stg;
 
   s=*sptr;
   startOfSubTag=_findStartOfSubTag(s);
@@ -270,17 +290,17 @@ int AHB_SWIFT_GetNextSubTag(const char **sptr, AHB_SWIFT_SUBTAG **tptr)
         s=t;
       }
     }
-    content=s;
 
-    /* create subtag */
     startOfNextSubTag=_findStartOfSubTag(s);
+    view->id=id;
+    view->content=s;
     if (startOfNextSubTag)
-      stg=AHB_SWIFT_SubTag_new(id, content, startOfNextSubTag-content);
+      view->contentLen=startOfNextSubTag-s;
     else
       /* rest of line */
-      stg=AHB_SWIFT_SubTag_new(id, content, -1);
-    /* update return pointers */
-    *tptr=stg;
+      view->contentLen=strlen(s);
+
+    /* update return pointer */
     *sptr=startOfNextSubTag;
     return 0;
   }
@@ -292,6 +312,29 @@ int AHB_SWIFT_GetNextSubTag(const char **sptr, AHB_SWIFT_SUBTAG **tptr)
 
 
 
+void AHB_SWIFT_SubTagView_CondenseToBuffer(const AHB_SWIFT_SUBTAG_VIEW *view, int keepMultipleBlanks, GWEN_BUFFER *buf)
+{
+  GWEN_Buffer_Reset(buf);
+  GWEN_Buffer_AppendBytes(buf, view->content, view->contentLen);
+  AHB_SWIFT_Condense(GWEN_Buffer_GetStart(buf), keepMultipleBlanks);
+}
+
+
+
+int AHB_SWIFT_GetNextSubTag(const char **sptr, AHB_SWIFT_SUBTAG **tptr)
+{
+  AHB_SWIFT_SUBTAG_VIEW view;
+  int rv;
+
+  rv=AHB_SWIFT_GetNextSubTagView(sptr, &view);
+  if (rv<0)
+    return rv;
+  *tptr=AHB_SWIFT_SubTag_new(view.id, view.content, view.contentLen);
+  return 0;
+}
+
+
+
 int AHB_SWIFT_ParseSubTags(const char *s, AHB_SWIFT_SUBTAG_LIST *stlist, int keepMultipleBlanks)
 {
   while (s && *s) {
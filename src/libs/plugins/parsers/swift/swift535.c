@@ -63,6 +63,10 @@ int AHB_SWIFT__SetCharValue535(GWEN_DB_NODE *db,
   GWEN_BUFFER *vbuf;
   int rv;
 
+  /* no need to transcode plain ASCII */
+  if (AHB_SWIFT_IsPlainAscii(s))
+    return GWEN_DB_SetCharValue(db, flags, name, s);
+
   vbuf=GWEN_Buffer_new(0, strlen(s)+32, 0, 1);
   _iso8859_1ToUtf8(s, -1, vbuf);
   rv=GWEN_DB_SetCharValue(db, flags, name, GWEN_Buffer_GetStart(vbuf));
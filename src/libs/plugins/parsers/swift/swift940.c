@@ -41,7 +41,8 @@
 
 static void _extractAndHandleSepaTags(GWEN_DB_NODE *dbData, uint32_t flags);
 static void _transformPurposeIntoOneString(GWEN_DB_NODE *dbData, uint32_t flags);
-static void _readSubTagsIntoDb(AHB_SWIFT_SUBTAG_LIST *stlist, GWEN_DB_NODE *dbData, uint32_t flags);
+static int _readSubTagsIntoDb(const char *p, GWEN_DB_NODE *dbData, uint32_t flags, int keepMultipleBlanks);
+static int _setCharValueFromView(GWEN_DB_NODE *db, uint32_t flags, const char *name, const char *s, int len);
 static int _readSepaTags(const char *sPurpose, GWEN_DB_NODE *dbSepaTags);
 static int _storeSepaTag(const char *sTagStart, int tagLen, GWEN_DB_NODE *dbSepaTags);
 static void _transformSepaTags(GWEN_DB_NODE *dbData, GWEN_DB_NODE *dbSepaTags, uint32_t flags);
@@ -97,6 +98,10 @@ int AHB_SWIFT__SetCharValue(GWEN_DB_NODE *db,
   GWEN_BUFFER *vbuf;
   int rv;
 
+  /* no need to transcode plain ASCII */
+  if (AHB_SWIFT_IsPlainAscii(s))
+    return GWEN_DB_SetCharValue(db, flags, name, s);
+
   vbuf=GWEN_Buffer_new(0, strlen(s)+32, 0, 1);
   _iso8859_1ToUtf8(s, -1, vbuf);
   rv=GWEN_DB_SetCharValue(db, flags, name, GWEN_Buffer_GetStart(vbuf));
@@ -106,6 +111,27 @@ int AHB_SWIFT__SetCharValue(GWEN_DB_NODE *db,
 
 
 
+int _setCharValueFromView(GWEN_DB_NODE *db, uint32_t flags, const char *name, const char *s, int len)
+{
+  char sbuf[128];
+  char *t;
+  int rv;
+
+  /* most fields are short, avoid allocating a copy for them */
+  if (len<(int)sizeof(sbuf))
+    t=sbuf;
+  else
+    t=(char *)GWEN_Memory_malloc(len+1);
+  memmove(t, s, len);
+  t[len]=0;
+  rv=AHB_SWIFT__SetCharValue(db, flags, name, t);
+  if (t!=sbuf)
+    GWEN_Memory_dealloc(t);
+  return rv;
+}
+
+
+
 int AHB_SWIFT940_Parse_25(const AHB_SWIFT_TAG *tg,
                           uint32_t flags,
                           GWEN_DB_NODE *data,
@@ -206,14 +232,12 @@ int AHB_SWIFT940_Parse_86(const AHB_SWIFT_TAG *tg,
   }
 
   if (isStructured) {
-    AHB_SWIFT_SUBTAG_LIST *stlist;
     int rv;
 
     /* store code */
     GWEN_DB_SetIntValue(dbData, flags, "transactioncode", code);
 
-    stlist=AHB_SWIFT_SubTag_List_new();
-    rv=AHB_SWIFT_ParseSubTags(p, stlist, keepMultipleBlanks);
+    rv=_readSubTagsIntoDb(p, dbData, flags, keepMultipleBlanks);
     if (rv<0) {
       DBG_WARN(AQBANKING_LOGDOMAIN, "Handling tag :86: as unstructured (%d)", rv);
       isStructured=0;
@@ -222,18 +246,15 @@ int AHB_SWIFT940_Parse_86(const AHB_SWIFT_TAG *tg,
       if (code<900) {
         /* sepa */
         DBG_INFO(AQBANKING_LOGDOMAIN, "Reading as SEPA tag (%d)", code);
-        _readSubTagsIntoDb(stlist, dbData, flags);
         _extractAndHandleSepaTags(dbData, flags);
         _transformPurposeIntoOneString(dbData, flags);
       }
       else {
         /* non-sepa */
         DBG_INFO(AQBANKING_LOGDOMAIN, "Reading as non-SEPA tag (%d)", code);
-        _readSubTagsIntoDb(stlist, dbData, flags);
         _transformPurposeIntoOneString(dbData, flags);
       }
     } /* if really structured */
-    AHB_SWIFT_SubTag_List_free(stlist);
   } /* if isStructured */
   else {
     /* unstructured :86:, simply store as mutliple purpose lines */
@@ -461,12 +482,8 @@ int AHB_SWIFT940_Parse_61(const AHB_SWIFT_TAG *tg,
                            "SWIFT: Missing customer reference");
     }
     else {
-      s=(char *)GWEN_Memory_malloc(p2-p+1);
-      memmove(s, p, p2-p);
-      s[p2-p]=0;
-      if (strcasecmp(s, "NONREF")!=0)
-        AHB_SWIFT__SetCharValue(data, flags, "customerReference", s);
-      GWEN_Memory_dealloc(s);
+      if (!(p2-p==6 && strncasecmp(p, "NONREF", 6)==0))
+        _setCharValueFromView(data, flags, "customerReference", p, p2-p);
     }
     bleft-=p2-p;
     p=p2;
@@ -489,11 +506,7 @@ int AHB_SWIFT940_Parse_61(const AHB_SWIFT_TAG *tg,
                              "SWIFT: Non-Standard MT940 file: Missing bank reference field in :61: line - ignored.");
         return 0;
       }
-      s=(char *)GWEN_Memory_malloc(p2-p+1);
-      memmove(s, p, p2-p+1);
-      s[p2-p]=0;
-      AHB_SWIFT__SetCharValue(data, flags, "bankReference", s);
-      GWEN_Memory_dealloc(s);
+      _setCharValueFromView(data, flags, "bankReference", p, p2-p);
       bleft-=p2-p;
       p=p2;
       assert(bleft>=0);
@@ -541,11 +554,7 @@ int AHB_SWIFT940_Parse_61(const AHB_SWIFT_TAG *tg,
                                  "SWIFT: Bad original value");
             return -1;
           }
-          s=(char *)GWEN_Memory_malloc(p2-p+1);
-          memmove(s, p, p2-p+1);
-          s[p2-p]=0;
-          AHB_SWIFT__SetCharValue(data, flags, "origvalue", s);
-          GWEN_Memory_dealloc(s);
+          _setCharValueFromView(data, flags, "origvalue", p, p2-p);
           bleft-=p2-p;
           p=p2;
         }
@@ -573,11 +582,7 @@ int AHB_SWIFT940_Parse_61(const AHB_SWIFT_TAG *tg,
                                  "SWIFT: Bad charges value");
             return -1;
           }
-          s=(char *)GWEN_Memory_malloc(p2-p+1);
-          memmove(s, p, p2-p+1);
-          s[p2-p]=0;
-          AHB_SWIFT__SetCharValue(data, flags, "charges", s);
-          GWEN_Memory_dealloc(s);
+          _setCharValueFromView(data, flags, "charges", p, p2-p);
           bleft-=p2-p;
           p=p2;
         }
@@ -1070,18 +1075,29 @@ int AHB_SWIFT940_Import(AHB_SWIFT_TAG_LIST *tl,
 
 
 
-void _readSubTagsIntoDb(AHB_SWIFT_SUBTAG_LIST *stlist, GWEN_DB_NODE *dbData, uint32_t flags)
+/* read subtags directly from the tag data, only the condensed content of the current subtag is copied */
+int _readSubTagsIntoDb(const char *p, GWEN_DB_NODE *dbData, uint32_t flags, int keepMultipleBlanks)
 {
-  AHB_SWIFT_SUBTAG *stg;
+  AHB_SWIFT_SUBTAG_VIEW view;
+  GWEN_BUFFER *cbuf;
+  int rv;
+
+  /* check for the first subtag before writing anything to the db */
+  rv=AHB_SWIFT_GetNextSubTagView(&p, &view);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
 
-  stg=AHB_SWIFT_SubTag_List_First(stlist);
-  while (stg) {
+  cbuf=GWEN_Buffer_new(0, 256, 0, 1);
+  for (;;) {
     const char *s;
     int id;
     int intVal;
 
-    id=AHB_SWIFT_SubTag_GetId(stg);
-    s=AHB_SWIFT_SubTag_GetData(stg);
+    AHB_SWIFT_SubTagView_CondenseToBuffer(&view, keepMultipleBlanks, cbuf);
+    id=view.id;
+    s=GWEN_Buffer_GetStart(cbuf);
     switch (id) {
     case 0: /* Buchungstext */
       AHB_SWIFT__SetCharValue(dbData, flags, "transactionText", s);
@@ -1138,8 +1154,16 @@ void _readSubTagsIntoDb(AHB_SWIFT_SUBTAG_LIST *stlist, GWEN_DB_NODE *dbData, uin
       DBG_WARN(AQBANKING_LOGDOMAIN, "Unknown :86: field \"%02d\" (%s)", id, s);
       break;
     } /* switch */
-    stg=AHB_SWIFT_SubTag_List_Next(stg);
-  } /* while */
+
+    if (p==NULL || *p==0)
+      break;
+    rv=AHB_SWIFT_GetNextSubTagView(&p, &view);
+    if (rv<0)
+      break;
+  } /* for */
+  GWEN_Buffer_free(cbuf);
+
+  return 0;
 }
 
 
@@ -13,6 +13,7 @@
 
 #include <gwenhywfar/misc.h>
 #include <gwenhywfar/dbio.h>
+#include <gwenhywfar/buffer.h>
 
 
 
@@ -20,6 +21,18 @@ typedef struct AHB_SWIFT_TAG AHB_SWIFT_TAG;
 typedef struct AHB_SWIFT_SUBTAG AHB_SWIFT_SUBTAG;
 
 
+/**
+ * A subtag ("?NN...") referencing the content inside the tag data it was found in (no copy).
+ * The content is not NUL-terminated and may still contain line feeds.
+ */
+typedef struct AHB_SWIFT_SUBTAG_VIEW AHB_SWIFT_SUBTAG_VIEW;
+struct AHB_SWIFT_SUBTAG_VIEW {
+  int id;
+  const char *content;
+  int contentLen;
+};
+
+
 GWEN_LIST_FUNCTION_DEFS(AHB_SWIFT_TAG, AHB_SWIFT_Tag);
 
 
@@ -39,11 +52,27 @@ AHB_SWIFT_SUBTAG *AHB_SWIFT_FindSubTagById(const AHB_SWIFT_SUBTAG_LIST *stlist,
 void AHB_SWIFT_SubTag_Condense(AHB_SWIFT_SUBTAG *stg, int keepMultipleBlanks);
 
 int AHB_SWIFT_GetNextSubTag(const char **sptr, AHB_SWIFT_SUBTAG **tptr);
+
+/**
+ * Find the next subtag in the given string without allocating anything.
+ * On return *sptr points to the start of the following subtag (or NULL if there is none).
+ * @return 0 if ok, GWEN_ERROR_NO_DATA if there is no subtag
+ */
+int AHB_SWIFT_GetNextSubTagView(const char **sptr, AHB_SWIFT_SUBTAG_VIEW *view);
+
+/**
+ * Copy the content of the given subtag view into the buffer (which is reset first) and condense it
+ * (see @ref AHB_SWIFT_Condense).
+ */
+void AHB_SWIFT_SubTagView_CondenseToBuffer(const AHB_SWIFT_SUBTAG_VIEW *view, int keepMultipleBlanks, GWEN_BUFFER *buf);
 int AHB_SWIFT_ParseSubTags(const char *s, AHB_SWIFT_SUBTAG_LIST *stlist, int keepMultipleBlanks);
 
 
 int AHB_SWIFT_Condense(char *buffer, int keepDoubleBlanks);
 
+/** Returns 1 if the given string only contains printable ASCII (i.e. needs no transcoding to UTF-8), 0 otherwise */
+int AHB_SWIFT_IsPlainAscii(const char *s);
+
 
 #endif /* AQHBCIBANK_SWIFT_L_H */
 
@@ -24,7 +24,7 @@
 struct AHB_SWIFT_TAG {
   GWEN_LIST_ELEMENT(AHB_SWIFT_TAG);
   char *id;
-  char *content;
+  char *content; /* points into the allocation of id */
 };
 
 
@@ -0,0 +1,813 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+/*
+ * Benchmark driver for the im-/exporter plugins (run via "make bench").
+ *
+ * For every case and size a synthetic context is created (see benchgen.c) and converted into the input
+ * format of the case, either by one of the writers of the generator or by the exporter of the case itself.
+ * Then the import and/or export path is measured and one JSON object per line is written containing wall
+ * time, peak RSS and number of allocations (glibc only) so that results can be compared across releases.
+ *
+ * With "--profiles" only the lookup of the profile of every case is measured, once by reading all profiles
+ * ("profile-scan") and once via the profile registry ("profile-cache").
+ */
+
+
+#include "benchgen.h"
+
+#include <aqbanking/banking.h>
+#include <aqbanking/version.h>
+
+#include <gwenhywfar/buffer.h>
+#include <gwenhywfar/syncio_memory.h>
+#include <gwenhywfar/syncio_file.h>
+#include <gwenhywfar/db.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+
+
+#define BENCH_FLAGS_IMPORT        0x0001
+#define BENCH_FLAGS_EXPORT        0x0002
+#define BENCH_FLAGS_IMPORT_STREAM 0x0004
+
+#define BENCH_DEFAULT_SIZES  "100,1000,10000"
+#define BENCH_DEFAULT_REPEAT 3
+#define BENCH_MAX_SIZES      16
+
+
+
+typedef struct BENCH_CASE BENCH_CASE;
+struct BENCH_CASE {
+  const char *name;
+  const char *imExporterName;
+  const char *profileName;
+  BENCHGEN_DATATYPE dataType;
+  BENCHGEN_WRITE_FN writeFn;        /* NULL: input is created by the exporter of this case */
+  uint32_t flags;
+};
+
+
+typedef struct BENCH_RUN BENCH_RUN;
+struct BENCH_RUN {
+  AB_BANKING *banking;
+  const BENCH_CASE *benchCase;
+  GWEN_DB_NODE *dbProfile;
+
+  AB_IMEXPORTER_CONTEXT *sourceContext;  /* context to export */
+  GWEN_BUFFER *inputBuffer;              /* data to import */
+
+  AB_IMEXPORTER_CONTEXT *importContext;  /* result of import */
+  GWEN_BUFFER *outputBuffer;             /* result of export */
+  int transactions;
+};
+
+
+typedef struct BENCH_RESULT BENCH_RESULT;
+struct BENCH_RESULT {
+  int result;
+  int transactions;
+  uint32_t bytes;
+  double wallMsMin;
+  double wallMsAvg;
+  long peakRssKb;
+  long rssGrowthKb;
+  long long allocs;
+};
+
+
+typedef int (*BENCH_RUN_FN)(BENCH_RUN *run);
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * forward declarations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+static int _runCase(AB_BANKING *ab, const BENCH_CASE *bc, int size, int repeat, uint32_t seed, FILE *f);
+static int _runProfileCase(AB_BANKING *ab, const BENCH_CASE *bc, int repeat, FILE *f);
+static int _createInput(AB_BANKING *ab, const BENCH_CASE *bc, AB_IMEXPORTER_CONTEXT *ctx, GWEN_BUFFER *buf);
+static int _generateFile(AB_BANKING *ab, const char *caseName, int size, uint32_t seed, const char *fileName);
+
+static int _runImport(BENCH_RUN *run);
+static int _runImportStream(BENCH_RUN *run);
+static int _runExport(BENCH_RUN *run);
+static int _runGetProfile(BENCH_RUN *run);
+static void _cleanupRun(BENCH_RUN *run);
+static int _countTransactionsCb(AB_IMEXPORTER_ACCOUNTINFO *ai, AB_TRANSACTION *t, void *user_data);
+static int _countTransactions(const AB_IMEXPORTER_CONTEXT *ctx);
+
+static void _measure(BENCH_RUN_FN fn, BENCH_RUN *run, int repeat, BENCH_RESULT *res);
+static void _writeResult(FILE *f, const BENCH_CASE *bc, const char *op, int size, uint32_t seed, const BENCH_RESULT *res);
+
+static double _now(void);
+static void _resetPeakRss(void);
+static long _readProcStatusKb(const char *key);
+static long _getPeakRssKb(void);
+static long long _getAllocCount(void);
+
+static const BENCH_CASE *_findCase(const char *name);
+static int _parseSizes(const char *s, int *sizes, int maxSizes);
+static void _usage(const char *prgName);
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * static data
+ * ------------------------------------------------------------------------------------------------
+ */
+
+static const BENCH_CASE _benchCases[]= {
+  /* formats without exporter: input created by the generator */
+  {"mt940",        "swift",   "SWIFT-MT940",     BenchGen_DataType_Statements, BenchGen_WriteMt940, BENCH_FLAGS_IMPORT},
+  {"ofx",          "ofx",     "default",         BenchGen_DataType_Statements, BenchGen_WriteOfx,   BENCH_FLAGS_IMPORT | BENCH_FLAGS_IMPORT_STREAM},
+  {"eri2",         "eri2",    "default",         BenchGen_DataType_Statements, BenchGen_WriteEri2,  BENCH_FLAGS_IMPORT},
+  {"q43",          "q43",     "default",         BenchGen_DataType_Statements, BenchGen_WriteQ43,   BENCH_FLAGS_IMPORT},
+
+  /* formats with exporter: input created by exporting the generated context */
+  {"csv",          "csv",     "full",            BenchGen_DataType_Statements, NULL, BENCH_FLAGS_IMPORT | BENCH_FLAGS_EXPORT},
+  {"ctxfile",      "ctxfile", "default",         BenchGen_DataType_Statements, NULL, BENCH_FLAGS_IMPORT | BENCH_FLAGS_EXPORT},
+  {"columnar",     "columnar", "default",        BenchGen_DataType_Statements, NULL, BENCH_FLAGS_EXPORT},
+  {"camt052",      "xml",     "camt_052_001_02", BenchGen_DataType_Statements, NULL, BENCH_FLAGS_IMPORT | BENCH_FLAGS_EXPORT},
+  {"camt053",      "xml",     "camt_053_001_04", BenchGen_DataType_Statements, NULL, BENCH_FLAGS_IMPORT | BENCH_FLAGS_EXPORT},
+  {"pain001",      "xml",     "pain_001_001_03", BenchGen_DataType_Transfers,  NULL, BENCH_FLAGS_IMPORT | BENCH_FLAGS_EXPORT},
+  {"pain008",      "xml",     "pain_008_001_02", BenchGen_DataType_DebitNotes, NULL, BENCH_FLAGS_IMPORT | BENCH_FLAGS_EXPORT},
+  {"sepa-pain001", "sepa",    "001_003_03",      BenchGen_DataType_Transfers,  NULL, BENCH_FLAGS_EXPORT},
+  {"sepa-pain008", "sepa",    "008_003_02",      BenchGen_DataType_DebitNotes, NULL, BENCH_FLAGS_EXPORT},
+  {NULL,           NULL,      NULL,              BenchGen_DataType_Statements, NULL, 0}
+};
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * allocation counter
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#if defined(__GLIBC__) && !defined(AB_BENCH_NO_MALLOC_COUNT)
+
+/* glibc explicitly supports replacing malloc by the application, the original functions are still
+ * available under these names */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+static volatile long long _allocCount=0;
+
+
+void *malloc(size_t size)
+{
+  _allocCount++;
+  return __libc_malloc(size);
+}
+
+
+
+void *calloc(size_t nmemb, size_t size)
+{
+  _allocCount++;
+  return __libc_calloc(nmemb, size);
+}
+
+
+
+void *realloc(void *ptr, size_t size)
+{
+  _allocCount++;
+  return __libc_realloc(ptr, size);
+}
+
+
+
+void free(void *ptr)
+{
+  __libc_free(ptr);
+}
+
+
+
+long long _getAllocCount(void)
+{
+  return _allocCount;
+}
+
+#else
+
+long long _getAllocCount(void)
+{
+  return -1;
+}
+
+#endif
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * implementations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+int main(int argc, char **argv)
+{
+  AB_BANKING *ab;
+  int sizes[BENCH_MAX_SIZES];
+  int sizeCount;
+  int repeat=BENCH_DEFAULT_REPEAT;
+  uint32_t seed=0;
+  const char *caseName=NULL;
+  const char *generateName=NULL;
+  const char *outFile=NULL;
+  int profilesOnly=0;
+  FILE *f=stdout;
+  int errors=0;
+  int rv;
+  int i;
+
+  sizeCount=_parseSizes(BENCH_DEFAULT_SIZES, sizes, BENCH_MAX_SIZES);
+
+  for (i=1; i<argc; i++) {
+    const char *s=argv[i];
+
+    if ((strcmp(s, "-s")==0 || strcmp(s, "--sizes")==0) && i+1<argc) {
+      sizeCount=_parseSizes(argv[++i], sizes, BENCH_MAX_SIZES);
+      if (sizeCount<1) {
+        fprintf(stderr, "Invalid list of sizes\n");
+        return 1;
+      }
+    }
+    else if ((strcmp(s, "-r")==0 || strcmp(s, "--repeat")==0) && i+1<argc) {
+      repeat=atoi(argv[++i]);
+      if (repeat<1)
+        repeat=1;
+    }
+    else if (strcmp(s, "--seed")==0 && i+1<argc)
+      seed=(uint32_t) strtoul(argv[++i], NULL, 0);
+    else if ((strcmp(s, "-c")==0 || strcmp(s, "--case")==0) && i+1<argc)
+      caseName=argv[++i];
+    else if ((strcmp(s, "-g")==0 || strcmp(s, "--generate")==0) && i+1<argc)
+      generateName=argv[++i];
+    else if (strcmp(s, "-o")==0 && i+1<argc)
+      outFile=argv[++i];
+    else if (strcmp(s, "--profiles")==0)
+      profilesOnly=1;
+    else if (strcmp(s, "-l")==0 || strcmp(s, "--list")==0) {
+      const BENCH_CASE *bc;
+
+      for (bc=_benchCases; bc->name; bc++)
+        fprintf(stdout, "%-14s %-8s %s\n", bc->name, bc->imExporterName, bc->profileName);
+      return 0;
+    }
+    else {
+      _usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (caseName && _findCase(caseName)==NULL) {
+    fprintf(stderr, "Unknown case \"%s\"\n", caseName);
+    return 1;
+  }
+
+  ab=AB_Banking_new("abbench", "./abbench.conf", 0);
+  rv=AB_Banking_Init(ab);
+  if (rv) {
+    fprintf(stderr, "Could not init AqBanking (%d)\n", rv);
+    AB_Banking_free(ab);
+    return 2;
+  }
+
+  if (generateName) {
+    /* only write the input data of a case */
+    if (outFile==NULL) {
+      fprintf(stderr, "Option -o required with --generate\n");
+      errors++;
+    }
+    else if (_generateFile(ab, generateName, sizes[0], seed, outFile)<0)
+      errors++;
+  }
+  else {
+    const BENCH_CASE *bc;
+
+    if (outFile) {
+      f=fopen(outFile, "w");
+      if (f==NULL) {
+        fprintf(stderr, "Could not create \"%s\"\n", outFile);
+        AB_Banking_Fini(ab);
+        AB_Banking_free(ab);
+        return 2;
+      }
+    }
+
+    for (bc=_benchCases; bc->name; bc++) {
+      if (profilesOnly) {
+        if (caseName==NULL || strcasecmp(caseName, bc->name)==0) {
+          if (_runProfileCase(ab, bc, repeat, f)<0)
+            errors++;
+        }
+      }
+      else if (caseName==NULL || strcasecmp(caseName, bc->name)==0) {
+        for (i=0; i<sizeCount; i++) {
+          if (_runCase(ab, bc, sizes[i], repeat, seed, f)<0)
+            errors++;
+        }
+      }
+    }
+
+    if (f!=stdout)
+      fclose(f);
+  }
+
+  rv=AB_Banking_Fini(ab);
+  if (rv) {
+    fprintf(stderr, "Could not deinit AqBanking (%d)\n", rv);
+    errors++;
+  }
+  AB_Banking_free(ab);
+
+  if (errors) {
+    fprintf(stderr, "%d benchmark(s) failed.\n", errors);
+    return 2;
+  }
+  return 0;
+}
+
+
+
+int _runCase(AB_BANKING *ab, const BENCH_CASE *bc, int size, int repeat, uint32_t seed, FILE *f)
+{
+  BENCH_RUN run;
+  BENCH_RESULT res;
+  int rv;
+  int errors=0;
+
+  memset(&run, 0, sizeof(run));
+  memset(&res, 0, sizeof(res));
+  run.banking=ab;
+  run.benchCase=bc;
+
+  run.dbProfile=AB_Banking_GetImExporterProfile(ab, bc->imExporterName, bc->profileName);
+  if (run.dbProfile==NULL) {
+    /* plugin not compiled in or profile missing */
+    res.result=GWEN_ERROR_NOT_AVAILABLE;
+    _writeResult(f, bc, "none", size, seed, &res);
+    return 0;
+  }
+
+  run.sourceContext=BenchGen_CreateContext(bc->dataType, size, seed);
+  run.inputBuffer=GWEN_Buffer_new(0, 1024, 0, 1);
+  rv=_createInput(ab, bc, run.sourceContext, run.inputBuffer);
+  if (rv<0) {
+    fprintf(stderr, "%s: Error creating input data (%d)\n", bc->name, rv);
+    res.result=rv;
+    _writeResult(f, bc, "generate", size, seed, &res);
+    errors++;
+  }
+  else {
+    if (bc->flags & BENCH_FLAGS_IMPORT) {
+      _measure(_runImport, &run, repeat, &res);
+      _writeResult(f, bc, "import", size, seed, &res);
+      if (res.result<0)
+        errors++;
+    }
+
+    if (bc->flags & BENCH_FLAGS_IMPORT_STREAM) {
+      memset(&res, 0, sizeof(res));
+      _measure(_runImportStream, &run, repeat, &res);
+      _writeResult(f, bc, "import-stream", size, seed, &res);
+      if (res.result<0)
+        errors++;
+    }
+
+    if (bc->flags & BENCH_FLAGS_EXPORT) {
+      memset(&res, 0, sizeof(res));
+      _measure(_runExport, &run, repeat, &res);
+      _writeResult(f, bc, "export", size, seed, &res);
+      if (res.result<0)
+        errors++;
+    }
+  }
+
+  GWEN_Buffer_free(run.inputBuffer);
+  AB_ImExporterContext_free(run.sourceContext);
+  GWEN_DB_Group_free(run.dbProfile);
+  fflush(f);
+
+  return errors?GWEN_ERROR_GENERIC:0;
+}
+
+
+
+int _runProfileCase(AB_BANKING *ab, const BENCH_CASE *bc, int repeat, FILE *f)
+{
+  BENCH_RUN run;
+  BENCH_RESULT resScan;
+  BENCH_RESULT resCache;
+
+  memset(&run, 0, sizeof(run));
+  memset(&resScan, 0, sizeof(resScan));
+  memset(&resCache, 0, sizeof(resCache));
+  run.banking=ab;
+  run.benchCase=bc;
+
+  /* read all profiles for every lookup */
+  AB_Banking_RuntimeConfig_SetIntValue(ab, "noProfileCache", 1);
+  _measure(_runGetProfile, &run, repeat, &resScan);
+  _writeResult(f, bc, "profile-scan", 0, 0, &resScan);
+
+  /* use the profile registry, the first lookup (re-)creates it if needed */
+  AB_Banking_RuntimeConfig_SetIntValue(ab, "noProfileCache", 0);
+  _runGetProfile(&run);
+  _measure(_runGetProfile, &run, repeat, &resCache);
+  _writeResult(f, bc, "profile-cache", 0, 0, &resCache);
+  fflush(f);
+
+  if (resScan.result==GWEN_ERROR_NOT_AVAILABLE)
+    /* plugin not compiled in or profile missing */
+    return 0;
+  if (resScan.result<0 || resCache.result<0)
+    return GWEN_ERROR_GENERIC;
+
+  fprintf(stderr, "%s: profile lookup %.3f ms -> %.3f ms (saved %.3f ms)\n",
+          bc->name, resScan.wallMsAvg, resCache.wallMsAvg, resScan.wallMsAvg-resCache.wallMsAvg);
+  return 0;
+}
+
+
+
+int _createInput(AB_BANKING *ab, const BENCH_CASE *bc, AB_IMEXPORTER_CONTEXT *ctx, GWEN_BUFFER *buf)
+{
+  GWEN_DB_NODE *dbProfile;
+  int rv;
+
+  if (bc->writeFn)
+    return bc->writeFn(ctx, buf);
+
+  dbProfile=AB_Banking_GetImExporterProfile(ab, bc->imExporterName, bc->profileName);
+  if (dbProfile==NULL)
+    return GWEN_ERROR_NOT_AVAILABLE;
+  rv=AB_Banking_ExportToBuffer(ab, bc->imExporterName, ctx, buf, dbProfile);
+  GWEN_DB_Group_free(dbProfile);
+  return rv;
+}
+
+
+
+int _generateFile(AB_BANKING *ab, const char *caseName, int size, uint32_t seed, const char *fileName)
+{
+  const BENCH_CASE *bc;
+  AB_IMEXPORTER_CONTEXT *ctx;
+  GWEN_BUFFER *buf;
+  FILE *f;
+  int rv;
+
+  bc=_findCase(caseName);
+  if (bc==NULL) {
+    fprintf(stderr, "Unknown case \"%s\"\n", caseName);
+    return GWEN_ERROR_NOT_FOUND;
+  }
+
+  ctx=BenchGen_CreateContext(bc->dataType, size, seed);
+  buf=GWEN_Buffer_new(0, 1024, 0, 1);
+  rv=_createInput(ab, bc, ctx, buf);
+  AB_ImExporterContext_free(ctx);
+  if (rv<0) {
+    fprintf(stderr, "Error creating input data (%d)\n", rv);
+    GWEN_Buffer_free(buf);
+    return rv;
+  }
+
+  f=fopen(fileName, "wb");
+  if (f==NULL || fwrite(GWEN_Buffer_GetStart(buf), GWEN_Buffer_GetUsedBytes(buf), 1, f)!=1) {
+    fprintf(stderr, "Could not write \"%s\"\n", fileName);
+    if (f)
+      fclose(f);
+    GWEN_Buffer_free(buf);
+    return GWEN_ERROR_IO;
+  }
+  fclose(f);
+  GWEN_Buffer_free(buf);
+  return 0;
+}
+
+
+
+int _runImport(BENCH_RUN *run)
+{
+  int rv;
+
+  run->importContext=AB_ImExporterContext_new();
+  rv=AB_Banking_ImportFromBuffer(run->banking, run->benchCase->imExporterName, run->importContext,
+                                 (const uint8_t *) GWEN_Buffer_GetStart(run->inputBuffer),
+                                 GWEN_Buffer_GetUsedBytes(run->inputBuffer),
+                                 run->dbProfile);
+  if (rv<0)
+    return rv;
+  run->transactions=_countTransactions(run->importContext);
+  return 0;
+}
+
+
+
+int _runImportStream(BENCH_RUN *run)
+{
+  GWEN_BUFFER *buf;
+  GWEN_SYNCIO *sio;
+  int rv;
+
+  run->importContext=AB_ImExporterContext_new();
+  run->transactions=0;
+
+  buf=GWEN_Buffer_new(GWEN_Buffer_GetStart(run->inputBuffer),
+                      GWEN_Buffer_GetUsedBytes(run->inputBuffer),
+                      GWEN_Buffer_GetUsedBytes(run->inputBuffer), 0);
+  GWEN_Buffer_SetMode(buf, GWEN_BUFFER_MODE_READONLY);
+  sio=GWEN_SyncIo_Memory_new(buf, 0);
+  rv=AB_Banking_ImportWithTransactionFn(run->banking, run->benchCase->imExporterName, run->importContext,
+                                        sio, run->dbProfile, _countTransactionsCb, run);
+  GWEN_SyncIo_free(sio);
+  GWEN_Buffer_free(buf);
+  return rv;
+}
+
+
+
+int _runExport(BENCH_RUN *run)
+{
+  run->outputBuffer=GWEN_Buffer_new(0, 1024, 0, 1);
+  run->transactions=_countTransactions(run->sourceContext);
+  return AB_Banking_ExportToBuffer(run->banking, run->benchCase->imExporterName, run->sourceContext,
+                                   run->outputBuffer, run->dbProfile);
+}
+
+
+
+int _runGetProfile(BENCH_RUN *run)
+{
+  GWEN_DB_NODE *dbProfile;
+
+  run->transactions=0;
+  dbProfile=AB_Banking_GetImExporterProfile(run->banking, run->benchCase->imExporterName, run->benchCase->profileName);
+  if (dbProfile==NULL)
+    return GWEN_ERROR_NOT_AVAILABLE;
+  GWEN_DB_Group_free(dbProfile);
+  return 0;
+}
+
+
+
+void _cleanupRun(BENCH_RUN *run)
+{
+  AB_ImExporterContext_free(run->importContext);
+  run->importContext=NULL;
+  GWEN_Buffer_free(run->outputBuffer);
+  run->outputBuffer=NULL;
+}
+
+
+
+int _countTransactionsCb(AB_IMEXPORTER_ACCOUNTINFO *ai, AB_TRANSACTION *t, void *user_data)
+{
+  BENCH_RUN *run;
+
+  run=(BENCH_RUN *) user_data;
+  run->transactions++;
+  return 0;
+}
+
+
+
+int _countTransactions(const AB_IMEXPORTER_CONTEXT *ctx)
+{
+  AB_IMEXPORTER_ACCOUNTINFO_LIST *ail;
+  const AB_IMEXPORTER_ACCOUNTINFO *ai;
+  int count=0;
+
+  ail=AB_ImExporterContext_GetAccountInfoList(ctx);
+  ai=ail?AB_ImExporterAccountInfo_List_First(ail):NULL;
+  while (ai) {
+    AB_TRANSACTION_LIST *tl;
+
+    tl=AB_ImExporterAccountInfo_GetTransactionList(ai);
+    if (tl)
+      count+=AB_Transaction_List_GetCount(tl);
+    ai=AB_ImExporterAccountInfo_List_Next(ai);
+  }
+
+  return count;
+}
+
+
+
+void _measure(BENCH_RUN_FN fn, BENCH_RUN *run, int repeat, BENCH_RESULT *res)
+{
+  double sum=0.0;
+  int i;
+
+  for (i=0; i<repeat; i++) {
+    long long allocsBefore=0;
+    long rssBefore=0;
+    double tStart;
+    double tElapsed;
+    int rv;
+
+    if (i==0) {
+      /* memory figures are taken from the first run */
+      _resetPeakRss();
+      rssBefore=_readProcStatusKb("VmRSS:");
+      allocsBefore=_getAllocCount();
+    }
+
+    tStart=_now();
+    rv=fn(run);
+    tElapsed=_now()-tStart;
+
+    if (i==0) {
+      res->allocs=(allocsBefore<0)?-1:(_getAllocCount()-allocsBefore);
+      res->peakRssKb=_getPeakRssKb();
+      res->rssGrowthKb=(rssBefore>0 && res->peakRssKb>rssBefore)?(res->peakRssKb-rssBefore):0;
+      res->transactions=run->transactions;
+      if (run->outputBuffer)
+        res->bytes=GWEN_Buffer_GetUsedBytes(run->outputBuffer);
+      else if (run->inputBuffer)
+        res->bytes=GWEN_Buffer_GetUsedBytes(run->inputBuffer);
+    }
+    _cleanupRun(run);
+
+    if (rv<0) {
+      fprintf(stderr, "%s: Error in benchmark run (%d)\n", run->benchCase->name, rv);
+      res->result=rv;
+      return;
+    }
+
+    sum+=tElapsed;
+    if (i==0 || tElapsed<res->wallMsMin)
+      res->wallMsMin=tElapsed;
+  }
+
+  res->wallMsAvg=sum/repeat;
+  res->result=0;
+}
+
+
+
+void _writeResult(FILE *f, const BENCH_CASE *bc, const char *op, int size, uint32_t seed, const BENCH_RESULT *res)
+{
+  const char *status;
+
+  if (res->result==GWEN_ERROR_NOT_AVAILABLE)
+    status="unavailable";
+  else if (res->result<0)
+    status="error";
+  else
+    status="ok";
+
+  fprintf(f,
+          "{\"version\":\"%s\",\"case\":\"%s\",\"imexporter\":\"%s\",\"profile\":\"%s\",\"op\":\"%s\","
+          "\"size\":%d,\"seed\":%u,\"status\":\"%s\",\"result\":%d",
+          AQBANKING_VERSION_FULL_STRING, bc->name, bc->imExporterName, bc->profileName, op,
+          size, (unsigned int) seed, status, res->result);
+  if (res->result==0) {
+    fprintf(f,
+            ",\"transactions\":%d,\"bytes\":%lu,\"wall_ms_min\":%.3f,\"wall_ms_avg\":%.3f,"
+            "\"peak_rss_kb\":%ld,\"rss_growth_kb\":%ld,\"allocs\":%lld,\"allocs_per_transaction\":%.2f",
+            res->transactions, (unsigned long) res->bytes, res->wallMsMin, res->wallMsAvg,
+            res->peakRssKb, res->rssGrowthKb, res->allocs,
+            (res->allocs>=0 && res->transactions>0)?((double) res->allocs/res->transactions):-1.0);
+  }
+  fprintf(f, "}\n");
+}
+
+
+
+double _now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (ts.tv_sec*1000.0)+(ts.tv_nsec/1000000.0);
+}
+
+
+
+void _resetPeakRss(void)
+{
+  FILE *f;
+
+  /* Linux: writing "5" resets the peak RSS (VmHWM) of the process */
+  f=fopen("/proc/self/clear_refs", "w");
+  if (f) {
+    fputs("5", f);
+    fclose(f);
+  }
+}
+
+
+
+long _readProcStatusKb(const char *key)
+{
+  FILE *f;
+  char line[256];
+  long value=-1;
+  int keyLen;
+
+  f=fopen("/proc/self/status", "r");
+  if (f==NULL)
+    return -1;
+
+  keyLen=strlen(key);
+  while (fgets(line, sizeof(line), f)) {
+    if (strncmp(line, key, keyLen)==0) {
+      value=strtol(line+keyLen, NULL, 10);
+      break;
+    }
+  }
+  fclose(f);
+  return value;
+}
+
+
+
+long _getPeakRssKb(void)
+{
+  struct rusage ru;
+  long kb;
+
+  kb=_readProcStatusKb("VmHWM:");
+  if (kb>=0)
+    return kb;
+
+  /* no procfs: peak RSS of the whole process */
+  if (getrusage(RUSAGE_SELF, &ru)==0)
+    return ru.ru_maxrss;
+  return -1;
+}
+
+
+
+const BENCH_CASE *_findCase(const char *name)
+{
+  const BENCH_CASE *bc;
+
+  for (bc=_benchCases; bc->name; bc++) {
+    if (strcasecmp(name, bc->name)==0)
+      return bc;
+  }
+  return NULL;
+}
+
+
+
+int _parseSizes(const char *s, int *sizes, int maxSizes)
+{
+  int count=0;
+
+  while (s && *s && count<maxSizes) {
+    char *end;
+    long v;
+
+    v=strtol(s, &end, 10);
+    if (end==s || v<0)
+      return -1;
+    sizes[count++]=(int) v;
+    s=end;
+    if (*s==',')
+      s++;
+  }
+
+  return count;
+}
+
+
+
+void _usage(const char *prgName)
+{
+  fprintf(stderr,
+          "Usage: %s [OPTIONS]\n"
+          " -s, --sizes LIST    comma separated numbers of transactions (default: %s)\n"
+          " -r, --repeat N      number of runs per benchmark, minimum and average time are reported (default: %d)\n"
+          "     --seed N        seed for the data generator\n"
+          " -c, --case NAME     only run the given case\n"
+          " -l, --list          list all cases\n"
+          " -o FILE             write results (one JSON object per line) to FILE instead of stdout\n"
+          "     --profiles      only measure the lookup of the profile of every case with and without profile registry\n"
+          " -g, --generate NAME only write the input data of the given case for the first size to the file given by -o\n",
+          prgName, BENCH_DEFAULT_SIZES, BENCH_DEFAULT_REPEAT);
+}
+
+
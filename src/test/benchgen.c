@@ -0,0 +1,686 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+
+#include "benchgen.h"
+
+#include <gwenhywfar/gwendate.h>
+#include <gwenhywfar/error.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+
+
+#define BENCHGEN_DEFAULT_SEED    0x2545f491
+#define BENCHGEN_LOCAL_BANKCODE  "12030000"
+#define BENCHGEN_LOCAL_ACCOUNT   "1234567890"
+#define BENCHGEN_LOCAL_BIC       "BYLADEM1001"
+#define BENCHGEN_LOCAL_NAME      "Benchmark Account Holder"
+#define BENCHGEN_CREDITOR_ID     "DE98ZZZ09999999999"
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * forward declarations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+static uint32_t _nextRandom(uint32_t *pState);
+static AB_TRANSACTION *_createTransaction(BENCHGEN_DATATYPE dt, int idx, int count, int baseJulian, uint32_t *pState);
+static void _setDateFromJulian(AB_TRANSACTION *t, int julian, int valuta);
+static AB_BALANCE *_createBalance(int julian, long long cents);
+static long long _valueToCents(const AB_VALUE *v);
+static void _appendAmount(GWEN_BUFFER *buf, long long cents, char decimalMark);
+static void _appendDate(GWEN_BUFFER *buf, const GWEN_DATE *dt, int fourDigitYear);
+static int _getPurposeLine(const char *purpose, int idx, char *buffer, int size);
+static const AB_IMEXPORTER_ACCOUNTINFO *_getAccountInfo(const AB_IMEXPORTER_CONTEXT *ctx);
+static void _appendFixed(GWEN_BUFFER *buf, const char *s, int len, char filler, int alignRight);
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * static data
+ * ------------------------------------------------------------------------------------------------
+ */
+
+static const char *_firstNames[]= {
+  "Anna", "Bernd", "Claudia", "Dieter", "Elke", "Frank", "Gisela", "Hans", "Ines", "Jens",
+  "Karin", "Lars", "Monika", "Norbert", "Olga", "Peter", "Renate", "Stefan", "Tanja", "Uwe"
+};
+
+static const char *_lastNames[]= {
+  "Mueller", "Schmidt", "Schneider", "Fischer", "Weber", "Meyer", "Wagner", "Becker",
+  "Schulz", "Hoffmann", "Koch", "Richter", "Klein", "Wolf", "Neumann", "Schwarz"
+};
+
+static const char *_purposeWords[]= {
+  "Invoice", "Rent", "Salary", "Insurance", "Contract", "Order", "Refund", "Membership",
+  "Electricity", "Phone", "Subscription", "Tax", "Deposit", "Fee", "Payment", "Reference"
+};
+
+static const char *_bankCodes[]= {
+  "10010010", "20050550", "37040044", "50010517", "60050101", "70020270", "76050101", "43060967"
+};
+
+static const char *_bics[]= {
+  "PBNKDEFFXXX", "HASPDEHHXXX", "COBADEFFXXX", "INGDDEFFXXX", "SOLADESTXXX", "HYVEDEMMXXX",
+  "SSKNDE77XXX", "GENODEM1GLS"
+};
+
+#define BENCHGEN_NUM(a) ((int)(sizeof(a)/sizeof(a[0])))
+
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * implementations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+AB_IMEXPORTER_CONTEXT *BenchGen_CreateContext(BENCHGEN_DATATYPE dt, int count, uint32_t seed)
+{
+  AB_IMEXPORTER_CONTEXT *ctx;
+  AB_IMEXPORTER_ACCOUNTINFO *ai;
+  GWEN_DATE *dtBase;
+  uint32_t state;
+  char iban[40];
+  long long balance;
+  int baseJulian;
+  int i;
+
+  state=seed?seed:BENCHGEN_DEFAULT_SEED;
+
+  dtBase=GWEN_Date_fromGregorian(2026, 1, 1);
+  baseJulian=GWEN_Date_GetJulian(dtBase);
+  GWEN_Date_free(dtBase);
+
+  ctx=AB_ImExporterContext_new();
+  ai=AB_ImExporterAccountInfo_new();
+  BenchGen_MakeIban(BENCHGEN_LOCAL_BANKCODE, BENCHGEN_LOCAL_ACCOUNT, iban, sizeof(iban));
+  AB_ImExporterAccountInfo_SetBankCode(ai, BENCHGEN_LOCAL_BANKCODE);
+  AB_ImExporterAccountInfo_SetAccountNumber(ai, BENCHGEN_LOCAL_ACCOUNT);
+  AB_ImExporterAccountInfo_SetIban(ai, iban);
+  AB_ImExporterAccountInfo_SetBic(ai, BENCHGEN_LOCAL_BIC);
+  AB_ImExporterAccountInfo_SetOwner(ai, BENCHGEN_LOCAL_NAME);
+  AB_ImExporterAccountInfo_SetCurrency(ai, "EUR");
+  AB_ImExporterAccountInfo_SetAccountType(ai, AB_AccountType_Bank);
+  AB_ImExporterContext_AddAccountInfo(ctx, ai);
+
+  balance=100000000; /* 1.000.000,00 */
+  if (dt==BenchGen_DataType_Statements)
+    AB_ImExporterAccountInfo_AddBalance(ai, _createBalance(baseJulian-1, balance));
+
+  for (i=0; i<count; i++) {
+    AB_TRANSACTION *t;
+
+    t=_createTransaction(dt, i, count, baseJulian, &state);
+    balance+=_valueToCents(AB_Transaction_GetValue(t));
+    AB_ImExporterAccountInfo_AddTransaction(ai, t);
+  }
+
+  if (dt==BenchGen_DataType_Statements)
+    AB_ImExporterAccountInfo_AddBalance(ai, _createBalance(baseJulian+365, balance));
+
+  return ctx;
+}
+
+
+
+int BenchGen_WriteMt940(const AB_IMEXPORTER_CONTEXT *ctx, GWEN_BUFFER *buf)
+{
+  const AB_IMEXPORTER_ACCOUNTINFO *ai;
+  const AB_TRANSACTION *t;
+  const AB_BALANCE *bal;
+  long long cents;
+
+  ai=_getAccountInfo(ctx);
+  if (ai==NULL)
+    return GWEN_ERROR_NO_DATA;
+
+  GWEN_Buffer_AppendString(buf, ":20:STARTUMS\r\n");
+  GWEN_Buffer_AppendArgs(buf, ":25:%s/%s\r\n",
+                         AB_ImExporterAccountInfo_GetBankCode(ai),
+                         AB_ImExporterAccountInfo_GetAccountNumber(ai));
+  GWEN_Buffer_AppendString(buf, ":28C:00001/001\r\n");
+
+  bal=AB_Balance_List_First(AB_ImExporterAccountInfo_GetBalanceList(ai));
+  cents=bal?_valueToCents(AB_Balance_GetValue(bal)):0;
+  GWEN_Buffer_AppendString(buf, ":60F:");
+  GWEN_Buffer_AppendByte(buf, (cents<0)?'D':'C');
+  _appendDate(buf, bal?AB_Balance_GetDate(bal):NULL, 0);
+  GWEN_Buffer_AppendString(buf, "EUR");
+  _appendAmount(buf, (cents<0)?-cents:cents, ',');
+  GWEN_Buffer_AppendString(buf, "\r\n");
+
+  t=AB_Transaction_List_First(AB_ImExporterAccountInfo_GetTransactionList(ai));
+  while (t) {
+    const GWEN_DATE *dtValuta;
+    const char *purpose;
+    char line[64];
+    int i;
+
+    cents=_valueToCents(AB_Transaction_GetValue(t));
+    dtValuta=AB_Transaction_GetValutaDate(t);
+
+    /* :61:valuta(YYMMDD) booking date(MMDD) C/D amount type reference */
+    GWEN_Buffer_AppendString(buf, ":61:");
+    _appendDate(buf, dtValuta, 0);
+    GWEN_Buffer_AppendArgs(buf, "%02d%02d",
+                           GWEN_Date_GetMonth(AB_Transaction_GetDate(t)),
+                           GWEN_Date_GetDay(AB_Transaction_GetDate(t)));
+    GWEN_Buffer_AppendByte(buf, (cents<0)?'D':'C');
+    _appendAmount(buf, (cents<0)?-cents:cents, ',');
+    GWEN_Buffer_AppendArgs(buf, "NMSC%s\r\n", AB_Transaction_GetFiId(t));
+
+    /* :86: with structured subfields */
+    GWEN_Buffer_AppendArgs(buf, ":86:%03d?00%s\r\n",
+                           AB_Transaction_GetTextKey(t),
+                           AB_Transaction_GetTransactionText(t));
+    GWEN_Buffer_AppendArgs(buf, "?10%s\r\n", AB_Transaction_GetPrimanota(t));
+    GWEN_Buffer_AppendArgs(buf, "?20EREF+%s\r\n", AB_Transaction_GetEndToEndReference(t));
+    purpose=AB_Transaction_GetPurpose(t);
+    for (i=0; i<8 && _getPurposeLine(purpose, i, line, sizeof(line))>=0; i++)
+      GWEN_Buffer_AppendArgs(buf, "?%02d%s\r\n", 21+i, line);
+    GWEN_Buffer_AppendArgs(buf, "?30%s\r\n", AB_Transaction_GetRemoteBic(t));
+    GWEN_Buffer_AppendArgs(buf, "?31%s\r\n", AB_Transaction_GetRemoteIban(t));
+    GWEN_Buffer_AppendArgs(buf, "?32%s\r\n", AB_Transaction_GetRemoteName(t));
+
+    t=AB_Transaction_List_Next(t);
+  }
+
+  bal=AB_Balance_List_Last(AB_ImExporterAccountInfo_GetBalanceList(ai));
+  cents=bal?_valueToCents(AB_Balance_GetValue(bal)):0;
+  GWEN_Buffer_AppendString(buf, ":62F:");
+  GWEN_Buffer_AppendByte(buf, (cents<0)?'D':'C');
+  _appendDate(buf, bal?AB_Balance_GetDate(bal):NULL, 0);
+  GWEN_Buffer_AppendString(buf, "EUR");
+  _appendAmount(buf, (cents<0)?-cents:cents, ',');
+  GWEN_Buffer_AppendString(buf, "\r\n-\r\n");
+
+  return 0;
+}
+
+
+
+int BenchGen_WriteOfx(const AB_IMEXPORTER_CONTEXT *ctx, GWEN_BUFFER *buf)
+{
+  const AB_IMEXPORTER_ACCOUNTINFO *ai;
+  const AB_TRANSACTION *t;
+  const AB_BALANCE *bal;
+  long long cents;
+
+  ai=_getAccountInfo(ctx);
+  if (ai==NULL)
+    return GWEN_ERROR_NO_DATA;
+
+  GWEN_Buffer_AppendString(buf,
+                           "OFXHEADER:100\r\n"
+                           "DATA:OFXSGML\r\n"
+                           "VERSION:102\r\n"
+                           "SECURITY:NONE\r\n"
+                           "ENCODING:USASCII\r\n"
+                           "CHARSET:1252\r\n"
+                           "COMPRESSION:NONE\r\n"
+                           "OLDFILEUID:NONE\r\n"
+                           "NEWFILEUID:NONE\r\n"
+                           "\r\n"
+                           "<OFX>\r\n"
+                           "<SIGNONMSGSRSV1><SONRS>\r\n"
+                           "<STATUS><CODE>0<SEVERITY>INFO</STATUS>\r\n"
+                           "<DTSERVER>20260101120000<LANGUAGE>ENG\r\n"
+                           "</SONRS></SIGNONMSGSRSV1>\r\n"
+                           "<BANKMSGSRSV1><STMTTRNRS><TRNUID>1\r\n"
+                           "<STATUS><CODE>0<SEVERITY>INFO</STATUS>\r\n"
+                           "<STMTRS><CURDEF>EUR\r\n");
+  GWEN_Buffer_AppendArgs(buf,
+                         "<BANKACCTFROM><BANKID>%s<ACCTID>%s<ACCTTYPE>CHECKING</BANKACCTFROM>\r\n",
+                         AB_ImExporterAccountInfo_GetBankCode(ai),
+                         AB_ImExporterAccountInfo_GetAccountNumber(ai));
+  GWEN_Buffer_AppendString(buf, "<BANKTRANLIST><DTSTART>20260101<DTEND>20261231\r\n");
+
+  t=AB_Transaction_List_First(AB_ImExporterAccountInfo_GetTransactionList(ai));
+  while (t) {
+    char line[64];
+
+    cents=_valueToCents(AB_Transaction_GetValue(t));
+    GWEN_Buffer_AppendArgs(buf, "<STMTTRN><TRNTYPE>%s<DTPOSTED>", (cents<0)?"DEBIT":"CREDIT");
+    _appendDate(buf, AB_Transaction_GetDate(t), 1);
+    GWEN_Buffer_AppendString(buf, "<DTAVAIL>");
+    _appendDate(buf, AB_Transaction_GetValutaDate(t), 1);
+    GWEN_Buffer_AppendString(buf, "<TRNAMT>");
+    if (cents<0) {
+      GWEN_Buffer_AppendByte(buf, '-');
+      cents=-cents;
+    }
+    _appendAmount(buf, cents, '.');
+    GWEN_Buffer_AppendArgs(buf, "<FITID>%s<NAME>%s",
+                           AB_Transaction_GetFiId(t),
+                           AB_Transaction_GetRemoteName(t));
+    if (_getPurposeLine(AB_Transaction_GetPurpose(t), 0, line, sizeof(line))>=0)
+      GWEN_Buffer_AppendArgs(buf, "<MEMO>%s", line);
+    GWEN_Buffer_AppendString(buf, "</STMTTRN>\r\n");
+    t=AB_Transaction_List_Next(t);
+  }
+  GWEN_Buffer_AppendString(buf, "</BANKTRANLIST>\r\n");
+
+  bal=AB_Balance_List_Last(AB_ImExporterAccountInfo_GetBalanceList(ai));
+  cents=bal?_valueToCents(AB_Balance_GetValue(bal)):0;
+  GWEN_Buffer_AppendString(buf, "<LEDGERBAL><BALAMT>");
+  if (cents<0) {
+    GWEN_Buffer_AppendByte(buf, '-');
+    cents=-cents;
+  }
+  _appendAmount(buf, cents, '.');
+  GWEN_Buffer_AppendString(buf, "<DTASOF>");
+  _appendDate(buf, bal?AB_Balance_GetDate(bal):NULL, 1);
+  GWEN_Buffer_AppendString(buf,
+                           "</LEDGERBAL>\r\n"
+                           "</STMTRS></STMTTRNRS></BANKMSGSRSV1>\r\n"
+                           "</OFX>\r\n");
+
+  return 0;
+}
+
+
+
+int BenchGen_WriteEri2(const AB_IMEXPORTER_CONTEXT *ctx, GWEN_BUFFER *buf)
+{
+  const AB_IMEXPORTER_ACCOUNTINFO *ai;
+  const AB_TRANSACTION *t;
+  const char *localAccount;
+
+  ai=_getAccountInfo(ctx);
+  if (ai==NULL)
+    return GWEN_ERROR_NO_DATA;
+  localAccount=AB_ImExporterAccountInfo_GetAccountNumber(ai);
+
+  /* records have 128 bytes, every transaction consists of a record type 1 and 2 (codes "2" and "3") */
+  t=AB_Transaction_List_First(AB_ImExporterAccountInfo_GetTransactionList(ai));
+  while (t) {
+    const char *purpose;
+    char line[64];
+    char amount[16];
+    long long cents;
+
+    cents=_valueToCents(AB_Transaction_GetValue(t));
+    snprintf(amount, sizeof(amount), "%013lld", (cents<0)?-cents:cents);
+
+    /* record type 1 */
+    _appendFixed(buf, localAccount, 10, '0', 1);
+    GWEN_Buffer_AppendString(buf, "EUR99999999992");
+    GWEN_Buffer_AppendString(buf, "001" "00100" "0" "00100");
+    _appendFixed(buf, AB_Transaction_GetRemoteAccountNumber(t), 10, '0', 1);
+    _appendFixed(buf, AB_Transaction_GetRemoteName(t), 24, ' ', 0);
+    GWEN_Buffer_AppendString(buf, "0");
+    GWEN_Buffer_AppendString(buf, amount);
+    GWEN_Buffer_AppendByte(buf, (cents<0)?'D':'C');
+    _appendDate(buf, AB_Transaction_GetDate(t), 0);
+    _appendDate(buf, AB_Transaction_GetValutaDate(t), 0);
+    GWEN_Buffer_AppendString(buf, "0000" "99999");
+    _appendFixed(buf, AB_Transaction_GetEndToEndReference(t), 16, ' ', 0);
+    GWEN_Buffer_AppendString(buf, "99" "  " "\r\n");
+
+    /* record type 2 */
+    purpose=AB_Transaction_GetPurpose(t);
+    _appendFixed(buf, localAccount, 10, '0', 1);
+    GWEN_Buffer_AppendString(buf, "EUR99999999993");
+    _appendFixed(buf, AB_Transaction_GetFiId(t), 29, ' ', 0);
+    GWEN_Buffer_AppendString(buf, "   ");
+    _appendFixed(buf, (_getPurposeLine(purpose, 0, line, sizeof(line))>=0)?line:"", 32, ' ', 0);
+    _appendFixed(buf, (_getPurposeLine(purpose, 1, line, sizeof(line))>=0)?line:"", 32, ' ', 0);
+    GWEN_Buffer_AppendString(buf, "0" "       " "\r\n");
+
+    t=AB_Transaction_List_Next(t);
+  }
+
+  return 0;
+}
+
+
+
+int BenchGen_WriteQ43(const AB_IMEXPORTER_CONTEXT *ctx, GWEN_BUFFER *buf)
+{
+  const AB_IMEXPORTER_ACCOUNTINFO *ai;
+  const AB_TRANSACTION *t;
+  int records=0;
+
+  ai=_getAccountInfo(ctx);
+  if (ai==NULL)
+    return GWEN_ERROR_NO_DATA;
+
+  /* records have 80 bytes */
+  t=AB_Transaction_List_First(AB_ImExporterAccountInfo_GetTransactionList(ai));
+  GWEN_Buffer_AppendString(buf, "000000");
+  _appendDate(buf, t?AB_Transaction_GetDate(t):NULL, 0);
+  _appendFixed(buf, "", 68, ' ', 0);
+  GWEN_Buffer_AppendString(buf, "\r\n");
+
+  GWEN_Buffer_AppendString(buf, "11");
+  _appendFixed(buf, AB_ImExporterAccountInfo_GetBankCode(ai), 8, '0', 1);
+  _appendFixed(buf, AB_ImExporterAccountInfo_GetAccountNumber(ai), 10, '0', 1);
+  _appendFixed(buf, "", 27, ' ', 0);
+  GWEN_Buffer_AppendString(buf, "978");
+  _appendFixed(buf, "", 30, ' ', 0);
+  GWEN_Buffer_AppendString(buf, "\r\n");
+  records++;
+
+  t=AB_Transaction_List_First(AB_ImExporterAccountInfo_GetTransactionList(ai));
+  while (t) {
+    const char *purpose;
+    char line[64];
+    char amount[16];
+    long long cents;
+
+    cents=_valueToCents(AB_Transaction_GetValue(t));
+    snprintf(amount, sizeof(amount), "%014lld", (cents<0)?-cents:cents);
+
+    GWEN_Buffer_AppendString(buf, "22" "    " "0000");
+    _appendDate(buf, AB_Transaction_GetDate(t), 0);
+    _appendDate(buf, AB_Transaction_GetValutaDate(t), 0);
+    GWEN_Buffer_AppendString(buf, "00000");
+    GWEN_Buffer_AppendByte(buf, (cents<0)?'1':'2');
+    GWEN_Buffer_AppendString(buf, amount);
+    _appendFixed(buf, AB_Transaction_GetFiId(t), 38, ' ', 0);
+    GWEN_Buffer_AppendString(buf, "\r\n");
+    records++;
+
+    purpose=AB_Transaction_GetPurpose(t);
+    GWEN_Buffer_AppendString(buf, "2301");
+    _appendFixed(buf, (_getPurposeLine(purpose, 0, line, sizeof(line))>=0)?line:"", 38, ' ', 0);
+    _appendFixed(buf, (_getPurposeLine(purpose, 1, line, sizeof(line))>=0)?line:"", 38, ' ', 0);
+    GWEN_Buffer_AppendString(buf, "\r\n");
+    records++;
+
+    t=AB_Transaction_List_Next(t);
+  }
+
+  GWEN_Buffer_AppendString(buf, "33");
+  _appendFixed(buf, "", 78, ' ', 0);
+  GWEN_Buffer_AppendString(buf, "\r\n");
+  records++;
+
+  GWEN_Buffer_AppendString(buf, "88");
+  _appendFixed(buf, "", 18, '9', 0);
+  GWEN_Buffer_AppendArgs(buf, "%06d", records);
+  _appendFixed(buf, "", 54, ' ', 0);
+  GWEN_Buffer_AppendString(buf, "\r\n");
+
+  return 0;
+}
+
+
+
+uint32_t _nextRandom(uint32_t *pState)
+{
+  uint32_t x;
+
+  /* xorshift32 */
+  x=*pState;
+  x^=x<<13;
+  x^=x>>17;
+  x^=x<<5;
+  *pState=x;
+  return x;
+}
+
+
+
+void BenchGen_MakeIban(const char *bankCode, const char *accountNumber, char *buffer, int size)
+{
+  char tmp[64];
+  const char *p;
+  int rem=0;
+
+  /* BBAN followed by the country code as digits ("DE"=1314) and "00" */
+  snprintf(tmp, sizeof(tmp), "%s%s131400", bankCode, accountNumber);
+  for (p=tmp; *p; p++)
+    rem=((rem*10)+(*p-'0'))%97;
+  snprintf(buffer, size, "DE%02d%s%s", 98-rem, bankCode, accountNumber);
+}
+
+
+
+AB_TRANSACTION *_createTransaction(BENCHGEN_DATATYPE dt, int idx, int count, int baseJulian, uint32_t *pState)
+{
+  AB_TRANSACTION *t;
+  AB_VALUE *v;
+  char localIban[40];
+  char remoteIban[40];
+  char remoteAccount[16];
+  char name[64];
+  char buffer[128];
+  long long cents;
+  int bankIdx;
+  int julian;
+  int lines;
+  int i;
+
+  t=AB_Transaction_new();
+
+  bankIdx=_nextRandom(pState)%BENCHGEN_NUM(_bankCodes);
+  snprintf(remoteAccount, sizeof(remoteAccount), "%010u", (unsigned int)(_nextRandom(pState)%4000000000u));
+  BenchGen_MakeIban(_bankCodes[bankIdx], remoteAccount, remoteIban, sizeof(remoteIban));
+  snprintf(name, sizeof(name), "%s %s",
+           _firstNames[_nextRandom(pState)%BENCHGEN_NUM(_firstNames)],
+           _lastNames[_nextRandom(pState)%BENCHGEN_NUM(_lastNames)]);
+
+  BenchGen_MakeIban(BENCHGEN_LOCAL_BANKCODE, BENCHGEN_LOCAL_ACCOUNT, localIban, sizeof(localIban));
+  AB_Transaction_SetLocalBankCode(t, BENCHGEN_LOCAL_BANKCODE);
+  AB_Transaction_SetLocalAccountNumber(t, BENCHGEN_LOCAL_ACCOUNT);
+  AB_Transaction_SetLocalIban(t, localIban);
+  AB_Transaction_SetLocalBic(t, BENCHGEN_LOCAL_BIC);
+  AB_Transaction_SetLocalName(t, BENCHGEN_LOCAL_NAME);
+
+  AB_Transaction_SetRemoteBankCode(t, _bankCodes[bankIdx]);
+  AB_Transaction_SetRemoteAccountNumber(t, remoteAccount);
+  AB_Transaction_SetRemoteIban(t, remoteIban);
+  AB_Transaction_SetRemoteBic(t, _bics[bankIdx]);
+  AB_Transaction_SetRemoteName(t, name);
+
+  cents=1+(_nextRandom(pState)%250000);
+  if (dt==BenchGen_DataType_Statements && (_nextRandom(pState)%10)<6)
+    cents=-cents;
+  snprintf(buffer, sizeof(buffer), "%s%lld.%02lld:EUR", (cents<0)?"-":"", ((cents<0)?-cents:cents)/100,
+           ((cents<0)?-cents:cents)%100);
+  v=AB_Value_fromString(buffer);
+  AB_Transaction_SetValue(t, v);
+  AB_Value_free(v);
+
+  /* 1-3 purpose lines of up to 27 characters (the limit of most formats) */
+  lines=1+(_nextRandom(pState)%3);
+  for (i=0; i<lines; i++) {
+    snprintf(buffer, sizeof(buffer), "%s %u %s %u",
+             _purposeWords[_nextRandom(pState)%BENCHGEN_NUM(_purposeWords)],
+             (unsigned int)(_nextRandom(pState)%1000000),
+             _purposeWords[_nextRandom(pState)%BENCHGEN_NUM(_purposeWords)],
+             (unsigned int)(_nextRandom(pState)%10000));
+    buffer[27]=0;
+    AB_Transaction_AddPurposeLine(t, buffer);
+  }
+
+  snprintf(buffer, sizeof(buffer), "E2E-%08d", idx+1);
+  AB_Transaction_SetEndToEndReference(t, buffer);
+  snprintf(buffer, sizeof(buffer), "BENCH%010d", idx+1);
+  AB_Transaction_SetFiId(t, buffer);
+
+  /* spread transactions evenly over one year */
+  julian=baseJulian+(int)(((long long)idx*365)/(count>0?count:1));
+
+  switch (dt) {
+  case BenchGen_DataType_Statements:
+    AB_Transaction_SetType(t, AB_Transaction_TypeStatement);
+    _setDateFromJulian(t, julian, 0);
+    _setDateFromJulian(t, julian+(int)(_nextRandom(pState)%3), 1);
+    AB_Transaction_SetTextKey(t, (cents<0)?5:51);
+    AB_Transaction_SetTransactionText(t, (cents<0)?"LASTSCHRIFT":"GUTSCHRIFT");
+    AB_Transaction_SetTransactionKey(t, "MSC");
+    AB_Transaction_SetPrimanota(t, "9310");
+    break;
+
+  case BenchGen_DataType_Transfers:
+    AB_Transaction_SetType(t, AB_Transaction_TypeTransfer);
+    AB_Transaction_SetCommand(t, AB_Transaction_CommandSepaTransfer);
+    break;
+
+  case BenchGen_DataType_DebitNotes:
+    AB_Transaction_SetType(t, AB_Transaction_TypeDebitNote);
+    AB_Transaction_SetCommand(t, AB_Transaction_CommandSepaDebitNote);
+    AB_Transaction_SetCreditorSchemeId(t, BENCHGEN_CREDITOR_ID);
+    snprintf(buffer, sizeof(buffer), "M-%06d", (int)(_nextRandom(pState)%1000000));
+    AB_Transaction_SetMandateId(t, buffer);
+    AB_Transaction_SetSequence(t, (idx%2)?AB_Transaction_SequenceFollowing:AB_Transaction_SequenceOnce);
+    _setDateFromJulian(t, julian, 0);
+    if (1) {
+      GWEN_DATE *dtMandate;
+
+      dtMandate=GWEN_Date_fromJulian(baseJulian-400);
+      AB_Transaction_SetMandateDate(t, dtMandate);
+      GWEN_Date_free(dtMandate);
+    }
+    break;
+  }
+
+  return t;
+}
+
+
+
+void _setDateFromJulian(AB_TRANSACTION *t, int julian, int valuta)
+{
+  GWEN_DATE *dt;
+
+  dt=GWEN_Date_fromJulian(julian);
+  if (valuta)
+    AB_Transaction_SetValutaDate(t, dt);
+  else
+    AB_Transaction_SetDate(t, dt);
+  GWEN_Date_free(dt);
+}
+
+
+
+AB_BALANCE *_createBalance(int julian, long long cents)
+{
+  AB_BALANCE *bal;
+  GWEN_DATE *dt;
+  AB_VALUE *v;
+  char buffer[64];
+  long long absCents;
+
+  absCents=(cents<0)?-cents:cents;
+  snprintf(buffer, sizeof(buffer), "%s%lld.%02lld:EUR", (cents<0)?"-":"", absCents/100, absCents%100);
+  v=AB_Value_fromString(buffer);
+  dt=GWEN_Date_fromJulian(julian);
+
+  bal=AB_Balance_new();
+  AB_Balance_SetType(bal, AB_Balance_TypeBooked);
+  AB_Balance_SetDate(bal, dt);
+  AB_Balance_SetValue(bal, v);
+
+  GWEN_Date_free(dt);
+  AB_Value_free(v);
+  return bal;
+}
+
+
+
+long long _valueToCents(const AB_VALUE *v)
+{
+  double d;
+
+  if (v==NULL)
+    return 0;
+  d=AB_Value_GetValueAsDouble(v)*100.0;
+  return (long long)((d<0)?(d-0.5):(d+0.5));
+}
+
+
+
+void _appendAmount(GWEN_BUFFER *buf, long long cents, char decimalMark)
+{
+  GWEN_Buffer_AppendArgs(buf, "%lld%c%02lld", cents/100, decimalMark, cents%100);
+}
+
+
+
+void _appendDate(GWEN_BUFFER *buf, const GWEN_DATE *dt, int fourDigitYear)
+{
+  if (dt==NULL) {
+    GWEN_Buffer_AppendString(buf, fourDigitYear?"20260101":"260101");
+    return;
+  }
+
+  if (fourDigitYear)
+    GWEN_Buffer_AppendArgs(buf, "%04d", GWEN_Date_GetYear(dt));
+  else
+    GWEN_Buffer_AppendArgs(buf, "%02d", GWEN_Date_GetYear(dt)%100);
+  GWEN_Buffer_AppendArgs(buf, "%02d%02d", GWEN_Date_GetMonth(dt), GWEN_Date_GetDay(dt));
+}
+
+
+
+int _getPurposeLine(const char *purpose, int idx, char *buffer, int size)
+{
+  const char *p;
+  int len;
+
+  if (purpose==NULL)
+    return GWEN_ERROR_NOT_FOUND;
+
+  p=purpose;
+  while (idx>0) {
+    p=strchr(p, '\n');
+    if (p==NULL)
+      return GWEN_ERROR_NOT_FOUND;
+    p++;
+    idx--;
+  }
+
+  len=strcspn(p, "\n");
+  if (len==0 && *p==0)
+    return GWEN_ERROR_NOT_FOUND;
+  if (len>=size)
+    len=size-1;
+  memmove(buffer, p, len);
+  buffer[len]=0;
+  return len;
+}
+
+
+
+const AB_IMEXPORTER_ACCOUNTINFO *_getAccountInfo(const AB_IMEXPORTER_CONTEXT *ctx)
+{
+  AB_IMEXPORTER_ACCOUNTINFO_LIST *ail;
+
+  ail=AB_ImExporterContext_GetAccountInfoList(ctx);
+  return ail?AB_ImExporterAccountInfo_List_First(ail):NULL;
+}
+
+
+
+void _appendFixed(GWEN_BUFFER *buf, const char *s, int len, char filler, int alignRight)
+{
+  int sLen;
+
+  sLen=s?strlen(s):0;
+  if (sLen>len)
+    sLen=len;
+
+  if (alignRight)
+    GWEN_Buffer_FillWithBytes(buf, (unsigned char) filler, len-sLen);
+  if (sLen)
+    GWEN_Buffer_AppendBytes(buf, s, sLen);
+  if (!alignRight)
+    GWEN_Buffer_FillWithBytes(buf, (unsigned char) filler, len-sLen);
+}
+
+
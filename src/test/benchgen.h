@@ -0,0 +1,68 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+/** @file benchgen.h
+ * @short Deterministic generator for synthetic benchmark data.
+ *
+ * All data is derived from a simple pseudo random generator, so the same seed and count always
+ * produce exactly the same context and the same input files.
+ */
+
+
+#ifndef AB_BENCHGEN_H
+#define AB_BENCHGEN_H
+
+
+#include <aqbanking/types/imexporter_context.h>
+
+#include <gwenhywfar/buffer.h>
+
+
+typedef enum {
+  BenchGen_DataType_Statements=0,   /**< booked transactions with balances (bank statements) */
+  BenchGen_DataType_Transfers,      /**< SEPA transfers */
+  BenchGen_DataType_DebitNotes      /**< SEPA direct debits */
+} BENCHGEN_DATATYPE;
+
+
+/**
+ * Function writing an input file in a format for which there is no exporter.
+ * @return 0 if ok, error code otherwise
+ */
+typedef int (*BENCHGEN_WRITE_FN)(const AB_IMEXPORTER_CONTEXT *ctx, GWEN_BUFFER *buf);
+
+
+/**
+ * Create a context with one account info containing the given number of transactions.
+ */
+AB_IMEXPORTER_CONTEXT *BenchGen_CreateContext(BENCHGEN_DATATYPE dt, int count, uint32_t seed);
+
+
+/**
+ * Create a german IBAN with valid check digits from the given bank code and account number (digits only).
+ */
+void BenchGen_MakeIban(const char *bankCode, const char *accountNumber, char *buffer, int size);
+
+
+/** SWIFT MT940 statement */
+int BenchGen_WriteMt940(const AB_IMEXPORTER_CONTEXT *ctx, GWEN_BUFFER *buf);
+
+/** OFX 1.0.2 (SGML) bank statement */
+int BenchGen_WriteOfx(const AB_IMEXPORTER_CONTEXT *ctx, GWEN_BUFFER *buf);
+
+/** Rabobank ERI (mut.asc) */
+int BenchGen_WriteEri2(const AB_IMEXPORTER_CONTEXT *ctx, GWEN_BUFFER *buf);
+
+/** Spanish Norma 43 */
+int BenchGen_WriteQ43(const AB_IMEXPORTER_CONTEXT *ctx, GWEN_BUFFER *buf);
+
+
+#endif
+
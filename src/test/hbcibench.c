@@ -0,0 +1,778 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+/*
+ * End-to-end throughput driver for the aqhbci backend (run via "make bench-hbci").
+ *
+ * Unless an external server is given the synthetic FinTS server (see hbcisrv.h) is started in a child
+ * process. N PIN/TAN users are then created in a fresh configuration directory and set up like a user
+ * would do it with aqhbci-tool4 (system id, accounts, SEPA info). Afterwards every phase (balance, MT940,
+ * CAMT, SEPA transfer) is run for the given number of rounds, each round sending one job per account
+ * via AB_Banking_SendCommands(). One JSON object per phase is written containing dialogs/s, bytes/s,
+ * round latency and the statistics collected by the server.
+ */
+
+
+#include "hbcisrv.h"
+#include "benchgen.h"
+
+#include <aqbanking/banking.h>
+#include <aqbanking/version.h>
+#include <aqbanking/error.h>
+#include <aqbanking/gui/abgui.h>
+#include <aqbanking/types/transaction.h>
+
+#include <gwenhywfar/gui.h>
+#include <gwenhywfar/cgui.h>
+#include <gwenhywfar/buffer.h>
+#include <gwenhywfar/db.h>
+#include <gwenhywfar/url.h>
+#include <gwenhywfar/debug.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdarg.h>
+#include <time.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+
+
+#ifndef HBCISRV_XMLFILE
+# define HBCISRV_XMLFILE "hbci.xml"
+#endif
+
+#define HBCIBENCH_DEFAULT_USERS        2
+#define HBCIBENCH_DEFAULT_ROUNDS       3
+#define HBCIBENCH_DEFAULT_TRANSACTIONS 100
+#define HBCIBENCH_DEFAULT_CONFDIR      "./hbcibench.conf"
+#define HBCIBENCH_PIN                  "12345"
+
+
+
+typedef struct HBCIBENCH HBCIBENCH;
+struct HBCIBENCH {
+  AB_BANKING *banking;
+  const char *bankCode;
+  char serverUrl[128];
+  char statsHost[64];
+  int statsPort;
+  int users;
+  int rounds;
+};
+
+
+typedef struct HBCIBENCH_PHASE HBCIBENCH_PHASE;
+struct HBCIBENCH_PHASE {
+  const char *name;
+  AB_TRANSACTION_COMMAND command;
+  int preferCamt;                 /* set account flag "preferCamtDownload" before running the phase */
+};
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * forward declarations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+static int _startServer(const char *xmlFile, int accounts, int transactions, int latency, pid_t *pPid);
+static void _stopServer(pid_t pid);
+static void _childSignalHandler(int sig);
+
+static int _providerControl(AB_BANKING *ab, const char *cmd, ...);
+static int _setupUsers(HBCIBENCH *hb);
+static int _setupAccounts(HBCIBENCH *hb, int preferCamt);
+
+static int _runPhase(HBCIBENCH *hb, const HBCIBENCH_PHASE *phase, FILE *f);
+static AB_TRANSACTION_LIST2 *_createJobs(HBCIBENCH *hb, const HBCIBENCH_PHASE *phase, int round);
+static void _freeJobs(AB_TRANSACTION_LIST2 *jobList);
+
+static int _httpGet(const char *host, int port, const char *path, GWEN_BUFFER *buf);
+static unsigned long long _readStatsValue(const char *json, const char *name);
+
+static double _now(void);
+static void _usage(const char *prgName);
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * static data
+ * ------------------------------------------------------------------------------------------------
+ */
+
+static const HBCIBENCH_PHASE _benchPhases[]= {
+  {"balance",      AB_Transaction_CommandGetBalance,      0},
+  {"transactions", AB_Transaction_CommandGetTransactions, 0},
+  {"camt",         AB_Transaction_CommandGetTransactions, 1},
+  {"transfer",     AB_Transaction_CommandSepaTransfer,    0},
+  {NULL,           AB_Transaction_CommandNone,            0}
+};
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * implementations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+int main(int argc, char **argv)
+{
+  HBCIBENCH hb;
+  GWEN_GUI *gui;
+  GWEN_DB_NODE *dbPins;
+  const HBCIBENCH_PHASE *phase;
+  const char *xmlFile=HBCISRV_XMLFILE;
+  const char *confDir=HBCIBENCH_DEFAULT_CONFDIR;
+  const char *serverUrl=NULL;
+  const char *phaseName=NULL;
+  const char *outFile=NULL;
+  FILE *f=stdout;
+  struct stat st;
+  pid_t serverPid=0;
+  int accounts=HBCISRV_DEFAULT_ACCOUNTS;
+  int transactions=HBCIBENCH_DEFAULT_TRANSACTIONS;
+  int latency=0;
+  int errors=0;
+  int rv;
+  int i;
+
+  memset(&hb, 0, sizeof(hb));
+  hb.bankCode=HBCISRV_DEFAULT_BANKCODE;
+  hb.users=HBCIBENCH_DEFAULT_USERS;
+  hb.rounds=HBCIBENCH_DEFAULT_ROUNDS;
+
+  for (i=1; i<argc; i++) {
+    const char *s=argv[i];
+
+    if ((strcmp(s, "-u")==0 || strcmp(s, "--users")==0) && i+1<argc)
+      hb.users=atoi(argv[++i]);
+    else if ((strcmp(s, "-a")==0 || strcmp(s, "--accounts")==0) && i+1<argc)
+      accounts=atoi(argv[++i]);
+    else if ((strcmp(s, "-r")==0 || strcmp(s, "--rounds")==0) && i+1<argc)
+      hb.rounds=atoi(argv[++i]);
+    else if ((strcmp(s, "-t")==0 || strcmp(s, "--transactions")==0) && i+1<argc)
+      transactions=atoi(argv[++i]);
+    else if ((strcmp(s, "-l")==0 || strcmp(s, "--latency")==0) && i+1<argc)
+      latency=atoi(argv[++i]);
+    else if ((strcmp(s, "-p")==0 || strcmp(s, "--phase")==0) && i+1<argc)
+      phaseName=argv[++i];
+    else if ((strcmp(s, "-x")==0 || strcmp(s, "--xml")==0) && i+1<argc)
+      xmlFile=argv[++i];
+    else if ((strcmp(s, "-d")==0 || strcmp(s, "--confdir")==0) && i+1<argc)
+      confDir=argv[++i];
+    else if ((strcmp(s, "-b")==0 || strcmp(s, "--bankcode")==0) && i+1<argc)
+      hb.bankCode=argv[++i];
+    else if (strcmp(s, "--server")==0 && i+1<argc)
+      serverUrl=argv[++i];
+    else if (strcmp(s, "-o")==0 && i+1<argc)
+      outFile=argv[++i];
+    else {
+      _usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (hb.users<1 || hb.rounds<1 || accounts<1) {
+    fprintf(stderr, "Number of users, accounts and rounds must be positive\n");
+    return 1;
+  }
+
+  /* users are created from scratch, never touch an existing configuration */
+  if (stat(confDir, &st)==0) {
+    fprintf(stderr, "Configuration folder \"%s\" already exists, please remove it first\n", confDir);
+    return 1;
+  }
+
+  if (serverUrl) {
+    GWEN_URL *url;
+
+    url=GWEN_Url_fromString(serverUrl);
+    if (url==NULL || GWEN_Url_GetServer(url)==NULL) {
+      fprintf(stderr, "Bad server URL \"%s\"\n", serverUrl);
+      GWEN_Url_free(url);
+      return 1;
+    }
+    snprintf(hb.serverUrl, sizeof(hb.serverUrl), "%s", serverUrl);
+    snprintf(hb.statsHost, sizeof(hb.statsHost), "%s", GWEN_Url_GetServer(url));
+    hb.statsPort=GWEN_Url_GetPort(url);
+    GWEN_Url_free(url);
+  }
+  else {
+    rv=_startServer(xmlFile, accounts, transactions, latency, &serverPid);
+    if (rv<0)
+      return 2;
+    snprintf(hb.serverUrl, sizeof(hb.serverUrl), "http://127.0.0.1:%d/", rv);
+    snprintf(hb.statsHost, sizeof(hb.statsHost), "127.0.0.1");
+    hb.statsPort=rv;
+  }
+
+  /* non-interactive GUI, all PINs are taken from the password db */
+  dbPins=GWEN_DB_Group_new("pins");
+  for (i=1; i<=hb.users; i++) {
+    char varName[64];
+
+    snprintf(varName, sizeof(varName), "PIN_%s_user%d", hb.bankCode, i);
+    GWEN_DB_SetCharValue(dbPins, GWEN_DB_FLAGS_OVERWRITE_VARS, varName, HBCIBENCH_PIN);
+  }
+  gui=GWEN_Gui_CGui_new();
+  GWEN_Gui_AddFlags(gui, GWEN_GUI_FLAGS_NONINTERACTIVE);
+  GWEN_Gui_AddFlags(gui, GWEN_GUI_FLAGS_ACCEPTVALIDCERTS);
+  GWEN_Gui_SetPasswordDb(gui, dbPins, 1);
+  GWEN_Gui_SetGui(gui);
+
+  hb.banking=AB_Banking_new("hbcibench", confDir, 0);
+  AB_Gui_Extend(gui, hb.banking);
+  rv=AB_Banking_Init(hb.banking);
+  if (rv) {
+    fprintf(stderr, "Could not init AqBanking (%d)\n", rv);
+    AB_Banking_free(hb.banking);
+    _stopServer(serverPid);
+    return 2;
+  }
+
+  rv=_setupUsers(&hb);
+  if (rv<0) {
+    fprintf(stderr, "Could not setup users (%d)\n", rv);
+    errors++;
+  }
+  else {
+    if (outFile) {
+      f=fopen(outFile, "w");
+      if (f==NULL) {
+        fprintf(stderr, "Could not create \"%s\"\n", outFile);
+        errors++;
+      }
+    }
+
+    for (phase=_benchPhases; f && phase->name; phase++) {
+      if (phaseName==NULL || strcasecmp(phaseName, phase->name)==0) {
+        if (_runPhase(&hb, phase, f)<0)
+          errors++;
+      }
+    }
+
+    if (f && f!=stdout)
+      fclose(f);
+  }
+
+  rv=AB_Banking_Fini(hb.banking);
+  if (rv) {
+    fprintf(stderr, "Could not deinit AqBanking (%d)\n", rv);
+    errors++;
+  }
+  AB_Banking_free(hb.banking);
+  GWEN_Gui_SetGui(NULL);
+  GWEN_Gui_free(gui);
+
+  _stopServer(serverPid);
+
+  if (errors) {
+    fprintf(stderr, "%d phase(s) failed.\n", errors);
+    return 2;
+  }
+  return 0;
+}
+
+
+
+int _startServer(const char *xmlFile, int accounts, int transactions, int latency, pid_t *pPid)
+{
+  AB_BANKING *ab;
+  HBCISRV *srv;
+  pid_t pid;
+  int port;
+  int rv;
+
+  srv=HbciSrv_new();
+  HbciSrv_SetAccountsPerUser(srv, accounts);
+  HbciSrv_SetLatency(srv, latency);
+
+  rv=HbciSrv_LoadDefinitions(srv, xmlFile);
+  if (rv<0) {
+    fprintf(stderr, "Could not load HBCI definitions from \"%s\" (%d)\n", xmlFile, rv);
+    HbciSrv_free(srv);
+    return rv;
+  }
+
+  /* only needed for the camt exporter, uses its own folder to keep the client configuration clean */
+  ab=AB_Banking_new("hbciserver", "./hbciserver.conf", 0);
+  rv=AB_Banking_Init(ab);
+  if (rv==0) {
+    rv=HbciSrv_CreatePayloads(srv, ab, transactions, 0);
+    AB_Banking_Fini(ab);
+  }
+  AB_Banking_free(ab);
+  if (rv<0) {
+    fprintf(stderr, "Could not create transaction data (%d)\n", rv);
+    HbciSrv_free(srv);
+    return rv;
+  }
+
+  /* listen before forking so the client can connect right away */
+  port=HbciSrv_Listen(srv, "127.0.0.1", 0);
+  if (port<0) {
+    fprintf(stderr, "Could not start server (%d)\n", port);
+    HbciSrv_free(srv);
+    return port;
+  }
+
+  fflush(stdout);
+  fflush(stderr);
+  pid=fork();
+  if (pid==-1) {
+    fprintf(stderr, "fork(): %s\n", strerror(errno));
+    HbciSrv_free(srv);
+    return GWEN_ERROR_GENERIC;
+  }
+  else if (pid==0) {
+    struct sigaction sa;
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler=_childSignalHandler;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGINT, SIG_IGN);
+    signal(SIGPIPE, SIG_IGN);
+
+    rv=HbciSrv_Run(srv);
+    HbciSrv_free(srv);
+    _exit((rv<0)?2:0);
+  }
+
+  /* parent: the listening socket now belongs to the child */
+  HbciSrv_free(srv);
+  *pPid=pid;
+  return port;
+}
+
+
+
+void _stopServer(pid_t pid)
+{
+  if (pid>0) {
+    int status;
+
+    kill(pid, SIGTERM);
+    while (waitpid(pid, &status, 0)==-1 && errno==EINTR);
+  }
+}
+
+
+
+void _childSignalHandler(int sig)
+{
+  (void) sig;
+  HbciSrv_Stop();
+}
+
+
+
+int _providerControl(AB_BANKING *ab, const char *cmd, ...)
+{
+  va_list ap;
+  char *argv[32];
+  int argc=0;
+  int rv;
+
+  argv[argc++]=(char *) cmd;
+  va_start(ap, cmd);
+  for (;;) {
+    char *s;
+
+    s=va_arg(ap, char *);
+    if (s==NULL || argc>=31)
+      break;
+    argv[argc++]=s;
+  }
+  va_end(ap);
+  argv[argc]=NULL;
+
+  rv=AB_Banking_ProviderControl(ab, "aqhbci", argc, argv);
+  if (rv!=0) {
+    fprintf(stderr, "Command \"%s\" failed (%d)\n", cmd, rv);
+    return GWEN_ERROR_GENERIC;
+  }
+  return 0;
+}
+
+
+
+int _setupUsers(HBCIBENCH *hb)
+{
+  int rv;
+  int i;
+
+  for (i=1; i<=hb->users; i++) {
+    char userId[32];
+    char userName[32];
+
+    snprintf(userId, sizeof(userId), "user%d", i);
+    snprintf(userName, sizeof(userName), "Bench User %d", i);
+    rv=_providerControl(hb->banking, "adduser",
+                        "-t", "pintan",
+                        "-b", hb->bankCode,
+                        "-u", userId,
+                        "-c", userId,
+                        "-N", userName,
+                        "-s", hb->serverUrl,
+                        "--hbciversion=300",
+                        NULL);
+    if (rv<0)
+      return rv;
+  }
+
+  /* in a fresh configuration the users added above get the unique ids 1..N */
+  for (i=1; i<=hb->users; i++) {
+    char uidBuf[32];
+
+    snprintf(uidBuf, sizeof(uidBuf), "%d", i);
+    rv=_providerControl(hb->banking, "getsysid", "-u", uidBuf, NULL);
+    if (rv==0)
+      rv=_providerControl(hb->banking, "getaccounts", "-u", uidBuf, NULL);
+    if (rv<0)
+      return rv;
+  }
+
+  return _setupAccounts(hb, 0);
+}
+
+
+
+int _setupAccounts(HBCIBENCH *hb, int preferCamt)
+{
+  AB_ACCOUNT_SPEC_LIST *asl=NULL;
+  AB_ACCOUNT_SPEC *as;
+  int rv;
+
+  rv=AB_Banking_GetAccountSpecList(hb->banking, &asl);
+  if (rv<0) {
+    fprintf(stderr, "No accounts (%d)\n", rv);
+    return rv;
+  }
+
+  as=AB_AccountSpec_List_First(asl);
+  while (as) {
+    char aidBuf[32];
+
+    snprintf(aidBuf, sizeof(aidBuf), "%lu", (unsigned long) AB_AccountSpec_GetUniqueId(as));
+    if (preferCamt)
+      rv=_providerControl(hb->banking, "addaccountflags", "-a", aidBuf, "-f", "preferCamtDownload", NULL);
+    else
+      rv=_providerControl(hb->banking, "getaccsepa", "-a", aidBuf, NULL);
+    if (rv<0) {
+      AB_AccountSpec_List_free(asl);
+      return rv;
+    }
+    as=AB_AccountSpec_List_Next(as);
+  }
+  AB_AccountSpec_List_free(asl);
+
+  return 0;
+}
+
+
+
+int _runPhase(HBCIBENCH *hb, const HBCIBENCH_PHASE *phase, FILE *f)
+{
+  GWEN_BUFFER *statsBuf;
+  const char *stats;
+  double msMin=0.0, msMax=0.0, msSum=0.0;
+  double tStart;
+  double wallMs;
+  unsigned long long dialogs;
+  unsigned long long bytes;
+  int jobs=0;
+  int failed=0;
+  int round;
+  int rv;
+
+  if (phase->preferCamt) {
+    rv=_setupAccounts(hb, 1);
+    if (rv<0)
+      return rv;
+  }
+
+  statsBuf=GWEN_Buffer_new(0, 1024, 0, 1);
+  rv=_httpGet(hb->statsHost, hb->statsPort, "/stats?reset=1", statsBuf);
+  if (rv<0) {
+    fprintf(stderr, "Could not reset server statistics (%d)\n", rv);
+    GWEN_Buffer_free(statsBuf);
+    return rv;
+  }
+
+  tStart=_now();
+  for (round=0; round<hb->rounds; round++) {
+    AB_TRANSACTION_LIST2 *jobList;
+    AB_IMEXPORTER_CONTEXT *ctx;
+    double t0, ms;
+
+    jobList=_createJobs(hb, phase, round);
+    if (jobList==NULL) {
+      fprintf(stderr, "Phase \"%s\": no account supports this job\n", phase->name);
+      GWEN_Buffer_free(statsBuf);
+      return GWEN_ERROR_NOT_SUPPORTED;
+    }
+    jobs+=AB_Transaction_List2_GetSize(jobList);
+
+    ctx=AB_ImExporterContext_new();
+    t0=_now();
+    rv=AB_Banking_SendCommands(hb->banking, jobList, ctx);
+    ms=_now()-t0;
+    AB_ImExporterContext_free(ctx);
+    _freeJobs(jobList);
+    if (rv<0) {
+      fprintf(stderr, "Phase \"%s\", round %d: error sending commands (%d)\n", phase->name, round, rv);
+      failed++;
+    }
+
+    msSum+=ms;
+    if (round==0 || ms<msMin)
+      msMin=ms;
+    if (ms>msMax)
+      msMax=ms;
+  }
+  wallMs=_now()-tStart;
+
+  GWEN_Buffer_Reset(statsBuf);
+  rv=_httpGet(hb->statsHost, hb->statsPort, "/stats", statsBuf);
+  if (rv<0) {
+    fprintf(stderr, "Could not read server statistics (%d)\n", rv);
+    GWEN_Buffer_free(statsBuf);
+    return rv;
+  }
+  stats=GWEN_Buffer_GetStart(statsBuf);
+  dialogs=_readStatsValue(stats, "dialogs");
+  bytes=_readStatsValue(stats, "bytesIn")+_readStatsValue(stats, "bytesOut");
+
+  fprintf(f,
+          "{\"version\":\"%s\",\"phase\":\"%s\",\"users\":%d,\"rounds\":%d,\"jobs\":%d,\"failed_rounds\":%d,"
+          "\"wall_ms\":%.3f,\"round_ms_min\":%.3f,\"round_ms_avg\":%.3f,\"round_ms_max\":%.3f,"
+          "\"dialogs\":%llu,\"dialogs_per_s\":%.2f,\"bytes\":%llu,\"bytes_per_s\":%.0f,\"server\":%s}\n",
+          AQBANKING_VERSION_FULL_STRING, phase->name, hb->users, hb->rounds, jobs, failed,
+          wallMs, msMin, msSum/hb->rounds, msMax,
+          dialogs, (wallMs>0.0)?(dialogs*1000.0/wallMs):0.0,
+          bytes, (wallMs>0.0)?(bytes*1000.0/wallMs):0.0,
+          stats);
+  fflush(f);
+  GWEN_Buffer_free(statsBuf);
+
+  return failed?GWEN_ERROR_GENERIC:0;
+}
+
+
+
+AB_TRANSACTION_LIST2 *_createJobs(HBCIBENCH *hb, const HBCIBENCH_PHASE *phase, int round)
+{
+  AB_ACCOUNT_SPEC_LIST *asl=NULL;
+  AB_ACCOUNT_SPEC *as;
+  AB_TRANSACTION_LIST2 *jobList;
+  char remoteIban[40];
+  int rv;
+
+  rv=AB_Banking_GetAccountSpecList(hb->banking, &asl);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return NULL;
+  }
+
+  BenchGen_MakeIban(hb->bankCode, "9999999999", remoteIban, sizeof(remoteIban));
+
+  jobList=AB_Transaction_List2_new();
+  as=AB_AccountSpec_List_First(asl);
+  while (as) {
+    if (AB_AccountSpec_GetTransactionLimitsForCommand(as, phase->command)) {
+      AB_TRANSACTION *j;
+
+      j=AB_Transaction_new();
+      if (phase->command==AB_Transaction_CommandSepaTransfer) {
+        AB_VALUE *v;
+        char purpose[64];
+
+        AB_Banking_FillTransactionFromAccountSpec(j, as);
+        AB_Transaction_SetType(j, AB_Transaction_TypeTransfer);
+        AB_Transaction_SetRemoteName(j, "Bench Recipient");
+        AB_Transaction_SetRemoteIban(j, remoteIban);
+        AB_Transaction_SetRemoteBic(j, HBCISRV_DEFAULT_BIC);
+        v=AB_Value_fromString("1.00:EUR");
+        AB_Transaction_SetValue(j, v);
+        AB_Value_free(v);
+        snprintf(purpose, sizeof(purpose), "Benchmark round %d", round);
+        AB_Transaction_AddPurposeLine(j, purpose);
+      }
+      AB_Transaction_SetUniqueAccountId(j, AB_AccountSpec_GetUniqueId(as));
+      AB_Transaction_SetCommand(j, phase->command);
+      AB_Transaction_List2_PushBack(jobList, j);
+    }
+    as=AB_AccountSpec_List_Next(as);
+  }
+  AB_AccountSpec_List_free(asl);
+
+  if (AB_Transaction_List2_GetSize(jobList)==0) {
+    AB_Transaction_List2_free(jobList);
+    return NULL;
+  }
+  return jobList;
+}
+
+
+
+void _freeJobs(AB_TRANSACTION_LIST2 *jobList)
+{
+  AB_TRANSACTION_LIST2_ITERATOR *it;
+
+  it=AB_Transaction_List2_First(jobList);
+  if (it) {
+    AB_TRANSACTION *t;
+
+    t=AB_Transaction_List2Iterator_Data(it);
+    while (t) {
+      AB_Transaction_free(t);
+      t=AB_Transaction_List2Iterator_Next(it);
+    }
+    AB_Transaction_List2Iterator_free(it);
+  }
+  AB_Transaction_List2_free(jobList);
+}
+
+
+
+int _httpGet(const char *host, int port, const char *path, GWEN_BUFFER *buf)
+{
+  struct addrinfo hints;
+  struct addrinfo *ai=NULL;
+  GWEN_BUFFER *rbuf;
+  char portBuf[16];
+  char req[256];
+  const char *s;
+  int sk;
+  int rv;
+
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family=AF_INET;
+  hints.ai_socktype=SOCK_STREAM;
+  snprintf(portBuf, sizeof(portBuf), "%d", port);
+  rv=getaddrinfo(host, portBuf, &hints, &ai);
+  if (rv!=0 || ai==NULL) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Could not resolve \"%s\": %s", host, gai_strerror(rv));
+    return GWEN_ERROR_NOT_FOUND;
+  }
+
+  sk=socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+  if (sk==-1 || connect(sk, ai->ai_addr, ai->ai_addrlen)==-1) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Could not connect to %s:%d: %s", host, port, strerror(errno));
+    if (sk!=-1)
+      close(sk);
+    freeaddrinfo(ai);
+    return GWEN_ERROR_IO;
+  }
+  freeaddrinfo(ai);
+
+  snprintf(req, sizeof(req), "GET %s HTTP/1.0\r\nHost: %s\r\nConnection: close\r\n\r\n", path, host);
+  if (send(sk, req, strlen(req), 0)<0) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "send(): %s", strerror(errno));
+    close(sk);
+    return GWEN_ERROR_IO;
+  }
+
+  /* the server closes the connection after the response */
+  rbuf=GWEN_Buffer_new(0, 1024, 0, 1);
+  for (;;) {
+    char tbuf[1024];
+    ssize_t n;
+
+    n=recv(sk, tbuf, sizeof(tbuf), 0);
+    if (n<0 && errno==EINTR)
+      continue;
+    if (n<0) {
+      DBG_ERROR(AQBANKING_LOGDOMAIN, "recv(): %s", strerror(errno));
+      GWEN_Buffer_free(rbuf);
+      close(sk);
+      return GWEN_ERROR_IO;
+    }
+    if (n==0)
+      break;
+    GWEN_Buffer_AppendBytes(rbuf, tbuf, (uint32_t) n);
+  }
+  close(sk);
+
+  s=GWEN_Buffer_GetStart(rbuf);
+  if (strncmp(s, "HTTP/1.", 7)!=0 || atoi(s+9)!=200) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Bad response from server");
+    GWEN_Buffer_free(rbuf);
+    return GWEN_ERROR_BAD_DATA;
+  }
+  s=strstr(s, "\r\n\r\n");
+  if (s==NULL) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Incomplete response from server");
+    GWEN_Buffer_free(rbuf);
+    return GWEN_ERROR_BAD_DATA;
+  }
+  GWEN_Buffer_AppendString(buf, s+4);
+  GWEN_Buffer_free(rbuf);
+
+  return 0;
+}
+
+
+
+unsigned long long _readStatsValue(const char *json, const char *name)
+{
+  char key[64];
+  const char *s;
+
+  /* only used for the top level counters which are written first by HbciSrv_WriteStats() */
+  snprintf(key, sizeof(key), "\"%s\":", name);
+  s=strstr(json, key);
+  if (s==NULL)
+    return 0;
+  return strtoull(s+strlen(key), NULL, 10);
+}
+
+
+
+double _now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (ts.tv_sec*1000.0)+(ts.tv_nsec/1000000.0);
+}
+
+
+
+void _usage(const char *prgName)
+{
+  fprintf(stderr,
+          "Usage: %s [OPTIONS]\n"
+          " -u, --users N         number of users (default: %d)\n"
+          " -a, --accounts N      accounts per user (local server only, default: %d)\n"
+          " -r, --rounds N        rounds per phase, every round sends one job per account (default: %d)\n"
+          " -t, --transactions N  transactions per statement (local server only, default: %d)\n"
+          " -l, --latency MS      delay added by the server to every response (local server only)\n"
+          " -p, --phase NAME      only run the given phase (balance, transactions, camt, transfer)\n"
+          " -x, --xml FILE        HBCI definitions for the local server (default: %s)\n"
+          " -d, --confdir DIR     configuration folder to create (default: %s)\n"
+          " -b, --bankcode CODE   bank code of the server (default: %s)\n"
+          "     --server URL      use a running server (see hbciserver) instead of starting one\n"
+          " -o FILE               write results (one JSON object per line) to FILE instead of stdout\n",
+          prgName, HBCIBENCH_DEFAULT_USERS, HBCISRV_DEFAULT_ACCOUNTS, HBCIBENCH_DEFAULT_ROUNDS,
+          HBCIBENCH_DEFAULT_TRANSACTIONS, HBCISRV_XMLFILE, HBCIBENCH_DEFAULT_CONFDIR,
+          HBCISRV_DEFAULT_BANKCODE);
+}
+
+
@@ -0,0 +1,173 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+/*
+ * Standalone synthetic FinTS server (see hbcisrv.h).
+ *
+ * Users can be set up against it with aqhbci-tool4 using the PIN/TAN mode and the URL printed on
+ * startup, any PIN is accepted. The server runs until it receives SIGINT or SIGTERM.
+ */
+
+
+#include "hbcisrv.h"
+
+#include <aqbanking/banking.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+
+
+#ifndef HBCISRV_XMLFILE
+# define HBCISRV_XMLFILE "hbci.xml"
+#endif
+
+#define HBCISERVER_DEFAULT_TRANSACTIONS 100
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * forward declarations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+static void _signalHandler(int sig);
+static void _usage(const char *prgName);
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * implementations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+int main(int argc, char **argv)
+{
+  AB_BANKING *ab;
+  HBCISRV *srv;
+  struct sigaction sa;
+  const char *xmlFile=HBCISRV_XMLFILE;
+  const char *address="127.0.0.1";
+  const char *bankCode=NULL;
+  int port=0;
+  int transactions=HBCISERVER_DEFAULT_TRANSACTIONS;
+  int accounts=HBCISRV_DEFAULT_ACCOUNTS;
+  int latency=0;
+  int rv;
+  int i;
+
+  for (i=1; i<argc; i++) {
+    const char *s=argv[i];
+
+    if ((strcmp(s, "-p")==0 || strcmp(s, "--port")==0) && i+1<argc)
+      port=atoi(argv[++i]);
+    else if (strcmp(s, "--address")==0 && i+1<argc)
+      address=argv[++i];
+    else if ((strcmp(s, "-x")==0 || strcmp(s, "--xml")==0) && i+1<argc)
+      xmlFile=argv[++i];
+    else if ((strcmp(s, "-t")==0 || strcmp(s, "--transactions")==0) && i+1<argc)
+      transactions=atoi(argv[++i]);
+    else if ((strcmp(s, "-a")==0 || strcmp(s, "--accounts")==0) && i+1<argc)
+      accounts=atoi(argv[++i]);
+    else if ((strcmp(s, "-l")==0 || strcmp(s, "--latency")==0) && i+1<argc)
+      latency=atoi(argv[++i]);
+    else if ((strcmp(s, "-b")==0 || strcmp(s, "--bankcode")==0) && i+1<argc)
+      bankCode=argv[++i];
+    else {
+      _usage(argv[0]);
+      return 1;
+    }
+  }
+
+  ab=AB_Banking_new("hbciserver", "./hbciserver.conf", 0);
+  rv=AB_Banking_Init(ab);
+  if (rv) {
+    fprintf(stderr, "Could not init AqBanking (%d)\n", rv);
+    AB_Banking_free(ab);
+    return 2;
+  }
+
+  srv=HbciSrv_new();
+  HbciSrv_SetAccountsPerUser(srv, accounts);
+  HbciSrv_SetLatency(srv, latency);
+  if (bankCode)
+    HbciSrv_SetBankCode(srv, bankCode);
+
+  rv=HbciSrv_LoadDefinitions(srv, xmlFile);
+  if (rv<0) {
+    fprintf(stderr, "Could not load HBCI definitions from \"%s\" (%d)\n", xmlFile, rv);
+    HbciSrv_free(srv);
+    AB_Banking_Fini(ab);
+    AB_Banking_free(ab);
+    return 2;
+  }
+
+  rv=HbciSrv_CreatePayloads(srv, ab, transactions, 0);
+  AB_Banking_Fini(ab);
+  AB_Banking_free(ab);
+  if (rv<0) {
+    fprintf(stderr, "Could not create transaction data (%d)\n", rv);
+    HbciSrv_free(srv);
+    return 2;
+  }
+
+  rv=HbciSrv_Listen(srv, address, port);
+  if (rv<0) {
+    fprintf(stderr, "Could not listen on %s:%d (%d)\n", address, port, rv);
+    HbciSrv_free(srv);
+    return 2;
+  }
+  fprintf(stdout, "Listening on http://%s:%d/\n", address, rv);
+  fflush(stdout);
+
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler=_signalHandler;
+  sigemptyset(&sa.sa_mask);
+  sigaction(SIGINT, &sa, NULL);
+  sigaction(SIGTERM, &sa, NULL);
+  signal(SIGPIPE, SIG_IGN);
+
+  rv=HbciSrv_Run(srv);
+  HbciSrv_free(srv);
+  if (rv<0) {
+    fprintf(stderr, "Server error (%d)\n", rv);
+    return 2;
+  }
+  return 0;
+}
+
+
+
+void _signalHandler(int sig)
+{
+  (void) sig;
+  HbciSrv_Stop();
+}
+
+
+
+void _usage(const char *prgName)
+{
+  fprintf(stderr,
+          "Usage: %s [OPTIONS]\n"
+          "Options:\n"
+          " -p, --port PORT            port to listen on (default: choose a free port)\n"
+          "     --address ADDR         address to listen on (default: 127.0.0.1)\n"
+          " -x, --xml FILE             HBCI definitions (default: %s)\n"
+          " -t, --transactions N       transactions returned per statement request (default: %d)\n"
+          " -a, --accounts N           accounts per user (default: %d)\n"
+          " -l, --latency MS           delay added to every response\n"
+          " -b, --bankcode CODE        bank code of the server (default: %s)\n",
+          prgName, HBCISRV_XMLFILE, HBCISERVER_DEFAULT_TRANSACTIONS, HBCISRV_DEFAULT_ACCOUNTS,
+          HBCISRV_DEFAULT_BANKCODE);
+}
+
+
@@ -0,0 +1,1939 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+
+#include "hbcisrv.h"
+#include "benchgen.h"
+
+#include <aqbanking/error.h>
+
+#include <gwenhywfar/msgengine.h>
+#include <gwenhywfar/xml.h>
+#include <gwenhywfar/db.h>
+#include <gwenhywfar/base64.h>
+#include <gwenhywfar/inherit.h>
+#include <gwenhywfar/misc.h>
+#include <gwenhywfar/debug.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+
+
+#define HBCISRV_BPD_VERSION      1
+#define HBCISRV_UPD_VERSION      1
+#define HBCISRV_MAX_HEADER_SIZE  16384
+#define HBCISRV_MAX_BODY_SIZE    (64*1024*1024)
+#define HBCISRV_RECV_TIMEOUT     30
+
+#define HBCISRV_CAMT_FORMAT      "urn:iso:std:iso:20022:tech:xsd:camt.052.001.02"
+
+
+
+typedef enum {
+  HbciSrv_Phase_DialogInit=0,
+  HbciSrv_Phase_Sync,
+  HbciSrv_Phase_DialogEnd,
+  HbciSrv_Phase_Balance,
+  HbciSrv_Phase_Transactions,
+  HbciSrv_Phase_Camt,
+  HbciSrv_Phase_Transfer,
+  HbciSrv_Phase_SepaInfo,
+  HbciSrv_Phase_Other,
+  HbciSrv_Phase_Count
+} HBCISRV_PHASE;
+
+
+typedef struct HBCISRV_TIMING HBCISRV_TIMING;
+struct HBCISRV_TIMING {
+  uint64_t count;
+  uint64_t bytes;
+  double msMin;
+  double msMax;
+  double msSum;
+};
+
+
+typedef struct HBCISRV_DIALOG HBCISRV_DIALOG;
+struct HBCISRV_DIALOG {
+  char *dialogId;
+  double startTime;
+  HBCISRV_DIALOG *next;
+};
+
+
+/* state while handling a single message */
+typedef struct HBCISRV_MSGCTX HBCISRV_MSGCTX;
+struct HBCISRV_MSGCTX {
+  const char *userId;
+  const char *customerId;
+  uint32_t userNum;
+  int nextSeq;
+  int errors;
+  int dialogEnded;
+  HBCISRV_PHASE phase;
+};
+
+
+typedef int (*HBCISRV_SEGHANDLER_FN)(HBCISRV *srv, HBCISRV_MSGCTX *mctx, GWEN_DB_NODE *dbSeg,
+                                     GWEN_DB_NODE *dbResult, GWEN_BUFFER *dataBuf);
+
+
+typedef struct HBCISRV_SEGHANDLER HBCISRV_SEGHANDLER;
+struct HBCISRV_SEGHANDLER {
+  const char *code;
+  HBCISRV_PHASE phase;
+  HBCISRV_SEGHANDLER_FN handlerFn;
+};
+
+
+struct HBCISRV {
+  GWEN_MSGENGINE *msgEngine;
+
+  char *bankCode;
+  char *bic;
+  int accountsPerUser;
+  int latencyMs;
+
+  GWEN_BUFFER *mt940Data;
+  GWEN_BUFFER *camtData;
+
+  int listenSocket;
+
+  int dialogCounter;
+  HBCISRV_DIALOG *openDialogs;
+
+  /* statistics */
+  uint64_t statDialogs;
+  uint64_t statMessages;
+  uint64_t statBytesIn;
+  uint64_t statBytesOut;
+  HBCISRV_TIMING statDialogDuration;
+  HBCISRV_TIMING statPhases[HbciSrv_Phase_Count];
+};
+
+
+GWEN_INHERIT(GWEN_MSGENGINE, HBCISRV);
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * forward declarations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+static void GWENHYWFAR_CB _freeMsgEngineData(void *bp, void *p);
+static GWEN_DB_NODE_TYPE _msgEngineTypeCheck(GWEN_MSGENGINE *e, const char *tname);
+static const char *_msgEngineGetCharValue(GWEN_MSGENGINE *e, const char *name, const char *defValue);
+static int _msgEngineGetIntValue(GWEN_MSGENGINE *e, const char *name, int defValue);
+
+static int _readSegments(GWEN_MSGENGINE *e, GWEN_BUFFER *mbuf, GWEN_DB_NODE *dbOut);
+static int _readSegment(GWEN_MSGENGINE *e, GWEN_BUFFER *mbuf, GWEN_DB_NODE *dbOut);
+static int _createSegmentById(GWEN_MSGENGINE *e, const char *id, GWEN_DB_NODE *dbData, GWEN_BUFFER *destBuf);
+static int _createSegmentByCode(GWEN_MSGENGINE *e, const char *code, int version, GWEN_DB_NODE *dbData,
+                                GWEN_BUFFER *destBuf);
+static int _createSegmentFromNode(GWEN_MSGENGINE *e, GWEN_XMLNODE *node, GWEN_DB_NODE *dbData, GWEN_BUFFER *destBuf);
+static int _addDataSegment(HBCISRV *srv, HBCISRV_MSGCTX *mctx, const char *code, int version, GWEN_DB_NODE *dbData,
+                           GWEN_BUFFER *destBuf);
+static void _addResult(GWEN_DB_NODE *dbResult, int code, const char *text, const char *param);
+static int _resultsHaveErrors(GWEN_DB_NODE *dbResult);
+
+static int _handleSegments(HBCISRV *srv, HBCISRV_MSGCTX *mctx, GWEN_DB_NODE *dbSegs, GWEN_BUFFER *destBuf);
+static int _wrapMessage(HBCISRV *srv, const char *userId, const char *dialogId, int msgNum,
+                        const char *refDialogId, int lastSeq, GWEN_BUFFER *innerBuf, GWEN_BUFFER *destBuf);
+static int _addMsgHead(GWEN_MSGENGINE *e, const char *dialogId, int msgNum, const char *refDialogId, GWEN_BUFFER *msgBuf);
+
+static int _handleIdent(HBCISRV *srv, HBCISRV_MSGCTX *mctx, GWEN_DB_NODE *dbSeg, GWEN_DB_NODE *dbResult,
+                        GWEN_BUFFER *dataBuf);
+static int _handlePrepare(HBCISRV *srv, HBCISRV_MSGCTX *mctx, GWEN_DB_NODE *dbSeg, GWEN_DB_NODE *dbResult,
+                          GWEN_BUFFER *dataBuf);
+static int _handleSync(HBCISRV *srv, HBCISRV_MSGCTX *mctx, GWEN_DB_NODE *dbSeg, GWEN_DB_NODE *dbResult,
+                       GWEN_BUFFER *dataBuf);
+static int _handleDialogEnd(HBCISRV *srv, HBCISRV_MSGCTX *mctx, GWEN_DB_NODE *dbSeg, GWEN_DB_NODE *dbResult,
+                            GWEN_BUFFER *dataBuf);
+static int _handleBalance(HBCISRV *srv, HBCISRV_MSGCTX *mctx, GWEN_DB_NODE *dbSeg, GWEN_DB_NODE *dbResult,
+                          GWEN_BUFFER *dataBuf);
+static int _handleTransactions(HBCISRV *srv, HBCISRV_MSGCTX *mctx, GWEN_DB_NODE *dbSeg, GWEN_DB_NODE *dbResult,
+                               GWEN_BUFFER *dataBuf);
+static int _handleTransactionsCamt(HBCISRV *srv, HBCISRV_MSGCTX *mctx, GWEN_DB_NODE *dbSeg, GWEN_DB_NODE *dbResult,
+                                   GWEN_BUFFER *dataBuf);
+static int _handleTransfer(HBCISRV *srv, HBCISRV_MSGCTX *mctx, GWEN_DB_NODE *dbSeg, GWEN_DB_NODE *dbResult,
+                           GWEN_BUFFER *dataBuf);
+static int _handleSepaInfo(HBCISRV *srv, HBCISRV_MSGCTX *mctx, GWEN_DB_NODE *dbSeg, GWEN_DB_NODE *dbResult,
+                           GWEN_BUFFER *dataBuf);
+
+static int _addBpd(HBCISRV *srv, HBCISRV_MSGCTX *mctx, GWEN_BUFFER *dataBuf);
+static int _addBpdJob(HBCISRV *srv, HBCISRV_MSGCTX *mctx, const char *code, int version, GWEN_DB_NODE *dbData,
+                      GWEN_BUFFER *dataBuf);
+static int _addUpd(HBCISRV *srv, HBCISRV_MSGCTX *mctx, GWEN_BUFFER *dataBuf);
+
+static uint32_t _getUserNum(const char *userId);
+static void _getAccountNumber(uint32_t userNum, int idx, char *buffer, int size);
+static int _getAccountIndex(const HBCISRV *srv, const HBCISRV_MSGCTX *mctx, const char *accountId);
+static void _setKik(HBCISRV *srv, GWEN_DB_NODE *db);
+
+static void _startDialog(HBCISRV *srv, const char *dialogId);
+static void _endDialog(HBCISRV *srv, const char *dialogId);
+static void _addTiming(HBCISRV_TIMING *ti, double ms, uint32_t bytes);
+static void _writeTiming(const HBCISRV_TIMING *ti, GWEN_BUFFER *buf);
+
+static int _handleConnection(HBCISRV *srv, int sk);
+static int _readRequest(int sk, GWEN_BUFFER *hbuf, GWEN_BUFFER *bbuf);
+static int _handlePost(HBCISRV *srv, GWEN_BUFFER *bbuf, GWEN_BUFFER *rbuf);
+static int _writeResponse(int sk, int code, const char *contentType, const char *ptr, uint32_t len);
+static int _writeAll(int sk, const char *ptr, uint32_t len);
+static void _sleepMs(int ms);
+static double _now(void);
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * static data
+ * ------------------------------------------------------------------------------------------------
+ */
+
+static volatile sig_atomic_t _stopRequested=0;
+
+
+static const HBCISRV_SEGHANDLER _segHandlers[]= {
+  {"HKIDN", HbciSrv_Phase_DialogInit,   _handleIdent},
+  {"HKVVB", HbciSrv_Phase_DialogInit,   _handlePrepare},
+  {"HKSYN", HbciSrv_Phase_Sync,         _handleSync},
+  {"HKEND", HbciSrv_Phase_DialogEnd,    _handleDialogEnd},
+  {"HKSAL", HbciSrv_Phase_Balance,      _handleBalance},
+  {"HKKAZ", HbciSrv_Phase_Transactions, _handleTransactions},
+  {"HKCAZ", HbciSrv_Phase_Camt,         _handleTransactionsCamt},
+  {"HKCCS", HbciSrv_Phase_Transfer,     _handleTransfer},
+  {"HKSPA", HbciSrv_Phase_SepaInfo,     _handleSepaInfo},
+  {NULL,    HbciSrv_Phase_Other,        NULL}
+};
+
+
+static const char *_phaseNames[HbciSrv_Phase_Count]= {
+  "dialogInit",
+  "sync",
+  "dialogEnd",
+  "balance",
+  "transactions",
+  "camt",
+  "transfer",
+  "sepaInfo",
+  "other"
+};
+
+
+/* jobs offered in BPD and UPD */
+static const char *_updJobs[]= {"HKSAL", "HKKAZ", "HKCAZ", "HKCCS", "HKSPA", NULL};
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * implementations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+HBCISRV *HbciSrv_new(void)
+{
+  HBCISRV *srv;
+
+  GWEN_NEW_OBJECT(HBCISRV, srv);
+  srv->bankCode=strdup(HBCISRV_DEFAULT_BANKCODE);
+  srv->bic=strdup(HBCISRV_DEFAULT_BIC);
+  srv->accountsPerUser=HBCISRV_DEFAULT_ACCOUNTS;
+  srv->listenSocket=-1;
+  HbciSrv_ResetStats(srv);
+
+  srv->msgEngine=GWEN_MsgEngine_new();
+  GWEN_INHERIT_SETDATA(GWEN_MSGENGINE, HBCISRV, srv->msgEngine, srv, _freeMsgEngineData);
+  GWEN_MsgEngine_SetTypeCheckFunction(srv->msgEngine, _msgEngineTypeCheck);
+  GWEN_MsgEngine_SetGetCharValueFunction(srv->msgEngine, _msgEngineGetCharValue);
+  GWEN_MsgEngine_SetGetIntValueFunction(srv->msgEngine, _msgEngineGetIntValue);
+  GWEN_MsgEngine_SetEscapeChar(srv->msgEngine, '?');
+  GWEN_MsgEngine_SetMode(srv->msgEngine, "pintan");
+  GWEN_MsgEngine_SetProtocolVersion(srv->msgEngine, 300);
+
+  return srv;
+}
+
+
+
+void HbciSrv_free(HBCISRV *srv)
+{
+  if (srv) {
+    while (srv->openDialogs) {
+      HBCISRV_DIALOG *dlg;
+
+      dlg=srv->openDialogs;
+      srv->openDialogs=dlg->next;
+      free(dlg->dialogId);
+      GWEN_FREE_OBJECT(dlg);
+    }
+    if (srv->listenSocket!=-1)
+      close(srv->listenSocket);
+    GWEN_Buffer_free(srv->camtData);
+    GWEN_Buffer_free(srv->mt940Data);
+    GWEN_MsgEngine_free(srv->msgEngine);
+    free(srv->bic);
+    free(srv->bankCode);
+    GWEN_FREE_OBJECT(srv);
+  }
+}
+
+
+
+void GWENHYWFAR_CB _freeMsgEngineData(GWEN_UNUSED void *bp, GWEN_UNUSED void *p)
+{
+  /* the server object owns the engine, not the other way round */
+}
+
+
+
+int HbciSrv_LoadDefinitions(HBCISRV *srv, const char *fileName)
+{
+  GWEN_XMLNODE *xmlNode;
+  int rv;
+
+  xmlNode=GWEN_XMLNode_new(GWEN_XMLNodeTypeTag, "root");
+  rv=GWEN_XML_ReadFile(xmlNode, fileName, GWEN_XML_FLAGS_DEFAULT | GWEN_XML_FLAGS_HANDLE_HEADERS);
+  if (rv<0) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Could not read XML file \"%s\" (%d)", fileName, rv);
+    GWEN_XMLNode_free(xmlNode);
+    return rv;
+  }
+  GWEN_MsgEngine_SetDefinitions(srv->msgEngine, xmlNode, 1);
+  return 0;
+}
+
+
+
+void HbciSrv_SetBankCode(HBCISRV *srv, const char *s)
+{
+  free(srv->bankCode);
+  srv->bankCode=strdup((s && *s)?s:HBCISRV_DEFAULT_BANKCODE);
+}
+
+
+
+void HbciSrv_SetBic(HBCISRV *srv, const char *s)
+{
+  free(srv->bic);
+  srv->bic=strdup((s && *s)?s:HBCISRV_DEFAULT_BIC);
+}
+
+
+
+void HbciSrv_SetAccountsPerUser(HBCISRV *srv, int i)
+{
+  srv->accountsPerUser=(i>0)?i:1;
+}
+
+
+
+void HbciSrv_SetLatency(HBCISRV *srv, int ms)
+{
+  srv->latencyMs=(ms>0)?ms:0;
+}
+
+
+
+void HbciSrv_SetMt940Data(HBCISRV *srv, const char *ptr, uint32_t len)
+{
+  GWEN_Buffer_free(srv->mt940Data);
+  srv->mt940Data=NULL;
+  if (ptr && len) {
+    srv->mt940Data=GWEN_Buffer_new(0, len, 0, 1);
+    GWEN_Buffer_AppendBytes(srv->mt940Data, ptr, len);
+  }
+}
+
+
+
+void HbciSrv_SetCamtData(HBCISRV *srv, const char *ptr, uint32_t len)
+{
+  GWEN_Buffer_free(srv->camtData);
+  srv->camtData=NULL;
+  if (ptr && len) {
+    srv->camtData=GWEN_Buffer_new(0, len, 0, 1);
+    GWEN_Buffer_AppendBytes(srv->camtData, ptr, len);
+  }
+}
+
+
+
+int HbciSrv_CreatePayloads(HBCISRV *srv, AB_BANKING *ab, int transactions, uint32_t seed)
+{
+  AB_IMEXPORTER_CONTEXT *ctx;
+  GWEN_DB_NODE *dbProfile;
+  GWEN_BUFFER *buf;
+  int rv;
+
+  ctx=BenchGen_CreateContext(BenchGen_DataType_Statements, transactions, seed);
+  buf=GWEN_Buffer_new(0, 1024, 0, 1);
+
+  rv=BenchGen_WriteMt940(ctx, buf);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    GWEN_Buffer_free(buf);
+    AB_ImExporterContext_free(ctx);
+    return rv;
+  }
+  HbciSrv_SetMt940Data(srv, GWEN_Buffer_GetStart(buf), GWEN_Buffer_GetUsedBytes(buf));
+  GWEN_Buffer_Reset(buf);
+
+  dbProfile=AB_Banking_GetImExporterProfile(ab, "xml", "camt_052_001_02");
+  if (dbProfile==NULL) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "No camt.052 export profile, HKCAZ will return no data");
+  }
+  else {
+    rv=AB_Banking_ExportToBuffer(ab, "xml", ctx, buf, dbProfile);
+    GWEN_DB_Group_free(dbProfile);
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      GWEN_Buffer_free(buf);
+      AB_ImExporterContext_free(ctx);
+      return rv;
+    }
+    HbciSrv_SetCamtData(srv, GWEN_Buffer_GetStart(buf), GWEN_Buffer_GetUsedBytes(buf));
+  }
+
+  GWEN_Buffer_free(buf);
+  AB_ImExporterContext_free(ctx);
+  return 0;
+}
+
+
+
+int HbciSrv_Listen(HBCISRV *srv, const char *address, int port)
+{
+  struct sockaddr_in sa;
+  socklen_t saLen;
+  int sk;
+  int one=1;
+
+  memset(&sa, 0, sizeof(sa));
+  sa.sin_family=AF_INET;
+  sa.sin_port=htons(port);
+  if (inet_pton(AF_INET, (address && *address)?address:"127.0.0.1", &sa.sin_addr)!=1) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Invalid address \"%s\"", address);
+    return GWEN_ERROR_INVALID;
+  }
+
+  sk=socket(AF_INET, SOCK_STREAM, 0);
+  if (sk==-1) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "socket(): %s", strerror(errno));
+    return GWEN_ERROR_IO;
+  }
+  setsockopt(sk, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+  if (bind(sk, (struct sockaddr *) &sa, sizeof(sa))==-1) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "bind(): %s", strerror(errno));
+    close(sk);
+    return GWEN_ERROR_IO;
+  }
+  if (listen(sk, 64)==-1) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "listen(): %s", strerror(errno));
+    close(sk);
+    return GWEN_ERROR_IO;
+  }
+
+  saLen=sizeof(sa);
+  if (getsockname(sk, (struct sockaddr *) &sa, &saLen)==-1) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "getsockname(): %s", strerror(errno));
+    close(sk);
+    return GWEN_ERROR_IO;
+  }
+
+  if (srv->listenSocket!=-1)
+    close(srv->listenSocket);
+  srv->listenSocket=sk;
+  return ntohs(sa.sin_port);
+}
+
+
+
+int HbciSrv_Run(HBCISRV *srv)
+{
+  if (srv->listenSocket==-1) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Not listening");
+    return GWEN_ERROR_INVALID;
+  }
+
+  while (!_stopRequested) {
+    struct pollfd pfd;
+    int rv;
+    int sk;
+
+    /* wake up regularly to check for the stop flag */
+    pfd.fd=srv->listenSocket;
+    pfd.events=POLLIN;
+    pfd.revents=0;
+    rv=poll(&pfd, 1, 250);
+    if (rv==-1) {
+      if (errno==EINTR)
+        continue;
+      DBG_ERROR(AQBANKING_LOGDOMAIN, "poll(): %s", strerror(errno));
+      return GWEN_ERROR_IO;
+    }
+    if (rv==0)
+      continue;
+
+    sk=accept(srv->listenSocket, NULL, NULL);
+    if (sk==-1) {
+      if (errno==EINTR || errno==EAGAIN || errno==ECONNABORTED)
+        continue;
+      DBG_ERROR(AQBANKING_LOGDOMAIN, "accept(): %s", strerror(errno));
+      return GWEN_ERROR_IO;
+    }
+
+    rv=_handleConnection(srv, sk);
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    }
+    close(sk);
+  }
+
+  return 0;
+}
+
+
+
+void HbciSrv_Stop(void)
+{
+  _stopRequested=1;
+}
+
+
+
+int HbciSrv_HandleMessage(HBCISRV *srv, const uint8_t *ptr, uint32_t len, GWEN_BUFFER *destBuf)
+{
+  GWEN_MSGENGINE *e;
+  GWEN_BUFFER *mbuf;
+  GWEN_BUFFER *innerBuf;
+  GWEN_DB_NODE *dbOuter;
+  GWEN_DB_NODE *dbInner;
+  GWEN_DB_NODE *dbHead;
+  GWEN_DB_NODE *dbT;
+  HBCISRV_MSGCTX mctx;
+  const char *reqDialogId;
+  char dialogIdBuf[32];
+  const char *dialogId;
+  const uint8_t *cryptData;
+  uint32_t cryptLen=0;
+  int msgNum;
+  double startTime;
+  int rv;
+
+  startTime=_now();
+  e=srv->msgEngine;
+  GWEN_MsgEngine_SetMode(e, "pintan");
+  GWEN_MsgEngine_SetProtocolVersion(e, 300);
+
+  /* parse outer message */
+  mbuf=GWEN_Buffer_new((char *) ptr, len, len, 0);
+  GWEN_Buffer_SetMode(mbuf, GWEN_BUFFER_MODE_READONLY);
+  dbOuter=GWEN_DB_Group_new("request");
+  rv=_readSegments(e, mbuf, dbOuter);
+  GWEN_Buffer_free(mbuf);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    GWEN_DB_Group_free(dbOuter);
+    return rv;
+  }
+
+  dbHead=GWEN_DB_GetGroup(dbOuter, GWEN_PATH_FLAGS_NAMEMUSTEXIST, "MsgHead");
+  if (dbHead==NULL) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "No message head");
+    GWEN_DB_Group_free(dbOuter);
+    return GWEN_ERROR_BAD_DATA;
+  }
+  reqDialogId=GWEN_DB_GetCharValue(dbHead, "dialogId", 0, "0");
+  msgNum=GWEN_DB_GetIntValue(dbHead, "msgnum", 0, 1);
+
+  /* get inner part (PIN/TAN messages are not really encrypted) */
+  dbInner=GWEN_DB_Group_new("segments");
+  dbT=GWEN_DB_GetGroup(dbOuter, GWEN_PATH_FLAGS_NAMEMUSTEXIST, "CryptData");
+  if (dbT)
+    cryptData=(const uint8_t *) GWEN_DB_GetBinValue(dbT, "CryptData", 0, NULL, 0, &cryptLen);
+  else
+    cryptData=NULL;
+  if (cryptData && cryptLen) {
+    mbuf=GWEN_Buffer_new((char *) cryptData, cryptLen, cryptLen, 0);
+    GWEN_Buffer_SetMode(mbuf, GWEN_BUFFER_MODE_READONLY);
+    rv=_readSegments(e, mbuf, dbInner);
+    GWEN_Buffer_free(mbuf);
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      GWEN_DB_Group_free(dbInner);
+      GWEN_DB_Group_free(dbOuter);
+      return rv;
+    }
+  }
+  else {
+    /* unencrypted message: use outer segments */
+    GWEN_DB_AddGroupChildren(dbInner, dbOuter);
+  }
+
+  /* determine user */
+  memset(&mctx, 0, sizeof(mctx));
+  mctx.userId=GWEN_DB_GetCharValue(dbOuter, "CryptHead/key/userid", 0, NULL);
+  if (mctx.userId==NULL)
+    mctx.userId=GWEN_DB_GetCharValue(dbInner, "SigHead/key/userid", 0, "unknown");
+  mctx.customerId=GWEN_DB_GetCharValue(dbInner, "Ident/customerId", 0, mctx.userId);
+  mctx.userNum=_getUserNum(mctx.userId);
+  mctx.phase=HbciSrv_Phase_DialogInit;
+
+  /* determine dialog id */
+  if (strcmp(reqDialogId, "0")==0) {
+    snprintf(dialogIdBuf, sizeof(dialogIdBuf), "HBCISRV%d", ++(srv->dialogCounter));
+    dialogId=dialogIdBuf;
+    _startDialog(srv, dialogId);
+  }
+  else
+    dialogId=reqDialogId;
+
+  /* handle segments */
+  innerBuf=GWEN_Buffer_new(0, 1024, 0, 1);
+  rv=_handleSegments(srv, &mctx, dbInner, innerBuf);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    GWEN_Buffer_free(innerBuf);
+    GWEN_DB_Group_free(dbInner);
+    GWEN_DB_Group_free(dbOuter);
+    return rv;
+  }
+
+  /* wrap into envelope */
+  rv=_wrapMessage(srv, mctx.userId, dialogId, msgNum, reqDialogId, mctx.nextSeq-1, innerBuf, destBuf);
+  GWEN_Buffer_free(innerBuf);
+  if (mctx.dialogEnded)
+    _endDialog(srv, dialogId);
+  GWEN_DB_Group_free(dbInner);
+  GWEN_DB_Group_free(dbOuter);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  srv->statMessages++;
+  _addTiming(&(srv->statPhases[mctx.phase]), (_now()-startTime)*1000.0, len+GWEN_Buffer_GetUsedBytes(destBuf));
+  return 0;
+}
+
+
+
+int _handleSegments(HBCISRV *srv, HBCISRV_MSGCTX *mctx, GWEN_DB_NODE *dbSegs, GWEN_BUFFER *destBuf)
+{
+  GWEN_MSGENGINE *e;
+  GWEN_BUFFER *bodyBuf;
+  GWEN_BUFFER *dataBuf;
+  GWEN_DB_NODE *dbSeg;
+  GWEN_DB_NODE *dbMsgResult;
+  int rv;
+
+  e=srv->msgEngine;
+  bodyBuf=GWEN_Buffer_new(0, 1024, 0, 1);
+  dataBuf=GWEN_Buffer_new(0, 1024, 0, 1);
+
+  /* seq 1 is the message head, seq 2 the message result (added last) */
+  mctx->nextSeq=3;
+
+  dbSeg=GWEN_DB_GetFirstGroup(dbSegs);
+  while (dbSeg) {
+    const char *code;
+    int segNum;
+
+    code=GWEN_DB_GetCharValue(dbSeg, "head/code", 0, "");
+    segNum=GWEN_DB_GetIntValue(dbSeg, "head/seq", 0, 0);
+
+    /* signature envelope needs no response */
+    if (strcasecmp(code, "HNSHK")!=0 && strcasecmp(code, "HNSHA")!=0) {
+      const HBCISRV_SEGHANDLER *sh;
+      GWEN_DB_NODE *dbResult;
+      int resultSeq;
+
+      dbResult=GWEN_DB_Group_new("SegResult");
+      resultSeq=mctx->nextSeq++;
+      GWEN_Buffer_Reset(dataBuf);
+
+      for (sh=_segHandlers; sh->code; sh++) {
+        if (strcasecmp(sh->code, code)==0)
+          break;
+      }
+
+      if (sh->code) {
+        if (sh->phase!=HbciSrv_Phase_DialogInit)
+          mctx->phase=sh->phase;
+        rv=sh->handlerFn(srv, mctx, dbSeg, dbResult, dataBuf);
+        if (rv<0) {
+          DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+          GWEN_DB_Group_free(dbResult);
+          GWEN_Buffer_free(dataBuf);
+          GWEN_Buffer_free(bodyBuf);
+          return rv;
+        }
+      }
+      else {
+        DBG_WARN(AQBANKING_LOGDOMAIN, "Unhandled segment \"%s\"", code);
+        if (mctx->phase==HbciSrv_Phase_DialogInit)
+          mctx->phase=HbciSrv_Phase_Other;
+        _addResult(dbResult, 9010, "Geschaeftsvorfall nicht unterstuetzt", NULL);
+      }
+
+      if (_resultsHaveErrors(dbResult))
+        mctx->errors++;
+
+      GWEN_DB_SetIntValue(dbResult, GWEN_DB_FLAGS_OVERWRITE_VARS, "head/seq", resultSeq);
+      GWEN_DB_SetIntValue(dbResult, GWEN_DB_FLAGS_OVERWRITE_VARS, "head/ref", segNum);
+      rv=_createSegmentById(e, "SegResult", dbResult, bodyBuf);
+      GWEN_DB_Group_free(dbResult);
+      if (rv<0) {
+        DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+        GWEN_Buffer_free(dataBuf);
+        GWEN_Buffer_free(bodyBuf);
+        return rv;
+      }
+      GWEN_Buffer_AppendBuffer(bodyBuf, dataBuf);
+    }
+
+    dbSeg=GWEN_DB_GetNextGroup(dbSeg);
+  }
+  GWEN_Buffer_free(dataBuf);
+
+  /* message result */
+  dbMsgResult=GWEN_DB_Group_new("MsgResult");
+  GWEN_DB_SetIntValue(dbMsgResult, GWEN_DB_FLAGS_OVERWRITE_VARS, "head/seq", 2);
+  if (mctx->errors)
+    _addResult(dbMsgResult, 9050, "Die Nachricht enthaelt Fehler", NULL);
+  else if (mctx->dialogEnded)
+    _addResult(dbMsgResult, 100, "Dialog beendet", NULL);
+  else
+    _addResult(dbMsgResult, 10, "Nachricht entgegengenommen", NULL);
+  rv=_createSegmentById(e, "MsgResult", dbMsgResult, destBuf);
+  GWEN_DB_Group_free(dbMsgResult);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    GWEN_Buffer_free(bodyBuf);
+    return rv;
+  }
+
+  GWEN_Buffer_AppendBuffer(destBuf, bodyBuf);
+  GWEN_Buffer_free(bodyBuf);
+  return 0;
+}
+
+
+
+int _wrapMessage(HBCISRV *srv, const char *userId, const char *dialogId, int msgNum,
+                 const char *refDialogId, int lastSeq, GWEN_BUFFER *innerBuf, GWEN_BUFFER *destBuf)
+{
+  GWEN_MSGENGINE *e;
+  GWEN_DB_NODE *cfg;
+  GWEN_BUFFER *msgBuf;
+  char sdate[9];
+  char stime[7];
+  struct tm *lt;
+  time_t tt;
+  int rv;
+
+  e=srv->msgEngine;
+  GWEN_MsgEngine_SetValue(e, "DialogId", dialogId);
+  GWEN_MsgEngine_SetIntValue(e, "MessageNumber", msgNum);
+
+  tt=time(0);
+  lt=localtime(&tt);
+  strftime(sdate, sizeof(sdate), "%Y%m%d", lt);
+  strftime(stime, sizeof(stime), "%H%M%S", lt);
+
+  msgBuf=GWEN_Buffer_new(0, GWEN_Buffer_GetUsedBytes(innerBuf)+512, 0, 1);
+
+  /* crypt head, same as created by the client */
+  cfg=GWEN_DB_Group_new("crypthead");
+  GWEN_DB_SetIntValue(cfg, GWEN_DB_FLAGS_DEFAULT, "head/seq", 998);
+  GWEN_DB_SetIntValue(cfg, GWEN_DB_FLAGS_DEFAULT, "SecDetails/dir", 1);
+  GWEN_DB_SetCharValue(cfg, GWEN_DB_FLAGS_DEFAULT, "SecDetails/SecId", "0");
+  GWEN_DB_SetCharValue(cfg, GWEN_DB_FLAGS_DEFAULT, "SecStamp/date", sdate);
+  GWEN_DB_SetCharValue(cfg, GWEN_DB_FLAGS_DEFAULT, "SecStamp/time", stime);
+  GWEN_DB_SetCharValue(cfg, GWEN_DB_FLAGS_DEFAULT, "key/bankcode", srv->bankCode);
+  GWEN_DB_SetCharValue(cfg, GWEN_DB_FLAGS_DEFAULT, "key/userid", userId);
+  GWEN_DB_SetCharValue(cfg, GWEN_DB_FLAGS_DEFAULT, "key/keytype", "V");
+  GWEN_DB_SetIntValue(cfg, GWEN_DB_FLAGS_DEFAULT, "key/keynum", 0);
+  GWEN_DB_SetIntValue(cfg, GWEN_DB_FLAGS_DEFAULT, "key/keyversion", 0);
+  GWEN_DB_SetCharValue(cfg, GWEN_DB_FLAGS_DEFAULT, "secProfile/code", "PIN");
+  GWEN_DB_SetIntValue(cfg, GWEN_DB_FLAGS_DEFAULT, "secProfile/version", 1);
+  GWEN_DB_SetBinValue(cfg, GWEN_DB_FLAGS_DEFAULT, "CryptAlgo/MsgKey", "XXXXXXXX", 8);
+  GWEN_DB_SetIntValue(cfg, GWEN_DB_FLAGS_DEFAULT, "CryptAlgo/keytype", 5);
+  rv=_createSegmentById(e, "CryptHead", cfg, msgBuf);
+  GWEN_DB_Group_free(cfg);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    GWEN_Buffer_free(msgBuf);
+    return rv;
+  }
+
+  /* crypt data */
+  cfg=GWEN_DB_Group_new("cryptdata");
+  GWEN_DB_SetIntValue(cfg, GWEN_DB_FLAGS_DEFAULT, "head/seq", 999);
+  GWEN_DB_SetBinValue(cfg, GWEN_DB_FLAGS_DEFAULT, "cryptdata",
+                      GWEN_Buffer_GetStart(innerBuf), GWEN_Buffer_GetUsedBytes(innerBuf));
+  rv=_createSegmentById(e, "CryptData", cfg, msgBuf);
+  GWEN_DB_Group_free(cfg);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    GWEN_Buffer_free(msgBuf);
+    return rv;
+  }
+
+  /* message tail */
+  cfg=GWEN_DB_Group_new("msgtail");
+  GWEN_DB_SetIntValue(cfg, GWEN_DB_FLAGS_DEFAULT, "head/seq", lastSeq+1);
+  rv=_createSegmentById(e, "MsgTail", cfg, msgBuf);
+  GWEN_DB_Group_free(cfg);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    GWEN_Buffer_free(msgBuf);
+    return rv;
+  }
+
+  /* message head */
+  rv=_addMsgHead(e, dialogId, msgNum, refDialogId, msgBuf);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    GWEN_Buffer_free(msgBuf);
+    return rv;
+  }
+
+  GWEN_Buffer_AppendBuffer(destBuf, msgBuf);
+  GWEN_Buffer_free(msgBuf);
+  return 0;
+}
+
+
+
+int _addMsgHead(GWEN_MSGENGINE *e, const char *dialogId, int msgNum, const char *refDialogId, GWEN_BUFFER *msgBuf)
+{
+  GWEN_XMLNODE *node;
+  GWEN_DB_NODE *cfg;
+  GWEN_BUFFER *hbuf;
+  int rv;
+
+  node=GWEN_MsgEngine_FindNodeByPropertyStrictProto(e, "SEG", "id", 0, "MsgHead");
+  if (node==NULL) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Segment \"MsgHead\" not found");
+    return GWEN_ERROR_NOT_FOUND;
+  }
+
+  cfg=GWEN_DB_Group_new("msghead");
+  GWEN_DB_SetCharValue(cfg, GWEN_DB_FLAGS_DEFAULT, "dialogid", dialogId);
+  GWEN_DB_SetIntValue(cfg, GWEN_DB_FLAGS_DEFAULT, "msgnum", msgNum);
+  GWEN_DB_SetIntValue(cfg, GWEN_DB_FLAGS_DEFAULT, "msgref/msgnum", msgNum);
+  GWEN_DB_SetCharValue(cfg, GWEN_DB_FLAGS_DEFAULT, "msgref/dialogid", refDialogId);
+  GWEN_DB_SetIntValue(cfg, GWEN_DB_FLAGS_DEFAULT, "hversion", 300);
+  GWEN_DB_SetIntValue(cfg, GWEN_DB_FLAGS_DEFAULT, "size", 1);
+  GWEN_DB_SetIntValue(cfg, GWEN_DB_FLAGS_DEFAULT, "head/seq", 1);
+
+  /* create first version just to calculate the size */
+  hbuf=GWEN_Buffer_new(0, 128, 0, 1);
+  rv=GWEN_MsgEngine_CreateMessageFromNode(e, node, hbuf, cfg);
+  if (rv) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Could not create msgHead");
+    GWEN_Buffer_free(hbuf);
+    GWEN_DB_Group_free(cfg);
+    return GWEN_ERROR_GENERIC;
+  }
+
+  GWEN_DB_SetIntValue(cfg, GWEN_DB_FLAGS_OVERWRITE_VARS, "size",
+                      GWEN_Buffer_GetUsedBytes(msgBuf)+GWEN_Buffer_GetUsedBytes(hbuf));
+  GWEN_Buffer_Reset(hbuf);
+  rv=GWEN_MsgEngine_CreateMessageFromNode(e, node, hbuf, cfg);
+  GWEN_DB_Group_free(cfg);
+  if (rv) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Could not create 2nd version of msgHead");
+    GWEN_Buffer_free(hbuf);
+    return GWEN_ERROR_GENERIC;
+  }
+
+  GWEN_Buffer_SetPos(msgBuf, 0);
+  rv=GWEN_Buffer_InsertBuffer(msgBuf, hbuf);
+  GWEN_Buffer_free(hbuf);
+  if (rv) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "Could not insert msgHead");
+    return GWEN_ERROR_GENERIC;
+  }
+
+  return 0;
+}
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * segment handlers
+ * ------------------------------------------------------------------------------------------------
+ */
+
+int _handleIdent(GWEN_UNUSED HBCISRV *srv, GWEN_UNUSED HBCISRV_MSGCTX *mctx, GWEN_UNUSED GWEN_DB_NODE *dbSeg,
+                 GWEN_DB_NODE *dbResult, GWEN_UNUSED GWEN_BUFFER *dataBuf)
+{
+  /* PINs are not checked */
+  _addResult(dbResult, 20, "Auftrag ausgefuehrt", NULL);
+  return 0;
+}
+
+
+
+int _handlePrepare(HBCISRV *srv, HBCISRV_MSGCTX *mctx, GWEN_DB_NODE *dbSeg, GWEN_DB_NODE *dbResult,
+                   GWEN_BUFFER *dataBuf)
+{
+  int rv;
+
+  _addResult(dbResult, 20, "Informationen fehlerfrei entgegengenommen", NULL);
+
+  if (GWEN_DB_GetIntValue(dbSeg, "bpdVersion", 0, 0)!=HBCISRV_BPD_VERSION) {
+    rv=_addBpd(srv, mctx, dataBuf);
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      return rv;
+    }
+    _addResult(dbResult, 3050, "BPD nicht mehr aktuell, aktuelle Version enthalten", NULL);
+  }
+
+  if (GWEN_DB_GetIntValue(dbSeg, "updVersion", 0, 0)!=HBCISRV_UPD_VERSION) {
+    rv=_addUpd(srv, mctx, dataBuf);
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      return rv;
+    }
+    _addResult(dbResult, 3050, "UPD nicht mehr aktuell, aktuelle Version enthalten", NULL);
+  }
+
+  /* only single step TAN method */
+  _addResult(dbResult, 3920, "Zugelassene Zwei-Schritt-Verfahren fuer den Benutzer", "999");
+  return 0;
+}
+
+
+
+int _handleSync(HBCISRV *srv, HBCISRV_MSGCTX *mctx, GWEN_UNUSED GWEN_DB_NODE *dbSeg, GWEN_DB_NODE *dbResult,
+                GWEN_BUFFER *dataBuf)
+{
+  GWEN_DB_NODE *dbData;
+  char sysId[64];
+  int rv;
+
+  snprintf(sysId, sizeof(sysId), "SYS-%s", mctx->userId);
+  dbData=GWEN_DB_Group_new("syncresponse");
+  GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "systemid", sysId);
+  rv=_addDataSegment(srv, mctx, "HISYN", 4, dbData, dataBuf);
+  GWEN_DB_Group_free(dbData);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  _addResult(dbResult, 20, "Auftrag ausgefuehrt", NULL);
+  return 0;
+}
+
+
+
+int _handleDialogEnd(GWEN_UNUSED HBCISRV *srv, HBCISRV_MSGCTX *mctx, GWEN_UNUSED GWEN_DB_NODE *dbSeg,
+                     GWEN_DB_NODE *dbResult, GWEN_UNUSED GWEN_BUFFER *dataBuf)
+{
+  mctx->dialogEnded=1;
+  _addResult(dbResult, 20, "Dialog beendet", NULL);
+  return 0;
+}
+
+
+
+int _handleBalance(HBCISRV *srv, HBCISRV_MSGCTX *mctx, GWEN_DB_NODE *dbSeg, GWEN_DB_NODE *dbResult,
+                   GWEN_BUFFER *dataBuf)
+{
+  GWEN_DB_NODE *dbData;
+  const char *accountId;
+  char valueBuf[32];
+  char sdate[9];
+  char stime[7];
+  struct tm *lt;
+  time_t tt;
+  uint32_t cents;
+  int idx;
+  int rv;
+
+  accountId=GWEN_DB_GetCharValue(dbSeg, "accountid", 0, NULL);
+  idx=_getAccountIndex(srv, mctx, accountId);
+  if (idx<0) {
+    _addResult(dbResult, 9010, "Konto unbekannt", NULL);
+    return 0;
+  }
+
+  tt=time(0);
+  lt=localtime(&tt);
+  strftime(sdate, sizeof(sdate), "%Y%m%d", lt);
+  strftime(stime, sizeof(stime), "%H%M%S", lt);
+
+  /* deterministic balance per account */
+  cents=(mctx->userNum*7919u+(uint32_t) idx*104729u)%10000000u;
+  snprintf(valueBuf, sizeof(valueBuf), "%u,%02u", cents/100, cents%100);
+
+  dbData=GWEN_DB_Group_new("Balance");
+  GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "accountid", accountId);
+  _setKik(srv, dbData);
+  GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "accountName", "Girokonto");
+  GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "currency", "EUR");
+  GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "booked/debitmark", "C");
+  GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "booked/value", valueBuf);
+  GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "booked/currency", "EUR");
+  GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "booked/date", sdate);
+  GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "booked/time", stime);
+  rv=_addDataSegment(srv, mctx, "HISAL", 6, dbData, dataBuf);
+  GWEN_DB_Group_free(dbData);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  _addResult(dbResult, 20, "Auftrag ausgefuehrt", NULL);
+  return 0;
+}
+
+
+
+int _handleTransactions(HBCISRV *srv, HBCISRV_MSGCTX *mctx, GWEN_DB_NODE *dbSeg, GWEN_DB_NODE *dbResult,
+                        GWEN_BUFFER *dataBuf)
+{
+  GWEN_DB_NODE *dbData;
+  int rv;
+
+  if (_getAccountIndex(srv, mctx, GWEN_DB_GetCharValue(dbSeg, "accountid", 0, NULL))<0) {
+    _addResult(dbResult, 9010, "Konto unbekannt", NULL);
+    return 0;
+  }
+
+  if (srv->mt940Data==NULL) {
+    _addResult(dbResult, 3010, "Keine Umsaetze vorhanden", NULL);
+    return 0;
+  }
+
+  dbData=GWEN_DB_Group_new("Transactions");
+  GWEN_DB_SetBinValue(dbData, GWEN_DB_FLAGS_DEFAULT, "booked",
+                      GWEN_Buffer_GetStart(srv->mt940Data), GWEN_Buffer_GetUsedBytes(srv->mt940Data));
+  rv=_addDataSegment(srv, mctx, "HIKAZ", 6, dbData, dataBuf);
+  GWEN_DB_Group_free(dbData);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  _addResult(dbResult, 20, "Auftrag ausgefuehrt", NULL);
+  return 0;
+}
+
+
+
+int _handleTransactionsCamt(HBCISRV *srv, HBCISRV_MSGCTX *mctx, GWEN_DB_NODE *dbSeg, GWEN_DB_NODE *dbResult,
+                            GWEN_BUFFER *dataBuf)
+{
+  GWEN_DB_NODE *dbData;
+  const char *accountId;
+  const char *s;
+  int rv;
+
+  accountId=GWEN_DB_GetCharValue(dbSeg, "accountid", 0, NULL);
+  if (_getAccountIndex(srv, mctx, accountId)<0) {
+    _addResult(dbResult, 9010, "Konto unbekannt", NULL);
+    return 0;
+  }
+
+  if (srv->camtData==NULL) {
+    _addResult(dbResult, 3010, "Keine Umsaetze vorhanden", NULL);
+    return 0;
+  }
+
+  dbData=GWEN_DB_Group_new("TransactionsCAMT");
+  s=GWEN_DB_GetCharValue(dbSeg, "iban", 0, NULL);
+  if (s)
+    GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "iban", s);
+  GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "bic", srv->bic);
+  GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "accountid", accountId);
+  _setKik(srv, dbData);
+  GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "format", HBCISRV_CAMT_FORMAT);
+  GWEN_DB_SetBinValue(dbData, GWEN_DB_FLAGS_DEFAULT, "booked/dayData",
+                      GWEN_Buffer_GetStart(srv->camtData), GWEN_Buffer_GetUsedBytes(srv->camtData));
+  rv=_addDataSegment(srv, mctx, "HICAZ", 1, dbData, dataBuf);
+  GWEN_DB_Group_free(dbData);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  _addResult(dbResult, 20, "Auftrag ausgefuehrt", NULL);
+  return 0;
+}
+
+
+
+int _handleTransfer(GWEN_UNUSED HBCISRV *srv, GWEN_UNUSED HBCISRV_MSGCTX *mctx, GWEN_DB_NODE *dbSeg,
+                    GWEN_DB_NODE *dbResult, GWEN_UNUSED GWEN_BUFFER *dataBuf)
+{
+  uint32_t len=0;
+
+  /* the pain message itself is not checked, just accepted */
+  if (GWEN_DB_GetBinValue(dbSeg, "transfer", 0, NULL, 0, &len)==NULL || len==0) {
+    _addResult(dbResult, 9110, "Keine SEPA-Nachricht enthalten", NULL);
+    return 0;
+  }
+
+  _addResult(dbResult, 20, "Auftrag ausgefuehrt", NULL);
+  return 0;
+}
+
+
+
+int _handleSepaInfo(HBCISRV *srv, HBCISRV_MSGCTX *mctx, GWEN_DB_NODE *dbSeg, GWEN_DB_NODE *dbResult,
+                    GWEN_BUFFER *dataBuf)
+{
+  GWEN_DB_NODE *dbData;
+  const char *accountId;
+  int first=0;
+  int last;
+  int i;
+  int rv;
+
+  last=srv->accountsPerUser-1;
+  accountId=GWEN_DB_GetCharValue(dbSeg, "accountid", 0, NULL);
+  if (accountId && *accountId) {
+    first=_getAccountIndex(srv, mctx, accountId);
+    if (first<0) {
+      _addResult(dbResult, 9010, "Konto unbekannt", NULL);
+      return 0;
+    }
+    last=first;
+  }
+
+  dbData=GWEN_DB_Group_new("GetAccountSepaInfoResponse");
+  for (i=first; i<=last; i++) {
+    GWEN_DB_NODE *dbAccount;
+    char accountNumber[32];
+    char iban[40];
+
+    _getAccountNumber(mctx->userNum, i, accountNumber, sizeof(accountNumber));
+    BenchGen_MakeIban(srv->bankCode, accountNumber, iban, sizeof(iban));
+
+    dbAccount=GWEN_DB_GetGroup(dbData, GWEN_PATH_FLAGS_CREATE_GROUP, "account");
+    GWEN_DB_SetCharValue(dbAccount, GWEN_DB_FLAGS_DEFAULT, "sepa", "J");
+    GWEN_DB_SetCharValue(dbAccount, GWEN_DB_FLAGS_DEFAULT, "iban", iban);
+    GWEN_DB_SetCharValue(dbAccount, GWEN_DB_FLAGS_DEFAULT, "bic", srv->bic);
+    GWEN_DB_SetCharValue(dbAccount, GWEN_DB_FLAGS_DEFAULT, "accountid", accountNumber);
+    _setKik(srv, dbAccount);
+  }
+  rv=_addDataSegment(srv, mctx, "HISPA", 1, dbData, dataBuf);
+  GWEN_DB_Group_free(dbData);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  _addResult(dbResult, 20, "Auftrag ausgefuehrt", NULL);
+  return 0;
+}
+
+
+
+int _addBpd(HBCISRV *srv, HBCISRV_MSGCTX *mctx, GWEN_BUFFER *dataBuf)
+{
+  GWEN_DB_NODE *dbData;
+  const char **pJob;
+  int rv;
+
+  /* general bank parameters */
+  dbData=GWEN_DB_Group_new("BPD");
+  GWEN_DB_SetIntValue(dbData, GWEN_DB_FLAGS_DEFAULT, "version", HBCISRV_BPD_VERSION);
+  _setKik(srv, dbData);
+  GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "name", "AqBanking Testbank");
+  GWEN_DB_SetIntValue(dbData, GWEN_DB_FLAGS_DEFAULT, "jobtypespermsg", 1);
+  GWEN_DB_SetIntValue(dbData, GWEN_DB_FLAGS_DEFAULT, "languages/language", 1);
+  GWEN_DB_SetIntValue(dbData, GWEN_DB_FLAGS_DEFAULT, "versions/version", 300);
+  rv=_addDataSegment(srv, mctx, "HIBPA", 3, dbData, dataBuf);
+  GWEN_DB_Group_free(dbData);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  /* PIN/TAN parameters: no job needs a TAN */
+  dbData=GWEN_DB_Group_new("PinTanBPD");
+  GWEN_DB_SetIntValue(dbData, GWEN_DB_FLAGS_DEFAULT, "jobspermsg", 1);
+  GWEN_DB_SetIntValue(dbData, GWEN_DB_FLAGS_DEFAULT, "minsigs", 1);
+  GWEN_DB_SetIntValue(dbData, GWEN_DB_FLAGS_DEFAULT, "minPinLen", 5);
+  GWEN_DB_SetIntValue(dbData, GWEN_DB_FLAGS_DEFAULT, "maxPinLen", 20);
+  GWEN_DB_SetIntValue(dbData, GWEN_DB_FLAGS_DEFAULT, "maxTanLen", 6);
+  GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "userIdText", "Benutzerkennung");
+  GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "customerIdText", "Kunden-ID");
+  for (pJob=_updJobs; *pJob; pJob++) {
+    GWEN_DB_NODE *dbJob;
+
+    dbJob=GWEN_DB_GetGroup(dbData, GWEN_PATH_FLAGS_CREATE_GROUP, "job");
+    GWEN_DB_SetCharValue(dbJob, GWEN_DB_FLAGS_DEFAULT, "job", *pJob);
+    GWEN_DB_SetCharValue(dbJob, GWEN_DB_FLAGS_DEFAULT, "needTan", "N");
+  }
+  rv=_addDataSegment(srv, mctx, "HIPINS", 1, dbData, dataBuf);
+  GWEN_DB_Group_free(dbData);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  /* job parameters */
+  rv=_addBpdJob(srv, mctx, "HISALS", 6, NULL, dataBuf);
+  if (rv==0) {
+    dbData=GWEN_DB_Group_new("HIKAZS");
+    GWEN_DB_SetIntValue(dbData, GWEN_DB_FLAGS_DEFAULT, "StoreDays", 360);
+    GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "MaxEntryAllowed", "N");
+    GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "AllAccountsAllowed", "N");
+    rv=_addBpdJob(srv, mctx, "HIKAZS", 6, dbData, dataBuf);
+    GWEN_DB_Group_free(dbData);
+  }
+  if (rv==0) {
+    dbData=GWEN_DB_Group_new("HICAZS");
+    GWEN_DB_SetIntValue(dbData, GWEN_DB_FLAGS_DEFAULT, "StoreDays", 360);
+    GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "MaxEntryAllowed", "N");
+    GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "AllAccountsAllowed", "N");
+    GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "supportedFormat", HBCISRV_CAMT_FORMAT);
+    rv=_addBpdJob(srv, mctx, "HICAZS", 1, dbData, dataBuf);
+    GWEN_DB_Group_free(dbData);
+  }
+  if (rv==0)
+    rv=_addBpdJob(srv, mctx, "HICCSS", 1, NULL, dataBuf);
+  if (rv==0) {
+    dbData=GWEN_DB_Group_new("HISPAS");
+    GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "AllowSingleAccount", "J");
+    GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "AllowNationalAccountSpec", "J");
+    GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "AllowStructuredPurpose", "N");
+    GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "SupportedSepaFormats/Format",
+                         "urn:iso:std:iso:20022:tech:xsd:pain.001.001.03");
+    GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "SupportedSepaFormats/Format",
+                         "urn:iso:std:iso:20022:tech:xsd:pain.001.003.03");
+    rv=_addBpdJob(srv, mctx, "HISPAS", 1, dbData, dataBuf);
+    GWEN_DB_Group_free(dbData);
+  }
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  return 0;
+}
+
+
+
+int _addBpdJob(HBCISRV *srv, HBCISRV_MSGCTX *mctx, const char *code, int version, GWEN_DB_NODE *dbData,
+               GWEN_BUFFER *dataBuf)
+{
+  GWEN_DB_NODE *dbJob;
+  int rv;
+
+  dbJob=dbData?GWEN_DB_Group_dup(dbData):GWEN_DB_Group_new(code);
+  GWEN_DB_SetIntValue(dbJob, GWEN_DB_FLAGS_OVERWRITE_VARS, "jobspermsg", 1);
+  GWEN_DB_SetIntValue(dbJob, GWEN_DB_FLAGS_OVERWRITE_VARS, "minsigs", 1);
+  GWEN_DB_SetIntValue(dbJob, GWEN_DB_FLAGS_OVERWRITE_VARS, "secProfile", 1);
+  rv=_addDataSegment(srv, mctx, code, version, dbJob, dataBuf);
+  GWEN_DB_Group_free(dbJob);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+  return 0;
+}
+
+
+
+int _addUpd(HBCISRV *srv, HBCISRV_MSGCTX *mctx, GWEN_BUFFER *dataBuf)
+{
+  GWEN_DB_NODE *dbData;
+  int i;
+  int rv;
+
+  dbData=GWEN_DB_Group_new("UserData");
+  GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "userid", mctx->userId);
+  GWEN_DB_SetIntValue(dbData, GWEN_DB_FLAGS_DEFAULT, "version", HBCISRV_UPD_VERSION);
+  GWEN_DB_SetIntValue(dbData, GWEN_DB_FLAGS_DEFAULT, "ignoreUPDJobs", 0);
+  GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "userName", "Test User");
+  rv=_addDataSegment(srv, mctx, "HIUPA", 4, dbData, dataBuf);
+  GWEN_DB_Group_free(dbData);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+
+  for (i=0; i<srv->accountsPerUser; i++) {
+    char accountNumber[32];
+    char iban[40];
+    const char **pJob;
+
+    _getAccountNumber(mctx->userNum, i, accountNumber, sizeof(accountNumber));
+    BenchGen_MakeIban(srv->bankCode, accountNumber, iban, sizeof(iban));
+
+    dbData=GWEN_DB_Group_new("AccountData");
+    GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "accountid", accountNumber);
+    _setKik(srv, dbData);
+    GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "iban", iban);
+    GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "customer", mctx->customerId);
+    GWEN_DB_SetIntValue(dbData, GWEN_DB_FLAGS_DEFAULT, "type", 1);
+    GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "currency", "EUR");
+    GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "name1", "Test User");
+    GWEN_DB_SetCharValue(dbData, GWEN_DB_FLAGS_DEFAULT, "account/name", "Girokonto");
+    for (pJob=_updJobs; *pJob; pJob++) {
+      GWEN_DB_NODE *dbJob;
+
+      dbJob=GWEN_DB_GetGroup(dbData, GWEN_PATH_FLAGS_CREATE_GROUP, "updjob");
+      GWEN_DB_SetCharValue(dbJob, GWEN_DB_FLAGS_DEFAULT, "job", *pJob);
+      GWEN_DB_SetIntValue(dbJob, GWEN_DB_FLAGS_DEFAULT, "minsign", 1);
+    }
+    rv=_addDataSegment(srv, mctx, "HIUPD", 6, dbData, dataBuf);
+    GWEN_DB_Group_free(dbData);
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      return rv;
+    }
+  }
+
+  return 0;
+}
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * message engine helpers
+ * ------------------------------------------------------------------------------------------------
+ */
+
+GWEN_DB_NODE_TYPE _msgEngineTypeCheck(GWEN_UNUSED GWEN_MSGENGINE *e, const char *tname)
+{
+  if (strcasecmp(tname, "date")==0 || strcasecmp(tname, "time")==0)
+    return GWEN_DB_NodeType_ValueChar;
+  return GWEN_DB_NodeType_Unknown;
+}
+
+
+
+const char *_msgEngineGetCharValue(GWEN_MSGENGINE *e, const char *name, const char *defValue)
+{
+  HBCISRV *srv;
+
+  srv=GWEN_INHERIT_GETDATA(GWEN_MSGENGINE, HBCISRV, e);
+  if (srv && strcasecmp(name, "bankcode")==0)
+    return srv->bankCode;
+  return defValue;
+}
+
+
+
+int _msgEngineGetIntValue(GWEN_UNUSED GWEN_MSGENGINE *e, const char *name, int defValue)
+{
+  if (strcasecmp(name, "country")==0)
+    return 280;
+  return defValue;
+}
+
+
+
+int _readSegments(GWEN_MSGENGINE *e, GWEN_BUFFER *mbuf, GWEN_DB_NODE *dbOut)
+{
+  GWEN_Buffer_Rewind(mbuf);
+  while (GWEN_Buffer_GetBytesLeft(mbuf)) {
+    int rv;
+
+    rv=_readSegment(e, mbuf, dbOut);
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      return rv;
+    }
+  }
+  return 0;
+}
+
+
+
+int _readSegment(GWEN_MSGENGINE *e, GWEN_BUFFER *mbuf, GWEN_DB_NODE *dbOut)
+{
+  GWEN_XMLNODE *node;
+  GWEN_DB_NODE *dbHead;
+  uint32_t posBak;
+  const char *code;
+  int segVer;
+
+  node=GWEN_MsgEngine_FindGroupByProperty(e, "id", 0, "SegHead");
+  if (node==NULL) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Segment description not found (definitions not loaded?)");
+    return GWEN_ERROR_NOT_FOUND;
+  }
+
+  /* parse segment head */
+  dbHead=GWEN_DB_Group_new("head");
+  posBak=GWEN_Buffer_GetPos(mbuf);
+  if (GWEN_MsgEngine_ParseMessage(e, node, mbuf, dbHead, 0)) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Error parsing segment head");
+    GWEN_DB_Group_free(dbHead);
+    return GWEN_ERROR_BAD_DATA;
+  }
+  GWEN_Buffer_SetPos(mbuf, posBak);
+
+  segVer=GWEN_DB_GetIntValue(dbHead, "version", 0, 0);
+  code=GWEN_DB_GetCharValue(dbHead, "code", 0, NULL);
+  if (code==NULL) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "No segment code");
+    GWEN_DB_Group_free(dbHead);
+    return GWEN_ERROR_BAD_DATA;
+  }
+
+  node=GWEN_MsgEngine_FindNodeByProperty(e, "SEG", "code", segVer, code);
+  if (node==NULL) {
+    GWEN_DB_NODE *dbSeg;
+
+    /* unknown segment: keep the head so that it gets a response, then skip it */
+    DBG_WARN(AQBANKING_LOGDOMAIN, "Unknown segment \"%s\" (version %d)", code, segVer);
+    dbSeg=GWEN_DB_GetGroup(dbOut, GWEN_PATH_FLAGS_CREATE_GROUP, code);
+    GWEN_DB_AddGroup(dbSeg, dbHead);
+    if (GWEN_MsgEngine_SkipSegment(e, mbuf, '?', '\'')) {
+      DBG_ERROR(AQBANKING_LOGDOMAIN, "Error skipping segment \"%s\"", code);
+      return GWEN_ERROR_BAD_DATA;
+    }
+  }
+  else {
+    GWEN_DB_NODE *dbSeg;
+
+    dbSeg=GWEN_DB_GetGroup(dbOut, GWEN_PATH_FLAGS_CREATE_GROUP, GWEN_XMLNode_GetProperty(node, "id", code));
+    GWEN_DB_Group_free(dbHead);
+    if (GWEN_MsgEngine_ParseMessage(e, node, mbuf, dbSeg, 0)) {
+      DBG_ERROR(AQBANKING_LOGDOMAIN, "Error parsing segment \"%s\"", code);
+      return GWEN_ERROR_BAD_DATA;
+    }
+  }
+
+  return 0;
+}
+
+
+
+int _createSegmentById(GWEN_MSGENGINE *e, const char *id, GWEN_DB_NODE *dbData, GWEN_BUFFER *destBuf)
+{
+  GWEN_XMLNODE *node;
+
+  node=GWEN_MsgEngine_FindNodeByPropertyStrictProto(e, "SEG", "id", 0, id);
+  if (node==NULL) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Segment \"%s\" not found", id);
+    return GWEN_ERROR_NOT_FOUND;
+  }
+  return _createSegmentFromNode(e, node, dbData, destBuf);
+}
+
+
+
+int _createSegmentByCode(GWEN_MSGENGINE *e, const char *code, int version, GWEN_DB_NODE *dbData,
+                         GWEN_BUFFER *destBuf)
+{
+  GWEN_XMLNODE *node;
+
+  node=GWEN_MsgEngine_FindNodeByProperty(e, "SEG", "code", version, code);
+  if (node==NULL) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Segment \"%s\" version %d not found", code, version);
+    return GWEN_ERROR_NOT_FOUND;
+  }
+  return _createSegmentFromNode(e, node, dbData, destBuf);
+}
+
+
+
+int _createSegmentFromNode(GWEN_MSGENGINE *e, GWEN_XMLNODE *node, GWEN_DB_NODE *dbData, GWEN_BUFFER *destBuf)
+{
+  GWEN_BUFFER *dbuf;
+  uint32_t len;
+  int rv;
+
+  dbuf=GWEN_Buffer_new(0, 256, 0, 1);
+  rv=GWEN_MsgEngine_CreateMessageFromNode(e, node, dbuf, dbData);
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    GWEN_Buffer_free(dbuf);
+    return rv;
+  }
+
+  /* remove trailing "+" (same as done by the client) */
+  len=GWEN_Buffer_GetUsedBytes(dbuf);
+  if (len>2) {
+    const char *ptr;
+    uint32_t pos;
+
+    ptr=GWEN_Buffer_GetStart(dbuf);
+    pos=len-2;
+    while (pos>0 && ptr[pos]=='+')
+      pos--;
+    GWEN_Buffer_AppendBytes(destBuf, ptr, pos+1);
+    GWEN_Buffer_AppendByte(destBuf, '\'');
+  }
+  else
+    GWEN_Buffer_AppendBuffer(destBuf, dbuf);
+  GWEN_Buffer_free(dbuf);
+  return 0;
+}
+
+
+
+int _addDataSegment(HBCISRV *srv, HBCISRV_MSGCTX *mctx, const char *code, int version, GWEN_DB_NODE *dbData,
+                    GWEN_BUFFER *destBuf)
+{
+  GWEN_DB_SetIntValue(dbData, GWEN_DB_FLAGS_OVERWRITE_VARS, "head/seq", mctx->nextSeq++);
+  return _createSegmentByCode(srv->msgEngine, code, version, dbData, destBuf);
+}
+
+
+
+void _addResult(GWEN_DB_NODE *dbResult, int code, const char *text, const char *param)
+{
+  GWEN_DB_NODE *dbT;
+
+  dbT=GWEN_DB_GetGroup(dbResult, GWEN_PATH_FLAGS_CREATE_GROUP, "result");
+  GWEN_DB_SetIntValue(dbT, GWEN_DB_FLAGS_DEFAULT, "resultcode", code);
+  GWEN_DB_SetCharValue(dbT, GWEN_DB_FLAGS_DEFAULT, "text", text);
+  if (param)
+    GWEN_DB_SetCharValue(dbT, GWEN_DB_FLAGS_DEFAULT, "param", param);
+}
+
+
+
+int _resultsHaveErrors(GWEN_DB_NODE *dbResult)
+{
+  GWEN_DB_NODE *dbT;
+
+  dbT=GWEN_DB_FindFirstGroup(dbResult, "result");
+  while (dbT) {
+    if (GWEN_DB_GetIntValue(dbT, "resultcode", 0, 0)>=9000)
+      return 1;
+    dbT=GWEN_DB_FindNextGroup(dbT, "result");
+  }
+  return 0;
+}
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * accounts
+ * ------------------------------------------------------------------------------------------------
+ */
+
+uint32_t _getUserNum(const char *userId)
+{
+  const char *s;
+  uint32_t h=2166136261u;
+
+  /* use trailing digits of the user id if any, so "user12" always gets the same accounts */
+  s=userId+strlen(userId);
+  while (s>userId && isdigit((int) s[-1]))
+    s--;
+  if (*s)
+    return (uint32_t) strtoul(s, NULL, 10)%1000000u;
+
+  for (s=userId; *s; s++) {
+    h^=(unsigned char) *s;
+    h*=16777619u;
+  }
+  return h%1000000u;
+}
+
+
+
+void _getAccountNumber(uint32_t userNum, int idx, char *buffer, int size)
+{
+  snprintf(buffer, size, "%06u%04d", (unsigned int) userNum, idx+1);
+}
+
+
+
+int _getAccountIndex(const HBCISRV *srv, const HBCISRV_MSGCTX *mctx, const char *accountId)
+{
+  char prefix[16];
+  int idx;
+
+  if (accountId==NULL || strlen(accountId)!=10)
+    return GWEN_ERROR_NOT_FOUND;
+  snprintf(prefix, sizeof(prefix), "%06u", (unsigned int) mctx->userNum);
+  if (strncmp(accountId, prefix, 6)!=0)
+    return GWEN_ERROR_NOT_FOUND;
+  idx=atoi(accountId+6)-1;
+  if (idx<0 || idx>=srv->accountsPerUser)
+    return GWEN_ERROR_NOT_FOUND;
+  return idx;
+}
+
+
+
+void _setKik(HBCISRV *srv, GWEN_DB_NODE *db)
+{
+  GWEN_DB_SetIntValue(db, GWEN_DB_FLAGS_OVERWRITE_VARS, "country", 280);
+  GWEN_DB_SetCharValue(db, GWEN_DB_FLAGS_OVERWRITE_VARS, "bankcode", srv->bankCode);
+}
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * statistics
+ * ------------------------------------------------------------------------------------------------
+ */
+
+void _startDialog(HBCISRV *srv, const char *dialogId)
+{
+  HBCISRV_DIALOG *dlg;
+
+  GWEN_NEW_OBJECT(HBCISRV_DIALOG, dlg);
+  dlg->dialogId=strdup(dialogId);
+  dlg->startTime=_now();
+  dlg->next=srv->openDialogs;
+  srv->openDialogs=dlg;
+  srv->statDialogs++;
+}
+
+
+
+void _endDialog(HBCISRV *srv, const char *dialogId)
+{
+  HBCISRV_DIALOG **pDlg;
+
+  for (pDlg=&(srv->openDialogs); *pDlg; pDlg=&((*pDlg)->next)) {
+    HBCISRV_DIALOG *dlg;
+
+    dlg=*pDlg;
+    if (strcmp(dlg->dialogId, dialogId)==0) {
+      _addTiming(&(srv->statDialogDuration), (_now()-dlg->startTime)*1000.0, 0);
+      *pDlg=dlg->next;
+      free(dlg->dialogId);
+      GWEN_FREE_OBJECT(dlg);
+      return;
+    }
+  }
+}
+
+
+
+void _addTiming(HBCISRV_TIMING *ti, double ms, uint32_t bytes)
+{
+  if (ti->count==0 || ms<ti->msMin)
+    ti->msMin=ms;
+  if (ms>ti->msMax)
+    ti->msMax=ms;
+  ti->msSum+=ms;
+  ti->bytes+=bytes;
+  ti->count++;
+}
+
+
+
+void _writeTiming(const HBCISRV_TIMING *ti, GWEN_BUFFER *buf)
+{
+  GWEN_Buffer_AppendArgs(buf,
+                         "{\"count\":%llu,\"bytes\":%llu,\"minMs\":%.3f,\"avgMs\":%.3f,\"maxMs\":%.3f}",
+                         (unsigned long long) ti->count,
+                         (unsigned long long) ti->bytes,
+                         ti->msMin,
+                         ti->count?(ti->msSum/ti->count):0.0,
+                         ti->msMax);
+}
+
+
+
+void HbciSrv_WriteStats(const HBCISRV *srv, GWEN_BUFFER *buf)
+{
+  int i;
+
+  GWEN_Buffer_AppendArgs(buf,
+                         "{\"dialogs\":%llu,\"messages\":%llu,\"bytesIn\":%llu,\"bytesOut\":%llu,\"dialogDuration\":",
+                         (unsigned long long) srv->statDialogs,
+                         (unsigned long long) srv->statMessages,
+                         (unsigned long long) srv->statBytesIn,
+                         (unsigned long long) srv->statBytesOut);
+  _writeTiming(&(srv->statDialogDuration), buf);
+  GWEN_Buffer_AppendString(buf, ",\"phases\":{");
+  for (i=0; i<HbciSrv_Phase_Count; i++) {
+    if (i)
+      GWEN_Buffer_AppendByte(buf, ',');
+    GWEN_Buffer_AppendArgs(buf, "\"%s\":", _phaseNames[i]);
+    _writeTiming(&(srv->statPhases[i]), buf);
+  }
+  GWEN_Buffer_AppendString(buf, "}}");
+}
+
+
+
+void HbciSrv_ResetStats(HBCISRV *srv)
+{
+  srv->statDialogs=0;
+  srv->statMessages=0;
+  srv->statBytesIn=0;
+  srv->statBytesOut=0;
+  memset(&(srv->statDialogDuration), 0, sizeof(srv->statDialogDuration));
+  memset(srv->statPhases, 0, sizeof(srv->statPhases));
+}
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * HTTP
+ * ------------------------------------------------------------------------------------------------
+ */
+
+int _handleConnection(HBCISRV *srv, int sk)
+{
+  GWEN_BUFFER *hbuf;
+  GWEN_BUFFER *bbuf;
+  GWEN_BUFFER *rbuf;
+  const char *s;
+  int rv;
+
+  hbuf=GWEN_Buffer_new(0, 1024, 0, 1);
+  bbuf=GWEN_Buffer_new(0, 1024, 0, 1);
+  rv=_readRequest(sk, hbuf, bbuf);
+  if (rv<=0) {
+    /* connection test by the client (connect and close) or broken request */
+    GWEN_Buffer_free(bbuf);
+    GWEN_Buffer_free(hbuf);
+    return rv;
+  }
+
+  rbuf=GWEN_Buffer_new(0, 1024, 0, 1);
+  s=GWEN_Buffer_GetStart(hbuf);
+  if (strncmp(s, "GET /stats", 10)==0) {
+    HbciSrv_WriteStats(srv, rbuf);
+    GWEN_Buffer_AppendByte(rbuf, '\n');
+    if (strncmp(s, "GET /stats?reset=1", 18)==0)
+      HbciSrv_ResetStats(srv);
+    rv=_writeResponse(sk, 200, "application/json", GWEN_Buffer_GetStart(rbuf), GWEN_Buffer_GetUsedBytes(rbuf));
+  }
+  else if (strncmp(s, "POST ", 5)==0) {
+    srv->statBytesIn+=GWEN_Buffer_GetUsedBytes(bbuf);
+    rv=_handlePost(srv, bbuf, rbuf);
+    if (rv<0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+      rv=_writeResponse(sk, 400, "text/plain", "Bad request\n", 12);
+    }
+    else {
+      srv->statBytesOut+=GWEN_Buffer_GetUsedBytes(rbuf);
+      if (srv->latencyMs)
+        _sleepMs(srv->latencyMs);
+      rv=_writeResponse(sk, 200, "application/octet-stream", GWEN_Buffer_GetStart(rbuf), GWEN_Buffer_GetUsedBytes(rbuf));
+    }
+  }
+  else
+    rv=_writeResponse(sk, 404, "text/plain", "Not found\n", 10);
+
+  GWEN_Buffer_free(rbuf);
+  GWEN_Buffer_free(bbuf);
+  GWEN_Buffer_free(hbuf);
+  return rv;
+}
+
+
+
+int _handlePost(HBCISRV *srv, GWEN_BUFFER *bbuf, GWEN_BUFFER *rbuf)
+{
+  const char *ptr;
+  uint32_t len;
+  int rv;
+
+  ptr=GWEN_Buffer_GetStart(bbuf);
+  len=GWEN_Buffer_GetUsedBytes(bbuf);
+  while (len && isspace((int) ptr[len-1]))
+    len--;
+
+  if (len>6 && strncmp(ptr, "HNHBK:", 6)==0) {
+    /* raw message, answer raw */
+    rv=HbciSrv_HandleMessage(srv, (const uint8_t *) ptr, len, rbuf);
+  }
+  else {
+    GWEN_BUFFER *dbuf;
+    GWEN_BUFFER *msgBuf;
+
+    /* base64 encoded message, answer the same way */
+    dbuf=GWEN_Buffer_new(0, len, 0, 1);
+    rv=GWEN_Base64_Decode((const unsigned char *) ptr, len, dbuf);
+    if (rv<0) {
+      DBG_ERROR(AQBANKING_LOGDOMAIN, "Could not decode base64 data (%d)", rv);
+      GWEN_Buffer_free(dbuf);
+      return rv;
+    }
+    msgBuf=GWEN_Buffer_new(0, 1024, 0, 1);
+    rv=HbciSrv_HandleMessage(srv, (const uint8_t *) GWEN_Buffer_GetStart(dbuf), GWEN_Buffer_GetUsedBytes(dbuf), msgBuf);
+    GWEN_Buffer_free(dbuf);
+    if (rv==0)
+      rv=GWEN_Base64_Encode((const unsigned char *) GWEN_Buffer_GetStart(msgBuf), GWEN_Buffer_GetUsedBytes(msgBuf), rbuf, 0);
+    GWEN_Buffer_free(msgBuf);
+  }
+
+  if (rv<0) {
+    DBG_INFO(AQBANKING_LOGDOMAIN, "here (%d)", rv);
+    return rv;
+  }
+  return 0;
+}
+
+
+
+/* returns 0 if the peer closed the connection without sending anything, 1 if a request was read */
+int _readRequest(int sk, GWEN_BUFFER *hbuf, GWEN_BUFFER *bbuf)
+{
+  struct timeval tv;
+  char buffer[4096];
+  const char *hdrEnd=NULL;
+  uint32_t hdrLen;
+  uint32_t contentLength=0;
+  const char *s;
+
+  tv.tv_sec=HBCISRV_RECV_TIMEOUT;
+  tv.tv_usec=0;
+  setsockopt(sk, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+  /* read header */
+  while (hdrEnd==NULL) {
+    ssize_t got;
+
+    got=recv(sk, buffer, sizeof(buffer), 0);
+    if (got<0) {
+      if (errno==EINTR)
+        continue;
+      DBG_INFO(AQBANKING_LOGDOMAIN, "recv(): %s", strerror(errno));
+      return GWEN_ERROR_IO;
+    }
+    if (got==0) {
+      if (GWEN_Buffer_GetUsedBytes(hbuf)==0)
+        return 0;
+      DBG_INFO(AQBANKING_LOGDOMAIN, "Connection closed inside header");
+      return GWEN_ERROR_EOF;
+    }
+    GWEN_Buffer_AppendBytes(hbuf, buffer, got);
+    hdrEnd=strstr(GWEN_Buffer_GetStart(hbuf), "\r\n\r\n");
+    if (hdrEnd==NULL && GWEN_Buffer_GetUsedBytes(hbuf)>HBCISRV_MAX_HEADER_SIZE) {
+      DBG_ERROR(AQBANKING_LOGDOMAIN, "Header too long");
+      return GWEN_ERROR_BAD_DATA;
+    }
+  }
+
+  /* move data behind the header into the body buffer */
+  hdrLen=(hdrEnd-GWEN_Buffer_GetStart(hbuf))+4;
+  GWEN_Buffer_AppendBytes(bbuf, GWEN_Buffer_GetStart(hbuf)+hdrLen, GWEN_Buffer_GetUsedBytes(hbuf)-hdrLen);
+  GWEN_Buffer_Crop(hbuf, 0, hdrLen);
+
+  /* get content length */
+  for (s=GWEN_Buffer_GetStart(hbuf); s && *s; s=strchr(s, '\n')) {
+    if (*s=='\n')
+      s++;
+    if (strncasecmp(s, "Content-Length:", 15)==0) {
+      contentLength=(uint32_t) strtoul(s+15, NULL, 10);
+      break;
+    }
+  }
+  if (contentLength>HBCISRV_MAX_BODY_SIZE) {
+    DBG_ERROR(AQBANKING_LOGDOMAIN, "Body too large (%u bytes)", (unsigned int) contentLength);
+    return GWEN_ERROR_BAD_DATA;
+  }
+
+  /* read body */
+  while (GWEN_Buffer_GetUsedBytes(bbuf)<contentLength) {
+    ssize_t got;
+
+    got=recv(sk, buffer, sizeof(buffer), 0);
+    if (got<0) {
+      if (errno==EINTR)
+        continue;
+      DBG_INFO(AQBANKING_LOGDOMAIN, "recv(): %s", strerror(errno));
+      return GWEN_ERROR_IO;
+    }
+    if (got==0) {
+      DBG_INFO(AQBANKING_LOGDOMAIN, "Connection closed inside body");
+      return GWEN_ERROR_EOF;
+    }
+    GWEN_Buffer_AppendBytes(bbuf, buffer, got);
+  }
+
+  return 1;
+}
+
+
+
+int _writeResponse(int sk, int code, const char *contentType, const char *ptr, uint32_t len)
+{
+  char header[256];
+  int rv;
+
+  snprintf(header, sizeof(header),
+           "HTTP/1.1 %d %s\r\n"
+           "Content-Type: %s\r\n"
+           "Content-Length: %u\r\n"
+           "Connection: close\r\n"
+           "\r\n",
+           code, (code==200)?"OK":((code==404)?"Not Found":"Bad Request"),
+           contentType, (unsigned int) len);
+  rv=_writeAll(sk, header, strlen(header));
+  if (rv==0 && len)
+    rv=_writeAll(sk, ptr, len);
+  return rv;
+}
+
+
+
+int _writeAll(int sk, const char *ptr, uint32_t len)
+{
+  while (len) {
+    ssize_t written;
+
+    written=send(sk, ptr, len, MSG_NOSIGNAL);
+    if (written<0) {
+      if (errno==EINTR)
+        continue;
+      DBG_INFO(AQBANKING_LOGDOMAIN, "send(): %s", strerror(errno));
+      return GWEN_ERROR_IO;
+    }
+    ptr+=written;
+    len-=written;
+  }
+  return 0;
+}
+
+
+
+void _sleepMs(int ms)
+{
+  struct timespec ts;
+
+  ts.tv_sec=ms/1000;
+  ts.tv_nsec=(ms%1000)*1000000L;
+  while (nanosleep(&ts, &ts)==-1 && errno==EINTR);
+}
+
+
+
+double _now(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return (double) tv.tv_sec+((double) tv.tv_usec)/1000000.0;
+}
+
+
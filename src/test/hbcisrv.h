@@ -0,0 +1,104 @@
+/***************************************************************************
+    begin       : Mon Oct 19 2026
+    copyright   : (C) 2026 by Martin Preuss
+    email       : martin@libchipcard.de
+
+ ***************************************************************************
+ * This file is part of the project "AqBanking".                           *
+ * Please see toplevel file COPYING of that project for license details.   *
+ ***************************************************************************/
+
+/** @file hbcisrv.h
+ * @short Synthetic FinTS 3.0 PIN/TAN bank server for end-to-end tests.
+ *
+ * The server answers HBCI messages received via HTTP POST on a local socket. Messages are parsed and
+ * created using the same XML definitions as the aqhbci backend (hbci.xml), so the client code is
+ * exercised exactly as with a real bank.
+ *
+ * Supported are dialog initialisation and end, synchronisation (HKSYN), BPD/UPD, balance (HKSAL),
+ * transactions as MT940 (HKKAZ) and CAMT (HKCAZ), SEPA account info (HKSPA) and SEPA transfers
+ * (HKCCS). Every user gets the same configurable number of accounts, PINs are not checked and only
+ * one-step TAN (999) is offered.
+ *
+ * A request "GET /stats" returns the collected statistics as JSON, "GET /stats?reset=1" also resets them.
+ */
+
+
+#ifndef AB_HBCISRV_H
+#define AB_HBCISRV_H
+
+
+#include <aqbanking/banking.h>
+
+#include <gwenhywfar/buffer.h>
+
+
+#define HBCISRV_DEFAULT_BANKCODE "10020030"
+#define HBCISRV_DEFAULT_BIC      "TESTDEFFXXX"
+#define HBCISRV_DEFAULT_ACCOUNTS 3
+
+
+typedef struct HBCISRV HBCISRV;
+
+
+HBCISRV *HbciSrv_new(void);
+void HbciSrv_free(HBCISRV *srv);
+
+/**
+ * Load message definitions (normally the file "hbci.xml" from the aqhbci backend).
+ */
+int HbciSrv_LoadDefinitions(HBCISRV *srv, const char *fileName);
+
+void HbciSrv_SetBankCode(HBCISRV *srv, const char *s);
+void HbciSrv_SetBic(HBCISRV *srv, const char *s);
+void HbciSrv_SetAccountsPerUser(HBCISRV *srv, int i);
+
+/** Delay in milliseconds added before every response is sent */
+void HbciSrv_SetLatency(HBCISRV *srv, int ms);
+
+/** Data returned as booked transactions for HKKAZ (MT940) */
+void HbciSrv_SetMt940Data(HBCISRV *srv, const char *ptr, uint32_t len);
+
+/** Data returned as booked transactions for HKCAZ (camt.052) */
+void HbciSrv_SetCamtData(HBCISRV *srv, const char *ptr, uint32_t len);
+
+/**
+ * Generate MT940 and camt.052 data with the given number of transactions per account (see benchgen.h).
+ * @param ab AqBanking object used to export the camt data
+ */
+int HbciSrv_CreatePayloads(HBCISRV *srv, AB_BANKING *ab, int transactions, uint32_t seed);
+
+
+/**
+ * Open the listening socket.
+ * @return port number (useful when called with port 0), error code otherwise
+ */
+int HbciSrv_Listen(HBCISRV *srv, const char *address, int port);
+
+/**
+ * Handle incoming connections until @ref HbciSrv_Stop has been called.
+ */
+int HbciSrv_Run(HBCISRV *srv);
+
+/**
+ * Make @ref HbciSrv_Run return. Only sets a flag, so it can be called from a signal handler.
+ */
+void HbciSrv_Stop(void);
+
+
+/**
+ * Handle a single decoded HBCI message and write the response message to the given buffer.
+ * This is the function used by @ref HbciSrv_Run for every POST request.
+ */
+int HbciSrv_HandleMessage(HBCISRV *srv, const uint8_t *ptr, uint32_t len, GWEN_BUFFER *destBuf);
+
+/**
+ * Write the current statistics as a JSON object into the given buffer.
+ */
+void HbciSrv_WriteStats(const HBCISRV *srv, GWEN_BUFFER *buf);
+
+void HbciSrv_ResetStats(HBCISRV *srv);
+
+
+#endif
+
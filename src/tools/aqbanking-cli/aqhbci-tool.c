@@ -111,6 +111,17 @@ int main(int argc, char **argv)
       "Tool for optical TAN challenges", /* short description */
       "Specify an external tool to display optical TAN challenges" /* long description */
     },
+    {
+      0,                            /* flags */
+      GWEN_ArgsType_Int,            /* type */
+      "stats",                      /* name */
+      0,                            /* minnum */
+      1,                            /* maxnum */
+      NULL,                         /* short option */
+      "stats",                      /* long option */
+      "Print timing statistics",    /* short description */
+      "Print timing statistics of the HBCI message pipeline after the command has finished" /* long description */
+    },
     {
       GWEN_ARGS_FLAGS_HELP | GWEN_ARGS_FLAGS_LAST, /* flags */
       GWEN_ArgsType_Int,            /* type */
@@ -235,6 +246,8 @@ int main(int argc, char **argv)
 
   AB_Banking_RuntimeConfig_SetCharValue(ab, "fintsRegistrationKey", "32F8A67FE34B57AB8D7E4FE70");
   AB_Banking_RuntimeConfig_SetCharValue(ab, "fintsApplicationVersionString", AQBANKING_FINTS_VERSION_STRING);
+  if (GWEN_DB_GetIntValue(db, "stats", 0, 0))
+    AB_Banking_RuntimeConfig_SetIntValue(ab, "aqhbciStats", 1);
 
   AB_Gui_Extend(gui, ab);
 
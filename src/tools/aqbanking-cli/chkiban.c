@@ -14,6 +14,18 @@
 #include "globals.h"
 #include <gwenhywfar/text.h>
 
+#include <string.h>
+
+
+#define CHKIBAN_BATCH_SIZE 1024
+#define CHKIBAN_MAX_LINE   256
+
+
+
+static int _checkIbansFromStdin(void);
+static int _checkIbanBatch(char lines[][CHKIBAN_MAX_LINE], int count);
+static const char *_ibanCheckResultToString(AB_IBANCHECK_RESULT res);
+
 
 
 int chkIban(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv)
@@ -27,13 +39,25 @@ int chkIban(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv)
       GWEN_ARGS_FLAGS_HAS_ARGUMENT, /* flags */
       GWEN_ArgsType_Char,            /* type */
       "iban",                       /* name */
-      1,                            /* minnum */
+      0,                            /* minnum */
       1,                            /* maxnum */
       0,                            /* short option */
       "iban",                       /* long option */
       "Specify the IBAN to check",  /* short description */
       "Specify the IBAN to check"   /* long description */
     },
+    {
+      0,                            /* flags */
+      GWEN_ArgsType_Int,            /* type */
+      "stdin",                      /* name */
+      0,                            /* minnum */
+      1,                            /* maxnum */
+      0,                            /* short option */
+      "stdin",                      /* long option */
+      "Read IBANs from stdin",      /* short description */
+      "Read IBANs from stdin, one per line, optionally followed by a TAB or \";\" and a BIC.\n"
+      "Prints every line followed by a TAB and the result of the check."
+    },
     {
       GWEN_ARGS_FLAGS_HELP | GWEN_ARGS_FLAGS_LAST, /* flags */
       GWEN_ArgsType_Int,             /* type */
@@ -71,7 +95,7 @@ int chkIban(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv)
                  "Return codes:\n"
                  " 1: missing/bad arguments\n"
                  " 2: error while initializing AqBanking\n"
-                 " 3: given combination is definately invalid\n"
+                 " 3: given IBAN (or at least one of the IBANs read from stdin) is invalid\n"
                  " 5: error while deinitializing AqBanking\n"
                  "\n"
                  "Arguments:\n"
@@ -82,7 +106,10 @@ int chkIban(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv)
   }
 
   iban=GWEN_DB_GetCharValue(db, "iban", 0, 0);
-  assert(iban);
+  if (!GWEN_DB_GetIntValue(db, "stdin", 0, 0) && !(iban && *iban)) {
+    fprintf(stderr, "ERROR: Either --iban or --stdin is needed\n");
+    return 1;
+  }
 
   rv=AB_Banking_Init(ab);
   if (rv) {
@@ -90,11 +117,24 @@ int chkIban(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv)
     return 2;
   }
 
-  res=AB_Banking_CheckIban(iban);
-  if (res != 0) {
-    DBG_ERROR(0,
-              "IBAN is invalid");
-    return 3;
+  if (GWEN_DB_GetIntValue(db, "stdin", 0, 0)) {
+    rv=_checkIbansFromStdin();
+    if (rv<0) {
+      AB_Banking_Fini(ab);
+      return 1;
+    }
+    else if (rv>0) {
+      AB_Banking_Fini(ab);
+      return 3;
+    }
+  }
+  else {
+    res=AB_Banking_CheckIban(iban);
+    if (res != 0) {
+      DBG_ERROR(0,
+                "IBAN is invalid");
+      return 3;
+    }
   }
 
   rv=AB_Banking_Fini(ab);
@@ -108,6 +148,99 @@ int chkIban(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv)
 
 
 
+/* returns the number of invalid IBANs */
+int _checkIbansFromStdin(void)
+{
+  static char lines[CHKIBAN_BATCH_SIZE][CHKIBAN_MAX_LINE];
+  int count=0;
+  int errors=0;
+
+  while (fgets(lines[count], CHKIBAN_MAX_LINE, stdin)) {
+    char *p;
+
+    /* strip line end */
+    p=strchr(lines[count], '\n');
+    if (p==NULL && !feof(stdin)) {
+      fprintf(stderr, "ERROR: Line too long\n");
+      return GWEN_ERROR_BAD_DATA;
+    }
+    if (p)
+      *p=0;
+    p=strchr(lines[count], '\r');
+    if (p)
+      *p=0;
+    if (lines[count][0]==0)
+      continue;
+
+    count++;
+    if (count>=CHKIBAN_BATCH_SIZE) {
+      errors+=_checkIbanBatch(lines, count);
+      count=0;
+    }
+  }
+  if (count)
+    errors+=_checkIbanBatch(lines, count);
+
+  return errors;
+}
 
 
 
+int _checkIbanBatch(char lines[][CHKIBAN_MAX_LINE], int count)
+{
+  const char *ibans[CHKIBAN_BATCH_SIZE];
+  const char *bics[CHKIBAN_BATCH_SIZE];
+  char separators[CHKIBAN_BATCH_SIZE];
+  AB_IBANCHECK_RESULT results[CHKIBAN_BATCH_SIZE];
+  int errors;
+  int i;
+
+  /* split lines into IBAN and BIC */
+  for (i=0; i<count; i++) {
+    char *p;
+
+    ibans[i]=lines[i];
+    bics[i]=NULL;
+    separators[i]=0;
+    p=strpbrk(lines[i], "\t;");
+    if (p) {
+      separators[i]=*p;
+      *p=0;
+      bics[i]=p+1;
+    }
+  }
+
+  errors=AB_Banking_CheckIbans(ibans, bics, count, results);
+
+  for (i=0; i<count; i++) {
+    if (separators[i])
+      fprintf(stdout, "%s%c%s\t%s\n", ibans[i], separators[i], bics[i], _ibanCheckResultToString(results[i]));
+    else
+      fprintf(stdout, "%s\t%s\n", ibans[i], _ibanCheckResultToString(results[i]));
+  }
+
+  return errors;
+}
+
+
+
+const char *_ibanCheckResultToString(AB_IBANCHECK_RESULT res)
+{
+  switch (res) {
+  case AB_IbanCheckResult_Ok:
+    return "ok";
+  case AB_IbanCheckResult_Missing:
+    return "missing";
+  case AB_IbanCheckResult_BadFormat:
+    return "bad format";
+  case AB_IbanCheckResult_BadLength:
+    return "bad length";
+  case AB_IbanCheckResult_BadStructure:
+    return "bad structure";
+  case AB_IbanCheckResult_BadChecksum:
+    return "bad checksum";
+  case AB_IbanCheckResult_BadBic:
+    return "bad BIC";
+  }
+  return "unknown";
+}
@@ -21,8 +21,8 @@
 
 /* forward declarations */
 static GWEN_DB_NODE *_readCommandLine(GWEN_DB_NODE *dbArgs, int argc, char **argv);
-static int _copyTransactionsAndFillGaps(AB_IMEXPORTER_CONTEXT *inCtx,
-                                        AB_ACCOUNT_SPEC_LIST *accountSpecList,
+static int _copyTransactionsAndFillGaps(AB_BANKING *ab,
+                                        AB_IMEXPORTER_CONTEXT *inCtx,
                                         AB_IMEXPORTER_CONTEXT *outCtx);
 
 
@@ -36,7 +36,6 @@ int fillGaps(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv)
   int noWriteOnError=0;
   AB_IMEXPORTER_CONTEXT *inCtx=NULL;
   AB_IMEXPORTER_CONTEXT *outCtx=NULL;
-  AB_ACCOUNT_SPEC_LIST *accountSpecList=NULL;
 
   /* parse command line arguments */
   db=_readCommandLine(dbArgs, argc, argv);
@@ -64,17 +63,9 @@ int fillGaps(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv)
     return 4;
   }
 
-  /* read account list */
-  rv=AB_Banking_GetAccountSpecList(ab, &accountSpecList);
-  if (rv<0) {
-    DBG_INFO(0, "here (%d)", rv);
-    AB_Banking_Fini(ab);
-    return 4;
-  }
-
   /* fill gaps */
   outCtx=AB_ImExporterContext_new();
-  rv=_copyTransactionsAndFillGaps(inCtx, accountSpecList, outCtx);
+  rv=_copyTransactionsAndFillGaps(ab, inCtx, outCtx);
   if (rv<0) {
     if (noWriteOnError) {
       DBG_ERROR(0, "Some transactions could not be assigned to configured accounts, nothing written.");
@@ -175,8 +166,8 @@ GWEN_DB_NODE *_readCommandLine(GWEN_DB_NODE *dbArgs, int argc, char **argv)
 
 
 
-int _copyTransactionsAndFillGaps(AB_IMEXPORTER_CONTEXT *inCtx,
-                                 AB_ACCOUNT_SPEC_LIST *accountSpecList,
+int _copyTransactionsAndFillGaps(AB_BANKING *ab,
+                                 AB_IMEXPORTER_CONTEXT *inCtx,
                                  AB_IMEXPORTER_CONTEXT *outCtx)
 {
   AB_IMEXPORTER_ACCOUNTINFO *iea;
@@ -194,7 +185,7 @@ int _copyTransactionsAndFillGaps(AB_IMEXPORTER_CONTEXT *inCtx,
 
       tCopy=AB_Transaction_dup(t);
 
-      as=pickAccountSpecForTransaction(accountSpecList, tCopy);
+      as=pickAccountSpecForTransaction(ab, tCopy);
       if (as==NULL) {
         DBG_ERROR(0, "Could not determine account for transaction %d", transactionCount);
         allOk=0;
@@ -203,6 +194,7 @@ int _copyTransactionsAndFillGaps(AB_IMEXPORTER_CONTEXT *inCtx,
 
       /* fill missing fields in transaction from account spec */
       AB_Banking_FillTransactionFromAccountSpec(tCopy, as);
+      AB_AccountSpec_free(as);
 
       /* add to new context */
       AB_ImExporterContext_AddTransaction(outCtx, tCopy);
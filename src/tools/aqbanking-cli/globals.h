@@ -49,6 +49,8 @@ typedef enum {
 #define AQBANKING_TOOL_REQUEST_ESTATEMENTS   0x0008
 #define AQBANKING_TOOL_REQUEST_DEPOT         0x0010
 
+#define AQBANKING_TOOL_REQUEST_INCREMENTAL   0x4000
+
 #define AQBANKING_TOOL_REQUEST_IGNORE_UNSUP  0x8000
 
 
@@ -81,7 +83,11 @@ AB_ACCOUNT_SPEC *getSingleSelectedAccount(AB_BANKING *ab, GWEN_DB_NODE *db);
 
 
 AB_ACCOUNT_SPEC *pickAccountSpecForArgs(const AB_ACCOUNT_SPEC_LIST *accountSpecList, GWEN_DB_NODE *db);
-AB_ACCOUNT_SPEC *pickAccountSpecForTransaction(const AB_ACCOUNT_SPEC_LIST *as, const AB_TRANSACTION *t);
+/**
+ * Return a copy of the account spec the given transaction belongs to (or NULL if none or multiple candidates match).
+ * The caller is responsible for freeing the account spec returned.
+ */
+AB_ACCOUNT_SPEC *pickAccountSpecForTransaction(AB_BANKING *ab, const AB_TRANSACTION *t);
 
 
 
@@ -123,6 +129,32 @@ int addTransactionToBufferByTemplate(const AB_TRANSACTION *t, const char *tmplSt
 
 
 
+/* ========================================================================================================================
+ *                                                main.c
+ * ========================================================================================================================
+ */
+
+/**
+ * Execute the given command (all commands except "serve").
+ * @return exit code for the command
+ */
+int execCommand(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, const char *cmd, int argc, char **argv);
+
+
+
+/* ========================================================================================================================
+ *                                                serve.c
+ * ========================================================================================================================
+ */
+
+/**
+ * Send a command to the server listening on the given socket and wait for its exit code.
+ * stdin, stdout and stderr are handed over to the server for the duration of the command.
+ */
+int sendToServer(const char *socketPath, int argc, char **argv);
+
+
+
 /* ========================================================================================================================
  *                                                Commands
  * ========================================================================================================================
@@ -147,6 +179,7 @@ int sepaMultiJobs(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv,
                   AQBANKING_TOOL_MULTISEPA_TYPE multisepa_type);
 int sepaRecurTransfer(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv);
 int sepaTransfer(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv);
+int serve(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv);
 int updateConf(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv);
 int versions(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv);
 
@@ -13,22 +13,96 @@
 
 #include "globals.h"
 #include <gwenhywfar/text.h>
+#include <gwenhywfar/stringlist.h>
 
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#ifndef OS_WIN32
+# include <sys/types.h>
+# include <sys/wait.h>
+# include <unistd.h>
+# include <glob.h>
+#else
+# include <windows.h>
+#endif
+
+
+
+typedef struct IMPORT_PARAMS IMPORT_PARAMS;
+struct IMPORT_PARAMS {
+  const char *importerName;
+  const char *profileName;
+  const char *profileFile;
+};
+
+
+typedef struct IMPORT_FILE IMPORT_FILE;
+struct IMPORT_FILE {
+  const char *fileName;
+  int result;
+  uint64_t usecs;
+  AB_IMEXPORTER_CONTEXT *ctx;
+#ifndef OS_WIN32
+  pid_t pid;
+  int resultFd;
+#endif
+};
+
+
+#ifndef OS_WIN32
+/* sent from a worker process to the main process */
+typedef struct IMPORT_WORKER_RESULT IMPORT_WORKER_RESULT;
+struct IMPORT_WORKER_RESULT {
+  int result;
+  uint64_t usecs;
+};
+#endif
 
 
 
+/* ------------------------------------------------------------------------------------------------
+ * forward declarations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+static int _collectInputFiles(GWEN_DB_NODE *db, GWEN_STRINGLIST *sl);
+static int _addFileOrPattern(GWEN_STRINGLIST *sl, const char *s);
+static int _readFileList(GWEN_STRINGLIST *sl, const char *listFile);
+static int _importFile(AB_BANKING *ab, const IMPORT_PARAMS *params, const char *fileName,
+                       AB_IMEXPORTER_CONTEXT **pCtx);
+static void _importFilesSequentially(AB_BANKING *ab, const IMPORT_PARAMS *params, IMPORT_FILE *files, int count);
+#ifndef OS_WIN32
+static int _importFilesInWorkers(AB_BANKING *ab, const IMPORT_PARAMS *params, IMPORT_FILE *files, int count, int jobs);
+static int _startWorker(AB_BANKING *ab, const IMPORT_PARAMS *params, IMPORT_FILE *f, const char *tmpFile);
+static void _finishWorker(IMPORT_FILE *f, int status);
+#endif
+static void _reportFile(const IMPORT_FILE *f);
+static int _countTransactions(const AB_IMEXPORTER_CONTEXT *ctx);
+static uint64_t _now(void);
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * implementations
+ * ------------------------------------------------------------------------------------------------
+ */
+
 int import(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv)
 {
   GWEN_DB_NODE *db;
   int rv;
   const char *ctxFile;
-  const char *inFile;
-  const char *importerName;
-  const char *profileName;
-  const char *profileFile;
   const char *bankId;
   const char *accountId;
-  AB_IMEXPORTER_CONTEXT *ctx=0;
+  IMPORT_PARAMS params;
+  GWEN_STRINGLIST *sl;
+  int count;
+  int jobs;
+  int ignoreErrors;
+  int mergeSorted;
+  AB_IMEXPORTER_CONTEXT *ctx=NULL;
   const GWEN_ARGS args[]= {
     {
       GWEN_ARGS_FLAGS_HAS_ARGUMENT, /* flags */
@@ -46,11 +120,59 @@ int import(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv)
       GWEN_ArgsType_Char,            /* type */
       "inFile",                     /* name */
       0,                            /* minnum */
-      1,                            /* maxnum */
+      99,                           /* maxnum */
       "f",                          /* short option */
       "infile",                    /* long option */
       "Specify the file to read the data from",   /* short description */
-      "Specify the file to read the data from"      /* long description */
+      "Specify the file to read the data from.\n"
+      "Can be given multiple times and may contain wildcards (e.g. \"*.sta\")."
+    },
+    {
+      GWEN_ARGS_FLAGS_HAS_ARGUMENT, /* flags */
+      GWEN_ArgsType_Char,            /* type */
+      "fileList",                   /* name */
+      0,                            /* minnum */
+      1,                            /* maxnum */
+      0,                            /* short option */
+      "filelist",                   /* long option */
+      "Read names of files to import from the given file (\"-\" for stdin)",   /* short description */
+      "Read names of files to import from the given file (\"-\" for stdin), one name per line"
+    },
+    {
+      GWEN_ARGS_FLAGS_HAS_ARGUMENT, /* flags */
+      GWEN_ArgsType_Int,             /* type */
+      "jobs",                       /* name */
+      0,                            /* minnum */
+      1,                            /* maxnum */
+      "j",                          /* short option */
+      "jobs",                       /* long option */
+      "Number of files to import in parallel",   /* short description */
+      "Number of files to import in parallel (default: 1).\n"
+      "Every file is imported by its own worker process, the results are merged in the order the files\n"
+      "were given."
+    },
+    {
+      0,                            /* flags */
+      GWEN_ArgsType_Int,             /* type */
+      "ignoreErrors",               /* name */
+      0,                            /* minnum */
+      1,                            /* maxnum */
+      0,                            /* short option */
+      "ignore-errors",              /* long option */
+      "Write the data of all readable files even if some files could not be imported",
+      "Write the data of all readable files even if some files could not be imported"
+    },
+    {
+      0,                            /* flags */
+      GWEN_ArgsType_Int,             /* type */
+      "mergeSorted",                /* name */
+      0,                            /* minnum */
+      1,                            /* maxnum */
+      0,                            /* short option */
+      "merge",                      /* long option */
+      "Merge the transactions of the same account from all files sorted by date, dropping duplicates",
+      "Merge the transactions of the same account from all files sorted by booking date, valuta date and bank\n"
+      "reference, dropping duplicates (e.g. from overlapping statements)."
     },
     {
       GWEN_ARGS_FLAGS_HAS_ARGUMENT, /* flags */
@@ -144,28 +266,108 @@ int import(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv)
 
   bankId=GWEN_DB_GetCharValue(db, "bankId", 0, 0);
   accountId=GWEN_DB_GetCharValue(db, "accountId", 0, 0);
-  importerName=GWEN_DB_GetCharValue(db, "importerName", 0, "csv");
-  profileName=GWEN_DB_GetCharValue(db, "profileName", 0, "default");
-  profileFile=GWEN_DB_GetCharValue(db, "profileFile", 0, NULL);
+  params.importerName=GWEN_DB_GetCharValue(db, "importerName", 0, "csv");
+  params.profileName=GWEN_DB_GetCharValue(db, "profileName", 0, "default");
+  params.profileFile=GWEN_DB_GetCharValue(db, "profileFile", 0, NULL);
   ctxFile=GWEN_DB_GetCharValue(db, "ctxfile", 0, 0);
-  inFile=GWEN_DB_GetCharValue(db, "inFile", 0, 0);
+  jobs=GWEN_DB_GetIntValue(db, "jobs", 0, 1);
+  ignoreErrors=GWEN_DB_GetIntValue(db, "ignoreErrors", 0, 0);
+  mergeSorted=GWEN_DB_GetIntValue(db, "mergeSorted", 0, 0);
+
+  sl=GWEN_StringList_new();
+  rv=_collectInputFiles(db, sl);
+  if (rv<0) {
+    GWEN_StringList_free(sl);
+    return 1;
+  }
+  if (GWEN_StringList_Count(sl)<1 && GWEN_DB_GetCharValue(db, "fileList", 0, NULL)) {
+    fprintf(stderr, "ERROR: No files to import\n");
+    GWEN_StringList_free(sl);
+    return 1;
+  }
 
   rv=AB_Banking_Init(ab);
   if (rv) {
     DBG_ERROR(0, "Error on init (%d)", rv);
+    GWEN_StringList_free(sl);
     return 2;
   }
 
   /* import new context */
-  ctx=AB_ImExporterContext_new();
-  rv=AB_Banking_ImportFromFileLoadProfile(ab, importerName, ctx,
-                                          profileName, profileFile,
-                                          inFile);
-  if (rv<0) {
-    DBG_ERROR(0, "Error reading file: %d", rv);
-    AB_ImExporterContext_free(ctx);
-    return 4;
+  count=GWEN_StringList_Count(sl);
+  if (count<1) {
+    /* no file given, read from stdin */
+    rv=_importFile(ab, &params, NULL, &ctx);
+    if (rv<0) {
+      DBG_ERROR(0, "Error reading file: %d", rv);
+      GWEN_StringList_free(sl);
+      AB_Banking_Fini(ab);
+      return 4;
+    }
+  }
+  else {
+    IMPORT_FILE *files;
+    GWEN_STRINGLISTENTRY *se;
+    int i;
+    int errors=0;
+    uint64_t startTime;
+
+    files=(IMPORT_FILE *) calloc(count, sizeof(IMPORT_FILE));
+    assert(files);
+    se=GWEN_StringList_FirstEntry(sl);
+    for (i=0; i<count && se; i++) {
+      files[i].fileName=GWEN_StringListEntry_Data(se);
+      se=GWEN_StringListEntry_Next(se);
+    }
+
+    startTime=_now();
+#ifndef OS_WIN32
+    if (jobs>1 && count>1)
+      rv=_importFilesInWorkers(ab, &params, files, count, jobs);
+    else
+#endif
+    {
+      _importFilesSequentially(ab, &params, files, count);
+      rv=0;
+    }
+    if (rv<0) {
+      fprintf(stderr, "ERROR: Could not start import (%d)\n", rv);
+      free(files);
+      GWEN_StringList_free(sl);
+      AB_Banking_Fini(ab);
+      return 4;
+    }
+
+    /* merge contexts in the order the files were given */
+    ctx=AB_ImExporterContext_new();
+    if (mergeSorted)
+      AB_ImExporterContext_AddFlags(ctx, AB_IMEXPORTER_CONTEXT_FLAGS_MERGESORTED);
+    for (i=0; i<count; i++) {
+      if (count>1)
+        _reportFile(&files[i]);
+      if (files[i].result<0) {
+        if (count==1)
+          DBG_ERROR(0, "Error reading file \"%s\": %d", files[i].fileName, files[i].result);
+        errors++;
+      }
+      else if (files[i].ctx) {
+        AB_ImExporterContext_AddContext(ctx, files[i].ctx);
+        files[i].ctx=NULL;
+      }
+    }
+    if (count>1)
+      fprintf(stderr, "Imported %d of %d files in %lu ms\n",
+              count-errors, count, (unsigned long)((_now()-startTime)/1000));
+    free(files);
+
+    if (errors && !ignoreErrors) {
+      AB_ImExporterContext_free(ctx);
+      GWEN_StringList_free(sl);
+      AB_Banking_Fini(ab);
+      return 4;
+    }
   }
+  GWEN_StringList_free(sl);
 
   /* adjust local account id if requested */
   if (bankId || accountId) {
@@ -184,6 +386,7 @@ int import(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv)
   /* write context */
   rv=writeContext(ctxFile, ctx);
   if (rv<0) {
+    AB_ImExporterContext_free(ctx);
     AB_Banking_Fini(ab);
     return 4;
   }
@@ -201,6 +404,364 @@ int import(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv)
 
 
 
+int _collectInputFiles(GWEN_DB_NODE *db, GWEN_STRINGLIST *sl)
+{
+  const char *s;
+  int i;
+  int rv;
+
+  for (i=0; ; i++) {
+    s=GWEN_DB_GetCharValue(db, "inFile", i, NULL);
+    if (s==NULL)
+      break;
+    rv=_addFileOrPattern(sl, s);
+    if (rv<0) {
+      DBG_INFO(0, "here (%d)", rv);
+      return rv;
+    }
+  }
+
+  s=GWEN_DB_GetCharValue(db, "fileList", 0, NULL);
+  if (s && *s) {
+    rv=_readFileList(sl, s);
+    if (rv<0) {
+      DBG_INFO(0, "here (%d)", rv);
+      return rv;
+    }
+  }
+
+  return 0;
+}
+
+
+
+int _addFileOrPattern(GWEN_STRINGLIST *sl, const char *s)
+{
+#ifndef OS_WIN32
+  if (strpbrk(s, "*?[")) {
+    glob_t g;
+    size_t i;
+    int rv;
+
+    memset(&g, 0, sizeof(g));
+    rv=glob(s, 0, NULL, &g);
+    if (rv==GLOB_NOMATCH) {
+      fprintf(stderr, "ERROR: No file matches \"%s\"\n", s);
+      globfree(&g);
+      return GWEN_ERROR_NOT_FOUND;
+    }
+    else if (rv) {
+      fprintf(stderr, "ERROR: Could not expand \"%s\" (%d)\n", s, rv);
+      globfree(&g);
+      return GWEN_ERROR_GENERIC;
+    }
+
+    /* glob() returns the names sorted */
+    for (i=0; i<g.gl_pathc; i++)
+      GWEN_StringList_AppendString(sl, g.gl_pathv[i], 0, 0);
+    globfree(&g);
+    return 0;
+  }
+#endif
+
+  GWEN_StringList_AppendString(sl, s, 0, 0);
+  return 0;
+}
+
+
+
+int _readFileList(GWEN_STRINGLIST *sl, const char *listFile)
+{
+  FILE *f;
+  char line[4096];
+
+  if (strcmp(listFile, "-")==0)
+    f=stdin;
+  else {
+    f=fopen(listFile, "r");
+    if (f==NULL) {
+      fprintf(stderr, "ERROR: Could not open file list \"%s\": %s\n", listFile, strerror(errno));
+      return GWEN_ERROR_IO;
+    }
+  }
+
+  while (fgets(line, sizeof(line), f)) {
+    size_t len;
+
+    len=strlen(line);
+    while (len && (line[len-1]=='\n' || line[len-1]=='\r'))
+      line[--len]=0;
+    /* skip empty lines and comments */
+    if (len && line[0]!='#')
+      GWEN_StringList_AppendString(sl, line, 0, 0);
+  }
+
+  if (f!=stdin)
+    fclose(f);
+  return 0;
+}
+
+
+
+int _importFile(AB_BANKING *ab, const IMPORT_PARAMS *params, const char *fileName, AB_IMEXPORTER_CONTEXT **pCtx)
+{
+  AB_IMEXPORTER_CONTEXT *ctx;
+  int rv;
+
+  ctx=AB_ImExporterContext_new();
+  rv=AB_Banking_ImportFromFileLoadProfile(ab, params->importerName, ctx,
+                                          params->profileName, params->profileFile,
+                                          fileName);
+  if (rv<0) {
+    DBG_INFO(0, "here (%d)", rv);
+    AB_ImExporterContext_free(ctx);
+    return rv;
+  }
+
+  *pCtx=ctx;
+  return 0;
+}
+
+
+
+void _importFilesSequentially(AB_BANKING *ab, const IMPORT_PARAMS *params, IMPORT_FILE *files, int count)
+{
+  int i;
+
+  for (i=0; i<count; i++) {
+    uint64_t startTime;
+
+    startTime=_now();
+    files[i].result=_importFile(ab, params, files[i].fileName, &(files[i].ctx));
+    files[i].usecs=_now()-startTime;
+  }
+}
+
+
+
+#ifndef OS_WIN32
+
+int _importFilesInWorkers(AB_BANKING *ab, const IMPORT_PARAMS *params, IMPORT_FILE *files, int count, int jobs)
+{
+  GWEN_BUFFER *dirBuf;
+  const char *tmpDir;
+  char tmpFile[1024];
+  int next=0;
+  int running=0;
+  int i;
+
+  /* the workers store their results in a private temporary folder */
+  dirBuf=GWEN_Buffer_new(0, 256, 0, 1);
+  tmpDir=getenv("TMPDIR");
+  GWEN_Buffer_AppendString(dirBuf, (tmpDir && *tmpDir)?tmpDir:"/tmp");
+  GWEN_Buffer_AppendString(dirBuf, "/aqbanking-import-XXXXXX");
+  if (mkdtemp(GWEN_Buffer_GetStart(dirBuf))==NULL) {
+    DBG_ERROR(0, "mkdtemp(%s): %s", GWEN_Buffer_GetStart(dirBuf), strerror(errno));
+    GWEN_Buffer_free(dirBuf);
+    return GWEN_ERROR_IO;
+  }
+  tmpDir=GWEN_Buffer_GetStart(dirBuf);
+  if (strlen(tmpDir)+16>sizeof(tmpFile)) {
+    DBG_ERROR(0, "Path of temporary folder too long");
+    rmdir(tmpDir);
+    GWEN_Buffer_free(dirBuf);
+    return GWEN_ERROR_INVALID;
+  }
+
+  /* don't let the workers inherit unwritten output */
+  fflush(stdout);
+  fflush(stderr);
+
+  while (next<count || running>0) {
+    int status;
+    pid_t pid;
+
+    while (running<jobs && next<count) {
+      int rv;
+
+      snprintf(tmpFile, sizeof(tmpFile), "%s/%d.ctx", tmpDir, next);
+      rv=_startWorker(ab, params, &files[next], tmpFile);
+      if (rv<0)
+        files[next].result=rv;
+      else
+        running++;
+      next++;
+    }
+
+    if (running<1)
+      break;
+
+    pid=waitpid(-1, &status, 0);
+    if (pid<0) {
+      if (errno==EINTR)
+        continue;
+      DBG_ERROR(0, "waitpid(): %s", strerror(errno));
+      break;
+    }
+    for (i=0; i<count; i++) {
+      if (files[i].pid==pid) {
+        _finishWorker(&files[i], status);
+        running--;
+        break;
+      }
+    }
+  }
+
+  /* read the results */
+  for (i=0; i<count; i++) {
+    snprintf(tmpFile, sizeof(tmpFile), "%s/%d.ctx", tmpDir, i);
+    if (files[i].result==0) {
+      int rv;
+
+      rv=readContext(tmpFile, &(files[i].ctx), 1);
+      if (rv) {
+        DBG_ERROR(0, "Could not read result for \"%s\" (%d)", files[i].fileName, rv);
+        files[i].result=(rv<0)?rv:GWEN_ERROR_IO;
+      }
+    }
+    unlink(tmpFile);
+  }
+  rmdir(tmpDir);
+  GWEN_Buffer_free(dirBuf);
+
+  return 0;
+}
+
 
 
+int _startWorker(AB_BANKING *ab, const IMPORT_PARAMS *params, IMPORT_FILE *f, const char *tmpFile)
+{
+  int fds[2];
+  pid_t pid;
+
+  if (pipe(fds)<0) {
+    DBG_ERROR(0, "pipe(): %s", strerror(errno));
+    return GWEN_ERROR_IO;
+  }
+
+  f->usecs=_now();
+  pid=fork();
+  if (pid<0) {
+    DBG_ERROR(0, "fork(): %s", strerror(errno));
+    close(fds[0]);
+    close(fds[1]);
+    return GWEN_ERROR_IO;
+  }
+  else if (pid==0) {
+    /* worker process: import, store result and leave without deinitializing AqBanking */
+    IMPORT_WORKER_RESULT res;
+    AB_IMEXPORTER_CONTEXT *ctx=NULL;
+    uint64_t startTime;
+    int rv;
+
+    close(fds[0]);
+    startTime=_now();
+    rv=_importFile(ab, params, f->fileName, &ctx);
+    if (rv==0) {
+      rv=writeContext(tmpFile, ctx);
+      if (rv>0)
+        rv=GWEN_ERROR_IO;
+      AB_ImExporterContext_free(ctx);
+    }
+    memset(&res, 0, sizeof(res));
+    res.result=rv;
+    res.usecs=_now()-startTime;
+    if (write(fds[1], &res, sizeof(res))!=sizeof(res))
+      _exit(2);
+    close(fds[1]);
+    _exit((rv==0)?0:1);
+  }
+
+  close(fds[1]);
+  f->pid=pid;
+  f->resultFd=fds[0];
+  return 0;
+}
+
+
+
+void _finishWorker(IMPORT_FILE *f, int status)
+{
+  IMPORT_WORKER_RESULT res;
+  ssize_t got;
+
+  do {
+    got=read(f->resultFd, &res, sizeof(res));
+  } while (got<0 && errno==EINTR);
+  close(f->resultFd);
+  f->resultFd=-1;
+  f->pid=0;
+
+  if (got==sizeof(res)) {
+    f->result=res.result;
+    f->usecs=res.usecs;
+  }
+  else {
+    if (WIFSIGNALED(status)) {
+      DBG_ERROR(0, "Worker for \"%s\" killed by signal %d", f->fileName, WTERMSIG(status));
+    }
+    else {
+      DBG_ERROR(0, "Worker for \"%s\" did not send a result", f->fileName);
+    }
+    f->result=GWEN_ERROR_GENERIC;
+    f->usecs=_now()-f->usecs;
+  }
+}
+
+#endif
+
+
+
+void _reportFile(const IMPORT_FILE *f)
+{
+  if (f->result<0)
+    fprintf(stderr, "%s: ERROR %d (%lu ms)\n",
+            f->fileName, f->result, (unsigned long)(f->usecs/1000));
+  else
+    fprintf(stderr, "%s: %d account(s), %d transaction(s) (%lu ms)\n",
+            f->fileName,
+            f->ctx?AB_ImExporterContext_GetAccountInfoCount(f->ctx):0,
+            _countTransactions(f->ctx),
+            (unsigned long)(f->usecs/1000));
+}
+
+
+
+int _countTransactions(const AB_IMEXPORTER_CONTEXT *ctx)
+{
+  int count=0;
+
+  if (ctx) {
+    AB_IMEXPORTER_ACCOUNTINFO *iea;
+
+    iea=AB_ImExporterContext_GetFirstAccountInfo(ctx);
+    while (iea) {
+      count+=AB_ImExporterAccountInfo_GetTransactionCount(iea, AB_Transaction_TypeNone, AB_Transaction_CommandNone);
+      iea=AB_ImExporterAccountInfo_List_Next(iea);
+    }
+  }
+
+  return count;
+}
+
+
+
+uint64_t _now(void)
+{
+#ifdef OS_WIN32
+  static LARGE_INTEGER freq= {0};
+  LARGE_INTEGER cnt;
+
+  if (freq.QuadPart==0)
+    QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&cnt);
+  return (uint64_t)((cnt.QuadPart*1000000.0)/freq.QuadPart);
+#else
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (((uint64_t) ts.tv_sec)*1000000)+(ts.tv_nsec/1000);
+#endif
+}
+
 
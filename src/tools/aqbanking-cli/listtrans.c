@@ -17,6 +17,8 @@
 
 
 static GWEN_DB_NODE *_readCommandLine(GWEN_DB_NODE *dbArgs, int argc, char **argv);
+static GWEN_DATE *_readDateArg(GWEN_DB_NODE *db, const char *varName, int *pErr);
+static void _printTransactionList2(AB_TRANSACTION_LIST2 *tl2, const char *tmplString, GWEN_BUFFER *dbuf);
 
 
 
@@ -37,6 +39,8 @@ int listTrans(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv)
   int transactionCommand=0;
   const char *tmplString;
   const char *s;
+  GWEN_DATE *fromDate;
+  GWEN_DATE *toDate;
 
   /* parse command line arguments */
   db=_readCommandLine(dbArgs, argc, argv);
@@ -79,10 +83,21 @@ int listTrans(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv)
     }
   }
 
+  fromDate=_readDateArg(db, "fromDate", &rv);
+  if (rv)
+    return 1;
+  toDate=_readDateArg(db, "toDate", &rv);
+  if (rv) {
+    GWEN_Date_free(fromDate);
+    return 1;
+  }
+
   /* init AqBanking */
   rv=AB_Banking_Init(ab);
   if (rv) {
     DBG_ERROR(0, "Error on init (%d)", rv);
+    GWEN_Date_free(toDate);
+    GWEN_Date_free(fromDate);
     return 2;
   }
 
@@ -92,6 +107,8 @@ int listTrans(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv)
   if (rv<0) {
     DBG_ERROR(0, "Error reading context (%d)", rv);
     AB_ImExporterContext_free(ctx);
+    GWEN_Date_free(toDate);
+    GWEN_Date_free(fromDate);
     return 4;
   }
 
@@ -110,7 +127,21 @@ int listTrans(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv)
       AB_TRANSACTION_LIST *tl;
 
       tl=AB_ImExporterAccountInfo_GetTransactionList(iea);
-      if (tl) {
+      if (tl && (fromDate || toDate)) {
+        AB_TRANSACTION_LIST2 *tl2;
+
+        /* use the sorted date view instead of scanning the whole list */
+        tl2=AB_ImExporterAccountInfo_FindTransactionsByDate(iea, fromDate, toDate, 0, transactionType, transactionCommand);
+        if (tl2) {
+          GWEN_BUFFER *dbuf;
+
+          dbuf=GWEN_Buffer_new(0, 256, 0, 1);
+          _printTransactionList2(tl2, tmplString, dbuf);
+          GWEN_Buffer_free(dbuf);
+          AB_Transaction_List2_free(tl2);
+        }
+      }
+      else if (tl) {
         const AB_TRANSACTION *t;
         GWEN_BUFFER *dbuf;
 
@@ -134,6 +165,8 @@ int listTrans(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv)
     iea=AB_ImExporterAccountInfo_List_Next(iea);
   } /* while */
   AB_ImExporterContext_free(ctx);
+  GWEN_Date_free(toDate);
+  GWEN_Date_free(fromDate);
 
   /* deinit */
   rv=AB_Banking_Fini(ab);
@@ -147,6 +180,48 @@ int listTrans(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv)
 
 
 
+GWEN_DATE *_readDateArg(GWEN_DB_NODE *db, const char *varName, int *pErr)
+{
+  const char *s;
+
+  *pErr=0;
+  s=GWEN_DB_GetCharValue(db, varName, 0, 0);
+  if (s && *s) {
+    GWEN_DATE *dt;
+
+    dt=GWEN_Date_fromStringWithTemplate(s, "YYYYMMDD");
+    if (dt==NULL) {
+      DBG_ERROR(0, "Invalid date value \"%s\"", s);
+      *pErr=1;
+    }
+    return dt;
+  }
+  return NULL;
+}
+
+
+
+void _printTransactionList2(AB_TRANSACTION_LIST2 *tl2, const char *tmplString, GWEN_BUFFER *dbuf)
+{
+  AB_TRANSACTION_LIST2_ITERATOR *it;
+
+  it=AB_Transaction_List2_First(tl2);
+  if (it) {
+    AB_TRANSACTION *t;
+
+    t=AB_Transaction_List2Iterator_Data(it);
+    while (t) {
+      addTransactionToBufferByTemplate(t, tmplString, dbuf);
+      fprintf(stdout, "%s\n", GWEN_Buffer_GetStart(dbuf));
+      GWEN_Buffer_Reset(dbuf);
+      t=AB_Transaction_List2Iterator_Next(it);
+    }
+    AB_Transaction_List2Iterator_free(it);
+  }
+}
+
+
+
 /* parse command line */
 GWEN_DB_NODE *_readCommandLine(GWEN_DB_NODE *dbArgs, int argc, char **argv)
 {
@@ -230,6 +305,28 @@ GWEN_DB_NODE *_readCommandLine(GWEN_DB_NODE *dbArgs, int argc, char **argv)
       "Specify the transaction command to filter",      /* short description */
       "Specify the transaction command to filter"       /* long description */
     },
+    {
+      GWEN_ARGS_FLAGS_HAS_ARGUMENT, /* flags */
+      GWEN_ArgsType_Char,            /* type */
+      "fromDate",                   /* name */
+      0,                            /* minnum */
+      1,                            /* maxnum */
+      0,                            /* short option */
+      "fromdate",                   /* long option */
+      "Only list transactions booked on or after this date (YYYYMMDD)", /* short */
+      "Only list transactions booked on or after this date (YYYYMMDD)" /* long */
+    },
+    {
+      GWEN_ARGS_FLAGS_HAS_ARGUMENT, /* flags */
+      GWEN_ArgsType_Char,            /* type */
+      "toDate",                     /* name */
+      0,                            /* minnum */
+      1,                            /* maxnum */
+      0,                            /* short option */
+      "todate",                     /* long option */
+      "Only list transactions booked on or before this date (YYYYMMDD)", /* short */
+      "Only list transactions booked on or before this date (YYYYMMDD)" /* long */
+    },
     {
       GWEN_ARGS_FLAGS_HAS_ARGUMENT, /* flags */
       GWEN_ArgsType_Char,            /* type */
@@ -43,6 +43,86 @@ static void cmdAddHelpStr(GWEN_BUFFER *ubuf,
 }
 
 
+int execCommand(AB_BANKING *ab, GWEN_DB_NODE *db, const char *cmd, int argc, char **argv)
+{
+  int rv;
+
+  if (strcasecmp(cmd, "listaccs")==0 ||
+      strcasecmp(cmd, "listaccounts")==0) {
+    rv=listAccs(ab, db, argc, argv);
+  }
+  else if (strcasecmp(cmd, "listbal")==0) {
+    rv=listBal(ab, db, argc, argv);
+  }
+  else if (strcasecmp(cmd, "listtrans")==0) {
+    rv=listTrans(ab, db, argc, argv);
+  }
+  else if (strcasecmp(cmd, "listtransfers")==0) {
+    fprintf(stderr,
+            "ERROR: Please use the commands \"listtrans\" or \"export\" and specify the transaction type via \"-tt TYPE\"\n");
+    rv=1;
+  }
+  else if (strcasecmp(cmd, "listdoc")==0) {
+    rv=listDoc(ab, db, argc, argv);
+  }
+  else if (strcasecmp(cmd, "request")==0) {
+    rv=request(ab, db, argc, argv);
+  }
+  else if (strcasecmp(cmd, "chkiban")==0) {
+    rv=chkIban(ab, db, argc, argv);
+  }
+  else if (strcasecmp(cmd, "import")==0) {
+    rv=import(ab, db, argc, argv);
+  }
+  else if (strcasecmp(cmd, "export")==0) {
+    rv=exportCtx(ab, db, argc, argv);
+  }
+  else if (strcasecmp(cmd, "sepatransfer")==0) {
+    rv=sepaTransfer(ab, db, argc, argv);
+  }
+  else if (strcasecmp(cmd, "sepatransfers")==0) {
+    rv=sepaMultiJobs(ab, db, argc, argv, AQBANKING_TOOL_SEPA_TRANSFERS);
+  }
+  else if (strcasecmp(cmd, "sepadebitnote")==0) {
+    rv=sepaDebitNote(ab, db, argc, argv, 0);
+  }
+  else if (strcasecmp(cmd, "sepaFlashDebitNote")==0) {
+    rv=sepaDebitNote(ab, db, argc, argv, 1);
+  }
+  else if (strcasecmp(cmd, "sepadebitnotes")==0) {
+    rv=sepaMultiJobs(ab, db, argc, argv, AQBANKING_TOOL_SEPA_DEBITNOTES);
+  }
+  else if (strcasecmp(cmd, "addtrans")==0) {
+    rv=addTransaction(ab, db, argc, argv);
+  }
+  else if (strcasecmp(cmd, "addsepadebitnote")==0) {
+    rv=addSepaDebitNote(ab, db, argc, argv, 0);
+  }
+  else if (strcasecmp(cmd, "addFlashSepadebitnote")==0) {
+    rv=addSepaDebitNote(ab, db, argc, argv, 1);
+  }
+  else if (strcasecmp(cmd, "sepasto")==0) {
+    rv=sepaRecurTransfer(ab, db, argc, argv);
+  }
+  else if (strcasecmp(cmd, "fillgaps")==0) {
+    rv=fillGaps(ab, db, argc, argv);
+  }
+  else if (strcasecmp(cmd, "listprofiles")==0) {
+    rv=listProfiles(ab, db, argc, argv);
+  }
+  else if (strcasecmp(cmd, "versions")==0) {
+    rv=versions(ab, db, argc, argv);
+  }
+  else {
+    fprintf(stderr, "ERROR: Unknown command \"%s\".\n", cmd);
+    rv=1;
+  }
+
+  return rv;
+}
+
+
+
 int main(int argc, char **argv)
 {
   GWEN_DB_NODE *db;
@@ -51,6 +131,7 @@ int main(int argc, char **argv)
   AB_BANKING *ab;
   GWEN_GUI *gui;
   const char *ctrlBackend=NULL;
+  const char *socketPath;
   int nonInteractive=0;
   int acceptValidCerts=0;
   const char *pinFile;
@@ -136,6 +217,18 @@ int main(int argc, char **argv)
       "backend for control function", /* short description */
       "Call the CONTROL function of the given backend"          /* long description */
     },
+    {
+      GWEN_ARGS_FLAGS_HAS_ARGUMENT,   /* flags */
+      GWEN_ArgsType_Char,             /* type */
+      "socket",                       /* name */
+      0,                              /* minnum */
+      1,                              /* maxnum */
+      "S",                            /* short option */
+      "socket",                       /* long option */
+      "socket of a running server",   /* short description */
+      "Let the server listening on the given unix socket execute the command (see command \"serve\").\n"
+      "The global options of the server are used in that case."
+    },
     {
       GWEN_ARGS_FLAGS_HELP | GWEN_ARGS_FLAGS_LAST, /* flags */
       GWEN_ArgsType_Int,            /* type */
@@ -220,7 +313,7 @@ int main(int argc, char **argv)
                   I18N("Requests transactions, balances, standing orders etc."));
 
     cmdAddHelpStr(ubuf, "chkiban",
-                  I18N("Check an IBAN"));
+                  I18N("Check an IBAN (or a list of IBANs and BICs read from stdin)"));
 
     cmdAddHelpStr(ubuf, "import",
                   I18N("Import a file into an import context file"));
@@ -264,6 +357,9 @@ int main(int argc, char **argv)
     cmdAddHelpStr(ubuf, "versions",
                   I18N("Print the program and library versions"));
 
+    cmdAddHelpStr(ubuf, "serve",
+                  I18N("Keep AqBanking initialized and execute commands sent via \"--socket\""));
+
     GWEN_Buffer_AppendString(ubuf, "\n");
 
     fprintf(stdout, "%s\n", GWEN_Buffer_GetStart(ubuf));
@@ -280,6 +376,15 @@ int main(int argc, char **argv)
   acceptValidCerts=GWEN_DB_GetIntValue(db, "acceptValidCerts", 0, 0);
   cfgDir=GWEN_DB_GetCharValue(db, "cfgdir", 0, 0);
   ctrlBackend=GWEN_DB_GetCharValue(db, "control", 0, 0);
+  socketPath=GWEN_DB_GetCharValue(db, "socket", 0, NULL);
+
+  cmd=GWEN_DB_GetCharValue(db, "params", 0, 0);
+  if (socketPath && *socketPath && !(ctrlBackend && *ctrlBackend) && cmd && strcasecmp(cmd, "serve")!=0) {
+    /* let the server do the work */
+    rv=sendToServer(socketPath, argc, argv);
+    GWEN_DB_Group_free(db);
+    return rv;
+  }
 
   gui=GWEN_Gui_CGui_new();
   s=GWEN_DB_GetCharValue(db, "charset", 0, NULL);
@@ -332,84 +437,16 @@ int main(int argc, char **argv)
     rv=control(ab, ctrlBackend, db, argc, argv);
   }
   else {
-    cmd=GWEN_DB_GetCharValue(db, "params", 0, 0);
     if (!cmd) {
       fprintf(stderr, "ERROR: Command needed.\n");
       GWEN_DB_Group_free(db);
       return 1;
     }
 
-    if (strcasecmp(cmd, "listaccs")==0 ||
-        strcasecmp(cmd, "listaccounts")==0) {
-      rv=listAccs(ab, db, argc, argv);
-    }
-    else if (strcasecmp(cmd, "listbal")==0) {
-      rv=listBal(ab, db, argc, argv);
-    }
-    else if (strcasecmp(cmd, "listtrans")==0) {
-      rv=listTrans(ab, db, argc, argv);
-    }
-    else if (strcasecmp(cmd, "listtransfers")==0) {
-      fprintf(stderr,
-              "ERROR: Please use the commands \"listtrans\" or \"export\" and specify the transaction type via \"-tt TYPE\"\n");
-      GWEN_DB_Group_free(db);
-      return 1;
-    }
-    else if (strcasecmp(cmd, "listdoc")==0) {
-      rv=listDoc(ab, db, argc, argv);
-    }
-    else if (strcasecmp(cmd, "request")==0) {
-      rv=request(ab, db, argc, argv);
-    }
-    else if (strcasecmp(cmd, "chkiban")==0) {
-      rv=chkIban(ab, db, argc, argv);
-    }
-    else if (strcasecmp(cmd, "import")==0) {
-      rv=import(ab, db, argc, argv);
-    }
-    else if (strcasecmp(cmd, "export")==0) {
-      rv=exportCtx(ab, db, argc, argv);
-    }
-    else if (strcasecmp(cmd, "sepatransfer")==0) {
-      rv=sepaTransfer(ab, db, argc, argv);
-    }
-    else if (strcasecmp(cmd, "sepatransfers")==0) {
-      rv=sepaMultiJobs(ab, db, argc, argv, AQBANKING_TOOL_SEPA_TRANSFERS);
-    }
-    else if (strcasecmp(cmd, "sepadebitnote")==0) {
-      rv=sepaDebitNote(ab, db, argc, argv, 0);
-    }
-    else if (strcasecmp(cmd, "sepaFlashDebitNote")==0) {
-      rv=sepaDebitNote(ab, db, argc, argv, 1);
-    }
-    else if (strcasecmp(cmd, "sepadebitnotes")==0) {
-      rv=sepaMultiJobs(ab, db, argc, argv, AQBANKING_TOOL_SEPA_DEBITNOTES);
-    }
-    else if (strcasecmp(cmd, "addtrans")==0) {
-      rv=addTransaction(ab, db, argc, argv);
-    }
-    else if (strcasecmp(cmd, "addsepadebitnote")==0) {
-      rv=addSepaDebitNote(ab, db, argc, argv, 0);
-    }
-    else if (strcasecmp(cmd, "addFlashSepadebitnote")==0) {
-      rv=addSepaDebitNote(ab, db, argc, argv, 1);
-    }
-    else if (strcasecmp(cmd, "sepasto")==0) {
-      rv=sepaRecurTransfer(ab, db, argc, argv);
-    }
-    else if (strcasecmp(cmd, "fillgaps")==0) {
-      rv=fillGaps(ab, db, argc, argv);
-    }
-    else if (strcasecmp(cmd, "listprofiles")==0) {
-      rv=listProfiles(ab, db, argc, argv);
-    }
-    else if (strcasecmp(cmd, "versions")==0) {
-      rv=versions(ab, db, argc, argv);
-    }
-    else {
-      fprintf(stderr, "ERROR: Unknown command \"%s\".\n", cmd);
-      rv=1;
-    }
+    if (strcasecmp(cmd, "serve")==0)
+      rv=serve(ab, db, argc, argv);
+    else
+      rv=execCommand(ab, db, cmd, argc, argv);
   }
 
   GWEN_DB_Group_free(db);
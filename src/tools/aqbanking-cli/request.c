@@ -66,6 +66,8 @@ int request(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv)
     requestFlags|=AQBANKING_TOOL_REQUEST_DEPOT;
   if (GWEN_DB_GetIntValue(db, "ignoreUnsupported", 0, 0))
     requestFlags|=AQBANKING_TOOL_REQUEST_IGNORE_UNSUP;
+  if (GWEN_DB_GetIntValue(db, "incremental", 0, 0))
+    requestFlags|=AQBANKING_TOOL_REQUEST_INCREMENTAL;
 
   /* read command line arguments */
   ctxFile=GWEN_DB_GetCharValue(db, "ctxfile", 0, 0);
@@ -365,6 +367,19 @@ GWEN_DB_NODE *_readCommandLine(GWEN_DB_NODE *dbArgs, int argc, char **argv)
       "let AqBanking ignore unsupported requests for accounts",
       "let AqBanking ignore unsupported requests for accounts",
     },
+    {
+      0,                            /* flags */
+      GWEN_ArgsType_Int,            /* type */
+      "incremental",                /* name */
+      0,                            /* minnum */
+      1,                            /* maxnum */
+      0,                            /* short option */
+      "incremental",                /* long option */
+      "Only request transactions booked since the last incremental request", /* short */
+      "Only request transactions booked since the last incremental request for the same account "
+      "(the date given by --fromdate is used if it is later), transactions already received by "
+      "that request are dropped" /* long */
+    },
     {
       GWEN_ARGS_FLAGS_HAS_ARGUMENT, /* flags */
       GWEN_ArgsType_Char,            /* type */
@@ -21,8 +21,8 @@
 
 static GWEN_DB_NODE *_readCommandLine(GWEN_DB_NODE *dbArgs, int argc, char **argv);
 
-static int _createJobsFromContext(AB_IMEXPORTER_CONTEXT *ctx,
-                                  const AB_ACCOUNT_SPEC_LIST *accountSpecList,
+static int _createJobsFromContext(AB_BANKING *ab,
+                                  AB_IMEXPORTER_CONTEXT *ctx,
                                   AB_ACCOUNT_SPEC *forcedAccount,
                                   AB_TRANSACTION_COMMAND cmd,
                                   AB_TRANSACTION_LIST2 *jobList);
@@ -120,7 +120,7 @@ int sepaMultiJobs(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv,
 
   /* populate job list */
   jobList=AB_Transaction_List2_new();
-  rv=_createJobsFromContext(ctx, accountSpecList, forcedAccount, cmd, jobList);
+  rv=_createJobsFromContext(ab, ctx, forcedAccount, cmd, jobList);
   AB_ImExporterContext_free(ctx);
   if (rv<0) {
     DBG_INFO(0, "Error (%d)", rv);
@@ -351,8 +351,8 @@ GWEN_DB_NODE *_readCommandLine(GWEN_DB_NODE *dbArgs, int argc, char **argv)
 
 
 
-int _createJobsFromContext(AB_IMEXPORTER_CONTEXT *ctx,
-                           const AB_ACCOUNT_SPEC_LIST *accountSpecList,
+int _createJobsFromContext(AB_BANKING *ab,
+                           AB_IMEXPORTER_CONTEXT *ctx,
                            AB_ACCOUNT_SPEC *forcedAccount,
                            AB_TRANSACTION_COMMAND cmd,
                            AB_TRANSACTION_LIST2 *jobList)
@@ -368,6 +368,7 @@ int _createJobsFromContext(AB_IMEXPORTER_CONTEXT *ctx,
     t=AB_ImExporterAccountInfo_GetFirstTransaction(iea, 0, 0);
     while (t) {
       AB_ACCOUNT_SPEC *as;
+      AB_ACCOUNT_SPEC *pickedAccount=NULL;
       AB_TRANSACTION *job=NULL;
       const char *rIBAN;
       const char *lIBAN;
@@ -380,7 +381,7 @@ int _createJobsFromContext(AB_IMEXPORTER_CONTEXT *ctx,
       if (forcedAccount)
         as=forcedAccount;
       else
-        as=pickAccountSpecForTransaction(accountSpecList, t);
+        as=pickedAccount=pickAccountSpecForTransaction(ab, t);
       if (as==NULL) {
         DBG_ERROR(0, "Could not determine account for job in line %d", transactionLine);
         reallyExecute=0;
@@ -445,6 +446,7 @@ int _createJobsFromContext(AB_IMEXPORTER_CONTEXT *ctx,
         }
       }
       AB_Transaction_SetCommand(job, cmd);
+      AB_AccountSpec_free(pickedAccount);
 
       AB_Transaction_List2_PushBack(jobList, job);
       transactionLine++;
@@ -0,0 +1,746 @@
+/***************************************************************************
+ begin       : Mon Oct 19 2026
+ copyright   : (C) 2026 by Martin Preuss
+ email       : martin@libchipcard.de
+
+ ***************************************************************************
+ *          Please see toplevel file COPYING for license details           *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "globals.h"
+
+#ifndef OS_WIN32
+# include <sys/types.h>
+# include <sys/stat.h>
+# include <sys/socket.h>
+# include <sys/un.h>
+# include <sys/time.h>
+# include <unistd.h>
+# include <fcntl.h>
+# include <signal.h>
+# include <errno.h>
+# include <string.h>
+# include <assert.h>
+# ifdef HAVE_STDIO_EXT_H
+#  include <stdio_ext.h>
+# endif
+#endif
+
+
+/*
+ * Protocol between client and server (all numbers are 32 bit big endian):
+ *
+ * Client -> Server:
+ * - length of the request data, sent together with the file descriptors of stdin, stdout and stderr
+ *   of the client (SCM_RIGHTS)
+ * - request data: the current folder of the client followed by the command and its arguments,
+ *   every string is terminated by a NUL byte
+ *
+ * Server -> Client:
+ * - exit code of the command
+ *
+ * The server executes one command at a time. While a command is executed stdin, stdout and stderr
+ * of the server are replaced by those of the client, so the client sees the output as if it had
+ * executed the command itself.
+ */
+
+
+#define AQBANKING_CLI_SERVE_MAX_REQUEST_SIZE (256*1024)
+#define AQBANKING_CLI_SERVE_BACKLOG          8
+/* seconds a client may take to send its request before it is dropped */
+#define AQBANKING_CLI_SERVE_READ_TIMEOUT     10
+
+
+
+#ifndef OS_WIN32
+
+/* ------------------------------------------------------------------------------------------------
+ * forward declarations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+static int _createServerSocket(const char *socketPath);
+static int _isServerRunning(const struct sockaddr_un *addr);
+static int _checkPeer(int fd);
+static int _setReadTimeout(int fd, int seconds);
+static void _handleClient(AB_BANKING *ab, int fd, int startDirFd);
+static int _readRequest(int fd, int *clientFds, char **pData, uint32_t *pLen);
+static char **_splitRequest(char *data, uint32_t len, int *pCount);
+static int _execRequest(AB_BANKING *ab, const int *clientFds, const char *cwd, int argc, char **argv, int startDirFd);
+static void _discardStdinBuffer(void);
+static int _readFull(int fd, void *p, size_t len);
+static int _writeFull(int fd, const void *p, size_t len);
+static void _uint32ToBuffer(uint32_t v, uint8_t *p);
+static uint32_t _bufferToUint32(const uint8_t *p);
+static void _onSignal(int sig);
+
+
+
+static volatile sig_atomic_t _stopServer=0;
+
+
+
+/* ------------------------------------------------------------------------------------------------
+ * implementations
+ * ------------------------------------------------------------------------------------------------
+ */
+
+int serve(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv)
+{
+  GWEN_DB_NODE *db;
+  int rv;
+  int sfd;
+  int startDirFd;
+  const char *socketPath;
+  struct sigaction sa;
+  uint32_t requests=0;
+  const GWEN_ARGS args[]= {
+    {
+      GWEN_ARGS_FLAGS_HELP | GWEN_ARGS_FLAGS_LAST, /* flags */
+      GWEN_ArgsType_Int,             /* type */
+      "help",                       /* name */
+      0,                            /* minnum */
+      0,                            /* maxnum */
+      "h",                          /* short option */
+      "help",                       /* long option */
+      "Show this help screen",      /* short description */
+      "Show this help screen"       /* long description */
+    }
+  };
+
+  db=GWEN_DB_GetGroup(dbArgs, GWEN_DB_FLAGS_DEFAULT, "local");
+  rv=GWEN_Args_Check(argc, argv, 1,
+                     0 /*GWEN_ARGS_MODE_ALLOW_FREEPARAM*/,
+                     args,
+                     db);
+  if (rv==GWEN_ARGS_RESULT_ERROR) {
+    fprintf(stderr, "ERROR: Could not parse arguments\n");
+    return 1;
+  }
+  else if (rv==GWEN_ARGS_RESULT_HELP) {
+    GWEN_BUFFER *ubuf;
+
+    ubuf=GWEN_Buffer_new(0, 1024, 0, 1);
+    GWEN_Buffer_AppendString(ubuf,
+                             "Keep AqBanking and its backends initialized and execute commands sent by\n"
+                             "\"aqbanking-cli --socket=PATH COMMAND [LOCAL OPTIONS]\" one at a time.\n"
+                             "The global option \"--socket\" is needed to specify the socket to listen on.\n"
+                             "Only the user running the server is allowed to connect.\n\n");
+    if (GWEN_Args_Usage(args, ubuf, GWEN_ArgsOutType_Txt)) {
+      fprintf(stderr, "ERROR: Could not create help string\n");
+      GWEN_Buffer_free(ubuf);
+      return 1;
+    }
+    fprintf(stdout, "%s\n", GWEN_Buffer_GetStart(ubuf));
+    GWEN_Buffer_free(ubuf);
+    return 0;
+  }
+
+  socketPath=GWEN_DB_GetCharValue(dbArgs, "socket", 0, NULL);
+  if (!(socketPath && *socketPath)) {
+    fprintf(stderr, "ERROR: Global option \"--socket\" needed.\n");
+    return 1;
+  }
+
+  startDirFd=open(".", O_RDONLY);
+  if (startDirFd<0) {
+    fprintf(stderr, "ERROR: Could not open current folder: %s\n", strerror(errno));
+    return 2;
+  }
+
+#if !defined(HAVE___FPURGE) && !defined(HAVE_FPURGE)
+  /* stdin is shared by all clients and its buffer can't be discarded between them, so don't buffer at all */
+  setvbuf(stdin, NULL, _IONBF, 0);
+#endif
+
+  /* keep backends (and the data they loaded) initialized between commands */
+  AB_Banking_RuntimeConfig_SetIntValue(ab, "keepProviders", 1);
+
+  rv=AB_Banking_Init(ab);
+  if (rv) {
+    DBG_ERROR(0, "Error on init (%d)", rv);
+    close(startDirFd);
+    return 2;
+  }
+
+  sfd=_createServerSocket(socketPath);
+  if (sfd<0) {
+    fprintf(stderr, "ERROR: Could not listen on \"%s\" (%d)\n", socketPath, sfd);
+    AB_Banking_Fini(ab);
+    close(startDirFd);
+    return 3;
+  }
+
+  /* no SA_RESTART: accept() needs to return when the server is asked to stop */
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler=_onSignal;
+  sigemptyset(&sa.sa_mask);
+  sigaction(SIGINT, &sa, NULL);
+  sigaction(SIGTERM, &sa, NULL);
+  signal(SIGPIPE, SIG_IGN);
+
+  DBG_NOTICE(0, "Listening on \"%s\"", socketPath);
+  while (!_stopServer) {
+    int cfd;
+
+    cfd=accept(sfd, NULL, NULL);
+    if (cfd<0) {
+      if (errno==EINTR)
+        continue;
+      DBG_ERROR(0, "accept(): %s", strerror(errno));
+      break;
+    }
+
+    /* a client which doesn't send its request would otherwise block the server forever */
+    if (_setReadTimeout(cfd, AQBANKING_CLI_SERVE_READ_TIMEOUT)==0 && _checkPeer(cfd)==0) {
+      _handleClient(ab, cfd, startDirFd);
+      requests++;
+    }
+    close(cfd);
+  }
+  DBG_NOTICE(0, "Stopping server after %lu requests", (unsigned long) requests);
+
+  close(sfd);
+  unlink(socketPath);
+  close(startDirFd);
+
+  rv=AB_Banking_Fini(ab);
+  if (rv) {
+    fprintf(stderr, "ERROR: Error on deinit (%d)\n", rv);
+    return 5;
+  }
+
+  return 0;
+}
+
+
+
+int sendToServer(const char *socketPath, int argc, char **argv)
+{
+  struct sockaddr_un addr;
+  int fd;
+  int i;
+  int fds[3]= {0, 1, 2};
+  char cwd[4096];
+  uint8_t header[4];
+  uint8_t result[4];
+  GWEN_BUFFER *buf;
+  struct msghdr msg;
+  struct iovec iov;
+  union {
+    struct cmsghdr align;
+    char buf[CMSG_SPACE(sizeof(fds))];
+  } ctrl;
+  struct cmsghdr *cmsg;
+  ssize_t sent;
+
+  if (strlen(socketPath)>=sizeof(addr.sun_path)) {
+    fprintf(stderr, "ERROR: Socket path \"%s\" too long\n", socketPath);
+    return 1;
+  }
+
+  if (getcwd(cwd, sizeof(cwd)-1)==NULL) {
+    fprintf(stderr, "ERROR: Could not determine current folder: %s\n", strerror(errno));
+    return 2;
+  }
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family=AF_UNIX;
+  strncpy(addr.sun_path, socketPath, sizeof(addr.sun_path)-1);
+
+  fd=socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd<0) {
+    fprintf(stderr, "ERROR: socket(): %s\n", strerror(errno));
+    return 2;
+  }
+  if (connect(fd, (const struct sockaddr *) &addr, sizeof(addr))<0) {
+    fprintf(stderr, "ERROR: Could not connect to server at \"%s\": %s\n", socketPath, strerror(errno));
+    close(fd);
+    return 2;
+  }
+
+  buf=GWEN_Buffer_new(0, 256, 0, 1);
+  GWEN_Buffer_AppendBytes(buf, cwd, strlen(cwd)+1);
+  for (i=0; i<argc; i++)
+    GWEN_Buffer_AppendBytes(buf, argv[i], strlen(argv[i])+1);
+  if (GWEN_Buffer_GetUsedBytes(buf)>AQBANKING_CLI_SERVE_MAX_REQUEST_SIZE) {
+    fprintf(stderr, "ERROR: Command line too long\n");
+    GWEN_Buffer_free(buf);
+    close(fd);
+    return 1;
+  }
+  _uint32ToBuffer(GWEN_Buffer_GetUsedBytes(buf), header);
+
+  /* send header together with our stdin, stdout and stderr */
+  memset(&msg, 0, sizeof(msg));
+  memset(&ctrl, 0, sizeof(ctrl));
+  iov.iov_base=header;
+  iov.iov_len=sizeof(header);
+  msg.msg_iov=&iov;
+  msg.msg_iovlen=1;
+  msg.msg_control=ctrl.buf;
+  msg.msg_controllen=sizeof(ctrl.buf);
+  cmsg=CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level=SOL_SOCKET;
+  cmsg->cmsg_type=SCM_RIGHTS;
+  cmsg->cmsg_len=CMSG_LEN(sizeof(fds));
+  memmove(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+  do {
+    sent=sendmsg(fd, &msg, 0);
+  } while (sent<0 && errno==EINTR);
+  if (sent!=(ssize_t) sizeof(header) ||
+      _writeFull(fd, GWEN_Buffer_GetStart(buf), GWEN_Buffer_GetUsedBytes(buf))<0) {
+    fprintf(stderr, "ERROR: Could not send command to server: %s\n", strerror(errno));
+    GWEN_Buffer_free(buf);
+    close(fd);
+    return 2;
+  }
+  GWEN_Buffer_free(buf);
+
+  /* wait for the command to finish */
+  if (_readFull(fd, result, sizeof(result))<0) {
+    fprintf(stderr, "ERROR: Server closed the connection\n");
+    close(fd);
+    return 2;
+  }
+  close(fd);
+
+  return (int) _bufferToUint32(result);
+}
+
+
+
+int _createServerSocket(const char *socketPath)
+{
+  struct sockaddr_un addr;
+  int fd;
+  int rv;
+  mode_t oldMask;
+
+  if (strlen(socketPath)>=sizeof(addr.sun_path)) {
+    DBG_ERROR(0, "Socket path \"%s\" too long", socketPath);
+    return GWEN_ERROR_INVALID;
+  }
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family=AF_UNIX;
+  strncpy(addr.sun_path, socketPath, sizeof(addr.sun_path)-1);
+
+  fd=socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd<0) {
+    DBG_ERROR(0, "socket(): %s", strerror(errno));
+    return GWEN_ERROR_IO;
+  }
+
+  /* only the owner may connect */
+  oldMask=umask(077);
+  rv=bind(fd, (const struct sockaddr *) &addr, sizeof(addr));
+  if (rv<0 && errno==EADDRINUSE) {
+    if (_isServerRunning(&addr)) {
+      DBG_ERROR(0, "Another server is already listening on \"%s\"", socketPath);
+      umask(oldMask);
+      close(fd);
+      return GWEN_ERROR_INVALID;
+    }
+    DBG_INFO(0, "Removing stale socket \"%s\"", socketPath);
+    unlink(socketPath);
+    rv=bind(fd, (const struct sockaddr *) &addr, sizeof(addr));
+  }
+  umask(oldMask);
+  if (rv<0) {
+    DBG_ERROR(0, "bind(%s): %s", socketPath, strerror(errno));
+    close(fd);
+    return GWEN_ERROR_IO;
+  }
+
+  if (listen(fd, AQBANKING_CLI_SERVE_BACKLOG)<0) {
+    DBG_ERROR(0, "listen(): %s", strerror(errno));
+    close(fd);
+    unlink(socketPath);
+    return GWEN_ERROR_IO;
+  }
+
+  return fd;
+}
+
+
+
+int _isServerRunning(const struct sockaddr_un *addr)
+{
+  int fd;
+  int rv;
+
+  fd=socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd<0)
+    return 0;
+  rv=connect(fd, (const struct sockaddr *) addr, sizeof(*addr));
+  close(fd);
+  return (rv==0)?1:0;
+}
+
+
+
+int _checkPeer(int fd)
+{
+#ifdef SO_PEERCRED
+  struct ucred cred;
+  socklen_t len=sizeof(cred);
+
+  if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len)<0) {
+    DBG_ERROR(0, "getsockopt(SO_PEERCRED): %s", strerror(errno));
+    return GWEN_ERROR_IO;
+  }
+  if (cred.uid!=geteuid()) {
+    DBG_ERROR(0, "Rejecting connection from user %lu", (unsigned long) cred.uid);
+    return GWEN_ERROR_PERMISSIONS;
+  }
+#else
+  uid_t uid;
+  gid_t gid;
+
+  if (getpeereid(fd, &uid, &gid)<0) {
+    DBG_ERROR(0, "getpeereid(): %s", strerror(errno));
+    return GWEN_ERROR_IO;
+  }
+  if (uid!=geteuid()) {
+    DBG_ERROR(0, "Rejecting connection from user %lu", (unsigned long) uid);
+    return GWEN_ERROR_PERMISSIONS;
+  }
+#endif
+  return 0;
+}
+
+
+
+int _setReadTimeout(int fd, int seconds)
+{
+  struct timeval tv;
+
+  memset(&tv, 0, sizeof(tv));
+  tv.tv_sec=seconds;
+  if (setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv))<0) {
+    DBG_ERROR(0, "setsockopt(SO_RCVTIMEO): %s", strerror(errno));
+    return GWEN_ERROR_IO;
+  }
+  return 0;
+}
+
+
+
+void _handleClient(AB_BANKING *ab, int fd, int startDirFd)
+{
+  int clientFds[3];
+  char *data=NULL;
+  uint32_t len=0;
+  char **argv;
+  int argc;
+  int rv;
+  int i;
+  uint8_t result[4];
+
+  rv=_readRequest(fd, clientFds, &data, &len);
+  if (rv<0) {
+    DBG_INFO(0, "here (%d)", rv);
+    return;
+  }
+
+  argv=_splitRequest(data, len, &argc);
+  if (argv==NULL || argc<2) {
+    DBG_ERROR(0, "Invalid request");
+    rv=1;
+  }
+  else
+    /* first string is the current folder of the client */
+    rv=_execRequest(ab, clientFds, argv[0], argc-1, argv+1, startDirFd);
+
+  for (i=0; i<3; i++)
+    close(clientFds[i]);
+  free(argv);
+  free(data);
+
+  _uint32ToBuffer((uint32_t) rv, result);
+  if (_writeFull(fd, result, sizeof(result))<0) {
+    DBG_ERROR(0, "Could not send result to client: %s", strerror(errno));
+  }
+}
+
+
+
+int _readRequest(int fd, int *clientFds, char **pData, uint32_t *pLen)
+{
+  uint8_t header[4];
+  struct msghdr msg;
+  struct iovec iov;
+  union {
+    struct cmsghdr align;
+    char buf[CMSG_SPACE(3*sizeof(int))];
+  } ctrl;
+  struct cmsghdr *cmsg;
+  ssize_t got;
+  uint32_t len;
+  char *data;
+
+  memset(&msg, 0, sizeof(msg));
+  iov.iov_base=header;
+  iov.iov_len=sizeof(header);
+  msg.msg_iov=&iov;
+  msg.msg_iovlen=1;
+  msg.msg_control=ctrl.buf;
+  msg.msg_controllen=sizeof(ctrl.buf);
+
+  do {
+    got=recvmsg(fd, &msg, 0);
+  } while (got<0 && errno==EINTR);
+  if (got<0 && (errno==EAGAIN || errno==EWOULDBLOCK)) {
+    DBG_ERROR(0, "Timeout waiting for request");
+    return GWEN_ERROR_TIMEOUT;
+  }
+  else if (got<0) {
+    DBG_ERROR(0, "recvmsg(): %s", strerror(errno));
+    return GWEN_ERROR_IO;
+  }
+  else if (got==0) {
+    /* e.g. another server checking whether we are still running */
+    DBG_INFO(0, "Connection closed by client");
+    return GWEN_ERROR_EOF;
+  }
+
+  cmsg=CMSG_FIRSTHDR(&msg);
+  if (cmsg==NULL ||
+      cmsg->cmsg_level!=SOL_SOCKET ||
+      cmsg->cmsg_type!=SCM_RIGHTS ||
+      cmsg->cmsg_len!=CMSG_LEN(3*sizeof(int))) {
+    DBG_ERROR(0, "Client did not send stdin, stdout and stderr");
+    return GWEN_ERROR_BAD_DATA;
+  }
+  memmove(clientFds, CMSG_DATA(cmsg), 3*sizeof(int));
+
+  if (got<(ssize_t) sizeof(header) &&
+      _readFull(fd, header+got, sizeof(header)-got)<0) {
+    DBG_ERROR(0, "Incomplete request header");
+    close(clientFds[0]);
+    close(clientFds[1]);
+    close(clientFds[2]);
+    return GWEN_ERROR_BAD_DATA;
+  }
+
+  len=_bufferToUint32(header);
+  if (len<1 || len>AQBANKING_CLI_SERVE_MAX_REQUEST_SIZE) {
+    DBG_ERROR(0, "Invalid request size (%lu)", (unsigned long) len);
+    close(clientFds[0]);
+    close(clientFds[1]);
+    close(clientFds[2]);
+    return GWEN_ERROR_BAD_DATA;
+  }
+
+  data=(char *) malloc(len);
+  assert(data);
+  if (_readFull(fd, data, len)<0) {
+    DBG_ERROR(0, "Incomplete request");
+    free(data);
+    close(clientFds[0]);
+    close(clientFds[1]);
+    close(clientFds[2]);
+    return GWEN_ERROR_BAD_DATA;
+  }
+
+  *pData=data;
+  *pLen=len;
+  return 0;
+}
+
+
+
+char **_splitRequest(char *data, uint32_t len, int *pCount)
+{
+  char **strings;
+  uint32_t i;
+  int count=0;
+  int idx=0;
+
+  /* every string must be NUL-terminated */
+  if (len<1 || data[len-1]!=0)
+    return NULL;
+
+  for (i=0; i<len; i++) {
+    if (data[i]==0)
+      count++;
+  }
+
+  strings=(char **) malloc(sizeof(char *)*(count+1));
+  assert(strings);
+  strings[idx++]=data;
+  for (i=0; i<len-1; i++) {
+    if (data[i]==0)
+      strings[idx++]=data+i+1;
+  }
+  strings[idx]=NULL;
+
+  *pCount=count;
+  return strings;
+}
+
+
+
+int _execRequest(AB_BANKING *ab, const int *clientFds, const char *cwd, int argc, char **argv, int startDirFd)
+{
+  int savedFds[3];
+  int i;
+  int rv;
+
+  fflush(stdout);
+  fflush(stderr);
+  for (i=0; i<3; i++) {
+    savedFds[i]=dup(i);
+    dup2(clientFds[i], i);
+  }
+
+  if (chdir(cwd)<0) {
+    fprintf(stderr, "ERROR: Could not change to folder \"%s\": %s\n", cwd, strerror(errno));
+    rv=1;
+  }
+  else if (strcasecmp(argv[0], "serve")==0) {
+    fprintf(stderr, "ERROR: Command \"serve\" can not be sent to a server.\n");
+    rv=1;
+  }
+  else {
+    GWEN_DB_NODE *dbArgs;
+
+    DBG_INFO(0, "Executing command \"%s\"", argv[0]);
+
+    /* account specs might have been changed by other processes */
+    AB_Banking_ClearAccountSpecCache(ab);
+
+    dbArgs=GWEN_DB_Group_new("arguments");
+    GWEN_DB_SetCharValue(dbArgs, GWEN_DB_FLAGS_DEFAULT, "params", argv[0]);
+    rv=execCommand(ab, dbArgs, argv[0], argc, argv);
+    GWEN_DB_Group_free(dbArgs);
+  }
+
+  fflush(stdout);
+  fflush(stderr);
+  _discardStdinBuffer();
+  for (i=0; i<3; i++) {
+    dup2(savedFds[i], i);
+    close(savedFds[i]);
+  }
+  if (fchdir(startDirFd)<0) {
+    DBG_ERROR(0, "Could not change back to start folder: %s", strerror(errno));
+  }
+
+  return rv;
+}
+
+
+
+void _discardStdinBuffer(void)
+{
+  /* input read ahead from the stdin of a client must not be seen by the next client */
+#if defined(HAVE___FPURGE)
+  __fpurge(stdin);
+#elif defined(HAVE_FPURGE)
+  fpurge(stdin);
+#endif
+  clearerr(stdin);
+}
+
+
+
+int _readFull(int fd, void *p, size_t len)
+{
+  uint8_t *ptr=(uint8_t *) p;
+
+  while (len) {
+    ssize_t got;
+
+    got=read(fd, ptr, len);
+    if (got<0) {
+      if (errno==EINTR)
+        continue;
+      if (errno==EAGAIN || errno==EWOULDBLOCK)
+        /* SO_RCVTIMEO expired */
+        return GWEN_ERROR_TIMEOUT;
+      return GWEN_ERROR_IO;
+    }
+    else if (got==0)
+      return GWEN_ERROR_EOF;
+    ptr+=got;
+    len-=got;
+  }
+  return 0;
+}
+
+
+
+int _writeFull(int fd, const void *p, size_t len)
+{
+  const uint8_t *ptr=(const uint8_t *) p;
+
+  while (len) {
+    ssize_t sent;
+
+    sent=write(fd, ptr, len);
+    if (sent<0) {
+      if (errno==EINTR)
+        continue;
+      return GWEN_ERROR_IO;
+    }
+    ptr+=sent;
+    len-=sent;
+  }
+  return 0;
+}
+
+
+
+void _uint32ToBuffer(uint32_t v, uint8_t *p)
+{
+  p[0]=(v>>24) & 0xff;
+  p[1]=(v>>16) & 0xff;
+  p[2]=(v>>8) & 0xff;
+  p[3]=v & 0xff;
+}
+
+
+
+uint32_t _bufferToUint32(const uint8_t *p)
+{
+  return (((uint32_t) p[0])<<24) | (((uint32_t) p[1])<<16) | (((uint32_t) p[2])<<8) | ((uint32_t) p[3]);
+}
+
+
+
+void _onSignal(GWEN_UNUSED int sig)
+{
+  _stopServer=1;
+}
+
+
+
+#else /* OS_WIN32 */
+
+
+
+int serve(AB_BANKING *ab, GWEN_DB_NODE *dbArgs, int argc, char **argv)
+{
+  fprintf(stderr, "ERROR: Command \"serve\" is not supported on this system.\n");
+  return 1;
+}
+
+
+
+int sendToServer(const char *socketPath, int argc, char **argv)
+{
+  fprintf(stderr, "ERROR: Option \"--socket\" is not supported on this system.\n");
+  return 1;
+}
+
+
+
+#endif
+
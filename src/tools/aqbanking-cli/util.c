@@ -650,18 +650,19 @@ AB_ACCOUNT_SPEC *pickAccountSpecForArgs(const AB_ACCOUNT_SPEC_LIST *accountSpecL
  */
 
 
-AB_ACCOUNT_SPEC *pickAccountSpecForTransaction(const AB_ACCOUNT_SPEC_LIST *accountSpecList, const AB_TRANSACTION *t)
+AB_ACCOUNT_SPEC *pickAccountSpecForTransaction(AB_BANKING *ab, const AB_TRANSACTION *t)
 {
   uint32_t uaid;
   AB_ACCOUNT_SPEC *accountSpec=NULL;
+  int rv;
 
-  assert(accountSpecList);
+  assert(ab);
   assert(t);
 
   uaid=AB_Transaction_GetUniqueAccountId(t);
   if (uaid>0) {
-    accountSpec=AB_AccountSpec_List_GetByUniqueId(accountSpecList, uaid);
-    if (accountSpec==NULL) {
+    rv=AB_Banking_GetAccountSpecByUniqueId(ab, uaid, &accountSpec);
+    if (rv<0) {
       DBG_ERROR(0, "ERROR: No account spec with unique id %" PRIu32, uaid);
       return NULL;
     }
@@ -672,6 +673,8 @@ AB_ACCOUNT_SPEC *pickAccountSpecForTransaction(const AB_ACCOUNT_SPEC_LIST *accou
     const char *accountNumber;
     const char *accountSuffix;
     const char *iban;
+    AB_ACCOUNT_SPEC_LIST *candidateList=NULL;
+    AB_ACCOUNT_SPEC *as;
 
     country=AB_Transaction_GetLocalCountry(t);
     bankCode=AB_Transaction_GetLocalBankCode(t);
@@ -679,21 +682,34 @@ AB_ACCOUNT_SPEC *pickAccountSpecForTransaction(const AB_ACCOUNT_SPEC_LIST *accou
     accountSuffix=AB_Transaction_GetLocalSuffix(t);
     iban=AB_Transaction_GetLocalIban(t);
 
-    accountSpec=AB_AccountSpec_List_FindFirst(accountSpecList,
-                                              "*", /* backend */
-                                              (country && *country)?country:"*",
-                                              (bankCode && *bankCode)?bankCode:"*",
-                                              (accountNumber && *accountNumber)?accountNumber:"*",
-                                              (accountSuffix && *accountSuffix)?accountSuffix:"*",
-                                              (iban && *iban)?iban:"*",
-                                              "*", /* currency */
-                                              AB_AccountType_Unknown);
-    if (accountSpec==NULL) {
+    /* only get the account specs which can possibly match via the indexed lookups */
+    if (iban && *iban)
+      rv=AB_Banking_GetAccountSpecListByIban(ab, iban, &candidateList);
+    else if (bankCode && *bankCode && accountNumber && *accountNumber)
+      rv=AB_Banking_GetAccountSpecListByBankCodeAndAccountNumber(ab, bankCode, accountNumber, &candidateList);
+    else
+      rv=AB_Banking_GetAccountSpecList(ab, &candidateList);
+    if (rv<0) {
       DBG_ERROR(0, "ERROR: No matching account spec found");
       return NULL;
     }
 
-    if (AB_AccountSpec_List_FindNext(accountSpec,
+    as=AB_AccountSpec_List_FindFirst(candidateList,
+                                     "*", /* backend */
+                                     (country && *country)?country:"*",
+                                     (bankCode && *bankCode)?bankCode:"*",
+                                     (accountNumber && *accountNumber)?accountNumber:"*",
+                                     (accountSuffix && *accountSuffix)?accountSuffix:"*",
+                                     (iban && *iban)?iban:"*",
+                                     "*", /* currency */
+                                     AB_AccountType_Unknown);
+    if (as==NULL) {
+      DBG_ERROR(0, "ERROR: No matching account spec found");
+      AB_AccountSpec_List_free(candidateList);
+      return NULL;
+    }
+
+    if (AB_AccountSpec_List_FindNext(as,
                                      "*", /* backend */
                                      (country && *country)?country:"*",
                                      (bankCode && *bankCode)?bankCode:"*",
@@ -703,8 +719,13 @@ AB_ACCOUNT_SPEC *pickAccountSpecForTransaction(const AB_ACCOUNT_SPEC_LIST *accou
                                      "*", /* currency */
                                      AB_AccountType_Unknown)) {
       DBG_ERROR(0, "ERROR: Ambiguous account specification");
+      AB_AccountSpec_List_free(candidateList);
       return NULL;
     }
+
+    AB_AccountSpec_List_Del(as);
+    AB_AccountSpec_List_free(candidateList);
+    accountSpec=as;
   }
 
   return accountSpec;
@@ -1047,6 +1068,16 @@ int createAndAddRequests(AB_BANKING *ab,
     rv=createAndAddRequest(ab, tList, as, AB_Transaction_CommandGetTransactions, fromDate, toDate, ignoreUnsupported);
     if (rv)
       return rv;
+    if (requestFlags & AQBANKING_TOOL_REQUEST_INCREMENTAL) {
+      AB_TRANSACTION *j;
+
+      /* only ask for transactions booked since the last incremental request */
+      j=AB_Transaction_List2_GetBack(tList);
+      if (j &&
+          AB_Transaction_GetCommand(j)==AB_Transaction_CommandGetTransactions &&
+          AB_Transaction_GetUniqueAccountId(j)==AB_AccountSpec_GetUniqueId(as))
+        AB_Transaction_AddRequestFlags(j, AB_TRANSACTION_REQUESTFLAGS_INCREMENTAL);
+    }
   }
 
   if (requestFlags & AQBANKING_TOOL_REQUEST_SEPASTO) {